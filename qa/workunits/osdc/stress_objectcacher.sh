@@ -24,5 +24,6 @@ do
 done
 
 ceph_test_objectcacher_stress --correctness-test > /dev/null 2>&1
+ceph_test_objectcacher_stress --dirty-extent-test > /dev/null 2>&1
 
 echo OK
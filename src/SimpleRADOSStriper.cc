@@ -61,6 +61,8 @@ enum {
   P_SHRINK_BYTES,
   P_LOCK,
   P_UNLOCK,
+  P_READAHEAD,
+  P_READAHEAD_HIT,
   P_LAST,
 };
 
@@ -75,6 +77,8 @@ int SimpleRADOSStriper::config_logger(CephContext* cct, std::string_view name, s
   plb.add_u64_counter(P_SHRINK_BYTES, "shrink_bytes", "Bytes shrunk");
   plb.add_u64_counter(P_LOCK, "lock", "Number of locks");
   plb.add_u64_counter(P_UNLOCK, "unlock", "Number of unlocks");
+  plb.add_u64_counter(P_READAHEAD, "readahead", "Number of read-ahead fetches");
+  plb.add_u64_counter(P_READAHEAD_HIT, "readahead_hit", "Reads served from read-ahead");
   l->reset(plb.create_perf_counters());
   return 0;
 }
@@ -148,6 +152,8 @@ int SimpleRADOSStriper::truncate(uint64_t size)
     return -EBLOCKLISTED;
   }
 
+  invalidate_readahead();
+
   /* TODO: (not currently used by SQLite) handle growth + sparse */
   if (int rc = set_metadata(size, true); rc < 0) {
     return rc;
@@ -455,6 +461,10 @@ ssize_t SimpleRADOSStriper::write(const void* data, size_t len, uint64_t off)
     }
   }
 
+  if (off < readahead_off + readahead.length() && readahead_off < off + len) {
+    invalidate_readahead();
+  }
+
   size_t w = 0;
   while ((len-w) > 0) {
     auto ext = get_next_extent(off+w, len-w);
@@ -487,6 +497,41 @@ ssize_t SimpleRADOSStriper::read(void* data, size_t len, uint64_t off)
     return -EBLOCKLISTED;
   }
 
+  if (!locked || len == 0 || len >= readahead_max) {
+    return _read(data, len, off);
+  }
+
+  if (off < readahead_off || off + len > readahead_off + readahead.length()) {
+    if (off != last_read_end || off >= size) {
+      last_read_end = off + len;
+      return _read(data, len, off);
+    }
+    /* sequential: fetch the next window, bounded by the file size */
+    size_t want = std::min<uint64_t>(readahead_max, size - off);
+    want = std::max(want, len);
+    ceph::bufferptr bp(want);
+    ssize_t r = _read(bp.c_str(), want, off);
+    if (r < 0) {
+      invalidate_readahead();
+      return r;
+    }
+    bp.set_length(r);
+    readahead.clear();
+    readahead.append(std::move(bp));
+    readahead_off = off;
+    if (logger) logger->inc(P_READAHEAD);
+  } else {
+    if (logger) logger->inc(P_READAHEAD_HIT);
+  }
+
+  size_t n = std::min<uint64_t>(len, readahead_off + readahead.length() - off);
+  readahead.begin(off - readahead_off).copy(n, (char*)data);
+  last_read_end = off + n;
+  return n;
+}
+
+ssize_t SimpleRADOSStriper::_read(void* data, size_t len, uint64_t off)
+{
   size_t r = 0;
   // Don't use std::vector to store bufferlists (e.g for parallelizing aio_reads),
   // as they are being moved whenever the vector resizes
@@ -672,6 +717,8 @@ int SimpleRADOSStriper::lock(uint64_t timeoutms)
 
   ceph_assert(!is_locked());
 
+  invalidate_readahead();
+
   /* We're going to be very lazy here in implementation: only exclusive locks
    * are allowed. That even ensures a single reader.
    */
@@ -750,6 +797,8 @@ int SimpleRADOSStriper::unlock()
 
   ceph_assert(is_locked());
 
+  invalidate_readahead();
+
   /* wait for flush of metadata */
   if (int rc = flush(); rc < 0) {
     return rc;
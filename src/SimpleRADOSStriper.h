@@ -79,6 +79,9 @@ public:
   void set_blocklist_the_dead(bool b) {
     blocklist_the_dead = b;
   }
+  void set_readahead(size_t bytes) {
+    readahead_max = bytes;
+  }
 
 protected:
   struct extent {
@@ -94,6 +97,11 @@ protected:
   int maybe_shrink_alloc();
   int wait_for_aios(bool block);
   int recover_lock();
+  ssize_t _read(void* data, size_t len, uint64_t off);
+  void invalidate_readahead() {
+    readahead.clear();
+    last_read_end = 0;
+  }
   extent get_next_extent(uint64_t off, size_t len) const;
   extent get_first_extent() const {
     return get_next_extent(0, 0);
@@ -131,6 +139,12 @@ private:
   bool locked = false;
   bool size_dirty = false;
   bool blocklist_the_dead = true;
+  /* sequential reads fetch up to readahead_max bytes into readahead, which
+   * starts at readahead_off; only used while we hold the exclusive lock */
+  size_t readahead_max = 0;
+  ceph::bufferlist readahead;
+  uint64_t readahead_off = 0;
+  uint64_t last_read_end = 0;
   std::queue<aiocompletionptr> aios;
   int aios_failure = 0;
   std::string myaddrs;
@@ -104,6 +104,10 @@ struct io_queue_t {
   virtual int submit_batch(aio_iter begin, aio_iter end,
 			   void *priv, int *retries) = 0;
   virtual int get_next_completed(int timeout_ms, aio_t **paio, int max) = 0;
+  /// pin long-lived I/O buffers with the kernel, if the backend supports it
+  virtual int register_buffers(const std::vector<iovec>& bufs) {
+    return -EOPNOTSUPP;
+  }
 };
 
 struct aio_queue_t final : public io_queue_t {
@@ -13,6 +13,7 @@
  */
 
 #include <limits>
+#include <thread>
 #include <unistd.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -65,7 +66,6 @@ KernelDevice::KernelDevice(CephContext* cct, aio_callback_t cb, void *cbpriv, ai
     discard_callback(d_cb),
     discard_callback_priv(d_cbpriv),
     aio_stop(false),
-    aio_thread(this),
     injecting_crash(0)
 {
   cct->_conf.add_observer(this);
@@ -74,19 +74,29 @@ KernelDevice::KernelDevice(CephContext* cct, aio_callback_t cb, void *cbpriv, ai
 
   bool use_ioring = cct->_conf.get_val<bool>("bdev_ioring");
   unsigned int iodepth = cct->_conf->bdev_aio_max_queue_depth;
+  auto nqueues = cct->_conf.get_val<uint64_t>("bdev_aio_reap_threads");
 
-  if (use_ioring && ioring_queue_t::supported()) {
-    bool use_ioring_hipri = cct->_conf.get_val<bool>("bdev_ioring_hipri");
-    bool use_ioring_sqthread_poll = cct->_conf.get_val<bool>("bdev_ioring_sqthread_poll");
-    io_queue = std::make_unique<ioring_queue_t>(iodepth, use_ioring_hipri, use_ioring_sqthread_poll);
-  } else {
+  if (use_ioring && !ioring_queue_t::supported()) {
     static bool once;
-    if (use_ioring && !once) {
+    if (!once) {
       derr << "WARNING: io_uring API is not supported! Fallback to libaio!"
            << dendl;
       once = true;
     }
-    io_queue = std::make_unique<aio_queue_t>(iodepth);
+    use_ioring = false;
+  }
+  for (uint64_t i = 0; i < nqueues; ++i) {
+    if (use_ioring) {
+      bool use_ioring_hipri = cct->_conf.get_val<bool>("bdev_ioring_hipri");
+      bool use_ioring_sqthread_poll = cct->_conf.get_val<bool>("bdev_ioring_sqthread_poll");
+      auto sqthread_idle_ms = cct->_conf.get_val<std::chrono::milliseconds>(
+	"bdev_ioring_sqthread_idle");
+      io_queues.emplace_back(std::make_unique<ioring_queue_t>(
+	iodepth, use_ioring_hipri, use_ioring_sqthread_poll,
+	sqthread_idle_ms.count()));
+    } else {
+      io_queues.emplace_back(std::make_unique<aio_queue_t>(iodepth));
+    }
   }
 
   char name[128];
@@ -96,6 +106,14 @@ KernelDevice::KernelDevice(CephContext* cct, aio_callback_t cb, void *cbpriv, ai
   b.set_prio_default(PerfCountersBuilder::PRIO_USEFUL);
   b.add_u64_counter(l_blk_kernel_device_discard_op, "discard_op",
             "Number of discard ops issued to kernel device");
+  b.add_u64_counter(l_blk_kernel_device_write_direct_op, "write_direct_op",
+            "Number of unbuffered writes submitted without copying the data");
+  b.add_u64_counter(l_blk_kernel_device_write_rebuild_op, "write_rebuild_op",
+            "Number of writes whose data was copied to meet alignment");
+  b.add_u64_counter(l_blk_kernel_device_write_rebuild_bytes,
+            "write_rebuild_bytes",
+            "Bytes in writes whose data was copied to meet alignment",
+            NULL, 0, unit_t(UNIT_BYTES));
 
   logger.reset(b.create_perf_counters());
   cct->get_perfcounters_collection()->add(logger.get());
@@ -521,42 +539,108 @@ int KernelDevice::_aio_start()
 {
   if (aio) {
     dout(10) << __func__ << dendl;
-    int r = io_queue->init(fd_directs);
-    if (r < 0) {
-      if (r == -EAGAIN) {
-	derr << __func__ << " io_setup(2) failed with EAGAIN; "
-	     << "try increasing /proc/sys/fs/aio-max-nr" << dendl;
-      } else {
-	derr << __func__ << " io_setup(2) failed: " << cpp_strerror(r) << dendl;
+    for (size_t i = 0; i < io_queues.size(); ++i) {
+      int r = io_queues[i]->init(fd_directs);
+      if (r < 0) {
+	if (r == -EAGAIN) {
+	  derr << __func__ << " io_setup(2) failed with EAGAIN; "
+	       << "try increasing /proc/sys/fs/aio-max-nr" << dendl;
+	} else {
+	  derr << __func__ << " io_setup(2) failed: " << cpp_strerror(r) << dendl;
+	}
+	while (i--) {
+	  io_queues[i]->shutdown();
+	}
+	return r;
       }
-      return r;
     }
-    aio_thread.create("bstore_aio");
+    if (cct->_conf.get_val<bool>("bdev_ioring_register_buffers")) {
+      _aio_register_buffers();
+    }
+    for (unsigned i = 0; i < io_queues.size(); ++i) {
+      aio_threads.emplace_back(std::make_unique<AioCompletionThread>(this, i));
+      aio_threads.back()->create("bstore_aio");
+    }
+    if (cct->_conf.get_val<bool>("bdev_aio_reap_threads_numa_affinity")) {
+      _aio_set_numa_affinity();
+    }
   }
   return 0;
 }
 
+void KernelDevice::_aio_set_numa_affinity()
+{
+  int node;
+  int r = BlkDev{fd_buffereds[WRITE_LIFE_NOT_SET]}.get_numa_node(&node);
+  if (r < 0) {
+    dout(1) << __func__ << " unable to determine numa node of the device: "
+	    << cpp_strerror(r) << dendl;
+    return;
+  }
+  size_t cpu_set_size;
+  cpu_set_t cpu_set;
+  r = get_numa_node_cpu_set(node, &cpu_set_size, &cpu_set);
+  if (r < 0) {
+    dout(1) << __func__ << " unable to determine numa node " << node
+	    << " CPUs" << dendl;
+    return;
+  }
+  dout(1) << __func__ << " setting aio thread affinity to numa node " << node
+	  << " cpus " << cpu_set_to_str_list(cpu_set_size, &cpu_set) << dendl;
+  for (auto& t : aio_threads) {
+    r = pthread_setaffinity_np(t->get_thread_id(), cpu_set_size, &cpu_set);
+    if (r != 0) {
+      derr << __func__ << " failed to set aio thread affinity: "
+	   << cpp_strerror(r) << dendl;
+      return;
+    }
+  }
+}
+
+io_queue_t* KernelDevice::_choose_io_queue()
+{
+  if (io_queues.size() == 1) {
+    return io_queues.front().get();
+  }
+  // keep each submitting thread on one queue (and completion thread)
+  static thread_local size_t thread_hash =
+    std::hash<std::thread::id>{}(std::this_thread::get_id());
+  return io_queues[thread_hash % io_queues.size()].get();
+}
+
 void KernelDevice::_aio_stop()
 {
   if (aio) {
     dout(10) << __func__ << dendl;
     aio_stop = true;
 
-    IOContext wakeup_ctx(cct, nullptr, false);
-    bufferlist bl;
-    aio_read(0, block_size, &bl, &wakeup_ctx);
-    aio_submit(&wakeup_ctx);
+    // wake every completion thread with a read on its own queue
+    std::vector<std::unique_ptr<IOContext>> wakeup_ctxs;
+    for (auto& q : io_queues) {
+      wakeup_ctxs.emplace_back(std::make_unique<IOContext>(cct, nullptr, false));
+      IOContext *wakeup_ctx = wakeup_ctxs.back().get();
+      bufferlist bl;
+      aio_read(0, block_size, &bl, wakeup_ctx);
+      _aio_submit(wakeup_ctx, q.get());
+    }
 
-    aio_thread.join();
+    for (auto& t : aio_threads) {
+      t->join();
+    }
+    aio_threads.clear();
 
     if (cct->_conf->bdev_debug_aio) {
-      for (auto& i: wakeup_ctx.running_aios) {
-	debug_aio_unlink(i);
+      for (auto& wakeup_ctx : wakeup_ctxs) {
+	for (auto& i: wakeup_ctx->running_aios) {
+	  debug_aio_unlink(i);
+	}
       }
     }
 
     aio_stop = false;
-    io_queue->shutdown();
+    for (auto& q : io_queues) {
+      q->shutdown();
+    }
   }
 }
 
@@ -636,9 +720,10 @@ static bool is_expected_ioerr(const int r)
 	  );
 }
 
-void KernelDevice::_aio_thread()
+void KernelDevice::_aio_thread(unsigned qid)
 {
-  dout(10) << __func__ << " start" << dendl;
+  dout(10) << __func__ << " " << qid << " start" << dendl;
+  io_queue_t *io_queue = io_queues[qid].get();
   int inject_crash_count = 0;
   while (!aio_stop) {
     dout(40) << __func__ << " polling" << dendl;
@@ -929,6 +1014,11 @@ void KernelDevice::_aio_log_finish(
 }
 
 void KernelDevice::aio_submit(IOContext *ioc)
+{
+  _aio_submit(ioc, _choose_io_queue());
+}
+
+void KernelDevice::_aio_submit(IOContext *ioc, io_queue_t *io_queue)
 {
   dout(20) << __func__ << " ioc " << ioc
 	   << " pending " << ioc->num_pending.load()
@@ -1036,6 +1126,19 @@ int KernelDevice::_sync_write(uint64_t off, bufferlist &bl, bool buffered, int w
   return 0;
 }
 
+void KernelDevice::_align_write_buffer(bufferlist& bl, bool buffered)
+{
+  if (!buffered || bl.get_num_buffers() >= IOV_MAX) {
+    if (bl.rebuild_aligned_size_and_memory(block_size, block_size, IOV_MAX)) {
+      dout(20) << __func__ << " rebuilding buffer to be aligned" << dendl;
+      logger->inc(l_blk_kernel_device_write_rebuild_op);
+      logger->inc(l_blk_kernel_device_write_rebuild_bytes, bl.length());
+    } else if (!buffered) {
+      logger->inc(l_blk_kernel_device_write_direct_op);
+    }
+  }
+}
+
 int KernelDevice::write(
   uint64_t off,
   bufferlist &bl,
@@ -1053,10 +1156,7 @@ int KernelDevice::write(
     return 0;
   }
 
-  if ((!buffered || bl.get_num_buffers() >= IOV_MAX) &&
-      bl.rebuild_aligned_size_and_memory(block_size, block_size, IOV_MAX)) {
-    dout(20) << __func__ << " rebuilding buffer to be aligned" << dendl;
-  }
+  _align_write_buffer(bl, buffered);
   dout(40) << "data:\n";
   bl.hexdump(*_dout);
   *_dout << dendl;
@@ -1082,10 +1182,7 @@ int KernelDevice::aio_write(
     return 0;
   }
 
-  if ((!buffered || bl.get_num_buffers() >= IOV_MAX) &&
-      bl.rebuild_aligned_size_and_memory(block_size, block_size, IOV_MAX)) {
-    dout(20) << __func__ << " rebuilding buffer to be aligned" << dendl;
-  }
+  _align_write_buffer(bl, buffered);
   dout(40) << "data:\n";
   bl.hexdump(*_dout);
   *_dout << dendl;
@@ -1216,6 +1313,7 @@ struct ExplicitHugePagePool {
                    " /proc/sys/vm/nr_hugepages misconfigured?");
       } else {
         region_q.push(mmaped_region);
+        regions.push_back(mmaped_region);
       }
     }
   }
@@ -1241,9 +1339,16 @@ struct ExplicitHugePagePool {
     return buffer_size;
   }
 
+  void get_regions(std::vector<iovec>* out) const {
+    for (void* region : regions) {
+      out->push_back(iovec{region, buffer_size});
+    }
+  }
+
 private:
   const size_t buffer_size;
   region_queue_t region_q;
+  std::vector<void*> regions; ///< every region we own, for registration
 };
 
 struct HugePagePoolOfPools {
@@ -1275,6 +1380,12 @@ struct HugePagePoolOfPools {
 
   static HugePagePoolOfPools from_desc(const std::string& conf);
 
+  void get_regions(std::vector<iovec>* out) const {
+    for (const auto& pool : pools) {
+      pool.get_regions(out);
+    }
+  }
+
 private:
   // let's have some space inside (for 2 MB and 4 MB perhaps?)
   // NOTE: we need tiny_vector as the boost::lockfree queue inside
@@ -1300,6 +1411,35 @@ HugePagePoolOfPools HugePagePoolOfPools::from_desc(const std::string& desc) {
   return HugePagePoolOfPools{std::move(conf)};
 }
 
+static HugePagePoolOfPools& get_huge_page_pools(CephContext* cct)
+{
+  static HugePagePoolOfPools hp_pools = HugePagePoolOfPools::from_desc(
+    cct->_conf.get_val<std::string>("bdev_read_preallocated_huge_buffers")
+  );
+  return hp_pools;
+}
+
+void KernelDevice::_aio_register_buffers()
+{
+  // the preallocated huge page read buffers live as long as the process,
+  // so they can stay pinned and let io_uring skip per-io page mapping.
+  std::vector<iovec> bufs;
+  get_huge_page_pools(cct).get_regions(&bufs);
+  if (bufs.empty()) {
+    dout(10) << __func__ << " no preallocated buffers to register" << dendl;
+    return;
+  }
+  for (auto& q : io_queues) {
+    int r = q->register_buffers(bufs);
+    if (r < 0) {
+      derr << __func__ << " failed to register " << bufs.size()
+	   << " buffers: " << cpp_strerror(r) << dendl;
+      return;
+    }
+  }
+  dout(1) << __func__ << " registered " << bufs.size() << " buffers" << dendl;
+}
+
 // create a buffer basing on user-configurable. it's intended to make
 // our buffers THP-able.
 ceph::unique_leakable_ptr<buffer::raw> KernelDevice::create_custom_aligned(
@@ -1310,10 +1450,7 @@ ceph::unique_leakable_ptr<buffer::raw> KernelDevice::create_custom_aligned(
   if (len < CEPH_PAGE_SIZE) {
     return ceph::buffer::create_small_page_aligned(len);
   } else {
-    static HugePagePoolOfPools hp_pools = HugePagePoolOfPools::from_desc(
-      cct->_conf.get_val<std::string>("bdev_read_preallocated_huge_buffers")
-    );
-    if (auto lucky_raw = hp_pools.try_create(len); lucky_raw) {
+    if (auto lucky_raw = get_huge_page_pools(cct).try_create(len); lucky_raw) {
       dout(20) << __func__ << " allocated from huge pool"
 	       << " lucky_raw.data=" << (void*)lucky_raw->get_data()
 	       << " bdev_read_preallocated_huge_buffers="
@@ -32,6 +32,9 @@
 enum {
   l_blk_kernel_device_first = 1000,
   l_blk_kernel_device_discard_op,
+  l_blk_kernel_device_write_direct_op,
+  l_blk_kernel_device_write_rebuild_op,
+  l_blk_kernel_device_write_rebuild_bytes,
   l_blk_kernel_device_last,
 };
 
@@ -54,7 +57,8 @@ private:
   std::atomic<bool> io_since_flush = {false};
   ceph::mutex flush_mutex = ceph::make_mutex("KernelDevice::flush_mutex");
 
-  std::unique_ptr<io_queue_t> io_queue;
+  /// one queue per completion thread; submitters are spread across them
+  std::vector<std::unique_ptr<io_queue_t>> io_queues;
   aio_callback_t discard_callback;
   void *discard_callback_priv;
   bool aio_stop;
@@ -68,12 +72,14 @@ private:
 
   struct AioCompletionThread : public Thread {
     KernelDevice *bdev;
-    explicit AioCompletionThread(KernelDevice *b) : bdev(b) {}
+    const unsigned qid;
+    AioCompletionThread(KernelDevice *b, unsigned qid) : bdev(b), qid(qid) {}
     void *entry() override {
-      bdev->_aio_thread();
+      bdev->_aio_thread(qid);
       return NULL;
     }
-  } aio_thread;
+  };
+  std::vector<std::unique_ptr<AioCompletionThread>> aio_threads;
 
   struct DiscardThread : public Thread {
     KernelDevice *bdev;
@@ -92,13 +98,17 @@ private:
   virtual int _post_open() { return 0; }  // hook for child implementations
   virtual void  _pre_close() { }  // hook for child implementations
 
-  void _aio_thread();
+  void _aio_thread(unsigned qid);
+  io_queue_t* _choose_io_queue();
+  void _aio_submit(IOContext *ioc, io_queue_t *io_queue);
+  void _aio_set_numa_affinity();
   void _discard_thread(uint64_t tid);
   void _queue_discard(interval_set<uint64_t> &to_release);
   bool try_discard(interval_set<uint64_t> &to_release, bool async = true) override;
 
   int _aio_start();
   void _aio_stop();
+  void _aio_register_buffers();
 
   void _discard_update_threads(bool discard_stop = false);
   void _discard_stop();
@@ -107,6 +117,7 @@ private:
   void _aio_log_start(IOContext *ioc, uint64_t offset, uint64_t length);
   void _aio_log_finish(IOContext *ioc, uint64_t offset, uint64_t length);
 
+  void _align_write_buffer(ceph::buffer::list& bl, bool buffered);
   int _sync_write(uint64_t off, ceph::buffer::list& bl, bool buffered, int write_hint);
 
   int _lock();
@@ -17,6 +17,8 @@ struct ioring_data {
   pthread_mutex_t sq_mutex;
   int epoll_fd = -1;
   std::map<int, int> fixed_fds_map;
+  /// registered buffers: start address -> (length, buffer index)
+  std::map<uintptr_t, std::pair<size_t, int>> fixed_bufs_map;
 };
 
 static int ioring_get_cqe(struct ioring_data *d, unsigned int max,
@@ -50,6 +52,23 @@ static int find_fixed_fd(struct ioring_data *d, int real_fd)
   return it->second;
 }
 
+// index of the registered buffer holding the whole of a single-iovec io
+static int find_fixed_buf(struct ioring_data *d, struct aio_t *io)
+{
+  if (d->fixed_bufs_map.empty() || io->iov.size() != 1)
+    return -1;
+
+  uintptr_t base = (uintptr_t)io->iov[0].iov_base;
+  auto it = d->fixed_bufs_map.upper_bound(base);
+  if (it == d->fixed_bufs_map.begin())
+    return -1;
+  --it;
+  if (base + io->iov[0].iov_len > it->first + it->second.first)
+    return -1;
+
+  return it->second.second;
+}
+
 static void init_sqe(struct ioring_data *d, struct io_uring_sqe *sqe,
 		     struct aio_t *io)
 {
@@ -57,7 +76,14 @@ static void init_sqe(struct ioring_data *d, struct io_uring_sqe *sqe,
 
   ceph_assert(fixed_fd != -1);
 
-  if (io->iocb.aio_lio_opcode == IO_CMD_PWRITEV)
+  int fixed_buf = find_fixed_buf(d, io);
+  if (fixed_buf >= 0 && io->iocb.aio_lio_opcode == IO_CMD_PWRITEV)
+    io_uring_prep_write_fixed(sqe, fixed_fd, io->iov[0].iov_base,
+			      io->iov[0].iov_len, io->offset, fixed_buf);
+  else if (fixed_buf >= 0 && io->iocb.aio_lio_opcode == IO_CMD_PREADV)
+    io_uring_prep_read_fixed(sqe, fixed_fd, io->iov[0].iov_base,
+			     io->iov[0].iov_len, io->offset, fixed_buf);
+  else if (io->iocb.aio_lio_opcode == IO_CMD_PWRITEV)
     io_uring_prep_writev(sqe, fixed_fd, &io->iov[0],
 			 io->iov.size(), io->offset);
   else if (io->iocb.aio_lio_opcode == IO_CMD_PREADV)
@@ -106,11 +132,13 @@ static void build_fixed_fds_map(struct ioring_data *d,
   }
 }
 
-ioring_queue_t::ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_) :
+ioring_queue_t::ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_,
+			       unsigned sq_thread_idle_ms_) :
   d(make_unique<ioring_data>()),
   iodepth(iodepth_),
   hipri(hipri_),
-  sq_thread(sq_thread_)
+  sq_thread(sq_thread_),
+  sq_thread_idle_ms(sq_thread_idle_ms_)
 {
 }
 
@@ -120,17 +148,20 @@ ioring_queue_t::~ioring_queue_t()
 
 int ioring_queue_t::init(std::vector<int> &fds)
 {
-  unsigned flags = 0;
+  struct io_uring_params params = {};
 
   pthread_mutex_init(&d->cq_mutex, NULL);
   pthread_mutex_init(&d->sq_mutex, NULL);
 
   if (hipri)
-    flags |= IORING_SETUP_IOPOLL;
-  if (sq_thread)
-    flags |= IORING_SETUP_SQPOLL;
+    params.flags |= IORING_SETUP_IOPOLL;
+  if (sq_thread) {
+    params.flags |= IORING_SETUP_SQPOLL;
+    /* how long the kernel poller spins before it needs a wakeup */
+    params.sq_thread_idle = sq_thread_idle_ms;
+  }
 
-  int ret = io_uring_queue_init(iodepth, &d->io_uring, flags);
+  int ret = io_uring_queue_init_params(iodepth, &d->io_uring, &params);
   if (ret < 0)
     return ret;
 
@@ -171,6 +202,10 @@ close_ring_fd:
 
 void ioring_queue_t::shutdown()
 {
+  if (!d->fixed_bufs_map.empty()) {
+    d->fixed_bufs_map.clear();
+    io_uring_unregister_buffers(&d->io_uring);
+  }
   d->fixed_fds_map.clear();
   close(d->epoll_fd);
   d->epoll_fd = -1;
@@ -211,6 +246,24 @@ get_cqe:
   return events;
 }
 
+int ioring_queue_t::register_buffers(const std::vector<iovec>& bufs)
+{
+  if (bufs.empty())
+    return 0;
+
+  pthread_mutex_lock(&d->sq_mutex);
+  int ret = io_uring_register_buffers(&d->io_uring, &bufs[0], bufs.size());
+  if (ret == 0) {
+    for (int i = 0; i < (int)bufs.size(); i++) {
+      d->fixed_bufs_map[(uintptr_t)bufs[i].iov_base] =
+	std::make_pair(bufs[i].iov_len, i);
+    }
+  }
+  pthread_mutex_unlock(&d->sq_mutex);
+
+  return ret;
+}
+
 bool ioring_queue_t::supported()
 {
   struct io_uring ring;
@@ -226,7 +279,8 @@ bool ioring_queue_t::supported()
 
 struct ioring_data {};
 
-ioring_queue_t::ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_)
+ioring_queue_t::ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_,
+			       unsigned sq_thread_idle_ms_)
 {
   ceph_assert(0);
 }
@@ -258,6 +312,11 @@ int ioring_queue_t::get_next_completed(int timeout_ms, aio_t **paio, int max)
   ceph_assert(0);
 }
 
+int ioring_queue_t::register_buffers(const std::vector<iovec>& bufs)
+{
+  ceph_assert(0);
+}
+
 bool ioring_queue_t::supported()
 {
   return false;
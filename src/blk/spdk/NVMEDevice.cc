@@ -27,6 +27,7 @@
 #include <fstream>
 #include <functional>
 #include <map>
+#include <memory>
 #include <thread>
 #include <boost/intrusive/slist.hpp>
 
@@ -142,13 +143,14 @@ class SharedDriverData {
 };
 
 class SharedDriverQueueData {
-  NVMEDevice *bdev;
   SharedDriverData *driver;
   spdk_nvme_ctrlr *ctrlr;
   spdk_nvme_ns *ns;
   std::string sn;
   uint32_t block_size;
   uint32_t max_queue_depth;
+  uint32_t max_io_completion;
+  uint64_t io_sleep_in_us;
   struct spdk_nvme_qpair *qpair;
   int alloc_buf_from_pool(Task *t, bool write);
 
@@ -158,12 +160,13 @@ class SharedDriverQueueData {
     bi::slist<data_cache_buf, bi::constant_time_size<true>> data_buf_list;
     void _aio_handle(Task *t, IOContext *ioc);
 
-    SharedDriverQueueData(NVMEDevice *bdev, SharedDriverData *driver)
-      : bdev(bdev),
-        driver(driver) {
+    explicit SharedDriverQueueData(SharedDriverData *driver)
+      : driver(driver) {
     ctrlr = driver->ctrlr;
     ns = driver->ns;
     block_size = driver->block_size;
+    max_io_completion = (uint32_t)g_conf().get_val<uint64_t>("bluestore_spdk_max_io_completion");
+    io_sleep_in_us = g_conf().get_val<uint64_t>("bluestore_spdk_io_sleep");
 
     struct spdk_nvme_io_qpair_opts opts = {};
     spdk_nvme_ctrlr_get_default_io_qpair_opts(ctrlr, &opts, sizeof(opts));
@@ -352,8 +355,6 @@ void SharedDriverQueueData::_aio_handle(Task *t, IOContext *ioc)
 
   int r = 0;
   uint64_t lba_off, lba_count;
-  uint32_t max_io_completion = (uint32_t)g_conf().get_val<uint64_t>("bluestore_spdk_max_io_completion");
-  uint64_t io_sleep_in_us = g_conf().get_val<uint64_t>("bluestore_spdk_io_sleep");
 
   while (ioc->num_running) {
  again:
@@ -810,8 +811,16 @@ void NVMEDevice::aio_submit(IOContext *ioc)
     // Only need to push the first entry
     ioc->nvme_task_first = ioc->nvme_task_last = nullptr;
 
-    thread_local SharedDriverQueueData queue_t = SharedDriverQueueData(this, driver);
-    queue_t._aio_handle(t, ioc);
+    // one qpair per submitting thread, keyed by controller.  Only one
+    // device per osd is supported for now (see register_ctrlr()), but a
+    // queue must never be used with a driver other than its own.
+    thread_local std::map<SharedDriverData*,
+                          std::unique_ptr<SharedDriverQueueData>> queues;
+    auto& queue_t = queues[driver];
+    if (!queue_t) {
+      queue_t = std::make_unique<SharedDriverQueueData>(driver);
+    }
+    queue_t->_aio_handle(t, ioc);
   }
 }
 
@@ -421,6 +421,8 @@ Client::Client(Messenger *m, MonClient *mc, Objecter *objecter_)
 				  cct->_conf->client_oc_target_dirty,
 				  cct->_conf->client_oc_max_dirty_age,
 				  true));
+  objectcacher->set_max_dirty_extent(
+    cct->_conf.get_val<Option::size_t>("client_oc_max_dirty_extent"));
 }
 
 
@@ -11208,8 +11210,10 @@ int Client::_read_async(Fh *f, uint64_t off, uint64_t len, bufferlist *bl,
     return 0;
   }
 
-  // Wait for the blocking read to complete and then do readahead
   if (r == 0) {
+    // the read missed the cache: start the readahead now so that it is
+    // fetched in parallel with this read, not after it returns
+    do_readahead(f, in, off, len);
     client_lock.unlock();
     r = io_finish_cond->wait();
     client_lock.lock();
@@ -11217,10 +11221,9 @@ int Client::_read_async(Fh *f, uint64_t off, uint64_t len, bufferlist *bl,
     update_read_io_size(bl->length());
   } else {
     put_cap_ref(in, CEPH_CAP_FILE_CACHE);
+    do_readahead(f, in, off, len);
   }
 
-  do_readahead(f, in, off, len);
-
   return r;
 }
 
@@ -17437,6 +17440,7 @@ const char** Client::get_tracked_conf_keys() const
     "client_oc_max_dirty",
     "client_oc_target_dirty",
     "client_oc_max_dirty_age",
+    "client_oc_max_dirty_extent",
     "client_caps_release_delay",
     "client_mount_timeout",
     NULL
@@ -17472,6 +17476,10 @@ void Client::handle_conf_change(const ConfigProxy& conf,
   if (changed.count("client_oc_max_dirty_age")) {
     objectcacher->set_max_dirty_age(cct->_conf->client_oc_max_dirty_age);
   }
+  if (changed.count("client_oc_max_dirty_extent")) {
+    objectcacher->set_max_dirty_extent(
+      cct->_conf.get_val<Option::size_t>("client_oc_max_dirty_extent"));
+  }
   if (changed.count("client_collect_and_send_global_metrics")) {
     _collect_and_send_global_metrics = cct->_conf.get_val<bool>(
       "client_collect_and_send_global_metrics");
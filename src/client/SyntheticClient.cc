@@ -14,8 +14,10 @@
 
 #include "include/compat.h"
 
+#include <atomic>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 
 #include "common/config.h"
@@ -165,6 +167,11 @@ void parse_syn_options(vector<const char*>& args)
         syn_modes.push_back( SYNCLIENT_MODE_OPENSHARED );
         syn_iargs.push_back( atoi(args[++i]) );
         syn_iargs.push_back( atoi(args[++i]) );
+      } else if (strcmp(args[i],"statthreads") == 0) {
+        syn_modes.push_back( SYNCLIENT_MODE_STATTHREADS );
+        syn_iargs.push_back( atoi(args[++i]) );
+        syn_iargs.push_back( atoi(args[++i]) );
+        syn_iargs.push_back( atoi(args[++i]) );
       } else if (strcmp(args[i],"createobjects") == 0) {
         syn_modes.push_back( SYNCLIENT_MODE_CREATEOBJECTS );
         syn_iargs.push_back( atoi(args[++i]) );
@@ -605,6 +612,19 @@ int SyntheticClient::run()
       }
       break;
 
+    case SYNCLIENT_MODE_STATTHREADS:
+      {
+        int num = iargs.front();  iargs.pop_front();
+        int seconds = iargs.front();  iargs.pop_front();
+        int max_threads = iargs.front();  iargs.pop_front();
+        if (run_me()) {
+          dout(2) << "statthreads " << num << " " << seconds << " " << max_threads << dendl;
+          stat_threads(num, seconds, max_threads);
+        }
+	did_run_me();
+      }
+      break;
+
     case SYNCLIENT_MODE_CREATEOBJECTS:
       {
         int count = iargs.front();  iargs.pop_front();
@@ -1934,6 +1954,40 @@ int SyntheticClient::create_shared(int num)
   return 0;
 }
 
+// stat the createshared files from 1, 2, 4, ... max_threads threads sharing
+// this client, to show how metadata ops/sec scale with concurrency
+int SyntheticClient::stat_threads(int num, int seconds, int max_threads)
+{
+  if (num <= 0)
+    return -EINVAL;
+  UserPerm perms = client->pick_my_perms();
+  for (int threads = 1; threads <= max_threads && !time_to_stop(); threads *= 2) {
+    std::atomic<uint64_t> ops = 0;
+    utime_t start = ceph_clock_now();
+    utime_t end = start;
+    end += (double)seconds;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back([this, &ops, &perms, end, num, t] {
+        char d[255];
+        struct stat st;
+        uint64_t n = 0;
+        for (int i = t; ceph_clock_now() < end; i++, n++) {
+          snprintf(d, sizeof(d), "test/file.%d", i % num);
+          client->lstat(d, &st, perms);
+        }
+        ops += n;
+      });
+    }
+    for (auto &w : workers)
+      w.join();
+    double el = (double)(ceph_clock_now() - start);
+    dout(0) << "stat_threads " << threads << " threads " << ops.load()
+            << " ops " << (ops.load() / el) << " ops/sec" << dendl;
+  }
+  return 0;
+}
+
 int SyntheticClient::open_shared(int num, int count)
 {
   // files
@@ -38,6 +38,7 @@
 #define SYNCLIENT_MODE_MAKEFILES2   12     // num count private
 #define SYNCLIENT_MODE_CREATESHARED 13     // num
 #define SYNCLIENT_MODE_OPENSHARED   14     // num count
+#define SYNCLIENT_MODE_STATTHREADS  15     // num seconds max_threads
 
 #define SYNCLIENT_MODE_RMFILE      19
 #define SYNCLIENT_MODE_WRITEFILE   20
@@ -237,6 +238,7 @@ class SyntheticClient {
 
   int create_shared(int num);
   int open_shared(int num, int count);
+  int stat_threads(int num, int seconds, int max_threads);
 
   int rm_file(std::string& fn);
   int write_file(std::string& fn, int mb, loff_t chunk);
@@ -167,9 +167,11 @@ static int chunk_put_ref(cls_method_context_t hctx,
   if (ret < 0)
     return ret;
 
-  if (!objr.put(op.source)) {
-    CLS_LOG(10, "oid=%s (no ref)\n", op.source.oid.name.c_str());
-    return -ENOLINK;
+  for (uint32_t i = 0; i < op.count; ++i) {
+    if (!objr.put(op.source)) {
+      CLS_LOG(10, "oid=%s (no ref)\n", op.source.oid.name.c_str());
+      return -ENOLINK;
+    }
   }
 
   if (objr.empty()) {
@@ -214,6 +216,7 @@ CLS_INIT(cas)
   cls_method_handle_t h_chunk_create_or_get_ref;
   cls_method_handle_t h_chunk_get_ref;
   cls_method_handle_t h_chunk_put_ref;
+  cls_method_handle_t h_chunk_put_refs;
   cls_method_handle_t h_references_chunk;
 
   cls_register("cas", &h_class);
@@ -230,6 +233,12 @@ CLS_INIT(cas)
 			  CLS_METHOD_RD | CLS_METHOD_WR,
 			  chunk_put_ref,
 			  &h_chunk_put_ref);
+  // same method; the separate name lets callers that batch puts find
+  // out (-EOPNOTSUPP) that this OSD would ignore cls_cas_chunk_put_ref_op::count
+  cls_register_cxx_method(h_class, "chunk_put_refs",
+			  CLS_METHOD_RD | CLS_METHOD_WR,
+			  chunk_put_ref,
+			  &h_chunk_put_refs);
   cls_register_cxx_method(h_class, "references_chunk", CLS_METHOD_RD,
 			  references_chunk,
 			  &h_references_chunk);
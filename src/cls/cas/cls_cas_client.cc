@@ -53,6 +53,19 @@ void cls_cas_chunk_put_ref(
   op.exec("cas", "chunk_put_ref", in);
 }
 
+void cls_cas_chunk_put_refs(
+  librados::ObjectWriteOperation& op,
+  const hobject_t& soid,
+  uint32_t count)
+{
+  bufferlist in;
+  cls_cas_chunk_put_ref_op call;
+  call.source = soid;
+  call.count = count;
+  encode(call, in);
+  op.exec("cas", "chunk_put_refs", in);
+}
+
 int cls_cas_references_chunk(
   librados::IoCtx& io_ctx,
   const string& oid,
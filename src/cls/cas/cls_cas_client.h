@@ -29,6 +29,13 @@ void cls_cas_chunk_put_ref(
   librados::ObjectWriteOperation& op,
   const hobject_t& soid);
 
+/// drop count references held by soid on existing chunk; fails with
+/// -EOPNOTSUPP on OSDs that predate it
+void cls_cas_chunk_put_refs(
+  librados::ObjectWriteOperation& op,
+  const hobject_t& soid,
+  uint32_t count);
+
 
 //
 // advanced (used for scrub, repair, etc.)
@@ -74,26 +74,36 @@ WRITE_CLASS_ENCODER(cls_cas_chunk_get_ref_op)
 
 struct cls_cas_chunk_put_ref_op {
   hobject_t source;
+  uint32_t count = 1;  ///< number of refs held by source to drop
 
   cls_cas_chunk_put_ref_op() {}
 
   void encode(ceph::buffer::list& bl) const {
-    ENCODE_START(1, 1, bl);
+    ENCODE_START(2, 1, bl);
     encode(source, bl);
+    encode(count, bl);
     ENCODE_FINISH(bl);
   }
 
   void decode(ceph::buffer::list::const_iterator& bl) {
-    DECODE_START(1, bl);
+    DECODE_START(2, bl);
     decode(source, bl);
+    if (struct_v >= 2) {
+      decode(count, bl);
+    } else {
+      count = 1;
+    }
     DECODE_FINISH(bl);
   }
 
   void dump(ceph::Formatter *f) const {
     f->dump_object("source", source);
+    f->dump_unsigned("count", count);
   }
   static void generate_test_instances(std::list<cls_cas_chunk_put_ref_op*>& ls) {
     ls.push_back(new cls_cas_chunk_put_ref_op());
+    ls.push_back(new cls_cas_chunk_put_ref_op());
+    ls.back()->count = 3;
   }
 };
 WRITE_CLASS_ENCODER(cls_cas_chunk_put_ref_op)
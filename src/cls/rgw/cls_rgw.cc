@@ -162,8 +162,12 @@ static void bi_reshard_log_key(cls_method_context_t hctx, string& key, const str
   key.append(idx);
 }
 
+// with a non-null batch the omap key/value is added to it for the caller to
+// write with cls_cxx_map_set_vals(); likewise for log_index_operation() and
+// write_entry()
 static int reshard_log_index_operation(cls_method_context_t hctx, const string& idx,
-                                       const cls_rgw_obj_key& key, bufferlist* log_bl)
+                                       const cls_rgw_obj_key& key, bufferlist* log_bl,
+                                       std::map<std::string, bufferlist>* batch = nullptr)
 {
   string reshard_log_idx;
   bi_reshard_log_key(hctx, reshard_log_idx, idx);
@@ -178,6 +182,10 @@ static int reshard_log_index_operation(cls_method_context_t hctx, const string&
     reshard_log_entry.data = *log_bl;
   }
   reshard_log_entry.idx = idx;
+  if (batch) {
+    encode(reshard_log_entry, (*batch)[reshard_log_idx]);
+    return 0;
+  }
   bufferlist bl;
   encode(reshard_log_entry, bl);
   return cls_cxx_map_set_val(hctx, reshard_log_idx, &bl);
@@ -199,7 +207,8 @@ static void bi_log_index_key(cls_method_context_t hctx, string& key, string& id,
 static int log_index_operation(cls_method_context_t hctx, const cls_rgw_obj_key& obj_key,
                                RGWModifyOp op, const string& tag, real_time timestamp,
                                const rgw_bucket_entry_ver& ver, RGWPendingState state, uint64_t index_ver,
-                               string& max_marker, uint16_t bilog_flags, string *owner, string *owner_display_name, rgw_zone_set *zones_trace)
+                               string& max_marker, uint16_t bilog_flags, string *owner, string *owner_display_name, rgw_zone_set *zones_trace,
+                               std::map<std::string, bufferlist>* batch = nullptr)
 {
   bufferlist bl;
 
@@ -232,6 +241,10 @@ static int log_index_operation(cls_method_context_t hctx, const cls_rgw_obj_key&
   if (entry.id > max_marker)
     max_marker = entry.id;
 
+  if (batch) {
+    (*batch)[key] = std::move(bl);
+    return 0;
+  }
   return cls_cxx_map_set_val(hctx, key, &bl);
 }
 
@@ -737,24 +750,40 @@ static int write_bucket_header(cls_method_context_t hctx, rgw_bucket_dir_header
 
 template <class T>
 static int write_entry(cls_method_context_t hctx, T& entry, const string& key,
-                       rgw_bucket_dir_header& header, bool count_entry = true)
+                       rgw_bucket_dir_header& header, bool count_entry = true,
+                       std::map<std::string, bufferlist>* batch = nullptr)
 {
-  bufferlist bl;
+  if (!header.resharding_in_logrecord()) {
+    bufferlist bl;
+    encode(entry, bl);
+    if (batch) {
+      (*batch)[key] = std::move(bl);
+      return 0;
+    }
+    return cls_cxx_map_set_val(hctx, key, &bl);
+  }
+
+  // write the entry and its reshard log record together
+  std::map<std::string, bufferlist> vals;
+  auto& out = batch ? *batch : vals;
+  bufferlist& bl = out[key];
+  bl.clear();
   encode(entry, bl);
-  int ret = cls_cxx_map_set_val(hctx, key, &bl);
+  int ret = reshard_log_index_operation(hctx, key, entry.key, &bl, &out);
   if (ret < 0) {
     return ret;
   }
-  if (header.resharding_in_logrecord()) {
-    ret = reshard_log_index_operation(hctx, key, entry.key, &bl);
-    header.reshardlog_entries++;
+  header.reshardlog_entries++;
+  if (batch) {
+    return 0;
   }
-  return ret;
+  return cls_cxx_map_set_vals(hctx, &vals);
 }
 
 static int remove_entry(cls_method_context_t hctx, const string& idx,
                         const cls_rgw_obj_key& key,
-                        rgw_bucket_dir_header& header)
+                        rgw_bucket_dir_header& header,
+                        std::map<std::string, bufferlist>* batch = nullptr)
 {
   int ret = cls_cxx_map_remove_key(hctx, idx);
   if (ret < 0) {
@@ -764,7 +793,7 @@ static int remove_entry(cls_method_context_t hctx, const string& idx,
   if (header.resharding_in_logrecord()) {
     header.reshardlog_entries++;
     bufferlist empty;
-    return reshard_log_index_operation(hctx, idx, key, &empty);
+    return reshard_log_index_operation(hctx, idx, key, &empty, batch);
   }
   return 0;
 }
@@ -1209,6 +1238,10 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
   // controls whether this operation is logged (depends on op.op and ondisk)
   bool log_op = default_log_op;
 
+  // the entry, reshard log and bilog updates for op.key go out as a
+  // single omap write below
+  std::map<std::string, bufferlist> vals;
+
   entry.ver = op.ver;
   if (op.op == CLS_RGW_OP_CANCEL) {
     log_op = false; // don't log cancelation
@@ -1218,7 +1251,7 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
         CLS_LOG_BITX(bitx_inst, 20,
                      "INFO: %s: removing map entry with key=%s",
                      __func__, escape_str(idx).c_str());
-        rc = remove_entry(hctx, idx, entry.key, header);
+        rc = remove_entry(hctx, idx, entry.key, header, &vals);
         if (rc < 0) {
           CLS_LOG_BITX(bitx_inst, 1,
                        "ERROR: %s: unable to remove map key, key=%s, rc=%d",
@@ -1231,7 +1264,7 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
         CLS_LOG_BITX(bitx_inst, 20,
                      "INFO: %s: setting map entry at key=%s",
                      __func__, escape_str(idx).c_str());
-        rc = write_entry(hctx, entry, idx, header);
+        rc = write_entry(hctx, entry, idx, header, true, &vals);
         if (rc < 0) {
           CLS_LOG_BITX(bitx_inst, 1,
                        "ERROR: %s: unable to set map val, key=%s, rc=%d",
@@ -1259,7 +1292,7 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
 	CLS_LOG_BITX(bitx_inst, 20,
 		     "INFO: %s: removing map entry with key=%s",
 		     __func__, escape_str(idx).c_str());
-      rc = remove_entry(hctx, idx, entry.key, header);
+      rc = remove_entry(hctx, idx, entry.key, header, &vals);
       if (rc < 0) {
 	  CLS_LOG_BITX(bitx_inst, 1,
 		       "ERROR: %s: unable to remove map key, key=%s, rc=%d",
@@ -1272,7 +1305,7 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
 		   "INFO: %s: setting map entry at key=%s",
 		   __func__, escape_str(idx).c_str());
 
-      rc = write_entry(hctx, entry, idx, header);
+      rc = write_entry(hctx, entry, idx, header, true, &vals);
       if (rc < 0) {
 	CLS_LOG_BITX(bitx_inst, 1,
 		     "ERROR: %s: unable to set map val, key=%s, rc=%d",
@@ -1302,7 +1335,7 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
     CLS_LOG_BITX(bitx_inst, 20,
 		 "INFO: %s: setting map entry at key=%s",
 		 __func__, escape_str(idx).c_str());
-    rc = write_entry(hctx, entry, idx, header);
+    rc = write_entry(hctx, entry, idx, header, true, &vals);
     if (rc < 0) {
       CLS_LOG_BITX(bitx_inst, 1,
 		   "ERROR: %s: unable to set map value at key=%s, rc=%d",
@@ -1315,7 +1348,7 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
     rc = log_index_operation(hctx, op.key, op.op, op.tag, entry.meta.mtime,
 			     entry.ver, CLS_RGW_STATE_COMPLETE, header.ver,
 			     header.max_marker, op.bilog_flags, NULL, NULL,
-			     &op.zones_trace);
+			     &op.zones_trace, &vals);
     if (rc < 0) {
       CLS_LOG_BITX(bitx_inst, 0,
 		   "ERROR: %s: log_index_operation failed with rc=%d",
@@ -1324,6 +1357,17 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
     }
   }
 
+  // flush before remove_objs, which may touch the same keys
+  if (!vals.empty()) {
+    rc = cls_cxx_map_set_vals(hctx, &vals);
+    if (rc < 0) {
+      CLS_LOG_BITX(bitx_inst, 1,
+		   "ERROR: %s: unable to set map values for key=%s, rc=%d",
+		   __func__, escape_str(idx).c_str(), rc);
+      return rc;
+    }
+  }
+
   CLS_LOG_BITX(bitx_inst, 20, "INFO: %s: remove_objs.size()=%d",
 	       __func__, (int)op.remove_objs.size());
   for (const auto& remove_key : op.remove_objs) {
@@ -546,6 +546,35 @@ int cls_rgw_bi_list(librados::IoCtx& io_ctx, const std::string& oid,
   return 0;
 }
 
+void cls_rgw_bi_list(librados::ObjectReadOperation& op,
+                     const std::string& name_filter, const std::string& marker, uint32_t max,
+                     bool reshardlog, rgw_cls_bi_list_ret *pdata, int *ret)
+{
+  bufferlist in;
+  rgw_cls_bi_list_op call;
+  call.name_filter = name_filter;
+  call.marker = marker;
+  call.max = max;
+  call.reshardlog = reshardlog;
+  encode(call, in);
+  op.exec(RGW_CLASS, RGW_BI_LIST, in, new ClsBucketIndexOpCtx<rgw_cls_bi_list_ret>(pdata, ret));
+}
+
+static bool issue_bi_list_op(librados::IoCtx& io_ctx, const string& oid, const int shard_id,
+                             const string& marker, uint32_t max, bool reshardlog,
+                             BucketIndexAioManager *manager,
+                             rgw_cls_bi_list_ret *pdata)
+{
+  librados::ObjectReadOperation op;
+  cls_rgw_bi_list(op, "", marker, max, reshardlog, pdata, nullptr);
+  return manager->aio_operate(io_ctx, shard_id, oid, &op);
+}
+
+int CLSRGWIssueBIList::issue_op(const int shard_id, const string& oid)
+{
+  return issue_bi_list_op(io_ctx, oid, shard_id, marker, max, reshardlog, &manager, &result[shard_id]);
+}
+
 int cls_rgw_bucket_link_olh(librados::IoCtx& io_ctx, const string& oid,
                             const cls_rgw_obj_key& key, const bufferlist& olh_tag,
                             bool delete_marker, const string& op_tag, const rgw_bucket_dir_entry_meta *meta,
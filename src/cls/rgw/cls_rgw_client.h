@@ -395,6 +395,9 @@ void cls_rgw_bi_put_entries(librados::ObjectWriteOperation& op,
 int cls_rgw_bi_list(librados::IoCtx& io_ctx, const std::string& oid,
                    const std::string& name, const std::string& marker, uint32_t max,
                    std::list<rgw_cls_bi_entry> *entries, bool *is_truncated, bool reshardlog = false);
+void cls_rgw_bi_list(librados::ObjectReadOperation& op,
+                     const std::string& name, const std::string& marker, uint32_t max,
+                     bool reshardlog, rgw_cls_bi_list_ret *pdata, int *ret);
 
 void cls_rgw_bucket_link_olh(librados::ObjectWriteOperation& op,
                             const cls_rgw_obj_key& key, const ceph::buffer::list& olh_tag,
@@ -543,6 +546,29 @@ public:
       CLSRGWConcurrentIO(io_ctx, _bucket_objs, max_aio) {}
 };
 
+/**
+ * List the first max index entries after marker (or, with reshardlog,
+ * reshard log entries) of every shard. Shards whose object doesn't
+ * exist get an empty, untruncated result.
+ */
+class CLSRGWIssueBIList : public CLSRGWConcurrentIO {
+  std::string marker;
+  uint32_t max;
+  bool reshardlog;
+  std::map<int, rgw_cls_bi_list_ret>& result;
+protected:
+  int issue_op(int shard_id, const std::string& oid) override;
+  int valid_ret_code() override { return -ENOENT; }
+public:
+  CLSRGWIssueBIList(librados::IoCtx& io_ctx, const std::string& _marker,
+                    uint32_t _max, bool _reshardlog,
+                    std::map<int, std::string>& oids,
+                    std::map<int, rgw_cls_bi_list_ret>& bi_lists,
+                    uint32_t max_aio) :
+    CLSRGWConcurrentIO(io_ctx, oids, max_aio), marker(_marker), max(_max),
+    reshardlog(_reshardlog), result(bi_lists) {}
+};
+
 /**
  * Check the bucket index.
  *
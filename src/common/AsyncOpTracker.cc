@@ -9,21 +9,31 @@ AsyncOpTracker::AsyncOpTracker()
 }
 
 AsyncOpTracker::~AsyncOpTracker() {
-  std::lock_guard locker(m_lock);
-  ceph_assert(m_pending_ops == 0);
+  ceph_assert(m_pending_ops.load(std::memory_order_acquire) == 0);
 }
 
 void AsyncOpTracker::start_op() {
-  std::lock_guard locker(m_lock);
-  ++m_pending_ops;
+  m_pending_ops.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void AsyncOpTracker::finish_op() {
+  // drop any reference but the last without the lock
+  auto pending_ops = m_pending_ops.load(std::memory_order_acquire);
+  while (pending_ops > 1) {
+    if (m_pending_ops.compare_exchange_weak(pending_ops, pending_ops - 1,
+                                            std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+
+  // the 1 -> 0 transition happens under m_lock: once the count is zero a
+  // waiter may destroy the tracker, so it must not be touched afterwards
   Context *on_finish = nullptr;
   {
     std::lock_guard locker(m_lock);
-    ceph_assert(m_pending_ops > 0);
-    if (--m_pending_ops == 0) {
+    pending_ops = m_pending_ops.fetch_sub(1, std::memory_order_acq_rel);
+    ceph_assert(pending_ops > 0);
+    if (pending_ops == 1) {
       std::swap(on_finish, m_on_finish);
     }
   }
@@ -37,7 +47,7 @@ void AsyncOpTracker::wait_for_ops(Context *on_finish) {
   {
     std::lock_guard locker(m_lock);
     ceph_assert(m_on_finish == nullptr);
-    if (m_pending_ops > 0) {
+    if (m_pending_ops.load(std::memory_order_acquire) > 0) {
       m_on_finish = on_finish;
       return;
     }
@@ -46,7 +56,8 @@ void AsyncOpTracker::wait_for_ops(Context *on_finish) {
 }
 
 bool AsyncOpTracker::empty() {
+  // serialize with a finish_op() that is still releasing m_lock
   std::lock_guard locker(m_lock);
-  return (m_pending_ops == 0);
+  return (m_pending_ops.load(std::memory_order_acquire) == 0);
 }
 
@@ -4,6 +4,8 @@
 #ifndef CEPH_ASYNC_OP_TRACKER_H
 #define CEPH_ASYNC_OP_TRACKER_H
 
+#include <atomic>
+
 #include "common/ceph_mutex.h"
 #include "include/Context.h"
 
@@ -20,8 +22,11 @@ public:
   bool empty();
 
 private:
+  // start_op() / finish_op() sit on per-IO paths (e.g. once per librbd
+  // dispatch layer), so the counter is only touched atomically and m_lock
+  // is taken just for the last finish_op(), a waiter or empty()
   ceph::mutex m_lock = ceph::make_mutex("AsyncOpTracker::m_lock");
-  uint32_t m_pending_ops = 0;
+  std::atomic<uint32_t> m_pending_ops = 0;
   Context *m_on_finish = nullptr;
 
 };
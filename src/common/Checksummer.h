@@ -4,9 +4,13 @@
 #ifndef CEPH_OS_BLUESTORE_CHECKSUMMER
 #define CEPH_OS_BLUESTORE_CHECKSUMMER
 
+#include <algorithm>
+#include <type_traits>
+
 #include "include/buffer.h"
 #include "include/byteorder.h"
 #include "include/ceph_assert.h"
+#include "include/crc32c.h"
 
 #include "xxHash/xxhash.h"
 
@@ -90,6 +94,10 @@ public:
       ) {
       return p.crc32c(len, init_value);
     }
+    // result of ceph_crc32c_multi(), see calc_multi()
+    static init_value_t fold(uint32_t crc) {
+      return crc;
+    }
   };
 
   struct crc32c_16 {
@@ -111,6 +119,9 @@ public:
       ) {
       return p.crc32c(len, init_value) & 0xffff;
     }
+    static init_value_t fold(uint32_t crc) {
+      return crc & 0xffff;
+    }
   };
 
   struct crc32c_8 {
@@ -132,6 +143,9 @@ public:
       ) {
       return p.crc32c(len, init_value) & 0xff;
     }
+    static init_value_t fold(uint32_t crc) {
+      return crc & 0xff;
+    }
   };
 
   struct xxhash32 {
@@ -225,9 +239,22 @@ public:
     typename Alg::value_t *pv =
       reinterpret_cast<typename Alg::value_t*>(csum_data->c_str());
     pv += offset / csum_block_size;
-    while (blocks--) {
+    while (blocks) {
+      if constexpr (has_multi<Alg>::value) {
+	uint32_t crcs[MULTI_BATCH];
+	size_t n = calc_multi(init_value, csum_block_size,
+			      std::min(blocks, MULTI_BATCH), p, crcs);
+	if (n) {
+	  for (size_t i = 0; i < n; ++i, ++pv) {
+	    *pv = Alg::fold(crcs[i]);
+	  }
+	  blocks -= n;
+	  continue;
+	}
+      }
       *pv = Alg::calc(state, init_value, csum_block_size, p);
       ++pv;
+      --blocks;
     }
     Alg::fini(&state);
     return 0;
@@ -254,6 +281,27 @@ public:
     pv += offset / csum_block_size;
     size_t pos = offset;
     while (length > 0) {
+      if constexpr (has_multi<Alg>::value) {
+	uint32_t crcs[MULTI_BATCH];
+	size_t n = calc_multi(-1, csum_block_size,
+			      std::min(length / csum_block_size, MULTI_BATCH),
+			      p, crcs);
+	for (size_t i = 0; i < n; ++i, ++pv) {
+	  typename Alg::init_value_t v = Alg::fold(crcs[i]);
+	  if (*pv != v) {
+	    if (bad_csum) {
+	      *bad_csum = v;
+	    }
+	    Alg::fini(&state);
+	    return pos;
+	  }
+	  pos += csum_block_size;
+	  length -= csum_block_size;
+	}
+	if (n) {
+	  continue;
+	}
+      }
       typename Alg::init_value_t v = Alg::calc(state, -1, csum_block_size, p);
       if (*pv != v) {
 	if (bad_csum) {
@@ -269,6 +317,37 @@ public:
     Alg::fini(&state);
     return -1;  // no errors
   }
+
+private:
+  /// crc32c flavours can checksum many blocks at once, see calc_multi()
+  template<class Alg, class = void>
+  struct has_multi : std::false_type {};
+  template<class Alg>
+  struct has_multi<Alg, std::void_t<decltype(Alg::fold(0u))>>
+    : std::true_type {};
+
+  static constexpr size_t MULTI_BATCH = 64;
+
+  /// checksum up to max whole blocks that are contiguous in memory at p
+  /// with a single ceph_crc32c_multi() call, returns the number of blocks
+  /// done, 0 if fewer than two of them are (the per-block path is as good)
+  static size_t calc_multi(
+    uint32_t init_value,
+    size_t csum_block_size,
+    size_t max,
+    ceph::buffer::list::const_iterator& p,
+    uint32_t *out) {
+    auto cur = p.get_current_ptr();
+    size_t n = std::min(max, cur.length() / csum_block_size);
+    if (n < 2) {
+      return 0;
+    }
+    ceph_crc32c_multi(init_value,
+		      reinterpret_cast<const unsigned char*>(cur.c_str()),
+		      csum_block_size, n, out);
+    p += n * csum_block_size;
+    return n;
+  }
 };
 
 #endif
@@ -162,7 +162,7 @@ void Formatter::dump_format_unquoted(std::string_view name, const char *fmt, ...
 void JSONFormatter::flush(std::ostream& os)
 {
   finish_pending_string();
-  os << m_ss.str();
+  os << m_ss.view();
   if (m_line_break_enabled)
     os << "\n";
   m_ss.clear();
@@ -339,12 +339,15 @@ void JSONFormatter::dump_null(std::string_view name)
 
 void JSONFormatter::dump_unsigned(std::string_view name, uint64_t u)
 {
-  add_value(name, u);
+  // large dumps are mostly integers; skip the stringstream
+  fmt::format_int f(u);
+  add_value(name, std::string_view(f.data(), f.size()), false);
 }
 
 void JSONFormatter::dump_int(std::string_view name, int64_t s)
 {
-  add_value(name, s);
+  fmt::format_int f(s);
+  add_value(name, std::string_view(f.data(), f.size()), false);
 }
 
 void JSONFormatter::dump_float(std::string_view name, double d)
@@ -91,23 +91,31 @@ void Throttle::_reset_max(int64_t m)
   max = m;
 }
 
+// waits for, and takes, c slots; lock must be held
 bool Throttle::_wait(int64_t c, std::unique_lock<std::mutex>& l)
 {
   mono_time start;
   bool waited = false;
-  if (_should_wait(c) || !conds.empty()) { // always wait behind other waiters.
+  // always wait behind other waiters.
+  if (!conds.empty() || !_try_reserve(c)) {
     {
       auto cv = conds.emplace(conds.end());
+      // published before the predicate reads count, so a put() that
+      // misses us has already lowered count (see put())
+      ++num_waiters;
       auto w = make_scope_guard([this, cv]() {
 	  conds.erase(cv);
+	  --num_waiters;
 	});
       waited = true;
       ldout(cct, 2) << "_wait waiting..." << dendl;
       if (logger)
 	start = mono_clock::now();
 
-      cv->wait(l, [this, c, cv]() { return (!_should_wait(c) &&
-					    cv == conds.begin()); });
+      // reserve while still queued, so the lock-free path cannot slip in
+      // between our wakeup and taking the slots
+      cv->wait(l, [this, c, cv]() { return (cv == conds.begin() &&
+					    _try_reserve(c)); });
       ldout(cct, 2) << "_wait finished waiting" << dendl;
       if (logger) {
 	logger->tinc(l_throttle_wait, mono_clock::now() - start);
@@ -164,14 +172,13 @@ bool Throttle::get(int64_t c, int64_t m)
     logger->inc(l_throttle_get_started);
   }
   bool waited = false;
-  {
+  if (m || num_waiters || !_try_reserve(c)) {
     std::unique_lock l(lock);
     if (m) {
       ceph_assert(m > 0);
       _reset_max(m);
     }
     waited = _wait(c, l);
-    count += c;
   }
   if (logger) {
     logger->inc(l_throttle_get);
@@ -192,18 +199,11 @@ bool Throttle::get_or_fail(int64_t c)
   }
 
   assert (c >= 0);
-  bool result = false;
-  {
-    std::lock_guard l(lock);
-    if (_should_wait(c) || !conds.empty()) {
-      ldout(cct, 10) << "get_or_fail " << c << " failed" << dendl;
-      result = false;
-    } else {
-      ldout(cct, 10) << "get_or_fail " << c << " success (" << count.load()
-	<< " -> " << (count.load() + c) << ")" << dendl;
-      count += c;
-      result = true;
-    }
+  bool result = !num_waiters && _try_reserve(c);
+  if (result) {
+    ldout(cct, 10) << "get_or_fail " << c << " success" << dendl;
+  } else {
+    ldout(cct, 10) << "get_or_fail " << c << " failed" << dendl;
   }
 
   if (logger) {
@@ -229,16 +229,18 @@ int64_t Throttle::put(int64_t c)
   ceph_assert(c >= 0);
   ldout(cct, 10) << "put " << c << " (" << count.load() << " -> "
 		 << (count.load()-c) << ")" << dendl;
-  int64_t new_count;
-  {
-    std::lock_guard l(lock);
-    new_count = count;
-    if (c) {
+  int64_t new_count = count;
+  if (c) {
+    int64_t old_count = count.fetch_sub(c);
+    // if count goes negative, we failed somewhere!
+    ceph_assert(old_count >= c);
+    new_count = old_count - c;
+    // either a waiter queued before our update and is seen here, or it
+    // will see the new count when it first checks its predicate
+    if (num_waiters) {
+      std::lock_guard l(lock);
       if (!conds.empty())
 	conds.front().notify_one();
-      // if count goes negative, we failed somewhere!
-      ceph_assert(count >= c);
-      new_count = count -= c;
     }
   }
   if (logger) {
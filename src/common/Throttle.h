@@ -28,6 +28,10 @@
  * This class defines the maximum number of slots currently taken away. The
  * excessive requests for more of them are delayed, until some slots are put
  * back, so @p get_current() drops below the limit after fulfills the requests.
+ *
+ * While nobody is waiting, get(), get_or_fail() and put() only touch atomics;
+ * the lock is taken to queue a waiter or to wake the first one, and waiters
+ * are served in FIFO order.
  */
 class Throttle final : public ThrottleInterface {
   CephContext *cct;
@@ -36,6 +40,8 @@ class Throttle final : public ThrottleInterface {
   std::atomic<int64_t> count = { 0 }, max = { 0 };
   std::mutex lock;
   std::list<std::condition_variable> conds;
+  // conds.size(), readable without the lock
+  std::atomic<size_t> num_waiters = { 0 };
   const bool use_perf;
 
 public:
@@ -44,14 +50,26 @@ public:
 
 private:
   void _reset_max(int64_t m);
-  bool _should_wait(int64_t c) const {
+  bool _should_wait(int64_t c, int64_t cur) const {
     int64_t m = max;
-    int64_t cur = count;
     return
       m &&
       ((c <= m && cur + c > m) || // normally stay under max
        (c >= m && cur > m));     // except for large c
   }
+  bool _should_wait(int64_t c) const {
+    return _should_wait(c, count);
+  }
+  // add c to count unless that would have to wait
+  bool _try_reserve(int64_t c) {
+    int64_t cur = count;
+    do {
+      if (_should_wait(c, cur)) {
+	return false;
+      }
+    } while (!count.compare_exchange_weak(cur, cur + c));
+    return true;
+  }
 
   bool _wait(int64_t c, std::unique_lock<std::mutex>& l);
 
@@ -12,6 +12,7 @@
 
 #include "TrackedOp.h"
 
+#include <algorithm>
 #include <shared_mutex> // for std::shared_lock
 #include <sstream>
 
@@ -233,6 +234,97 @@ bool OpTracker::dump_historic_slow_ops(Formatter *f, set<string> filters)
   return true;
 }
 
+void OpTracker::set_timeline(uint32_t sample_interval, uint32_t size)
+{
+  std::lock_guard l{timeline_lock};
+  if (size != timeline_ring.size()) {
+    timeline_ring.clear();
+    timeline_ring.resize(size);
+    timeline_next = 0;
+    timeline_count = 0;
+  }
+  timeline_interval = size ? sample_interval : 0;
+}
+
+void OpTracker::set_timeline_stage_names(std::vector<std::string> names)
+{
+  ceph_assert(names.size() <= TrackedOpTimeline::MAX_STAGES);
+  std::lock_guard l{timeline_lock};
+  timeline_stage_names = std::move(names);
+}
+
+void OpTracker::record_timeline(const TrackedOpTimeline& t)
+{
+  std::lock_guard l{timeline_lock};
+  if (timeline_ring.empty()) {
+    return;
+  }
+  timeline_ring[timeline_next] = t;
+  timeline_next = (timeline_next + 1) % timeline_ring.size();
+  timeline_count = std::min(timeline_count + 1, timeline_ring.size());
+}
+
+void OpTracker::dump_ops_timeline(Formatter *f)
+{
+  std::vector<std::string> names;
+  std::vector<TrackedOpTimeline> samples;
+  {
+    std::lock_guard l{timeline_lock};
+    names = timeline_stage_names;
+    samples.assign(timeline_ring.begin(),
+		   timeline_ring.begin() + timeline_count);
+  }
+  names.resize(TrackedOpTimeline::MAX_STAGES);
+
+  // time spent getting to each stage from the stage before it that the
+  // op hit; the done "stage" is the time since the last one
+  std::vector<std::vector<uint32_t>> deltas(TrackedOpTimeline::MAX_STAGES + 1);
+  std::vector<uint32_t> totals;
+  for (auto& t : samples) {
+    uint32_t prev = 0;
+    for (unsigned i = 0; i < TrackedOpTimeline::MAX_STAGES; ++i) {
+      if (t.stage_us[i] == TrackedOpTimeline::UNSET) {
+	continue;
+      }
+      deltas[i].push_back(t.stage_us[i] >= prev ? t.stage_us[i] - prev : 0);
+      prev = std::max(prev, t.stage_us[i]);
+    }
+    deltas.back().push_back(t.done_us >= prev ? t.done_us - prev : 0);
+    totals.push_back(t.done_us);
+  }
+
+  auto dump_stage = [f](const std::string& name, std::vector<uint32_t>& v) {
+    std::sort(v.begin(), v.end());
+    auto pct = [&v](unsigned p) {
+      return v[(v.size() - 1) * p / 100];
+    };
+    f->open_object_section("stage");
+    f->dump_string("stage", name);
+    f->dump_unsigned("count", v.size());
+    f->dump_unsigned("p50_us", pct(50));
+    f->dump_unsigned("p90_us", pct(90));
+    f->dump_unsigned("p99_us", pct(99));
+    f->dump_unsigned("max_us", v.back());
+    f->close_section();
+  };
+
+  f->open_object_section("ops_timeline");
+  f->dump_unsigned("sample_interval", timeline_interval);
+  f->dump_unsigned("num_samples", samples.size());
+  f->open_array_section("stages");
+  for (unsigned i = 0; i < TrackedOpTimeline::MAX_STAGES; ++i) {
+    if (!deltas[i].empty()) {
+      dump_stage(names[i].empty() ? std::to_string(i) : names[i], deltas[i]);
+    }
+  }
+  if (!deltas.back().empty()) {
+    dump_stage("done", deltas.back());
+    dump_stage("total", totals);
+  }
+  f->close_section();
+  f->close_section();
+}
+
 bool OpTracker::dump_ops_in_flight(Formatter *f, bool print_only_blocked, set<string> filters, bool count_only, dumper lambda)
 {
   if (!tracking_enabled)
@@ -14,6 +14,7 @@
 #ifndef TRACKEDREQUEST_H_
 #define TRACKEDREQUEST_H_
 
+#include <array>
 #include <atomic>
 #include "common/StackStringStream.h"
 #include "common/ceph_mutex.h"
@@ -126,6 +127,19 @@ public:
   }
 };
 
+/// stage timestamps of one sampled op, as usec since it was initiated
+struct TrackedOpTimeline {
+  static constexpr unsigned MAX_STAGES = 8;
+  static constexpr uint32_t UNSET = UINT32_MAX;
+
+  std::array<uint32_t, MAX_STAGES> stage_us;
+  uint32_t done_us = UNSET;
+
+  TrackedOpTimeline() {
+    stage_us.fill(UNSET);
+  }
+};
+
 struct ShardedTrackingData;
 class OpTracker {
   friend class OpHistory;
@@ -138,6 +152,15 @@ class OpTracker {
   std::atomic<bool> tracking_enabled;
   ceph::shared_mutex lock = ceph::make_shared_mutex("OpTracker::lock");
 
+  // ring of the timelines of 1-in-timeline_interval ops, kept whether
+  // or not tracking is enabled
+  std::atomic<uint32_t> timeline_interval = {0};
+  ceph::mutex timeline_lock = ceph::make_mutex("OpTracker::timeline_lock");
+  std::vector<std::string> timeline_stage_names; ///< protected by timeline_lock
+  std::vector<TrackedOpTimeline> timeline_ring;  ///< protected by timeline_lock
+  size_t timeline_next = 0;                      ///< protected by timeline_lock
+  size_t timeline_count = 0;                     ///< protected by timeline_lock
+
 public:
   using dumper = std::function<void(const TrackedOp&, Formatter*)>;
 
@@ -157,6 +180,21 @@ public:
   bool is_tracking() const {
     return tracking_enabled;
   }
+  /// sample every sample_interval'th op (0 to disable) into a ring of
+  /// the last size timelines
+  void set_timeline(uint32_t sample_interval, uint32_t size);
+  /// names of the stages passed to TrackedOp::mark_stage()
+  void set_timeline_stage_names(std::vector<std::string> names);
+  bool should_sample_timeline() {
+    // counted per thread so that every op doesn't bounce one shared
+    // cache line between the op queue shards
+    static thread_local uint64_t timeline_seq = 0;
+    uint32_t n = timeline_interval;
+    return n && timeline_seq++ % n == 0;
+  }
+  void record_timeline(const TrackedOpTimeline& t);
+  /// per-stage latency percentiles over the timeline ring
+  void dump_ops_timeline(ceph::Formatter *f);
   void set_tracking(bool enable) {
     tracking_enabled = enable;
   }
@@ -223,6 +261,9 @@ public:
     };
     typename R::Ref retval(new R(params, this));
     retval->tracking_start();
+    if (should_sample_timeline()) {
+      retval->timeline = std::make_unique<TrackedOpTimeline>();
+    }
     if (is_tracking()) {
       retval->mark_event("header_read", params->get_recv_stamp());
       retval->mark_event("throttled", params->get_throttle_stamp());
@@ -305,6 +346,15 @@ protected:
   std::atomic<int> state = {STATE_UNTRACKED};
   uint64_t flags = 0;
 
+  /// set for ops sampled by OpTracker::should_sample_timeline()
+  std::unique_ptr<TrackedOpTimeline> timeline;
+
+  void finish_timeline() {
+    timeline->done_us = (ceph_clock_now() - initiated_at).to_nsec() / 1000;
+    tracker->record_timeline(*timeline);
+    timeline.reset();
+  }
+
   void mark_continuous() {
     flags |= FLAG_CONTINUOUS;
   }
@@ -345,6 +395,9 @@ public:
   again:
     auto nref_snap = nref.load();
     if (nref_snap == 1) {
+      if (timeline) {
+	finish_timeline();
+      }
       switch (state.load()) {
       case STATE_UNTRACKED:
 	_unregistered();
@@ -425,6 +478,15 @@ public:
 
   void mark_event(std::string_view event, utime_t stamp=ceph_clock_now());
 
+  /// note the first time a sampled op reaches stage; no lock, no string
+  void mark_stage(unsigned stage) {
+    if (timeline && stage < TrackedOpTimeline::MAX_STAGES &&
+	timeline->stage_us[stage] == TrackedOpTimeline::UNSET) {
+      timeline->stage_us[stage] =
+	(ceph_clock_now() - initiated_at).to_nsec() / 1000;
+    }
+  }
+
   void mark_nowarn() {
     warn_interval_multiplier = 0;
   }
@@ -17,6 +17,8 @@
 
 #include "OpQueue.h"
 
+#include <random>
+
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/rbtree.hpp>
 #include <boost/intrusive/avl_set.hpp>
@@ -201,10 +203,13 @@ class WeightedPriorityQueue :  public OpQueue <T, K>
       SubQueues queues;
       unsigned total_prio;
       unsigned max_cost;
+      // per queue generator: rand() serializes every shard on one lock
+      std::minstd_rand rng;
       public:
 	Queue() :
 	  total_prio(0),
-	  max_cost(0) {
+	  max_cost(0),
+	  rng(std::random_device{}()) {
 	}
 	~Queue() {
 	  queues.clear_and_dispose(DelItem<SubQueue>());
@@ -237,7 +242,7 @@ class WeightedPriorityQueue :  public OpQueue <T, K>
 	  if (queues.size() > 1) {
 	    while (true) {
 	      // Pick a new priority out of the total priority.
-	      unsigned prio = rand() % total_prio + 1;
+	      unsigned prio = rng() % total_prio + 1;
 	      unsigned tp = total_prio - i->key;
 	      // Find the priority corresponding to the picked number.
 	      // Subtract high priorities to low priorities until the picked number
@@ -252,7 +257,7 @@ class WeightedPriorityQueue :  public OpQueue <T, K>
 	      // The next op's cost is multiplied by .9 and subtracted from the
 	      // max cost seen. Ops with lower costs will have a larger value
 	      // and allow them to be selected easier than ops with high costs.
-	      if (max_cost == 0 || rand() % max_cost <=
+	      if (max_cost == 0 || rng() % max_cost <=
 		  (max_cost - ((i->get_cost() * 9) / 10))) {
 		break;
 	      }
@@ -304,9 +309,7 @@ class WeightedPriorityQueue :  public OpQueue <T, K>
     WeightedPriorityQueue(unsigned max_per, unsigned min_c) :
       strict(),
       normal()
-      {
-	std::srand(time(0));
-      }
+      {}
     void remove_by_class(K cl, std::list<T>* removed = 0) final {
       strict.filter_class(cl, removed);
       normal.filter_class(cl, removed);
@@ -265,6 +265,7 @@ void ShardedThreadPool::shardedthreadpool_worker(uint32_t thread_index)
   std::stringstream ss;
   ss << name << " thread " << (void *)pthread_self();
   auto hb = cct->get_heartbeat_map()->add_worker(ss.str(), pthread_self());
+  wq->_thread_start(thread_index);
 
   while (!stop_threads) {
     if (pause_threads) {
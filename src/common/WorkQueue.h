@@ -25,6 +25,7 @@ struct ThreadPool {
 #else
 
 #include <atomic>
+#include <deque>
 #include <list>
 #include <set>
 #include <string>
@@ -388,7 +389,7 @@ public:
     }
   private:
     ThreadPool *m_pool;
-    std::list<T *> m_items;
+    std::deque<T *> m_items;
     uint32_t m_processing;
   };
 protected:
@@ -541,6 +542,7 @@ public:
     if (result != 0) {
       std::lock_guard locker(m_lock);
       m_context_results[ctx] = result;
+      ++m_num_results;
     }
     ThreadPool::PointerWQ<Context>::queue(ctx);
   }
@@ -550,17 +552,22 @@ protected:
 
     std::lock_guard locker(m_lock);
     m_context_results.clear();
+    m_num_results = 0;
   }
 
   void process(Context *ctx) override {
     int result = 0;
-    {
+    // most contexts complete with 0; skip the lock and lookup for them.
+    // a result is recorded before its context is queued, and the pool
+    // lock orders that against our dequeue
+    if (m_num_results > 0) {
       std::lock_guard locker(m_lock);
       ceph::unordered_map<Context *, int>::iterator it =
         m_context_results.find(ctx);
       if (it != m_context_results.end()) {
         result = it->second;
         m_context_results.erase(it);
+        --m_num_results;
       }
     }
     ctx->complete(result);
@@ -568,6 +575,7 @@ protected:
 private:
   ceph::mutex m_lock = ceph::make_mutex("ContextWQ::m_lock");
   ceph::unordered_map<Context*, int> m_context_results;
+  std::atomic<size_t> m_num_results = {0}; ///< >= m_context_results.size()
 };
 
 class ShardedThreadPool {
@@ -603,6 +611,8 @@ public:
     virtual void return_waiting_threads() = 0;
     virtual void stop_return_waiting_threads() = 0;
     virtual bool is_shard_empty(uint32_t thread_index) = 0;
+    /// called by each worker thread before it starts processing
+    virtual void _thread_start(uint32_t thread_index) {}
     void set_timeout(time_t ti) {
       timeout_interval.store(ceph::make_timespan(ti));
     }
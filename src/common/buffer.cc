@@ -2204,6 +2204,52 @@ bool buffer::ptr_node::dispose_if_hypercombined(
   }
 }
 
+namespace {
+// Freed ptr_nodes of this thread, waiting to be reused.  It is trivially
+// destructible so lists freed late in thread exit can still use it; the
+// drainer empties it and turns it off when the thread goes away.
+struct ptr_node_cache_t {
+  static constexpr unsigned max_nodes = 64;
+  void* nodes[max_nodes];
+  unsigned count;
+  bool disabled;
+};
+thread_local ptr_node_cache_t ptr_node_cache;
+
+struct ptr_node_cache_drainer_t {
+  ~ptr_node_cache_drainer_t() {
+    ptr_node_cache.disabled = true;
+    while (ptr_node_cache.count) {
+      ::operator delete(ptr_node_cache.nodes[--ptr_node_cache.count]);
+    }
+  }
+};
+thread_local ptr_node_cache_drainer_t ptr_node_cache_drainer;
+} // anonymous namespace
+
+void* buffer::ptr_node::operator new(std::size_t size)
+{
+  auto& cache = ptr_node_cache;
+  if (size == sizeof(ptr_node) && cache.count) {
+    return cache.nodes[--cache.count];
+  }
+  return ::operator new(size);
+}
+
+void buffer::ptr_node::operator delete(void* p)
+{
+  auto& cache = ptr_node_cache;
+  if (cache.count < ptr_node_cache_t::max_nodes && !cache.disabled) {
+    if (!cache.count) {
+      // make sure the drainer runs at thread exit
+      (void)&ptr_node_cache_drainer;
+    }
+    cache.nodes[cache.count++] = p;
+    return;
+  }
+  ::operator delete(p);
+}
+
 std::unique_ptr<buffer::ptr_node, buffer::ptr_node::disposer>
 buffer::ptr_node::create_hypercombined(ceph::unique_leakable_ptr<buffer::raw> r)
 {
@@ -26,6 +26,8 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <cctype>
 #include <sstream>
 
 /* Don't use standard Ceph logging in this file.
@@ -1073,9 +1075,15 @@ Option::value_t md_config_t::_get_val(
   }
 
   // In key names, leading and trailing whitespace are not significant.
-  string k(ConfFile::normalize_key_name(key));
-
-  const Option *o = find_option(k);
+  // Callers almost always pass the canonical name, so only copy the key
+  // when it needs normalizing.
+  const Option *o;
+  if (std::any_of(key.begin(), key.end(),
+		  [](unsigned char c) { return std::isspace(c); })) {
+    o = find_option(ConfFile::normalize_key_name(key));
+  } else {
+    o = find_option(key);
+  }
   if (!o) {
     // not a valid config option
     return {};
@@ -0,0 +1,107 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#ifndef CEPH_COMMON_COUNT_MIN_SKETCH_H
+#define CEPH_COMMON_COUNT_MIN_SKETCH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * decaying count-min sketch
+ *
+ * Approximate access counts for a stream of 32-bit keys (e.g.
+ * hobject_t::get_hash()) in depth * width counters.  estimate() never
+ * under-counts; it over-counts by hash collisions only.  Every
+ * decay_interval insertions all counters are halved, so the estimate is
+ * an exponentially decaying access frequency rather than a lifetime
+ * count.  Not thread-safe.
+ */
+class decaying_count_min_sketch {
+  using counter_t = uint32_t;
+
+  unsigned depth = 0;
+  unsigned width = 0;
+  uint64_t decay_interval = 0;
+  uint64_t since_decay = 0;
+  std::vector<counter_t> table;
+
+  // each row sees an independently mixed copy of the key, so keys that
+  // share their low bits (same PG) still spread over the row
+  static uint32_t mix(uint32_t key, unsigned row) {
+    uint64_t h = (uint64_t(row) << 32 | key) * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 32;
+    return static_cast<uint32_t>(h);
+  }
+  counter_t& cell(unsigned row, uint32_t key) {
+    return table[row * width + mix(key, row) % width];
+  }
+
+public:
+  decaying_count_min_sketch() = default;
+  decaying_count_min_sketch(unsigned depth, unsigned width,
+			    uint64_t decay_interval) {
+    init(depth, width, decay_interval);
+  }
+
+  /// (re)size and clear; width == 0 disables the sketch
+  void init(unsigned d, unsigned w, uint64_t interval) {
+    depth = w ? std::max(1u, d) : 0;
+    width = w;
+    decay_interval = interval;
+    since_decay = 0;
+    table.assign(size_t(depth) * width, 0);
+  }
+
+  bool enabled() const {
+    return width > 0;
+  }
+
+  void clear() {
+    std::fill(table.begin(), table.end(), 0);
+    since_decay = 0;
+  }
+
+  void insert(uint32_t key, counter_t count = 1) {
+    if (!enabled()) {
+      return;
+    }
+    for (unsigned r = 0; r < depth; ++r) {
+      counter_t& c = cell(r, key);
+      c = c > std::numeric_limits<counter_t>::max() - count ?
+	std::numeric_limits<counter_t>::max() : c + count;
+    }
+    if (decay_interval && ++since_decay >= decay_interval) {
+      decay();
+    }
+  }
+
+  counter_t estimate(uint32_t key) const {
+    if (!enabled()) {
+      return 0;
+    }
+    counter_t est = std::numeric_limits<counter_t>::max();
+    for (unsigned r = 0; r < depth; ++r) {
+      est = std::min(est, table[r * width + mix(key, r) % width]);
+    }
+    return est;
+  }
+
+  /// halve every counter
+  void decay() {
+    for (auto& c : table) {
+      c >>= 1;
+    }
+    since_decay = 0;
+  }
+
+  size_t get_memory_usage() const {
+    return table.size() * sizeof(counter_t);
+  }
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "arch/s390x.h"
 #include "common/sctp_crc32.h"
 #include "common/crc32c_intel_fast.h"
+#include "common/crc32c_intel_multi.h"
 #include "common/crc32c_aarch64.h"
 #include "common/crc32c_ppc.h"
 #include "common/crc32c_s390x.h"
@@ -61,6 +62,33 @@ ceph_crc32c_func_t ceph_choose_crc32(void)
  */
 ceph_crc32c_func_t ceph_crc32c_func = ceph_choose_crc32();
 
+static void ceph_crc32c_multi_generic(uint32_t crc, unsigned char const *data,
+				      unsigned chunk_len, unsigned count,
+				      uint32_t *out)
+{
+  for (unsigned i = 0; i < count; ++i, data += chunk_len) {
+    out[i] = ceph_crc32c_func(crc, data, chunk_len);
+  }
+}
+
+ceph_crc32c_multi_func_t ceph_choose_crc32c_multi(void)
+{
+  ceph_arch_probe();
+
+#if defined(__x86_64__)
+  if (ceph_arch_intel_sse42) {
+    return ceph_crc32c_intel_multi;
+  }
+#elif defined(__aarch64__) && defined(HAVE_ARMV8_CRC)
+  if (ceph_arch_aarch64_crc32) {
+    return ceph_crc32c_aarch64_multi;
+  }
+#endif
+  return ceph_crc32c_multi_generic;
+}
+
+ceph_crc32c_multi_func_t ceph_crc32c_multi_func = ceph_choose_crc32c_multi();
+
 
 /*
  * Look: http://crcutil.googlecode.com/files/crc-doc.1.0.pdf
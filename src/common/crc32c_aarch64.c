@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "acconfig.h"
 #include "include/int_types.h"
 #include "common/crc32c_aarch64.h"
@@ -272,3 +274,49 @@ uint32_t ceph_crc32c_aarch64(uint32_t crc, unsigned char const *buffer, unsigned
 	}
 	return crc;
 }
+
+/*
+ * Checksum count consecutive chunks of chunk_len bytes independently,
+ * interleaving four of them so each crc32cx dependency chain overlaps
+ * with the others.
+ */
+void ceph_crc32c_aarch64_multi(uint32_t crc, unsigned char const *data,
+			       unsigned chunk_len, unsigned count,
+			       uint32_t *out)
+{
+	unsigned n = 0;
+
+	for (; n + 4 <= count; n += 4) {
+		unsigned char const *p0 = data + (size_t)n * chunk_len;
+		unsigned char const *p1 = p0 + chunk_len;
+		unsigned char const *p2 = p1 + chunk_len;
+		unsigned char const *p3 = p2 + chunk_len;
+		uint32_t c0 = crc, c1 = crc, c2 = crc, c3 = crc;
+		unsigned i = 0;
+
+		for (; i + 8 <= chunk_len; i += 8) {
+			uint64_t v0, v1, v2, v3;
+			memcpy(&v0, p0 + i, 8);
+			memcpy(&v1, p1 + i, 8);
+			memcpy(&v2, p2 + i, 8);
+			memcpy(&v3, p3 + i, 8);
+			CRC32CX(c0, v0);
+			CRC32CX(c1, v1);
+			CRC32CX(c2, v2);
+			CRC32CX(c3, v3);
+		}
+		for (; i < chunk_len; i++) {
+			CRC32CB(c0, p0[i]);
+			CRC32CB(c1, p1[i]);
+			CRC32CB(c2, p2[i]);
+			CRC32CB(c3, p3[i]);
+		}
+		out[n] = c0;
+		out[n + 1] = c1;
+		out[n + 2] = c2;
+		out[n + 3] = c3;
+	}
+	for (; n < count; n++)
+		out[n] = ceph_crc32c_aarch64(crc, data + (size_t)n * chunk_len,
+					     chunk_len);
+}
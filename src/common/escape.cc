@@ -255,32 +255,44 @@ std::ostream& operator<<(std::ostream& out, const json_stream_escaper& e)
 {
   boost::optional<hex_formatter> fmt;
 
-  for (unsigned char c : e.str) {
+  // write runs of characters that need no escaping in one go
+  const char *data = e.str.data();
+  size_t run = 0;
+  for (size_t i = 0; i < e.str.size(); ++i) {
+    const unsigned char c = data[i];
+    const char *esc;
     switch (c) {
     case '"':
-      out << DBL_QUOTE_JESCAPE;
+      esc = DBL_QUOTE_JESCAPE;
       break;
     case '\\':
-      out << BACKSLASH_JESCAPE;
+      esc = BACKSLASH_JESCAPE;
       break;
     case '\t':
-      out << TAB_JESCAPE;
+      esc = TAB_JESCAPE;
       break;
     case '\n':
-      out << NEWLINE_JESCAPE;
+      esc = NEWLINE_JESCAPE;
       break;
     default:
       // Escape control characters.
       if ((c < 0x20) || (c == 0x7f)) {
-        if (!fmt) {
-          fmt.emplace(out); // enable hex formatting
-        }
-        out << "\\u" << std::setw(4) << static_cast<unsigned int>(c);
-      } else {
-        out << c;
+        esc = nullptr;
+        break;
       }
-      break;
+      continue;
+    }
+    out.write(data + run, i - run);
+    run = i + 1;
+    if (esc) {
+      out << esc;
+    } else {
+      if (!fmt) {
+        fmt.emplace(out); // enable hex formatting
+      }
+      out << "\\u" << std::setw(4) << static_cast<unsigned int>(c);
     }
   }
+  out.write(data + run, e.str.size() - run);
   return out;
 }
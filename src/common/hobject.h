@@ -364,7 +364,16 @@ public:
     return snap <=> rhs.snap;
   }
   constexpr bool operator==(const hobject_t& rhs) const noexcept {
-    return operator<=>(rhs) == 0;
+    // same equivalence as operator<=>, but test the integer fields first
+    // so that unequal objects rarely reach the string compares
+    return max == rhs.max &&
+      (max || hash_reverse_bits == rhs.hash_reverse_bits) &&
+      snap == rhs.snap &&
+      pool == rhs.pool &&
+      nspace == rhs.nspace &&
+      ((get_key().empty() && rhs.get_key().empty()) ||
+       get_effective_key() == rhs.get_effective_key()) &&
+      oid == rhs.oid;
   }
   friend struct ghobject_t;
   friend struct test_hobject_fmt_t;
@@ -17,8 +17,10 @@
 
 #include "include/interval_set.h"
 #include <initializer_list>
+#include <map>
 
-template <typename K, typename V, typename S>
+template <typename K, typename V, typename S,
+	  template<typename, typename, typename ...> class C = std::map>
 /**
  * interval_map
  *
@@ -30,12 +32,17 @@ template <typename K, typename V, typename S>
  * for this use case.  The aggregation concept seems to assume
  * commutativity, which doesn't work if we want more recent insertions
  * to overwrite previous ones.
+ *
+ * As with interval_set, the backing container is a template argument;
+ * btree::btree_map avoids a node allocation per interval for large
+ * maps.  Its iterators are invalidated by insert/erase, so only rely on
+ * iterators returned by those calls.
  */
 class interval_map {
   S s;
-  using map = std::map<K, std::pair<K, V> >;
-  using mapiter = typename std::map<K, std::pair<K, V> >::iterator;
-  using cmapiter = typename std::map<K, std::pair<K, V> >::const_iterator;
+  using map = C<K, std::pair<K, V> >;
+  using mapiter = typename map::iterator;
+  using cmapiter = typename map::const_iterator;
   map m;
   std::pair<mapiter, mapiter> get_range(K off, K len) {
     // fst is first iterator with end after off (may be end)
@@ -182,7 +189,7 @@ public:
   void insert(interval_map &&other) {
     for (auto i = other.m.begin();
 	 i != other.m.end();
-	 other.m.erase(i++)) {
+	 i = other.m.erase(i)) {
       insert(i->first, i->second.first, std::move(i->second.second));
     }
   }
@@ -318,8 +325,9 @@ public:
   }
 };
 
-template <typename K, typename V, typename S>
-std::ostream &operator<<(std::ostream &out, const interval_map<K, V, S> &m) {
+template <typename K, typename V, typename S,
+	  template<typename, typename, typename ...> class C>
+std::ostream &operator<<(std::ostream &out, const interval_map<K, V, S, C> &m) {
   return m.print(out);
 }
 
@@ -11,4 +11,9 @@ const uint64_t Model::get_block_size() const { return block_size; }
 
 const std::string Model::get_oid() const { return oid; }
 
-int Model::get_num_io() const { return num_io; }
\ No newline at end of file
+int Model::get_num_io() const { return num_io; }
+
+const std::map<ceph::io_exerciser::OpType, Model::LatencyStats>&
+Model::get_latency_stats() const {
+  return latency_stats;
+}
\ No newline at end of file
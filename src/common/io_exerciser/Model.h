@@ -2,7 +2,11 @@
 
 #include <boost/asio/io_context.hpp>
 
+#include <algorithm>
+#include <map>
+
 #include "IoOp.h"
+#include "common/ceph_time.h"
 #include "common/Thread.h"
 #include "global/global_context.h"
 #include "global/global_init.h"
@@ -22,8 +26,28 @@ namespace ceph {
 namespace io_exerciser {
 
 class Model {
+ public:
+  struct LatencyStats {
+    uint64_t count = 0;
+    ceph::timespan total = ceph::timespan::zero();
+    ceph::timespan max = ceph::timespan::zero();
+
+    void add(ceph::timespan lat) {
+      ++count;
+      total += lat;
+      max = std::max(max, lat);
+    }
+    void merge(const LatencyStats& other) {
+      count += other.count;
+      total += other.total;
+      max = std::max(max, other.max);
+    }
+  };
+
  protected:
   int num_io{0};
+  // completed asynchronous I/Os by op type
+  std::map<OpType, LatencyStats> latency_stats;
   std::string oid;
   uint64_t block_size;
 
@@ -37,6 +61,7 @@ class Model {
   const std::string get_oid() const;
   const uint64_t get_block_size() const;
   int get_num_io() const;
+  const std::map<OpType, LatencyStats>& get_latency_stats() const;
 };
 
 /* Simple RADOS I/O generator */
@@ -67,8 +67,9 @@ void RadosIo::start_io() {
   outstanding_io++;
 }
 
-void RadosIo::finish_io() {
+void RadosIo::finish_io(OpType type, ceph::mono_time start) {
   std::lock_guard l(lock);
+  latency_stats[type].add(ceph::mono_clock::now() - start);
   ceph_assert(outstanding_io > 0);
   outstanding_io--;
   cond.notify_all();
@@ -137,9 +138,10 @@ void RadosIo::applyIoOp(IoOp& op) {
       op_info->bufferlist[0] = db->generate_data(0, opSize);
       librados::ObjectWriteOperation wop;
       wop.write_full(op_info->bufferlist[0]);
-      auto create_cb = [this](boost::system::error_code ec, version_t ver) {
+      auto create_cb = [this, start = ceph::mono_clock::now()](
+                           boost::system::error_code ec, version_t ver) {
         ceph_assert(ec == boost::system::errc::success);
-        finish_io();
+        finish_io(OpType::Create, start);
       };
       librados::async_operate(asio.get_executor(), io, oid,
                               std::move(wop), 0, nullptr, create_cb);
@@ -151,9 +153,10 @@ void RadosIo::applyIoOp(IoOp& op) {
       auto op_info = std::make_shared<AsyncOpInfo<0>>();
       librados::ObjectWriteOperation wop;
       wop.remove();
-      auto remove_cb = [this](boost::system::error_code ec, version_t ver) {
+      auto remove_cb = [this, start = ceph::mono_clock::now()](
+                           boost::system::error_code ec, version_t ver) {
         ceph_assert(ec == boost::system::errc::success);
-        finish_io();
+        finish_io(OpType::Remove, start);
       };
       librados::async_operate(asio.get_executor(), io, oid,
                               std::move(wop), 0, nullptr, remove_cb);
@@ -205,14 +208,15 @@ void RadosIo::applyReadWriteOp(IoOp& op) {
                readOp.length[i] * block_size, &op_info->bufferlist[i],
                nullptr);
     }
-    auto read_cb = [this, op_info](boost::system::error_code ec, version_t ver,
-                                   bufferlist bl) {
+    auto read_cb = [this, op_info, start = ceph::mono_clock::now()](
+                       boost::system::error_code ec, version_t ver,
+                       bufferlist bl) {
       ceph_assert(ec == boost::system::errc::success);
       for (int i = 0; i < N; i++) {
         ceph_assert(db->validate(op_info->bufferlist[i], op_info->offset[i],
                                  op_info->length[i]));
       }
-      finish_io();
+      finish_io(opType, start);
     };
     librados::async_operate(asio.get_executor(), io, oid,
                             std::move(rop), 0, nullptr, read_cb);
@@ -230,9 +234,10 @@ void RadosIo::applyReadWriteOp(IoOp& op) {
       wop.write(writeOp.offset[i] * block_size,
                 op_info->bufferlist[i]);
     }
-    auto write_cb = [this](boost::system::error_code ec, version_t ver) {
+    auto write_cb = [this, start = ceph::mono_clock::now()](
+                        boost::system::error_code ec, version_t ver) {
       ceph_assert(ec == boost::system::errc::success);
-      finish_io();
+      finish_io(opType, start);
     };
     librados::async_operate(asio.get_executor(), io, oid,
                             std::move(wop), 0, nullptr, write_cb);
@@ -250,10 +255,10 @@ void RadosIo::applyReadWriteOp(IoOp& op) {
       wop.write(writeOp.offset[i] * block_size,
                 op_info->bufferlist[i]);
     }
-    auto write_cb = [this, writeOp](boost::system::error_code ec,
-                                    version_t ver) {
+    auto write_cb = [this, writeOp, start = ceph::mono_clock::now()](
+                        boost::system::error_code ec, version_t ver) {
       ceph_assert(ec != boost::system::errc::success);
-      finish_io();
+      finish_io(opType, start);
     };
     librados::async_operate(asio.get_executor(), io, oid,
                             std::move(wop), 0, nullptr, write_cb);
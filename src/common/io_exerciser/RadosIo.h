@@ -34,7 +34,7 @@ class RadosIo : public Model {
   int outstanding_io;
 
   void start_io();
-  void finish_io();
+  void finish_io(OpType type, ceph::mono_time start);
   void wait_for_io(int count);
 
  public:
@@ -98,6 +98,23 @@ ostream& ObjBencher::out(ostream& os)
   return out(os, cur_time);
 }
 
+void ObjBencher::report_latency_percentiles(int label_width)
+{
+  static const std::pair<const char*, double> pcts[] = {
+    {"50", 50}, {"99", 99}, {"99.9", 99.9}, {"99.99", 99.99}};
+  for (auto& [name, p] : pcts) {
+    double v = data.latency_histogram.percentile(p);
+    if (!formatter) {
+      std::string label = std::string("p") + name + " latency(s):";
+      out(cout) << std::left << setw(label_width) << label << std::right
+		<< v << std::endl;
+    } else {
+      formatter->dump_format((std::string("p") + name + "_latency").c_str(),
+			     "%f", v);
+    }
+  }
+}
+
 void *ObjBencher::status_printer(void *_bencher) {
   ceph_pthread_setname("OB::stat_print");
   ObjBencher *bencher = static_cast<ObjBencher *>(_bencher);
@@ -296,6 +313,7 @@ int ObjBencher::aio_bench(
   data.max_latency = 0;
   data.avg_latency = 0;
   data.latency_diff_sum = 0;
+  data.latency_histogram.clear();
   data.object_contents = contentsChars;
   lock.unlock();
 
@@ -510,6 +528,7 @@ int ObjBencher::write_bench(int secondsToRun,
       goto ERR;
     }
     data.cur_latency = mono_clock::now() - start_times[slot];
+    data.latency_histogram.add(data.cur_latency.count());
     total_latency += data.cur_latency.count();
     if( data.cur_latency.count() > data.max_latency)
       data.max_latency = data.cur_latency.count();
@@ -627,6 +646,7 @@ int ObjBencher::write_bench(int secondsToRun,
     formatter->dump_format("max_latency", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
   }
+  report_latency_percentiles(24);
   //write object size/number data for read benchmarks
   encode(data.object_size, b_write);
   encode(data.finished, b_write);
@@ -738,6 +758,7 @@ int ObjBencher::seq_read_bench(
 
     // calculate latency here, so memcmp doesn't inflate it
     data.cur_latency = mono_clock::now() - start_times[slot];
+    data.latency_histogram.add(data.cur_latency.count());
 
     cur_contents = contents[slot].get();
     int current_index = index[slot];
@@ -844,6 +865,7 @@ int ObjBencher::seq_read_bench(
     formatter->dump_format("max_latency", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
   }
+  report_latency_percentiles(22);
 
   completions_done();
 
@@ -950,6 +972,7 @@ int ObjBencher::rand_read_bench(
 
     // calculate latency here, so memcmp doesn't inflate it
     data.cur_latency = mono_clock::now() - start_times[slot];
+    data.latency_histogram.add(data.cur_latency.count());
 
     locker.unlock();
 
@@ -1056,6 +1079,7 @@ int ObjBencher::rand_read_bench(
     formatter->dump_format("max_latency", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
   }
+  report_latency_percentiles(22);
   completions_done();
 
   return (errors > 0 ? -EIO : 0);
@@ -18,7 +18,10 @@
 #include "common/ceph_context.h"
 #include "common/Formatter.h"
 #include "ceph_time.h"
+#include <algorithm>
+#include <array>
 #include <cfloat>
+#include <cmath>
 
 using ceph::mono_clock;
 
@@ -35,6 +38,54 @@ struct bench_interval_data {
   double iops_diff_sum = 0;
 };
 
+// log-linear latency histogram: 16 linear sub-buckets per power of two of
+// microseconds, so any percentile is within 6.25% of the true value
+struct bench_latency_histogram {
+  static constexpr unsigned SUB_BITS = 4;
+  static constexpr unsigned SUB = 1 << SUB_BITS;
+  std::array<uint64_t, 64 * SUB> buckets{};
+  uint64_t count = 0;
+
+  static unsigned index(uint64_t us) {
+    if (us < SUB) {
+      return us;
+    }
+    unsigned msb = 63 - __builtin_clzll(us);
+    return (msb - SUB_BITS + 1) * SUB + ((us >> (msb - SUB_BITS)) & (SUB - 1));
+  }
+  // upper bound, in seconds, of the values in bucket i
+  static double bucket_max(unsigned i) {
+    if (i < SUB) {
+      return (i + 1) / 1e6;
+    }
+    unsigned shift = i / SUB - 1;
+    return (((uint64_t)(SUB + i % SUB) + 1) << shift) / 1e6;
+  }
+
+  void clear() {
+    buckets.fill(0);
+    count = 0;
+  }
+  void add(double secs) {
+    ++buckets[index(secs > 0 ? (uint64_t)(secs * 1e6) : 0)];
+    ++count;
+  }
+  double percentile(double p) const {
+    if (!count) {
+      return 0;
+    }
+    uint64_t want = std::max<uint64_t>(1, std::ceil(count * p / 100.0));
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < buckets.size(); ++i) {
+      seen += buckets[i];
+      if (seen >= want) {
+	return bucket_max(i);
+      }
+    }
+    return bucket_max(buckets.size() - 1);
+  }
+};
+
 struct bench_data {
   bool done; //is the benchmark is done
   uint64_t object_size; //the size of the objects
@@ -49,6 +100,7 @@ struct bench_data {
   double avg_latency;
   struct bench_interval_data idata; // data that is updated by time intervals and not by events
   double latency_diff_sum;
+  bench_latency_histogram latency_histogram;
   std::chrono::duration<double> cur_latency; //latency of last completed transaction - in seconds by default
   mono_time start_time; //start time for benchmark - use the monotonic clock as we'll measure the passage of time
   char *object_contents; //pointer to the contents written to each object
@@ -106,6 +158,7 @@ protected:
 
   std::ostream& out(std::ostream& os);
   std::ostream& out(std::ostream& os, utime_t& t);
+  void report_latency_percentiles(int label_width);
 public:
   explicit ObjBencher(CephContext *cct_) : show_time(false), cct(cct_), data() {}
   virtual ~ObjBencher() {}
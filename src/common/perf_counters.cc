@@ -14,6 +14,7 @@
  */
 
 #include "common/perf_counters.h"
+#include "common/Cycles.h"
 #include "common/perf_counters_key.h"
 #include "common/dout.h"
 #include "common/valgrind.h"
@@ -162,6 +163,13 @@ void PerfCountersCollectionImpl::with_counters(std::function<void(
 
 // ---------------------------
 
+unsigned PerfCounters::perf_counter_data_any_d::hot_shard_index()
+{
+  static std::atomic<unsigned> next_index = { 0 };
+  thread_local unsigned index = next_index++ % HOT_SHARDS;
+  return index;
+}
+
 PerfCounters::~PerfCounters()
 {
 }
@@ -178,13 +186,7 @@ void PerfCounters::inc(int idx, uint64_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_U64))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt;
-    data.avgcount2++;
-  } else {
-    data.u64 += amt;
-  }
+  data.add_sample(amt);
 }
 
 void PerfCounters::dec(int idx, uint64_t amt)
@@ -200,7 +202,11 @@ void PerfCounters::dec(int idx, uint64_t amt)
   ceph_assert(!(data.type & PERFCOUNTER_LONGRUNAVG));
   if (!(data.type & PERFCOUNTER_U64))
     return;
-  data.u64 -= amt;
+  if (data.shards) {
+    data.shards[data.hot_shard_index()].u64 -= amt;
+  } else {
+    data.u64 -= amt;
+  }
 }
 
 void PerfCounters::set(int idx, uint64_t amt)
@@ -225,6 +231,13 @@ void PerfCounters::set(int idx, uint64_t amt)
   } else {
     data.u64 = amt;
   }
+  if (data.shards) {
+    // not atomic with respect to concurrent inc(); hot counters are
+    // not expected to be set()
+    for (unsigned i = 0; i < data.HOT_SHARDS; ++i) {
+      data.shards[i].u64 = 0;
+    }
+  }
 }
 
 uint64_t PerfCounters::get(int idx) const
@@ -239,7 +252,7 @@ uint64_t PerfCounters::get(int idx) const
   const perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_U64))
     return 0;
-  return data.u64;
+  return data.read_u64();
 }
 
 void PerfCounters::tinc(int idx, utime_t amt)
@@ -254,13 +267,7 @@ void PerfCounters::tinc(int idx, utime_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt.to_nsec();
-    data.avgcount2++;
-  } else {
-    data.u64 += amt.to_nsec();
-  }
+  data.add_sample(amt.to_nsec());
 }
 
 void PerfCounters::tinc(int idx, ceph::timespan amt)
@@ -275,13 +282,18 @@ void PerfCounters::tinc(int idx, ceph::timespan amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt.count();
-    data.avgcount2++;
-  } else {
-    data.u64 += amt.count();
-  }
+  data.add_sample(amt.count());
+}
+
+void PerfCounters::tinc_cycles(int idx, uint64_t cycles)
+{
+#ifndef WITH_SEASTAR
+  if (!m_cct->_conf->perf)
+    return;
+#endif
+  if (Cycles::per_second() == 0)
+    return;
+  tinc(idx, ceph::timespan(Cycles::to_nanoseconds(cycles)));
 }
 
 void PerfCounters::tset(int idx, utime_t amt)
@@ -330,7 +342,7 @@ utime_t PerfCounters::tget(int idx) const
   const perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return utime_t();
-  uint64_t v = data.u64;
+  uint64_t v = data.read_u64();
   return utime_t(v / 1000000000ull, v % 1000000000ull);
 }
 
@@ -499,7 +511,7 @@ void PerfCounters::dump_formatted_generic(Formatter *f, bool schema,
         d->histogram->dump_formatted(f);
         f->close_section();
       } else {
-	uint64_t v = d->u64;
+	uint64_t v = d->read_u64();
 	if (d->type & PERFCOUNTER_U64) {
 	  f->dump_unsigned(d->name, v);
 	} else if (d->type & PERFCOUNTER_TIME) {
@@ -624,6 +636,20 @@ void PerfCountersBuilder::add_impl(
   data.histogram = std::move(histogram);
 }
 
+void PerfCountersBuilder::mark_hot(int idx)
+{
+  ceph_assert(idx > m_perf_counters->m_lower_bound);
+  ceph_assert(idx < m_perf_counters->m_upper_bound);
+  PerfCounters::perf_counter_data_any_d
+    &data(m_perf_counters->m_data[idx - m_perf_counters->m_lower_bound - 1]);
+  // only counters and averages, which are inc()ed rather than set()
+  ceph_assert(data.type & (PERFCOUNTER_COUNTER | PERFCOUNTER_LONGRUNAVG));
+  ceph_assert(!(data.type & PERFCOUNTER_HISTOGRAM));
+  data.shards.reset(
+    new PerfCounters::perf_counter_data_any_d::shard_d[
+      PerfCounters::perf_counter_data_any_d::HOT_SHARDS]);
+}
+
 PerfCounters *PerfCountersBuilder::create_perf_counters()
 {
   PerfCounters::perf_counter_data_vec_t::const_iterator d = m_perf_counters->m_data.begin();
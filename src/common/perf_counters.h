@@ -117,6 +117,10 @@ public:
     const char* nick = nullptr,
     int prio=0, int unit=UNIT_NONE);
 
+  /// shard the storage of an already added counter per thread; for
+  /// counters updated from many threads at once.  Reads get slower.
+  void mark_hot(int key);
+
   void set_prio_default(int prio_)
   {
     prio_default = prio_;
@@ -199,29 +203,91 @@ public:
     std::atomic<uint64_t> avgcount2 = { 0 };
     std::unique_ptr<PerfHistogram<>> histogram;
 
+    // Counters marked hot (PerfCountersBuilder::mark_hot) are updated
+    // through one of these per-thread slots instead of the fields
+    // above, so that threads bumping the same counter do not fight
+    // over a single cache line.  Readers sum the slots.
+    static constexpr unsigned HOT_SHARDS = 16;
+    struct alignas(64) shard_d {
+      std::atomic<uint64_t> u64 = { 0 };
+      std::atomic<uint64_t> avgcount = { 0 };
+      std::atomic<uint64_t> avgcount2 = { 0 };
+    };
+    std::unique_ptr<shard_d[]> shards;
+
     void reset()
     {
       if (type != PERFCOUNTER_U64) {
 	    u64 = 0;
 	    avgcount = 0;
 	    avgcount2 = 0;
+	    if (shards) {
+	      for (unsigned i = 0; i < HOT_SHARDS; ++i) {
+		shards[i].u64 = 0;
+		shards[i].avgcount = 0;
+		shards[i].avgcount2 = 0;
+	      }
+	    }
       }
       if (histogram) {
         histogram->reset();
       }
     }
 
+    /// add one sample (inc or tinc) to the counter
+    void add_sample(uint64_t amt) {
+      auto add = [this, amt](auto& d) {
+	if (type & PERFCOUNTER_LONGRUNAVG) {
+	  d.avgcount++;
+	  d.u64 += amt;
+	  d.avgcount2++;
+	} else {
+	  d.u64 += amt;
+	}
+      };
+      if (shards) {
+	add(shards[hot_shard_index()]);
+      } else {
+	add(*this);
+      }
+    }
+
+    uint64_t read_u64() const {
+      uint64_t v = u64;
+      if (shards) {
+	for (unsigned i = 0; i < HOT_SHARDS; ++i) {
+	  v += shards[i].u64;
+	}
+      }
+      return v;
+    }
+
     // read <sum, count> safely by making sure the post- and pre-count
     // are identical; in other words the whole loop needs to be run
-    // without any intervening calls to inc, set, or tinc.
+    // without any intervening calls to inc, set, or tinc.  Hot
+    // counters are read one slot at a time.
     std::pair<uint64_t,uint64_t> read_avg() const {
-      uint64_t sum, count;
-      do {
-	count = avgcount2;
-	sum = u64;
-      } while (avgcount != count);
-      return { sum, count };
+      auto read = [](const auto& d) -> std::pair<uint64_t,uint64_t> {
+	uint64_t sum, count;
+	do {
+	  count = d.avgcount2;
+	  sum = d.u64;
+	} while (d.avgcount != count);
+	return { sum, count };
+      };
+      auto ret = read(*this);
+      if (shards) {
+	for (unsigned i = 0; i < HOT_SHARDS; ++i) {
+	  auto a = read(shards[i]);
+	  ret.first += a.first;
+	  ret.second += a.second;
+	}
+      }
+      return ret;
     }
+
+    /// slot in shards[] used by the calling thread
+    static unsigned hot_shard_index();
   };
 
   template <typename T>
@@ -251,6 +317,9 @@ public:
   void tset(int idx, ceph::timespan v);
   void tinc(int idx, utime_t v);
   void tinc(int idx, ceph::timespan v);
+  /// tinc() with a duration measured by Cycles::rdtsc(); samples are
+  /// dropped unless Cycles::init() has been called
+  void tinc_cycles(int idx, uint64_t cycles);
   utime_t tget(int idx) const;
 
   void hinc(int idx, int64_t x, int64_t y);
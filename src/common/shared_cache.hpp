@@ -67,6 +67,16 @@ private:
     contents.erase(i);
   }
 
+  /// strong ref from the lru, if any; saves the ordered weak_refs lookup
+  VPtr lru_lookup(const K& key) {
+    auto i = contents.find(key);
+    if (i == contents.end()) {
+      return VPtr();
+    }
+    lru.splice(lru.begin(), lru, i->second);
+    return i->second->second;
+  }
+
   void lru_add(const K& key, const VPtr& val, std::list<VPtr> *to_release) {
     auto i = contents.find(key);
     if (i != contents.end()) {
@@ -277,6 +287,9 @@ public:
     std::list<VPtr> to_release;
     {
       std::unique_lock l{lock};
+      if (val = lru_lookup(key); val) {
+        return val;
+      }
       ++waiting;
       cond.wait(l, [this, &key, &val, &to_release] {
         if (auto i = weak_refs.find(key); i != weak_refs.end()) {
@@ -299,6 +312,9 @@ public:
     std::list<VPtr> to_release;
     {
       std::unique_lock l{lock};
+      if (val = lru_lookup(key); val) {
+        return val;
+      }
       cond.wait(l, [this, &key, &val] {
         if (auto i = weak_refs.find(key); i != weak_refs.end()) {
           if (val = i->second.first.lock(); val) {
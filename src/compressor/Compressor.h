@@ -87,6 +87,12 @@ public:
   // this is a bit weird but we need non-const iterator to be in
   // alignment with decode methods
   virtual int decompress(ceph::bufferlist::const_iterator &p, size_t compressed_len, ceph::bufferlist &out, std::optional<int32_t> compressor_message) = 0;
+  // Decompress at least the first want_len bytes of the original data.
+  // Codecs able to stop early (streamed or block based formats) may
+  // produce less than the whole original, the default produces it all.
+  virtual int decompress_prefix(ceph::bufferlist::const_iterator &p, size_t compressed_len, size_t want_len, ceph::bufferlist &out, std::optional<int32_t> compressor_message) {
+    return decompress(p, compressed_len, out, compressor_message);
+  }
 
   static CompressorRef create(CephContext *cct, const std::string &type);
   static CompressorRef create(CephContext *cct, int alg);
@@ -159,9 +159,24 @@ int QatAccel::compress(const bufferlist &in, bufferlist &out, std::optional<int3
   compressor_message = windowBits;
 
   int begin = 1;
-  for (auto &i : in.buffers()) {
-    const unsigned char* c_in = (unsigned char*) i.c_str();
-    unsigned int len = i.length();
+  auto p = in.begin();
+  while (!p.end()) {
+    // each qzCompress() is one round trip to the device, so small
+    // fragments (e.g. page-sized buffers) are coalesced into jobs of up to
+    // QZ_HW_BUFF_SZ; longer contiguous buffers go as they are.
+    // the output is still a run of gzip members decompress() walks through
+    const char *c;
+    unsigned int len = p.get_ptr_and_advance(p.get_remaining(), &c);
+    bufferptr coalesced;
+    if (len < QZ_HW_BUFF_SZ && !p.end()) {
+      unsigned int want = std::min<unsigned int>(QZ_HW_BUFF_SZ, len + p.get_remaining());
+      coalesced = buffer::create(want);
+      memcpy(coalesced.c_str(), c, len);
+      p.copy(want - len, coalesced.c_str() + len);
+      len = want;
+      c = coalesced.c_str();
+    }
+    const unsigned char* c_in = (const unsigned char*)c;
     unsigned int out_len = qzMaxCompressedLength(len, session.get()) + begin;
 
     bufferptr ptr = buffer::create_small_page_aligned(out_len);
@@ -12,6 +12,8 @@
  *
  */
 
+#include <limits>
+
 #include "LZ4Compressor.h"
 #include "common/ceph_context.h"
 #ifdef HAVE_QATZIP
@@ -100,6 +102,17 @@ int LZ4Compressor::decompress(ceph::buffer::list::const_iterator &p,
                               size_t compressed_len,
                               ceph::buffer::list &dst,
                               std::optional<int32_t> compressor_message)
+{
+  return decompress_prefix(p, compressed_len,
+                           std::numeric_limits<size_t>::max(),
+                           dst, compressor_message);
+}
+
+int LZ4Compressor::decompress_prefix(ceph::buffer::list::const_iterator &p,
+                                     size_t compressed_len,
+                                     size_t want_len,
+                                     ceph::buffer::list &dst,
+                                     std::optional<int32_t> compressor_message)
 {
 #ifdef HAVE_QATZIP
   if (qat_enabled)
@@ -109,26 +122,38 @@ int LZ4Compressor::decompress(ceph::buffer::list::const_iterator &p,
   uint32_t count;
   decode(count, p);
   std::vector<std::pair<uint32_t, uint32_t> > compressed_pairs(count);
-  uint32_t total_origin = 0;
   for (auto& [dst_size, src_size] : compressed_pairs) {
     decode(dst_size, p);
     decode(src_size, p);
-    total_origin += dst_size;
   }
   compressed_len -= (sizeof(uint32_t) + sizeof(uint32_t) * count * 2);
 
-  ceph::buffer::ptr dstptr(total_origin);
+  // blocks are independent of what follows them, so only the ones
+  // covering the wanted prefix need to be decoded
+  unsigned need_count = 0;
+  uint32_t total_origin = 0;
+  size_t need_compressed = 0;
+  while (need_count < count && total_origin < want_len) {
+    total_origin += compressed_pairs[need_count].first;
+    need_compressed += compressed_pairs[need_count].second;
+    ++need_count;
+  }
+  if (need_compressed > compressed_len) {
+    return -1;
+  }
+
+  ceph::buffer::ptr dstptr(ceph::buffer::create_page_aligned(total_origin));
   LZ4_streamDecode_t lz4_stream_decode;
   LZ4_setStreamDecode(&lz4_stream_decode, nullptr, 0);
 
   ceph::buffer::list indata;
   // this does a shallow copy
-  p.copy(compressed_len, indata);
+  p.copy(need_compressed, indata);
   // if the input isn't fragmented, c_str() costs almost nothing.
   // otherwise rectifying copy will be taken
   const char* c_in = indata.c_str();
   char *c_out = dstptr.c_str();
-  for (unsigned i = 0; i < count; ++i) {
+  for (unsigned i = 0; i < need_count; ++i) {
     int r = LZ4_decompress_safe_continue(
         &lz4_stream_decode, c_in, c_out, compressed_pairs[i].second, compressed_pairs[i].first);
     if (r == (int)compressed_pairs[i].first) {
@@ -46,6 +46,12 @@ class LZ4Compressor : public Compressor {
 		 size_t compressed_len,
 		 ceph::buffer::list &dst,
 		 std::optional<int32_t> compressor_message) override;
+
+  int decompress_prefix(ceph::buffer::list::const_iterator &p,
+			size_t compressed_len,
+			size_t want_len,
+			ceph::buffer::list &dst,
+			std::optional<int32_t> compressor_message) override;
 };
 
 #endif
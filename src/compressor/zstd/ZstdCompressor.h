@@ -16,6 +16,9 @@
 #define CEPH_ZSTDCOMPRESSOR_H
 
 #define ZSTD_STATIC_LINKING_ONLY
+#include <limits>
+#include <memory>
+
 #include "zstd/lib/zstd.h"
 
 #include "include/buffer.h"
@@ -27,7 +30,8 @@ class ZstdCompressor : public Compressor {
   ZstdCompressor(CephContext *cct) : Compressor(COMP_ALG_ZSTD, "zstd"), cct(cct) {}
 
   int compress(const ceph::buffer::list &src, ceph::buffer::list &dst, std::optional<int32_t> &compressor_message) override {
-    ZSTD_CStream *s = ZSTD_createCStream();
+    ZSTD_CStream *s = get_cstream();
+    // (re)starts the frame, whatever state the last use left it in
     ZSTD_initCStream_srcSize(s, cct->_conf->compressor_zstd_level, src.length());
     auto p = src.begin();
     size_t left = src.length();
@@ -53,8 +57,6 @@ class ZstdCompressor : public Compressor {
     }
     ceph_assert(p.end());
 
-    ZSTD_freeCStream(s);
-
     // prefix with decompressed length
     ceph::encode((uint32_t)src.length(), dst);
     dst.append(outptr, 0, outbuf.pos);
@@ -70,6 +72,16 @@ class ZstdCompressor : public Compressor {
 		 size_t compressed_len,
 		 ceph::buffer::list &dst,
 		 std::optional<int32_t> compressor_message) override {
+    return decompress_prefix(p, compressed_len,
+			     std::numeric_limits<size_t>::max(),
+			     dst, compressor_message);
+  }
+
+  int decompress_prefix(ceph::buffer::list::const_iterator &p,
+			size_t compressed_len,
+			size_t want_len,
+			ceph::buffer::list &dst,
+			std::optional<int32_t> compressor_message) override {
     if (compressed_len < 4) {
       return -1;
     }
@@ -77,14 +89,16 @@ class ZstdCompressor : public Compressor {
     uint32_t dst_len;
     ceph::decode(dst_len, p);
 
-    ceph::buffer::ptr dstptr(dst_len);
+    // the stream stops once the output buffer is full
+    ceph::buffer::ptr dstptr(ceph::buffer::create_page_aligned(
+      std::min<size_t>(dst_len, want_len)));
     ZSTD_outBuffer_s outbuf;
     outbuf.dst = dstptr.c_str();
     outbuf.size = dstptr.length();
     outbuf.pos = 0;
-    ZSTD_DStream *s = ZSTD_createDStream();
+    ZSTD_DStream *s = get_dstream();
     ZSTD_initDStream(s);
-    while (compressed_len > 0) {
+    while (compressed_len > 0 && outbuf.pos < outbuf.size) {
       if (p.end()) {
 	return -1;
       }
@@ -95,12 +109,31 @@ class ZstdCompressor : public Compressor {
       ZSTD_decompressStream(s, &outbuf, &inbuf);
       compressed_len -= inbuf.size;
     }
-    ZSTD_freeDStream(s);
 
     dst.append(dstptr, 0, outbuf.pos);
     return 0;
   }
  private:
+  // zstd contexts hold several hundred KB of tables; allocating them for
+  // every (typically 64K) blob costs more than compressing it, so each
+  // thread keeps one of each and resets it per call
+  struct CStreamDeleter {
+    void operator()(ZSTD_CStream *s) const { ZSTD_freeCStream(s); }
+  };
+  struct DStreamDeleter {
+    void operator()(ZSTD_DStream *s) const { ZSTD_freeDStream(s); }
+  };
+  static ZSTD_CStream *get_cstream() {
+    static thread_local std::unique_ptr<ZSTD_CStream, CStreamDeleter> s{
+      ZSTD_createCStream()};
+    return s.get();
+  }
+  static ZSTD_DStream *get_dstream() {
+    static thread_local std::unique_ptr<ZSTD_DStream, DStreamDeleter> s{
+      ZSTD_createDStream()};
+    return s.get();
+  }
+
   CephContext *const cct;
 };
 
@@ -2,6 +2,7 @@
 // vim: ts=8 sw=2 smarttab
 
 #include "crimson/admin/osd_admin.h"
+#include <sstream>
 #include <string>
 #include <string_view>
 
@@ -641,6 +642,59 @@ private:
 template std::unique_ptr<AdminSocketHook>
 make_asok_hook<DumpSlowestHistoricOpsHook>(const crimson::osd::OSDOperationRegistry& op_registry);
 
+/**
+ * Dump the per-shard latency profile of the ClientRequest pipeline stages,
+ * optionally in the folded stack format taken by flamegraph.pl
+ */
+class DumpOpStageProfileHook : public AdminSocketHook {
+public:
+  explicit DumpOpStageProfileHook(const crimson::osd::PGShardManager &pg_shard_manager) :
+    AdminSocketHook{"dump_op_stage_profile",
+		    "name=folded,type=CephBool,req=false",
+		    "show the time client requests spent at each pipeline stage"},
+    pg_shard_manager(pg_shard_manager)
+  {}
+  seastar::future<tell_result_t> call(const cmdmap_t& cmdmap,
+				      std::string_view format,
+				      ceph::bufferlist&& input) const final
+  {
+    if (cmd_getval_or<bool>(cmdmap, "folded", false)) {
+      return seastar::do_with(std::ostringstream{}, [this](auto &out) {
+	return pg_shard_manager.invoke_on_each_shard_seq(
+	  [&out](const auto &shard_services) {
+	  shard_services.get_registry().get_client_stage_profile(
+	  ).dump_folded(
+	    out, fmt::format("osd;shard_{};", seastar::this_shard_id()));
+	  return seastar::now();
+	}).then([&out] {
+	  ceph::bufferlist bl;
+	  bl.append(out.str());
+	  return seastar::make_ready_future<tell_result_t>(
+	    tell_result_t{0, {}, std::move(bl)});
+	});
+      });
+    }
+    unique_ptr<Formatter> fref{
+      Formatter::create(format, "json-pretty", "json-pretty")};
+    auto *f = fref.get();
+    f->open_array_section("shards");
+    return pg_shard_manager.invoke_on_each_shard_seq([f](const auto &shard_services) {
+      f->open_object_section("shard");
+      f->dump_unsigned("id", seastar::this_shard_id());
+      shard_services.get_registry().get_client_stage_profile().dump(f);
+      f->close_section();
+      return seastar::now();
+    }).then([fref=std::move(fref)]() mutable {
+      fref->close_section();
+      return seastar::make_ready_future<tell_result_t>(std::move(fref));
+    });
+  }
+private:
+  const crimson::osd::PGShardManager &pg_shard_manager;
+};
+template std::unique_ptr<AdminSocketHook>
+make_asok_hook<DumpOpStageProfileHook>(const crimson::osd::PGShardManager &);
+
 class DumpRecoveryReservationsHook : public AdminSocketHook {
 public:
   explicit DumpRecoveryReservationsHook(crimson::osd::ShardServices& shard_services) :
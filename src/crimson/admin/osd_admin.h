@@ -21,6 +21,7 @@ class RunOSDBenchHook;
 class DumpInFlightOpsHook;
 class DumpHistoricOpsHook;
 class DumpSlowestHistoricOpsHook;
+class DumpOpStageProfileHook;
 class DumpRecoveryReservationsHook;
 
 template<class Hook, class... Args>
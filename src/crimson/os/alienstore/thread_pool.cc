@@ -83,7 +83,9 @@ void ThreadPool::loop(std::chrono::milliseconds queue_max_wait, size_t shard)
 seastar::future<> ThreadPool::start()
 {
   auto slots_per_shard = queue_size / seastar::smp::count;
-  return submit_queue.start(slots_per_shard);
+  return submit_queue.start(slots_per_shard).then([this] {
+    return submit_queue.invoke_on_all(&SubmitQueue::start);
+  });
 }
 
 seastar::future<> ThreadPool::stop()
@@ -4,12 +4,15 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <optional>
 #include <tuple>
 #include <type_traits>
+#include <sys/eventfd.h>
 #include <boost/lockfree/queue.hpp>
 #include <boost/optional.hpp>
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/core/resource.hh>
 #include <seastar/core/semaphore.hh>
@@ -25,6 +28,46 @@ namespace crimson::os {
 struct WorkItem {
   virtual ~WorkItem() {}
   virtual void process() = 0;
+  // called by the submitting reactor after process() returns
+  virtual void complete() = 0;
+};
+
+/// tasks finished by the alien threads, handed back to the reactor which
+/// submitted them. the reactor is woken up once for all the tasks finished
+/// since it last drained the queue, instead of once per task.
+struct CompletionQueue {
+public:
+  void push_back(WorkItem* work_item) {
+    [[maybe_unused]] bool pushed = completed.push(work_item);
+    assert(pushed);
+    if (!notified.exchange(true, std::memory_order_acq_rel)) {
+      ::eventfd_write(wakeup.get_write_fd(), 1);
+    }
+  }
+  seastar::future<> run() {
+    return seastar::repeat([this] {
+      return wakeup.wait().then([this](size_t) {
+        // clear the flag before draining, so a push racing with us wakes
+        // us up again
+        notified.store(false, std::memory_order_release);
+        WorkItem* work_item = nullptr;
+        while (completed.pop(work_item)) {
+          work_item->complete();
+        }
+        return stopping ? seastar::stop_iteration::yes :
+                          seastar::stop_iteration::no;
+      });
+    });
+  }
+  void stop() {
+    stopping = true;
+    ::eventfd_write(wakeup.get_write_fd(), 1);
+  }
+private:
+  bool stopping = false;
+  std::atomic<bool> notified = false;
+  seastar::readable_eventfd wakeup;
+  boost::lockfree::queue<WorkItem*> completed{128};
 };
 
 template<typename Func>
@@ -36,8 +79,9 @@ struct Task final : WorkItem {
                        seastar::internal::future_stored_type_t<T>>;
   using futurator_t = seastar::futurize<T>;
 public:
-  explicit Task(Func&& f)
-    : func(std::move(f))
+  Task(Func&& f, CompletionQueue& completions)
+    : func(std::move(f)),
+      completions(completions)
   {}
   void process() override {
     try {
@@ -50,10 +94,13 @@ public:
     } catch (...) {
       state.set_exception(std::current_exception());
     }
-    on_done.write_side().signal(1);
+    completions.push_back(this);
+  }
+  void complete() override {
+    on_done.set_value();
   }
   typename futurator_t::type get_future() {
-    return on_done.wait().then([this](size_t) {
+    return on_done.get_future().then([this] {
       if (state.failed()) {
         return futurator_t::make_exception_future(state.get_exception());
       } else {
@@ -64,17 +111,27 @@ public:
 private:
   Func func;
   seastar::future_state<future_stored_type_t> state;
-  seastar::readable_eventfd on_done;
+  seastar::promise<> on_done;
+  CompletionQueue& completions;
 };
 
 struct SubmitQueue {
   seastar::semaphore free_slots;
   seastar::gate pending_tasks;
+  CompletionQueue completions;
+  std::optional<seastar::future<>> completing;
   explicit SubmitQueue(size_t num_free_slots)
     : free_slots(num_free_slots)
   {}
+  seastar::future<> start() {
+    completing = completions.run();
+    return seastar::now();
+  }
   seastar::future<> stop() {
-    return pending_tasks.close();
+    return pending_tasks.close().then([this] {
+      completions.stop();
+      return std::move(*completing);
+    });
   }
 };
 
@@ -139,7 +196,8 @@ public:
       [packaged=std::move(packaged), shard, this] {
         return local_free_slots().wait()
           .then([packaged=std::move(packaged), shard, this] {
-            auto task = new Task{std::move(packaged)};
+            auto task = new Task{std::move(packaged),
+                                 submit_queue.local().completions};
             auto fut = task->get_future();
             pending_queues[shard].push_back(task);
             return fut.finally([task, this] {
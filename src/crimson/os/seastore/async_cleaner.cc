@@ -4,6 +4,7 @@
 #include <fmt/chrono.h>
 #include <seastar/core/metrics.hh>
 
+#include "crimson/common/config_proxy.h"
 #include "crimson/os/seastore/logging.h"
 
 #include "crimson/os/seastore/async_cleaner.h"
@@ -12,17 +13,6 @@
 
 SET_SUBSYS(seastore_cleaner);
 
-namespace {
-
-enum class gc_formula_t {
-  GREEDY,
-  BENEFIT,
-  COST_BENEFIT,
-};
-constexpr auto gc_formula = gc_formula_t::COST_BENEFIT;
-
-}
-
 namespace crimson::os::seastore {
 
 void segment_info_t::set_open(
@@ -860,6 +850,21 @@ std::ostream &operator<<(
   return os;
 }
 
+SegmentCleaner::config_t SegmentCleaner::config_t::get_default()
+{
+  auto formula = crimson::common::get_conf<std::string>(
+    "seastore_segment_cleaner_gc_formula");
+  return config_t{
+    .15,  // available_ratio_gc_max
+    .1,   // available_ratio_hard_limit
+    .1,   // reclaim_ratio_gc_threshold
+    1<<20,// reclaim_bytes_per_cycle
+    formula == "greedy" ? gc_formula_t::GREEDY :
+    formula == "benefit" ? gc_formula_t::BENEFIT :
+    gc_formula_t::COST_BENEFIT
+  };
+}
+
 SegmentCleaner::SegmentCleaner(
   config_t config,
   SegmentManagerGroupRef&& sm_group,
@@ -1002,24 +1007,55 @@ segment_id_t SegmentCleaner::allocate_segment(
   assert(seq != NULL_SEG_SEQ);
   ceph_assert(type == segment_type_t::OOL ||
               trimmer != nullptr); // segment_type_t::JOURNAL
-  for (auto it = segments.begin();
-       it != segments.end();
-       ++it) {
-    auto seg_id = it->first;
-    auto& segment_info = it->second;
-    if (segment_info.is_empty()) {
-      auto old_usage = calc_utilization(seg_id);
-      segments.mark_open(seg_id, seq, type, category, generation);
-      if (type == segment_type_t::JOURNAL) {
-        assert(trimmer != nullptr);
-        trimmer->set_journal_head_sequence(seq);
-      }
-      background_callback->maybe_wake_background();
-      auto new_usage = calc_utilization(seg_id);
-      adjust_segment_util(old_usage, new_usage);
-      INFO("opened, {}", stat_printer_t{*this, false});
-      return seg_id;
+  // Open the new segment on the device with the fewest open segments,
+  // so that the journal and the OOL writers stream to different
+  // devices of a multi-device group in parallel instead of all filling
+  // the first one.  Devices which already reached their open segment
+  // limit (e.g. the active zone budget of a ZNS drive) are only used as a
+  // last resort.
+  std::map<device_id_t, std::size_t> num_open;
+  std::map<device_id_t, segment_id_t> first_empty;
+  for (auto& [seg_id, segment_info] : segments) {
+    auto device = seg_id.device_id();
+    if (segment_info.is_open()) {
+      ++num_open[device];
+    } else if (segment_info.is_empty() && !first_empty.contains(device)) {
+      first_empty.emplace(device, seg_id);
+    }
+  }
+  std::optional<segment_id_t> chosen;
+  std::size_t chosen_open = 0;
+  bool chosen_over_limit = false;
+  for (auto& [device, seg_id] : first_empty) {
+    auto n = num_open[device];
+    auto max_open = sm_group->get_max_open_segments(device);
+    bool over_limit = (max_open != 0 && n >= max_open);
+    if (!chosen ||
+        std::make_pair(over_limit, n) <
+        std::make_pair(chosen_over_limit, chosen_open)) {
+      chosen = seg_id;
+      chosen_open = n;
+      chosen_over_limit = over_limit;
+    }
+  }
+  if (chosen) {
+    auto seg_id = *chosen;
+    if (chosen_over_limit) {
+      WARN("{} open segments on device {} exceed its limit {}",
+           chosen_open + 1, device_id_printer_t{seg_id.device_id()},
+           sm_group->get_max_open_segments(seg_id.device_id()));
+    }
+    auto old_usage = calc_utilization(seg_id);
+    segments.mark_open(seg_id, seq, type, category, generation);
+    if (type == segment_type_t::JOURNAL) {
+      assert(trimmer != nullptr);
+      trimmer->set_journal_head_sequence(seq);
     }
+    background_callback->maybe_wake_background();
+    auto new_usage = calc_utilization(seg_id);
+    adjust_segment_util(old_usage, new_usage);
+    INFO("opened {}, {}", seg_id, stat_printer_t{*this, false});
+    return seg_id;
   }
   ERROR("out of space with {} {} {} {}",
         type, segment_seq_printer_t{seq}, category,
@@ -1053,11 +1089,11 @@ double SegmentCleaner::calc_gc_benefit_cost(
 {
   double util = calc_utilization(id);
   ceph_assert(util >= 0 && util < 1);
-  if constexpr (gc_formula == gc_formula_t::GREEDY) {
+  if (config.gc_formula == gc_formula_t::GREEDY) {
     return 1 - util;
   }
 
-  if constexpr (gc_formula == gc_formula_t::COST_BENEFIT) {
+  if (config.gc_formula == gc_formula_t::COST_BENEFIT) {
     if (util == 0) {
       return std::numeric_limits<double>::max();
     }
@@ -1072,7 +1108,7 @@ double SegmentCleaner::calc_gc_benefit_cost(
     }
   }
 
-  assert(gc_formula == gc_formula_t::BENEFIT);
+  assert(config.gc_formula == gc_formula_t::BENEFIT);
   auto modify_time = segments[id].modify_time;
   double age_factor = 0.5; // middle value if age is invalid
   if (likely(bound_time != NULL_TIME &&
@@ -1619,13 +1655,13 @@ segment_id_t SegmentCleaner::get_next_reclaim_segment() const
   segment_id_t id = NULL_SEG_ID;
   double max_benefit_cost = 0;
   sea_time_point now_time;
-  if constexpr (gc_formula != gc_formula_t::GREEDY) {
+  if (config.gc_formula != gc_formula_t::GREEDY) {
     now_time = seastar::lowres_system_clock::now();
   } else {
     now_time = NULL_TIME;
   }
   sea_time_point bound_time;
-  if constexpr (gc_formula == gc_formula_t::BENEFIT) {
+  if (config.gc_formula == gc_formula_t::BENEFIT) {
     bound_time = segments.get_time_bound();
     if (bound_time == NULL_TIME) {
       WARN("BENEFIT -- bound_time is NULL_TIME");
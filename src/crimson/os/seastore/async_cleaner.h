@@ -1221,6 +1221,13 @@ using SegmentCleanerRef = std::unique_ptr<SegmentCleaner>;
 
 class SegmentCleaner : public SegmentProvider, public AsyncCleaner {
 public:
+  /// How closed segments are scored for reclaim
+  enum class gc_formula_t {
+    GREEDY,       ///< least utilized first
+    BENEFIT,      ///< weighs utilization by age within the live range
+    COST_BENEFIT, ///< free space gained times age over the copy cost
+  };
+
   /// Config
   struct config_t {
     /// Ratio of maximum available space to disable reclaiming.
@@ -1231,20 +1238,15 @@ public:
     double reclaim_ratio_gc_threshold = 0;
     /// Number of bytes to reclaim per cycle
     std::size_t reclaim_bytes_per_cycle = 0;
+    /// Victim selection
+    gc_formula_t gc_formula = gc_formula_t::COST_BENEFIT;
 
     void validate() const {
       ceph_assert(available_ratio_gc_max > available_ratio_hard_limit);
       ceph_assert(reclaim_bytes_per_cycle > 0);
     }
 
-    static config_t get_default() {
-      return config_t{
-        .15,  // available_ratio_gc_max
-        .1,   // available_ratio_hard_limit
-        .1,   // reclaim_ratio_gc_threshold
-        1<<20 // reclaim_bytes_per_cycle
-      };
-    }
+    static config_t get_default();
 
     static config_t get_test() {
       return config_t{
@@ -103,10 +103,32 @@ public:
       if (ret.at_boundary()) {
         return seastar::do_with(
           ret,
-          [c, visitor](auto &ret) mutable {
-            return ret.handle_boundary(
-              c, visitor
-            ).si_then([&ret] {
+          [c, visitor](auto &ret) mutable -> iterator_fut {
+            auto n = c.cache.get_btree_scan_prefetch_leaves();
+            if (n == 0 || ret.get_depth() == 1) {
+              return ret.handle_boundary(
+                c, visitor
+              ).si_then([&ret] {
+                return std::move(ret);
+              });
+            }
+            // A scan stepping onto the next leaf reads it together with
+            // the n after it; when the next leaf is under a new parent,
+            // the siblings are read once that parent is found.
+            auto &parent = ret.get_internal(2);
+            bool same_parent = parent.pos + 1 < parent.node->get_size();
+            auto fut = same_parent
+              ? prefetch_leaves(c, parent.node, parent.pos + 1, n + 1)
+              : base_iertr::future<>(base_iertr::now());
+            return fut.si_then([&ret, c, visitor] {
+              return ret.handle_boundary(c, visitor);
+            }).si_then([&ret, c, n, same_parent]() -> base_iertr::future<> {
+              if (same_parent || ret.is_end()) {
+                return base_iertr::now();
+              }
+              auto &parent = ret.get_internal(2);
+              return prefetch_leaves(c, parent.node, parent.pos + 1, n);
+            }).si_then([&ret] {
               return std::move(ret);
             });
           });
@@ -1534,6 +1556,54 @@ private:
     });
   }
 
+  /**
+   * prefetch_leaves
+   *
+   * Reads the children [pos, pos + n) of the depth 2 node parent that
+   * are not yet linked, in parallel.  They are linked to parent as the
+   * reads are issued, so a later lookup finds them through get_child().
+   */
+  static base_iertr::future<> prefetch_leaves(
+    op_context_t<node_key_t> c,
+    InternalNodeRef parent,
+    uint16_t pos,
+    uint16_t n)
+  {
+    std::vector<uint16_t> positions;
+    for (uint16_t i = pos; i < parent->get_size() && positions.size() < n; ++i) {
+      positions.push_back(i);
+    }
+    return seastar::do_with(
+      std::move(positions),
+      [c, parent](auto &positions) {
+      return trans_intr::parallel_for_each(
+        positions,
+        [c, parent](uint16_t i) -> base_iertr::future<> {
+        auto node_iter = parent->iter_idx(i);
+        auto v = parent->template get_child<leaf_node_t>(c, node_iter);
+        if (v.has_child()) {
+          // cached, or already being read
+          return std::move(v.get_child_fut()).si_then([](auto) {});
+        }
+        auto child_pos = v.get_child_pos();
+        auto next_iter = node_iter + 1;
+        auto begin = node_iter->get_key();
+        auto end = next_iter == parent->end()
+          ? parent->get_node_meta().end
+          : next_iter->get_key();
+        return get_leaf_node(
+          c,
+          node_iter->get_val().maybe_relative_to(parent->get_paddr()),
+          begin,
+          end,
+          std::make_optional<node_position_t<leaf_node_t>>(
+            child_pos.template get_parent<leaf_node_t>(),
+            child_pos.get_pos())
+        ).si_then([](LeafNodeRef) {});
+      });
+    });
+  }
+
   using lookup_leaf_iertr = base_iertr;
   using lookup_leaf_ret = lookup_leaf_iertr::future<>;
   template <typename F>
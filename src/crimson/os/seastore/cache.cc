@@ -31,6 +31,8 @@ namespace crimson::os::seastore {
 Cache::Cache(
   ExtentPlacementManager &epm)
   : epm(epm),
+    btree_scan_prefetch_leaves(crimson::common::get_conf<uint64_t>(
+      "seastore_btree_scan_prefetch_leaves")),
     lru(crimson::common::get_conf<Option::size_t>(
 	  "seastore_cache_lru_size"))
 {
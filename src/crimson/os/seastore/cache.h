@@ -120,6 +120,11 @@ public:
 
   cache_stats_t get_stats(bool report_detail, double seconds) const;
 
+  /// number of sibling leaves a btree scan loads ahead of itself
+  uint16_t get_btree_scan_prefetch_leaves() const {
+    return btree_scan_prefetch_leaves;
+  }
+
   /// Creates empty transaction by source
   TransactionRef create_transaction(
       Transaction::src_t src,
@@ -1486,6 +1491,7 @@ private:
   }
 
   ExtentPlacementManager& epm;
+  const uint16_t btree_scan_prefetch_leaves;
   RootBlockRef root;               ///< ref to current root
   ExtentIndex extents_index;             ///< set of live extents
 
@@ -338,13 +338,21 @@ Journal::replay_ret CircularBoundedJournal::replay(
       std::move(delta_handler),
       std::map<paddr_t, journal_seq_t>(),
       std::map<paddr_t, std::pair<CachedExtentRef, uint32_t>>(),
-      [this](auto &d_handler, auto &map, auto &crc_info) {
-      auto build_paddr_seq_map = [&map](
+      [this, FNAME](auto &d_handler, auto &map, auto &crc_info) {
+      auto build_paddr_seq_map = [this, &map](
         const auto &offsets,
         const auto &e,
 	sea_time_point modify_time)
       {
-	if (e.type == extent_types_t::ALLOC_INFO) {
+	if (e.type == extent_types_t::JOURNAL_TAIL) {
+	  // the header is only rewritten once in a while, the latest tails
+	  // are the ones journaled by the trim transactions
+	  journal_tail_delta_t tail_delta;
+	  decode(tail_delta, e.bl);
+	  cjs.set_journal_tails(
+	    std::max(get_dirty_tail(), tail_delta.dirty_tail),
+	    std::max(get_alloc_tail(), tail_delta.alloc_tail));
+	} else if (e.type == extent_types_t::ALLOC_INFO) {
 	  alloc_delta_t alloc_delta;
 	  decode(alloc_delta, e.bl);
 	  if (alloc_delta.op == alloc_delta_t::op_types_t::CLEAR) {
@@ -361,7 +369,10 @@ Journal::replay_ret CircularBoundedJournal::replay(
       // The first pass to build the paddr->journal_seq_t map 
       // from extent allocations
       return scan_valid_record_delta(std::move(build_paddr_seq_map), tail
-      ).safe_then([this, &map, &d_handler, tail, &crc_info]() {
+      ).safe_then([this, FNAME, &map, &d_handler, &crc_info]() {
+	auto tail = get_dirty_tail() <= get_alloc_tail() ?
+	  get_dirty_tail() : get_alloc_tail();
+	DEBUG("replaying deltas from {}", tail);
 	auto call_d_handler_if_valid = [this, &map, &d_handler, &crc_info](
 	  const auto &offsets,
 	  const auto &e,
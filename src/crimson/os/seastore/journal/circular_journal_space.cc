@@ -6,6 +6,7 @@
 #include <fmt/format.h>
 #include <fmt/os.h>
 
+#include "crimson/common/config_proxy.h"
 #include "crimson/os/seastore/logging.h"
 #include "crimson/os/seastore/async_cleaner.h"
 #include "crimson/os/seastore/journal/circular_bounded_journal.h"
@@ -24,7 +25,10 @@ std::ostream &operator<<(std::ostream &out,
              << ")";
 }
 
-CircularJournalSpace::CircularJournalSpace(RBMDevice * device) : device(device) {}
+CircularJournalSpace::CircularJournalSpace(RBMDevice * device)
+  : header_sync_size(crimson::common::get_conf<Option::size_t>(
+      "seastore_cbjournal_header_sync_size")),
+    device(device) {}
   
 bool CircularJournalSpace::needs_roll(std::size_t length) const {
   if (length + get_rbm_addr(get_written_to()) > get_journal_end()) {
@@ -66,18 +70,65 @@ CircularJournalSpace::write(ceph::bufferlist&& to_write) {
   paddr_t paddr = convert_abs_addr_to_paddr(
     new_written_to,
     get_device_id());
+  bool sync_needed = is_header_sync_needed(encoded_size);
   set_written_to(
     journal_seq_t{get_written_to().segment_seq, paddr});
   DEBUG("length {}, commit target {}, used_size {}",
         encoded_size, target, get_records_used_size());
 
-  return device_write_bl(target, to_write
-  ).handle_error(
+  auto fut = sync_needed ? sync_header() : wait_header_synced();
+  return fut.then([this, target, to_write=std::move(to_write)]() mutable {
+    return seastar::do_with(
+      std::move(to_write),
+      [this, target](auto &bl) {
+      return device_write_bl(target, bl);
+    });
+  }).handle_error(
     write_ertr::pass_further{},
     crimson::ct_error::assert_all{ "Invalid error" }
   );
 }
 
+bool CircularJournalSpace::is_header_sync_needed(std::size_t length) const
+{
+  if (synced_tail == get_tail()) {
+    return false;
+  }
+  // records are never split at the journal end, so the free space between
+  // the write position and the synced tail does not wrap within a write
+  auto rbm_written_to = get_rbm_addr(get_written_to());
+  auto rbm_synced = get_rbm_addr(synced_tail);
+  auto distance = rbm_synced >= rbm_written_to ?
+    rbm_synced - rbm_written_to :
+    get_journal_end() - rbm_written_to + rbm_synced - get_records_start();
+  return distance < length;
+}
+
+seastar::future<> CircularJournalSpace::sync_header()
+{
+  auto fut = wait_header_synced().then([this] {
+    return write_header(
+    ).handle_error(
+      crimson::ct_error::assert_all{
+        "encountered invalid error in sync_header"
+    });
+  });
+  header_syncing.emplace(std::move(fut));
+  return header_syncing->get_future();
+}
+
+seastar::future<> CircularJournalSpace::wait_header_synced()
+{
+  if (!header_syncing) {
+    return seastar::now();
+  }
+  if (header_syncing->available()) {
+    header_syncing.reset();
+    return seastar::now();
+  }
+  return header_syncing->get_future();
+}
+
 segment_nonce_t calc_new_nonce(
   uint32_t crc,
   unsigned char const *data,
@@ -224,6 +275,7 @@ CircularJournalSpace::write_header()
 {
   LOG_PREFIX(CircularJournalSpace::write_header);
   ceph::bufferlist bl = encode_header();
+  synced_tail = get_tail();
   ceph_assert(bl.length() <= get_block_size());
   DEBUG(
     "sync header of CircularJournalSpace, length {}",
@@ -55,8 +55,10 @@ class CircularJournalSpace : public JournalAllocator {
   void update_modify_time(record_t& record) final {}
 
   close_ertr::future<> close() final {
-    return write_header(
-    ).safe_then([this]() -> close_ertr::future<> {
+    return wait_header_synced(
+    ).then([this] {
+      return write_header();
+    }).safe_then([this]() -> close_ertr::future<> {
       initialized = false;
       return close_ertr::now();
     }).handle_error(
@@ -107,6 +109,25 @@ class CircularJournalSpace : public JournalAllocator {
 
   submit_ertr::future<> write_header();
 
+  /*
+   * sync_header
+   *
+   * Write the header with the current tails after any header write still
+   * in flight.  Journal writes wait for it via wait_header_synced().
+   */
+  seastar::future<> sync_header();
+
+  seastar::future<> wait_header_synced();
+
+  /*
+   * is_header_sync_needed
+   *
+   * Whether a write of length bytes at the current write position would
+   * overwrite records between the tail recorded in the on-disk header and
+   * the current tail, which replay still needs to read.
+   */
+  bool is_header_sync_needed(std::size_t length) const;
+
 
   /**
    * CircularBoundedJournal structure
@@ -163,6 +184,9 @@ class CircularJournalSpace : public JournalAllocator {
   journal_seq_t get_alloc_tail() const {
     return header.alloc_tail;
   }
+  journal_seq_t get_tail() const {
+    return std::min(header.dirty_tail, header.alloc_tail);
+  }
 
   /* 
     Size-related interfaces
@@ -225,11 +249,17 @@ class CircularJournalSpace : public JournalAllocator {
     journal_seq_t alloc) {
     header.dirty_tail = dirty;
     header.alloc_tail = alloc;
-    return write_header(
-    ).handle_error(
-      crimson::ct_error::assert_all{
-      "encountered invalid error in update_journal_tail"
-    });
+    // the tails are also journaled by the trim transaction, defer the
+    // header write until the tail moved far enough or write() needs it
+    auto rbm_tail = get_rbm_addr(get_tail());
+    auto rbm_synced = get_rbm_addr(synced_tail);
+    auto distance = rbm_tail >= rbm_synced ?
+      rbm_tail - rbm_synced :
+      rbm_tail + get_records_total_size() + get_block_size() - rbm_synced;
+    if (distance < header_sync_size) {
+      return seastar::now();
+    }
+    return sync_header();
   }
 
   void set_initialized(bool init) {
@@ -238,6 +268,12 @@ class CircularJournalSpace : public JournalAllocator {
 
   void set_cbj_header(cbj_header_t& head) {
     header = head;
+    synced_tail = get_tail();
+  }
+
+  void set_journal_tails(journal_seq_t dirty, journal_seq_t alloc) {
+    header.dirty_tail = dirty;
+    header.alloc_tail = alloc;
   }
 
   cbj_header_t get_cbj_header() {
@@ -251,6 +287,10 @@ class CircularJournalSpace : public JournalAllocator {
  private:
   std::string print_name;
   cbj_header_t header;
+  // tail in the last header write, records from it on may not be overwritten
+  journal_seq_t synced_tail;
+  std::optional<seastar::shared_future<>> header_syncing;
+  const std::size_t header_sync_size;
   RBMDevice* device;
   journal_seq_t written_to;
   bool initialized = false;
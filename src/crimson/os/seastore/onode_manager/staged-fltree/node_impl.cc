@@ -4,12 +4,19 @@
 #include "node_impl.h"
 #include "node_layout.h"
 
+#include "crimson/common/config_proxy.h"
+
 namespace crimson::os::seastore::onode {
 
 #ifdef UNIT_TESTS_BUILT
 last_split_info_t last_split = {};
 #endif
 
+double get_tail_split_ratio()
+{
+  return crimson::common::get_conf<double>("seastore_onode_tail_split_ratio");
+}
+
 // XXX: branchless allocation
 eagain_ifuture<InternalNodeImpl::fresh_impl_t>
 InternalNodeImpl::allocate(
@@ -47,6 +47,15 @@ struct last_split_info_t {
 extern last_split_info_t last_split;
 #endif
 
+/**
+ * get_tail_split_ratio
+ *
+ * Share of the contents kept in the left node when a level-tail node
+ * splits on an insert past its largest key, see
+ * seastore_onode_tail_split_ratio.
+ */
+double get_tail_split_ratio();
+
 struct key_hobj_t;
 struct key_view_t;
 class NodeExtentMutable;
@@ -705,6 +705,17 @@ class NodeLayoutT final : public InternalNodeImpl, public LeafNodeImpl {
        */
       target_split_size = empty_size + (filled_kv_size + insert_size) / 2;
       assert(insert_size < (node_stage.total_size() - empty_size) / 2);
+      if (insert_stage == STAGE && insert_pos.index == INDEX_END &&
+          is_level_tail()) {
+        // Appending past the largest key, as a sorted load does, the left
+        // node is unlikely to receive more inserts, so keep it fuller.
+        // Capped at the current contents, the insert itself always goes
+        // to the right node and neither side can overflow.
+        size_t tail_split_size = empty_size +
+          (filled_kv_size + insert_size) * get_tail_split_ratio();
+        target_split_size = std::max(
+          target_split_size, std::min<size_t>(tail_split_size, filled_size()));
+      }
 
       std::optional<bool> _is_insert_left;
       split_at.set(node_stage);
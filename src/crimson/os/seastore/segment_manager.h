@@ -195,6 +195,17 @@ public:
     return ((device_segment_id_t)(get_available_size() / get_segment_size()));
   }
 
+  /**
+   * get_max_open_segments
+   *
+   * Number of segments that may be open for write at the same time, or 0
+   * if the device does not limit it.  Zoned devices bound the number of
+   * active zones.
+   */
+  virtual std::size_t get_max_open_segments() const {
+    return 0;
+  }
+
   virtual ~SegmentManager() {}
 
   static seastar::future<SegmentManagerRef>
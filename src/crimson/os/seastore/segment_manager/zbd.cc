@@ -5,6 +5,9 @@
 #include <string.h>
 #include <linux/blkzoned.h>
 
+#include <filesystem>
+#include <fstream>
+
 #include <fmt/format.h>
 #include "crimson/os/seastore/segment_manager/zbd.h"
 #include "crimson/common/config_proxy.h"
@@ -242,6 +245,30 @@ static seastar::future<size_t> get_nr_cnv_zones(
   );
 }
 
+// Zones in the implicitly/explicitly open or closed state count against
+// the device's active zone limit; writes to a new zone fail once it is
+// reached.  Read the limit from sysfs, falling back to the open zone limit
+// for kernels which do not report max_active_zones.  0 means no limit.
+static size_t get_max_active_zones(const std::string &device_path)
+{
+  LOG_PREFIX(ZBDSegmentManager::get_max_active_zones);
+  std::error_code ec;
+  auto dev = std::filesystem::canonical(device_path, ec);
+  if (ec) {
+    WARN("unable to resolve {}: {}", device_path, ec.message());
+    return 0;
+  }
+  auto queue = std::filesystem::path("/sys/block") / dev.filename() / "queue";
+  for (auto attr : {"max_active_zones", "max_open_zones"}) {
+    std::ifstream f(queue / attr);
+    size_t limit = 0;
+    if (f >> limit && limit > 0) {
+      DEBUG("{} {}: {}", device_path, attr, limit);
+      return limit;
+    }
+  }
+  return 0;
+}
 
 static write_ertr::future<> do_write(
   seastar::file &device,
@@ -421,6 +448,13 @@ ZBDSegmentManager::mount_ret ZBDSegmentManager::shard_mount()
   }).safe_then([=, this](auto meta){
     shard_info = meta.shard_infos[seastar::this_shard_id()];
     metadata = meta;
+    // every shard runs its own cleaner over its own range of zones, so
+    // split the device-wide budget between them
+    auto max_active_zones = get_max_active_zones(device_path);
+    if (max_active_zones) {
+      max_open_segments = std::max<size_t>(
+	1, max_active_zones / meta.shard_infos.size());
+    }
     return mount_ertr::now();
   });
 }
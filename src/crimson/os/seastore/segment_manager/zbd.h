@@ -167,6 +167,10 @@ namespace crimson::os::seastore::segment_manager::zbd {
       return metadata.segment_capacity;
     };
 
+    std::size_t get_max_open_segments() const final {
+      return max_open_segments;
+    }
+
     const seastore_meta_t &get_meta() const {
       return metadata.meta;
     };
@@ -189,6 +193,8 @@ namespace crimson::os::seastore::segment_manager::zbd {
     zbd_sm_metadata_t metadata;
     seastar::file device;
     uint32_t nr_zones;
+    // this shard's share of the device's active zone limit, 0 if unlimited
+    std::size_t max_open_segments = 0;
     struct effort_t {
       uint64_t num = 0;
       uint64_t bytes = 0;
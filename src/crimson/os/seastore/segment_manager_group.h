@@ -114,6 +114,11 @@ public:
     return segment_managers[id.device_id()]->open(id);
   }
 
+  std::size_t get_max_open_segments(device_id_t id) const {
+    assert(has_device(id));
+    return segment_managers[id]->get_max_open_segments();
+  }
+
   using release_ertr = SegmentManager::release_ertr;
   release_ertr::future<> release_segment(segment_id_t id) {
     assert(has_device(id.device_id()));
@@ -736,6 +736,9 @@ seastar::future<> OSD::start_asok_admin()
     asok->register_command(
       make_asok_hook<DumpSlowestHistoricOpsHook>(
 	std::as_const(get_shard_services().get_registry())));
+    asok->register_command(
+      make_asok_hook<DumpOpStageProfileHook>(
+	std::as_const(pg_shard_manager)));
     asok->register_command(
       make_asok_hook<DumpRecoveryReservationsHook>(get_shard_services()));
   });
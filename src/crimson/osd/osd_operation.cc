@@ -2,6 +2,10 @@
 // vim: ts=8 sw=2 smarttab
 
 #include "osd_operation.h"
+
+#include <bit>
+#include <ostream>
+
 #include "common/Formatter.h"
 #include "crimson/common/log.h"
 #include "crimson/osd/osd_operations/client_request.h"
@@ -39,6 +43,111 @@ void OSDOperationRegistry::do_stop()
 OSDOperationRegistry::OSDOperationRegistry()
   : OperationRegistryT(seastar::this_shard_id()) {}
 
+template <size_t... Is>
+std::array<const char*, ClientRequestStageProfile::NUM_STAGES>
+ClientRequestStageProfile::make_stage_names(std::index_sequence<Is...>)
+{
+  return {std::tuple_element_t<Is, stages_t>::type_name...};
+}
+
+const std::array<const char*, ClientRequestStageProfile::NUM_STAGES>
+ClientRequestStageProfile::stage_names =
+  make_stage_names(std::make_index_sequence<NUM_STAGES>{});
+
+void ClientRequestStageProfile::op_profile_t::mark(size_t next)
+{
+  auto now = clock_t::now();
+  if (stage < NUM_STAGES) {
+    spent[stage] += now - entered;
+    visited.set(stage);
+  }
+  stage = next;
+  entered = now;
+}
+
+ClientRequestStageProfile::ClientRequestStageProfile()
+{
+  namespace sm = seastar::metrics;
+  for (size_t i = 0; i < NUM_STAGES; ++i) {
+    metrics.add_group(
+      "osd",
+      {
+	sm::make_histogram(
+	  "client_request_stage_latency",
+	  [this, i] {
+	    const auto& s = stats[i];
+	    seastar::metrics::histogram h;
+	    h.sample_count = s.count;
+	    h.sample_sum = s.sum_us;
+	    uint64_t cumulative = 0;
+	    for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+	      cumulative += s.buckets[b];
+	      h.buckets.push_back({cumulative, double(1ull << b)});
+	    }
+	    return h;
+	  },
+	  sm::description("time client requests spent at a pipeline stage, "
+			  "in microseconds"),
+	  {sm::label_instance("stage", stage_names[i])}
+	),
+      }
+    );
+  }
+}
+
+void ClientRequestStageProfile::account(const op_profile_t& op)
+{
+  for (size_t i = 0; i < NUM_STAGES; ++i) {
+    if (!op.visited.test(i)) {
+      continue;
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+      op.spent[i]).count();
+    auto& s = stats[i];
+    ++s.count;
+    s.sum_us += us;
+    size_t bucket = us > 0 ? std::bit_width(uint64_t(us)) : 0;
+    ++s.buckets[std::min(bucket, NUM_BUCKETS - 1)];
+  }
+}
+
+void ClientRequestStageProfile::dump(ceph::Formatter* f) const
+{
+  f->open_array_section("stages");
+  for (size_t i = 0; i < NUM_STAGES; ++i) {
+    const auto& s = stats[i];
+    f->open_object_section("stage");
+    f->dump_string("name", stage_names[i]);
+    f->dump_unsigned("count", s.count);
+    f->dump_unsigned("sum_us", s.sum_us);
+    f->dump_float("avg_us", s.count ? double(s.sum_us) / s.count : 0);
+    f->open_array_section("histogram_us");
+    for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+      if (s.buckets[b]) {
+	f->open_object_section("bucket");
+	f->dump_unsigned("le", 1ull << b);
+	f->dump_unsigned("count", s.buckets[b]);
+	f->close_section();
+      }
+    }
+    f->close_section();
+    f->close_section();
+  }
+  f->close_section();
+}
+
+void ClientRequestStageProfile::dump_folded(
+  std::ostream& out, std::string_view prefix) const
+{
+  for (size_t i = 0; i < NUM_STAGES; ++i) {
+    if (stats[i].sum_us) {
+      out << prefix << "ClientRequest;" << stage_names[i] << " "
+	  << stats[i].sum_us
+	  << "\n";
+    }
+  }
+}
+
 static auto get_duration(const ClientRequest& client_request)
 {
   // TODO: consider enhancing `CompletionEvent` with computing duration
@@ -3,6 +3,17 @@
 
 #pragma once
 
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <iosfwd>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <seastar/core/metrics.hh>
+
 #include "crimson/common/operation.h"
 #include "crimson/osd/pg_interval_interrupt_condition.h"
 #include "crimson/osd/scheduler/scheduler.h"
@@ -82,6 +93,88 @@ struct CommonOBCPipeline {
   } send_reply;
 };
 
+/**
+ * Latency profile of the ClientRequest pipeline stages on one shard.
+ *
+ * The time from entering a stage until entering the next one, or until
+ * the request completes, is charged to that stage, so it covers both
+ * waiting for the stage and running in it.
+ */
+class ClientRequestStageProfile {
+  using stages_t = std::tuple<
+    ConnectionPipeline::AwaitActive,
+    ConnectionPipeline::AwaitMap,
+    ConnectionPipeline::GetPGMapping,
+    PerShardPipeline::CreateOrWaitPG,
+    CommonPGPipeline::WaitPGReady,
+    CommonPGPipeline::GetOBC,
+    CommonOBCPipeline::Process,
+    CommonOBCPipeline::WaitRepop,
+    CommonOBCPipeline::SendReply>;
+
+  template <class StageT, size_t I = 0>
+  static constexpr size_t index_of() {
+    if constexpr (I == std::tuple_size_v<stages_t>) {
+      return I;
+    } else if constexpr (std::is_same_v<
+			   StageT, std::tuple_element_t<I, stages_t>>) {
+      return I;
+    } else {
+      return index_of<StageT, I + 1>();
+    }
+  }
+
+public:
+  static constexpr size_t NUM_STAGES = std::tuple_size_v<stages_t>;
+  // power-of-two microsecond buckets, the last one is open ended
+  static constexpr size_t NUM_BUCKETS = 24;
+  using clock_t = std::chrono::steady_clock;
+
+  /// the time a single request spent at each stage
+  class op_profile_t {
+  public:
+    template <class StageT>
+    void enter() {
+      constexpr auto index = index_of<StageT>();
+      if constexpr (index < NUM_STAGES) {
+	mark(index);
+      }
+    }
+    void finish() {
+      mark(NUM_STAGES);
+    }
+  private:
+    friend ClientRequestStageProfile;
+    void mark(size_t next);
+
+    std::array<clock_t::duration, NUM_STAGES> spent = {};
+    std::bitset<NUM_STAGES> visited;
+    size_t stage = NUM_STAGES;
+    clock_t::time_point entered;
+  };
+
+  ClientRequestStageProfile();
+
+  void account(const op_profile_t& op);
+  void dump(ceph::Formatter* f) const;
+  /// one "<prefix>ClientRequest;<stage> <usec>" line per stage, the folded
+  /// stack format flamegraph.pl takes
+  void dump_folded(std::ostream& out, std::string_view prefix) const;
+
+private:
+  struct stage_stats_t {
+    uint64_t count = 0;
+    uint64_t sum_us = 0;
+    std::array<uint64_t, NUM_BUCKETS> buckets = {};
+  };
+  template <size_t... Is>
+  static std::array<const char*, NUM_STAGES> make_stage_names(
+    std::index_sequence<Is...>);
+  static const std::array<const char*, NUM_STAGES> stage_names;
+  std::array<stage_stats_t, NUM_STAGES> stats;
+  seastar::metrics::metric_group metrics;
+};
+
 
 enum class OperationTypeCode {
   client_request = 0,
@@ -238,6 +331,7 @@ protected:
 
   template <class InterruptorT=void, class StageT>
   auto enter_stage(StageT& stage) {
+    that()->template on_enter_stage<StageT>();
     return this->template with_blocking_event<typename StageT::BlockingEvent,
 	                                      InterruptorT>(
       [&stage, this] (auto&& trigger) {
@@ -250,6 +344,7 @@ protected:
 
   template <class StageT>
   void enter_stage_sync(StageT& stage) {
+    that()->template on_enter_stage<StageT>();
     that()->get_handle().template enter_sync<T>(
         stage, this->template get_trigger<typename StageT::BlockingEvent>());
   }
@@ -257,6 +352,12 @@ protected:
   template <class OpT>
   friend class crimson::os::seastore::OperationProxyT;
 
+public:
+  // hook for ops that profile their stages, see ClientRequest
+  template <class StageT>
+  void on_enter_stage() {}
+
+protected:
   // PGShardManager::start_pg_operation needs access to enter_stage, we can make this
   // more sophisticated later on
   friend class PGShardManager;
@@ -282,9 +383,17 @@ struct OSDOperationRegistry : OperationRegistryT<
   size_t dump_slowest_historic_client_requests(ceph::Formatter* f) const;
   void visit_ops_in_flight(std::function<void(const ClientRequest&)>&& visit);
 
+  ClientRequestStageProfile& get_client_stage_profile() {
+    return client_stage_profile;
+  }
+  const ClientRequestStageProfile& get_client_stage_profile() const {
+    return client_stage_profile;
+  }
+
 private:
   size_t num_recent_ops = 0;
   size_t num_slow_ops = 0;
+  ClientRequestStageProfile client_stage_profile;
 };
 /**
  * Throttles set of currently running operations
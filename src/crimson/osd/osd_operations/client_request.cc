@@ -53,6 +53,9 @@ void ClientRequest::Orderer::clear_and_cancel(PG &pg)
 void ClientRequest::complete_request(PG &pg)
 {
   track_event<CompletionEvent>();
+  stage_profile.finish();
+  pg.get_shard_services().get_registry().get_client_stage_profile(
+  ).account(stage_profile);
   pg.client_request_orderer.remove_request(*this);
   on_complete.set_value();
 }
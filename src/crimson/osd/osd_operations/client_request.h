@@ -32,6 +32,7 @@ class ClientRequest final : public PhasedOperationT<ClientRequest>,
                             private CommonClientRequest {
   // Initially set to primary core, updated to pg core after with_pg()
   ShardServices *shard_services = nullptr;
+  ClientRequestStageProfile::op_profile_t stage_profile;
 
   crimson::net::ConnectionRef l_conn;
   crimson::net::ConnectionXcoreRef r_conn;
@@ -117,6 +118,7 @@ public:
 
     template <typename InterruptorT=void, typename StageT>
     auto enter_stage(StageT &stage, ClientRequest &op) {
+      op.on_enter_stage<StageT>();
       return this->template with_blocking_event<
 	typename StageT::BlockingEvent,
 	InterruptorT>(
@@ -128,6 +130,7 @@ public:
 
     template <typename StageT>
     void enter_stage_sync(StageT &stage, ClientRequest &op) {
+      op.on_enter_stage<StageT>();
       handle.template enter_sync<ClientRequest>(
           stage, get_trigger<typename StageT::BlockingEvent>(op));
     }
@@ -309,6 +312,11 @@ public:
   };
 
   void put_historic() const;
+
+  template <class StageT>
+  void on_enter_stage() {
+    stage_profile.template enter<StageT>();
+  }
   static interruptible_future<> maybe_inject_delay() {
     if (common::local_conf()->osd_debug_inject_dispatch_delay_probability > 0) {
       if (rand() % 10000 <
@@ -203,6 +203,7 @@ public:
     ).then([this, core, cc_seq,
             op=std::move(op), f=std::move(f)]() mutable {
       get_local_state().registry.remove_from_registry(*op);
+      ++get_local_state().crosscore_ops_sent;
       auto f_conn = op->prepare_remote_submission();
       return shard_services.invoke_on(
         core,
@@ -211,6 +212,7 @@ public:
         ](auto &target_shard_services) mutable {
         op->finish_remote_submission(std::move(f_conn));
         target_shard_services.local_state.registry.add_to_registry(*op);
+        ++target_shard_services.local_state.crosscore_ops_received;
         return this->template process_ordered_op_remotely<T>(
             cc_seq, target_shard_services, std::move(op), std::move(f));
       });
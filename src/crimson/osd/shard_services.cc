@@ -49,7 +49,24 @@ PerShardState::PerShardState(
       static_cast<ceph_tid_t>(seastar::this_shard_id()) <<
       (std::numeric_limits<ceph_tid_t>::digits - 8)),
     startup_time(startup_time)
-{}
+{
+  register_metrics();
+}
+
+void PerShardState::register_metrics()
+{
+  namespace sm = seastar::metrics;
+  metrics.add_group(
+    "osd",
+    {
+      sm::make_counter(
+	"crosscore_ops_sent", crosscore_ops_sent,
+	sm::description("ops forwarded to the core owning their pg")),
+      sm::make_counter(
+	"crosscore_ops_received", crosscore_ops_received,
+	sm::description("ops forwarded from another core to a pg here")),
+    });
+}
 
 seastar::future<> PerShardState::dump_ops_in_flight(Formatter *f) const
 {
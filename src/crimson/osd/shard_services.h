@@ -7,6 +7,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <seastar/core/future.hh>
+#include <seastar/core/metrics.hh>
 
 #include "include/common_fwd.h"
 #include "osd_operation.h"
@@ -198,6 +199,14 @@ class PerShardState {
 
   OSDSuperblock per_shard_superblock;
 
+  // ops this shard handed to, or took from, the core owning their PG.
+  // The op and its message move as a pointer, so these count the
+  // cross-core hops rather than any copies.
+  uint64_t crosscore_ops_sent = 0;
+  uint64_t crosscore_ops_received = 0;
+  seastar::metrics::metric_group metrics;
+  void register_metrics();
+
 public:
   PerShardState(
     int whoami,
@@ -501,6 +510,7 @@ public:
   }
 
   auto &get_registry() { return local_state.registry; }
+  const auto &get_registry() const { return local_state.registry; }
 
   // Loggers
   PerfCounters &get_recoverystate_perf_logger() {
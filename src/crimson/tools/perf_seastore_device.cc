@@ -0,0 +1,199 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 smarttab
+
+/*
+ * Issue fixed-size DMA reads or writes against a block device (or file)
+ * the same way NVMeBlockDevice and BlockSegmentManager do, at a fixed
+ * queue depth, and report IOPS and latency percentiles.
+ *
+ * The reactor backend is chosen with seastar's own --reactor-backend
+ * option, so e.g.
+ *
+ *   perf-seastore-device --path /dev/nvme0n1 --reactor-backend linux-aio
+ *   perf-seastore-device --path /dev/nvme0n1 --reactor-backend io_uring
+ *
+ * compares the two data paths SeaStore can run on at QD1 and QD32.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include <boost/program_options.hpp>
+#include <boost/range/irange.hpp>
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/file.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/defer.hh>
+
+#include "crimson/common/log.h"
+
+namespace bpo = boost::program_options;
+using mono_clock = std::chrono::steady_clock;
+
+namespace {
+
+seastar::logger& logger() {
+  return crimson::get_logger(ceph_subsys_test);
+}
+
+struct bench_config_t {
+  std::string path;
+  bool write;
+  bool random;
+  size_t block_size;
+  uint64_t size;
+  std::chrono::seconds duration;
+};
+
+struct bench_result_t {
+  uint64_t ops = 0;
+  // the sequential workloads share one cursor across all slots
+  uint64_t next_block = 0;
+  std::vector<double> lat_us;
+};
+
+seastar::future<> run_depth(
+  seastar::file& f,
+  const bench_config_t& conf,
+  unsigned depth,
+  bench_result_t& result)
+{
+  const uint64_t blocks = conf.size / conf.block_size;
+  const auto deadline = mono_clock::now() + conf.duration;
+  return seastar::parallel_for_each(
+    boost::irange(0u, depth),
+    [&f, &conf, &result, blocks, deadline](unsigned slot) {
+    return seastar::do_with(
+      // each slot owns its buffer, as a user of a registered buffer would
+      seastar::temporary_buffer<char>::aligned(
+        f.memory_dma_alignment(), conf.block_size),
+      std::mt19937_64(slot),
+      [&f, &conf, &result, blocks, deadline](auto& buf, auto& rng) {
+      std::memset(buf.get_write(), 0x5a, buf.size());
+      return seastar::do_until(
+        [deadline] { return mono_clock::now() >= deadline; },
+        [&f, &conf, &result, &buf, &rng, blocks] {
+        uint64_t block = conf.random ?
+          rng() % blocks : result.next_block++ % blocks;
+        uint64_t off = block * conf.block_size;
+        auto start = mono_clock::now();
+        auto fut = conf.write ?
+          f.dma_write(off, buf.get(), buf.size()) :
+          f.dma_read(off, buf.get_write(), buf.size());
+        return fut.then([&conf, &result, start](size_t len) {
+          if (len != conf.block_size) {
+            logger().error("short io: {} != {}", len, conf.block_size);
+            return seastar::make_exception_future<>(
+              std::system_error(EIO, std::system_category()));
+          }
+          std::chrono::duration<double, std::micro> lat =
+            mono_clock::now() - start;
+          result.lat_us.push_back(lat.count());
+          ++result.ops;
+          return seastar::now();
+        });
+      });
+    });
+  });
+}
+
+void report(
+  const bench_config_t& conf,
+  unsigned depth,
+  bench_result_t& result)
+{
+  auto& lat = result.lat_us;
+  std::sort(lat.begin(), lat.end());
+  auto pct = [&lat](double p) {
+    return lat.empty() ? 0.0 : lat[std::min(lat.size() - 1,
+                                             size_t(lat.size() * p))];
+  };
+  double secs = conf.duration.count();
+  fmt::print("{} {} bs={} qd={}: {:.0f} iops, {:.1f} MiB/s, "
+             "lat(us) p50={:.1f} p99={:.1f} p99.9={:.1f} max={:.1f}\n",
+             conf.random ? "rand" : "seq",
+             conf.write ? "write" : "read",
+             conf.block_size, depth,
+             result.ops / secs,
+             result.ops * conf.block_size / secs / (1 << 20),
+             pct(0.5), pct(0.99), pct(0.999),
+             lat.empty() ? 0.0 : lat.back());
+}
+
+seastar::future<> run(const bench_config_t& conf,
+                      const std::vector<unsigned>& depths)
+{
+  return seastar::async([&conf, &depths] {
+    auto mode = conf.write ? seastar::open_flags::rw : seastar::open_flags::ro;
+    auto f = seastar::open_file_dma(conf.path, mode).get();
+    auto close = seastar::defer([&f] { f.close().get(); });
+    auto size = conf.size;
+    if (size == 0) {
+      size = f.size().get();
+    }
+    bench_config_t c = conf;
+    c.size = size - size % conf.block_size;
+    if (c.size < conf.block_size) {
+      throw std::runtime_error(fmt::format(
+        "{} is smaller than one block of {}", conf.path, conf.block_size));
+    }
+    fmt::print("path={} size={}\n", conf.path, c.size);
+    for (auto depth : depths) {
+      bench_result_t result;
+      run_depth(f, c, depth, result).get();
+      report(c, depth, result);
+    }
+  });
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  seastar::app_template app;
+  app.add_options()
+    ("path", bpo::value<std::string>()->required(),
+     "block device or file to benchmark")
+    ("op", bpo::value<std::string>()->default_value("randread"),
+     "randread, randwrite, read or write")
+    ("block-size", bpo::value<size_t>()->default_value(4096),
+     "io size in bytes")
+    ("size", bpo::value<uint64_t>()->default_value(0),
+     "bytes of the device to exercise, 0 means the whole device")
+    ("queue-depth", bpo::value<std::vector<unsigned>>()->default_value(
+        {1, 32}, "1 32"),
+     "queue depths to run, one after another")
+    ("duration", bpo::value<unsigned>()->default_value(10),
+     "seconds to run each queue depth");
+  return app.run(argc, argv, [&app] {
+    auto&& config = app.configuration();
+    auto op = config["op"].as<std::string>();
+    if (op != "randread" && op != "randwrite" &&
+        op != "read" && op != "write") {
+      logger().error("unknown --op {}", op);
+      return seastar::make_ready_future<int>(EXIT_FAILURE);
+    }
+    return seastar::do_with(
+      bench_config_t{
+        config["path"].as<std::string>(),
+        op.ends_with("write"),
+        op.starts_with("rand"),
+        config["block-size"].as<size_t>(),
+        config["size"].as<uint64_t>(),
+        std::chrono::seconds(config["duration"].as<unsigned>())},
+      config["queue-depth"].as<std::vector<unsigned>>(),
+      [](auto& conf, auto& depths) {
+      return run(conf, depths).then([] {
+        return EXIT_SUCCESS;
+      }).handle_exception([](auto ep) {
+        logger().error("benchmark failed: {}", ep);
+        return EXIT_FAILURE;
+      });
+    });
+  });
+}
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <thread>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/icl/interval_map.hpp>
@@ -564,6 +565,50 @@ int CrushTester::test(CephContext* cct)
         // create a vector to hold placement results temporarily 
         vector<int> temporary_per ( per.size() );
 
+        // nothing is reported per input: split the range over threads,
+        // each counting into its own per/sizes and merging afterwards
+        if (use_crush && num_threads > 1 && !output_mappings &&
+            !output_bad_mappings && !output_data_file && !output_choose_tries) {
+          vector<vector<int>> thread_per(num_threads, vector<int>(per.size()));
+          vector<map<int,int>> thread_sizes(num_threads);
+          vector<std::thread> threads;
+          int64_t span = batch_max - batch_min + 1;
+          for (int t = 0; t < num_threads; t++) {
+            int lo = batch_min + span * t / num_threads;
+            int hi = batch_min + span * (t + 1) / num_threads - 1;
+            threads.emplace_back([&, t, lo, hi] {
+              vector<int> out;
+              for (int x = lo; x <= hi; x++) {
+                uint32_t real_x = x;
+                if (pool_id != -1) {
+                  real_x = crush_hash32_2(CRUSH_HASH_RJENKINS1, x, (uint32_t)pool_id);
+                }
+                crush.do_rule(r, real_x, out, nr, weight, 0);
+                for (auto o : out) {
+                  if (o != CRUSH_ITEM_NONE) {
+                    thread_per[t][o]++;
+                  }
+                }
+                thread_sizes[t][out.size()]++;
+              }
+            });
+          }
+          for (int t = 0; t < num_threads; t++) {
+            threads[t].join();
+            for (unsigned i = 0; i < per.size(); i++) {
+              per[i] += thread_per[t][i];
+              temporary_per[i] += thread_per[t][i];
+            }
+            for (auto& [size, count] : thread_sizes[t]) {
+              sizes[size] += count;
+            }
+          }
+          batch_per[current_batch] = temporary_per;
+          batch_min = batch_max + 1;
+          batch_max = batch_min + objects_per_batch - 1;
+          continue;
+        }
+
         for (int x = batch_min; x <= batch_max; x++) {
           // create a vector to hold the results of a CRUSH placement or RNG simulation
           vector<int> out;
@@ -599,7 +644,6 @@ int CrushTester::test(CephContext* cct)
             }
           }
 
-          batch_per[current_batch] = temporary_per;
           sizes[out.size()]++;
           if (output_bad_mappings && 
               (out.size() != (unsigned)nr ||
@@ -607,6 +651,7 @@ int CrushTester::test(CephContext* cct)
             err << "bad mapping rule " << r << " x " << x << " num_rep " << nr << " result " << out << std::endl;
           }
         }
+        batch_per[current_batch] = temporary_per;
 
         batch_min = batch_max + 1;
         batch_max = batch_min + objects_per_batch - 1;
@@ -20,6 +20,7 @@ class CrushTester {
   int64_t pool_id;
 
   int num_batches;
+  int num_threads;
   bool use_crush;
 
   float mark_down_device_ratio;
@@ -173,6 +174,7 @@ public:
       min_rep(-1), max_rep(-1),
       pool_id(-1),
       num_batches(1),
+      num_threads(1),
       use_crush(true),
       mark_down_device_ratio(0.0),
       mark_down_bucket_ratio(1.0),
@@ -258,6 +260,13 @@ public:
     return num_batches;
   }
 
+  void set_threads(int t) {
+    num_threads = std::max(1, t);
+  }
+  int get_threads() const {
+    return num_threads;
+  }
+
   void set_random_placement() {
     use_crush = false;
   }
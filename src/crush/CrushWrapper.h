@@ -1613,19 +1613,20 @@ public:
   void do_rule(int rule, int x, std::vector<int>& out, int maxout,
 	       const WeightVector& weight,
 	       uint64_t choose_args_index) const {
-    std::vector<int> rawout(maxout);
-    std::vector<char> work(crush_work_size(crush, maxout));
+    // mappings are computed for every pg/object; keep the workspace
+    // allocation per thread instead of per call, and map straight into out
+    static thread_local std::vector<char> work;
+    work.resize(crush_work_size(crush, maxout));
     crush_init_workspace(crush, std::data(work));
     crush_choose_arg_map arg_map = choose_args_get_with_fallback(
       choose_args_index);
-    int numrep = crush_do_rule(crush, rule, x, std::data(rawout), maxout,
+    out.resize(maxout);
+    int numrep = crush_do_rule(crush, rule, x, std::data(out), maxout,
 			       std::data(weight), std::size(weight),
 			       std::data(work), arg_map.args);
     if (numrep < 0)
       numrep = 0;
     out.resize(numrep);
-    for (int i=0; i<numrep; i++)
-      out[i] = rawout[i];
   }
 
   int _choose_type_stack(
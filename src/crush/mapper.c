@@ -312,10 +312,8 @@ static inline __s32 *get_choose_arg_ids(const struct crush_bucket_straw2 *bucket
  * for reference, see the exponential distribution example at:  
  * https://en.wikipedia.org/wiki/Inverse_transform_sampling#Examples
  */
-static inline __s64 generate_exponential_distribution(int type, int x, int y, int z, 
-                                                      int weight)
+static inline __s64 generate_exponential_ln(unsigned int u)
 {
-	unsigned int u = crush_hash32_3(type, x, y, z);
 	u &= 0xffff;
 
 	/*
@@ -328,36 +326,46 @@ static inline __s64 generate_exponential_distribution(int type, int x, int y, in
 	 * [0, 0xffffffffffff] (corresponding to real numbers
 	 * [-11.090355,0]).
 	 */
-	__s64 ln = crush_ln(u) - 0x1000000000000ll;
-
-	/*
-	 * divide by 16.16 fixed-point weight.  note
-	 * that the ln value is negative, so a larger
-	 * weight means a larger (less negative) value
-	 * for draw.
-	 */
-	return div64_s64(ln, weight);
+	return crush_ln(u) - 0x1000000000000ll;
 }
 
+/* items hashed per crush_hash32_3_multi call */
+#define STRAW2_HASH_BATCH 32
+
 static int bucket_straw2_choose(const struct crush_bucket_straw2 *bucket,
 				int x, int r, const struct crush_choose_arg *arg,
                                 int position)
 {
-	unsigned int i, high = 0;
+	unsigned int i, j, n, high = 0;
 	__s64 draw, high_draw = 0;
+	__u32 u[STRAW2_HASH_BATCH];
         __u32 *weights = get_choose_arg_weights(bucket, arg, position);
         __s32 *ids = get_choose_arg_ids(bucket, arg);
-	for (i = 0; i < bucket->h.size; i++) {
-                dprintk("weight 0x%x item %d\n", weights[i], ids[i]);
-		if (weights[i]) {
-			draw = generate_exponential_distribution(bucket->h.hash, x, ids[i], r, weights[i]);
-		} else {
-			draw = S64_MIN;
-		}
+	for (i = 0; i < bucket->h.size; i += n) {
+		n = bucket->h.size - i;
+		if (n > STRAW2_HASH_BATCH)
+			n = STRAW2_HASH_BATCH;
+		crush_hash32_3_multi(bucket->h.hash, x, ids + i, r, u, n);
+		for (j = 0; j < n; j++) {
+			dprintk("weight 0x%x item %d\n", weights[i + j],
+				ids[i + j]);
+			if (weights[i + j]) {
+				/*
+				 * divide by 16.16 fixed-point weight.  note
+				 * that the ln value is negative, so a larger
+				 * weight means a larger (less negative) value
+				 * for draw.
+				 */
+				draw = div64_s64(generate_exponential_ln(u[j]),
+						 weights[i + j]);
+			} else {
+				draw = S64_MIN;
+			}
 
-		if (i == 0 || draw > high_draw) {
-			high = i;
-			high_draw = draw;
+			if (i + j == 0 || draw > high_draw) {
+				high = i + j;
+				high_draw = draw;
+			}
 		}
 	}
 
@@ -164,6 +164,24 @@ int ErasureCode::minimum_to_decode_with_cost(const set<int> &want_to_read,
        i != available.end();
        ++i)
     available_chunks.insert(i->first);
+  if (includes(available_chunks.begin(), available_chunks.end(),
+               want_to_read.begin(), want_to_read.end()))
+    return _minimum_to_decode(want_to_read, available_chunks, minimum);
+
+  // add chunks cheapest first until there are enough of them to decode
+  vector<pair<int, int>> by_cost;
+  for (auto &i : available)
+    by_cost.push_back(make_pair(i.second, i.first));
+  sort(by_cost.begin(), by_cost.end());
+  set<int> cheapest;
+  for (auto &i : by_cost) {
+    cheapest.insert(i.second);
+    set<int> found;
+    if (_minimum_to_decode(want_to_read, cheapest, &found) == 0) {
+      *minimum = std::move(found);
+      return 0;
+    }
+  }
   return _minimum_to_decode(want_to_read, available_chunks, minimum);
 }
 
@@ -222,6 +240,83 @@ int ErasureCode::encode(const set<int> &want_to_encode,
   return 0;
 }
 
+int ErasureCode::encode_stripes(const set<int> &want_to_encode,
+                                const bufferlist &in,
+                                unsigned int stripe_width,
+                                map<int, bufferlist> *encoded)
+{
+  ceph_assert(stripe_width > 0);
+  ceph_assert(in.length() % stripe_width == 0);
+  ceph_assert(encoded->empty());
+  unsigned int stripes = in.length() / stripe_width;
+  if (stripes == 0)
+    return 0;
+  unsigned int k = get_data_chunk_count();
+  unsigned int n = get_chunk_count();
+  unsigned int chunk_size = get_chunk_size(stripe_width);
+  // padded stripes cannot be laid end to end
+  if (stripes == 1 || !encode_is_positional() ||
+      chunk_size * k != stripe_width) {
+    for (unsigned int i = 0; i < in.length(); i += stripe_width) {
+      map<int, bufferlist> chunks;
+      bufferlist stripe;
+      stripe.substr_of(in, i, stripe_width);
+      int r = encode(want_to_encode, stripe, &chunks);
+      if (r)
+        return r;
+      for (auto &c : chunks)
+        (*encoded)[c.first].claim_append(c.second);
+    }
+    return 0;
+  }
+
+  // gather chunk i of every stripe into one aligned buffer per data
+  // chunk, so that the whole batch is encoded with one encode_chunks
+  unsigned int length = chunk_size * stripes;
+  map<int, bufferlist> chunks;
+  for (unsigned int i = 0; i < n; i++) {
+    bufferptr buf(buffer::create_aligned(length, SIMD_ALIGN));
+    if (i < k) {
+      for (unsigned int s = 0; s < stripes; s++) {
+        in.begin(s * stripe_width + i * chunk_size).copy(
+          chunk_size, buf.c_str() + s * chunk_size);
+      }
+    }
+    chunks[chunk_index(i)].push_back(std::move(buf));
+  }
+  int r = encode_chunks(want_to_encode, &chunks);
+  if (r)
+    return r;
+  for (auto &c : chunks) {
+    if (want_to_encode.count(c.first))
+      (*encoded)[c.first].claim_append(c.second);
+  }
+  return 0;
+}
+
+void ErasureCode::encode_delta(const bufferlist &old_data,
+                               const bufferlist &new_data,
+                               bufferlist *delta)
+{
+  ceph_assert(old_data.length() == new_data.length());
+  bufferlist o = old_data, n = new_data;
+  const char *op = o.c_str();
+  const char *np = n.c_str();
+  bufferptr out(buffer::create_aligned(old_data.length(), SIMD_ALIGN));
+  char *d = out.c_str();
+  for (unsigned i = 0; i < old_data.length(); ++i) {
+    d[i] = op[i] ^ np[i];
+  }
+  delta->clear();
+  delta->push_back(std::move(out));
+}
+
+int ErasureCode::apply_delta(const map<int, bufferlist> &in,
+                             map<int, bufferlist> *out)
+{
+  return -EOPNOTSUPP;
+}
+
 int ErasureCode::_decode(const set<int> &want_to_read,
 			 const map<int, bufferlist> &chunks,
 			 map<int, bufferlist> *decoded)
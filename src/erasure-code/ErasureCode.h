@@ -81,6 +81,24 @@ namespace ceph {
                        const bufferlist &in,
                        std::map<int, bufferlist> *encoded) override;
 
+    int encode_stripes(const std::set<int> &want_to_encode,
+                       const bufferlist &in,
+                       unsigned int stripe_width,
+                       std::map<int, bufferlist> *encoded) override;
+
+    /// true if every byte of a chunk is encoded independently of the
+    /// others, so that stripes can be laid end to end and encoded at once
+    virtual bool encode_is_positional() const {
+      return false;
+    }
+
+    void encode_delta(const bufferlist &old_data,
+                      const bufferlist &new_data,
+                      bufferlist *delta) override;
+
+    int apply_delta(const std::map<int, bufferlist> &in,
+                    std::map<int, bufferlist> *out) override;
+
     int decode(const std::set<int> &want_to_read,
                 const std::map<int, bufferlist> &chunks,
                 std::map<int, bufferlist> *decoded, int chunk_size) override;
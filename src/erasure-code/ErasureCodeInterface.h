@@ -370,6 +370,61 @@ namespace ceph {
     virtual int encode_chunks(const std::set<int> &want_to_encode,
                               std::map<int, bufferlist> *encoded) = 0;
 
+    /**
+     * Encode **in**, made of consecutive stripes of **stripe_width**
+     * bytes each, and append to **encoded** the chunks of every
+     * stripe listed in **want_to_encode**, in stripe order. The
+     * result is the same as calling **encode** once per stripe and
+     * concatenating the chunks, but codes that compute each byte of
+     * a chunk independently of the others may encode all the stripes
+     * with a single call to the underlying library.
+     *
+     * The length of **in** must be a multiple of **stripe_width** and
+     * **encoded** must be a pointer to an empty map.
+     *
+     * @param [in] want_to_encode chunk indexes to be encoded
+     * @param [in] in consecutive stripes to be encoded
+     * @param [in] stripe_width size of one stripe
+     * @param [out] encoded map chunk indexes to chunk data
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int encode_stripes(const std::set<int> &want_to_encode,
+                               const bufferlist &in,
+                               unsigned int stripe_width,
+                               std::map<int, bufferlist> *encoded) = 0;
+
+    /**
+     * Compute in **delta** the difference between the **old_data**
+     * and **new_data** content of a range of a data chunk, suitable
+     * for **apply_delta**. All three buffers have the same length.
+     *
+     * @param [in] old_data range of the data chunk before the write
+     * @param [in] new_data the same range after the write
+     * @param [out] delta difference between the two
+     */
+    virtual void encode_delta(const bufferlist &old_data,
+                              const bufferlist &new_data,
+                              bufferlist *delta) = 0;
+
+    /**
+     * Update coding chunks in place so that they match data chunks
+     * modified by the **in** deltas, without reading the data chunks
+     * that did not change. **in** maps data chunk indexes to deltas
+     * computed by **encode_delta**, **out** maps every coding chunk
+     * index to the same range of that coding chunk. All buffers have
+     * the same length.
+     *
+     * Returns -EOPNOTSUPP if the code cannot update a range of the
+     * coding chunks independently of the rest of the stripe; the
+     * caller must then re-encode the full stripe.
+     *
+     * @param [in] in map data chunk indexes to deltas
+     * @param [in,out] out map coding chunk indexes to coding data
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int apply_delta(const std::map<int, bufferlist> &in,
+                            std::map<int, bufferlist> *out) = 0;
+
     /**
      * Decode the **chunks** and store at least **want_to_read**
      * chunks in **decoded**.
@@ -163,6 +163,41 @@ ErasureCodeIsaDefault::isa_encode(char **data,
 
 // -----------------------------------------------------------------------------
 
+int
+ErasureCodeIsaDefault::apply_delta(const map<int, bufferlist> &in,
+                                   map<int, bufferlist> *out)
+{
+  char *coding[m];
+  int blocksize = -1;
+  for (int i = 0; i < m; i++) {
+    auto p = out->find(k + i);
+    if (p == out->end())
+      return -EINVAL;
+    if (blocksize < 0)
+      blocksize = p->second.length();
+    else if ((int) p->second.length() != blocksize)
+      return -EINVAL;
+    coding[i] = p->second.c_str();
+  }
+  for (auto& [chunk, delta] : in) {
+    if (chunk < 0 || chunk >= k || (int) delta.length() != blocksize)
+      return -EINVAL;
+    bufferlist d = delta;
+    char *data = d.c_str();
+    if (m == 1) {
+      byte_xor(data, coding[0], data + blocksize);
+    } else {
+      // coding[i] ^= coeff[i][chunk] * data
+      ec_encode_data_update(blocksize, k, m, chunk, encode_tbls,
+                            (unsigned char*) data,
+                            (unsigned char**) coding);
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+
 bool
 ErasureCodeIsaDefault::erasure_contains(int *erasures, int i)
 {
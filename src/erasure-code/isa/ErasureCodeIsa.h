@@ -78,6 +78,10 @@ public:
 
   unsigned int get_chunk_size(unsigned int stripe_width) const override;
 
+  bool encode_is_positional() const override {
+    return true;
+  }
+
   int encode_chunks(const std::set<int> &want_to_encode,
                     std::map<int, ceph::buffer::list> *encoded) override;
 
@@ -143,6 +147,9 @@ public:
                           char **coding,
                           int blocksize) override;
 
+  int apply_delta(const std::map<int, ceph::buffer::list> &in,
+                  std::map<int, ceph::buffer::list> *out) override;
+
   virtual bool erasure_contains(int *erasures, int i);
 
   int isa_decode(int *erasures,
@@ -112,6 +112,59 @@ int ErasureCodeJerasure::encode_chunks(const set<int> &want_to_encode,
   return 0;
 }
 
+int ErasureCodeJerasure::apply_delta(const map<int, bufferlist> &in,
+				     map<int, bufferlist> *out)
+{
+  char *coding[m];
+  int blocksize = -1;
+  for (int i = 0; i < m; i++) {
+    auto p = out->find(k + i);
+    if (p == out->end())
+      return -EINVAL;
+    if (blocksize < 0)
+      blocksize = p->second.length();
+    else if ((int)p->second.length() != blocksize)
+      return -EINVAL;
+    coding[i] = p->second.c_str();
+  }
+  for (auto& [chunk, delta] : in) {
+    if (chunk < 0 || chunk >= k || (int)delta.length() != blocksize)
+      return -EINVAL;
+    bufferlist d = delta;
+    int r = jerasure_apply_delta(chunk, d.c_str(), coding, blocksize);
+    if (r < 0)
+      return r;
+  }
+  return 0;
+}
+
+// parity[i] += matrix[i][chunk] * delta over GF(2^w)
+static void matrix_apply_delta(int k, int m, int w, const int *matrix,
+			       int chunk, char *delta, char **coding,
+			       int blocksize)
+{
+  for (int i = 0; i < m; i++) {
+    int c = matrix[i * k + chunk];
+    if (c == 0)
+      continue;
+    if (c == 1) {
+      galois_region_xor(delta, coding[i], blocksize);
+      continue;
+    }
+    switch (w) {
+    case 8:
+      galois_w08_region_multiply(delta, c, blocksize, coding[i], 1);
+      break;
+    case 16:
+      galois_w16_region_multiply(delta, c, blocksize, coding[i], 1);
+      break;
+    case 32:
+      galois_w32_region_multiply(delta, c, blocksize, coding[i], 1);
+      break;
+    }
+  }
+}
+
 int ErasureCodeJerasure::decode_chunks(const set<int> &want_to_read,
 				       const map<int, bufferlist> &chunks,
 				       map<int, bufferlist> *decoded)
@@ -162,6 +215,13 @@ void ErasureCodeJerasureReedSolomonVandermonde::jerasure_encode(char **data,
   jerasure_matrix_encode(k, m, w, matrix, data, coding, blocksize);
 }
 
+int ErasureCodeJerasureReedSolomonVandermonde::jerasure_apply_delta(
+  int chunk, char *delta, char **coding, int blocksize)
+{
+  matrix_apply_delta(k, m, w, matrix, chunk, delta, coding, blocksize);
+  return 0;
+}
+
 int ErasureCodeJerasureReedSolomonVandermonde::jerasure_decode(int *erasures,
                                                                 char **data,
                                                                 char **coding,
@@ -213,6 +273,13 @@ void ErasureCodeJerasureReedSolomonRAID6::jerasure_encode(char **data,
   reed_sol_r6_encode(k, w, data, coding, blocksize);
 }
 
+int ErasureCodeJerasureReedSolomonRAID6::jerasure_apply_delta(
+  int chunk, char *delta, char **coding, int blocksize)
+{
+  matrix_apply_delta(k, m, w, matrix, chunk, delta, coding, blocksize);
+  return 0;
+}
+
 int ErasureCodeJerasureReedSolomonRAID6::jerasure_decode(int *erasures,
 							 char **data,
 							 char **coding,
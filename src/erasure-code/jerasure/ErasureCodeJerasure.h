@@ -56,6 +56,10 @@ public:
 
   unsigned int get_chunk_size(unsigned int stripe_width) const override;
 
+  bool encode_is_positional() const override {
+    return true;
+  }
+
   int encode_chunks(const std::set<int> &want_to_encode,
 		    std::map<int, ceph::buffer::list> *encoded) override;
 
@@ -63,11 +67,20 @@ public:
 		    const std::map<int, ceph::buffer::list> &chunks,
 		    std::map<int, ceph::buffer::list> *decoded) override;
 
+  int apply_delta(const std::map<int, ceph::buffer::list> &in,
+		  std::map<int, ceph::buffer::list> *out) override;
+
   int init(ceph::ErasureCodeProfile &profile, std::ostream *ss) override;
 
   virtual void jerasure_encode(char **data,
                                char **coding,
                                int blocksize) = 0;
+  virtual int jerasure_apply_delta(int chunk,
+				   char *delta,
+				   char **coding,
+				   int blocksize) {
+    return -EOPNOTSUPP;
+  }
   virtual int jerasure_decode(int *erasures,
                                char **data,
                                char **coding,
@@ -102,6 +115,10 @@ public:
                                char **data,
                                char **coding,
                                int blocksize) override;
+  int jerasure_apply_delta(int chunk,
+			   char *delta,
+			   char **coding,
+			   int blocksize) override;
   unsigned get_alignment() const override;
   void prepare() override;
 private:
@@ -132,6 +149,10 @@ public:
                                char **data,
                                char **coding,
                                int blocksize) override;
+  int jerasure_apply_delta(int chunk,
+			   char *delta,
+			   char **coding,
+			   int blocksize) override;
   unsigned get_alignment() const override;
   void prepare() override;
 private:
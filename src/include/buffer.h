@@ -369,6 +369,11 @@ struct error_code;
 
     ~ptr_node() = default;
 
+    // a ptr_node is allocated for nearly every append, so freed nodes are
+    // kept in a small per-thread cache for reuse
+    static void* operator new(std::size_t size);
+    static void operator delete(void* p);
+
     static std::unique_ptr<ptr_node, disposer>
     create(ceph::unique_leakable_ptr<raw> r) {
       return create_hypercombined(std::move(r));
@@ -17,6 +17,17 @@ extern ceph_crc32c_func_t ceph_crc32c_func;
 
 extern ceph_crc32c_func_t ceph_choose_crc32(void);
 
+typedef void (*ceph_crc32c_multi_func_t)(uint32_t crc, unsigned char const *data,
+					 unsigned chunk_len, unsigned count,
+					 uint32_t *out);
+
+/*
+ * the chosen implementation for checksumming many equally sized chunks
+ */
+extern ceph_crc32c_multi_func_t ceph_crc32c_multi_func;
+
+extern ceph_crc32c_multi_func_t ceph_choose_crc32c_multi(void);
+
 /**
  * calculate crc32c for data that is entirely 0 (ZERO)
  *
@@ -50,6 +61,25 @@ static inline uint32_t ceph_crc32c(uint32_t crc, unsigned char const *data, unsi
   return ceph_crc32c_func(crc, data, length);
 }
 
+/**
+ * calculate crc32c of count consecutive chunks independently
+ *
+ * out[i] is set to the crc32c of data[i * chunk_len, (i + 1) * chunk_len)
+ * starting from crc, same as calling ceph_crc32c() for each chunk.
+ *
+ * @param crc initial value for every chunk
+ * @param data pointer to count * chunk_len bytes, must not be NULL
+ * @param chunk_len length of each chunk
+ * @param count number of chunks
+ * @param out array of count results
+ */
+static inline void ceph_crc32c_multi(uint32_t crc, unsigned char const *data,
+				     unsigned chunk_len, unsigned count,
+				     uint32_t *out)
+{
+  ceph_crc32c_multi_func(crc, data, chunk_len, count, out);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <map>
+#include <memory_resource>
 #include <unordered_map>
 #include <set>
 #include <vector>
@@ -174,6 +175,7 @@ namespace mempool {
   f(osd)			      \
   f(osd_mapbl)			      \
   f(osd_pglog)			      \
+  f(osd_pgtrans)		      \
   f(osdmap)			      \
   f(osdmap_mapping)		      \
   f(pgmap)			      \
@@ -450,6 +452,27 @@ public:
   bool operator!=(const pool_allocator&) const { return false; }
 };
 
+// A std::pmr::memory_resource that allocates from the heap and accounts
+// what it hands out to a pool; mainly the upstream of a per-object
+// std::pmr::monotonic_buffer_resource, so what such an arena spills to
+// the heap is still tracked.
+template<pool_index_t pool_ix>
+class pool_memory_resource : public std::pmr::memory_resource {
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    get_pool(pool_ix).adjust_count(1, bytes);
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes,
+		     std::size_t alignment) override {
+    get_pool(pool_ix).adjust_count(-1, -(ssize_t)bytes);
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
 
 // Namespace mempool
 
@@ -507,6 +530,10 @@ public:
     inline size_t allocated_bytes() {					\
       return mempool::get_pool(id).allocated_bytes();			\
     }									\
+    inline std::pmr::memory_resource* memory_resource() {		\
+      static mempool::pool_memory_resource<id> resource;		\
+      return &resource;							\
+    }									\
     inline size_t allocated_items() {					\
       return mempool::get_pool(id).allocated_items();			\
     }									\
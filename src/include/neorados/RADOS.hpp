@@ -24,7 +24,9 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -1406,6 +1408,43 @@ public:
       }, consigned);
   }
 
+  /// Execute a batch of operations, keeping at most `max_concurrent`
+  /// (at least one) in flight. The handler is called once all of them
+  /// have completed, with the first error seen, if any, and every
+  /// operation's own result in the order the operations were given.
+  using ExecuteManySig = void(boost::system::error_code,
+			      std::vector<boost::system::error_code>);
+  using ExecuteManyComp = boost::asio::any_completion_handler<ExecuteManySig>;
+  template<boost::asio::completion_token_for<ExecuteManySig> CompletionToken>
+  auto execute_many(IOContext ioc,
+		    std::vector<std::pair<Object, ReadOp>> ops,
+		    std::size_t max_concurrent, CompletionToken&& token) {
+    auto consigned = boost::asio::consign(
+      std::forward<CompletionToken>(token), boost::asio::make_work_guard(
+	boost::asio::get_associated_executor(token, get_executor())));
+    return boost::asio::async_initiate<decltype(consigned), ExecuteManySig>(
+      [ioc = std::move(ioc), ops = std::move(ops), max_concurrent,
+       this](auto&& handler) mutable {
+	execute_many_(std::move(ioc), std::move(ops), max_concurrent,
+		      std::move(handler));
+      }, consigned);
+  }
+
+  template<boost::asio::completion_token_for<ExecuteManySig> CompletionToken>
+  auto execute_many(IOContext ioc,
+		    std::vector<std::pair<Object, WriteOp>> ops,
+		    std::size_t max_concurrent, CompletionToken&& token) {
+    auto consigned = boost::asio::consign(
+      std::forward<CompletionToken>(token), boost::asio::make_work_guard(
+	boost::asio::get_associated_executor(token, get_executor())));
+    return boost::asio::async_initiate<decltype(consigned), ExecuteManySig>(
+      [ioc = std::move(ioc), ops = std::move(ops), max_concurrent,
+       this](auto&& handler) mutable {
+	execute_many_(std::move(ioc), std::move(ops), max_concurrent,
+		      std::move(handler));
+      }, consigned);
+  }
+
   boost::uuids::uuid get_fsid() const noexcept;
 
   using LookupPoolSig = void(boost::system::error_code,
@@ -1813,6 +1852,13 @@ private:
 		Op::Completion c, uint64_t* objver,
 		const blkin_trace_info* trace_info);
 
+  void execute_many_(IOContext ioc,
+		     std::vector<std::pair<Object, ReadOp>> ops,
+		     std::size_t max_concurrent, ExecuteManyComp c);
+  void execute_many_(IOContext ioc,
+		     std::vector<std::pair<Object, WriteOp>> ops,
+		     std::size_t max_concurrent, ExecuteManyComp c);
+
   void lookup_pool_(std::string name, LookupPoolComp c);
   void list_pools_(LSPoolsComp c);
   void create_pool_snap_(int64_t pool, std::string snap_name,
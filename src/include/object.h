@@ -146,6 +146,7 @@ struct denc_traits<snapid_t> {
     denc(o.val, p);
   }
 };
+WRITE_CLASS_DENC_MEMCPY(snapid_t)
 
 inline std::ostream& operator<<(std::ostream& out, const snapid_t& s) {
   if (s == CEPH_NOSNAP)
@@ -156,7 +156,9 @@ Future JournalRecorder::append(uint64_t tag_tid,
 	 entry_bl);
   ceph_assert(entry_bl.length() <= m_journal_metadata->get_object_size());
 
-  bool object_full = object_ptr->append({{future, entry_bl}});
+  AppendBuffers append_buffers;
+  append_buffers.emplace_back(future, std::move(entry_bl));
+  bool object_full = object_ptr->append(std::move(append_buffers));
   m_object_locks[splay_offset].unlock();
 
   if (object_full) {
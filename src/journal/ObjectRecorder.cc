@@ -80,8 +80,8 @@ bool ObjectRecorder::append(AppendBuffers &&append_buffers) {
       last_flushed_future = append_buffer.first;
     }
 
-    m_pending_buffers.push_back(append_buffer);
     m_pending_bytes += append_buffer.second.length();
+    m_pending_buffers.push_back(std::move(append_buffer));
   }
 
   return send_appends(!!last_flushed_future, last_flushed_future);
@@ -341,8 +341,10 @@ bool ObjectRecorder::send_appends(bool force, ceph::ref_t<FutureImpl> flush_futu
     }
 
     append_bytes += bl.length();
-    append_buffers.push_back(*it);
-    it = m_pending_buffers.erase(it);
+    // splice the node across instead of copying the future and bufferlist
+    auto next = std::next(it);
+    append_buffers.splice(append_buffers.end(), m_pending_buffers, it);
+    it = next;
 
     if (flush_break) {
       ldout(m_cct, 20) << "stopping at requested flush future" << dendl;
@@ -4,12 +4,15 @@
 #define KEY_VALUE_DB_H
 
 #include "include/buffer.h"
+#include <algorithm>
+#include <cstring>
 #include <ostream>
 #include <set>
 #include <map>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 #include <boost/scoped_ptr.hpp>
 #include "include/encoding.h"
 #include "common/Formatter.h"
@@ -197,6 +200,58 @@ public:
     return get(prefix, std::string(key, keylen), value);
   }
 
+  /// Key/value pairs returned by next_batch(). Keys and values are views
+  /// into a single contiguous arena which stays alive for as long as any
+  /// of them is referenced.
+  struct KVBatch {
+    std::vector<std::pair<ceph::buffer::ptr, ceph::buffer::ptr>> entries;
+
+    size_t size() const {
+      return entries.size();
+    }
+    bool empty() const {
+      return entries.empty();
+    }
+    void clear() {
+      entries.clear();
+    }
+  };
+
+private:
+  // Copies up to max_entries pairs starting at the current position into
+  // one arena of (at least) max_bytes and advances past them. An entry
+  // bigger than the arena only ever goes into a batch on its own.
+  template <typename It>
+  static int fill_batch(It& it, size_t max_entries, size_t max_bytes,
+			KVBatch* out) {
+    out->clear();
+    ceph::buffer::ptr arena;
+    size_t off = 0;
+    while (out->size() < max_entries && it.valid()) {
+      std::string_view k = it.key_as_sv();
+      std::string_view v = it.value_as_sv();
+      if (off + k.size() + v.size() > arena.length()) {
+	if (!out->empty()) {
+	  break;
+	}
+	arena = ceph::buffer::create(std::max(k.size() + v.size(), max_bytes));
+      }
+      char* p = arena.c_str() + off;
+      memcpy(p, k.data(), k.size());
+      memcpy(p + k.size(), v.data(), v.size());
+      out->entries.emplace_back(
+	ceph::buffer::ptr(arena, off, k.size()),
+	ceph::buffer::ptr(arena, off + k.size(), v.size()));
+      off += k.size() + v.size();
+      int r = it.next();
+      if (r < 0) {
+	return r;
+      }
+    }
+    return it.status();
+  }
+
+public:
   // This superclass is used both by kv iterators *and* by the ObjectMap
   // omap iterator.  The class hierarchies are unfortunately tied together
   // by the legacy DBOjectMap implementation :(.
@@ -241,6 +296,12 @@ public:
 	ceph_abort();
       }
     }
+    /// Fills *out with up to max_entries pairs from the current position
+    /// and moves the iterator past them.
+    virtual int next_batch(size_t max_entries, size_t max_bytes,
+			   KVBatch* out) {
+      return fill_batch(*this, max_entries, max_bytes, out);
+    }
   };
   typedef std::shared_ptr< IteratorImpl > Iterator;
 
@@ -278,6 +339,12 @@ public:
     virtual size_t value_size() {
       return 0;
     }
+    /// Fills *out with up to max_entries pairs from the current position
+    /// and moves the iterator past them; keys don't include the prefix.
+    virtual int next_batch(size_t max_entries, size_t max_bytes,
+			   KVBatch* out) {
+      return fill_batch(*this, max_entries, max_bytes, out);
+    }
     virtual ~WholeSpaceIteratorImpl() { }
   };
   typedef std::shared_ptr< WholeSpaceIteratorImpl > WholeSpaceIterator;
@@ -359,6 +426,8 @@ protected:
 public:
   typedef uint32_t IteratorOpts;
   static const uint32_t ITERATOR_NOCACHE = 1;
+  /// hint that the iterator is used for a long forward scan
+  static const uint32_t ITERATOR_PREFETCH = 2;
 
   struct IteratorBounds {
     std::optional<std::string> lower_bound;
@@ -400,6 +469,11 @@ public:
     return nullptr;
   }
 
+  /// secondary cache of compressed blocks, if there is one
+  virtual std::shared_ptr<PriorityCache::PriCache> get_compressed_priority_cache() const {
+    return nullptr;
+  }
+
 
 
   virtual ~KeyValueDB() {}
@@ -7,6 +7,7 @@
 #include <set>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <errno.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -60,6 +61,7 @@ static const char* sharding_def_dir = "sharding";
 static const char* sharding_def_file = "sharding/def";
 static const char* sharding_recreate = "sharding/recreate_columns";
 static const char* resharding_column_lock = "reshardingXcommencingXlocked";
+static const char* sharding_online_file = "sharding/online_target";
 
 static bufferlist to_bufferlist(rocksdb::Slice in) {
   bufferlist bl;
@@ -546,11 +548,33 @@ int RocksDBStore::load_rocksdb_options(bool create_if_missing, rocksdb::Options&
   }
   uint64_t row_cache_size = cache_size * cct->_conf->rocksdb_cache_row_ratio;
   uint64_t block_cache_size = cache_size - row_cache_size;
+  uint64_t compressed_cache_size = 0;
+#if ROCKSDB_MAJOR < 8
+  compressed_cache_size =
+    block_cache_size * cct->_conf->rocksdb_cache_compressed_ratio;
+  block_cache_size -= compressed_cache_size;
+#else
+  if (cct->_conf->rocksdb_cache_compressed_ratio > 0) {
+    dout(1) << __func__ << " rocksdb_cache_compressed_ratio ignored,"
+	    << " this RocksDB has no compressed block cache" << dendl;
+  }
+#endif
 
   bbt_opts.block_cache = create_block_cache(cct->_conf->rocksdb_cache_type, block_cache_size);
   if (!bbt_opts.block_cache) {
     return -EINVAL;
   }
+#if ROCKSDB_MAJOR < 8
+  if (compressed_cache_size > 0) {
+    // holds the on-disk (compressed) form of data blocks; this is only
+    // populated when the table compression isn't kNoCompression
+    bbt_opts.block_cache_compressed =
+      create_block_cache(cct->_conf->rocksdb_cache_type, compressed_cache_size);
+    if (!bbt_opts.block_cache_compressed) {
+      return -EINVAL;
+    }
+  }
+#endif
   bbt_opts.block_size = cct->_conf->rocksdb_block_size;
 
   if (row_cache_size > 0)
@@ -598,6 +622,7 @@ int RocksDBStore::load_rocksdb_options(bool create_if_missing, rocksdb::Options&
   opt.table_factory.reset(rocksdb::NewBlockBasedTableFactory(bbt_opts));
   dout(10) << __func__ << " block size " << cct->_conf->rocksdb_block_size
            << ", block_cache size " << byte_u_t(block_cache_size)
+	   << ", compressed block_cache size " << byte_u_t(compressed_cache_size)
 	   << ", row_cache size " << byte_u_t(row_cache_size)
 	   << "; shards "
 	   << (1 << cct->_conf->rocksdb_cache_shard_bits)
@@ -696,6 +721,53 @@ rocksdb::ColumnFamilyHandle *RocksDBStore::check_cf_handle_bounds(const cf_handl
   }
 }
 
+std::vector<rocksdb::ColumnFamilyHandle *> RocksDBStore::get_prefix_handles(
+  const cf_handles_iterator& iter, bool* moving)
+{
+  auto handles = iter->second.handles;
+  if (moving) {
+    *moving = false;
+  }
+  if (online_reshard_active) {
+    std::shared_lock l(layout_lock);
+    auto p = reshard_from.find(iter->first);
+    if (p != reshard_from.end()) {
+      for (auto h : p->second.handles) {
+	if (std::find(handles.begin(), handles.end(), h) == handles.end()) {
+	  handles.push_back(h);
+	}
+      }
+      if (moving) {
+	*moving = true;
+      }
+    }
+  }
+  return handles;
+}
+
+rocksdb::Status RocksDBStore::_get_cf(const std::string& prefix,
+				      rocksdb::ColumnFamilyHandle* cf,
+				      const rocksdb::Slice& key,
+				      rocksdb::PinnableSlice* value)
+{
+  if (online_reshard_active) {
+    std::shared_lock l(layout_lock);
+    auto p = reshard_from.find(prefix);
+    if (p != reshard_from.end()) {
+      // keys not moved yet are found in the previous layout
+      auto from = get_key_cf(p->second, key.data(), key.size());
+      if (from != cf) {
+	auto s = db->Get(rocksdb::ReadOptions(), from, key, value);
+	if (!s.IsNotFound()) {
+	  return s;
+	}
+	value->Reset();
+      }
+    }
+  }
+  return db->Get(rocksdb::ReadOptions(), cf, key, value);
+}
+
 /**
  * Definition of sharding:
  * space-separated list of: column_def [ '=' options ]
@@ -1025,7 +1097,9 @@ int RocksDBStore::verify_sharding(const rocksdb::Options& opt,
 				  std::vector<rocksdb::ColumnFamilyDescriptor>& existing_cfs,
 				  std::vector<std::pair<size_t, RocksDBStore::ColumnFamily> >& existing_cfs_shard,
 				  std::vector<rocksdb::ColumnFamilyDescriptor>& missing_cfs,
-				  std::vector<std::pair<size_t, RocksDBStore::ColumnFamily> >& missing_cfs_shard)
+				  std::vector<std::pair<size_t, RocksDBStore::ColumnFamily> >& missing_cfs_shard,
+				  std::string* online_target,
+				  std::vector<rocksdb::ColumnFamilyDescriptor>& online_cfs)
 {
   rocksdb::Status status;
   std::string stored_sharding_text;
@@ -1089,7 +1163,44 @@ int RocksDBStore::verify_sharding(const rocksdb::Options& opt,
   }
   existing_cfs.emplace_back("default", opt);
 
- if (existing_cfs.size() != rocksdb_cfs.size()) {
+  // an online reshard adds the columns of the target sharding, and leaves
+  // the dropped columns behind if it was interrupted while finishing
+  online_target->clear();
+  if (opt.env->FileExists(sharding_online_file).ok()) {
+    status = rocksdb::ReadFileToString(opt.env,
+				       sharding_online_file,
+				       online_target);
+    if (!status.ok()) {
+      derr << __func__ << " cannot read from " << sharding_online_file << dendl;
+      return -EIO;
+    }
+    dout(1) << __func__ << " online reshard to " << *online_target << dendl;
+    std::vector<ColumnFamily> target_def;
+    parse_sharding_def(*online_target, target_def);
+    bool finishing = *online_target == stored_sharding_text;
+    for (auto& name : rocksdb_cfs) {
+      if (std::find_if(existing_cfs.begin(), existing_cfs.end(),
+		       [&](const rocksdb::ColumnFamilyDescriptor& c) {
+			 return c.name == name; }) != existing_cfs.end()) {
+	continue;
+      }
+      auto column = std::find_if(target_def.begin(), target_def.end(),
+				 [&](const ColumnFamily& c) {
+				   return name.substr(0, name.find('-')) == c.name; });
+      if (finishing || column == target_def.end()) {
+	online_cfs.emplace_back(name, opt);
+	continue;
+      }
+      rocksdb::ColumnFamilyOptions cf_opt(opt);
+      int r = update_column_family_options(column->name, column->options, &cf_opt);
+      if (r != 0) {
+	return r;
+      }
+      online_cfs.emplace_back(name, cf_opt);
+    }
+  }
+
+ if (existing_cfs.size() + online_cfs.size() != rocksdb_cfs.size()) {
    std::vector<std::string> columns_from_stored;
    sharding_def_to_columns(stored_sharding_def, columns_from_stored);
    derr << __func__ << " extra columns in rocksdb. rocksdb columns = " << rocksdb_cfs
@@ -1146,10 +1257,13 @@ int RocksDBStore::do_open(ostream &out,
     std::vector<std::pair<size_t, RocksDBStore::ColumnFamily> > existing_cfs_shard;
     std::vector<rocksdb::ColumnFamilyDescriptor> missing_cfs;
     std::vector<std::pair<size_t, RocksDBStore::ColumnFamily> > missing_cfs_shard;
+    std::string online_target;
+    std::vector<rocksdb::ColumnFamilyDescriptor> online_cfs;
 
     r = verify_sharding(opt,
 			existing_cfs, existing_cfs_shard,
-			missing_cfs, missing_cfs_shard);
+			missing_cfs, missing_cfs_shard,
+			&online_target, online_cfs);
     if (r < 0) {
       return r;
     }
@@ -1187,20 +1301,22 @@ int RocksDBStore::do_open(ostream &out,
       default_cf = db->DefaultColumnFamily();
     } else {
       std::vector<rocksdb::ColumnFamilyHandle*> handles;
+      std::vector<rocksdb::ColumnFamilyDescriptor> open_cfs(existing_cfs);
+      open_cfs.insert(open_cfs.end(), online_cfs.begin(), online_cfs.end());
       if (open_readonly) {
         status = rocksdb::DB::OpenForReadOnly(rocksdb::DBOptions(opt),
-				              path, existing_cfs,
+				              path, open_cfs,
 					      &handles, &db);
       } else {
         status = rocksdb::DB::Open(rocksdb::DBOptions(opt),
-				   path, existing_cfs, &handles, &db);
+				   path, open_cfs, &handles, &db);
       }
       if (!status.ok()) {
 	derr << status.ToString() << dendl;
 	return -EINVAL;
       }
       ceph_assert(existing_cfs.size() == existing_cfs_shard.size() + 1);
-      ceph_assert(handles.size() == existing_cfs.size());
+      ceph_assert(handles.size() == open_cfs.size());
       dout(10) << __func__ << " existing_cfs=" << existing_cfs.size() << dendl;
       for (size_t i = 0; i < existing_cfs_shard.size(); i++) {
 	add_column_family(existing_cfs_shard[i].second.name,
@@ -1209,8 +1325,12 @@ int RocksDBStore::do_open(ostream &out,
 			  existing_cfs_shard[i].first,
 			  handles[i]);
       }
-      default_cf = handles[handles.size() - 1];
+      default_cf = handles[existing_cfs.size() - 1];
       must_close_default_cf = true;
+      std::map<std::string, rocksdb::ColumnFamilyHandle*> online_handles;
+      for (size_t i = 0; i < online_cfs.size(); i++) {
+	online_handles[online_cfs[i].name] = handles[existing_cfs.size() + i];
+      }
 
       if (missing_cfs.size() > 0 &&
 	  std::find_if(missing_cfs.begin(), missing_cfs.end(),
@@ -1236,6 +1356,13 @@ int RocksDBStore::do_open(ostream &out,
 	}
 	opt.env->DeleteFile(sharding_recreate);
       }
+      if (!online_target.empty()) {
+	r = _online_reshard_apply(opt, online_target, online_handles,
+				  open_readonly);
+	if (r < 0) {
+	  return r;
+	}
+      }
     }
   }
   ceph_assert(default_cf != nullptr);
@@ -1257,6 +1384,11 @@ int RocksDBStore::do_open(ostream &out,
       "rocksdb_write_pre_and_post_time", "total time spent on writing a record, excluding write process");
   logger = plb.create_perf_counters();
   cct->get_perfcounters_collection()->add(logger);
+  prefix_stats_sample = cct->_conf.get_val<uint64_t>("rocksdb_perf_prefix_sample");
+  if (!reshard_from.empty() && !open_readonly) {
+    online_reshard_stop = false;
+    online_reshard_thread.create("rocksdb_reshard");
+  }
 
   if (compact_on_mount) {
     derr << "Compacting rocksdb store..." << dendl;
@@ -1266,6 +1398,76 @@ int RocksDBStore::do_open(ostream &out,
   return 0;
 }
 
+PerfCounters* RocksDBStore::_get_prefix_logger(const std::string& prefix)
+{
+  std::lock_guard l(prefix_loggers_lock);
+  auto& pl = prefix_loggers[prefix];
+  if (pl) {
+    return pl;
+  }
+  // Latency axis configuration for histograms, values are in nanoseconds
+  PerfHistogramCommon::axis_config_d lat_axis_config{
+    "Latency (usec)",
+    PerfHistogramCommon::SCALE_LOG2, ///< Latency in logarithmic scale
+    0,                               ///< Start at 0
+    10000,                           ///< Quantization unit is 10usec
+    24,                              ///< Up to minutes
+  };
+  // Size axis configuration for histograms, values are in bytes
+  PerfHistogramCommon::axis_config_d bytes_axis_config{
+    "Size (bytes)",
+    PerfHistogramCommon::SCALE_LOG2, ///< Size in logarithmic scale
+    0,                               ///< Start at 0
+    64,                              ///< Quantization unit is 64 bytes
+    24,                              ///< Up to GBs
+  };
+  PerfCountersBuilder plb(cct, "rocksdb-prefix-" + prefix,
+			  l_rocksdb_prefix_first, l_rocksdb_prefix_last);
+  plb.add_time_avg(l_rocksdb_prefix_get_lat, "get_latency",
+		   "Sampled get latency", nullptr,
+		   PerfCountersBuilder::PRIO_USEFUL);
+  plb.add_u64_counter(l_rocksdb_prefix_get_bytes, "get_bytes",
+		      "Sampled get value bytes", nullptr,
+		      PerfCountersBuilder::PRIO_USEFUL, unit_t(UNIT_BYTES));
+  plb.add_u64_counter_histogram(
+    l_rocksdb_prefix_get_lat_bytes_hist, "get_latency_bytes_histogram",
+    lat_axis_config, bytes_axis_config,
+    "Histogram of sampled get latency vs. value size");
+  plb.add_time_avg(l_rocksdb_prefix_iterate_lat, "iterate_latency",
+		   "Sampled time spent positioning an iterator, per iterator",
+		   nullptr, PerfCountersBuilder::PRIO_USEFUL);
+  plb.add_u64_counter(l_rocksdb_prefix_iterate_keys, "iterate_keys",
+		      "Keys visited by sampled iterators", nullptr,
+		      PerfCountersBuilder::PRIO_USEFUL);
+  plb.add_u64_counter_histogram(
+    l_rocksdb_prefix_iterate_lat_bytes_hist, "iterate_latency_bytes_histogram",
+    lat_axis_config, bytes_axis_config,
+    "Histogram of sampled iterator latency vs. bytes visited");
+  plb.add_time_avg(l_rocksdb_prefix_submit_lat, "submit_latency",
+		   "Sampled latency of transactions touching the prefix",
+		   nullptr, PerfCountersBuilder::PRIO_USEFUL);
+  plb.add_u64_counter(l_rocksdb_prefix_submit_bytes, "submit_bytes",
+		      "Sampled bytes written to the prefix", nullptr,
+		      PerfCountersBuilder::PRIO_USEFUL, unit_t(UNIT_BYTES));
+  plb.add_u64_counter_histogram(
+    l_rocksdb_prefix_submit_lat_bytes_hist, "submit_latency_bytes_histogram",
+    lat_axis_config, bytes_axis_config,
+    "Histogram of sampled transaction latency vs. bytes written to the prefix");
+  pl = plb.create_perf_counters();
+  cct->get_perfcounters_collection()->add(pl);
+  return pl;
+}
+
+void RocksDBStore::_shutdown_prefix_loggers()
+{
+  std::lock_guard l(prefix_loggers_lock);
+  for (auto& [prefix, pl] : prefix_loggers) {
+    cct->get_perfcounters_collection()->remove(pl);
+    delete pl;
+  }
+  prefix_loggers.clear();
+}
+
 int RocksDBStore::_test_init(const string& dir)
 {
   rocksdb::Options options;
@@ -1299,14 +1501,31 @@ void RocksDBStore::close()
   } else {
     compact_queue_lock.unlock();
   }
+  _online_reshard_stop();
 
   if (logger) {
     cct->get_perfcounters_collection()->remove(logger);
     delete logger;
     logger = nullptr;
   }
+  _shutdown_prefix_loggers();
 
   // Ensure db is destroyed before dependent db_cache and filterpolicy
+  for (auto& [prefix, from] : reshard_from) {
+    auto& to = cf_handles[prefix].handles;
+    for (auto h : from.handles) {
+      if (std::find(to.begin(), to.end(), h) == to.end()) {
+	db->DestroyColumnFamilyHandle(h);
+      }
+    }
+  }
+  reshard_from.clear();
+  for (auto h : retired_cf_handles) {
+    db->DestroyColumnFamilyHandle(h);
+  }
+  retired_cf_handles.clear();
+  online_reshard_active = false;
+  online_reshard_target.clear();
   for (auto& p : cf_handles) {
     for (size_t i = 0; i < p.second.handles.size(); i++) {
       db->DestroyColumnFamilyHandle(p.second.handles[i]);
@@ -1564,6 +1783,160 @@ struct RocksDBStore::RocksWBHandler: public rocksdb::WriteBatch::Handler {
   bool Continue() override { return num_seen < 50; }
 };
 
+// sums up the bytes a batch writes per prefix
+struct RocksDBStore::PrefixStatsHandler: public rocksdb::WriteBatch::Handler {
+  PrefixStatsHandler(const RocksDBStore& db) : db(db) {}
+  const RocksDBStore& db;
+  std::map<std::string, uint64_t> bytes;
+
+  void account(uint32_t column_family_id,
+	       const rocksdb::Slice& key,
+	       const rocksdb::Slice* value = nullptr) {
+    uint64_t len = key.size() + (value ? value->size() : 0);
+    if (column_family_id == 0) {
+      string prefix;
+      db.split_key(key, &prefix, nullptr);
+      bytes[prefix] += len;
+    } else if (auto it = db.cf_ids_to_prefix.find(column_family_id);
+	       it != db.cf_ids_to_prefix.end()) {
+      bytes[it->second] += len;
+    }
+  }
+  rocksdb::Status PutCF(uint32_t column_family_id, const rocksdb::Slice& key,
+			const rocksdb::Slice& value) override {
+    account(column_family_id, key, &value);
+    return rocksdb::Status::OK();
+  }
+  rocksdb::Status SingleDeleteCF(uint32_t column_family_id,
+				 const rocksdb::Slice& key) override {
+    account(column_family_id, key);
+    return rocksdb::Status::OK();
+  }
+  rocksdb::Status DeleteCF(uint32_t column_family_id,
+			   const rocksdb::Slice& key) override {
+    account(column_family_id, key);
+    return rocksdb::Status::OK();
+  }
+  rocksdb::Status DeleteRangeCF(uint32_t column_family_id,
+				const rocksdb::Slice& begin_key,
+				const rocksdb::Slice& end_key) override {
+    account(column_family_id, begin_key);
+    return rocksdb::Status::OK();
+  }
+  rocksdb::Status MergeCF(uint32_t column_family_id, const rocksdb::Slice& key,
+			  const rocksdb::Slice& value) override {
+    account(column_family_id, key, &value);
+    return rocksdb::Status::OK();
+  }
+};
+
+// re-routes a batch to the current layout, and removes keys from the
+// layout they are moving away from; layout_lock is held shared
+struct RocksDBStore::OnlineReshardHandler: public rocksdb::WriteBatch::Handler {
+  OnlineReshardHandler(RocksDBStore& db) : db(db) {}
+  RocksDBStore& db;
+  rocksdb::WriteBatch bat;
+
+  const std::string& get_prefix(uint32_t column_family_id) {
+    auto it = db.cf_ids_to_prefix.find(column_family_id);
+    ceph_assert(it != db.cf_ids_to_prefix.end());
+    return it->second;
+  }
+  /// column family the key moves away from, if any
+  rocksdb::ColumnFamilyHandle* get_from_cf(const std::string& prefix,
+					   const rocksdb::Slice& key,
+					   rocksdb::ColumnFamilyHandle* to) {
+    auto p = db.reshard_from.find(prefix);
+    if (p == db.reshard_from.end()) {
+      return nullptr;
+    }
+    auto from = db.get_key_cf(p->second, key.data(), key.size());
+    return from == to ? nullptr : from;
+  }
+  rocksdb::Status PutCF(uint32_t column_family_id, const rocksdb::Slice& key,
+			const rocksdb::Slice& value) override {
+    if (column_family_id == 0) {
+      bat.Put(db.default_cf, key, value);
+      return rocksdb::Status::OK();
+    }
+    auto& prefix = get_prefix(column_family_id);
+    auto to = db.get_cf_handle(prefix, key.data(), key.size());
+    bat.Put(to, key, value);
+    if (auto from = get_from_cf(prefix, key, to); from) {
+      bat.Delete(from, key);
+    }
+    return rocksdb::Status::OK();
+  }
+  rocksdb::Status DeleteCF(uint32_t column_family_id,
+			   const rocksdb::Slice& key) override {
+    if (column_family_id == 0) {
+      bat.Delete(db.default_cf, key);
+      return rocksdb::Status::OK();
+    }
+    auto& prefix = get_prefix(column_family_id);
+    auto to = db.get_cf_handle(prefix, key.data(), key.size());
+    bat.Delete(to, key);
+    if (auto from = get_from_cf(prefix, key, to); from) {
+      bat.Delete(from, key);
+    }
+    return rocksdb::Status::OK();
+  }
+  rocksdb::Status SingleDeleteCF(uint32_t column_family_id,
+				 const rocksdb::Slice& key) override {
+    if (column_family_id == 0) {
+      bat.SingleDelete(db.default_cf, key);
+      return rocksdb::Status::OK();
+    }
+    // a moved key may have been put more than once in its new column
+    return DeleteCF(column_family_id, key);
+  }
+  rocksdb::Status MergeCF(uint32_t column_family_id, const rocksdb::Slice& key,
+			  const rocksdb::Slice& value) override {
+    if (column_family_id == 0) {
+      bat.Merge(db.default_cf, key, value);
+      return rocksdb::Status::OK();
+    }
+    // prefixes with merge operators are never resharded online
+    auto& prefix = get_prefix(column_family_id);
+    bat.Merge(db.get_cf_handle(prefix, key.data(), key.size()), key, value);
+    return rocksdb::Status::OK();
+  }
+  rocksdb::Status DeleteRangeCF(uint32_t column_family_id,
+				const rocksdb::Slice& begin_key,
+				const rocksdb::Slice& end_key) override {
+    if (column_family_id == 0) {
+      bat.DeleteRange(db.default_cf, begin_key, end_key);
+      return rocksdb::Status::OK();
+    }
+    auto& prefix = get_prefix(column_family_id);
+    auto& to = db.cf_handles.at(prefix).handles;
+    for (auto cf : to) {
+      bat.DeleteRange(cf, begin_key, end_key);
+    }
+    if (auto p = db.reshard_from.find(prefix); p != db.reshard_from.end()) {
+      for (auto cf : p->second.handles) {
+	if (std::find(to.begin(), to.end(), cf) == to.end()) {
+	  bat.DeleteRange(cf, begin_key, end_key);
+	}
+      }
+    }
+    return rocksdb::Status::OK();
+  }
+};
+
+void RocksDBStore::_record_submit_prefix_stats(const rocksdb::WriteBatch& bat,
+					       utime_t lat)
+{
+  PrefixStatsHandler h(*this);
+  bat.Iterate(&h);
+  for (auto& [prefix, bytes] : h.bytes) {
+    PerfCounters* pl = _get_prefix_logger(prefix);
+    pl->tinc(l_rocksdb_prefix_submit_lat, lat);
+    pl->inc(l_rocksdb_prefix_submit_bytes, bytes);
+    pl->hinc(l_rocksdb_prefix_submit_lat_bytes_hist, lat.to_nsec(), bytes);
+  }
+}
+
 int RocksDBStore::submit_common(rocksdb::WriteOptions& woptions, KeyValueDB::Transaction t) 
 {
   // enable rocksdb breakdown
@@ -1576,6 +1949,17 @@ int RocksDBStore::submit_common(rocksdb::WriteOptions& woptions, KeyValueDB::Tra
   RocksDBTransactionImpl * _t =
     static_cast<RocksDBTransactionImpl *>(t.get());
   woptions.disableWAL = disableWAL;
+  std::shared_lock<ceph::shared_mutex> layout_l;
+  if (online_reshard_active) {
+    layout_l = std::shared_lock(layout_lock);
+    if (!reshard_from.empty() || _t->layout_epoch != layout_epoch) {
+      OnlineReshardHandler h(*this);
+      rocksdb::Status s = _t->bat.Iterate(&h);
+      ceph_assert(s.ok());
+      _t->bat = std::move(h.bat);
+      _t->layout_epoch = layout_epoch;
+    }
+  }
   lgeneric_subdout(cct, rocksdb, 30) << __func__;
   RocksWBHandler bat_txc(*this);
   _t->bat.Iterate(&bat_txc);
@@ -1621,6 +2005,10 @@ int RocksDBStore::submit_transaction(KeyValueDB::Transaction t)
 
   utime_t lat = ceph_clock_now() - start;
   logger->tinc(l_rocksdb_submit_latency, lat);
+  if (static_cast<RocksDBTransactionImpl *>(t.get())->sampled) {
+    _record_submit_prefix_stats(
+      static_cast<RocksDBTransactionImpl *>(t.get())->bat, lat);
+  }
   
   return result;
 }
@@ -1636,6 +2024,10 @@ int RocksDBStore::submit_transaction_sync(KeyValueDB::Transaction t)
   
   utime_t lat = ceph_clock_now() - start;
   logger->tinc(l_rocksdb_submit_sync_latency, lat);
+  if (static_cast<RocksDBTransactionImpl *>(t.get())->sampled) {
+    _record_submit_prefix_stats(
+      static_cast<RocksDBTransactionImpl *>(t.get())->bat, lat);
+  }
 
   return result;
 }
@@ -1643,6 +2035,8 @@ int RocksDBStore::submit_transaction_sync(KeyValueDB::Transaction t)
 RocksDBStore::RocksDBTransactionImpl::RocksDBTransactionImpl(RocksDBStore *_db)
 {
   db = _db;
+  sampled = db->_sample_prefix_stats();
+  layout_epoch = db->layout_epoch;
 }
 
 void RocksDBStore::RocksDBTransactionImpl::put_bat(
@@ -1754,7 +2148,7 @@ void RocksDBStore::RocksDBTransactionImpl::rmkeys_by_prefix(const string &prefix
     }
   } else {
     ceph_assert(p_iter->second.handles.size() >= 1);
-    for (auto cf : p_iter->second.handles) {
+    for (auto cf : db->get_prefix_handles(p_iter)) {
       uint64_t cnt = db->get_delete_range_threshold();
       bat.SetSavePoint();
       auto it = db->new_shard_iterator(cf);
@@ -1806,7 +2200,7 @@ void RocksDBStore::RocksDBTransactionImpl::rm_range_keys(const string &prefix,
     }
   } else if (cnt == 0) {
     ceph_assert(p_iter->second.handles.size() >= 1);
-    for (auto cf : p_iter->second.handles) {
+    for (auto cf : db->get_prefix_handles(p_iter)) {
       ldout(db->cct, 10) << __func__ << " p_iter != end(), resorting to DeleteRange"
 			   << dendl;
 	bat.DeleteRange(cf, rocksdb::Slice(start), rocksdb::Slice(end));
@@ -1816,7 +2210,7 @@ void RocksDBStore::RocksDBTransactionImpl::rm_range_keys(const string &prefix,
     bounds.lower_bound = start;
     bounds.upper_bound = end;
     ceph_assert(p_iter->second.handles.size() >= 1);
-    for (auto cf : p_iter->second.handles) {
+    for (auto cf : db->get_prefix_handles(p_iter)) {
       cnt = db->get_delete_range_threshold();
       uint64_t cnt0 = cnt;
       bat.SetSavePoint();
@@ -1892,7 +2286,7 @@ int RocksDBStore::get(
   if (cf_handles.count(prefix) > 0) {
     for (auto& key : keys) {
       auto cf_handle = get_cf_handle(prefix, key);
-      auto status = db->Get(rocksdb::ReadOptions(),
+      auto status = _get_cf(prefix,
 			    cf_handle,
 			    rocksdb::Slice(key),
 			    &value);
@@ -1920,6 +2314,16 @@ int RocksDBStore::get(
   }
   utime_t lat = ceph_clock_now() - start;
   logger->tinc(l_rocksdb_get_latency, lat);
+  if (_sample_prefix_stats()) {
+    uint64_t bytes = 0;
+    for (auto& [k, v] : *out) {
+      bytes += v.length();
+    }
+    PerfCounters* pl = _get_prefix_logger(prefix);
+    pl->tinc(l_rocksdb_prefix_get_lat, lat);
+    pl->inc(l_rocksdb_prefix_get_bytes, bytes);
+    pl->hinc(l_rocksdb_prefix_get_lat_bytes_hist, lat.to_nsec(), bytes);
+  }
   return 0;
 }
 
@@ -1935,7 +2339,7 @@ int RocksDBStore::get(
   rocksdb::Status s;
   auto cf = get_cf_handle(prefix, key);
   if (cf) {
-    s = db->Get(rocksdb::ReadOptions(),
+    s = _get_cf(prefix,
 		cf,
 		rocksdb::Slice(key),
 		&value);
@@ -1955,6 +2359,13 @@ int RocksDBStore::get(
   }
   utime_t lat = ceph_clock_now() - start;
   logger->tinc(l_rocksdb_get_latency, lat);
+  if (_sample_prefix_stats()) {
+    PerfCounters* pl = _get_prefix_logger(prefix);
+    pl->tinc(l_rocksdb_prefix_get_lat, lat);
+    pl->inc(l_rocksdb_prefix_get_bytes, out->length());
+    pl->hinc(l_rocksdb_prefix_get_lat_bytes_hist, lat.to_nsec(),
+	     out->length());
+  }
   return r;
 }
 
@@ -1971,7 +2382,7 @@ int RocksDBStore::get(
   rocksdb::Status s;
   auto cf = get_cf_handle(prefix, key, keylen);
   if (cf) {
-    s = db->Get(rocksdb::ReadOptions(),
+    s = _get_cf(prefix,
 		cf,
 		rocksdb::Slice(key, keylen),
 		&value);
@@ -1992,6 +2403,13 @@ int RocksDBStore::get(
   }
   utime_t lat = ceph_clock_now() - start;
   logger->tinc(l_rocksdb_get_latency, lat);
+  if (_sample_prefix_stats()) {
+    PerfCounters* pl = _get_prefix_logger(prefix);
+    pl->tinc(l_rocksdb_prefix_get_lat, lat);
+    pl->inc(l_rocksdb_prefix_get_bytes, out->length());
+    pl->hinc(l_rocksdb_prefix_get_lat_bytes_hist, lat.to_nsec(),
+	     out->length());
+  }
   return r;
 }
 
@@ -2041,13 +2459,32 @@ void RocksDBStore::compact()
   dout(2) << __func__ << " starting" << dendl;
   logger->inc(l_rocksdb_compact);
   rocksdb::CompactRangeOptions options;
-  db->CompactRange(options, default_cf, nullptr, nullptr);
+  std::vector<rocksdb::ColumnFamilyHandle*> handles{default_cf};
   for (auto cf : cf_handles) {
     for (auto shard_cf : cf.second.handles) {
-      db->CompactRange(
-	options,
-	shard_cf,
-	nullptr, nullptr);
+      handles.push_back(shard_cf);
+    }
+  }
+  auto nthreads = std::min<size_t>(
+    cct->_conf.get_val<uint64_t>("rocksdb_compact_threads"), handles.size());
+  if (nthreads <= 1) {
+    for (auto h : handles) {
+      db->CompactRange(options, h, nullptr, nullptr);
+    }
+  } else {
+    // independent column families; don't serialize them behind each other
+    options.exclusive_manual_compaction = false;
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nthreads; ++i) {
+      threads.emplace_back([&] {
+	for (size_t n = next++; n < handles.size(); n = next++) {
+	  db->CompactRange(options, handles[n], nullptr, nullptr);
+	}
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
     }
   }
   dout(2) << __func__ << " completed" << dendl;
@@ -2338,12 +2775,15 @@ public:
   explicit CFIteratorImpl(const RocksDBStore* db,
                           const std::string& p,
                           rocksdb::ColumnFamilyHandle* cf,
-                          KeyValueDB::IteratorBounds bounds_)
+                          KeyValueDB::IteratorBounds bounds_,
+                          KeyValueDB::IteratorOpts opts = 0)
     : prefix(p), bounds(std::move(bounds_)),
       iterate_lower_bound(make_slice(bounds.lower_bound)),
       iterate_upper_bound(make_slice(bounds.upper_bound))
       {
       auto options = rocksdb::ReadOptions();
+      // block cache filling stays as is for column family iterators
+      db->apply_iterator_opts(opts & KeyValueDB::ITERATOR_PREFETCH, &options);
       if (db->cct->_conf->osd_rocksdb_iterator_bounds_enabled) {
         if (bounds.lower_bound) {
           options.iterate_lower_bound = &iterate_lower_bound;
@@ -2930,13 +3370,16 @@ public:
   explicit ShardMergeIteratorImpl(const RocksDBStore* db,
 				  const std::string& prefix,
 				  const std::vector<rocksdb::ColumnFamilyHandle*>& shards,
-                  KeyValueDB::IteratorBounds bounds_)
+                  KeyValueDB::IteratorBounds bounds_,
+                  KeyValueDB::IteratorOpts opts = 0)
     : db(db), keyless(db->comparator), prefix(prefix), bounds(std::move(bounds_)),
       iterate_lower_bound(make_slice(bounds.lower_bound)),
       iterate_upper_bound(make_slice(bounds.upper_bound))
   {
     iters.reserve(shards.size());
     auto options = rocksdb::ReadOptions();
+    // block cache filling stays as is for column family iterators
+    db->apply_iterator_opts(opts & KeyValueDB::ITERATOR_PREFETCH, &options);
     if (db->cct->_conf->osd_rocksdb_iterator_bounds_enabled) {
       if (bounds.lower_bound) {
         options.iterate_lower_bound = &iterate_lower_bound;
@@ -2945,9 +3388,10 @@ public:
         options.iterate_upper_bound = &iterate_upper_bound;
       }
     }
-    for (auto& s : shards) {
-      iters.push_back(db->db->NewIterator(options, s));
-    }
+    // one consistent view over all shards, so keys moved between shards
+    // by an online reshard are seen exactly once
+    auto status = db->db->NewIterators(options, shards, &iters);
+    ceph_assert(status.ok());
   }
   ~ShardMergeIteratorImpl() {
     for (auto& it : iters) {
@@ -3127,12 +3571,114 @@ public:
   }
 };
 
+// Times the positioning calls of a sampled iterator and records them,
+// together with the amount of data visited, once the iterator goes away.
+class SampledIteratorImpl : public KeyValueDB::IteratorImpl {
+  PerfCounters *pl;
+  KeyValueDB::Iterator it;
+  ceph::timespan lat = ceph::timespan::zero();
+  uint64_t keys = 0;
+  uint64_t bytes = 0;
+
+  template <typename F>
+  int timed(F&& f) {
+    auto start = ceph::mono_clock::now();
+    int r = f();
+    lat += ceph::mono_clock::now() - start;
+    if (it->valid()) {
+      ++keys;
+      bytes += it->key_as_sv().size() + it->value_as_sv().size();
+    }
+    return r;
+  }
+public:
+  SampledIteratorImpl(PerfCounters *pl, KeyValueDB::Iterator it)
+    : pl(pl), it(std::move(it)) {}
+  ~SampledIteratorImpl() override {
+    pl->tinc(l_rocksdb_prefix_iterate_lat, lat);
+    pl->inc(l_rocksdb_prefix_iterate_keys, keys);
+    pl->hinc(l_rocksdb_prefix_iterate_lat_bytes_hist,
+	     std::chrono::nanoseconds(lat).count(), bytes);
+  }
+
+  int seek_to_first() override {
+    return timed([this] { return it->seek_to_first(); });
+  }
+  int seek_to_last() override {
+    return timed([this] { return it->seek_to_last(); });
+  }
+  int upper_bound(const string &after) override {
+    return timed([&] { return it->upper_bound(after); });
+  }
+  int lower_bound(const string &to) override {
+    return timed([&] { return it->lower_bound(to); });
+  }
+  int next() override {
+    return timed([this] { return it->next(); });
+  }
+  int prev() override {
+    return timed([this] { return it->prev(); });
+  }
+  int next_batch(size_t max_entries, size_t max_bytes,
+		 KeyValueDB::KVBatch* out) override {
+    auto start = ceph::mono_clock::now();
+    int r = it->next_batch(max_entries, max_bytes, out);
+    lat += ceph::mono_clock::now() - start;
+    keys += out->size();
+    for (auto& [k, v] : out->entries) {
+      bytes += k.length() + v.length();
+    }
+    return r;
+  }
+  bool valid() override {
+    return it->valid();
+  }
+  string key() override {
+    return it->key();
+  }
+  string_view key_as_sv() override {
+    return it->key_as_sv();
+  }
+  std::pair<std::string, std::string> raw_key() override {
+    return it->raw_key();
+  }
+  std::pair<std::string_view, std::string_view> raw_key_as_sv() override {
+    return it->raw_key_as_sv();
+  }
+  bufferlist value() override {
+    return it->value();
+  }
+  bufferptr value_as_ptr() override {
+    return it->value_as_ptr();
+  }
+  std::string_view value_as_sv() override {
+    return it->value_as_sv();
+  }
+  int status() override {
+    return it->status();
+  }
+};
+
 KeyValueDB::Iterator RocksDBStore::get_iterator(const std::string& prefix, IteratorOpts opts, IteratorBounds bounds)
+{
+  auto it = _get_iterator(prefix, opts, std::move(bounds));
+  if (_sample_prefix_stats()) {
+    return std::make_shared<SampledIteratorImpl>(_get_prefix_logger(prefix),
+						 std::move(it));
+  }
+  return it;
+}
+
+KeyValueDB::Iterator RocksDBStore::_get_iterator(const std::string& prefix, IteratorOpts opts, IteratorBounds bounds)
 {
   auto cf_it = cf_handles.find(prefix);
   if (cf_it != cf_handles.end()) {
     rocksdb::ColumnFamilyHandle* cf = nullptr;
-    if (cf_it->second.handles.size() == 1) {
+    bool moving = false;
+    auto shards = get_prefix_handles(cf_it, &moving);
+    if (moving) {
+      // keys may sit in either layout
+    } else if (cf_it->second.handles.size() == 1) {
       cf = cf_it->second.handles[0];
     } else if (cct->_conf->osd_rocksdb_iterator_bounds_enabled) {
       cf = check_cf_handle_bounds(cf_it, bounds);
@@ -3142,13 +3688,15 @@ KeyValueDB::Iterator RocksDBStore::get_iterator(const std::string& prefix, Itera
               this,
               prefix,
               cf,
-              std::move(bounds));
+              std::move(bounds),
+              opts);
     } else {
       return std::make_shared<ShardMergeIteratorImpl>(
         this,
         prefix,
-        cf_it->second.handles,
-        std::move(bounds));
+        shards,
+        std::move(bounds),
+        opts);
     }
   } else {
     // use wholespace engine if no cfs are configured
@@ -3220,6 +3768,13 @@ int RocksDBStore::prepare_for_reshard(const std::string& new_sharding,
     return -EINVAL;
   }
 
+  // the layout is in flux until an online reshard finished
+  if (env->FileExists(sharding_online_file).ok()) {
+    derr << __func__ << " online reshard in progress, open the db to let it finish"
+	 << dendl;
+    return -EBUSY;
+  }
+
   //0. lock db from opening
   std::string stored_sharding_text;
   rocksdb::ReadFileToString(env,
@@ -3590,6 +4145,346 @@ int RocksDBStore::reshard(const std::string& new_sharding, const RocksDBStore::r
   return r;
 }
 
+int RocksDBStore::reshard_online(const std::string& new_sharding, std::ostream& out)
+{
+  if (online_reshard_active) {
+    if (new_sharding == online_reshard_target) {
+      return 0;
+    }
+    out << "online reshard to '" << online_reshard_target << "' in progress";
+    return -EBUSY;
+  }
+  std::string stored_sharding_text;
+  get_sharding(stored_sharding_text);
+  if (new_sharding == stored_sharding_text) {
+    return 0;
+  }
+  std::vector<ColumnFamily> new_sharding_def;
+  char const* error_position;
+  std::string error_msg;
+  if (!parse_sharding_def(new_sharding, new_sharding_def, &error_position, &error_msg)) {
+    out << "bad sharding at position " << error_position - &new_sharding[0]
+	<< ": " << error_msg;
+    return -EINVAL;
+  }
+  if (new_sharding_def.size() != cf_handles.size()) {
+    out << "online reshard can't add or remove column families";
+    return -EINVAL;
+  }
+  for (auto& column : new_sharding_def) {
+    auto p = cf_handles.find(column.name);
+    if (p == cf_handles.end()) {
+      out << "column family " << column.name << " not in current sharding,"
+	  << " online reshard can't add or remove column families";
+      return -EINVAL;
+    }
+    if (p->second.handles.size() == column.shard_cnt &&
+	p->second.hash_l == column.hash_l &&
+	p->second.hash_h == column.hash_h) {
+      continue;
+    }
+    // merge operands of a key could end up split between two layouts
+    for (auto& [prefix, op] : merge_ops) {
+      if (prefix == column.name) {
+	out << "column family " << column.name << " has a merge operator,"
+	    << " it can only be resharded offline";
+	return -EINVAL;
+      }
+    }
+  }
+
+  // persist the target first, it is how the move resumes on next open
+  env->CreateDir(sharding_def_dir);
+  if (auto status = rocksdb::WriteStringToFile(env, new_sharding,
+					       sharding_online_file, true);
+      !status.ok()) {
+    out << "cannot write to " << sharding_online_file;
+    return -EIO;
+  }
+  int r = _online_reshard_apply(db->GetOptions(default_cf), new_sharding, {}, false);
+  if (r < 0) {
+    out << "failed to create column families: " << cpp_strerror(r);
+    return r;
+  }
+  dout(1) << __func__ << " resharding from " << stored_sharding_text
+	  << " to " << new_sharding << dendl;
+  if (!reshard_from.empty()) {
+    online_reshard_stop = false;
+    online_reshard_thread.create("rocksdb_reshard");
+  }
+  return 0;
+}
+
+bool RocksDBStore::is_online_resharding()
+{
+  std::shared_lock l(layout_lock);
+  return !reshard_from.empty();
+}
+
+int RocksDBStore::_online_reshard_apply(
+  const rocksdb::Options& opt,
+  const std::string& target_text,
+  const std::map<std::string, rocksdb::ColumnFamilyHandle*>& opened,
+  bool read_only)
+{
+  std::vector<ColumnFamily> target_def;
+  if (!parse_sharding_def(target_text, target_def)) {
+    derr << __func__ << " bad sharding: " << target_text << dendl;
+    return -EINVAL;
+  }
+  std::map<std::string, rocksdb::ColumnFamilyHandle*> handles(opened);
+  for (auto& [prefix, shards] : cf_handles) {
+    if (std::find_if(target_def.begin(), target_def.end(),
+		     [&](const ColumnFamily& c) { return c.name == prefix; }
+		     ) == target_def.end()) {
+      derr << __func__ << " column family " << prefix
+	   << " missing from target sharding " << target_text << dendl;
+      return -EINVAL;
+    }
+    for (auto h : shards.handles) {
+      handles[h->GetName()] = h;
+    }
+  }
+
+  std::set<rocksdb::ColumnFamilyHandle*> used;
+  std::map<std::string, prefix_shards> layouts;
+  for (auto& column : target_def) {
+    auto p = cf_handles.find(column.name);
+    if (p == cf_handles.end()) {
+      derr << __func__ << " column family " << column.name
+	   << " missing from current sharding" << dendl;
+      return -EINVAL;
+    }
+    auto& cur = p->second;
+    prefix_shards to{column.hash_l, column.hash_h, {}};
+    for (size_t idx = 0; idx < column.shard_cnt; idx++) {
+      std::string cf_name = column.shard_cnt == 1 ?
+	column.name : column.name + "-" + std::to_string(idx);
+      auto h = handles.find(cf_name);
+      if (h != handles.end()) {
+	to.handles.push_back(h->second);
+	continue;
+      }
+      if (read_only) {
+	// interrupted before the target existed, no key was moved yet
+	dout(1) << __func__ << " column " << cf_name << " not created yet,"
+		<< " ignoring online reshard" << dendl;
+	for (auto& [name, h] : opened) {
+	  retired_cf_handles.push_back(h);
+	}
+	return 0;
+      }
+      rocksdb::ColumnFamilyOptions cf_opt(opt);
+      int r = update_column_family_options(column.name, column.options, &cf_opt);
+      if (r != 0) {
+	return r;
+      }
+      rocksdb::ColumnFamilyHandle *cf;
+      auto status = db->CreateColumnFamily(cf_opt, cf_name, &cf);
+      if (!status.ok()) {
+	derr << __func__ << " Failed to create rocksdb column family: "
+	     << cf_name << dendl;
+	return -EINVAL;
+      }
+      handles[cf_name] = cf;
+      to.handles.push_back(cf);
+    }
+    used.insert(to.handles.begin(), to.handles.end());
+    if (to.hash_l != cur.hash_l || to.hash_h != cur.hash_h ||
+	to.handles != cur.handles) {
+      used.insert(cur.handles.begin(), cur.handles.end());
+      layouts.emplace(column.name, std::move(to));
+    }
+  }
+
+  // columns left behind by a finish which was interrupted, they are empty
+  for (auto& [name, h] : opened) {
+    if (used.count(h)) {
+      continue;
+    }
+    if (!read_only) {
+      std::unique_ptr<rocksdb::Iterator> it{
+	db->NewIterator(rocksdb::ReadOptions(), h)};
+      it->SeekToFirst();
+      ceph_assert(!it->Valid());
+      dout(5) << __func__ << " dropping column " << name << dendl;
+      if (auto status = db->DropColumnFamily(h); !status.ok()) {
+	derr << __func__ << " Failed to drop column: " << name << dendl;
+	return -EINVAL;
+      }
+    }
+    retired_cf_handles.push_back(h);
+  }
+  if (layouts.empty()) {
+    if (!read_only) {
+      env->DeleteFile(sharding_online_file);
+    }
+    return 0;
+  }
+
+  for (auto& [prefix, to] : layouts) {
+    dout(1) << __func__ << " column " << prefix << " moving to "
+	    << to.handles.size() << " shards" << dendl;
+    for (auto h : to.handles) {
+      cf_ids_to_prefix.emplace(h->GetID(), prefix);
+    }
+    auto& cur = cf_handles[prefix];
+    reshard_from[prefix] = std::move(cur);
+    cur = std::move(to);
+  }
+  online_reshard_active = true;
+  online_reshard_target = target_text;
+  ++layout_epoch;
+  return 0;
+}
+
+void RocksDBStore::online_reshard_thread_entry()
+{
+  std::vector<std::pair<std::string, rocksdb::ColumnFamilyHandle*>> to_process;
+  {
+    std::shared_lock l(layout_lock);
+    for (auto& [prefix, from] : reshard_from) {
+      for (auto h : from.handles) {
+	to_process.emplace_back(prefix, h);
+      }
+    }
+  }
+  dout(1) << __func__ << " processing " << to_process.size() << " columns" << dendl;
+  for (auto& [prefix, handle] : to_process) {
+    dout(5) << __func__ << " column " << handle->GetName() << dendl;
+    std::string resume;
+    bool done = false;
+    while (!done) {
+      size_t bytes = 0;
+      {
+	std::unique_lock l(layout_lock);
+	done = _online_reshard_move(prefix, handle, &resume, &bytes);
+      }
+      uint64_t rate = cct->_conf.get_val<Option::size_t>(
+	"rocksdb_online_reshard_bytes_per_sec");
+      std::unique_lock l(online_reshard_lock);
+      if (!online_reshard_stop && rate && bytes) {
+	online_reshard_cond.wait_for(
+	  l, std::chrono::microseconds(bytes * 1000000 / rate));
+      }
+      if (online_reshard_stop) {
+	dout(1) << __func__ << " stopped, continues on next open" << dendl;
+	return;
+      }
+    }
+  }
+  std::unique_lock l(layout_lock);
+  _online_reshard_finish();
+}
+
+bool RocksDBStore::_online_reshard_move(const std::string& prefix,
+					rocksdb::ColumnFamilyHandle* handle,
+					std::string* resume,
+					size_t* bytes)
+{
+  ceph_assert(ceph_mutex_is_wlocked(layout_lock));
+  const resharding_ctrl ctrl;
+  auto& to = cf_handles.at(prefix);
+  std::unique_ptr<rocksdb::Iterator> it{
+    db->NewIterator(rocksdb::ReadOptions(), handle)};
+  ceph_assert(it);
+  if (resume->empty()) {
+    it->SeekToFirst();
+  } else {
+    it->Seek(*resume);
+  }
+  rocksdb::WriteBatch bat;
+  size_t keys = 0;
+  for (size_t scanned = 0;
+       it->Valid() && scanned < ctrl.keys_per_iterator &&
+	 keys < ctrl.keys_per_batch && *bytes < ctrl.bytes_per_batch;
+       it->Next(), scanned++) {
+    rocksdb::Slice key = it->key();
+    auto new_handle = get_key_cf(to, key.data(), key.size());
+    if (new_handle == handle) {
+      continue;
+    }
+    bat.Delete(handle, key);
+    bat.Put(new_handle, key, it->value());
+    keys++;
+    *bytes += key.size() * 2 + it->value().size();
+  }
+  ceph_assert(it->status().ok());
+  bool done = !it->Valid();
+  if (!done) {
+    *resume = it->key().ToString();
+  }
+  if (bat.Count() > 0) {
+    rocksdb::WriteOptions woptions;
+    woptions.disableWAL = disableWAL;
+    rocksdb::Status s = db->Write(woptions, &bat);
+    ceph_assert(s.ok());
+  }
+  dout(20) << __func__ << " column " << handle->GetName() << " moved " << keys
+	   << " keys, " << *bytes << " bytes" << dendl;
+  return done;
+}
+
+int RocksDBStore::_online_reshard_finish()
+{
+  ceph_assert(ceph_mutex_is_wlocked(layout_lock));
+  std::set<rocksdb::ColumnFamilyHandle*> keep;
+  for (auto& [prefix, from] : reshard_from) {
+    auto& to = cf_handles.at(prefix);
+    keep.insert(to.handles.begin(), to.handles.end());
+  }
+  std::vector<rocksdb::ColumnFamilyHandle*> to_drop;
+  for (auto& [prefix, from] : reshard_from) {
+    for (auto h : from.handles) {
+      if (keep.count(h)) {
+	continue;
+      }
+      // verify that column is empty
+      std::unique_ptr<rocksdb::Iterator> it{
+	db->NewIterator(rocksdb::ReadOptions(), h)};
+      ceph_assert(it);
+      it->SeekToFirst();
+      ceph_assert(!it->Valid());
+      to_drop.push_back(h);
+    }
+  }
+  // from here on an interrupted finish is completed on next open
+  if (auto status = rocksdb::WriteStringToFile(env, online_reshard_target,
+					       sharding_def_file, true);
+      !status.ok()) {
+    derr << __func__ << " cannot write to " << sharding_def_file << dendl;
+    return -EIO;
+  }
+  for (auto h : to_drop) {
+    dout(5) << __func__ << " dropping column " << h->GetName() << dendl;
+    if (auto status = db->DropColumnFamily(h); !status.ok()) {
+      derr << __func__ << " Failed to drop column: " << h->GetName() << dendl;
+      return -EIO;
+    }
+  }
+  retired_cf_handles.insert(retired_cf_handles.end(),
+			    to_drop.begin(), to_drop.end());
+  reshard_from.clear();
+  env->DeleteFile(sharding_online_file);
+  ++layout_epoch;
+  dout(1) << __func__ << " sharding is now " << online_reshard_target << dendl;
+  return 0;
+}
+
+void RocksDBStore::_online_reshard_stop()
+{
+  if (!online_reshard_thread.is_started()) {
+    return;
+  }
+  dout(1) << __func__ << " waiting for online reshard thread to stop" << dendl;
+  {
+    std::lock_guard l(online_reshard_lock);
+    online_reshard_stop = true;
+    online_reshard_cond.notify_all();
+  }
+  online_reshard_thread.join();
+}
+
 bool RocksDBStore::get_sharding(std::string& sharding) {
   rocksdb::Status status;
   std::string stored_sharding_text;
@@ -10,6 +10,8 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <atomic>
+#include <shared_mutex>
 #include <boost/scoped_ptr.hpp>
 #include "rocksdb/write_batch.h"
 #include "rocksdb/perf_context.h"
@@ -47,6 +49,21 @@ enum {
   l_rocksdb_last,
 };
 
+// sampled per key prefix stats, one "rocksdb-prefix-<prefix>" logger each
+enum {
+  l_rocksdb_prefix_first = 34400,
+  l_rocksdb_prefix_get_lat,
+  l_rocksdb_prefix_get_bytes,
+  l_rocksdb_prefix_get_lat_bytes_hist,
+  l_rocksdb_prefix_iterate_lat,
+  l_rocksdb_prefix_iterate_keys,
+  l_rocksdb_prefix_iterate_lat_bytes_hist,
+  l_rocksdb_prefix_submit_lat,
+  l_rocksdb_prefix_submit_bytes,
+  l_rocksdb_prefix_submit_lat_bytes_hist,
+  l_rocksdb_prefix_last,
+};
+
 namespace rocksdb{
   class DB;
   class Env;
@@ -163,7 +180,9 @@ private:
 		      std::vector<rocksdb::ColumnFamilyDescriptor>& existing_cfs,
 		      std::vector<std::pair<size_t, RocksDBStore::ColumnFamily> >& existing_cfs_shard,
 		      std::vector<rocksdb::ColumnFamilyDescriptor>& missing_cfs,
-		      std::vector<std::pair<size_t, RocksDBStore::ColumnFamily> >& missing_cfs_shard);
+		      std::vector<std::pair<size_t, RocksDBStore::ColumnFamily> >& missing_cfs_shard,
+		      std::string* online_target,
+		      std::vector<rocksdb::ColumnFamilyDescriptor>& online_cfs);
   std::shared_ptr<rocksdb::Cache> create_block_cache(const std::string& cache_type, size_t cache_size, double cache_prio_high = 0.0);
   int split_column_family_options(const std::string& opts_str,
 				  std::unordered_map<std::string, std::string>* column_opts_map,
@@ -198,6 +217,73 @@ private:
   int tryInterpret(const std::string& key, const std::string& val,
 		   rocksdb::Options& opt);
 
+  // sampled per prefix stats
+  uint64_t prefix_stats_sample = 0; ///< sample one in N ops, 0 = off
+  ceph::mutex prefix_loggers_lock =
+    ceph::make_mutex("RocksDBStore::prefix_loggers_lock");
+  std::map<std::string, PerfCounters*> prefix_loggers;
+
+  bool _sample_prefix_stats() const {
+    static thread_local uint64_t n = 0;
+    return prefix_stats_sample && ++n % prefix_stats_sample == 0;
+  }
+  PerfCounters* _get_prefix_logger(const std::string& prefix);
+  void _shutdown_prefix_loggers();
+  void _record_submit_prefix_stats(const rocksdb::WriteBatch& bat,
+				   utime_t lat);
+
+  // online resharding
+  //
+  // Prefixes which change their layout point to the new layout in
+  // cf_handles while reshard_from keeps the previous one until all keys
+  // were moved. Reads check both, writes are re-routed at submit.
+  bool online_reshard_active = false; ///< only set on open, before the store is shared
+  std::string online_reshard_target;  ///< sharding being moved to
+  std::unordered_map<std::string, prefix_shards> reshard_from;
+  /// bumped on each layout change, transactions built against an older
+  /// layout are re-routed on submit
+  std::atomic<uint64_t> layout_epoch = {0};
+  /// held shared for layout lookups, exclusive by the mover
+  ceph::shared_mutex layout_lock =
+    ceph::make_shared_mutex("RocksDBStore::layout_lock");
+  /// handles of column families dropped by the mover, destroyed on close
+  std::vector<rocksdb::ColumnFamilyHandle *> retired_cf_handles;
+
+  ceph::mutex online_reshard_lock =
+    ceph::make_mutex("RocksDBStore::online_reshard_lock");
+  ceph::condition_variable online_reshard_cond;
+  bool online_reshard_stop = false;
+  class OnlineReshardThread : public Thread {
+    RocksDBStore *db;
+  public:
+    explicit OnlineReshardThread(RocksDBStore *d) : db(d) {}
+    void *entry() override {
+      db->online_reshard_thread_entry();
+      return NULL;
+    }
+  } online_reshard_thread;
+
+  void online_reshard_thread_entry();
+  int _online_reshard_apply(const rocksdb::Options& opt,
+			    const std::string& target_text,
+			    const std::map<std::string, rocksdb::ColumnFamilyHandle*>& opened,
+			    bool read_only);
+  bool _online_reshard_move(const std::string& prefix,
+			    rocksdb::ColumnFamilyHandle* handle,
+			    std::string* resume,
+			    size_t* bytes);
+  int _online_reshard_finish();
+  void _online_reshard_stop();
+  /// all handles which may hold keys of the prefix, sets *moving if the
+  /// prefix is being resharded
+  std::vector<rocksdb::ColumnFamilyHandle *> get_prefix_handles(
+    const cf_handles_iterator& iter, bool* moving = nullptr);
+  rocksdb::Status _get_cf(const std::string& prefix,
+			  rocksdb::ColumnFamilyHandle* cf,
+			  const rocksdb::Slice& key,
+			  rocksdb::PinnableSlice* value);
+  struct OnlineReshardHandler;
+
 public:
   /// compact the underlying rocksdb store
   bool compact_on_mount;
@@ -205,6 +291,17 @@ public:
   uint64_t get_delete_range_threshold() const {
     return cct->_conf.get_val<uint64_t>("rocksdb_delete_range_threshold");
   }
+  /// applies iterator hints to the read options of a new iterator
+  void apply_iterator_opts(IteratorOpts opts,
+			   rocksdb::ReadOptions* options) const {
+    if (opts & ITERATOR_NOCACHE) {
+      options->fill_cache = false;
+    }
+    if (opts & ITERATOR_PREFETCH) {
+      options->readahead_size =
+	cct->_conf.get_val<Option::size_t>("rocksdb_iterator_readahead_size");
+    }
+  }
 
   void compact() override;
 
@@ -249,6 +346,7 @@ public:
     dbstats(NULL),
     compact_queue_stop(false),
     compact_thread(this),
+    online_reshard_thread(this),
     compact_on_mount(false),
     disableWAL(false)
   {}
@@ -286,10 +384,13 @@ public:
   int64_t estimate_prefix_size(const std::string& prefix,
 			       const std::string& key_prefix) override;
   struct RocksWBHandler;
+  struct PrefixStatsHandler;
   class RocksDBTransactionImpl : public KeyValueDB::TransactionImpl {
   public:
     rocksdb::WriteBatch bat;
     RocksDBStore *db;
+    bool sampled = false; ///< record per prefix stats on submit
+    uint64_t layout_epoch; ///< layout the batch was routed with
 
     explicit RocksDBTransactionImpl(RocksDBStore *_db);
   private:
@@ -370,8 +471,7 @@ public:
                                            const KeyValueDB::IteratorOpts opts)
       {
         rocksdb::ReadOptions options = rocksdb::ReadOptions();
-        if (opts & ITERATOR_NOCACHE)
-          options.fill_cache=false;
+        db->apply_iterator_opts(opts, &options);
         dbiter = db->db->NewIterator(options, cf);
     }
     ~RocksDBWholeSpaceIteratorImpl() override;
@@ -400,6 +500,8 @@ public:
 
   Iterator get_iterator(const std::string& prefix, IteratorOpts opts = 0, IteratorBounds = IteratorBounds()) override;
 private:
+  Iterator _get_iterator(const std::string& prefix, IteratorOpts opts,
+			 IteratorBounds bounds);
   /// this iterator spans single cf
   WholeSpaceIterator new_shard_iterator(rocksdb::ColumnFamilyHandle* cf);
   Iterator new_shard_iterator(rocksdb::ColumnFamilyHandle* cf,
@@ -524,6 +626,16 @@ err:
         bbt_opts.block_cache);
   }
 
+  virtual std::shared_ptr<PriorityCache::PriCache>
+      get_compressed_priority_cache() const override {
+#if ROCKSDB_MAJOR < 8
+    return std::dynamic_pointer_cast<PriorityCache::PriCache>(
+        bbt_opts.block_cache_compressed);
+#else
+    return nullptr;
+#endif
+  }
+
   virtual std::shared_ptr<PriorityCache::PriCache>
       get_priority_cache(std::string prefix) const override {
     auto it = cf_bbt_opts.find(prefix);
@@ -556,6 +668,16 @@ public:
     bool   unittest_fail_after_successful_processing = false;
   };
   int reshard(const std::string& new_sharding, const resharding_ctrl* ctrl = nullptr);
+  /**
+   * Moves an open store to a new sharding in the background.
+   *
+   * Only changes of shard count or hash range of existing column families
+   * are supported, prefixes can't move to or from the default column
+   * family. Must be called right after open, before the store is used by
+   * other threads. Progress survives restarts, the move resumes on open.
+   */
+  int reshard_online(const std::string& new_sharding, std::ostream& out);
+  bool is_online_resharding();
   bool get_sharding(std::string& sharding);
 
 };
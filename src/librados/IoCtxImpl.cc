@@ -13,6 +13,7 @@
  */
 
 #include <limits.h>
+#include <optional>
 
 #include "IoCtxImpl.h"
 
@@ -2008,9 +2009,14 @@ void librados::IoCtxImpl::C_aio_Complete::finish(int r)
     }
   }
 
+  std::optional<CB_AioComplete> inline_cb;
   if (c->callback_complete ||
       c->callback_safe) {
-    boost::asio::defer(c->io->client->finish_strand, CB_AioComplete(c));
+    if (c->io->client->inline_aio_completions) {
+      inline_cb.emplace(c);
+    } else {
+      boost::asio::defer(c->io->client->finish_strand, CB_AioComplete(c));
+    }
   }
 
   if (c->aio_write_seq) {
@@ -2021,6 +2027,10 @@ void librados::IoCtxImpl::C_aio_Complete::finish(int r)
   OID_EVENT_TRACE(oid.name.c_str(), "RADOS_OP_COMPLETE");
 #endif
   c->put_unlock();
+  // the callbacks take c->lock themselves once they have run
+  if (inline_cb) {
+    (*inline_cb)();
+  }
 }
 
 void librados::IoCtxImpl::object_list_slice(
@@ -62,7 +62,9 @@ namespace cb = ceph::buffer;
 
 librados::RadosClient::RadosClient(CephContext *cct_)
   : Dispatcher(cct_->get()),
-    cct_deleter{cct, [](CephContext *p) {p->put();}}
+    cct_deleter{cct, [](CephContext *p) {p->put();}},
+    inline_aio_completions(
+      cct_->_conf.get_val<bool>("librados_inline_aio_completions"))
 {
   auto& conf = cct->_conf;
   conf.add_observer(this);
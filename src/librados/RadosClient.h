@@ -98,6 +98,8 @@ private:
 public:
   boost::asio::strand<boost::asio::io_context::executor_type>
       finish_strand{poolctx.get_executor()};
+  /// run aio callbacks where the op completes instead of on finish_strand
+  const bool inline_aio_completions;
 
   explicit RadosClient(CephContext *cct);
   ~RadosClient() override;
@@ -6,7 +6,9 @@
 
 #include "include/common_fwd.h"
 #include "include/rados/librados_fwd.hpp"
+#include <cstdint>
 #include <memory>
+#include <vector>
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
@@ -47,7 +49,16 @@ public:
 
   inline boost::asio::strand<executor_type>& get_api_strand() {
     // API client callbacks should never fire concurrently
-    return *m_api_strand;
+    return m_api_strands.front();
+  }
+  inline boost::asio::strand<executor_type>& get_api_strand(const void* key) {
+    // with rbd_api_strands > 1, only callbacks sharing a strand are
+    // serialized -- the key keeps one request on a single strand
+    if (m_api_strands.size() == 1) {
+      return m_api_strands.front();
+    }
+    auto index = (reinterpret_cast<uintptr_t>(key) >> 6) % m_api_strands.size();
+    return m_api_strands[index];
   }
 
   inline asio::ContextWQ* get_work_queue() {
@@ -71,7 +82,7 @@ private:
   CephContext* m_cct;
 
   boost::asio::io_context& m_io_context;
-  std::unique_ptr<boost::asio::strand<executor_type>> m_api_strand;
+  std::vector<boost::asio::strand<executor_type>> m_api_strands;
   std::unique_ptr<asio::ContextWQ> m_context_wq;
 };
 
@@ -19,7 +19,9 @@ AsyncObjectThrottle<T>::AsyncObjectThrottle(
     m_async_request(async_request), m_image_ctx(image_ctx),
     m_context_factory(context_factory), m_ctx(ctx), m_prog_ctx(prog_ctx),
     m_object_no(object_no), m_end_object_no(end_object_no), m_current_ops(0),
-    m_ret(0)
+    m_ret(0),
+    m_max_window(image_ctx.config.template get_val<uint64_t>(
+      "rbd_concurrent_management_ops_max"))
 {
 }
 
@@ -29,6 +31,7 @@ void AsyncObjectThrottle<T>::start_ops(uint64_t max_concurrent) {
   bool complete;
   {
     std::lock_guard l{m_lock};
+    m_window.init(max_concurrent, m_max_window);
     for (uint64_t i = 0; i < max_concurrent; ++i) {
       start_next_op();
       if (m_ret < 0 && m_current_ops == 0) {
@@ -46,6 +49,11 @@ void AsyncObjectThrottle<T>::start_ops(uint64_t max_concurrent) {
 
 template <typename T>
 void AsyncObjectThrottle<T>::finish_op(int r) {
+  finish_op(r, ceph::timespan::zero());
+}
+
+template <typename T>
+void AsyncObjectThrottle<T>::finish_op(int r, ceph::timespan op_latency) {
   bool complete;
   {
     std::shared_lock owner_locker{m_image_ctx.owner_lock};
@@ -55,7 +63,19 @@ void AsyncObjectThrottle<T>::finish_op(int r) {
       m_ret = r;
     }
 
-    start_next_op();
+    if (m_window.is_adaptive()) {
+      m_window.finish_op(op_latency);
+      while (m_current_ops < m_window.get()) {
+        auto current_ops = m_current_ops;
+        start_next_op();
+        if (m_current_ops == current_ops) {
+          // nothing left to start
+          break;
+        }
+      }
+    } else {
+      start_next_op();
+    }
     complete = (m_current_ops == 0);
   }
   if (complete) {
@@ -79,6 +99,7 @@ void AsyncObjectThrottle<T>::start_next_op() {
 
     uint64_t ono = m_object_no++;
     C_AsyncObjectThrottle<T> *ctx = m_context_factory(*this, ono);
+    ctx->set_start_time(ceph::mono_clock::now());
 
     int r = ctx->send();
     if (r < 0) {
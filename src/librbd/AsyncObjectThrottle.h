@@ -5,6 +5,8 @@
 
 #include "include/int_types.h"
 #include "include/Context.h"
+#include "common/ceph_time.h"
+#include "librbd/ConcurrencyWindow.h"
 
 #include <boost/function.hpp>
 
@@ -18,6 +20,9 @@ class AsyncObjectThrottleFinisher {
 public:
   virtual ~AsyncObjectThrottleFinisher() {};
   virtual void finish_op(int r) = 0;
+  virtual void finish_op(int r, ceph::timespan op_latency) {
+    finish_op(r);
+  }
 };
 
 template <typename ImageCtxT = ImageCtx>
@@ -30,15 +35,20 @@ public:
 
   virtual int send() = 0;
 
+  void set_start_time(ceph::mono_time start_time) {
+    m_start_time = start_time;
+  }
+
 protected:
   ImageCtxT &m_image_ctx;
 
   void finish(int r) override {
-    m_finisher.finish_op(r);
+    m_finisher.finish_op(r, ceph::mono_clock::now() - m_start_time);
   }
 
 private:
   AsyncObjectThrottleFinisher &m_finisher;
+  ceph::mono_time m_start_time;
 };
 
 template <typename ImageCtxT = ImageCtx>
@@ -56,6 +66,7 @@ public:
 
   void start_ops(uint64_t max_concurrent);
   void finish_op(int r) override;
+  void finish_op(int r, ceph::timespan op_latency) override;
 
 private:
   ceph::mutex m_lock;
@@ -69,6 +80,11 @@ private:
   uint64_t m_current_ops;
   int m_ret;
 
+  // adaptive only if rbd_concurrent_management_ops_max is larger than the
+  // initial concurrency passed to start_ops()
+  uint64_t m_max_window;
+  ConcurrencyWindow m_window;
+
   void start_next_op();
 };
 
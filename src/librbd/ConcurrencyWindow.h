@@ -0,0 +1,68 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+#ifndef CEPH_LIBRBD_CONCURRENCY_WINDOW_H
+#define CEPH_LIBRBD_CONCURRENCY_WINDOW_H
+
+#include "include/int_types.h"
+#include "common/ceph_time.h"
+#include <algorithm>
+
+namespace librbd {
+
+/**
+ * AIMD window for per-object operations (see
+ * rbd_concurrent_management_ops_max). The fastest op seen approximates the
+ * uncongested latency: the window grows by about one op per window of
+ * completions while ops stay within 2x of it and halves (at most once per
+ * window) when they take longer. Not thread-safe.
+ */
+class ConcurrencyWindow {
+public:
+  ConcurrencyWindow() {}
+  ConcurrencyWindow(uint64_t initial, uint64_t max) {
+    init(initial, max);
+  }
+
+  // adaptive only if max > initial; otherwise fixed at initial
+  void init(uint64_t initial, uint64_t max) {
+    m_window = std::max<uint64_t>(1, initial);
+    m_max = std::max<uint64_t>(m_window, max);
+    m_adaptive = (m_max > m_window);
+  }
+
+  bool is_adaptive() const {
+    return m_adaptive;
+  }
+
+  uint64_t get() const {
+    return static_cast<uint64_t>(m_window);
+  }
+
+  void finish_op(ceph::timespan op_latency) {
+    if (!m_adaptive || op_latency <= ceph::timespan::zero()) {
+      return;
+    }
+
+    m_min_latency = std::min(m_min_latency, op_latency);
+    ++m_ops_since_decrease;
+    if (op_latency > 2 * m_min_latency) {
+      if (m_ops_since_decrease >= get()) {
+	m_window = std::max(1.0, m_window / 2);
+	m_ops_since_decrease = 0;
+      }
+    } else {
+      m_window = std::min<double>(m_max, m_window + 1.0 / m_window);
+    }
+  }
+
+private:
+  double m_window = 1;
+  uint64_t m_max = 1;
+  bool m_adaptive = false;
+  ceph::timespan m_min_latency = ceph::timespan::max();
+  uint64_t m_ops_since_decrease = 0;
+};
+
+} // namespace librbd
+
+#endif // CEPH_LIBRBD_CONCURRENCY_WINDOW_H
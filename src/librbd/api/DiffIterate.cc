@@ -289,6 +289,28 @@ std::pair<uint64_t, uint64_t> DiffIterate<I>::calc_object_diff_range() {
   return {object_extents.front().object_no, object_extents.back().object_no + 1};
 }
 
+template <typename I>
+bool DiffIterate<I>::is_unchanged(uint64_t off, uint64_t len,
+                                  uint64_t start_object_no,
+                                  const BitVector<2>& object_diff_state,
+                                  bool parent_possible) {
+  striper::LightweightObjectExtents object_extents;
+  io::util::area_to_object_extents(&m_image_ctx, off, len,
+                                   io::ImageArea::DATA, 0, &object_extents);
+  for (const auto& oe : object_extents) {
+    uint8_t diff_state = object_diff_state[oe.object_no - start_object_no];
+    if (diff_state == object_map::DIFF_STATE_HOLE) {
+      // a hole in the child may still expose parent data
+      if (parent_possible) {
+        return false;
+      }
+    } else if (diff_state != object_map::DIFF_STATE_DATA) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <typename I>
 int DiffIterate<I>::execute() {
   CephContext* cct = m_image_ctx.cct;
@@ -326,9 +348,13 @@ int DiffIterate<I>::execute() {
   uint64_t start_object_no, end_object_no;
   BitVector<2> object_diff_state;
   interval_set<uint64_t> parent_diff;
-  if (m_whole_object) {
-    std::tie(start_object_no, end_object_no) = calc_object_diff_range();
+  bool parent_possible = false;
 
+  // the object map diff answers whole-object diffs directly and lets
+  // exact diffs skip listing snapshots of objects that did not change
+  // (not worth loading the object maps for a single object, though)
+  std::tie(start_object_no, end_object_no) = calc_object_diff_range();
+  if (m_whole_object || end_object_no - start_object_no > 1) {
     C_SaferCond ctx;
     auto req = object_map::DiffRequest<I>::create(&m_image_ctx, from_snap_id,
                                                   end_snap_id, start_object_no,
@@ -344,7 +370,10 @@ int DiffIterate<I>::execute() {
       fast_diff_enabled = true;
 
       // check parent overlap only if we are comparing to the beginning of time
-      if (m_include_parent && from_snap_id == 0) {
+      if (m_include_parent && from_snap_id == 0 && !m_whole_object) {
+        std::shared_lock image_locker{m_image_ctx.image_lock};
+        parent_possible = (m_image_ctx.parent != nullptr);
+      } else if (m_include_parent && from_snap_id == 0) {
         std::shared_lock image_locker{m_image_ctx.image_lock};
         uint64_t raw_overlap = 0;
         m_image_ctx.get_parent_overlap(m_image_ctx.snap_id, &raw_overlap);
@@ -380,7 +409,7 @@ int DiffIterate<I>::execute() {
     uint64_t period_off = round_down_to(off, period);
     uint64_t read_len = std::min(period_off + period - off, left);
 
-    if (fast_diff_enabled) {
+    if (fast_diff_enabled && m_whole_object) {
       // map to objects (there would be one extent per object)
       striper::LightweightObjectExtents object_extents;
       io::util::area_to_object_extents(&m_image_ctx, off, read_len,
@@ -432,6 +461,11 @@ int DiffIterate<I>::execute() {
           return r;
         }
       }
+    } else if (fast_diff_enabled &&
+               is_unchanged(off, read_len, start_object_no, object_diff_state,
+                            parent_possible)) {
+      ldout(cct, 20) << "skipping unchanged " << off << "~" << read_len
+                     << dendl;
     } else {
       auto diff_object = new C_DiffObject<I>(m_image_ctx, diff_context, off,
                                              read_len);
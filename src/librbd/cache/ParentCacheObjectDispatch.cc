@@ -2,6 +2,7 @@
 // vim: ts=8 sw=2 smarttab
 
 #include "common/errno.h"
+#include "common/safe_io.h"
 #include "include/neorados/RADOS.hpp"
 #include "librbd/ImageCtx.h"
 #include "librbd/Utils.h"
@@ -13,6 +14,8 @@
 #include "osd/osd_types.h"
 #include "osdc/WritebackHandler.h"
 
+#include <fcntl.h>
+#include <unistd.h>
 #include <vector>
 
 #define dout_subsys ceph_subsys_rbd
@@ -32,7 +35,11 @@ ParentCacheObjectDispatch<I>::ParentCacheObjectDispatch(
     I* image_ctx, plugin::Api<I>& plugin_api)
   : m_image_ctx(image_ctx), m_plugin_api(plugin_api),
     m_lock(ceph::make_mutex(
-      "librbd::cache::ParentCacheObjectDispatch::lock", true, false)) {
+      "librbd::cache::ParentCacheObjectDispatch::lock", true, false)),
+    m_file_lock(ceph::make_mutex(
+      "librbd::cache::ParentCacheObjectDispatch::file_lock")),
+    m_max_open_files(image_ctx->config.template get_val<uint64_t>(
+      "rbd_parent_cache_max_open_files")) {
   ceph_assert(m_image_ctx->data_ctx.is_valid());
   auto controller_path = image_ctx->cct->_conf.template get_val<std::string>(
     "immutable_object_cache_sock");
@@ -236,6 +243,49 @@ void ParentCacheObjectDispatch<I>::create_cache_session(Context* on_finish,
   m_cache_client->connect(connect_ctx);
 }
 
+template <typename I>
+ParentCacheObjectDispatch<I>::CacheFile::~CacheFile() {
+  VOID_TEMP_FAILURE_RETRY(::close(fd));
+}
+
+template <typename I>
+int ParentCacheObjectDispatch<I>::open_cache_file(const std::string& file_path,
+                                                  CacheFileRef* file) {
+  std::lock_guard locker{m_file_lock};
+  auto it = m_files.find(file_path);
+  if (it != m_files.end()) {
+    m_file_lru.splice(m_file_lru.end(), m_file_lru, it->second.second);
+    *file = it->second.first;
+    return 0;
+  }
+
+  int fd = TEMP_FAILURE_RETRY(::open(file_path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd < 0) {
+    return -errno;
+  }
+  *file = std::make_shared<CacheFile>(fd);
+
+  while (!m_file_lru.empty() && m_file_lru.size() >= m_max_open_files) {
+    // readers still holding a ref keep the fd open until they are done
+    m_files.erase(m_file_lru.front());
+    m_file_lru.pop_front();
+  }
+  auto lru_it = m_file_lru.insert(m_file_lru.end(), file_path);
+  m_files.emplace(file_path, std::make_pair(*file, lru_it));
+  return 0;
+}
+
+template <typename I>
+void ParentCacheObjectDispatch<I>::close_cache_file(
+    const std::string& file_path) {
+  std::lock_guard locker{m_file_lock};
+  auto it = m_files.find(file_path);
+  if (it != m_files.end()) {
+    m_file_lru.erase(it->second.second);
+    m_files.erase(it);
+  }
+}
+
 template <typename I>
 int ParentCacheObjectDispatch<I>::read_object(
     std::string file_path, ceph::bufferlist* read_data, uint64_t offset,
@@ -244,14 +294,38 @@ int ParentCacheObjectDispatch<I>::read_object(
   auto *cct = m_image_ctx->cct;
   ldout(cct, 20) << "file path: " << file_path << dendl;
 
-  std::string error;
-  int ret = read_data->pread_file(file_path.c_str(), offset, length, &error);
+  if (m_max_open_files == 0) {
+    std::string error;
+    int ret = read_data->pread_file(file_path.c_str(), offset, length, &error);
+    if (ret < 0) {
+      ldout(cct, 5) << "read from file return error: " << error
+                    << "file path= " << file_path
+                    << dendl;
+      return ret;
+    }
+    return read_data->length();
+  }
+
+  CacheFileRef file;
+  int ret = open_cache_file(file_path, &file);
   if (ret < 0) {
-    ldout(cct, 5) << "read from file return error: " << error
-                  << "file path= " << file_path
-                  << dendl;
+    ldout(cct, 5) << "failed to open file: " << cpp_strerror(ret)
+                  << " file path= " << file_path << dendl;
     return ret;
   }
+
+  ceph::bufferptr bp = ceph::buffer::create(length);
+  ssize_t r = safe_pread(file->fd, bp.c_str(), length, offset);
+  if (r < 0) {
+    ldout(cct, 5) << "read from file return error: " << cpp_strerror(r)
+                  << " file path= " << file_path << dendl;
+    close_cache_file(file_path);
+    return r;
+  }
+  if (r > 0) {
+    bp.set_length(r);
+    read_data->push_back(std::move(bp));
+  }
   return read_data->length();
 }
 
@@ -10,6 +10,10 @@
 #include "tools/immutable_object_cache/CacheClient.h"
 #include "tools/immutable_object_cache/Types.h"
 
+#include <list>
+#include <memory>
+#include <unordered_map>
+
 namespace librbd {
 
 class ImageCtx;
@@ -133,7 +137,17 @@ public:
   }
 
 private:
+  struct CacheFile {
+    int fd;
+
+    explicit CacheFile(int fd) : fd(fd) {}
+    ~CacheFile();
+  };
+  typedef std::shared_ptr<CacheFile> CacheFileRef;
+  typedef std::list<std::string> CacheFileLRU;
 
+  int open_cache_file(const std::string& file_path, CacheFileRef* file);
+  void close_cache_file(const std::string& file_path);
   int read_object(std::string file_path, ceph::bufferlist* read_data,
                   uint64_t offset, uint64_t length, Context *on_finish);
   void handle_read_cache(ceph::immutable_obj_cache::ObjectCacheRequest* ack,
@@ -151,6 +165,14 @@ private:
   ceph::mutex m_lock;
   CacheClient *m_cache_client = nullptr;
   bool m_connecting = false;
+
+  // cache files are immutable: an open fd stays valid even if the daemon
+  // evicts (unlinks) the file in the meantime
+  ceph::mutex m_file_lock;
+  uint64_t m_max_open_files;
+  CacheFileLRU m_file_lru;
+  std::unordered_map<std::string,
+                     std::pair<CacheFileRef, CacheFileLRU::iterator>> m_files;
 };
 
 } // namespace cache
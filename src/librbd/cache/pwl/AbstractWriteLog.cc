@@ -75,6 +75,8 @@ AbstractWriteLog<I>::AbstractWriteLog(
 {
   CephContext *cct = m_image_ctx.cct;
   m_plugin_api.get_image_timer_instance(cct, &m_timer, &m_timer_lock);
+  m_flush_bytes_in_flight_limit = m_image_ctx.config.template get_val<
+    Option::size_t>("rbd_persistent_cache_writeback_bytes_in_flight");
 }
 
 template <typename I>
@@ -1645,7 +1647,7 @@ bool AbstractWriteLog<I>::can_flush_entry(std::shared_ptr<GenericLogEntry> log_e
 
   return (log_entry->can_writeback() &&
          (m_flush_ops_in_flight <= IN_FLIGHT_FLUSH_WRITE_LIMIT) &&
-         (m_flush_bytes_in_flight <= IN_FLIGHT_FLUSH_BYTES_LIMIT));
+         ((uint64_t)m_flush_bytes_in_flight <= m_flush_bytes_in_flight_limit));
 }
 
 template <typename I>
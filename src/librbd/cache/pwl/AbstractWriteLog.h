@@ -205,6 +205,8 @@ private:
 
   int m_flush_ops_in_flight = 0;
   int m_flush_bytes_in_flight = 0;
+  /* rbd_persistent_cache_writeback_bytes_in_flight */
+  uint64_t m_flush_bytes_in_flight_limit;
   uint64_t m_lowest_flushing_sync_gen = 0;
 
   /* Writes that have left the block guard, but are waiting for resources */
@@ -55,7 +55,9 @@ WriteLog<I>::WriteLog(
     cache::ImageWritebackInterface& image_writeback,
     plugin::Api<I>& plugin_api)
   : AbstractWriteLog<I>(image_ctx, cache_state, create_builder(),
-                        image_writeback, plugin_api)
+                        image_writeback, plugin_api),
+    m_writeback_coalesce_bytes(image_ctx.config.template get_val<
+      Option::size_t>("rbd_persistent_cache_writeback_coalesce_bytes"))
 {
 }
 
@@ -597,6 +599,22 @@ void WriteLog<I>::construct_flush_entries(pwl::GenericLogEntries entries_to_flus
       [this, entries_to_flush, read_bls](int r) {
         int i = 0;
 	GuardedRequestFunctionContext *guarded_ctx = nullptr;
+	pwl::GenericLogEntries coalesced_entries;
+	std::vector<bufferlist> coalesced_bls;
+	uint64_t coalesced_bytes = 0;
+
+	auto flush_coalesced = [&]() {
+	  if (coalesced_entries.size() > 1) {
+	    flush_coalesced_entries(std::move(coalesced_entries),
+				    std::move(coalesced_bls));
+	  } else if (!coalesced_entries.empty()) {
+	    flush_write_entry(coalesced_entries.front(),
+			      std::move(coalesced_bls.front()));
+	  }
+	  coalesced_entries.clear();
+	  coalesced_bls.clear();
+	  coalesced_bytes = 0;
+	};
 
 	for (auto &log_entry : entries_to_flush) {
 	  if (log_entry->is_write_entry()) {
@@ -604,21 +622,27 @@ void WriteLog<I>::construct_flush_entries(pwl::GenericLogEntries entries_to_flus
 	    captured_entry_bl.claim_append(*read_bls[i]);
 	    delete read_bls[i++];
 
-	    guarded_ctx = new GuardedRequestFunctionContext([this, log_entry, captured_entry_bl]
-              (GuardedRequestFunctionContext &guard_ctx) {
-                log_entry->m_cell = guard_ctx.cell;
-                Context *ctx = this->construct_flush_entry(log_entry, false);
-
-	        m_image_ctx.op_work_queue->queue(new LambdaContext(
-	          [this, log_entry, entry_bl=std::move(captured_entry_bl), ctx](int r) {
-		    auto captured_entry_bl = std::move(entry_bl);
-		    ldout(m_image_ctx.cct, 15) << "flushing:" << log_entry
-			                       << " " << *log_entry << dendl;
-		    log_entry->writeback_bl(this->m_image_writeback, ctx,
-                                            std::move(captured_entry_bl));
-	          }), 0);
-	      });
+	    if (!log_entry->ram_entry.is_write()) {
+	      // write same entries are written back on their own
+	      flush_coalesced();
+	      flush_write_entry(log_entry, std::move(captured_entry_bl));
+	      continue;
+	    }
+	    if (!coalesced_entries.empty()) {
+	      auto &last = coalesced_entries.back()->ram_entry;
+	      if (last.image_offset_bytes + last.write_bytes !=
+		    log_entry->ram_entry.image_offset_bytes ||
+		  last.sync_gen_number != log_entry->ram_entry.sync_gen_number ||
+		  coalesced_bytes + log_entry->ram_entry.write_bytes >
+		    m_writeback_coalesce_bytes) {
+		flush_coalesced();
+	      }
+	    }
+	    coalesced_entries.push_back(log_entry);
+	    coalesced_bls.push_back(std::move(captured_entry_bl));
+	    coalesced_bytes += log_entry->ram_entry.write_bytes;
 	  } else {
+	    flush_coalesced();
 	    guarded_ctx = new GuardedRequestFunctionContext([this, log_entry]
               (GuardedRequestFunctionContext &guard_ctx) {
                 log_entry->m_cell = guard_ctx.cell;
@@ -630,15 +654,91 @@ void WriteLog<I>::construct_flush_entries(pwl::GenericLogEntries entries_to_flus
 		    log_entry->writeback(this->m_image_writeback, ctx);
 		  }), 0);
             });
+            this->detain_flush_guard_request(log_entry, guarded_ctx);
 	  }
-          this->detain_flush_guard_request(log_entry, guarded_ctx);
 	}
+	flush_coalesced();
       });
 
     aio_read_data_blocks(write_entries, read_bls, ctx);
   }
 }
 
+template <typename I>
+void WriteLog<I>::flush_write_entry(std::shared_ptr<GenericLogEntry> log_entry,
+				    bufferlist&& entry_bl) {
+  GuardedRequestFunctionContext *guarded_ctx =
+    new GuardedRequestFunctionContext([this, log_entry,
+				       captured_entry_bl=std::move(entry_bl)]
+      (GuardedRequestFunctionContext &guard_ctx) mutable {
+        log_entry->m_cell = guard_ctx.cell;
+        Context *ctx = this->construct_flush_entry(log_entry, false);
+
+        m_image_ctx.op_work_queue->queue(new LambdaContext(
+          [this, log_entry, entry_bl=std::move(captured_entry_bl), ctx](int r) {
+	    auto captured_entry_bl = std::move(entry_bl);
+	    ldout(m_image_ctx.cct, 15) << "flushing:" << log_entry
+			               << " " << *log_entry << dendl;
+	    log_entry->writeback_bl(this->m_image_writeback, ctx,
+                                    std::move(captured_entry_bl));
+          }), 0);
+    });
+  this->detain_flush_guard_request(log_entry, guarded_ctx);
+}
+
+template <typename I>
+void WriteLog<I>::flush_coalesced_entries(pwl::GenericLogEntries log_entries,
+					  std::vector<bufferlist> entry_bls) {
+  /* The entries cover contiguous image extents and share a sync gen number.
+   * Each still takes its own flush guard cell and gets its own flush context
+   * (which releases the cell and does the accounting), but the data goes to
+   * the image in one write once all the cells are held. */
+  struct CoalescedFlush {
+    pwl::GenericLogEntries log_entries;
+    std::vector<Context*> ctxs;
+    bufferlist bl;
+    std::atomic<size_t> pending;
+  };
+  auto flush = std::make_shared<CoalescedFlush>();
+  flush->log_entries = std::move(log_entries);
+  flush->ctxs.resize(flush->log_entries.size());
+  flush->pending = flush->log_entries.size();
+  for (auto &bl : entry_bls) {
+    flush->bl.claim_append(bl);
+  }
+
+  size_t i = 0;
+  for (auto &log_entry : flush->log_entries) {
+    GuardedRequestFunctionContext *guarded_ctx =
+      new GuardedRequestFunctionContext([this, flush, log_entry, i]
+        (GuardedRequestFunctionContext &guard_ctx) {
+          log_entry->m_cell = guard_ctx.cell;
+          flush->ctxs[i] = this->construct_flush_entry(log_entry, false);
+          if (--flush->pending > 0) {
+            return;
+          }
+
+          m_image_ctx.op_work_queue->queue(new LambdaContext(
+            [this, flush](int r) {
+              auto offset = flush->log_entries.front()->ram_entry.image_offset_bytes;
+              auto length = flush->bl.length();
+              ldout(m_image_ctx.cct, 15) << "flushing " << flush->ctxs.size()
+                                         << " coalesced entries as "
+                                         << offset << "~" << length << dendl;
+              this->m_image_writeback.aio_write(
+                {{offset, length}}, std::move(flush->bl), 0,
+                new LambdaContext([flush](int r) {
+                  for (auto ctx : flush->ctxs) {
+                    ctx->complete(r);
+                  }
+                }));
+            }), 0);
+      });
+    this->detain_flush_guard_request(log_entry, guarded_ctx);
+    ++i;
+  }
+}
+
 template <typename I>
 void WriteLog<I>::process_work() {
   CephContext *cct = m_image_ctx.cct;
@@ -103,6 +103,8 @@ private:
   BlockDevice *bdev = nullptr;
   pwl::WriteLogPoolRoot pool_root;
   Builder<This> *m_builderobj;
+  /* rbd_persistent_cache_writeback_coalesce_bytes */
+  uint64_t m_writeback_coalesce_bytes;
 
   Builder<This>* create_builder();
   int create_and_open_bdev();
@@ -125,6 +127,10 @@ private:
   void construct_flush_entries(pwl::GenericLogEntries entires_to_flush,
 				DeferredContexts &post_unlock,
 				bool has_write_entry) override;
+  void flush_write_entry(std::shared_ptr<GenericLogEntry> log_entry,
+                         bufferlist&& entry_bl);
+  void flush_coalesced_entries(pwl::GenericLogEntries log_entries,
+                               std::vector<bufferlist> entry_bls);
   void append_ops(GenericLogOperations &ops, Context *ctx,
                   uint64_t* new_first_free_entry);
   void write_log_entries(GenericLogEntriesVector log_entries,
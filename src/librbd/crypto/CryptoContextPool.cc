@@ -2,14 +2,17 @@
 // vim: ts=8 sw=2 smarttab
 
 #include "librbd/crypto/CryptoContextPool.h"
+#include "librbd/crypto/openssl/DataCryptor.h"
 
 namespace librbd {
 namespace crypto {
 
 template <typename T>
 CryptoContextPool<T>::CryptoContextPool(DataCryptor<T>* data_cryptor,
-                                        uint32_t pool_size)
-     : m_data_cryptor(data_cryptor), m_encrypt_contexts(pool_size),
+                                        uint32_t pool_size,
+                                        bool owns_data_cryptor)
+     : m_data_cryptor(data_cryptor), m_owns_data_cryptor(owns_data_cryptor),
+       m_encrypt_contexts(pool_size),
        m_decrypt_contexts(pool_size) {
 }
 
@@ -22,6 +25,9 @@ CryptoContextPool<T>::~CryptoContextPool() {
   while (m_decrypt_contexts.pop(ctx)) {
     m_data_cryptor->return_context(ctx, CipherMode::CIPHER_MODE_DEC);
   }
+  if (m_owns_data_cryptor) {
+    delete m_data_cryptor;
+  }
 }
 
 template <typename T>
@@ -42,3 +48,5 @@ void CryptoContextPool<T>::return_context(T* ctx, CipherMode mode) {
 
 } // namespace crypto
 } // namespace librbd
+
+template class librbd::crypto::CryptoContextPool<EVP_CIPHER_CTX>;
@@ -15,7 +15,9 @@ template <typename T>
 class CryptoContextPool : public DataCryptor<T>  {
 
 public:
-    CryptoContextPool(DataCryptor<T>* data_cryptor, uint32_t pool_size);
+    // takes ownership of data_cryptor if owns_data_cryptor is set
+    CryptoContextPool(DataCryptor<T>* data_cryptor, uint32_t pool_size,
+                      bool owns_data_cryptor = false);
     ~CryptoContextPool();
 
     T* get_context(CipherMode mode) override;
@@ -47,6 +49,7 @@ public:
 
 private:
     DataCryptor<T>* m_data_cryptor;
+    bool m_owns_data_cryptor;
     ContextQueue m_encrypt_contexts;
     ContextQueue m_decrypt_contexts;
 
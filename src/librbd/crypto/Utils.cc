@@ -7,6 +7,7 @@
 #include "common/errno.h"
 #include "librbd/ImageCtx.h"
 #include "librbd/crypto/BlockCrypto.h"
+#include "librbd/crypto/CryptoContextPool.h"
 #include "librbd/crypto/CryptoInterface.h"
 #include "librbd/crypto/CryptoObjectDispatch.h"
 #include "librbd/crypto/EncryptionFormat.h"
@@ -22,6 +23,10 @@ namespace librbd {
 namespace crypto {
 namespace util {
 
+// contexts preallocated per cipher mode; the pool grows past this under
+// higher concurrency
+const uint32_t CONTEXT_POOL_SIZE = 32;
+
 template <typename I>
 void set_crypto(I *image_ctx,
                 decltype(I::encryption_format) encryption_format) {
@@ -62,8 +67,13 @@ int build_crypto(
     return r;
   }
 
+  // keyed cipher contexts are expensive to set up (AES-XTS expands two key
+  // schedules), so recycle them across requests instead of creating one for
+  // every encrypt/decrypt call
+  auto context_pool = new CryptoContextPool<EVP_CIPHER_CTX>(
+          data_cryptor, CONTEXT_POOL_SIZE, true);
   result_crypto->reset(BlockCrypto<EVP_CIPHER_CTX>::create(
-          cct, data_cryptor, block_size, data_offset));
+          cct, context_pool, block_size, data_offset));
   return 0;
 }
 
@@ -152,6 +152,8 @@ void ImageCopyRequest<I>::send_object_copies() {
     std::lock_guard locker{m_lock};
     auto max_ops = m_src_image_ctx->config.template get_val<uint64_t>(
       "rbd_concurrent_management_ops");
+    m_window.init(max_ops, m_src_image_ctx->config.template get_val<uint64_t>(
+      "rbd_concurrent_management_ops_max"));
 
     // attempt to schedule at least 'max_ops' initial requests where
     // some objects might be skipped if fast-diff notes no change
@@ -182,8 +184,8 @@ void ImageCopyRequest<I>::send_next_object_copy() {
 
   uint64_t ono = m_object_no++;
   Context *ctx = new LambdaContext(
-    [this, ono](int r) {
-      handle_object_copy(ono, r);
+    [this, ono, start_time=ceph::mono_clock::now()](int r) {
+      handle_object_copy(ono, r, ceph::mono_clock::now() - start_time);
     });
 
   ldout(m_cct, 20) << "object_num=" << ono << dendl;
@@ -211,6 +213,11 @@ void ImageCopyRequest<I>::send_next_object_copy() {
 
     if (object_diff_state == object_map::DIFF_STATE_HOLE) {
       ldout(m_cct, 20) << "skipping non-existent object " << ono << dendl;
+      delete ctx;
+      // not a copy -- keep it out of the latency measurements
+      ctx = new LambdaContext([this, ono](int r) {
+          handle_object_copy(ono, r, ceph::timespan::zero());
+        });
       create_async_context_callback(*m_src_image_ctx, ctx)->complete(0);
       return;
     }
@@ -232,7 +239,8 @@ void ImageCopyRequest<I>::send_next_object_copy() {
 }
 
 template <typename I>
-void ImageCopyRequest<I>::handle_object_copy(uint64_t object_no, int r) {
+void ImageCopyRequest<I>::handle_object_copy(uint64_t object_no, int r,
+                                             ceph::timespan op_latency) {
   ldout(m_cct, 20) << "object_no=" << object_no << ", r=" << r << dendl;
 
   bool complete;
@@ -263,7 +271,19 @@ void ImageCopyRequest<I>::handle_object_copy(uint64_t object_no, int r) {
       }
     }
 
-    send_next_object_copy();
+    if (m_window.is_adaptive()) {
+      m_window.finish_op(op_latency);
+      while (m_current_ops < m_window.get()) {
+        auto object_no = m_object_no;
+        send_next_object_copy();
+        if (m_object_no == object_no) {
+          // nothing left to send
+          break;
+        }
+      }
+    } else {
+      send_next_object_copy();
+    }
     complete = (m_current_ops == 0) && !m_updating_progress;
   }
 
@@ -9,6 +9,8 @@
 #include "common/bit_vector.hpp"
 #include "common/ceph_mutex.h"
 #include "common/RefCountedObj.h"
+#include "common/ceph_time.h"
+#include "librbd/ConcurrencyWindow.h"
 #include "librbd/Types.h"
 #include "librbd/deep_copy/Types.h"
 #include <functional>
@@ -95,6 +97,7 @@ private:
   uint64_t m_object_no = 0;
   uint64_t m_end_object_no = 0;
   uint64_t m_current_ops = 0;
+  ConcurrencyWindow m_window;
   std::priority_queue<
     uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> m_copied_objects;
   bool m_updating_progress = false;
@@ -110,7 +113,8 @@ private:
 
   void send_object_copies();
   void send_next_object_copy();
-  void handle_object_copy(uint64_t object_no, int r);
+  void handle_object_copy(uint64_t object_no, int r,
+                          ceph::timespan op_latency);
 
   void finish(int r);
 };
@@ -134,7 +134,7 @@ void AioCompletion::queue_complete() {
   add_request();
 
   // ensure completion fires in clean lock context
-  boost::asio::post(ictx->asio_engine->get_api_strand(), [this]() {
+  boost::asio::post(ictx->asio_engine->get_api_strand(this), [this]() {
       complete_request(0);
     });
 }
@@ -248,8 +248,9 @@ void AioCompletion::complete_external_callback() {
   get();
 
   // ensure librbd external users never experience concurrent callbacks
-  // from multiple librbd-internal threads.
-  boost::asio::dispatch(ictx->asio_engine->get_api_strand(), [this]() {
+  // from multiple librbd-internal threads (unless rbd_api_strands allows
+  // callbacks on different strands to overlap).
+  boost::asio::dispatch(ictx->asio_engine->get_api_strand(this), [this]() {
       complete_cb(rbd_comp, complete_arg);
       mark_complete_and_notify();
       put();
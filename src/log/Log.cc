@@ -263,9 +263,15 @@ void Log::submit_entry(Entry&& e)
     m_cond_loggers.wait(lock);
   }
 
+  // the flusher only sleeps with m_new empty (checked under this lock), so
+  // only the entry that makes it non-empty has to wake it
+  bool was_empty = m_new.empty();
   m_new.emplace_back(std::move(e));
-  m_cond_flusher.notify_all();
   m_queue_mutex_holder = 0;
+  if (was_empty) {
+    lock.unlock();
+    m_cond_flusher.notify_one();
+  }
 }
 
 void Log::flush()
@@ -17,6 +17,7 @@
 #define MDS_BATCHOP_H
 
 #include "common/ref.h"
+#include "include/mempool.h"
 
 #include "mdstypes.h"
 
@@ -37,4 +38,8 @@ protected:
   virtual void _respond(mds_rank_t) = 0;
 };
 
+// batched ops by getattr mask, hung off every CInode and CDentry but almost
+// always empty
+using batch_op_map_t = mempool::mds_co::compact_map<int, std::unique_ptr<BatchOp>>;
+
 #endif
@@ -401,7 +401,7 @@ public:
     ClientLease, boost::intrusive::key_of_value<client_is_key>> ClientLeaseMap;
   ClientLeaseMap client_leases;
 
-  std::map<int, std::unique_ptr<BatchOp>> batch_ops;
+  batch_op_map_t batch_ops;
 
   ceph_tid_t reintegration_reqid = 0;
 
@@ -4223,7 +4223,8 @@ int CInode::encode_inodestat(bufferlist& bl, Session *session,
   return valid;
 }
 
-void CInode::encode_cap_message(const ref_t<MClientCaps> &m, Capability *cap)
+void CInode::encode_cap_message(const ref_t<MClientCaps> &m, Capability *cap,
+                                bufferlist *xattrs_bl)
 {
   ceph_assert(cap);
 
@@ -4285,10 +4286,17 @@ void CInode::encode_cap_message(const ref_t<MClientCaps> &m, Capability *cap)
   if ((cap->pending() & CEPH_CAP_XATTR_SHARED) &&
       i->xattr_version > cap->client_xattr_version) {
     dout(10) << "    including xattrs v " << i->xattr_version << dendl;
-    if (ix)
-      encode(*ix, m->xattrbl);
-    else
-      encode((__u32)0, m->xattrbl);
+    bufferlist bl;
+    if (xattrs_bl && !pxattr && xattrs_bl->length()) {
+      bl = *xattrs_bl;
+    } else if (ix) {
+      encode(*ix, bl);
+    } else {
+      encode((__u32)0, bl);
+    }
+    if (xattrs_bl && !pxattr && !xattrs_bl->length())
+      *xattrs_bl = bl;  // shares the buffers
+    m->xattrbl = std::move(bl);
     m->head.xattr_version = i->xattr_version;
     cap->client_xattr_version = i->xattr_version;
   }
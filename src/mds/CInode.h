@@ -420,7 +420,7 @@ class CInode : public MDSCacheObject, public InodeStoreBase, public Counter<CIno
     ceph_assert(batch_ops.empty());
   }
 
-  std::map<int, std::unique_ptr<BatchOp>> batch_ops;
+  batch_op_map_t batch_ops;
 
   std::string_view pin_name(int p) const override;
 
@@ -806,7 +806,10 @@ class CInode : public MDSCacheObject, public InodeStoreBase, public Counter<CIno
   int encode_inodestat(ceph::buffer::list& bl, Session *session, SnapRealm *realm,
 		       snapid_t snapid=CEPH_NOSNAP, unsigned max_bytes=0,
 		       int getattr_wants=0);
-  void encode_cap_message(const ceph::ref_t<MClientCaps> &m, Capability *cap);
+  // xattrs_bl, if given, caches the encoded (non-projected) xattrs across
+  // calls for several caps of this inode
+  void encode_cap_message(const ceph::ref_t<MClientCaps> &m, Capability *cap,
+                          ceph::buffer::list *xattrs_bl=nullptr);
 
   SimpleLock* get_lock(int type) override;
 
@@ -1090,7 +1093,7 @@ class CInode : public MDSCacheObject, public InodeStoreBase, public Counter<CIno
   // list item node for when we have unpropagated rstat data
   elist<CInode*>::item dirty_rstat_item;
 
-  mempool::mds_co::set<client_t> client_snap_caps;
+  mempool::mds_co::compact_set<client_t> client_snap_caps;
   mempool::mds_co::compact_map<snapid_t, mempool::mds_co::set<client_t> > client_need_snapflush;
 
   // LogSegment lists i (may) belong to
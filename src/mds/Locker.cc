@@ -2550,6 +2550,11 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
 
   ceph_assert(in->is_head());
 
+  // the same for every cap of this inode
+  const inodeno_t realm_ino = in->find_snaprealm()->inode->ino();
+  const int likes = in->get_caps_liked();
+  bufferlist xattrs_bl;
+
   // client caps
   map<client_t, Capability>::iterator it;
   if (only_cap)
@@ -2596,12 +2601,12 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
         if (mds->logger) mds->logger->inc(l_mdss_ceph_cap_op_grant);
 
 	auto m = make_message<MClientCaps>(CEPH_CAP_OP_GRANT, in->ino(),
-					   in->find_snaprealm()->inode->ino(),
+					   realm_ino,
 					   cap->get_cap_id(), cap->get_last_seq(),
 					   pending, wanted, 0, cap->get_mseq(),
                                            cap->get_last_issue(),
 					   mds->get_osd_epoch_barrier());
-	in->encode_cap_message(m, cap);
+	in->encode_cap_message(m, cap, &xattrs_bl);
 
 	mds->send_message_client_counted(m, cap->get_session());
       }
@@ -2620,7 +2625,6 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
       nissued++;
 
       // include caps that clients generally like, while we're at it.
-      int likes = in->get_caps_liked();      
       int before = pending;
       long seq;
       if (pending & ~allowed)
@@ -2647,12 +2651,12 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
       }
 
       auto m = make_message<MClientCaps>(op, in->ino(),
-					 in->find_snaprealm()->inode->ino(),
+					 realm_ino,
 					 cap->get_cap_id(), cap->get_last_seq(),
 					 after, wanted, 0, cap->get_mseq(),
                                          cap->get_last_issue(),
 					 mds->get_osd_epoch_barrier());
-      in->encode_cap_message(m, cap);
+      in->encode_cap_message(m, cap, &xattrs_bl);
 
       mds->send_message_client_counted(m, cap->get_session());
     }
@@ -2668,18 +2672,20 @@ void Locker::issue_truncate(CInode *in)
 {
   dout(7) << "issue_truncate on " << *in << dendl;
   
+  const inodeno_t realm_ino = in->find_snaprealm()->inode->ino();
+  bufferlist xattrs_bl;
   for (auto &p : in->client_caps) {
     if (mds->logger) mds->logger->inc(l_mdss_ceph_cap_op_trunc);
     Capability *cap = &p.second;
     auto m = make_message<MClientCaps>(CEPH_CAP_OP_TRUNC,
                                        in->ino(),
-                                       in->find_snaprealm()->inode->ino(),
+                                       realm_ino,
                                        cap->get_cap_id(), cap->get_last_seq(),
                                        cap->pending(), cap->wanted(), 0,
                                        cap->get_mseq(),
                                        cap->get_last_issue(),
                                        mds->get_osd_epoch_barrier());
-    in->encode_cap_message(m, cap);			     
+    in->encode_cap_message(m, cap, &xattrs_bl);
     mds->send_message_client_counted(m, cap->get_session());
   }
 
@@ -97,6 +97,7 @@ MDBalancer::MDBalancer(MDSRank *m, Messenger *msgr, MonClient *monc) :
   bal_split_wr = g_conf().get_val<double>("mds_bal_split_wr");
   bal_unreplicate_threshold = g_conf().get_val<double>("mds_bal_unreplicate_threshold");
   num_bal_times = g_conf().get_val<int64_t>("mds_bal_max");
+  bal_import_hold_time = g_conf().get_val<std::chrono::seconds>("mds_bal_import_hold_time").count();
 }
 
 void MDBalancer::handle_conf_change(const std::set<std::string>& changed, const MDSMap& mds_map)
@@ -133,6 +134,8 @@ void MDBalancer::handle_conf_change(const std::set<std::string>& changed, const
     bal_unreplicate_threshold = g_conf().get_val<double>("mds_bal_unreplicate_threshold");
   if (changed.count("mds_bal_max"))
     num_bal_times = g_conf().get_val<int64_t>("mds_bal_max");
+  if (changed.count("mds_bal_import_hold_time"))
+    bal_import_hold_time = g_conf().get_val<std::chrono::seconds>("mds_bal_import_hold_time").count();
 }
 
 bool MDBalancer::test_rank_mask(mds_rank_t rank)
@@ -987,6 +990,15 @@ void MDBalancer::try_rebalance(balance_state_t& state)
   // make a sorted list of my imports
   multimap<double, CDir*> import_pop_map;
   multimap<mds_rank_t, pair<CDir*, double> > import_from_map;
+  set<CDir*> held_imports;
+
+  auto now = clock::now();
+  for (auto it = import_times.begin(); it != import_times.end(); ) {
+    if (std::chrono::duration<double>(now - it->second).count() >= bal_import_hold_time)
+      it = import_times.erase(it);
+    else
+      ++it;
+  }
 
   for (auto& dir : mds->mdcache->get_fullauth_subtrees()) {
     CInode *diri = dir->get_inode();
@@ -999,6 +1011,13 @@ void MDBalancer::try_rebalance(balance_state_t& state)
 
     mds_rank_t from = diri->authority().first;
     double pop = dir->pop_auth_subtree.meta_load();
+    if (import_times.count(dir->dirfrag())) {
+      // only just arrived; keep it rather than bounce it straight back
+      dout(15) << "  map: holding recent import " << *dir << " from " << from << dendl;
+      held_imports.insert(dir);
+      import_pop_map.insert(make_pair(pop, dir));
+      continue;
+    }
     const auto bal_idle_threshold = g_conf().get_val<double>("mds_bal_idle_threshold");
     if (bal_idle_threshold > 0 &&
 	pop < bal_idle_threshold &&
@@ -1094,6 +1113,11 @@ void MDBalancer::try_rebalance(balance_state_t& state)
 	continue;
       }
 
+      if (held_imports.count(dir)) {
+	++p;
+	continue;
+      }
+
       double pop = p->first;
       if (pop <= amount-have && pop > MIN_REEXPORT) {
 	dout(5) << "reexporting " << *dir << " pop " << pop
@@ -1413,6 +1437,7 @@ void MDBalancer::hit_dir(CDir *dir, int type, double amount)
  */
 void MDBalancer::subtract_export(CDir *dir)
 {
+  import_times.erase(dir->dirfrag());
   dirfrag_load_vec_t subload = dir->pop_auth_subtree;
 
   while (true) {
@@ -1427,6 +1452,8 @@ void MDBalancer::subtract_export(CDir *dir)
 
 void MDBalancer::add_import(CDir *dir)
 {
+  if (bal_import_hold_time > 0)
+    import_times[dir->dirfrag()] = clock::now();
   dirfrag_load_vec_t subload = dir->pop_auth_subtree;
 
   while (true) {
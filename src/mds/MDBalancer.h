@@ -150,6 +150,7 @@ private:
   int64_t bal_split_size;
   int64_t bal_merge_size;
   int64_t num_bal_times;
+  double bal_import_hold_time;
 
   MDSRank *mds;
   Messenger *messenger;
@@ -175,6 +176,9 @@ private:
   // dirfrags that already have one in flight.
   std::set<dirfrag_t> split_pending, merge_pending;
 
+  // when we imported each subtree, for mds_bal_import_hold_time
+  std::map<dirfrag_t, time> import_times;
+
   // per-epoch scatter/gathered info
   std::map<mds_rank_t, mds_load_t> mds_load;
   std::map<mds_rank_t, double> mds_meta_load;
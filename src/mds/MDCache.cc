@@ -2050,6 +2050,23 @@ void MDCache::project_rstat_frag_to_inode(const nest_info_t& rstat,
     pin->reset_old_inodes(std::move(_old_inodes));
 }
 
+bool MDCache::is_under_nearly_full_quota(CInode *in) const
+{
+  for (SnapRealm *realm = in->find_snaprealm(); realm; realm = realm->parent) {
+    const auto& pi = realm->inode->get_projected_inode();
+    if (!pi->quota.is_enabled())
+      continue;
+    // same margin as broadcast_quota_to_client uses to update clients eagerly
+    if (pi->quota.max_files > 0 &&
+	pi->rstat.rsize() >= pi->quota.max_files - (pi->quota.max_files >> 3))
+      return true;
+    if (pi->quota.max_bytes > 0 &&
+	pi->rstat.rbytes > pi->quota.max_bytes - (pi->quota.max_bytes >> 3))
+      return true;
+  }
+  return false;
+}
+
 void MDCache::broadcast_quota_to_client(CInode *in, client_t exclude_ct, bool quota_change)
 {
   if (!(mds->is_active() || mds->is_stopping()))
@@ -2280,7 +2297,14 @@ void MDCache::predirty_journal_parents(MutationRef mut, EMetaBlob *blob,
     if (!stop && !first &&
 	g_conf()->mds_dirstat_min_interval > 0) {
       double since_last_prop = mut->get_mds_stamp() - pin->last_dirstat_prop;
-      if (since_last_prop < g_conf()->mds_dirstat_min_interval) {
+      if (since_last_prop < g_conf()->mds_dirstat_min_interval &&
+	  is_under_nearly_full_quota(pin)) {
+	// clients enforce quota from the rstat we send them; don't let
+	// it lag behind when the limit is close.
+	dout(10) << "predirty_journal_parents last prop " << since_last_prop
+		 << " < " << g_conf()->mds_dirstat_min_interval
+		 << ", but quota is nearly full, continuing" << dendl;
+      } else if (since_last_prop < g_conf()->mds_dirstat_min_interval) {
 	dout(10) << "predirty_journal_parents last prop " << since_last_prop
 		 << " < " << g_conf()->mds_dirstat_min_interval
 		 << ", stopping" << dendl;
@@ -9437,7 +9461,10 @@ void MDCache::open_ino_batch_submit()
   dout(10) << __func__ << dendl;
   open_ino_batch = false;
 
-  for (auto& [dir, p] : open_ino_batched_fetch) {
+  // waiters may open a new batch before we are done with this one
+  auto batch = std::move(open_ino_batched_fetch);
+  open_ino_batched_fetch.clear();
+  for (auto& [dir, p] : batch) {
     CInode *in = dir->inode;
     std::vector<dentry_key_t> keys;
     for (auto& dname : p.first)
@@ -9445,14 +9472,21 @@ void MDCache::open_ino_batch_submit()
     dir->fetch_keys(keys,
 	  new MDSInternalContextWrapper(mds,
 	    new LambdaContext([this, waiters = std::move(p.second)](int r) mutable {
-	      mds->queue_waiters_front(waiters);
+	      // continue these traversals together so that the dentries they
+	      // look up next (e.g. during failover replay of the open file
+	      // table) are fetched one batch per dirfrag as well.
+	      bool nested = open_ino_batch;
+	      if (!nested)
+		open_ino_batch_start();
+	      finish_contexts(g_ceph_context, waiters, 0);
+	      if (!nested)
+		open_ino_batch_submit();
 	    })
 	  )
 	);
     if (mds->logger)
       mds->logger->inc(l_mds_openino_dir_fetch);
   }
-  open_ino_batched_fetch.clear();
 }
 
 void MDCache::open_ino(inodeno_t ino, int64_t pool, MDSContext* fin,
@@ -451,6 +451,7 @@ class MDCache {
   void project_rstat_frag_to_inode(const nest_info_t& rstat, const nest_info_t& accounted_rstat,
 				   snapid_t ofirst, snapid_t last, CInode *pin, bool cow_head);
   void broadcast_quota_to_client(CInode *in, client_t exclude_ct = -1, bool quota_change = false);
+  bool is_under_nearly_full_quota(CInode *in) const;
   void predirty_journal_parents(MutationRef mut, EMetaBlob *blob,
 				CInode *in, CDir *parent,
 				int flags, int linkunlink=0,
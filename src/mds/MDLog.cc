@@ -508,73 +508,83 @@ void MDLog::_submit_thread()
       continue;
     }
 
+    // take every event queued for this segment so far: events submitted
+    // while the previous batch was being journaled are appended together,
+    // and their flush requests become a single journaler flush
     int64_t features = mdsmap_up_features;
-    PendingEvent data = it->second.front();
-    it->second.pop_front();
+    std::list<PendingEvent> batch;
+    batch.swap(it->second);
 
     locker.unlock();
 
-    if (data.le) {
-      LogEvent *le = data.le;
-      LogSegment *ls = le->_segment;
-      // encode it, with event type
-      bufferlist bl;
-      le->encode_with_header(bl, features);
-
-      uint64_t write_pos = journaler->get_write_pos();
-
-      le->set_start_off(write_pos);
-      if (dynamic_cast<SegmentBoundary*>(le)) {
-	ls->offset = write_pos;
-      }
-
-      if (bl.length() >= event_large_threshold.load()) {
-        dout(5) << "large event detected!" << dendl;
-        logger->inc(l_mdl_evlrg);
-      }
-
-      dout(5) << "_submit_thread " << write_pos << "~" << bl.length()
-	      << " : " << *le << dendl;
-
-      // journal it.
-      const uint64_t new_write_pos = journaler->append_entry(bl);  // bl is destroyed.
-      ls->end = new_write_pos;
-
-      MDSLogContextBase *fin;
-      if (data.fin) {
-	fin = dynamic_cast<MDSLogContextBase*>(data.fin);
-	ceph_assert(fin);
-	fin->set_write_pos(new_write_pos);
-      } else {
-	fin = new C_MDL_Flushed(this, new_write_pos);
-      }
-
-      journaler->wait_for_flush(fin);
-
-      if (data.flush)
-	journaler->flush();
-
-      if (logger)
-	logger->set(l_mdl_wrpos, ls->end);
-
-      delete le;
-    } else {
-      if (data.fin) {
+    bool do_flush = false;
+    uint64_t unflushed_events = 0;
+    for (auto& data : batch) {
+      if (data.le) {
+	LogEvent *le = data.le;
+	LogSegment *ls = le->_segment;
+	// encode it, with event type
+	bufferlist bl;
+	le->encode_with_header(bl, features);
+
+	uint64_t write_pos = journaler->get_write_pos();
+
+	le->set_start_off(write_pos);
+	if (dynamic_cast<SegmentBoundary*>(le)) {
+	  ls->offset = write_pos;
+	}
+
+	if (bl.length() >= event_large_threshold.load()) {
+	  dout(5) << "large event detected!" << dendl;
+	  logger->inc(l_mdl_evlrg);
+	}
+
+	dout(5) << "_submit_thread " << write_pos << "~" << bl.length()
+		<< " : " << *le << dendl;
+
+	// journal it.
+	const uint64_t new_write_pos = journaler->append_entry(bl);  // bl is destroyed.
+	ls->end = new_write_pos;
+
+	MDSLogContextBase *fin;
+	if (data.fin) {
+	  fin = dynamic_cast<MDSLogContextBase*>(data.fin);
+	  ceph_assert(fin);
+	  fin->set_write_pos(new_write_pos);
+	} else {
+	  fin = new C_MDL_Flushed(this, new_write_pos);
+	}
+
+	journaler->wait_for_flush(fin);
+
+	if (logger)
+	  logger->set(l_mdl_wrpos, ls->end);
+
+	delete le;
+      } else if (data.fin) {
 	Context* fin = dynamic_cast<Context*>(data.fin);
 	ceph_assert(fin);
 	C_MDL_Flushed *fin2 = new C_MDL_Flushed(this, fin);
 	fin2->set_write_pos(journaler->get_write_pos());
 	journaler->wait_for_flush(fin2);
       }
+
       if (data.flush)
-	journaler->flush();
+	do_flush = true;
+      else if (data.le)
+	unflushed_events++;
     }
 
+    // one flush covers the whole batch, including events queued behind
+    // the last flush request
+    if (do_flush)
+      journaler->flush();
+
     locker.lock();
-    if (data.flush)
+    if (do_flush)
       unflushed = 0;
-    else if (data.le)
-      unflushed++;
+    else
+      unflushed += unflushed_events;
   }
 }
 
@@ -992,10 +992,12 @@ void MDSDaemon::respawn()
 bool MDSDaemon::ms_dispatch2(const ref_t<Message> &m)
 {
   dout(25) << __func__ << ": processing " << m << dendl;
+  const auto wait_start = ceph::mono_clock::now();
   std::lock_guard l(mds_lock);
   if (stopping) {
     return false;
   }
+  const auto lock_start = ceph::mono_clock::now();
 
   // Drop out early if shutting down
   if (beacon.get_want_state() == CEPH_MDS_STATE_DNE) {
@@ -1011,7 +1013,14 @@ bool MDSDaemon::ms_dispatch2(const ref_t<Message> &m)
 
   // Not core, try it as a rank message
   if (mds_rank) {
-    return mds_rank->ms_dispatch(m);
+    const bool handled = mds_rank->ms_dispatch(m);
+    // how long messages queue behind mds_lock vs. how long handling holds it
+    if (mds_rank && mds_rank->logger) {
+      mds_rank->logger->tinc(l_mds_dispatch_lock_wait, lock_start - wait_start);
+      mds_rank->logger->tinc(l_mds_dispatch_lock_hold,
+                             ceph::mono_clock::now() - lock_start);
+    }
+    return handled;
   } else {
     return false;
   }
@@ -3733,6 +3733,10 @@ void MDSRank::create_logger()
     mds_plb.add_u64_counter(l_mds_traverse_lock, "traverse_lock",
                             "Traverse locks");
     mds_plb.add_u64(l_mds_dispatch_queue_len, "q", "Dispatch queue length");
+    mds_plb.add_time_avg(l_mds_dispatch_lock_wait, "dispatch_lock_wait",
+                         "Time a dispatched message waited for mds_lock");
+    mds_plb.add_time_avg(l_mds_dispatch_lock_hold, "dispatch_lock_hold",
+                         "Time mds_lock was held to handle a dispatched message");
     mds_plb.add_u64_counter(l_mds_exported, "exported", "Exports");
     mds_plb.add_u64_counter(l_mds_imported, "imported", "Imports");
     mds_plb.add_u64_counter(l_mds_openino_backtrace_fetch, "openino_backtrace_fetch",
@@ -4048,6 +4052,7 @@ const char** MDSRankDispatcher::get_tracked_conf_keys() const
     "mds_bal_fragment_fast_factor", \
     "mds_bal_fragment_interval", \
     "mds_bal_fragment_size_max", \
+    "mds_bal_import_hold_time", \
     "mds_bal_interval", \
     "mds_bal_max", \
     "mds_bal_max_until", \
@@ -4107,6 +4112,7 @@ const char** MDSRankDispatcher::get_tracked_conf_keys() const
     "mds_op_history_duration", \
     "mds_op_history_size", \
     "mds_op_log_threshold", \
+    "mds_readdir_prefetch_frags", \
     "mds_recall_max_decay_rate", \
     "mds_recall_warning_decay_rate", \
     "mds_request_load_average_decay_rate", \
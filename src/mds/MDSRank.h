@@ -80,6 +80,8 @@ enum {
   l_mds_traverse_lock,
   l_mds_load_cent,
   l_mds_dispatch_queue_len,
+  l_mds_dispatch_lock_wait,
+  l_mds_dispatch_lock_hold,
   l_mds_exported,
   l_mds_exported_inodes,
   l_mds_imported,
@@ -374,7 +374,7 @@ void PurgeQueue::push(const PurgeItem &pi, Context *completion)
   }
 }
 
-uint32_t PurgeQueue::_calculate_ops(const PurgeItem &item) const
+uint32_t PurgeQueue::_calculate_ops(const PurgeItem &item, bool concurrent) const
 {
   uint32_t ops_required = 0;
   if (item.action == PurgeItem::PURGE_DIR) {
@@ -388,8 +388,15 @@ uint32_t PurgeQueue::_calculate_ops(const PurgeItem &item) const
   } else {
     // File, work out concurrent Filer::purge deletes
     // Account for removing (or zeroing) backtrace
-    const uint64_t num = (item.size > 0) ?
+    uint64_t num = (item.size > 0) ?
       Striper::get_num_objects(item.layout, item.size) : 1;
+    // Filer::purge_range() keeps at most filer_max_purge_ops of the
+    // range in flight, so a large file shouldn't hold the whole op
+    // budget and stall the small files queued behind it
+    if (concurrent) {
+      num = std::min<uint64_t>(num, std::max<uint64_t>(
+        1, cct->_conf->filer_max_purge_ops));
+    }
 
     ops_required = num;
 
@@ -615,7 +622,8 @@ void PurgeQueue::_execute_item(
   files_high_water = std::max<uint64_t>(files_high_water,
                               in_flight.size());
   logger->set(l_pq_executing_high_water, files_high_water);
-  auto ops = _calculate_ops(item);
+  auto ops = _calculate_ops(item, true);
+  in_flight_ops[expire_to] = ops;
   ops_in_flight += ops;
   logger->set(l_pq_executing_ops, ops_in_flight);
   ops_high_water = std::max(ops_high_water, ops_in_flight);
@@ -679,6 +687,7 @@ void PurgeQueue::_execute_item(
     ops_high_water = std::max(ops_high_water, ops_in_flight);
     logger->set(l_pq_executing_ops_high_water, ops_high_water);
     in_flight.erase(expire_to);
+    in_flight_ops.erase(expire_to);
     logger->set(l_pq_executing, in_flight.size());
     files_high_water = std::max<uint64_t>(files_high_water,
                                 in_flight.size());
@@ -726,7 +735,10 @@ void PurgeQueue::_execute_item_complete(
   }
 
   auto executed_ops = _calculate_ops(iter->second);
-  ops_in_flight -= executed_ops;
+  auto charged = in_flight_ops.find(expire_to);
+  ceph_assert(charged != in_flight_ops.end());
+  ops_in_flight -= charged->second;
+  in_flight_ops.erase(charged);
   logger->set(l_pq_executing_ops, ops_in_flight);
   ops_high_water = std::max(ops_high_water, ops_in_flight);
   logger->set(l_pq_executing_ops_high_water, ops_high_water);
@@ -182,7 +182,8 @@ public:
   void handle_conf_change(const std::set<std::string>& changed, const MDSMap& mds_map);
 
 private:
-  uint32_t _calculate_ops(const PurgeItem &item) const;
+  // if concurrent, count only the ops an item can have in flight at once
+  uint32_t _calculate_ops(const PurgeItem &item, bool concurrent=false) const;
 
   bool _can_consume();
 
@@ -221,6 +222,8 @@ private:
 
   // Map of Journaler offset to PurgeItem
   std::map<uint64_t, PurgeItem> in_flight;
+  // ...and to what it was charged against max_purge_ops
+  std::map<uint64_t, uint32_t> in_flight_ops;
 
   std::set<uint64_t> pending_expire;
 
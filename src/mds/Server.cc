@@ -272,6 +272,7 @@ Server::Server(MDSRank *m, MetricsHandler *metrics_handler) :
   max_caps_throttle_ratio = g_conf().get_val<double>("mds_session_max_caps_throttle_ratio");
   caps_throttle_retry_request_timeout = g_conf().get_val<double>("mds_cap_acquisition_throttle_retry_request_timeout");
   dir_max_entries = g_conf().get_val<uint64_t>("mds_dir_max_entries");
+  readdir_prefetch_frags = g_conf().get_val<uint64_t>("mds_readdir_prefetch_frags");
   bal_fragment_size_max = g_conf().get_val<int64_t>("mds_bal_fragment_size_max");
   dispatch_client_request_delay = g_conf().get_val<std::chrono::milliseconds>("mds_server_dispatch_client_request_delay");
   dispatch_killpoint_random = g_conf().get_val<double>("mds_server_dispatch_killpoint_random");
@@ -1395,6 +1396,9 @@ void Server::handle_conf_change(const std::set<std::string>& changed) {
     dout(20) << __func__ << " max entries per directory changed to "
             << dir_max_entries << dendl;
   }
+  if (changed.count("mds_readdir_prefetch_frags")) {
+    readdir_prefetch_frags = g_conf().get_val<uint64_t>("mds_readdir_prefetch_frags");
+  }
   if (changed.count("mds_bal_fragment_size_max")) {
     bal_fragment_size_max = g_conf().get_val<int64_t>("mds_bal_fragment_size_max");
     dout(20) << __func__ << " max fragment size changed to "
@@ -4128,6 +4132,30 @@ CDir* Server::try_open_auth_dirfrag(CInode *diri, frag_t fg, const MDRequestRef&
   return dir;
 }
 
+/*
+ * start fetching the dirfrags that follow fg, so that a readdir moving on
+ * to them finds them complete (or at least already being fetched). no
+ * waiters are attached; a readdir that gets there first just waits on the
+ * fetch in flight.
+ */
+void Server::prefetch_next_dirfrags(CInode *diri, frag_t fg)
+{
+  for (uint64_t n = 0; n < readdir_prefetch_frags && !fg.is_rightmost(); ++n) {
+    fg = diri->dirfragtree[fg.next().value()];
+    CDir *dir = diri->get_dirfrag(fg);
+    if (!dir) {
+      if (!diri->is_auth() || diri->is_frozen())
+	return;
+      dir = diri->get_or_open_dirfrag(mdcache, fg);
+    }
+    if (!dir->is_auth() || dir->is_complete() ||
+	dir->state_test(CDir::STATE_FETCHING) || !dir->can_auth_pin())
+      continue;
+    dout(10) << __func__ << " " << *dir << dendl;
+    dir->fetch(nullptr);
+  }
+}
+
 
 // ===============================================================================
 // STAT
@@ -5014,6 +5042,8 @@ void Server::handle_client_readdir(const MDRequestRef& mdr)
     // fetch
     dout(10) << " incomplete dir contents for readdir on " << *dir << ", fetching" << dendl;
     dir->fetch(new C_MDS_RetryRequest(mdcache, mdr), true);
+    // the frags after this one are loaded in parallel with it
+    prefetch_next_dirfrags(diri, fg);
     return;
   }
 
@@ -5159,6 +5189,9 @@ void Server::handle_client_readdir(const MDRequestRef& mdr)
   if (req_flags & CEPH_READDIR_REPLY_BITFLAGS) {
     flags |= CEPH_READDIR_HASH_ORDER | CEPH_READDIR_OFFSET_HASH;
   }
+  // the client moves on to the next frag once this one is done
+  if (end)
+    prefetch_next_dirfrags(diri, dir->get_frag());
   _finalize_readdir(mdr, diri, dir, start, end, flags, numfiles, dirbl, dnbl);
 }
 
@@ -204,6 +204,7 @@ public:
 	    rdlock_two_paths_xlock_destdn(const MDRequestRef& mdr, bool xlock_srcdn);
 
   CDir* try_open_auth_dirfrag(CInode *diri, frag_t fg, const MDRequestRef& mdr);
+  void prefetch_next_dirfrags(CInode *diri, frag_t fg);
 
   // requests on existing inodes.
   void handle_client_getattr(const MDRequestRef& mdr, bool is_lookup);
@@ -553,6 +554,7 @@ private:
   uint64_t snapshot_name_max = NAME_MAX - 1 - 1 - 13;
   unsigned delegate_inos_pct = 0;
   uint64_t dir_max_entries = 0;
+  uint64_t readdir_prefetch_frags = 0;
   int64_t bal_fragment_size_max = 0;
 
   double inject_rename_corrupt_dentry_first = 0.0;
@@ -143,7 +143,7 @@ public:
   MOSDOpReply(const MOSDOp *req, int r, epoch_t e, int acktype,
 	      bool ignore_out_data)
     : Message{CEPH_MSG_OSD_OPREPLY, HEAD_VERSION, COMPAT_VERSION},
-      oid(req->hobj.oid), pgid(req->pgid.pgid), ops(req->ops),
+      oid(req->hobj.oid), pgid(req->pgid.pgid),
       bdata_encode(false) {
 
     set_tid(req->get_tid());
@@ -155,12 +155,15 @@ public:
     retry_attempt = req->get_retry_attempt();
     do_redirect = false;
 
+    // the reply carries no input data, and output data only if the request
+    // asked for it (RETURNVEC); don't copy the bufferlists just to clear
+    // them again, every copy allocates a node per buffer
+    ops.resize(req->ops.size());
     for (unsigned i = 0; i < ops.size(); i++) {
-      // zero out input data
-      ops[i].indata.clear();
-      if (ignore_out_data) {
-	// original request didn't set the RETURNVEC flag
-	ops[i].outdata.clear();
+      ops[i].op = req->ops[i].op;
+      ops[i].rval = req->ops[i].rval;
+      if (!ignore_out_data) {
+	ops[i].outdata = req->ops[i].outdata;
       }
     }
   }
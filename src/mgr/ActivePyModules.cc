@@ -515,6 +515,55 @@ PyObject *ActivePyModules::get_python(const std::string &what)
       const auto num_pg = pg_map.num_pg;
       f.dump_unsigned("total_num_pgs", num_pg);
     });
+  } else if (what == "pg_stats_columnar") {
+    // one packed array per field instead of a dict per pg; python reads
+    // them with memoryview(...).cast() without creating an object per pg
+    without_gil_t no_gil;
+    std::vector<int64_t> pool, num_bytes, num_objects;
+    std::vector<uint32_t> seed, reported_epoch;
+    std::vector<uint64_t> state;
+    std::vector<int32_t> up_primary, acting_primary;
+    cluster_state.with_pgmap([&](const PGMap &pg_map) {
+      const auto n = pg_map.pg_stat.size();
+      pool.reserve(n);
+      seed.reserve(n);
+      state.reserve(n);
+      reported_epoch.reserve(n);
+      up_primary.reserve(n);
+      acting_primary.reserve(n);
+      num_bytes.reserve(n);
+      num_objects.reserve(n);
+      for (const auto &[pgid, s] : pg_map.pg_stat) {
+	pool.push_back(pgid.pool());
+	seed.push_back(pgid.ps());
+	state.push_back(s.state);
+	reported_epoch.push_back(s.reported_epoch);
+	up_primary.push_back(s.up_primary);
+	acting_primary.push_back(s.acting_primary);
+	num_bytes.push_back(s.stats.sum.num_bytes);
+	num_objects.push_back(s.stats.sum.num_objects);
+      }
+    });
+    no_gil.acquire_gil();
+    PyObject *d = PyDict_New();
+    auto add_column = [d](const char *name, const auto &v) {
+      PyObject *b = PyBytes_FromStringAndSize(
+	reinterpret_cast<const char*>(v.data()), v.size() * sizeof(v[0]));
+      PyDict_SetItemString(d, name, b);
+      Py_DECREF(b);
+    };
+    add_column("pool", pool);
+    add_column("seed", seed);
+    add_column("state", state);
+    add_column("reported_epoch", reported_epoch);
+    add_column("up_primary", up_primary);
+    add_column("acting_primary", acting_primary);
+    add_column("num_bytes", num_bytes);
+    add_column("num_objects", num_objects);
+    PyObject *num_pgs = PyLong_FromSize_t(pool.size());
+    PyDict_SetItemString(d, "num_pgs", num_pgs);
+    Py_DECREF(num_pgs);
+    return d;
   } else {
     derr << "Python module requested unknown data '" << what << "'" << dendl;
     Py_RETURN_NONE;
@@ -19,7 +19,8 @@ template <class Key, class Value> class Cache {
   unsigned int capacity;
   Cache(unsigned int size = UINT16_MAX) : hits{0}, misses{0}, capacity{size} {};
   std::map<Key, Value> content;
-  std::vector<std::string> allowed_keys = {"osd_map", "pg_dump", "pg_stats"};
+  std::vector<std::string> allowed_keys = {"osd_map", "pg_dump", "pg_stats",
+                                           "pg_stats_columnar"};
 
   void mark_miss() {
     misses++;
@@ -792,6 +792,7 @@ void OSDMonitor::update_from_paxos(bool *need_bootstrap)
     dout(7) << __func__ << " loading latest full map e" << latest_full << dendl;
     osdmap = OSDMap();
     osdmap.decode(latest_bl);
+    mapping_full = true;
   }
 
   bufferlist bl;
@@ -832,6 +833,9 @@ void OSDMonitor::update_from_paxos(bool *need_bootstrap)
     OSDMap::Incremental inc(inc_bl);
     err = osdmap.apply_incremental(inc);
     ceph_assert(err == 0);
+    if (!mapping_full && !inc.get_pg_local_changes(&mapping_pgs)) {
+      mapping_full = true;
+    }
 
     if (!t)
       t.reset(new MonitorDBStore::Transaction);
@@ -1077,14 +1081,28 @@ void OSDMonitor::start_mapping()
   }
   if (!osdmap.get_pools().empty()) {
     auto fin = new C_UpdateCreatingPGs(this, osdmap.get_epoch());
-    mapping_job = mapping.start_update(osdmap, mapper,
-				       g_conf()->mon_osd_mapping_pgs_per_chunk);
+    // if the last job completed and nothing since then could move more
+    // than a known set of pgs (pg_temp/upmap only), remap just those
+    if (!mapping_full && mapping.get_epoch() == mapping_pgs_since) {
+      dout(10) << __func__ << " remapping " << mapping_pgs.size()
+	       << " pgs changed since e" << mapping_pgs_since << dendl;
+      mapping_job = mapping.start_update(
+	osdmap, mapper, g_conf()->mon_osd_mapping_pgs_per_chunk,
+	std::vector<pg_t>(mapping_pgs.begin(), mapping_pgs.end()));
+    } else {
+      mapping_job = mapping.start_update(
+	osdmap, mapper, g_conf()->mon_osd_mapping_pgs_per_chunk);
+    }
+    mapping_full = false;
+    mapping_pgs.clear();
+    mapping_pgs_since = osdmap.get_epoch();
     dout(10) << __func__ << " started mapping job " << mapping_job.get()
 	     << " at " << fin->start << dendl;
     mapping_job->set_finish_event(fin);
   } else {
     dout(10) << __func__ << " no pools, no mapping job" << dendl;
     mapping_job = nullptr;
+    mapping_full = true;
   }
 }
 
@@ -3237,6 +3255,33 @@ utime_t OSDMonitor::get_grace_time(utime_t now,
   return grace;
 }
 
+const std::string& OSDMonitor::get_reporter_subtree(int reporter,
+						    const std::string& level)
+{
+  // every report for a target re-counts all of its reporters; during a
+  // partition that is O(reporters^2) crush location lookups per target
+  // unless we remember them for the current map.
+  if (reporter_subtree_cache_epoch != osdmap.get_epoch() ||
+      reporter_subtree_cache_level != level) {
+    reporter_subtree_cache.clear();
+    reporter_subtree_cache_epoch = osdmap.get_epoch();
+    reporter_subtree_cache_level = level;
+  }
+  auto [it, inserted] = reporter_subtree_cache.try_emplace(reporter);
+  if (inserted) {
+    // get the parent bucket whose type matches with "reporter_subtree_level".
+    // fall back to OSD if the level doesn't exist.
+    auto reporter_loc = osdmap.crush->get_full_location(reporter);
+    if (auto iter = reporter_loc.find(level);
+	iter == reporter_loc.end()) {
+      it->second = "osd." + to_string(reporter);
+    } else {
+      it->second = iter->second;
+    }
+  }
+  return it->second;
+}
+
 bool OSDMonitor::check_failure(utime_t now, int target_osd, failure_info_t& fi)
 {
   // already pending failure?
@@ -3250,16 +3295,9 @@ bool OSDMonitor::check_failure(utime_t now, int target_osd, failure_info_t& fi)
   auto reporter_subtree_level = g_conf().get_val<string>("mon_osd_reporter_subtree_level");
   ceph_assert(fi.reporters.size());
   for (auto p = fi.reporters.begin(); p != fi.reporters.end();) {
-    // get the parent bucket whose type matches with "reporter_subtree_level".
-    // fall back to OSD if the level doesn't exist.
     if (osdmap.exists(p->first)) {
-      auto reporter_loc = osdmap.crush->get_full_location(p->first);
-      if (auto iter = reporter_loc.find(reporter_subtree_level);
-          iter == reporter_loc.end()) {
-        reporters_by_subtree.insert("osd." + to_string(p->first));
-      } else {
-        reporters_by_subtree.insert(iter->second);
-      }
+      reporters_by_subtree.insert(
+	get_reporter_subtree(p->first, reporter_subtree_level));
       ++p;
     } else {
       fi.cancel_report(p->first);;
@@ -4446,7 +4484,8 @@ MOSDMap *OSDMonitor::build_latest_full(uint64_t features)
   return r;
 }
 
-MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to, uint64_t features)
+MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to, uint64_t features,
+				       ssize_t max_bytes)
 {
   dout(10) << "build_incremental [" << from << ".." << to << "] with features "
 	   << std::hex << features << std::dec << dendl;
@@ -4454,7 +4493,12 @@ MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to, uint64_t featur
   m->cluster_osdmap_trim_lower_bound = get_first_committed();
   m->newest_map = osdmap.get_epoch();
 
-  for (epoch_t e = to; e >= from && e > 0; e--) {
+  // with a byte budget, stop after the map that exhausts it; the caller
+  // picks up from m->get_last() + 1
+  ssize_t left = max_bytes;
+  for (epoch_t e = std::max<epoch_t>(from, 1); e <= to; e++) {
+    if (max_bytes > 0 && left <= 0)
+      break;
     bufferlist bl;
     int err = get_version(e, features, bl);
     if (err == 0) {
@@ -4462,6 +4506,7 @@ MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to, uint64_t featur
       // if (get_version(e, bl) > 0) {
       dout(20) << "build_incremental    inc " << e << " "
 	       << bl.length() << " bytes" << dendl;
+      left -= bl.length();
       m->incremental_maps[e] = bl;
     } else {
       ceph_assert(err == -ENOENT);
@@ -4471,6 +4516,7 @@ MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to, uint64_t featur
       //else if (get_version("full", e, bl) > 0) {
       dout(20) << "build_incremental   full " << e << " "
 	       << bl.length() << " bytes" << dendl;
+      left -= bl.length();
       m->maps[e] = bl;
       } else {
 	ceph_abort();  // we should have all maps.
@@ -4555,7 +4601,9 @@ void OSDMonitor::send_incremental(epoch_t first,
   while (first <= osdmap.get_epoch()) {
     epoch_t last = std::min<epoch_t>(first + g_conf()->osd_map_message_max - 1,
 				     osdmap.get_epoch());
-    MOSDMap *m = build_incremental(first, last, features);
+    MOSDMap *m = build_incremental(first, last, features,
+				   g_conf()->osd_map_message_max_bytes);
+    last = m->get_last();
 
     if (req) {
       // send some maps.  it may not be all of them, but it will get them
@@ -9051,6 +9099,16 @@ int OSDMonitor::prepare_command_pool_set(const cmdmap_t& cmdmap,
         ss << "read_ratio must be between 0 and 100";
         return -ERANGE;
       }
+    } else if (var == "qos_reservation" || var == "qos_weight" ||
+	       var == "qos_limit") {
+      if (interr.length()) {
+        ss << "error parsing int value '" << val << "': " << interr;
+        return -EINVAL;
+      }
+      if (n < 0) {
+        ss << var << " must be >= 0";
+        return -ERANGE;
+      }
     }
 
     pool_opts_t::opt_desc_t desc = pool_opts_t::get_opt_desc(var);
@@ -14910,7 +14968,7 @@ int OSDMonitor::_prepare_remove_pool(
     }
   }
   // remove any pg_upmap mappings for this pool
-  for (auto& p : osdmap.pg_upmap) {
+  for (auto& p : *osdmap.pg_upmap) {
     if (p.first.pool() == pool) {
       dout(10) << __func__ << " " << pool
                << " removing obsolete pg_upmap "
@@ -14933,7 +14991,7 @@ int OSDMonitor::_prepare_remove_pool(
     }
   }
   // remove any pg_upmap_items mappings for this pool
-  for (auto& p : osdmap.pg_upmap_items) {
+  for (auto& p : *osdmap.pg_upmap_items) {
     if (p.first.pool() == pool) {
       dout(10) << __func__ << " " << pool
                << " removing obsolete pg_upmap_items " << p.first
@@ -221,6 +221,11 @@ public:
   std::map<int, ceph::buffer::list> pending_metadata;
   std::set<int>             pending_metadata_rm;
   std::map<int, failure_info_t> failure_info;
+  // reporter osd -> its mon_osd_reporter_subtree_level bucket, valid for
+  // reporter_subtree_cache_epoch/level only
+  std::map<int, std::string> reporter_subtree_cache;
+  epoch_t reporter_subtree_cache_epoch = 0;
+  std::string reporter_subtree_cache_level;
   std::map<int,utime_t>    down_pending_out;  // osd down -> out
   bool priority_convert = false;
   std::shared_ptr<PriorityCache::PriCache> rocksdb_binned_kv_cache = nullptr;
@@ -242,6 +247,7 @@ public:
 
   bool check_failures(utime_t now);
   bool check_failure(utime_t now, int target_osd, failure_info_t& fi);
+  const std::string& get_reporter_subtree(int reporter, const std::string& level);
   utime_t get_grace_time(utime_t now, int target_osd, failure_info_t& fi) const;
   bool is_failure_stale(utime_t now, failure_info_t& fi) const;
   void force_failure(int target_osd, int by);
@@ -389,6 +395,9 @@ private:
   ParallelPGMapper mapper;                        ///< for background pg work
   OSDMapMapping mapping;                          ///< pg <-> osd mappings
   std::unique_ptr<ParallelPGMapper::Job> mapping_job;  ///< background mapping job
+  bool mapping_full = true;        ///< next mapping job must remap every pg
+  std::set<pg_t> mapping_pgs;      ///< pgs changed since mapping_pgs_since
+  epoch_t mapping_pgs_since = 0;   ///< epoch the last mapping job targeted
   void start_mapping();
 
   void update_logger();
@@ -407,7 +416,8 @@ private:
 
   // ...
   MOSDMap *build_latest_full(uint64_t features);
-  MOSDMap *build_incremental(epoch_t first, epoch_t last, uint64_t features);
+  MOSDMap *build_incremental(epoch_t first, epoch_t last, uint64_t features,
+			     ssize_t max_bytes = 0);
   void send_full(MonOpRequestRef op);
   void send_incremental(MonOpRequestRef op, epoch_t first);
 
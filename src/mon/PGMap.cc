@@ -1132,7 +1132,12 @@ void PGMap::apply_incremental(CephContext *cct, const Incremental& inc)
     pool_stat_t &pool_sum_ref = pg_pool_sum[update_pool];
     if (pg_stat_iter == pg_stat.end()) {
       pg_stat.insert(make_pair(update_pg, update_stat));
+      purged_snaps_dirty_pools.insert(update_pool);
     } else {
+      if ((pg_stat_iter->second.state == 0) != (update_stat.state == 0) ||
+	  pg_stat_iter->second.purged_snaps != update_stat.purged_snaps) {
+	purged_snaps_dirty_pools.insert(update_pool);
+      }
       stat_pg_sub(update_pg, pg_stat_iter->second);
       pool_sum_ref.sub(pg_stat_iter->second);
       pg_stat_iter->second = update_stat;
@@ -1194,6 +1199,7 @@ void PGMap::apply_incremental(CephContext *cct, const Incremental& inc)
       }
 
       pg_stat.erase(s);
+      purged_snaps_dirty_pools.insert(removed_pg.pool());
       if (pool_erased) {
         deleted_pools.insert(removed_pg.pool());
       }
@@ -1268,6 +1274,7 @@ void PGMap::calc_stats()
   num_pg_by_state.clear();
   num_pg_by_pool_state.clear();
   num_pg_by_osd.clear();
+  purged_snaps_all_dirty = true;
 
   for (auto p = pg_stat.begin();
        p != pg_stat.end();
@@ -1425,9 +1432,24 @@ bool PGMap::stat_pg_sub(const pg_t &pgid, const pg_stat_t &s,
 
 void PGMap::calc_purged_snaps()
 {
-  purged_snaps.clear();
+  // most stat updates leave purged_snaps alone; only revisit the pools
+  // whose pgs changed it (or came, went, or became unknown)
+  if (!purged_snaps_all_dirty && purged_snaps_dirty_pools.empty()) {
+    return;
+  }
+  if (purged_snaps_all_dirty) {
+    purged_snaps.clear();
+  } else {
+    for (auto pool : purged_snaps_dirty_pools) {
+      purged_snaps.erase(pool);
+    }
+  }
   set<int64_t> unknown;
   for (auto& i : pg_stat) {
+    if (!purged_snaps_all_dirty &&
+	!purged_snaps_dirty_pools.count(i.first.pool())) {
+      continue;
+    }
     if (i.second.state == 0) {
       unknown.insert(i.first.pool());
       purged_snaps.erase(i.first.pool());
@@ -1443,6 +1465,8 @@ void PGMap::calc_purged_snaps()
       j->second.intersection_of(i.second.purged_snaps);
     }
   }
+  purged_snaps_all_dirty = false;
+  purged_snaps_dirty_pools.clear();
 }
 
 void PGMap::calc_osd_sum_by_class(const OSDMap& osdmap)
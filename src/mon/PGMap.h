@@ -319,6 +319,10 @@ public:
   mempool::pgmap::list<std::pair<pool_stat_t, utime_t> > pg_sum_deltas;
   mempool::pgmap::unordered_map<int64_t,mempool::pgmap::unordered_map<uint64_t,int32_t>> num_pg_by_pool_state;
 
+  // pools whose purged_snaps calc_purged_snaps() must recompute
+  mempool::pgmap::set<int64_t> purged_snaps_dirty_pools;
+  bool purged_snaps_all_dirty = true;
+
   utime_t stamp;
 
   void update_pool_deltas(
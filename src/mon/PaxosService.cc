@@ -196,6 +196,24 @@ bool PaxosService::should_propose(double& delay)
 void PaxosService::propose_pending()
 {
   dout(10) << __func__ << dendl;
+  queue_pending();
+
+  // any other service already waiting on its proposal_timer would only
+  // go through a round of its own right after ours; fold its pending
+  // value into this transaction instead.
+  for (auto& svc : mon.paxos_service) {
+    if (svc.get() != this && svc->proposal_timer &&
+	svc->have_pending && svc->is_active()) {
+      dout(10) << __func__ << " piggybacking " << svc->get_service_name() << dendl;
+      svc->queue_pending();
+    }
+  }
+
+  paxos.trigger_propose();
+}
+
+void PaxosService::queue_pending()
+{
   ceph_assert(have_pending);
   ceph_assert(!proposing);
   ceph_assert(mon.is_leader());
@@ -256,7 +274,6 @@ void PaxosService::propose_pending()
     }
   };
   paxos.queue_pending_finisher(new C_Committed(this));
-  paxos.trigger_propose();
 }
 
 bool PaxosService::should_stash_full()
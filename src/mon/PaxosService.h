@@ -212,6 +212,12 @@ private:
    */
   void _active();
 
+  /**
+   * Encode our pending value into the pending Paxos transaction, without
+   * triggering the proposal.
+   */
+  void queue_pending();
+
 public:
   /**
    * Propose a new value through Paxos.
@@ -16,6 +16,7 @@
 #include "DispatchQueue.h"
 #include "Messenger.h"
 #include "common/ceph_context.h"
+#include "common/perf_counters.h"
 
 #define dout_subsys ceph_subsys_ms
 #include "common/debug.h"
@@ -38,6 +39,42 @@ double DispatchQueue::get_max_age(utime_t now) const {
     return (now - *marrival.begin());
 }
 
+void DispatchQueue::create_logger(const std::string& name)
+{
+  // same axes as the messenger workers' histograms
+  PerfHistogramCommon::axis_config_d lat_axis{
+    "Latency (usec)",
+    PerfHistogramCommon::SCALE_LOG2,
+    0,
+    10000,
+    24,
+  };
+  PerfHistogramCommon::axis_config_d size_axis{
+    "Message size (bytes)",
+    PerfHistogramCommon::SCALE_LOG2,
+    0,
+    512,
+    20,
+  };
+  PerfCountersBuilder plb(cct, "msgr_dispatch_queue-" + name,
+                          l_dispatch_queue_first, l_dispatch_queue_last);
+  plb.add_time_avg(l_dispatch_queue_wait_lat, "wait_lat",
+                   "Time messages waited in the dispatch queue");
+  plb.add_u64_counter_histogram(
+    l_dispatch_queue_wait_lat_histogram, "wait_lat_histogram",
+    lat_axis, size_axis,
+    "Histogram of time messages waited in the dispatch queue");
+  logger = plb.create_perf_counters();
+  cct->get_perfcounters_collection()->add(logger);
+}
+
+void DispatchQueue::destroy_logger()
+{
+  cct->get_perfcounters_collection()->remove(logger);
+  delete logger;
+  logger = nullptr;
+}
+
 uint64_t DispatchQueue::pre_dispatch(const ref_t<Message>& m)
 {
   ldout(cct,1) << "<== " << m->get_source_inst()
@@ -198,6 +235,12 @@ void DispatchQueue::entry()
 	if (stop) {
 	  ldout(cct,10) << " stop flag set, discarding " << m << " " << *m << dendl;
 	} else {
+	  if (m->get_recv_complete_stamp() != utime_t()) {
+	    auto waited = ceph_clock_now() - m->get_recv_complete_stamp();
+	    logger->tinc(l_dispatch_queue_wait_lat, waited);
+	    logger->hinc(l_dispatch_queue_wait_lat_histogram, waited.to_nsec(),
+			 m->get_payload().length() + m->get_data().length());
+	  }
 	  uint64_t msize = pre_dispatch(m);
 	  msgr->ms_deliver_dispatch(m);
 	  post_dispatch(m, msize);
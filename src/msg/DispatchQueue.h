@@ -31,6 +31,13 @@
 class Messenger;
 struct Connection;
 
+enum {
+  l_dispatch_queue_first = 96000,
+  l_dispatch_queue_wait_lat,
+  l_dispatch_queue_wait_lat_histogram,
+  l_dispatch_queue_last,
+};
+
 /**
  * The DispatchQueue contains all the connections which have Messages
  * they want to be dispatched, carefully organized by Message priority
@@ -120,6 +127,10 @@ class DispatchQueue {
   uint64_t pre_dispatch(const ceph::ref_t<Message>& m);
   void post_dispatch(const ceph::ref_t<Message>& m, uint64_t msize);
 
+  PerfCounters *logger = nullptr;
+  void create_logger(const std::string& name);
+  void destroy_logger();
+
  public:
 
   /// Throttle preventing us from building up a big backlog waiting for dispatch
@@ -231,11 +242,14 @@ class DispatchQueue {
       dispatch_throttler(cct, std::string("msgr_dispatch_throttler-") + name,
                          cct->_conf->ms_dispatch_throttle_bytes),
       stop(false)
-    {}
+    {
+      create_logger(name);
+    }
   ~DispatchQueue() {
     ceph_assert(mqueue.empty());
     ceph_assert(marrival.empty());
     ceph_assert(local_messages.empty());
+    destroy_logger();
   }
 };
 
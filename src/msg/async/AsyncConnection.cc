@@ -333,7 +333,10 @@ ssize_t AsyncConnection::_try_send(bool more)
   // like do not call cs.send() and r = 0
   ssize_t r = 0;
   if (likely(!inject_network_congestion())) {
+    cs.set_zerocopy(async_msgr->get_zerocopy_min_bytes(peer_type));
     r = cs.send(outgoing_bl, more);
+    ++send_syscalls;
+    logger->inc(l_msgr_send_syscalls);
   }
   if (r < 0) {
     ldout(async_msgr->cct, 1) << __func__ << " send error: " << cpp_strerror(r) << dendl;
@@ -381,6 +384,12 @@ void AsyncConnection::process() {
 
   ldout(async_msgr->cct, 20) << __func__ << dendl;
 
+  if (cs) {
+    // completions of zerocopy sends arrive on the socket error queue, which
+    // keeps the socket readable until they are collected
+    cs.reap_send_completions();
+  }
+
   switch (state) {
     case STATE_NONE: {
       ldout(async_msgr->cct, 20) << __func__ << " enter none state" << dendl;
@@ -621,6 +630,8 @@ void AsyncConnection::fault()
 }
 
 void AsyncConnection::_stop() {
+  ldout(async_msgr->cct, 10) << __func__ << " issued " << send_syscalls
+                             << " socket sends" << dendl;
   writeCallback = {};
   dispatch_queue->discard_queue(conn_id);
   async_msgr->unregister_conn(this);
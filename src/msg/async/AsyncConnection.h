@@ -186,6 +186,7 @@ private:
   // lockfree, only used in own thread
   ceph::buffer::list outgoing_bl;
   bool open_write = false;
+  uint64_t send_syscalls = 0;  ///< socket sends issued on this connection
 
   std::mutex write_lock;
 
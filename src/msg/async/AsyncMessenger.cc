@@ -24,6 +24,8 @@
 #include "common/config.h"
 #include "common/Timer.h"
 #include "common/errno.h"
+#include "common/entity_name.h"
+#include "include/str_list.h"
 
 #include "messages/MOSDOp.h"
 #include "messages/MOSDOpReply.h"
@@ -304,6 +306,21 @@ AsyncMessenger::AsyncMessenger(CephContext *cct, entity_name_t name,
     processor_num = stack->get_num_worker();
   for (unsigned i = 0; i < processor_num; ++i)
     processors.push_back(new Processor(this, stack->get_worker(i), cct));
+
+  zerocopy_min_bytes = cct->_conf.get_val<Option::size_t>(
+    "ms_tcp_zerocopy_min_size");
+  std::vector<std::string> zerocopy_types;
+  get_str_vec(cct->_conf.get_val<std::string>("ms_tcp_zerocopy_peer_types"),
+              ",", zerocopy_types);
+  for (const auto& t : zerocopy_types) {
+    auto type = EntityName::str_to_ceph_entity_type(t);
+    if (type == CEPH_ENTITY_TYPE_ANY) {
+      lderr(cct) << __func__ << " ignoring unknown peer type '" << t
+                 << "' in ms_tcp_zerocopy_peer_types" << dendl;
+      continue;
+    }
+    zerocopy_peer_types.insert(type);
+  }
 }
 
 /**
@@ -18,6 +18,7 @@
 #define CEPH_ASYNCMESSENGER_H
 
 #include <map>
+#include <set>
 #include <optional>
 
 #include "include/types.h"
@@ -221,6 +222,9 @@ private:
 
   std::string ms_type;
 
+  uint64_t zerocopy_min_bytes = 0;
+  std::set<int> zerocopy_peer_types;
+
   /// overall lock used for AsyncMessenger data structures
   ceph::mutex lock = ceph::make_mutex("AsyncMessenger::lock");
   // AsyncMessenger stuff
@@ -364,6 +368,12 @@ public:
     return stack;
   }
 
+  /// ms_tcp_zerocopy_min_size if connections to this peer type may use
+  /// zerocopy sends, 0 otherwise
+  uint64_t get_zerocopy_min_bytes(int peer_type) const {
+    return zerocopy_peer_types.count(peer_type) ? zerocopy_min_bytes : 0;
+  }
+
   uint64_t get_nonce() const {
     return nonce;
   }
@@ -21,6 +21,11 @@
 #include <errno.h>
 
 #include <algorithm>
+#include <deque>
+
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif
 
 #include "PosixStack.h"
 
@@ -37,12 +42,45 @@
 #undef dout_prefix
 #define dout_prefix *_dout << "PosixStack "
 
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define HAVE_MSG_ZEROCOPY
+#endif
+
 class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
   ceph::NetHandler &handler;
   int _fd;
   entity_addr_t sa;
   bool connected;
 
+#ifdef HAVE_MSG_ZEROCOPY
+  /// sends of at least this many bytes use MSG_ZEROCOPY; 0 disables it
+  uint64_t zerocopy_min_bytes = 0;
+  bool zerocopy_enabled = false;  ///< SO_ZEROCOPY is set on the socket
+  bool zerocopy_failed = false;   ///< unsupported, or the kernel copied anyway
+  /// id the kernel gives the next successful MSG_ZEROCOPY sendmsg()
+  uint32_t zerocopy_next_id = 0;
+  struct zerocopy_send_t {
+    uint32_t first_id;
+    uint32_t num_ids;
+    uint32_t pending;
+    ceph::buffer::list bl;
+  };
+  /// data the kernel transmits by reference; kept until it reports completion
+  std::deque<zerocopy_send_t> zerocopy_inflight;
+
+  void complete_zerocopy(uint32_t lo, uint32_t hi) {
+    for (auto& z : zerocopy_inflight) {
+      for (uint32_t i = 0; i < z.num_ids; ++i) {
+        if (static_cast<uint32_t>(z.first_id + i - lo) <= hi - lo) {
+          --z.pending;
+        }
+      }
+    }
+    std::erase_if(zerocopy_inflight,
+                  [](const auto& z) { return z.pending == 0; });
+  }
+#endif
+
  public:
   explicit PosixConnectedSocketImpl(ceph::NetHandler &h, const entity_addr_t &sa,
 				    int f, bool connected)
@@ -77,23 +115,32 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
   // return the sent length
   // < 0 means error occurred
   #ifndef _WIN32
-  static ssize_t do_sendmsg(int fd, struct msghdr &msg, unsigned len, bool more)
+  // *zerocopy_calls counts the sendmsg() calls that went out with MSG_ZEROCOPY
+  static ssize_t do_sendmsg(int fd, struct msghdr &msg, unsigned len, bool more,
+                            int zerocopy, unsigned *zerocopy_calls)
   {
     size_t sent = 0;
     while (1) {
       MSGR_SIGPIPE_STOPPER;
       ssize_t r;
-      r = ::sendmsg(fd, &msg, MSG_NOSIGNAL | (more ? MSG_MORE : 0));
+      r = ::sendmsg(fd, &msg, MSG_NOSIGNAL | (more ? MSG_MORE : 0) | zerocopy);
       if (r < 0) {
         int err = ceph_sock_errno();
         if (err == EINTR) {
           continue;
         } else if (err == EAGAIN) {
           break;
+        } else if (err == ENOBUFS && zerocopy) {
+          // out of memory to track zerocopy sends; copy this time
+          zerocopy = 0;
+          continue;
         }
         return -err;
       }
 
+      if (zerocopy && r > 0) {
+        ++*zerocopy_calls;
+      }
       sent += r;
       if (len == sent) break;
 
@@ -115,6 +162,14 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
 
   ssize_t send(ceph::buffer::list &bl, bool more) override {
     size_t sent_bytes = 0;
+    int zerocopy = 0;
+    unsigned zerocopy_calls = 0;
+#ifdef HAVE_MSG_ZEROCOPY
+    if (zerocopy_enabled && !zerocopy_failed && zerocopy_min_bytes &&
+        bl.length() >= zerocopy_min_bytes) {
+      zerocopy = MSG_ZEROCOPY;
+    }
+#endif
     auto pb = std::cbegin(bl.buffers());
     uint64_t left_pbrs = bl.get_num_buffers();
     while (left_pbrs) {
@@ -133,7 +188,8 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
 	msglen += pb->length();
 	++pb;
       }
-      ssize_t r = do_sendmsg(_fd, msg, msglen, left_pbrs || more);
+      ssize_t r = do_sendmsg(_fd, msg, msglen, left_pbrs || more, zerocopy,
+                             &zerocopy_calls);
       if (r < 0)
         return r;
 
@@ -150,12 +206,65 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
         bl.splice(sent_bytes, bl.length()-sent_bytes, &swapped);
         bl.swap(swapped);
       } else {
-        bl.clear();
+        swapped.swap(bl);
+      }
+#ifdef HAVE_MSG_ZEROCOPY
+      // "swapped" now holds what was sent
+      if (zerocopy_calls) {
+        zerocopy_inflight.push_back({zerocopy_next_id, zerocopy_calls,
+                                     zerocopy_calls, std::move(swapped)});
+        zerocopy_next_id += zerocopy_calls;
       }
+#endif
     }
 
     return static_cast<ssize_t>(sent_bytes);
   }
+
+  void set_zerocopy(uint64_t min_bytes) override {
+#ifdef HAVE_MSG_ZEROCOPY
+    if (min_bytes && !zerocopy_enabled && !zerocopy_failed) {
+      int on = 1;
+      if (::setsockopt(_fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) < 0) {
+        zerocopy_failed = true;
+      } else {
+        zerocopy_enabled = true;
+      }
+    }
+    zerocopy_min_bytes = min_bytes;
+#endif
+  }
+
+  void reap_send_completions() override {
+#ifdef HAVE_MSG_ZEROCOPY
+    while (!zerocopy_inflight.empty()) {
+      char control[128];
+      struct msghdr msg;
+      memset(&msg, 0, sizeof(msg));
+      msg.msg_control = control;
+      msg.msg_controllen = sizeof(control);
+      if (::recvmsg(_fd, &msg, MSG_ERRQUEUE) < 0) {
+        break;
+      }
+      for (auto cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+        if (!(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) &&
+            !(cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)) {
+          continue;
+        }
+        auto serr = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cm));
+        if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+          continue;
+        }
+        if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+          // the route cannot do zerocopy (e.g. loopback); the pinning and
+          // notifications only cost us from here on
+          zerocopy_failed = true;
+        }
+        complete_zerocopy(serr->ee_info, serr->ee_data);
+      }
+    }
+#endif
+  }
   #else
   ssize_t send(bufferlist &bl, bool more) override
   {
@@ -346,8 +346,12 @@ void ProtocolV1::write_event() {
       }
 
       if (m->queue_start != ceph::mono_time()) {
-        connection->logger->tinc(l_msgr_send_messages_queue_lat,
-				 ceph::mono_clock::now() - m->queue_start);
+        auto queued = ceph::mono_clock::now() - m->queue_start;
+        connection->logger->tinc(l_msgr_send_messages_queue_lat, queued);
+        connection->logger->hinc(
+          l_msgr_send_messages_queue_lat_histogram,
+          std::chrono::nanoseconds(queued).count(),
+          m->get_payload().length() + m->get_data().length());
       }
 
       r = write_message(m, data, more);
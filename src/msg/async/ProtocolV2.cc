@@ -2,6 +2,7 @@
 // vim: ts=8 sw=2 smarttab
 
 #include <type_traits>
+#include <climits>
 
 #include "ProtocolV2.h"
 #include "AsyncMessenger.h"
@@ -560,6 +561,13 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
                  << " off=" << header2.data_off
                  << dendl;
   ssize_t total_send_size = connection->outgoing_bl.length();
+  if (more && should_coalesce()) {
+    // write_event() flushes whatever is still queued once the send queue
+    // runs dry, so this frame goes out together with the next ones
+    connection->logger->inc(l_msgr_send_coalesced_messages);
+    m->put();
+    return 0;
+  }
   ssize_t rc = connection->_try_send(more);
   if (rc < 0) {
     ldout(cct, 1) << __func__ << " error sending " << m << ", "
@@ -585,6 +593,12 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
   return rc;
 }
 
+bool ProtocolV2::should_coalesce() const {
+  const auto max_bytes = cct->_conf->ms_async_coalesce_max_bytes;
+  return max_bytes && connection->outgoing_bl.length() < max_bytes &&
+    connection->outgoing_bl.get_num_buffers() < IOV_MAX;
+}
+
 template <class F>
 bool ProtocolV2::append_frame(F& frame) {
   ceph::bufferlist bl;
@@ -659,7 +673,7 @@ void ProtocolV2::write_event() {
     auto start = ceph::mono_clock::now();
     bool more;
     do {
-      if (connection->is_queued()) {
+      if (connection->is_queued() && !should_coalesce()) {
 	if (r = connection->_try_send(); r!= 0) {
 	  // either fails to send or not all queued buffer is sent
 	  break;
@@ -685,9 +699,13 @@ void ProtocolV2::write_event() {
       }
 
       if (out_entry.m->queue_start != ceph::mono_time()) {
-        connection->logger->tinc(l_msgr_send_messages_queue_lat,
-				 ceph::mono_clock::now() -
-				 out_entry.m->queue_start);
+        auto queued = ceph::mono_clock::now() - out_entry.m->queue_start;
+        connection->logger->tinc(l_msgr_send_messages_queue_lat, queued);
+        connection->logger->hinc(
+          l_msgr_send_messages_queue_lat_histogram,
+          std::chrono::nanoseconds(queued).count(),
+          out_entry.m->get_payload().length() +
+          out_entry.m->get_data().length());
       }
 
       r = write_message(out_entry.m, more);
@@ -721,7 +739,16 @@ void ProtocolV2::write_event() {
           r = -EILSEQ;
         }
       } else if (is_queued()) {
+        ssize_t total_send_size = connection->outgoing_bl.length();
         r = connection->_try_send();
+        if (r >= 0) {
+          const auto sent_bytes =
+            total_send_size - connection->outgoing_bl.length();
+          connection->logger->inc(l_msgr_send_bytes, sent_bytes);
+          if (session_stream_handlers.tx) {
+            connection->logger->inc(l_msgr_send_encrypted_bytes, sent_bytes);
+          }
+        }
       }
     }
     connection->write_lock.unlock();
@@ -1191,6 +1218,16 @@ CtPtr ProtocolV2::read_frame_segment() {
 
   rx_buffer_t rx_buffer;
   uint16_t align = rx_frame_asm.get_segment_align(seg_idx);
+  if (next_tag == Tag::MESSAGE &&
+      seg_idx == SegmentIndex::Msg::DATA &&
+      onwire_len >= CEPH_PAGE_SIZE &&
+      align < segment_t::PAGE_SIZE_ALIGNMENT) {
+    // the data segment usually ends up in an O_DIRECT write; receive it
+    // page aligned whatever the peer advertised, so that the block device
+    // does not have to copy it into an aligned buffer.
+    align = segment_t::PAGE_SIZE_ALIGNMENT;
+    connection->logger->inc(l_msgr_recv_realigned_data_segments);
+  }
   try {
     rx_buffer = ceph::buffer::ptr_node::create(ceph::buffer::create_aligned(
         onwire_len, align));
@@ -2171,7 +2208,10 @@ CtPtr ProtocolV2::handle_compression_done(ceph::bufferlist &payload) {
     comp_meta.con_mode = Compressor::COMP_NONE;
   }
   session_compression_handlers = ceph::compression::onwire::rxtx_t::create_handler_pair(
-    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()));
+    cct, comp_meta,
+    messenger->comp_registry.get_min_compression_size(connection->get_peer_type()),
+    messenger->comp_registry.get_compress_required_ratio(),
+    messenger->comp_registry.get_compress_backoff_max());
 
   return start_session_connect();
 }
@@ -3031,7 +3071,10 @@ CtPtr ProtocolV2::finish_compression() {
   // allow reusing finish_compression().
   
   session_compression_handlers = ceph::compression::onwire::rxtx_t::create_handler_pair(
-    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()));
+    cct, comp_meta,
+    messenger->comp_registry.get_min_compression_size(connection->get_peer_type()),
+    messenger->comp_registry.get_compress_required_ratio(),
+    messenger->comp_registry.get_compress_backoff_max());
 
   state = SESSION_ACCEPTING;
   return CONTINUE(read_frame);
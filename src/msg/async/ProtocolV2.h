@@ -156,6 +156,7 @@ private:
   void prepare_send_message(uint64_t features, Message *m);
   out_queue_entry_t _get_next_outgoing();
   ssize_t write_message(Message *m, bool more);
+  bool should_coalesce() const;
   void handle_message_ack(uint64_t seq);
   void reset_compression();
 
@@ -19,6 +19,7 @@
 #include "include/compat.h"
 #include "common/Cond.h"
 #include "common/errno.h"
+#include "common/numa.h"
 #include "PosixStack.h"
 #ifdef HAVE_RDMA
 #include "rdma/RDMAStack.h"
@@ -38,7 +39,11 @@ std::function<void ()> NetworkStack::add_thread(Worker* w)
 {
   return [this, w]() {
       rename_thread(w->id);
+      set_worker_affinity(w->id);
       const unsigned EventMaxWaitUs = 30000000;
+      const auto busy_poll = std::chrono::microseconds(
+        cct->_conf.get_val<uint64_t>("ms_async_busy_poll_us"));
+      auto poll_until = ceph::mono_clock::zero();
       w->center.set_owner();
       ldout(cct, 10) << __func__ << " starting" << dendl;
       w->initialize();
@@ -47,11 +52,17 @@ std::function<void ()> NetworkStack::add_thread(Worker* w)
         ldout(cct, 30) << __func__ << " calling event process" << dendl;
 
         ceph::timespan dur;
-        int r = w->center.process_events(EventMaxWaitUs, &dur);
+        unsigned timeout = EventMaxWaitUs;
+        if (busy_poll.count() && ceph::mono_clock::now() < poll_until) {
+          timeout = 0;
+        }
+        int r = w->center.process_events(timeout, &dur);
         if (r < 0) {
           ldout(cct, 20) << __func__ << " process events failed: "
                          << cpp_strerror(errno) << dendl;
           // TODO do something?
+        } else if (r > 0 && busy_poll.count()) {
+          poll_until = ceph::mono_clock::now() + busy_poll;
         }
         w->perf_logger->tinc(l_msgr_running_total_time, dur);
       }
@@ -60,6 +71,43 @@ std::function<void ()> NetworkStack::add_thread(Worker* w)
   };
 }
 
+void NetworkStack::set_worker_affinity(unsigned id)
+{
+  auto cores = cct->_conf.get_val<std::string>("ms_async_affinity_cores");
+  if (cores.empty()) {
+    return;
+  }
+#ifdef __linux__
+  size_t cpu_set_size;
+  cpu_set_t cpu_set;
+  if (parse_cpu_set_list(cores.c_str(), &cpu_set_size, &cpu_set) < 0) {
+    lderr(cct) << __func__ << " unable to parse ms_async_affinity_cores '"
+               << cores << "'" << dendl;
+    return;
+  }
+  auto cpus = cpu_set_to_set(cpu_set_size, &cpu_set);
+  if (cpus.empty()) {
+    return;
+  }
+  int cpu = *std::next(cpus.begin(), id % cpus.size());
+  cpu_set_t worker_set;
+  CPU_ZERO(&worker_set);
+  CPU_SET(cpu, &worker_set);
+  int r = pthread_setaffinity_np(pthread_self(), sizeof(worker_set),
+                                 &worker_set);
+  if (r) {
+    lderr(cct) << __func__ << " unable to pin worker " << id << " to cpu "
+               << cpu << ": " << cpp_strerror(r) << dendl;
+  } else {
+    ldout(cct, 10) << __func__ << " pinned worker " << id << " to cpu "
+                   << cpu << dendl;
+  }
+#else
+  lderr(cct) << __func__ << " ms_async_affinity_cores is not supported on "
+             << "this platform" << dendl;
+#endif
+}
+
 std::shared_ptr<NetworkStack> NetworkStack::create(CephContext *c,
 						   const std::string &t)
 {
@@ -35,6 +35,10 @@ class ConnectedSocketImpl {
   virtual void close() = 0;
   virtual int fd() const = 0;
   virtual void set_priority(int sd, int prio, int domain) = 0;
+  /// send with kernel zerocopy when at least min_bytes are queued (0: never)
+  virtual void set_zerocopy(uint64_t min_bytes) {}
+  /// release the buffers of zerocopy sends the kernel is done with
+  virtual void reap_send_completions() {}
 };
 
 class ConnectedSocket;
@@ -130,6 +134,14 @@ class ConnectedSocket {
     _csi->set_priority(sd, prio, domain);
   }
 
+  void set_zerocopy(uint64_t min_bytes) {
+    _csi->set_zerocopy(min_bytes);
+  }
+
+  void reap_send_completions() {
+    _csi->reap_send_completions();
+  }
+
   explicit operator bool() const {
     return _csi.get();
   }
@@ -193,6 +205,26 @@ class ServerSocket {
 
 class NetworkStack;
 
+// Latency axis configuration for messenger histograms, values are in
+// nanoseconds
+inline const PerfHistogramCommon::axis_config_d msgr_lat_hist_x_axis_config{
+  "Latency (usec)",
+  PerfHistogramCommon::SCALE_LOG2, ///< Latency in logarithmic scale
+  0,                               ///< Start at 0
+  10000,                           ///< Quantization unit is 10usec
+  24,                              ///< Up to about a minute
+};
+
+// Message size axis configuration for messenger histograms, values are in
+// bytes
+inline const PerfHistogramCommon::axis_config_d msgr_size_hist_y_axis_config{
+  "Message size (bytes)",
+  PerfHistogramCommon::SCALE_LOG2, ///< Message size in logarithmic scale
+  0,                               ///< Start at 0
+  512,                             ///< Quantization unit is 512 bytes
+  20,                              ///< Up to hundreds of MB
+};
+
 enum {
   l_msgr_first = 94000,
   l_msgr_recv_messages,
@@ -209,10 +241,16 @@ enum {
 
   l_msgr_send_messages_queue_lat,
   l_msgr_handle_ack_lat,
+  l_msgr_send_messages_queue_lat_histogram,
 
   l_msgr_recv_encrypted_bytes,
   l_msgr_send_encrypted_bytes,
 
+  l_msgr_recv_realigned_data_segments,
+
+  l_msgr_send_syscalls,
+  l_msgr_send_coalesced_messages,
+
   l_msgr_last,
 };
 
@@ -267,10 +305,20 @@ class Worker {
 
     plb.add_time_avg(l_msgr_send_messages_queue_lat, "msgr_send_messages_queue_lat", "Network sent messages lat");
     plb.add_time_avg(l_msgr_handle_ack_lat, "msgr_handle_ack_lat", "Connection handle ack lat");
+    plb.add_u64_counter_histogram(
+      l_msgr_send_messages_queue_lat_histogram,
+      "msgr_send_messages_queue_lat_histogram",
+      msgr_lat_hist_x_axis_config, msgr_size_hist_y_axis_config,
+      "Histogram of time sent messages waited in the connection's out queue");
 
     plb.add_u64_counter(l_msgr_recv_encrypted_bytes, "msgr_recv_encrypted_bytes", "Network received encrypted bytes", NULL, 0, unit_t(UNIT_BYTES));
     plb.add_u64_counter(l_msgr_send_encrypted_bytes, "msgr_send_encrypted_bytes", "Network sent encrypted bytes", NULL, 0, unit_t(UNIT_BYTES));
 
+    plb.add_u64_counter(l_msgr_recv_realigned_data_segments, "msgr_recv_realigned_data_segments", "Message data segments received page aligned although the peer asked for less");
+
+    plb.add_u64_counter(l_msgr_send_syscalls, "msgr_send_syscalls", "Socket sends issued");
+    plb.add_u64_counter(l_msgr_send_coalesced_messages, "msgr_send_coalesced_messages", "Messages held back to be sent together with the following ones");
+
     perf_logger = plb.create_perf_counters();
     cct->get_perfcounters_collection()->add(perf_logger);
 
@@ -346,6 +394,8 @@ class NetworkStack {
   bool started = false;
 
   std::function<void ()> add_thread(Worker* w);
+  /// pin the calling worker thread as ms_async_affinity_cores asks
+  void set_worker_affinity(unsigned id);
 
   virtual Worker* create_worker(CephContext *c, unsigned i) = 0;
   virtual void rename_thread(unsigned id) {
@@ -12,7 +12,9 @@ namespace ceph::compression::onwire {
 rxtx_t rxtx_t::create_handler_pair(
     CephContext* ctx,
     const CompConnectionMeta& comp_meta,
-    std::uint64_t compress_min_size)
+    std::uint64_t compress_min_size,
+    double compress_required_ratio,
+    std::uint64_t compress_backoff_max)
 {
   if (comp_meta.is_compress()) {
      CompressorRef compressor = Compressor::create(ctx, comp_meta.get_method());
@@ -20,7 +22,9 @@ rxtx_t rxtx_t::create_handler_pair(
       return {std::make_unique<RxHandler>(ctx, compressor),
 	      std::make_unique<TxHandler>(ctx, compressor,
 					  comp_meta.get_mode(),
-					  compress_min_size)};
+					  compress_min_size,
+					  compress_required_ratio,
+					  compress_backoff_max)};
     }
   }
   return {};
@@ -78,9 +82,30 @@ std::optional<ceph::bufferlist> RxHandler::decompress(const ceph::bufferlist &in
   }
 }
 
-void TxHandler::done()
+bool TxHandler::should_compress()
+{
+  if (m_skip > 0) {
+    --m_skip;
+    return false;
+  }
+  return true;
+}
+
+bool TxHandler::done()
 {
   ldout(m_cct, 25) << __func__ << " compression ratio=" << get_ratio() << dendl;
+  if (m_onwire_size > m_init_onwire_size * m_required_ratio) {
+    if (m_backoff_max > 0) {
+      m_backoff = std::min(m_backoff ? m_backoff * 2 : 1, m_backoff_max);
+      m_skip = m_backoff;
+    }
+    ldout(m_cct, 20) << __func__ << " frame did not compress enough, sending "
+		     << "it and the next " << m_skip << " frames uncompressed"
+		     << dendl;
+    return false;
+  }
+  m_backoff = 0;
+  return true;
 }
 
 } // namespace ceph::compression::onwire
@@ -45,10 +45,14 @@ namespace ceph::compression::onwire {
 
   class TxHandler final : private Handler {
   public:
-    TxHandler(CephContext* const cct, CompressorRef compressor, int mode, std::uint64_t min_size)
+    TxHandler(CephContext* const cct, CompressorRef compressor, int mode,
+	      std::uint64_t min_size, double required_ratio,
+	      std::uint64_t backoff_max)
       : Handler(cct, compressor),
 	m_min_size(min_size),
-	m_mode(static_cast<Compressor::CompressionMode>(mode))
+	m_mode(static_cast<Compressor::CompressionMode>(mode)),
+	m_required_ratio(required_ratio),
+	m_backoff_max(backoff_max)
     {}
     ~TxHandler() {}
 
@@ -58,7 +62,19 @@ namespace ceph::compression::onwire {
       m_onwire_size = 0;
     }
 
-    void done();
+    /**
+     * Whether to try compressing the next frame at all: after frames that
+     * did not compress well, a number of frames is sent as they are.
+     */
+    bool should_compress();
+
+    /**
+     * Called once all segments of a frame are compressed.
+     *
+     * @returns false if the compressed frame is not enough smaller than the
+     *          original to be worth sending
+     */
+    bool done();
 
     /**
      * Compresses a bufferlist 
@@ -85,6 +101,14 @@ namespace ceph::compression::onwire {
   private:
     uint64_t m_min_size; 
     Compressor::CompressionMode m_mode;
+    double m_required_ratio;
+    uint64_t m_backoff_max;
+
+    /// frames to send uncompressed after the latest frame that did not
+    /// compress; doubles with each such frame
+    uint64_t m_backoff = 0;
+    /// frames left to send uncompressed
+    uint64_t m_skip = 0;
 
     uint64_t m_init_onwire_size;
     uint64_t m_onwire_size;
@@ -98,7 +122,9 @@ namespace ceph::compression::onwire {
     static rxtx_t create_handler_pair(
       CephContext* ctx,
       const CompConnectionMeta& comp_meta,
-      std::uint64_t compress_min_size);
+      std::uint64_t compress_min_size,
+      double compress_required_ratio,
+      std::uint64_t compress_backoff_max);
   };
 }
 
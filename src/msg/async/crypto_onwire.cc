@@ -18,6 +18,10 @@ static constexpr const std::size_t AESGCM_KEY_LEN{16};
 static constexpr const std::size_t AESGCM_IV_LEN{12};
 static constexpr const std::size_t AESGCM_TAG_LEN{16};
 static constexpr const std::size_t AESGCM_BLOCK_LEN{16};
+// plaintext buffers shorter than this are gathered into the output buffer
+// and encrypted there together: a cipher update call per buffer costs more
+// than the copy for them
+static constexpr const std::size_t AESGCM_GATHER_LEN{2048};
 
 struct nonce_t {
   ceph_le32 fixed;
@@ -111,20 +115,36 @@ void AES128GCM_OnWireTxHandler::authenticated_encrypt_update(
   ceph_assert(buffer.get_append_buffer_unused_tail_length() >=
               plaintext.length());
   auto filler = buffer.append_hole(plaintext.length());
+  auto out = reinterpret_cast<unsigned char*>(filler.c_str());
 
-  for (const auto& plainbuf : plaintext.buffers()) {
+  auto encrypt = [this, &out](const unsigned char* in, unsigned len) {
     int update_len = 0;
 
-    if(1 != EVP_EncryptUpdate(ectx.get(),
-	reinterpret_cast<unsigned char*>(filler.c_str()),
-	&update_len,
-	reinterpret_cast<const unsigned char*>(plainbuf.c_str()),
-	plainbuf.length())) {
+    if(1 != EVP_EncryptUpdate(ectx.get(), out, &update_len, in, len)) {
       throw std::runtime_error("EVP_EncryptUpdate failed");
     }
     ceph_assert_always(update_len >= 0);
-    ceph_assert(static_cast<unsigned>(update_len) == plainbuf.length());
-    filler.advance(update_len);
+    ceph_assert(static_cast<unsigned>(update_len) == len);
+    out += update_len;
+  };
+
+  // bytes of small buffers copied to out but not encrypted yet
+  unsigned gathered = 0;
+  for (const auto& plainbuf : plaintext.buffers()) {
+    if (plainbuf.length() < AESGCM_GATHER_LEN) {
+      ::memcpy(out + gathered, plainbuf.c_str(), plainbuf.length());
+      gathered += plainbuf.length();
+      continue;
+    }
+    if (gathered) {
+      encrypt(out, gathered);
+      gathered = 0;
+    }
+    encrypt(reinterpret_cast<const unsigned char*>(plainbuf.c_str()),
+	    plainbuf.length());
+  }
+  if (gathered) {
+    encrypt(out, gathered);
   }
 
   ldout(cct, 15) << __func__
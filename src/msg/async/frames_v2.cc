@@ -502,6 +502,9 @@ std::ostream& operator<<(std::ostream& os, const FrameAssembler& frame_asm) {
 void FrameAssembler::asm_compress(bufferlist segment_bls[]) {
   std::array<bufferlist, MAX_NUM_SEGMENTS> compressed;
 
+  if (!m_compression->tx->should_compress()) {
+    return;
+  }
   m_compression->tx->reset_handler(m_descs.size(), get_frame_logical_len());
 
   bool abort = false;
@@ -514,9 +517,7 @@ void FrameAssembler::asm_compress(bufferlist segment_bls[]) {
       }
   }
 
-  if (!abort) {
-    m_compression->tx->done();
-
+  if (!abort && m_compression->tx->done()) {
     for (size_t i = 0; i < m_descs.size(); i++) {
       segment_bls[i].swap(compressed[i]);
       m_descs[i].logical_len = segment_bls[i].length();
@@ -490,6 +490,10 @@ int RDMAConnectedSocketImpl::post_work_request(std::vector<Chunk*> &tx_buffers)
     iswr[current_swr].num_sge = 1;
     iswr[current_swr].opcode = IBV_WR_SEND;
     iswr[current_swr].send_flags = IBV_SEND_SIGNALED;
+    if (isge[current_sge].length <= qp->get_max_inline_data()) {
+      iswr[current_swr].send_flags |= IBV_SEND_INLINE;
+      worker->perf_logger->inc(l_msgr_rdma_tx_inline_chunks);
+    }
 
     worker->perf_logger->inc(l_msgr_rdma_tx_bytes, isge[current_sge].length);
     if (pre_wr)
@@ -25,6 +25,8 @@ const char** CompressorRegistry::get_tracked_conf_keys() const
     "ms_osd_compress_mode",
     "ms_osd_compression_algorithm",
     "ms_osd_compress_min_size",
+    "ms_osd_compress_required_ratio",
+    "ms_osd_compress_backoff_max",
     "ms_compress_secure",
     nullptr
   };
@@ -77,12 +79,16 @@ void CompressorRegistry::_refresh_config()
 
   ms_osd_compression_methods = _parse_method_list(cct->_conf.get_val<std::string>("ms_osd_compression_algorithm"));
   ms_osd_compress_min_size = cct->_conf.get_val<std::uint64_t>("ms_osd_compress_min_size");
+  ms_osd_compress_required_ratio = cct->_conf.get_val<double>("ms_osd_compress_required_ratio");
+  ms_osd_compress_backoff_max = cct->_conf.get_val<std::uint64_t>("ms_osd_compress_backoff_max");
 
   ms_compress_secure = cct->_conf.get_val<bool>("ms_compress_secure");
 
   ldout(cct,10) << __func__ << " ms_osd_compression_mode " << ms_osd_compress_mode
     << " ms_osd_compression_methods " << ms_osd_compression_methods
     << " ms_osd_compress_above_min_size " << ms_osd_compress_min_size
+    << " ms_osd_compress_required_ratio " << ms_osd_compress_required_ratio
+    << " ms_osd_compress_backoff_max " << ms_osd_compress_backoff_max
     << " ms_compress_secure " << ms_compress_secure
     << dendl;
 }
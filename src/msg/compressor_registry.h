@@ -50,6 +50,16 @@ public:
     }
   }
 
+  double get_compress_required_ratio() const {
+    std::scoped_lock l(lock);
+    return ms_osd_compress_required_ratio;
+  }
+
+  std::uint64_t get_compress_backoff_max() const {
+    std::scoped_lock l(lock);
+    return ms_osd_compress_backoff_max;
+  }
+
   bool get_is_compress_secure() const { 
     std::scoped_lock l(lock);
     return ms_compress_secure; 
@@ -62,6 +72,8 @@ private:
   uint32_t ms_osd_compress_mode;
   bool ms_compress_secure;
   std::uint64_t ms_osd_compress_min_size;
+  double ms_osd_compress_required_ratio;
+  std::uint64_t ms_osd_compress_backoff_max;
   std::vector<uint32_t> ms_osd_compression_methods;
 
   void _refresh_config();
@@ -14,8 +14,11 @@
 
 #define BOOST_BIND_NO_PLACEHOLDERS
 
+#include <algorithm>
+#include <mutex>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
 
@@ -966,6 +969,104 @@ void RADOS::execute_(Object o, IOContext _ioc, WriteOp _op,
   trace.event("submitted");
 }
 
+namespace {
+// Keeps up to max_concurrent ops of one execute_many() call in flight,
+// starting the next each time one completes.
+template<typename Op>
+struct ExecuteMany : std::enable_shared_from_this<ExecuteMany<Op>> {
+  RADOS& r;
+  IOContext ioc;
+  std::vector<std::pair<Object, Op>> ops;
+  RADOS::ExecuteManyComp c;
+
+  std::mutex lock;
+  std::vector<bs::error_code> results;
+  bs::error_code first_error;
+  std::size_t max_in_flight;
+  std::size_t next = 0;
+  std::size_t in_flight = 0;
+  std::size_t completed = 0;
+
+  ExecuteMany(RADOS& r, IOContext ioc,
+	      std::vector<std::pair<Object, Op>> ops,
+	      std::size_t max_concurrent, RADOS::ExecuteManyComp c)
+    : r(r), ioc(std::move(ioc)), ops(std::move(ops)), c(std::move(c)),
+      results(this->ops.size()), max_in_flight(std::max<std::size_t>(
+	max_concurrent, 1)) {}
+
+  void submit(std::size_t i, auto handler) {
+    if constexpr (std::is_same_v<Op, ReadOp>) {
+      r.execute(std::move(ops[i].first), ioc, std::move(ops[i].second),
+		nullptr, std::move(handler));
+    } else {
+      r.execute(std::move(ops[i].first), ioc, std::move(ops[i].second),
+		std::move(handler));
+    }
+  }
+
+  void submit_more() {
+    // never hold the lock across execute(), whose handler may run inline
+    for (;;) {
+      std::unique_lock l{lock};
+      if (next == ops.size() || in_flight >= max_in_flight) {
+	return;
+      }
+      auto i = next++;
+      ++in_flight;
+      l.unlock();
+      submit(i, [i, self = this->shared_from_this()](bs::error_code ec) {
+	self->finish(i, ec);
+      });
+    }
+  }
+
+  void finish(std::size_t i, bs::error_code ec) {
+    std::unique_lock l{lock};
+    results[i] = ec;
+    if (ec && !first_error) {
+      first_error = ec;
+    }
+    --in_flight;
+    if (++completed == ops.size()) {
+      l.unlock();
+      asio::dispatch(asio::append(std::move(c), first_error,
+				  std::move(results)));
+      return;
+    }
+    l.unlock();
+    submit_more();
+  }
+};
+
+template<typename Op>
+void start_execute_many(RADOS& r, IOContext ioc,
+			std::vector<std::pair<Object, Op>> ops,
+			std::size_t max_concurrent, RADOS::ExecuteManyComp c) {
+  if (ops.empty()) {
+    asio::dispatch(asio::append(std::move(c), bs::error_code{},
+				std::vector<bs::error_code>{}));
+    return;
+  }
+  std::make_shared<ExecuteMany<Op>>(r, std::move(ioc), std::move(ops),
+				    max_concurrent, std::move(c))
+    ->submit_more();
+}
+} // anonymous namespace
+
+void RADOS::execute_many_(IOContext ioc,
+			  std::vector<std::pair<Object, ReadOp>> ops,
+			  std::size_t max_concurrent, ExecuteManyComp c) {
+  start_execute_many(*this, std::move(ioc), std::move(ops), max_concurrent,
+		     std::move(c));
+}
+
+void RADOS::execute_many_(IOContext ioc,
+			  std::vector<std::pair<Object, WriteOp>> ops,
+			  std::size_t max_concurrent, ExecuteManyComp c) {
+  start_execute_many(*this, std::move(ioc), std::move(ops), max_concurrent,
+		     std::move(c));
+}
+
 boost::uuids::uuid RADOS::get_fsid() const noexcept {
   return impl->monclient.get_fsid().uuid;
 }
@@ -705,6 +705,10 @@ public:
 
       return op;
     }
+    /// next op without consuming it, nullptr if there is none
+    const Op* peek_op() const {
+      return ops > 0 ? reinterpret_cast<const Op*>(op_buffer_p) : nullptr;
+    }
     std::string decode_string() {
 	using ceph::decode;
       std::string s;
@@ -3,12 +3,14 @@
 
 #include "Allocator.h"
 #include <bit>
+#include "AllocatorTrace.h"
 #include "StupidAllocator.h"
 #include "BitmapAllocator.h"
 #include "AvlAllocator.h"
 #include "BtreeAllocator.h"
 #include "Btree2Allocator.h"
 #include "HybridAllocator.h"
+#include "ShardedAllocator.h"
 #include "common/debug.h"
 #include "common/admin_socket.h"
 
@@ -52,6 +54,17 @@ public:
           this,
           "give allocator fragmentation (0-no fragmentation, 1-absolute fragmentation)");
         ceph_assert(r == 0);
+        r = admin_socket->register_command(
+	  ("bluestore allocator trace start " + name +
+           " name=path,type=CephString").c_str(),
+	  this,
+	  "start recording allocate/release calls to a binary trace file");
+        ceph_assert(r == 0);
+        r = admin_socket->register_command(
+	  ("bluestore allocator trace stop " + name).c_str(),
+	  this,
+	  "stop recording allocator trace");
+        ceph_assert(r == 0);
         r = admin_socket->register_command(
 	  ("bluestore allocator fragmentation histogram " + name +
            " name=alloc_unit,type=CephInt,req=false" +
@@ -142,6 +155,12 @@ public:
         }
       );
       f->close_section();
+    } else if (command == "bluestore allocator trace start " + name) {
+      string path;
+      cmd_getval(cmdmap, "path", path);
+      r = alloc->start_trace(path, ss);
+    } else if (command == "bluestore allocator trace stop " + name) {
+      alloc->stop_trace();
     } else {
       ss << "Invalid command" << std::endl;
       r = -ENOSYS;
@@ -153,7 +172,8 @@ public:
 Allocator::Allocator(std::string_view name,
                      int64_t _capacity,
                      int64_t _block_size)
- : device_size(_capacity),
+ : trace(new AllocatorTrace),
+   device_size(_capacity),
    block_size(_block_size)
 {
   asok_hook = new SocketHook(this, name);
@@ -165,6 +185,31 @@ Allocator::~Allocator()
   delete asok_hook;
 }
 
+int Allocator::start_trace(const std::string& path, std::ostream& ss)
+{
+  return trace->start(path, this, tracing, ss);
+}
+
+void Allocator::stop_trace()
+{
+  tracing = false;
+  trace->stop();
+}
+
+void Allocator::_trace_allocate(uint64_t want, uint64_t unit,
+				uint64_t max_alloc_size, int64_t hint,
+				int64_t result,
+				const PExtentVector& extents, size_t first)
+{
+  trace->record_allocate(want, unit, max_alloc_size, hint, result,
+			 extents, first);
+}
+
+void Allocator::_trace_release(const release_set_t& release_set)
+{
+  trace->record_release(release_set);
+}
+
 const string& Allocator::get_name() const {
   return asok_hook->name;
 }
@@ -194,6 +239,13 @@ Allocator *Allocator::create(
       cct->_conf.get_val<uint64_t>("bluestore_hybrid_alloc_mem_cap"),
       cct->_conf.get_val<double>("bluestore_btree2_alloc_weight_factor"),
       name);
+  } else if (type == "hybrid_sharded") {
+    return new ShardedHybridAllocator(cct, size, block_size,
+      cct->_conf.get_val<uint64_t>("bluestore_hybrid_alloc_mem_cap"),
+      cct->_conf.get_val<uint64_t>("bluestore_sharded_alloc_shards"),
+      cct->_conf.get_val<uint64_t>("bluestore_sharded_alloc_size_classes"),
+      cct->_conf.get_val<uint64_t>("bluestore_sharded_alloc_batch"),
+      name);
   }
   if (alloc == nullptr) {
     lderr(cct) << "Allocator::" << __func__ << " unknown alloc type "
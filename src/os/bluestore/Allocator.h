@@ -12,12 +12,16 @@
 #ifndef CEPH_OS_BLUESTORE_ALLOCATOR_H
 #define CEPH_OS_BLUESTORE_ALLOCATOR_H
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <ostream>
 #include "include/ceph_assert.h"
 #include "bluestore_types.h"
 #include "common/ceph_mutex.h"
 
+class AllocatorTrace;
+
 typedef interval_set<uint64_t> release_set_t;
 typedef release_set_t::value_type release_set_entry_t;
 
@@ -351,12 +355,35 @@ public:
       std::function<void(uint64_t, uint64_t, uint64_t, uint64_t)> cb);
   };
 
+  /*
+   * Record allocate()/release() calls into a binary trace file,
+   * see AllocatorTrace.h for the format.
+   */
+  int start_trace(const std::string& path, std::ostream& ss);
+  void stop_trace();
+
 private:
   class SocketHook;
   SocketHook* asok_hook = nullptr;
+  std::atomic<bool> tracing = false;
+  std::unique_ptr<AllocatorTrace> trace;
 protected:
   const int64_t device_size = 0;
   const int64_t block_size = 0;
+
+  /*
+   * Implementations call these from their public allocate()/release()
+   * exactly once per call, outside of their own lock: releases before
+   * applying them, allocations after completion. extents[first..] are
+   * the ones returned by the call.
+   */
+  bool is_tracing() const {
+    return tracing.load(std::memory_order_relaxed);
+  }
+  void _trace_allocate(uint64_t want, uint64_t unit, uint64_t max_alloc_size,
+		       int64_t hint, int64_t result,
+		       const PExtentVector& extents, size_t first);
+  void _trace_release(const release_set_t& release_set);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "AllocatorTrace.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Allocator.h"
+#include "common/errno.h"
+#include "include/encoding.h"
+
+using ceph::decode;
+using ceph::encode;
+
+AllocatorTrace::~AllocatorTrace()
+{
+  stop();
+}
+
+int AllocatorTrace::start(const std::string& path, Allocator* alloc,
+			  std::atomic<bool>& active, std::ostream& ss)
+{
+  std::lock_guard l(lock);
+  if (fd >= 0) {
+    ss << "trace already in progress";
+    return -EBUSY;
+  }
+  fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    int r = -errno;
+    ss << "unable to open " << path << ": " << cpp_strerror(r);
+    return r;
+  }
+  started = ceph::mono_clock::now();
+  pending.clear();
+
+  encode(std::string(MAGIC), pending);
+  encode(VERSION, pending);
+  encode(uint64_t(alloc->get_capacity()), pending);
+  encode(uint64_t(alloc->get_block_size()), pending);
+  encode(std::string(alloc->get_type()), pending);
+
+  // Anything released from now on blocks on our lock until the free state
+  // below is captured, and is recorded before it is applied.
+  active = true;
+  alloc->foreach([&](uint64_t offset, uint64_t length) {
+    _encode_entry_start(OP_FREE);
+    encode(offset, pending);
+    encode(length, pending);
+    _maybe_flush();
+  });
+  _maybe_flush(true);
+  return 0;
+}
+
+void AllocatorTrace::stop()
+{
+  std::lock_guard l(lock);
+  if (fd < 0) {
+    return;
+  }
+  _maybe_flush(true);
+  VOID_TEMP_FAILURE_RETRY(::close(fd));
+  fd = -1;
+}
+
+void AllocatorTrace::record_allocate(
+  uint64_t want, uint64_t unit, uint64_t max_alloc_size,
+  int64_t hint, int64_t result,
+  const PExtentVector& extents, size_t first)
+{
+  std::lock_guard l(lock);
+  if (fd < 0) {
+    return;
+  }
+  _encode_entry_start(OP_ALLOCATE);
+  encode(want, pending);
+  encode(unit, pending);
+  encode(max_alloc_size, pending);
+  encode(hint, pending);
+  encode(result, pending);
+  uint32_t count = first < extents.size() ? extents.size() - first : 0;
+  encode(count, pending);
+  for (size_t i = first; i < extents.size(); ++i) {
+    encode(extents[i].offset, pending);
+    encode(extents[i].length, pending);
+  }
+  _maybe_flush();
+}
+
+void AllocatorTrace::record_release(const interval_set<uint64_t>& release_set)
+{
+  std::lock_guard l(lock);
+  if (fd < 0) {
+    return;
+  }
+  _encode_entry_start(OP_RELEASE);
+  encode(uint32_t(release_set.num_intervals()), pending);
+  for (auto& [offset, length] : release_set) {
+    encode(offset, pending);
+    encode(length, pending);
+  }
+  _maybe_flush();
+}
+
+void AllocatorTrace::_encode_entry_start(op_t op)
+{
+  ceph_assert(ceph_mutex_is_locked(lock));
+  encode(uint8_t(op), pending);
+  encode(uint64_t(std::chrono::nanoseconds(
+    ceph::mono_clock::now() - started).count()), pending);
+}
+
+void AllocatorTrace::_maybe_flush(bool force)
+{
+  ceph_assert(ceph_mutex_is_locked(lock));
+  if (pending.length() == 0 || (!force && pending.length() < FLUSH_BYTES)) {
+    return;
+  }
+  // on a write error keep going, replay stops at the truncated entry
+  pending.write_fd(fd);
+  pending.clear();
+}
+
+int AllocatorTrace::Reader::open(const std::string& path,
+				 header_t* header,
+				 std::ostream& ss)
+{
+  std::string err;
+  int r = bl.read_file(path.c_str(), &err);
+  if (r < 0) {
+    ss << "unable to read " << path << ": " << err;
+    return r;
+  }
+  p = bl.cbegin();
+  try {
+    std::string magic;
+    uint8_t version;
+    decode(magic, p);
+    decode(version, p);
+    if (magic != MAGIC || version != VERSION) {
+      ss << path << " is not a supported allocator trace";
+      return -EINVAL;
+    }
+    decode(header->capacity, p);
+    decode(header->block_size, p);
+    decode(header->alloc_type, p);
+  } catch (ceph::buffer::error& e) {
+    ss << "unable to decode trace header: " << e.what();
+    return -EINVAL;
+  }
+  return 0;
+}
+
+bool AllocatorTrace::Reader::next(entry_t* e)
+{
+  if (p.end()) {
+    return false;
+  }
+  try {
+    uint8_t op;
+    decode(op, p);
+    e->op = op_t(op);
+    decode(e->timestamp, p);
+    e->extents.clear();
+    switch (e->op) {
+    case OP_FREE:
+      {
+	uint64_t offset, length;
+	decode(offset, p);
+	decode(length, p);
+	e->extents.emplace_back(offset, length);
+      }
+      break;
+    case OP_ALLOCATE:
+      {
+	decode(e->want, p);
+	decode(e->unit, p);
+	decode(e->max_alloc_size, p);
+	decode(e->hint, p);
+	decode(e->result, p);
+	uint32_t count;
+	decode(count, p);
+	e->extents.reserve(count);
+	for (uint32_t i = 0; i < count; ++i) {
+	  uint64_t offset;
+	  uint32_t length;
+	  decode(offset, p);
+	  decode(length, p);
+	  e->extents.emplace_back(offset, length);
+	}
+      }
+      break;
+    case OP_RELEASE:
+      {
+	uint32_t count;
+	decode(count, p);
+	e->extents.reserve(count);
+	for (uint32_t i = 0; i < count; ++i) {
+	  uint64_t offset, length;
+	  decode(offset, p);
+	  decode(length, p);
+	  e->extents.emplace_back(offset, length);
+	}
+      }
+      break;
+    default:
+      return false;
+    }
+  } catch (ceph::buffer::error& err) {
+    // truncated trace, e.g. the OSD went down while recording
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,97 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "include/buffer.h"
+#include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
+#include "bluestore_types.h"
+
+class Allocator;
+
+/*
+ * Compact binary recording of allocate()/release() calls against an
+ * Allocator instance, suitable for offline replay against any other
+ * allocator implementation (see ceph_test_alloc_replay replay_trace).
+ *
+ * File layout (little endian, ceph encoding):
+ *   header:  string magic, u8 version, u64 capacity, u64 block_size,
+ *            string alloc_type
+ *   entries: u8 op, u64 timestamp (ns since trace start), then
+ *     OP_FREE:     u64 offset, u64 length   - free state at trace start
+ *     OP_ALLOCATE: u64 want, u64 unit, u64 max_alloc_size, i64 hint,
+ *                  i64 result, u32 count, count * (u64 offset, u32 length)
+ *     OP_RELEASE:  u32 count, count * (u64 offset, u64 length)
+ *
+ * Releases are recorded before they are applied and allocations after,
+ * so the order of entries never lets an extent be handed out before the
+ * release that freed it. Allocators must not hold their own lock while
+ * recording since start() walks the free extents with the trace lock held.
+ */
+class AllocatorTrace {
+public:
+  static constexpr const char* MAGIC = "ceph bluestore allocator trace";
+  static constexpr uint8_t VERSION = 1;
+
+  enum op_t : uint8_t {
+    OP_FREE = 1,
+    OP_ALLOCATE = 2,
+    OP_RELEASE = 3,
+  };
+
+  struct header_t {
+    uint64_t capacity = 0;
+    uint64_t block_size = 0;
+    std::string alloc_type;
+  };
+
+  struct entry_t {
+    op_t op = OP_FREE;
+    uint64_t timestamp = 0;
+    uint64_t want = 0;
+    uint64_t unit = 0;
+    uint64_t max_alloc_size = 0;
+    int64_t hint = 0;
+    int64_t result = 0;
+    // OP_FREE uses a single element
+    std::vector<std::pair<uint64_t, uint64_t>> extents;
+  };
+
+  class Reader {
+    ceph::buffer::list bl;
+    ceph::buffer::list::const_iterator p;
+  public:
+    int open(const std::string& path, header_t* header, std::ostream& ss);
+    /// returns false at the end of the trace
+    bool next(entry_t* e);
+  };
+
+  ~AllocatorTrace();
+
+  /// dumps alloc's free extents and starts recording to path, active is
+  /// raised under the trace lock so no release can slip in between
+  int start(const std::string& path, Allocator* alloc,
+	    std::atomic<bool>& active, std::ostream& ss);
+  void stop();
+
+  void record_allocate(uint64_t want, uint64_t unit, uint64_t max_alloc_size,
+		       int64_t hint, int64_t result,
+		       const PExtentVector& extents, size_t first);
+  void record_release(const interval_set<uint64_t>& release_set);
+
+private:
+  static constexpr size_t FLUSH_BYTES = 1 << 20;
+
+  ceph::mutex lock = ceph::make_mutex("AllocatorTrace::lock");
+  int fd = -1;
+  ceph::mono_time started;
+  ceph::buffer::list pending;
+
+  void _encode_entry_start(op_t op);
+  void _maybe_flush(bool force = false);
+};
@@ -418,11 +418,22 @@ int64_t AvlAllocator::allocate(
       max_alloc_size >= cap) {
     max_alloc_size = p2align(uint64_t(cap), (uint64_t)block_size);
   }
-  std::lock_guard l(lock);
-  return _allocate(want, unit, max_alloc_size, hint, extents);
+  const size_t first = extents->size();
+  int64_t r;
+  {
+    std::lock_guard l(lock);
+    r = _allocate(want, unit, max_alloc_size, hint, extents);
+  }
+  if (is_tracing()) {
+    _trace_allocate(want, unit, max_alloc_size, hint, r, *extents, first);
+  }
+  return r;
 }
 
 void AvlAllocator::release(const release_set_t& release_set) {
+  if (is_tracing()) {
+    _trace_release(release_set);
+  }
   std::lock_guard l(lock);
   _release(release_set);
 }
@@ -33,6 +33,11 @@ int64_t BitmapAllocator::allocate(
     
   _allocate_l2(want_size, alloc_unit, max_alloc_size, hint,
     &allocated, extents);
+  if (is_tracing()) {
+    _trace_allocate(want_size, alloc_unit, max_alloc_size, hint,
+		    allocated ? int64_t(allocated) : -ENOSPC,
+		    *extents, old_size);
+  }
   if (!allocated) {
     return -ENOSPC;
   }
@@ -51,6 +56,9 @@ int64_t BitmapAllocator::allocate(
 void BitmapAllocator::release(
   const interval_set<uint64_t>& release_set)
 {
+  if (is_tracing()) {
+    _trace_release(release_set);
+  }
   if (cct->_conf->subsys.should_gather<dout_subsys, 10>()) {
     for (auto& [offset, len] : release_set) {
       ldout(cct, 10) << __func__ << " 0x" << std::hex << offset << "~" << len
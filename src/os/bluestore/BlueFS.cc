@@ -197,6 +197,7 @@ private:
 
 BlueFS::BlueFS(CephContext* cct)
   : cct(cct),
+    log_compact_thread(this),
     bdev(MAX_BDEV),
     ioc(MAX_BDEV),
     block_reserved(MAX_BDEV),
@@ -1095,6 +1096,7 @@ int BlueFS::mount()
            << dendl;
   // update log size
   logger->set(l_bluefs_log_bytes, log.writer->file->fnode.size);
+  _start_log_compact_thread();
   return 0;
 
  out:
@@ -1123,6 +1125,7 @@ void BlueFS::umount(bool avoid_compact)
 {
   dout(1) << __func__ << dendl;
 
+  _stop_log_compact_thread();
   sync_metadata(avoid_compact);
   if (cct->_conf->bluefs_check_volume_selector_on_umount) {
     _check_vselector_LNF();
@@ -4157,6 +4160,12 @@ void BlueFS::_maybe_compact_log_LNF_NF_LD_D()
 {
   if (!cct->_conf->bluefs_replay_recovery_disable_compact &&
       _should_start_compact_log_L_N()) {
+    if (log_compact_thread_running) {
+      std::lock_guard l(log_compact_lock);
+      log_compact_kicked = true;
+      log_compact_cond.notify_one();
+      return;
+    }
     auto t0 = mono_clock::now();
     if (cct->_conf->bluefs_compact_log_sync) {
       _compact_log_sync_LNF_LD();
@@ -4167,6 +4176,59 @@ void BlueFS::_maybe_compact_log_LNF_NF_LD_D()
   }
 }
 
+void BlueFS::_start_log_compact_thread()
+{
+  if (!cct->_conf.get_val<bool>("bluefs_log_compact_thread") ||
+      cct->_conf->bluefs_compact_log_sync) {
+    return;
+  }
+  dout(10) << __func__ << dendl;
+  log_compact_stop = false;
+  log_compact_kicked = false;
+  log_compact_thread.create("bstore_fs_cmpct");
+  log_compact_thread_running = true;
+}
+
+void BlueFS::_stop_log_compact_thread()
+{
+  if (!log_compact_thread_running) {
+    return;
+  }
+  dout(10) << __func__ << dendl;
+  {
+    std::lock_guard l(log_compact_lock);
+    log_compact_stop = true;
+    log_compact_cond.notify_one();
+  }
+  log_compact_thread.join();
+  log_compact_thread_running = false;
+}
+
+void BlueFS::_log_compact_thread()
+{
+  dout(10) << __func__ << " start" << dendl;
+  std::unique_lock l(log_compact_lock);
+  while (true) {
+    log_compact_cond.wait(l, [this] {
+      return log_compact_kicked || log_compact_stop;
+    });
+    if (log_compact_stop) {
+      break;
+    }
+    log_compact_kicked = false;
+    l.unlock();
+    // conditions might have changed while we were waking up
+    if (!cct->_conf->bluefs_replay_recovery_disable_compact &&
+        _should_start_compact_log_L_N()) {
+      auto t0 = mono_clock::now();
+      _compact_log_async_LD_LNF_D();
+      logger->tinc(l_bluefs_compaction_lat, mono_clock::now() - t0);
+    }
+    l.lock();
+  }
+  dout(10) << __func__ << " finish" << dendl;
+}
+
 int BlueFS::open_for_write(
   std::string_view dirname,
   std::string_view filename,
@@ -11,6 +11,7 @@
 #include "blk/BlockDevice.h"
 
 #include "common/RefCountedObj.h"
+#include "common/Thread.h"
 #include "common/ceph_context.h"
 #include "global/global_context.h"
 #include "include/common_fwd.h"
@@ -482,6 +483,28 @@ private:
   std::atomic<bool> log_is_compacting{false};                    ///< signals that bluefs log is already ongoing compaction
   std::atomic<bool> log_forbidden_to_expand{false};              ///< used to signal that async compaction is in state
                                                                  ///  that prohibits expansion of bluefs log
+
+  /// runs async log compaction on behalf of writers, so that RocksDB
+  /// threads calling fsync()/flush() never compact the log themselves
+  struct LogCompactThread : public Thread {
+    BlueFS *fs;
+    explicit LogCompactThread(BlueFS *f) : fs(f) {}
+    void *entry() override {
+      fs->_log_compact_thread();
+      return NULL;
+    }
+  };
+  LogCompactThread log_compact_thread;
+  ceph::mutex log_compact_lock =
+    ceph::make_mutex("BlueFS::log_compact_lock");
+  ceph::condition_variable log_compact_cond;
+  bool log_compact_kicked = false;
+  bool log_compact_stop = false;
+  std::atomic<bool> log_compact_thread_running{false};
+
+  void _log_compact_thread();
+  void _start_log_compact_thread();
+  void _stop_log_compact_thread();
   /*
    * There are up to 3 block devices:
    *
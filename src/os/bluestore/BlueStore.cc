@@ -20,6 +20,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <algorithm>
+#include <cmath>
 
 #include <boost/container/flat_set.hpp>
 #include <boost/algorithm/string.hpp>
@@ -1083,8 +1084,19 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
       &BlueStore::Onode::lru_item> > list_t;
 
   list_t lru;
+  /// LRU tail whose extent map shards are kept in the compact encoded form,
+  /// entries are evicted from here first and return to lru when touched
+  list_t cold;
+  const double cold_ratio;
 
-  explicit LruOnodeCacheShard(CephContext *cct) : BlueStore::OnodeCacheShard(cct) {}
+  explicit LruOnodeCacheShard(CephContext *cct)
+    : BlueStore::OnodeCacheShard(cct),
+      cold_ratio(cct->_conf.get_val<double>("bluestore_onode_cache_cold_ratio"))
+  {}
+
+  list_t& _list_of(BlueStore::Onode* o) {
+    return o->cache_cold ? cold : lru;
+  }
 
   void _add(BlueStore::Onode* o, int level) override
   {
@@ -1103,7 +1115,9 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
     o->clear_cached();
     if (o->lru_item.is_linked()) {
       *(o->cache_age_bin) -= 1;
-      lru.erase(lru.iterator_to(*o));
+      auto& l = _list_of(o);
+      l.erase(l.iterator_to(*o));
+      o->cache_cold = false;
     }
     ceph_assert(num);
     --num;
@@ -1138,8 +1152,10 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
           o->c->onode_space._remove(o->oid);
         }
       } else if (o->exists) {
-        // move onode within LRU
-        lru.erase(lru.iterator_to(*o));
+        // move onode within LRU, cold shards are decoded lazily on access
+        auto& l = _list_of(o);
+        l.erase(l.iterator_to(*o));
+        o->cache_cold = false;
         lru.push_front(*o);
         if (o->cache_age_bin != age_bins.front()) {
           *(o->cache_age_bin) -= 1;
@@ -1155,16 +1171,19 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
 
   void _trim_to(uint64_t new_size) override
   {
-    if (new_size >= lru.size()) {
-      return; // don't even try
-    } 
+    if (new_size >= lru.size() + cold.size()) {
+      _trim_hot(new_size); // nothing to evict
+      return;
+    }
     uint64_t n = num - new_size; // note: we might get empty LRU
                                  // before n == 0 due to pinned
                                  // entries. And hence being unable
                                  // to reach new_size target.
-    while (n-- > 0 && lru.size() > 0) {
-      BlueStore::Onode *o = &lru.back();
-      lru.pop_back();
+    while (n-- > 0 && lru.size() + cold.size() > 0) {
+      auto& l = cold.empty() ? lru : cold;
+      BlueStore::Onode *o = &l.back();
+      l.pop_back();
+      o->cache_cold = false;
 
       dout(20) << __func__ << "  rm " << o->oid << " "
                << o->nref << " " << o->cached << dendl;
@@ -1175,10 +1194,36 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
       } else {
 	ceph_assert(num);
         --num;
+        _ghost_add(std::hash<ghobject_t>{}(o->oid), 1);
         o->clear_cached();
         o->c->onode_space._remove(o->oid);
       }
     }
+    _trim_hot(new_size);
+  }
+  /// moves the hot LRU tail beyond (1 - cold_ratio) * new_size to the
+  /// cold list, unloading decoded extent map shards on the way
+  void _trim_hot(uint64_t new_size)
+  {
+    if (cold_ratio <= 0) {
+      return;
+    }
+    uint64_t hot_max = new_size * (1.0 - cold_ratio);
+    while (lru.size() > hot_max) {
+      BlueStore::Onode *o = &lru.back();
+      lru.pop_back();
+      if (o->pin_nref > 1) {
+        // it is in use, will be back to lru once unpinned
+        *(o->cache_age_bin) -= 1;
+        continue;
+      }
+      unsigned n = o->extent_map.unload_shards();
+      if (n) {
+        logger->inc(l_bluestore_onode_shard_unloads, n);
+      }
+      o->cache_cold = true;
+      cold.push_front(*o);
+    }
   }
   void _move_pinned(OnodeCacheShard *to, BlueStore::Onode *o) override
   {
@@ -1193,7 +1238,7 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
   {
     std::lock_guard l(lock);
     *onodes += num;
-    *pinned_onodes += num - lru.size();
+    *pinned_onodes += num - lru.size() - cold.size();
   }
 #ifdef DEBUG_CACHE
   void _audit(const char *when) override
@@ -1285,6 +1330,7 @@ struct LruBufferCacheShard : public BlueStore::BufferCacheShard {
       dout(20) << __func__ << " rm " << *b << dendl;
       assert(*(b->cache_age_bin) >= b->length);
       *(b->cache_age_bin) -= b->length;
+      _ghost_add(b->space->ghost_key(b->offset), b->length);
       b->space->_rm_buffer(this, b);
     }
     num = lru.size();
@@ -1549,6 +1595,7 @@ public:
         *(b->cache_age_bin) -= b->length;
 	to_evict_bytes -= b->length;
         evicted += b->length;
+        _ghost_add(b->space->ghost_key(b->offset), b->length);
         b->state = BlueStore::Buffer::STATE_EMPTY;
         b->data.clear();
         warm_in.erase(warm_in.iterator_to(*b));
@@ -1579,6 +1626,7 @@ public:
         // adjust evict size before buffer goes invalid
         to_evict_bytes -= b->length;
         evicted += b->length;
+        _ghost_add(b->space->ghost_key(b->offset), b->length);
         b->space->_rm_buffer(this, b);
       }
 
@@ -1853,7 +1901,9 @@ void BlueStore::BufferSpace::read(
   res.clear();
   res_intervals.clear();
   uint32_t want_bytes = length;
+  uint32_t want_offset = offset;
   uint32_t end = offset + length;
+  bool ghost_hit = false;
 
   {
     std::lock_guard l(cache->lock);
@@ -1905,6 +1955,14 @@ void BlueStore::BufferSpace::read(
         }
       }
     }
+    if (cache->ghost.max && res_intervals.size() < want_bytes) {
+      interval_set<uint32_t> missing;
+      missing.insert(want_offset, want_bytes);
+      missing.subtract(res_intervals);
+      for (auto p = missing.begin(); p != missing.end() && !ghost_hit; ++p) {
+        ghost_hit = cache->_ghost_lookup(ghost_key(p.get_start()));
+      }
+    }
   }
 
   uint64_t hit_bytes = res_intervals.size();
@@ -1912,6 +1970,19 @@ void BlueStore::BufferSpace::read(
   uint64_t miss_bytes = want_bytes - hit_bytes;
   cache->logger->inc(l_bluestore_buffer_hit_bytes, hit_bytes);
   cache->logger->inc(l_bluestore_buffer_miss_bytes, miss_bytes);
+  auto& stats = onode.c->cache_stats;
+  stats.data_hit_bytes += hit_bytes;
+  stats.data_miss_bytes += miss_bytes;
+  if (ghost_hit) {
+    cache->logger->inc(l_bluestore_buffer_ghost_hits);
+    ++stats.data_ghost_hits;
+  }
+}
+
+uint64_t BlueStore::BufferSpace::ghost_key(uint32_t offset) const
+{
+  return std::hash<ghobject_t>{}(onode.oid) ^
+    (offset * 0x9e3779b97f4a7c15ull);
 }
 
 void BlueStore::BufferSpace::_finish_write(BufferCacheShard* cache,
@@ -2069,7 +2140,8 @@ void BlueStore::OnodeSpace::_remove(const ghobject_t& oid)
   onode_map.erase(oid);
 }
 
-BlueStore::OnodeRef BlueStore::OnodeSpace::lookup(const ghobject_t& oid)
+BlueStore::OnodeRef BlueStore::OnodeSpace::lookup(const ghobject_t& oid,
+						  bool *ghost_hit)
 {
   ldout(cache->cct, 30) << __func__ << dendl;
   OnodeRef o;
@@ -2080,6 +2152,12 @@ BlueStore::OnodeRef BlueStore::OnodeSpace::lookup(const ghobject_t& oid)
     if (p == onode_map.end()) {
       ldout(cache->cct, 30) << __func__ << " " << oid << " miss" << dendl;
       cache->logger->inc(l_bluestore_onode_misses);
+      if (cache->_ghost_lookup(std::hash<ghobject_t>{}(oid))) {
+        cache->logger->inc(l_bluestore_onode_ghost_hits);
+        if (ghost_hit) {
+          *ghost_hit = true;
+        }
+      }
     } else {
       ldout(cache->cct, 30) << __func__ << " " << oid << " hit " << p->second
                             << " " << p->second->nref
@@ -4196,7 +4274,17 @@ void BlueStore::ExtentMap::fault_range(
   while (start <= last) {
     ceph_assert((size_t)start < shards.size());
     auto p = &shards[start];
-    if (!p->loaded) {
+    if (!p->loaded && p->cold_bl.length()) {
+      bufferlist v;
+      v.swap(p->cold_bl);
+      p->extents = decode_some(v);
+      p->loaded = true;
+      dout(20) << __func__ << " open cold shard 0x" << std::hex
+	       << p->shard_info->offset
+	       << " for range 0x" << offset << "~" << length << std::dec
+	       << " (" << v.length() << " bytes)" << dendl;
+      onode->c->store->logger->inc(l_bluestore_onode_shard_cold_hits);
+    } else if (!p->loaded) {
       dout(30) << __func__ << " opening shard 0x" << std::hex
 	       << p->shard_info->offset << std::dec << dendl;
       bufferlist v;
@@ -4228,6 +4316,44 @@ void BlueStore::ExtentMap::fault_range(
   }
 }
 
+unsigned BlueStore::ExtentMap::unload_shards()
+{
+  if (shards.empty() || needs_reshard()) {
+    return 0;
+  }
+  unsigned n = 0;
+  for (size_t i = 0; i < shards.size(); ++i) {
+    auto& sh = shards[i];
+    if (!sh.loaded || sh.dirty) {
+      continue;
+    }
+    uint32_t start = sh.shard_info->offset;
+    uint32_t end = i + 1 < shards.size() ?
+      shards[i + 1].shard_info->offset : OBJECT_MAX_SIZE;
+    bufferlist bl;
+    if (encode_some(start, end - start, bl, nullptr)) {
+      // a clean shard can't hit a new spanning blob, but don't leave
+      // a reshard request behind us if it somehow does
+      clear_needs_reshard();
+      continue;
+    }
+    // the appender over-allocates by the bound estimate
+    bl.rebuild();
+    bl.reassign_to_mempool(mempool::mempool_bluestore_inline_bl);
+    Extent dummy(start);
+    auto p = extent_map.lower_bound(dummy);
+    while (p != extent_map.end() && p->logical_offset < end) {
+      p = extent_map.erase_and_dispose(p, DeleteDisposer());
+    }
+    sh.cold_bl.swap(bl);
+    sh.loaded = false;
+    ++n;
+  }
+  dout(20) << __func__ << " " << onode->oid << " unloaded " << n
+	   << " of " << shards.size() << " shards" << dendl;
+  return n;
+}
+
 void BlueStore::ExtentMap::dirty_range(
   uint32_t offset,
   uint32_t length)
@@ -4785,6 +4911,13 @@ BlueStore::Onode* BlueStore::Onode::create_decode(
     for (auto& i : on->onode.attrs) {
       i.second.reassign_to_mempool(mempool::mempool_bluestore_cache_meta);
     }
+    for (auto& i : on->onode.inline_omap) {
+      i.second.reassign_to_mempool(mempool::mempool_bluestore_cache_meta);
+    }
+    if (on->onode.inline_omap_header.length()) {
+      on->onode.inline_omap_header.reassign_to_mempool(
+	mempool::mempool_bluestore_cache_meta);
+    }
 
     // initialize extent_map
     if (on->onode.extent_map_shards.empty()) {
@@ -5139,9 +5272,16 @@ BlueStore::OnodeRef BlueStore::Collection::get_onode(
     }
   }
 
-  OnodeRef o = onode_space.lookup(oid);
-  if (o)
+  bool ghost_hit = false;
+  OnodeRef o = onode_space.lookup(oid, &ghost_hit);
+  if (o) {
+    ++cache_stats.onode_hits;
     return o;
+  }
+  ++cache_stats.onode_misses;
+  if (ghost_hit) {
+    ++cache_stats.onode_ghost_hits;
+  }
 
   string key;
   get_object_key(store->cct, oid, &key);
@@ -5302,6 +5442,7 @@ void *BlueStore::MempoolThread::entry()
 
   binned_kv_cache = store->db->get_priority_cache();
   binned_kv_onode_cache = store->db->get_priority_cache(PREFIX_OBJ);
+  binned_kv_compressed_cache = store->db->get_compressed_priority_cache();
   if (store->cache_autotune && binned_kv_cache != nullptr) {
     pcm = std::make_shared<PriorityCache::Manager>(
         store->cct, min, max, target, true, "bluestore-pricache");
@@ -5311,12 +5452,16 @@ void *BlueStore::MempoolThread::entry()
     if (binned_kv_onode_cache != nullptr) {
       pcm->insert("kv_onode", binned_kv_onode_cache, true);
     }
+    if (binned_kv_compressed_cache != nullptr) {
+      pcm->insert("kv_compressed", binned_kv_compressed_cache, true);
+    }
   }
 
   utime_t next_balance = ceph_clock_now();
   utime_t next_resize = ceph_clock_now();
   utime_t next_bin_rotation = ceph_clock_now();
   utime_t next_deferred_force_submit = ceph_clock_now();
+  utime_t next_deferred_tune = ceph_clock_now();
   utime_t alloc_stats_dump_clock = ceph_clock_now();
 
   bool interval_stats_trim = false;
@@ -5335,6 +5480,8 @@ void *BlueStore::MempoolThread::entry()
     double max_defer_interval = store->max_defer_interval;
     double alloc_stats_dump_interval =
       store->cct->_conf->bluestore_alloc_stats_dump_interval;
+    double deferred_autotune_interval =
+      store->cct->_conf.get_val<double>("bluestore_deferred_autotune_interval");
 
     // alloc stats dump
     if (alloc_stats_dump_interval > 0 &&
@@ -5350,6 +5497,9 @@ void *BlueStore::MempoolThread::entry()
       if (binned_kv_onode_cache != nullptr) {
         binned_kv_onode_cache->import_bins(store->kv_onode_bins);
       }
+      if (binned_kv_compressed_cache != nullptr) {
+        binned_kv_compressed_cache->import_bins(store->kv_bins);
+      }
       meta_cache->import_bins(store->meta_bins);
       data_cache->import_bins(store->data_bins);
 
@@ -5362,13 +5512,27 @@ void *BlueStore::MempoolThread::entry()
     // cache balancing
     if (autotune_interval > 0 && next_balance < ceph_clock_now()) {
       if (binned_kv_cache != nullptr) {
-        binned_kv_cache->set_cache_ratio(store->cache_kv_ratio);
+        double kv_ratio = store->cache_kv_ratio;
+        if (binned_kv_compressed_cache != nullptr) {
+          // the compressed tier gets its share of the kv ratio
+          double compressed_ratio =
+            store->cct->_conf->rocksdb_cache_compressed_ratio;
+          binned_kv_compressed_cache->set_cache_ratio(
+            kv_ratio * compressed_ratio);
+          kv_ratio *= 1.0 - compressed_ratio;
+        }
+        binned_kv_cache->set_cache_ratio(kv_ratio);
       }
       if (binned_kv_onode_cache != nullptr) {
         binned_kv_onode_cache->set_cache_ratio(store->cache_kv_onode_ratio);
       }
-      meta_cache->set_cache_ratio(store->cache_meta_ratio);
-      data_cache->set_cache_ratio(store->cache_data_ratio);
+      double meta_ratio = store->cache_meta_ratio;
+      double data_ratio = store->cache_data_ratio;
+      if (store->cache_ghost_ratio > 0) {
+        _tune_ghost_split(&meta_ratio, &data_ratio);
+      }
+      meta_cache->set_cache_ratio(meta_ratio);
+      data_cache->set_cache_ratio(data_ratio);
 
       // Log events at 5 instead of 20 when balance happens.
       interval_stats_trim = true;
@@ -5398,6 +5562,13 @@ void *BlueStore::MempoolThread::entry()
       next_deferred_force_submit = ceph_clock_now();
       next_deferred_force_submit += max_defer_interval/3;
     }
+    // deferred write threshold tuning
+    if (deferred_autotune_interval > 0 &&
+	next_deferred_tune < ceph_clock_now()) {
+      store->_tune_deferred();
+      next_deferred_tune = ceph_clock_now();
+      next_deferred_tune += deferred_autotune_interval;
+    }
 
     // Now Resize the shards 
     _resize_shards(interval_stats_trim);
@@ -5475,10 +5646,58 @@ void BlueStore::MempoolThread::_resize_shards(bool interval_stats)
 
   for (auto i : store->onode_cache_shards) {
     i->set_max(max_shard_onodes);
+    i->set_ghost_max(max_shard_onodes * store->cache_ghost_ratio);
   }
   for (auto i : store->buffer_cache_shards) {
     i->set_max(max_shard_buffer);
+    i->set_ghost_max(max_shard_buffer * store->cache_ghost_ratio);
+  }
+}
+
+void BlueStore::MempoolThread::_tune_ghost_split(
+  double *meta_ratio, double *data_ratio)
+{
+  // share moved per balance and the least either cache keeps
+  constexpr double step = 0.02;
+  constexpr double min_share = 0.05;
+
+  double total = *meta_ratio + *data_ratio;
+  if (total <= 0) {
+    return;
+  }
+  if (ghost_meta_share < 0) {
+    ghost_meta_share = *meta_ratio / total;
   }
+  uint64_t meta_hits = 0, meta_weight = 0;
+  for (auto i : store->onode_cache_shards) {
+    i->get_ghost_stats(&meta_hits, &meta_weight);
+  }
+  uint64_t data_hits = 0, data_weight = 0;
+  for (auto i : store->buffer_cache_shards) {
+    i->get_ghost_stats(&data_hits, &data_weight);
+  }
+  uint64_t meta_delta = meta_hits - last_meta_ghost_hits;
+  uint64_t data_delta = data_hits - last_data_ghost_hits;
+  last_meta_ghost_hits = meta_hits;
+  last_data_ghost_hits = data_hits;
+
+  // hits per byte the ghost lists would have turned from misses; the
+  // cache that gains more from another byte gets a bigger share
+  double meta_bytes = meta_weight * meta_cache->get_bytes_per_onode();
+  double meta_gain = meta_bytes > 0 ? meta_delta / meta_bytes : 0;
+  double data_gain = data_weight > 0 ? data_delta / (double)data_weight : 0;
+  if (meta_gain > data_gain * 1.1) {
+    ghost_meta_share = std::min(ghost_meta_share + step, 1.0 - min_share);
+  } else if (data_gain > meta_gain * 1.1) {
+    ghost_meta_share = std::max(ghost_meta_share - step, min_share);
+  }
+  *meta_ratio = total * ghost_meta_share;
+  *data_ratio = total - *meta_ratio;
+  dout(10) << __func__ << " meta ghost hits " << meta_delta
+           << " gain " << meta_gain
+           << " data ghost hits " << data_delta
+           << " gain " << data_gain
+           << " meta share " << ghost_meta_share << dendl;
 }
 
 void BlueStore::MempoolThread::_update_cache_settings()
@@ -5512,6 +5731,78 @@ void BlueStore::MempoolThread::_update_cache_settings()
 
 // =======================================================
 
+// InlineOmapIterator
+
+/// kv iterator over a copy of an inline omap, keyed by the same db keys the
+/// omap would have in its prefix so omap readers need not tell them apart
+class InlineOmapIterator : public KeyValueDB::IteratorImpl {
+  std::string prefix;
+  std::map<std::string, bufferptr> kv;
+  std::map<std::string, bufferptr>::iterator p;
+public:
+  InlineOmapIterator(const std::string& prefix,
+		     std::map<std::string, bufferptr>&& kv)
+    : prefix(prefix), kv(std::move(kv)), p(this->kv.end()) {}
+
+  int seek_to_first() override {
+    p = kv.begin();
+    return 0;
+  }
+  int seek_to_last() override {
+    p = kv.empty() ? kv.end() : std::prev(kv.end());
+    return 0;
+  }
+  int upper_bound(const std::string& after) override {
+    p = kv.upper_bound(after);
+    return 0;
+  }
+  int lower_bound(const std::string& to) override {
+    p = kv.lower_bound(to);
+    return 0;
+  }
+  bool valid() override {
+    return p != kv.end();
+  }
+  int next() override {
+    if (p != kv.end()) {
+      ++p;
+    }
+    return 0;
+  }
+  int prev() override {
+    p = (p == kv.begin()) ? kv.end() : std::prev(p);
+    return 0;
+  }
+  std::string key() override {
+    return p->first;
+  }
+  std::string_view key_as_sv() override {
+    return p->first;
+  }
+  std::pair<std::string, std::string> raw_key() override {
+    return {prefix, p->first};
+  }
+  std::pair<std::string_view, std::string_view> raw_key_as_sv() override {
+    return {prefix, p->first};
+  }
+  bufferlist value() override {
+    bufferlist bl;
+    bl.append(p->second);
+    return bl;
+  }
+  bufferptr value_as_ptr() override {
+    return p->second;
+  }
+  std::string_view value_as_sv() override {
+    return std::string_view(p->second.c_str(), p->second.length());
+  }
+  int status() override {
+    return 0;
+  }
+};
+
+// =======================================================
+
 // OmapIteratorImpl
 
 #undef dout_prefix
@@ -5788,6 +6079,8 @@ const char **BlueStore::get_tracked_conf_keys() const
     "bluestore_warn_on_no_per_pool_omap",
     "bluestore_warn_on_no_per_pg_omap",
     "bluestore_max_defer_interval",
+    "bluestore_write_coalesce_max_bytes",
+    "bluestore_inline_omap_max_bytes",
     NULL
   };
   return KEYS;
@@ -5852,6 +6145,14 @@ void BlueStore::handle_conf_change(const ConfigProxy& conf,
       _set_max_defer_interval();
     }
   }
+  if (changed.count("bluestore_write_coalesce_max_bytes")) {
+    write_coalesce_max_bytes =
+      conf.get_val<Option::size_t>("bluestore_write_coalesce_max_bytes");
+  }
+  if (changed.count("bluestore_inline_omap_max_bytes")) {
+    inline_omap_max_bytes =
+      conf.get_val<Option::size_t>("bluestore_inline_omap_max_bytes");
+  }
   if (changed.count("osd_memory_target") ||
       changed.count("osd_memory_base") ||
       changed.count("osd_memory_cache_min") ||
@@ -6048,6 +6349,8 @@ int BlueStore::_set_cache_sizes()
     return -EINVAL;
   }
 
+  cache_ghost_ratio = cct->_conf.get_val<double>("bluestore_cache_ghost_ratio");
+
   cache_data_ratio = (double)1.0 - 
                      (double)cache_meta_ratio - 
                      (double)cache_kv_ratio - 
@@ -6184,6 +6487,11 @@ void BlueStore::_init_logger()
 	    "au_b",
 	    PerfCountersBuilder::PRIO_CRITICAL,
 	    unit_t(UNIT_BYTES));
+  b.add_u64(l_bluestore_prefer_deferred_size, "prefer_deferred_size",
+	    "Current size threshold for deferred writes",
+	    NULL, PerfCountersBuilder::PRIO_DEBUGONLY, unit_t(UNIT_BYTES));
+  b.add_u64(l_bluestore_deferred_batch_ops, "deferred_batch_ops",
+	    "Current number of deferred writes batched before submission");
   //****************************************
 
   // Update op processing state latencies
@@ -6348,6 +6656,13 @@ void BlueStore::_init_logger()
   b.add_u64_counter(l_bluestore_write_small_skipped_bytes,
       "write_small_skipped_bytes",
       "Small writes into existing or sparse small blobs skipped due to zero detection (bytes)");
+  b.add_u64_counter(l_bluestore_write_coalesced_ops,
+      "write_coalesced_ops",
+      "Writes merged into the preceding adjacent write of a transaction");
+  b.add_u64_counter(l_bluestore_write_coalesced_bytes,
+      "write_coalesced_bytes",
+      "Bytes of writes merged into the preceding adjacent write of a transaction",
+      NULL, PerfCountersBuilder::PRIO_DEBUGONLY, unit_t(UNIT_BYTES));
   //****************************************
 
   // compressions stats
@@ -6367,10 +6682,18 @@ void BlueStore::_init_logger()
   b.add_time_avg(l_bluestore_decompress_lat, "decompress_lat",
 	    "Average decompress latency",
 	    "dcpl", PerfCountersBuilder::PRIO_USEFUL);
+  b.add_u64_counter(l_bluestore_decompress_skipped_bytes,
+	    "decompress_skipped_bytes",
+	    "Sum for bytes of compressed blobs not decompressed by partial reads",
+	    NULL,
+	    PerfCountersBuilder::PRIO_DEBUGONLY,
+	    unit_t(UNIT_BYTES));
   b.add_u64_counter(l_bluestore_compress_success_count, "compress_success_count",
 	    "Sum for beneficial compress ops");
   b.add_u64_counter(l_bluestore_compress_rejected_count, "compress_rejected_count",
 	    "Sum for compress ops rejected due to low net gain of space");
+  b.add_u64_counter(l_bluestore_compress_skipped_count, "compress_skipped_count",
+	    "Sum for blobs not compressed because sampled data looked incompressible");
   //****************************************
 
   // onode cache stats
@@ -6385,11 +6708,19 @@ void BlueStore::_init_logger()
   b.add_u64_counter(l_bluestore_onode_misses, "onode_misses",
 		    "Count of onode cache lookup misses",
 		    "o_ms", PerfCountersBuilder::PRIO_USEFUL);
+  b.add_u64_counter(l_bluestore_onode_ghost_hits, "onode_ghost_hits",
+		    "Count of onode cache misses on recently evicted onodes");
   b.add_u64_counter(l_bluestore_onode_shard_hits, "onode_shard_hits",
 		    "Count of onode shard cache lookups hits");
   b.add_u64_counter(l_bluestore_onode_shard_misses,
 		    "onode_shard_misses",
 		    "Count of onode shard cache lookups misses");
+  b.add_u64_counter(l_bluestore_onode_shard_cold_hits,
+		    "onode_shard_cold_hits",
+		    "Count of onode shards decoded from the compact cold form");
+  b.add_u64_counter(l_bluestore_onode_shard_unloads,
+		    "onode_shard_unloads",
+		    "Count of onode shards moved to the compact cold form");
   b.add_u64(l_bluestore_extents, "onode_extents",
 	    "Number of extents in cache");
   b.add_u64(l_bluestore_blobs, "onode_blobs",
@@ -6415,6 +6746,23 @@ void BlueStore::_init_logger()
 	    NULL,
 	    PerfCountersBuilder::PRIO_DEBUGONLY,
 	    unit_t(UNIT_BYTES));
+  b.add_u64_counter(l_bluestore_buffer_ghost_hits, "buffer_ghost_hits",
+	    "Count of reads missing recently evicted buffers");
+  b.add_u64_counter(l_bluestore_readahead_bytes, "readahead_bytes",
+	    "Sum for bytes prefetched by sequential readahead",
+	    NULL,
+	    PerfCountersBuilder::PRIO_DEBUGONLY,
+	    unit_t(UNIT_BYTES));
+  b.add_u64_counter(l_bluestore_readahead_hit_bytes, "readahead_hit_bytes",
+	    "Sum for bytes of reads served from the readahead range",
+	    NULL,
+	    PerfCountersBuilder::PRIO_DEBUGONLY,
+	    unit_t(UNIT_BYTES));
+  b.add_u64_counter(l_bluestore_readahead_waste_bytes, "readahead_waste_bytes",
+	    "Sum for bytes prefetched but never read",
+	    NULL,
+	    PerfCountersBuilder::PRIO_DEBUGONLY,
+	    unit_t(UNIT_BYTES));
   //****************************************
 
   // internal stats
@@ -6443,6 +6791,11 @@ void BlueStore::_init_logger()
     "amount of keys set by omap setkeys calls");
   b.add_u64_counter(l_bluestore_omap_setkeys_bytes, "omap_setkeys_bytes",
     "amount of bytes set by omap setkeys calls");
+  b.add_u64_counter(l_bluestore_omap_inline_count, "omap_inline_count",
+    "Objects whose omap was started inline in the onode");
+  b.add_u64_counter(l_bluestore_omap_inline_spill_count,
+    "omap_inline_spill_count",
+    "Inline omaps moved to kv after outgrowing the inline limit");
   b.add_u64_counter(l_bluestore_omap_rmkeys_count, "omap_rmkeys_count",
     "amount of omap keys removed via rmkeys");
   b.add_u64_counter(l_bluestore_omap_rmkey_ranges_count, "omap_rmkey_range_count",
@@ -7008,6 +7361,9 @@ void BlueStore::_set_alloc_sizes(void)
       deferred_batch_ops = cct->_conf->bluestore_deferred_batch_ops_ssd;
     }
   }
+  deferred_tuner.base_batch_ops = deferred_batch_ops;
+  logger->set(l_bluestore_prefer_deferred_size, prefer_deferred_size);
+  logger->set(l_bluestore_deferred_batch_ops, deferred_batch_ops);
 
   dout(10) << __func__ << " min_alloc_size 0x" << std::hex << min_alloc_size
 	   << std::dec << " order " << (int)min_alloc_size_order
@@ -7018,6 +7374,58 @@ void BlueStore::_set_alloc_sizes(void)
 	   << dendl;
 }
 
+void BlueStore::_tune_deferred()
+{
+  // average latency since the previous call, 0 if nothing was sampled
+  auto interval_avg = [this](int idx, std::pair<uint64_t, uint64_t>& last) {
+    auto cur = logger->get_tavg_ns(idx);
+    uint64_t count = cur.first - last.first;
+    uint64_t sum = cur.second - last.second;
+    last = cur;
+    return count ? sum / count : 0;
+  };
+  uint64_t direct = interval_avg(l_bluestore_state_aio_wait_lat,
+				 deferred_tuner.aio_wait);
+  uint64_t kv = interval_avg(l_bluestore_kv_commit_lat,
+			     deferred_tuner.kv_commit);
+  if (!direct && !kv) {
+    return; // idle
+  }
+  uint64_t lo = min_alloc_size;
+  uint64_t hi = std::max<uint64_t>(
+    lo,
+    cct->_conf.get_val<Option::size_t>("bluestore_deferred_autotune_max_size"));
+  int base_batch = std::max(deferred_tuner.base_batch_ops, 1);
+  uint64_t pds = prefer_deferred_size;
+  int batch = deferred_batch_ops;
+
+  if (throttle.should_submit_deferred()) {
+    // deferred ios are backing up: send less through the deferred path
+    // and give what is queued a better chance to merge
+    pds = std::max(pds / 2, lo);
+    batch = std::min(batch * 2, base_batch * 4);
+  } else if (direct > kv) {
+    // waiting for the device costs more than the kv commit a deferred
+    // write pays instead
+    pds = std::min(std::max(pds * 2, lo), hi);
+    batch = std::max(batch / 2, base_batch);
+  } else if (direct * 2 < kv) {
+    pds = std::max(pds / 2, lo);
+    batch = std::max(batch / 2, base_batch);
+  }
+  if (pds != prefer_deferred_size || batch != deferred_batch_ops) {
+    dout(10) << __func__ << " direct " << direct << "ns kv " << kv << "ns"
+	     << " prefer_deferred_size 0x" << std::hex << prefer_deferred_size
+	     << " -> 0x" << pds << std::dec
+	     << " deferred_batch_ops " << deferred_batch_ops
+	     << " -> " << batch << dendl;
+    prefer_deferred_size = pds;
+    deferred_batch_ops = batch;
+    logger->set(l_bluestore_prefer_deferred_size, pds);
+    logger->set(l_bluestore_deferred_batch_ops, batch);
+  }
+}
+
 int BlueStore::_open_bdev(bool create)
 {
   ceph_assert(bdev == NULL);
@@ -8066,6 +8474,16 @@ int BlueStore::_open_db(bool create, bool to_repair_db, bool read_only)
   }
   dout(1) << __func__ << " opened " << kv_backend
 	  << " path " << kv_dir_fn << " options " << options << dendl;
+  if (!create && !read_only && !sharding_def.empty() &&
+      cct->_conf.get_val<bool>("bluestore_rocksdb_online_reshard")) {
+    stringstream ss;
+    r = static_cast<RocksDBStore*>(db)->reshard_online(sharding_def, ss);
+    if (r < 0) {
+      // keep running with the stored sharding
+      derr << __func__ << " online reshard to " << sharding_def
+	   << " not started: " << ss.str() << dendl;
+    }
+  }
   return 0;
 }
 
@@ -9237,6 +9655,10 @@ int BlueStore::_mount()
     }
   }
   use_write_v2 = cct->_conf.get_val<bool>("bluestore_write_v2");
+  write_coalesce_max_bytes =
+    cct->_conf.get_val<Option::size_t>("bluestore_write_coalesce_max_bytes");
+  inline_omap_max_bytes =
+    cct->_conf.get_val<Option::size_t>("bluestore_inline_omap_max_bytes");
   if (cct->_conf.get_val<bool>("bluestore_write_v2_random")) {
     srand(time(NULL));
     use_write_v2 = rand() % 2;
@@ -10202,6 +10624,84 @@ public:
       }
     }
   };
+
+  /// Offloads deep fsck object data reads (and hence csum verification)
+  /// while the main thread keeps walking onode metadata.
+  struct FSCKDeepReadQueue : public ThreadPool::WorkQueue_
+  {
+    struct Entry {
+      BlueStore::CollectionRef c;
+      BlueStore::OnodeRef o;
+    };
+
+    BlueStore* store = nullptr;
+    size_t max_queued;
+
+    ceph::mutex lock = ceph::make_mutex("FSCKDeepReadQueue::lock");
+    ceph::condition_variable cond;
+    std::deque<Entry> entries;
+    size_t in_flight = 0;
+    std::atomic<int64_t> errors = {0};
+
+    FSCKDeepReadQueue(std::string n,
+                      size_t _max_queued,
+                      BlueStore* _store) :
+      WorkQueue_(n, ceph::timespan::zero(), ceph::timespan::zero()),
+      store(_store),
+      max_queued(_max_queued)
+    {
+    }
+
+    void _clear() override {
+      //do nothing
+    }
+    bool _empty() override {
+      ceph_assert(false);
+    }
+
+    void* _void_dequeue() override {
+      std::unique_lock l(lock);
+      if (entries.empty()) {
+        // ShallowFSCKThreadPool::worker polls, avoid spinning when idle
+        cond.wait_for(l, std::chrono::milliseconds(100));
+        if (entries.empty()) {
+          return nullptr;
+        }
+      }
+      Entry* e = new Entry(std::move(entries.front()));
+      entries.pop_front();
+      ++in_flight;
+      cond.notify_all();
+      return e;
+    }
+    void _void_process(void* item, TPHandle& handle) override {
+      Entry* e = (Entry*)item;
+      errors += store->fsck_read_object_data(e->c, e->o);
+      delete e;
+      std::lock_guard l(lock);
+      --in_flight;
+      cond.notify_all();
+    }
+    void _void_process_finish(void*) override {
+      ceph_assert(false);
+    }
+
+    void queue(BlueStore::CollectionRef c, BlueStore::OnodeRef o) {
+      std::unique_lock l(lock);
+      cond.wait(l, [this] { return entries.size() < max_queued; });
+      entries.push_back(Entry{std::move(c), std::move(o)});
+      cond.notify_all();
+    }
+
+    void finalize(ThreadPool& tp, int64_t& ctx_errors) {
+      {
+        std::unique_lock l(lock);
+        cond.wait(l, [this] { return entries.empty() && in_flight == 0; });
+      }
+      tp.stop();
+      ctx_errors += errors;
+    }
+  };
 };
 
 void BlueStore::_fsck_check_object_omap(FSCKDepth depth,
@@ -10388,6 +10888,24 @@ void BlueStore::_fsck_check_objects(
       thread_pool.start();
     }
 
+    // Deep fsck is dominated by reading object data, which only needs
+    // the onode, so let dedicated threads do that while this thread
+    // proceeds with the metadata checks that update shared state.
+    const size_t deep_read_threads = depth == FSCK_DEEP ?
+      cct->_conf.get_val<uint64_t>("bluestore_fsck_deep_read_threads") : 0;
+    typedef ShallowFSCKThreadPool::FSCKDeepReadQueue DeepWQ;
+    std::unique_ptr<DeepWQ> deep_wq;
+    std::unique_ptr<ShallowFSCKThreadPool> deep_thread_pool;
+    if (deep_read_threads > 0) {
+      deep_wq.reset(new DeepWQ("FSCKDeepReadQueue",
+                               deep_read_threads * 4,
+                               this));
+      deep_thread_pool.reset(new ShallowFSCKThreadPool(
+        cct, "DeepFSCKThreadPool", "DeepFSCK", deep_read_threads));
+      deep_thread_pool->add_work_queue(deep_wq.get());
+      deep_thread_pool->start();
+    }
+
     // fill global if not overriden below
     CollectionRef c;
     int64_t pool_id = -1;
@@ -10573,27 +11091,17 @@ void BlueStore::_fsck_check_objects(
           }
         } // if (o->onode.has_omap())
         if (depth == FSCK_DEEP) {
-          bufferlist bl;
-          uint64_t max_read_block = cct->_conf->bluestore_fsck_read_bytes_cap;
-          uint64_t offset = 0;
-          do {
-            uint64_t l = std::min(uint64_t(o->onode.size - offset), max_read_block);
-            int r = _do_read(c.get(), o, offset, l, bl,
-              CEPH_OSD_OP_FLAG_FADVISE_NOCACHE);
-            if (r < 0) {
-              ++errors;
-              derr << "fsck error: " << oid << std::hex
-                << " error during read: "
-                << " " << offset << "~" << l
-                << " " << cpp_strerror(r) << std::dec
-                << dendl;
-              break;
-            }
-            offset += l;
-          } while (offset < o->onode.size);
+          if (deep_read_threads > 0) {
+            deep_wq->queue(c, o);
+          } else {
+            errors += fsck_read_object_data(c, o);
+          }
         } // deep
       } //if (depth != FSCK_SHALLOW)
     } // for (it->lower_bound(string()); it->valid(); it->next())
+    if (deep_read_threads > 0) {
+      deep_wq->finalize(*deep_thread_pool, errors);
+    }
     if (depth == FSCK_SHALLOW && thread_count > 0) {
       wq->finalize(thread_pool, ctx);
       if (processed_myself) {
@@ -10607,6 +11115,32 @@ void BlueStore::_fsck_check_objects(
     }
   } // if (it)
 }
+int64_t BlueStore::fsck_read_object_data(
+  CollectionRef& c,
+  OnodeRef& o)
+{
+  int64_t errors = 0;
+  bufferlist bl;
+  uint64_t max_read_block = cct->_conf->bluestore_fsck_read_bytes_cap;
+  uint64_t offset = 0;
+  do {
+    uint64_t l = std::min(uint64_t(o->onode.size - offset), max_read_block);
+    int r = _do_read(c.get(), o, offset, l, bl,
+      CEPH_OSD_OP_FLAG_FADVISE_NOCACHE);
+    if (r < 0) {
+      ++errors;
+      derr << "fsck error: " << o->oid << std::hex
+        << " error during read: "
+        << " " << offset << "~" << l
+        << " " << cpp_strerror(r) << std::dec
+        << dendl;
+      break;
+    }
+    offset += l;
+  } while (offset < o->onode.size);
+  return errors;
+}
+
 /**
 An overview for currently implemented repair logics 
 performed in fsck in two stages: detection(+preparation) and commit.
@@ -12558,7 +13092,9 @@ int BlueStore::_generate_read_result_bl(
   blobs2read_t& blobs2read,
   bool buffered,
   bool* csum_error,
-  bufferlist& bl)
+  bufferlist& bl,
+  uint64_t readahead_offset,
+  bool cache_readahead)
 {
  // enumerate and decompress desired blobs
   auto p = compressed_blob_bls.begin();
@@ -12578,17 +13114,45 @@ int BlueStore::_generate_read_result_bl(
         *csum_error = true;
         return -EIO;
       }
+      // only decompress up to the end of the last region we use
+      uint64_t want_len = blob_offset + length;
+      for (auto& req : r2r) {
+        for (auto& r : req.regs) {
+          if (r.logical_offset < readahead_offset || cache_readahead) {
+            want_len = std::max<uint64_t>(want_len, r.blob_xoffset + r.length);
+          }
+        }
+      }
       bufferlist raw_bl;
-      auto r = _decompress(compressed_bl, &raw_bl);
+      auto r = _decompress(compressed_bl, &raw_bl, want_len);
       if (r < 0)
         return r;
-      if (buffered) {
+      if (raw_bl.length() < want_len) {
+        derr << __func__ << " decompressed 0x" << std::hex << raw_bl.length()
+             << " < 0x" << want_len << std::dec << " on blob " << *bptr
+             << dendl;
+        return -EIO;
+      }
+      if (bptr->get_blob().get_logical_length() > raw_bl.length()) {
+        logger->inc(l_bluestore_decompress_skipped_bytes,
+          bptr->get_blob().get_logical_length() - raw_bl.length());
+      }
+      if (buffered && offset < readahead_offset) {
         bufferlist region_buffer;
         region_buffer.substr_of(raw_bl, blob_offset, length);
         o->bc.did_read(o->c->cache, offset, std::move(region_buffer));
       }
       for (auto& req : r2r) {
         for (auto& r : req.regs) {
+          if (r.logical_offset >= readahead_offset) {
+            if (cache_readahead) {
+              bufferlist region_buffer;
+              region_buffer.substr_of(raw_bl, r.blob_xoffset, r.length);
+              o->bc.did_read(o->c->cache, r.logical_offset,
+                             std::move(region_buffer), 0);
+            }
+            continue;
+          }
           ready_regions[r.logical_offset].substr_of(
             raw_bl, r.blob_xoffset, r.length);
         }
@@ -12603,6 +13167,16 @@ int BlueStore::_generate_read_result_bl(
 
         // prune and keep result
         for (const auto& r : req.regs) {
+          if (r.logical_offset >= readahead_offset) {
+            // prefetched: park it at the cold end of the cache
+            if (cache_readahead) {
+              bufferlist region_buffer;
+              region_buffer.substr_of(req.bl, r.front, r.length);
+              o->bc.did_read(o->c->cache, r.logical_offset,
+                             std::move(region_buffer), 0);
+            }
+            continue;
+          }
           if (buffered) {
             bufferlist region_buffer;
             region_buffer.substr_of(req.bl, r.front, r.length);
@@ -12647,6 +13221,64 @@ int BlueStore::_generate_read_result_bl(
   return 0;
 }
 
+uint64_t BlueStore::_readahead_window(
+  OnodeRef& o,
+  uint64_t offset,
+  size_t length,
+  uint32_t op_flags)
+{
+  uint64_t max = cct->_conf->bluestore_readahead_max_bytes;
+  if (!max) {
+    return 0;
+  }
+  uint64_t end = offset + length;
+  uint64_t expected = o->ra_next_offset.exchange(end);
+  uint64_t ra_start = o->ra_start;
+  uint64_t ra_end = o->ra_end;
+  if (offset < ra_end && end > ra_start) {
+    logger->inc(l_bluestore_readahead_hit_bytes,
+		std::min(end, ra_end) - std::max(offset, ra_start));
+  }
+  if (offset != expected ||
+      (op_flags & (CEPH_OSD_OP_FLAG_FADVISE_RANDOM |
+		   CEPH_OSD_OP_FLAG_FADVISE_DONTNEED |
+		   CEPH_OSD_OP_FLAG_FADVISE_NOCACHE |
+		   CEPH_OSD_OP_FLAG_BYPASS_CLEAN_CACHE))) {
+    // stream broken; whatever it did not consume was read for nothing
+    uint64_t consumed = std::max(expected, ra_start);
+    if (ra_end > consumed) {
+      logger->inc(l_bluestore_readahead_waste_bytes, ra_end - consumed);
+    }
+    o->ra_seq_reads = 0;
+    o->ra_start = 0;
+    o->ra_end = 0;
+    return 0;
+  }
+  if (++o->ra_seq_reads < cct->_conf->bluestore_readahead_trigger_reads) {
+    return 0;
+  }
+  uint64_t limit = std::min<uint64_t>(end + max, o->onode.size);
+  // keep a full window ahead of the reader, but only top it up once
+  // at least half of it has been consumed
+  if (ra_end > end && ra_end - end > max / 2) {
+    return 0;
+  }
+  uint64_t start = std::max(end, ra_end);
+  if (start >= limit) {
+    return 0;
+  }
+  // ask for the whole window; the part prefetched earlier is normally
+  // still cached and will not be read again
+  uint64_t len = limit - end;
+  o->ra_start = end;
+  o->ra_end = limit;
+  logger->inc(l_bluestore_readahead_bytes, limit - start);
+  dout(20) << __func__ << " sequential read #" << o->ra_seq_reads
+	   << ", readahead 0x" << std::hex << end << "~" << len
+	   << std::dec << dendl;
+  return len;
+}
+
 int BlueStore::_do_read(
   Collection *c,
   OnodeRef& o,
@@ -12686,8 +13318,12 @@ int BlueStore::_do_read(
     length = o->onode.size - offset;
   }
 
+  uint64_t ra_length = retry_count ? 0 :
+    _readahead_window(o, offset, length, op_flags);
+  uint64_t ra_offset = offset + length;
+
   auto start = mono_clock::now();
-  o->extent_map.fault_range(db, offset, length);
+  o->extent_map.fault_range(db, offset, length + ra_length);
   log_latency(__func__,
     l_bluestore_read_onode_meta_lat,
     mono_clock::now() - start,
@@ -12706,7 +13342,13 @@ int BlueStore::_do_read(
   ready_regions_t ready_regions;
   blobs2read_t blobs2read;
   _read_cache(o, offset, length, read_cache_policy, ready_regions, blobs2read);
-
+  if (ra_length) {
+    // piggyback the prefetch on the same aio batch; whatever is already
+    // cached in the readahead range is left alone.
+    ready_regions_t ra_cached;
+    _read_cache(o, ra_offset, ra_length, read_cache_policy, ra_cached,
+		blobs2read);
+  }
 
   // read raw blob data.
   start = mono_clock::now(); // for the sake of simplicity
@@ -12743,7 +13385,8 @@ int BlueStore::_do_read(
   r = _generate_read_result_bl(o, offset, length, ready_regions,
                               compressed_blob_bls, blobs2read,
                               buffered && !ioc.skip_cache(),
-                              &csum_error, bl);
+                              &csum_error, bl,
+                              ra_offset, !ioc.skip_cache());
   if (csum_error) {
     // Handles spurious read errors caused by a kernel bug.
     // We sometimes get all-zero pages as a result of the read under
@@ -12819,7 +13462,12 @@ int BlueStore::_verify_csum(OnodeRef& o,
   return r;
 }
 
-int BlueStore::_decompress(bufferlist& source, bufferlist* result)
+/*
+ * want_len limits decompression to the leading part of the original data
+ * the caller needs, codecs which can stop early then skip the rest.
+ */
+int BlueStore::_decompress(bufferlist& source, bufferlist* result,
+                           uint64_t want_len)
 {
   int r = 0;
   auto start = mono_clock::now();
@@ -12841,7 +13489,8 @@ int BlueStore::_decompress(bufferlist& source, bufferlist* result)
     _set_compression_alert(false, alg_name);
     r = -EIO;
   } else {
-    r = cp->decompress(i, chdr.length, *result, chdr.compressor_message);
+    r = cp->decompress_prefix(i, chdr.length, want_len, *result,
+                              chdr.compressor_message);
     if (r < 0) {
       derr << __func__ << " decompression failed with exit code " << r << dendl;
       r = -EIO;
@@ -13462,6 +14111,34 @@ int BlueStore::_omap_get(
   return r;
 }
 
+KeyValueDB::Iterator BlueStore::_get_omap_kv_iterator(
+  const OnodeRef& o,
+  KeyValueDB::IteratorOpts opts,
+  KeyValueDB::IteratorBounds bounds)
+{
+  if (!o->onode.has_inline_omap()) {
+    return db->get_iterator(o->get_omap_prefix(), opts, std::move(bounds));
+  }
+  auto in_bounds = [&bounds](const std::string& k) {
+    return (!bounds.lower_bound || k >= *bounds.lower_bound) &&
+      (!bounds.upper_bound || k < *bounds.upper_bound);
+  };
+  std::map<std::string, bufferptr> kv;
+  std::string key;
+  o->get_omap_header(&key);
+  if (o->onode.inline_omap_header.length() && in_bounds(key)) {
+    kv.emplace(key, o->onode.inline_omap_header);
+  }
+  for (auto& [k, v] : o->onode.inline_omap) {
+    o->get_omap_key(std::string(k.data(), k.size()), &key);
+    if (in_bounds(key)) {
+      kv.emplace_hint(kv.end(), key, v);
+    }
+  }
+  return std::make_shared<InlineOmapIterator>(o->get_omap_prefix(),
+					      std::move(kv));
+}
+
 int BlueStore::_onode_omap_get(
   const OnodeRef &o,           ///< [in] Object containing omap
   bufferlist *header,          ///< [out] omap header
@@ -13477,27 +14154,44 @@ int BlueStore::_onode_omap_get(
     goto out;
   o->flush();
   {
-    const string& prefix = o->get_omap_prefix();
     string head, tail;
     o->get_omap_header(&head);
     o->get_omap_tail(&tail);
-    KeyValueDB::Iterator it = db->get_iterator(prefix, 0, KeyValueDB::IteratorBounds{head, tail});
+    KeyValueDB::Iterator it = _get_omap_kv_iterator(
+      o, KeyValueDB::ITERATOR_PREFETCH,
+      KeyValueDB::IteratorBounds{head, tail});
     it->lower_bound(head);
-    while (it->valid()) {
-      if (it->key() == head) {
-        dout(30) << __func__ << "  got header" << dendl;
-        *header = it->value();
-      } else if (it->key() >= tail) {
-        dout(30) << __func__ << "  reached tail" << dendl;
-        break;
-      } else {
-        string user_key;
-        o->decode_omap_key(it->key(), &user_key);
-        dout(20) << __func__ << "  got " << pretty_binary_string(it->key())
-          << " -> " << user_key << dendl;
-        (*out)[user_key] = it->value();
+    // Pull entries in batches; values stay views into the batch arena.
+    // Arenas start small so tiny omaps don't pin much memory and grow
+    // for the big ones.
+    const size_t userkey_offset = o->calc_userkey_offset_in_omap_key();
+    size_t batch_bytes = 4096;
+    KeyValueDB::KVBatch batch;
+    bool done = false;
+    while (!done && it->valid()) {
+      if (it->next_batch(256, batch_bytes, &batch) < 0 && batch.empty()) {
+	break;
+      }
+      batch_bytes = std::min<size_t>(batch_bytes * 2, 256 << 10);
+      for (auto& [k, v] : batch.entries) {
+	std::string_view key(k.c_str(), k.length());
+	if (key == head) {
+	  dout(30) << __func__ << "  got header" << dendl;
+	  header->clear();
+	  header->append(v);
+	} else if (key >= tail) {
+	  dout(30) << __func__ << "  reached tail" << dendl;
+	  done = true;
+	  break;
+	} else {
+	  string user_key(key.substr(userkey_offset));
+	  dout(20) << __func__ << "  got " << pretty_binary_string(key)
+		   << " -> " << user_key << dendl;
+	  bufferlist& bl = (*out)[user_key];
+	  bl.clear();
+	  bl.append(v);
+	}
       }
-      it->next();
     }
   }
 out:
@@ -13525,7 +14219,10 @@ int BlueStore::omap_get_header(
   if (!o->onode.has_omap())
     goto out;
   o->flush();
-  {
+  if (o->onode.has_inline_omap()) {
+    header->clear();
+    header->append(o->onode.inline_omap_header);
+  } else {
     string head;
     o->get_omap_header(&head);
     if (db->get(o->get_omap_prefix(), head, header) >= 0) {
@@ -13562,11 +14259,10 @@ int BlueStore::omap_get_keys(
     goto out;
   o->flush();
   {
-    const string& prefix = o->get_omap_prefix();
     string head, tail;
     o->get_omap_key(string(), &head);
     o->get_omap_tail(&tail);
-    KeyValueDB::Iterator it = db->get_iterator(prefix, 0, KeyValueDB::IteratorBounds{head, tail});
+    KeyValueDB::Iterator it = _get_omap_kv_iterator(o, 0, KeyValueDB::IteratorBounds{head, tail});
     it->lower_bound(head);
     while (it->valid()) {
       if (it->key() >= tail) {
@@ -13617,7 +14313,17 @@ int BlueStore::omap_get_values(
     goto out;
   }
   o->flush();
-  {
+  if (o->onode.has_inline_omap()) {
+    auto& inline_omap = o->onode.inline_omap;
+    for (auto& k : keys) {
+      auto q = inline_omap.find(
+	mempool::bluestore_cache_meta::string(k.data(), k.size()));
+      if (q != inline_omap.end()) {
+	dout(30) << __func__ << "  got inline " << k << dendl;
+	(*out)[k].append(q->second);
+      }
+    }
+  } else {
     const string& prefix = o->get_omap_prefix();
     o->get_omap_key(string(), &final_key);
     size_t base_key_len = final_key.size();
@@ -13667,7 +14373,15 @@ int BlueStore::omap_check_keys(
     goto out;
   }
   o->flush();
-  {
+  if (o->onode.has_inline_omap()) {
+    auto& inline_omap = o->onode.inline_omap;
+    for (auto& k : keys) {
+      if (inline_omap.count(
+	    mempool::bluestore_cache_meta::string(k.data(), k.size()))) {
+	out->insert(k);
+      }
+    }
+  } else {
     const string& prefix = o->get_omap_prefix();
     o->get_omap_key(string(), &final_key);
     size_t base_key_len = final_key.size();
@@ -13717,7 +14431,7 @@ ObjectMap::ObjectMapIterator BlueStore::get_omap_iterator(
     bounds.lower_bound = std::move(lower_bound);
     bounds.upper_bound = std::move(upper_bound);
   }
-  KeyValueDB::Iterator it = db->get_iterator(o->get_omap_prefix(), 0, std::move(bounds));
+  KeyValueDB::Iterator it = _get_omap_kv_iterator(o, 0, std::move(bounds));
   return ObjectMap::ObjectMapIterator(new OmapIteratorImpl(logger,c, o, it));
 }
 
@@ -13754,7 +14468,7 @@ int BlueStore::omap_iterate(
     o->get_omap_tail(&upper_bound);
     bounds.lower_bound = std::move(lower_bound);
     bounds.upper_bound = std::move(upper_bound);
-    it = db->get_iterator(o->get_omap_prefix(), 0, std::move(bounds));
+    it = _get_omap_kv_iterator(o, 0, std::move(bounds));
   }
 
   // seek the iterator
@@ -14200,22 +14914,7 @@ void BlueStore::_txc_state_proc(TransContext *txc)
 	  _txc_apply_kv(txc, true);
 	}
       }
-      {
-	std::lock_guard l(kv_lock);
-	kv_queue.push_back(txc);
-	if (!kv_sync_in_progress) {
-	  kv_sync_in_progress = true;
-	  kv_cond.notify_one();
-	}
-	if (txc->get_state() != TransContext::STATE_KV_SUBMITTED) {
-	  kv_queue_unsubmitted.push_back(txc);
-	  ++txc->osr->kv_committing_serially;
-	}
-	if (txc->had_ios)
-	  kv_ios++;
-	kv_throttle_costs += txc->cost;
-	++kv_throttle_txcs;
-      }
+      _txc_queue_kv(txc);
       return;
     case TransContext::STATE_KV_SUBMITTED:
       _txc_committed_kv(txc);
@@ -14250,6 +14949,69 @@ void BlueStore::_txc_state_proc(TransContext *txc)
   }
 }
 
+void BlueStore::_txc_queue_kv(TransContext *txc)
+{
+  if (txc->get_state() != TransContext::STATE_KV_SUBMITTED) {
+    ++txc->osr->kv_committing_serially;
+  }
+  if (!kv_submit_shards.empty()) {
+    // we hold osr->qlock, so txcs of one sequencer enter their shard in
+    // order; the kv sync thread restores FIFO order when it drains.
+    auto& shard = kv_submit_shards[
+      txc->osr->get_sequencer_id() % kv_submit_shards.size()];
+    shard.push(txc);
+    if (!kv_sync_in_progress.exchange(true)) {
+      std::lock_guard l(kv_lock);
+      kv_cond.notify_one();
+    }
+    return;
+  }
+  std::lock_guard l(kv_lock);
+  kv_queue.push_back(txc);
+  if (!kv_sync_in_progress) {
+    kv_sync_in_progress = true;
+    kv_cond.notify_one();
+  }
+  if (txc->get_state() != TransContext::STATE_KV_SUBMITTED) {
+    kv_queue_unsubmitted.push_back(txc);
+  }
+  if (txc->had_ios)
+    kv_ios++;
+  kv_throttle_costs += txc->cost;
+  ++kv_throttle_txcs;
+}
+
+bool BlueStore::_kv_submit_shards_empty() const
+{
+  for (auto& shard : kv_submit_shards) {
+    if (!shard.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BlueStore::_kv_drain_submit_shards()
+{
+  // caller holds kv_lock
+  for (auto& shard : kv_submit_shards) {
+    TransContext *txc = shard.pop_all();
+    while (txc) {
+      TransContext *next = txc->kv_submit_next;
+      txc->kv_submit_next = nullptr;
+      kv_queue.push_back(txc);
+      if (txc->get_state() != TransContext::STATE_KV_SUBMITTED) {
+	kv_queue_unsubmitted.push_back(txc);
+      }
+      if (txc->had_ios)
+	kv_ios++;
+      kv_throttle_costs += txc->cost;
+      ++kv_throttle_txcs;
+      txc = next;
+    }
+  }
+}
+
 void BlueStore::_txc_finish_io(TransContext *txc)
 {
   dout(20) << __func__ << " " << txc << dendl;
@@ -14739,8 +15501,15 @@ void BlueStore::_kv_start()
   dout(10) << __func__ << dendl;
 
   finisher.start();
+  kv_submit_shards = std::vector<KVSubmitShard>(
+    cct->_conf.get_val<uint64_t>("bluestore_kv_sync_queue_shards"));
   kv_sync_thread.create("bstore_kv_sync");
   kv_finalize_thread.create("bstore_kv_final");
+  auto lanes = cct->_conf.get_val<uint64_t>("bluestore_kv_sync_lanes");
+  for (uint64_t i = 1; i < lanes; ++i) {
+    kv_sync_lanes.emplace_back(std::make_unique<KVSyncLane>(this));
+    kv_sync_lanes.back()->create("bstore_kv_lane");
+  }
 }
 
 void BlueStore::_kv_stop()
@@ -14764,6 +15533,15 @@ void BlueStore::_kv_stop()
   }
   kv_sync_thread.join();
   kv_finalize_thread.join();
+  for (auto& lane : kv_sync_lanes) {
+    {
+      std::lock_guard l(lane->lock);
+      lane->stop = true;
+      lane->cond.notify_all();
+    }
+    lane->join();
+  }
+  kv_sync_lanes.clear();
   ceph_assert(removed_collections.empty());
   {
     std::lock_guard l(kv_lock);
@@ -14807,14 +15585,20 @@ void BlueStore::_kv_sync_thread()
       kv_submitted = 0;
     }
     ceph_assert(kv_committing.empty());
+    _kv_drain_submit_shards();
     if (kv_queue.empty() &&
 	((deferred_done_queue.empty() && deferred_stable_queue.empty()) ||
 	 !deferred_aggressive)) {
-      if (kv_stop)
+      if (kv_stop && _kv_submit_shards_empty())
 	break;
       dout(20) << __func__ << " sleep" << dendl;
       auto t = mono_clock::now();
       kv_sync_in_progress = false;
+      if (!_kv_submit_shards_empty()) {
+	// raced with a lockless producer that saw us still in progress
+	kv_sync_in_progress = true;
+	continue;
+      }
       kv_cond.wait(l);
       twait += mono_clock::now() - t;
 
@@ -14914,12 +15698,20 @@ void BlueStore::_kv_sync_thread()
 	dout(10) << __func__ << " new_blobid_max " << new_blobid_max << dendl;
       }
 
+      std::vector<std::vector<TransContext*>> lane_batches(
+	kv_sync_lanes.size() + 1);
       for (auto txc : kv_committing) {
 	throttle.log_state_latency(*txc, logger, l_bluestore_state_kv_queued_lat);
 	if (txc->get_state() == TransContext::STATE_KV_QUEUED) {
 	  ++kv_submitted;
-	  _txc_apply_kv(txc, false);
-	  --txc->osr->kv_committing_serially;
+	  if (kv_sync_lanes.empty()) {
+	    _txc_apply_kv(txc, false);
+	    --txc->osr->kv_committing_serially;
+	  } else {
+	    // a sequencer always maps to the same lane, keeping its order
+	    lane_batches[txc->osr->get_sequencer_id() % lane_batches.size()]
+	      .push_back(txc);
+	  }
 	} else {
 	  ceph_assert(txc->get_state() == TransContext::STATE_KV_SUBMITTED);
 	}
@@ -14927,6 +15719,9 @@ void BlueStore::_kv_sync_thread()
 	  --txc->osr->txc_with_unstable_io;
 	}
       }
+      if (!kv_sync_lanes.empty()) {
+	_kv_sync_lanes_submit(lane_batches);
+      }
 
       // release throttle *before* we commit.  this allows new ops
       // to be prepared and enter pipeline while we are waiting on
@@ -15053,6 +15848,68 @@ void BlueStore::_kv_sync_thread()
   kv_sync_started = false;
 }
 
+void BlueStore::_kv_sync_lanes_submit(
+  std::vector<std::vector<TransContext*>>& batches)
+{
+  ceph_assert(batches.size() == kv_sync_lanes.size() + 1);
+  unsigned busy = 0;
+  for (size_t i = 0; i < kv_sync_lanes.size(); ++i) {
+    if (!batches[i + 1].empty()) {
+      ++busy;
+    }
+  }
+  {
+    std::lock_guard l(kv_lanes_lock);
+    kv_lanes_busy = busy;
+  }
+  for (size_t i = 0; i < kv_sync_lanes.size(); ++i) {
+    if (batches[i + 1].empty()) {
+      continue;
+    }
+    auto& lane = kv_sync_lanes[i];
+    std::lock_guard l(lane->lock);
+    ceph_assert(lane->queue.empty());
+    lane->queue.swap(batches[i + 1]);
+    lane->cond.notify_one();
+  }
+  // lane 0 is ourselves
+  for (auto txc : batches[0]) {
+    _txc_apply_kv(txc, false);
+    --txc->osr->kv_committing_serially;
+  }
+  std::unique_lock l(kv_lanes_lock);
+  kv_lanes_cond.wait(l, [this] { return kv_lanes_busy == 0; });
+}
+
+void BlueStore::_kv_sync_lane_thread(KVSyncLane *lane)
+{
+  dout(10) << __func__ << " start" << dendl;
+  std::unique_lock l(lane->lock);
+  while (true) {
+    if (lane->queue.empty()) {
+      if (lane->stop)
+	break;
+      lane->cond.wait(l);
+      continue;
+    }
+    std::vector<TransContext*> q;
+    q.swap(lane->queue);
+    l.unlock();
+    for (auto txc : q) {
+      _txc_apply_kv(txc, false);
+      --txc->osr->kv_committing_serially;
+    }
+    {
+      std::lock_guard ll(kv_lanes_lock);
+      if (--kv_lanes_busy == 0) {
+	kv_lanes_cond.notify_one();
+      }
+    }
+    l.lock();
+  }
+  dout(10) << __func__ << " finish" << dendl;
+}
+
 void BlueStore::_kv_finalize_thread()
 {
   deque<TransContext*> kv_committed;
@@ -15589,6 +16446,65 @@ void BlueStore::_txc_aio_submit(TransContext *txc)
   bdev->aio_submit(&txc->ioc);
 }
 
+int BlueStore::_coalesce_writes(
+  Transaction::iterator& i,
+  const Transaction::Op& op,
+  uint64_t *off,
+  uint64_t *len,
+  bufferlist& bl)
+{
+  if (bl.length() < *len) {
+    return 0;
+  }
+  if (bl.length() > *len) {
+    bl.splice(*len, bl.length() - *len);
+  }
+  int merged = 0;
+  const Transaction::Op* next;
+  while ((next = i.peek_op()) != nullptr &&
+	 next->op == Transaction::OP_WRITE &&
+	 next->cid == op.cid &&
+	 next->oid == op.oid) {
+    uint64_t noff = next->off;
+    uint64_t nlen = next->len;
+    uint64_t start = std::min(*off, noff);
+    uint64_t end = std::max(*off + *len, noff + nlen);
+    // only ranges that touch, so the result stays a single write
+    if (noff > *off + *len || noff + nlen < *off ||
+	end - start > write_coalesce_max_bytes) {
+      break;
+    }
+    i.decode_op();
+    bufferlist nbl;
+    i.decode_bl(nbl);
+    ++merged;
+    if (nbl.length() > nlen) {
+      nbl.splice(nlen, nbl.length() - nlen);
+    }
+    ceph_assert(nbl.length() == nlen);
+    dout(20) << __func__ << " 0x" << std::hex << *off << "~" << *len
+	     << " += 0x" << noff << "~" << nlen << std::dec << dendl;
+    // the later write wins where the two overlap
+    bufferlist m;
+    if (start < noff) {
+      m.substr_of(bl, 0, noff - start);
+    }
+    m.claim_append(nbl);
+    if (*off + *len > noff + nlen) {
+      bufferlist tail;
+      tail.substr_of(bl, noff + nlen - *off, *off + *len - (noff + nlen));
+      m.claim_append(tail);
+    }
+    bl.swap(m);
+    *off = start;
+    *len = end - start;
+    ceph_assert(bl.length() == *len);
+    logger->inc(l_bluestore_write_coalesced_ops);
+    logger->inc(l_bluestore_write_coalesced_bytes, nlen);
+  }
+  return merged;
+}
+
 void BlueStore::_txc_add_transaction(TransContext *txc, Transaction *t)
 {
   Transaction::iterator i = t->begin();
@@ -15752,6 +16668,9 @@ void BlueStore::_txc_add_transaction(TransContext *txc, Transaction *t)
 	uint32_t fadvise_flags = i.get_fadvise_flags();
         bufferlist bl;
         i.decode_bl(bl);
+	if (write_coalesce_max_bytes) {
+	  pos += _coalesce_writes(i, *op, &off, &len, bl);
+	}
 	r = _write(txc, c, o, off, len, bl, fadvise_flags);
       }
       break;
@@ -16774,6 +17693,42 @@ void BlueStore::_do_write_big(
   }
 }
 
+// order-0 entropy, in bits per byte, of a few evenly spaced chunks of bl
+static double sample_entropy(const bufferlist& bl)
+{
+  constexpr unsigned chunks = 16;
+  constexpr unsigned chunk_len = 256;
+  unsigned hist[256] = {0};
+  unsigned total = 0;
+  unsigned len = bl.length();
+  unsigned stride = len / chunks;
+  auto p = bl.cbegin();
+  for (unsigned i = 0; i < chunks && stride >= chunk_len; ++i) {
+    p.seek(i * stride);
+    unsigned left = chunk_len;
+    while (left > 0) {
+      const char *d;
+      size_t n = p.get_ptr_and_advance(left, &d);
+      for (size_t j = 0; j < n; ++j) {
+	++hist[(unsigned char)d[j]];
+      }
+      left -= n;
+      total += n;
+    }
+  }
+  if (total == 0) {
+    return 0;
+  }
+  double h = 0;
+  for (auto n : hist) {
+    if (n) {
+      double f = (double)n / total;
+      h -= f * std::log2(f);
+    }
+  }
+  return h;
+}
+
 int BlueStore::_do_alloc_write(
   TransContext *txc,
   CollectionRef coll,
@@ -16843,7 +17798,20 @@ int BlueStore::_do_alloc_write(
   // and the condition is : (data_size < deferred).
 
   auto max_bsize = std::max(wctx->target_blob_size, min_alloc_size);
+  double skip_entropy = cct->_conf->bluestore_compression_skip_entropy;
   for (auto& wi : wctx->writes) {
+    if (c && wi.blob_length > min_alloc_size && skip_entropy > 0) {
+      double h = sample_entropy(wi.bl);
+      if (h >= skip_entropy) {
+	dout(20) << __func__ << std::hex << "  0x" << wi.blob_length
+		 << std::dec << " bytes sampled at " << h
+		 << " bits/byte, leaving uncompressed" << dendl;
+	logger->inc(l_bluestore_compress_skipped_count);
+	need += wi.blob_length;
+	data_size += wi.bl.length();
+	continue;
+      }
+    }
     if (c && wi.blob_length > min_alloc_size) {
       auto start = mono_clock::now();
 
@@ -17921,8 +18889,64 @@ int BlueStore::_rmattrs(TransContext *txc,
   return r;
 }
 
+void BlueStore::_init_omap(TransContext *txc, OnodeRef& o)
+{
+  if (o->oid.is_pgmeta()) {
+    o->onode.set_omap_flags_pgmeta();
+  } else {
+    o->onode.set_omap_flags(per_pool_omap == OMAP_BULK);
+  }
+  txc->write_onode(o);
+
+  // inline omaps have no kv keys at all, not even the tail
+  if (inline_omap_max_bytes > 0 && o->onode.is_perpg_omap()) {
+    o->onode.set_flag(bluestore_onode_t::FLAG_INLINE_OMAP);
+    logger->inc(l_bluestore_omap_inline_count);
+    return;
+  }
+  const string& prefix = o->get_omap_prefix();
+  string key_tail;
+  bufferlist tail;
+  o->get_omap_tail(&key_tail);
+  txc->t->set(prefix, key_tail, tail);
+}
+
+void BlueStore::_maybe_spill_inline_omap(TransContext *txc, OnodeRef& o)
+{
+  uint64_t bytes = o->onode.get_inline_omap_bytes();
+  if (bytes <= inline_omap_max_bytes) {
+    return;
+  }
+  dout(20) << __func__ << " " << o->oid << " " << o->onode.inline_omap.size()
+	   << " keys, " << bytes << " bytes" << dendl;
+  const string& prefix = o->get_omap_prefix();
+  string key;
+  if (o->onode.inline_omap_header.length()) {
+    bufferlist bl;
+    bl.append(o->onode.inline_omap_header);
+    o->get_omap_header(&key);
+    txc->t->set(prefix, key, bl);
+  }
+  for (auto& [k, v] : o->onode.inline_omap) {
+    bufferlist bl;
+    bl.append(v);
+    o->get_omap_key(std::string(k.data(), k.size()), &key);
+    txc->t->set(prefix, key, bl);
+  }
+  bufferlist tail;
+  o->get_omap_tail(&key);
+  txc->t->set(prefix, key, tail);
+  o->onode.clear_inline_omap();
+  txc->write_onode(o);
+  logger->inc(l_bluestore_omap_inline_spill_count);
+}
+
 void BlueStore::_do_omap_clear(TransContext *txc, OnodeRef& o)
 {
+  if (o->onode.has_inline_omap()) {
+    o->onode.clear_omap_flag();
+    return;
+  }
   const string& omap_prefix = o->get_omap_prefix();
   string prefix, tail;
   o->get_omap_header(&prefix);
@@ -17964,18 +18988,7 @@ int BlueStore::_omap_setkeys(TransContext *txc,
   auto p = bl.cbegin();
   __u32 num;
   if (!o->onode.has_omap()) {
-    if (o->oid.is_pgmeta()) {
-      o->onode.set_omap_flags_pgmeta();
-    } else {
-      o->onode.set_omap_flags(per_pool_omap == OMAP_BULK);
-    }
-    txc->write_onode(o);
-
-    const string& prefix = o->get_omap_prefix();
-    string key_tail;
-    bufferlist tail;
-    o->get_omap_tail(&key_tail);
-    txc->t->set(prefix, key_tail, tail);
+    _init_omap(txc, o);
   } else {
     txc->note_modified_object(o);
   }
@@ -17986,17 +18999,33 @@ int BlueStore::_omap_setkeys(TransContext *txc,
   decode(num, p);
   auto num0 = num;
   uint64_t total_bytes = 0;
+  bool inline_omap = o->onode.has_inline_omap();
   while (num--) {
     string key;
     bufferlist value;
     decode(key, p);
     decode(value, p);
+    total_bytes += value.length();
+    if (inline_omap) {
+      // copy so the onode does not pin the transaction buffer
+      bufferptr v(value.length());
+      value.cbegin().copy(value.length(), v.c_str());
+      v.reassign_to_mempool(mempool::mempool_bluestore_cache_meta);
+      dout(20) << __func__ << "  inline <- " << key << dendl;
+      o->onode.inline_omap[
+	mempool::bluestore_cache_meta::string(key.data(), key.size())] =
+	std::move(v);
+      continue;
+    }
     final_key.resize(base_key_len); // keep prefix
     final_key += key;
     dout(20) << __func__ << "  " << pretty_binary_string(final_key)
 	     << " <- " << key << dendl;
     txc->t->set(prefix, final_key, value);
-    total_bytes += value.length();
+  }
+  if (inline_omap) {
+    txc->write_onode(o);
+    _maybe_spill_inline_omap(txc, o);
   }
   logger->inc(l_bluestore_omap_setkeys_count);
   logger->inc(l_bluestore_omap_setkeys_records, num0);
@@ -18015,24 +19044,22 @@ int BlueStore::_omap_setheader(TransContext *txc,
   int r;
   string key;
   if (!o->onode.has_omap()) {
-    if (o->oid.is_pgmeta()) {
-      o->onode.set_omap_flags_pgmeta();
-    } else {
-      o->onode.set_omap_flags(per_pool_omap == OMAP_BULK);
-    }
-    txc->write_onode(o);
-
-    const string& prefix = o->get_omap_prefix();
-    string key_tail;
-    bufferlist tail;
-    o->get_omap_tail(&key_tail);
-    txc->t->set(prefix, key_tail, tail);
+    _init_omap(txc, o);
   } else {
     txc->note_modified_object(o);
   }
-  const string& prefix = o->get_omap_prefix();
-  o->get_omap_header(&key);
-  txc->t->set(prefix, key, bl);
+  if (o->onode.has_inline_omap()) {
+    bufferptr h(bl.length());
+    bl.cbegin().copy(bl.length(), h.c_str());
+    h.reassign_to_mempool(mempool::mempool_bluestore_cache_meta);
+    o->onode.inline_omap_header = std::move(h);
+    txc->write_onode(o);
+    _maybe_spill_inline_omap(txc, o);
+  } else {
+    const string& prefix = o->get_omap_prefix();
+    o->get_omap_header(&key);
+    txc->t->set(prefix, key, bl);
+  }
   logger->inc(l_bluestore_omap_setheader_count);
   logger->inc(l_bluestore_omap_setheader_bytes, bl.length());
   r = 0;
@@ -18053,6 +19080,19 @@ int BlueStore::_omap_rmkeys(TransContext *txc,
   if (!o->onode.has_omap()) {
     goto out;
   }
+  if (o->onode.has_inline_omap()) {
+    decode(num, p);
+    logger->inc(l_bluestore_omap_rmkeys_count, num);
+    while (num--) {
+      string key;
+      decode(key, p);
+      dout(20) << __func__ << "  rm inline " << key << dendl;
+      o->onode.inline_omap.erase(
+	mempool::bluestore_cache_meta::string(key.data(), key.size()));
+    }
+    txc->write_onode(o);
+    goto out;
+  }
   {
     const string& prefix = o->get_omap_prefix();
     o->get_omap_key(string(), &final_key);
@@ -18087,6 +19127,17 @@ int BlueStore::_omap_rmkey_range(TransContext *txc,
   if (!o->onode.has_omap()) {
     goto out;
   }
+  if (o->onode.has_inline_omap()) {
+    auto& inline_omap = o->onode.inline_omap;
+    logger->inc(l_bluestore_omap_rmkey_ranges_count);
+    inline_omap.erase(
+      inline_omap.lower_bound(
+	mempool::bluestore_cache_meta::string(first.data(), first.size())),
+      inline_omap.lower_bound(
+	mempool::bluestore_cache_meta::string(last.data(), last.size())));
+    txc->write_onode(o);
+    goto out;
+  }
   {
     const string& prefix = o->get_omap_prefix();
     o->flush();
@@ -18177,9 +19228,16 @@ int BlueStore::_clone(TransContext *txc,
     } else {
       newo->onode.set_omap_flags(per_pool_omap == OMAP_BULK);
     }
+    if (oldo->onode.has_inline_omap()) {
+      newo->onode.set_flag(bluestore_onode_t::FLAG_INLINE_OMAP);
+      newo->onode.inline_omap = oldo->onode.inline_omap;
+      newo->onode.inline_omap_header = oldo->onode.inline_omap_header;
+    }
     // check if prefix for omap key is exactly the same size for both objects
     // otherwise rewrite_omap_key will corrupt data
     ceph_assert(oldo->onode.flags == newo->onode.flags);
+  }
+  if (oldo->onode.has_omap() && !oldo->onode.has_inline_omap()) {
     const string& prefix = newo->get_omap_prefix();
     string head, tail;
     oldo->get_omap_header(&head);
@@ -18918,6 +19976,49 @@ void BlueStore::generate_db_histogram(Formatter *f)
 
 }
 
+void BlueStore::_dump_pool_cache_stats(Formatter *f)
+{
+  struct pool_stats_t {
+    uint64_t onode_hits = 0;
+    uint64_t onode_misses = 0;
+    uint64_t onode_ghost_hits = 0;
+    uint64_t data_hit_bytes = 0;
+    uint64_t data_miss_bytes = 0;
+    uint64_t data_ghost_hits = 0;
+  };
+  std::map<int64_t, pool_stats_t> pools;
+  {
+    std::shared_lock l(coll_lock);
+    for (auto& [cid, c] : coll_map) {
+      spg_t pgid;
+      if (!cid.is_pg(&pgid)) {
+	continue;
+      }
+      auto& s = c->cache_stats;
+      auto& p = pools[pgid.pool()];
+      p.onode_hits += s.onode_hits;
+      p.onode_misses += s.onode_misses;
+      p.onode_ghost_hits += s.onode_ghost_hits;
+      p.data_hit_bytes += s.data_hit_bytes;
+      p.data_miss_bytes += s.data_miss_bytes;
+      p.data_ghost_hits += s.data_ghost_hits;
+    }
+  }
+  f->open_array_section("bluestore_pool_cache");
+  for (auto& [pool, p] : pools) {
+    f->open_object_section("pool");
+    f->dump_int("pool", pool);
+    f->dump_unsigned("onode_hits", p.onode_hits);
+    f->dump_unsigned("onode_misses", p.onode_misses);
+    f->dump_unsigned("onode_ghost_hits", p.onode_ghost_hits);
+    f->dump_unsigned("data_hit_bytes", p.data_hit_bytes);
+    f->dump_unsigned("data_miss_bytes", p.data_miss_bytes);
+    f->dump_unsigned("data_ghost_hits", p.data_ghost_hits);
+    f->close_section();
+  }
+  f->close_section();
+}
+
 void BlueStore::_shutdown_cache()
 {
   dout(10) << __func__ << dendl;
@@ -80,6 +80,8 @@ enum {
   l_bluestore_stored,
   l_bluestore_fragmentation,
   l_bluestore_alloc_unit,
+  l_bluestore_prefer_deferred_size,
+  l_bluestore_deferred_batch_ops,
   //****************************************
 
   // Update op processing state latencies
@@ -151,6 +153,8 @@ enum {
   l_bluestore_write_big_skipped_bytes,
   l_bluestore_write_small_skipped,
   l_bluestore_write_small_skipped_bytes,
+  l_bluestore_write_coalesced_ops,
+  l_bluestore_write_coalesced_bytes,
   //****************************************
 
   // compressions stats
@@ -160,8 +164,10 @@ enum {
   l_bluestore_compressed_original,
   l_bluestore_compress_lat,
   l_bluestore_decompress_lat,
+  l_bluestore_decompress_skipped_bytes,
   l_bluestore_compress_success_count,
   l_bluestore_compress_rejected_count,
+  l_bluestore_compress_skipped_count,
   //****************************************
 
   // onode cache stats
@@ -170,8 +176,11 @@ enum {
   l_bluestore_pinned_onodes,
   l_bluestore_onode_hits,
   l_bluestore_onode_misses,
+  l_bluestore_onode_ghost_hits,
   l_bluestore_onode_shard_hits,
   l_bluestore_onode_shard_misses,
+  l_bluestore_onode_shard_cold_hits,
+  l_bluestore_onode_shard_unloads,
   l_bluestore_extents,
   l_bluestore_blobs,
   //****************************************
@@ -182,6 +191,10 @@ enum {
   l_bluestore_buffer_bytes,
   l_bluestore_buffer_hit_bytes,
   l_bluestore_buffer_miss_bytes,
+  l_bluestore_buffer_ghost_hits,
+  l_bluestore_readahead_bytes,
+  l_bluestore_readahead_hit_bytes,
+  l_bluestore_readahead_waste_bytes,
   //****************************************
 
   // internal stats
@@ -202,6 +215,8 @@ enum {
   l_bluestore_omap_setkeys_count,
   l_bluestore_omap_setkeys_records,
   l_bluestore_omap_setkeys_bytes,
+  l_bluestore_omap_inline_count,
+  l_bluestore_omap_inline_spill_count,
   //****************************************
 
   // other client ops latencies
@@ -427,6 +442,9 @@ public:
       ceph_assert(buffer_map.empty());
     }
 
+    /// key of the buffer at offset in the cache shard ghost list
+    uint64_t ghost_key(uint32_t offset) const;
+
     void _add_buffer(BufferCacheShard* cache,
                      Buffer* b,
                      uint16_t cache_private, int level, Buffer *near);
@@ -487,13 +505,14 @@ public:
     void _finish_write(BufferCacheShard* cache, TransContext* txc,
                        uint32_t offset, uint32_t length);
     void did_read(BufferCacheShard* cache,
-                  uint32_t offset, ceph::buffer::list&& bl) {
+                  uint32_t offset, ceph::buffer::list&& bl,
+                  int level = 1) {
       std::lock_guard l(cache->lock);
       uint16_t cache_private = _discard(cache, offset, bl.length());
       _add_buffer(
           cache,
           new Buffer(this, Buffer::STATE_CLEAN, 0, offset, std::move(bl), 0),
-          cache_private, 1, nullptr);
+          cache_private, level, nullptr);
       cache->_trim();
     }
 
@@ -971,6 +990,8 @@ public:
       unsigned extents = 0;  ///< count extents in this shard
       bool loaded = false;   ///< true if shard is loaded
       bool dirty = false;    ///< true if shard is dirty and needs reencoding
+      ceph::buffer::list cold_bl; ///< encoded extents while unloaded by
+                                  ///  the onode cache, empty=>load from kv
     };
 
     mempool::bluestore_cache_meta::vector<Shard> shards;    ///< shards
@@ -1143,6 +1164,9 @@ public:
     }
 
     /// ensure that a range of the map is loaded
+    /// drop decoded extents of clean shards, keeping them encoded in memory
+    unsigned unload_shards();
+
     void fault_range(KeyValueDB *db,
 		     uint32_t offset, uint32_t length);
 
@@ -1340,6 +1364,7 @@ public:
     bool cached;              ///< Onode is logically in the cache
                               /// (it can be pinned and hence physically out
                               /// of it at the moment though)
+    bool cache_cold = false;  ///< on the cache's cold list, under cache lock
     ExtentMap extent_map;
     BufferSpace bc;             ///< buffer cache
 
@@ -1352,6 +1377,12 @@ public:
     ceph::condition_variable flush_cond;   ///< wait here for uncommitted txns
     std::shared_ptr<int64_t> cache_age_bin;  ///< cache age bin
 
+    // sequential read detection, see BlueStore::_readahead_window()
+    std::atomic<uint64_t> ra_next_offset = {0}; ///< expected next read offset
+    std::atomic<uint64_t> ra_start = {0};       ///< readahead range ahead
+    std::atomic<uint64_t> ra_end = {0};         ///< of the reader
+    std::atomic<uint32_t> ra_seq_reads = {0};   ///< sequential reads so far
+
     Onode(Collection *c, const ghobject_t& o,
 	  const mempool::bluestore_cache_meta::string& k)
       : c(c),
@@ -1491,6 +1522,17 @@ public:
     std::atomic<uint64_t> num = {0};
     boost::circular_buffer<std::shared_ptr<int64_t>> age_bins;
 
+    /// keys recently evicted from the shard and their weight (onodes or
+    /// bytes); a miss on one of them would have been a hit had the shard
+    /// been bigger by ghost.max
+    struct GhostList {
+      std::deque<std::pair<uint64_t, uint32_t>> fifo;
+      ceph::unordered_map<uint64_t, uint32_t> refs;
+      uint64_t weight = 0;
+      uint64_t max = 0;
+      uint64_t hits = 0;  ///< lookups found in the list, monotonic
+    } ghost;
+
     CacheShard(CephContext* cct) : cct(cct), logger(nullptr), age_bins(1) {
       shift_bins();
     }
@@ -1536,6 +1578,44 @@ public:
       std::lock_guard l(lock);
       age_bins.set_capacity(count);
     }
+    void _ghost_add(uint64_t key, uint32_t weight) {
+      if (ghost.max == 0) {
+        return;
+      }
+      ghost.fifo.emplace_back(key, weight);
+      ++ghost.refs[key];
+      ghost.weight += weight;
+      _ghost_trim();
+    }
+    bool _ghost_lookup(uint64_t key) {
+      if (ghost.refs.count(key)) {
+        ++ghost.hits;
+        return true;
+      }
+      return false;
+    }
+    void _ghost_trim() {
+      while (ghost.weight > ghost.max) {
+        auto [key, weight] = ghost.fifo.front();
+        ghost.fifo.pop_front();
+        ghost.weight -= weight;
+        auto p = ghost.refs.find(key);
+        if (--p->second == 0) {
+          ghost.refs.erase(p);
+        }
+      }
+    }
+    void set_ghost_max(uint64_t max_) {
+      std::lock_guard l(lock);
+      ghost.max = max_;
+      _ghost_trim();
+    }
+    void get_ghost_stats(uint64_t *hits, uint64_t *weight) {
+      std::lock_guard l(lock);
+      *hits += ghost.hits;
+      *weight += ghost.weight;
+    }
+
     uint64_t sum_bins(uint32_t start, uint32_t end) {
       std::lock_guard l(lock);
       auto size = age_bins.size();
@@ -1647,7 +1727,7 @@ public:
     }
 
     OnodeRef add_onode(const ghobject_t& oid, OnodeRef& o);
-    OnodeRef lookup(const ghobject_t& o);
+    OnodeRef lookup(const ghobject_t& o, bool *ghost_hit = nullptr);
     void rename(OnodeRef& o, const ghobject_t& old_oid,
 		const ghobject_t& new_oid,
 		const mempool::bluestore_cache_meta::string& new_okey);
@@ -1684,6 +1764,17 @@ public:
     pool_opts_t pool_opts;
     ContextQueue *commit_queue;
 
+    /// cache lookups of this collection, summed per pool by
+    /// dump_cache_stats()
+    struct CacheStats {
+      std::atomic<uint64_t> onode_hits = {0};
+      std::atomic<uint64_t> onode_misses = {0};
+      std::atomic<uint64_t> onode_ghost_hits = {0};
+      std::atomic<uint64_t> data_hit_bytes = {0};
+      std::atomic<uint64_t> data_miss_bytes = {0};
+      std::atomic<uint64_t> data_ghost_hits = {0};
+    } cache_stats;
+
     OnodeCacheShard* get_onode_cache() const {
       return onode_space.cache;
     }
@@ -1937,6 +2028,7 @@ public:
     CollectionRef ch;
     OpSequencerRef osr;  // this should be ch->osr
     boost::intrusive::list_member_hook<> sequencer_item;
+    TransContext *kv_submit_next = nullptr; ///< link in a KVSubmitShard
 
     uint64_t bytes = 0, ios = 0, cost = 0;
 
@@ -2340,6 +2432,21 @@ public:
       return NULL;
     }
   };
+  /// extra kv submission lane; the kv sync thread hands it the queued
+  /// txcs of the sequencers hashed to it and waits for their submission
+  /// before the (shared) sync commit.
+  struct KVSyncLane : public Thread {
+    BlueStore *store;
+    ceph::mutex lock = ceph::make_mutex("BlueStore::KVSyncLane::lock");
+    ceph::condition_variable cond;
+    std::vector<TransContext*> queue;
+    bool stop = false;
+    explicit KVSyncLane(BlueStore *s) : store(s) {}
+    void *entry() override {
+      store->_kv_sync_lane_thread(this);
+      return NULL;
+    }
+  };
   struct KVFinalizeThread : public Thread {
     BlueStore *store;
     explicit KVFinalizeThread(BlueStore *s) : store(s) {}
@@ -2439,7 +2546,42 @@ private:
   std::deque<TransContext*> kv_queue_unsubmitted; ///< ready, need submit by kv thread
   std::deque<TransContext*> kv_committing;        ///< currently syncing
   std::deque<DeferredBatch*> deferred_done_queue;   ///< deferred ios done
-  bool kv_sync_in_progress = false;
+  std::atomic_bool kv_sync_in_progress = {false};
+
+  /// lock-free MPSC hand-off of ready txcs to the kv sync thread, used
+  /// instead of kv_queue when bluestore_kv_sync_queue_shards > 0.
+  /// Sequencers are pinned to a shard so per-osr order is preserved.
+  struct alignas(64) KVSubmitShard {
+    std::atomic<TransContext*> head = {nullptr};
+
+    void push(TransContext *txc) {
+      TransContext *h = head.load(std::memory_order_relaxed);
+      do {
+	txc->kv_submit_next = h;
+      } while (!head.compare_exchange_weak(h, txc));
+    }
+    bool empty() const {
+      return head.load() == nullptr;
+    }
+    /// detach everything queued so far, oldest first
+    TransContext *pop_all() {
+      TransContext *h = head.exchange(nullptr, std::memory_order_acquire);
+      TransContext *fifo = nullptr;
+      while (h) {
+	TransContext *next = h->kv_submit_next;
+	h->kv_submit_next = fifo;
+	fifo = h;
+	h = next;
+      }
+      return fifo;
+    }
+  };
+  std::vector<KVSubmitShard> kv_submit_shards;
+
+  std::vector<std::unique_ptr<KVSyncLane>> kv_sync_lanes;
+  ceph::mutex kv_lanes_lock = ceph::make_mutex("BlueStore::kv_lanes_lock");
+  ceph::condition_variable kv_lanes_cond;
+  unsigned kv_lanes_busy = 0;  ///< lanes still submitting the current batch
 
   KVFinalizeThread kv_finalize_thread;
   ceph::mutex kv_finalize_lock = ceph::make_mutex("BlueStore::kv_finalize_lock");
@@ -2489,6 +2631,19 @@ private:
   ///< size threshold for forced deferred writes
   std::atomic<uint64_t> prefer_deferred_size = {0};
 
+  /// state of the deferred write autotuner, see _tune_deferred()
+  struct {
+    int base_batch_ops = 0;  ///< configured deferred_batch_ops
+    std::pair<uint64_t, uint64_t> aio_wait = {0, 0};  ///< last count, sum
+    std::pair<uint64_t, uint64_t> kv_commit = {0, 0};
+  } deferred_tuner;
+
+  ///< max size of a write merged from adjacent writes in a transaction
+  std::atomic<uint64_t> write_coalesce_max_bytes = {0};
+
+  ///< omap smaller than this is kept in the onode
+  std::atomic<uint64_t> inline_omap_max_bytes = {0};
+
   ///< approx cost per io, in bytes
   std::atomic<uint64_t> throttle_cost_per_io = {0};
 
@@ -2510,6 +2665,7 @@ private:
   double cache_kv_ratio = 0;     ///< cache ratio dedicated to kv (e.g., rocksdb)
   double cache_kv_onode_ratio = 0; ///< cache ratio dedicated to kv onodes (e.g., rocksdb onode CF)
   double cache_data_ratio = 0;   ///< cache ratio dedicated to object data
+  double cache_ghost_ratio = 0;  ///< ghost list size relative to each cache
   bool cache_autotune = false;   ///< cache autotune setting
   double cache_age_bin_interval = 0; ///< time to wait between cache age bin rotations
   double cache_autotune_interval = 0; ///< time to wait between cache rebalancing
@@ -2549,6 +2705,7 @@ private:
     bool stop = false;
     std::shared_ptr<PriorityCache::PriCache> binned_kv_cache = nullptr;
     std::shared_ptr<PriorityCache::PriCache> binned_kv_onode_cache = nullptr;
+    std::shared_ptr<PriorityCache::PriCache> binned_kv_compressed_cache = nullptr;
     std::shared_ptr<PriorityCache::Manager> pcm = nullptr;
 
     struct MempoolCache : public PriorityCache::PriCache {
@@ -2748,6 +2905,11 @@ private:
     };
     std::shared_ptr<DataCache> data_cache;
 
+    // ghost list driven split between meta and data caches
+    double ghost_meta_share = -1;  ///< meta part of meta + data ratio
+    uint64_t last_meta_ghost_hits = 0;
+    uint64_t last_data_ghost_hits = 0;
+
   public:
     explicit MempoolThread(BlueStore *s)
       : store(s),
@@ -2770,6 +2932,7 @@ private:
   private:
     void _update_cache_settings();
     void _resize_shards(bool interval_stats);
+    void _tune_ghost_split(double *meta_ratio, double *data_ratio);
   } mempool_thread;
 
 #ifdef WITH_BLKIN
@@ -2791,6 +2954,7 @@ private:
   int _write_fsid();
   void _close_fsid();
   void _set_alloc_sizes();
+  void _tune_deferred();
   void _set_blob_size();
   void _set_finisher_num();
   void _set_per_pool_omap();
@@ -2905,9 +3069,21 @@ private:
 			    TrackedOpRef osd_op=TrackedOpRef());
   void _txc_update_store_statfs(TransContext *txc);
   void _txc_add_transaction(TransContext *txc, Transaction *t);
+  /// merges the OP_WRITEs following op that touch its range into op's
+  /// data, returns the number of ops consumed from i
+  int _coalesce_writes(Transaction::iterator& i,
+		       const Transaction::Op& op,
+		       uint64_t *off,
+		       uint64_t *len,
+		       ceph::buffer::list& bl);
   void _txc_calc_cost(TransContext *txc);
   void _txc_write_nodes(TransContext *txc, KeyValueDB::Transaction t);
   void _txc_state_proc(TransContext *txc);
+  void _txc_queue_kv(TransContext *txc);
+  bool _kv_submit_shards_empty() const;
+  void _kv_drain_submit_shards();
+  void _kv_sync_lanes_submit(std::vector<std::vector<TransContext*>>& batches);
+  void _kv_sync_lane_thread(KVSyncLane *lane);
   void _txc_aio_submit(TransContext *txc);
 public:
   void txc_aio_finish(void *p) {
@@ -3164,7 +3340,9 @@ public:
     }
     f->dump_int("bluestore_onode", onode_count);
     f->dump_int("bluestore_buffers", buffers_bytes);
+    _dump_pool_cache_stats(f);
   }
+  void _dump_pool_cache_stats(ceph::Formatter *f);
   void dump_cache_stats(std::ostream& ss) override {
     int onode_count = 0, buffers_bytes = 0;
     for (auto i: onode_cache_shards) {
@@ -3309,7 +3487,15 @@ private:
     blobs2read_t& blobs2read,
     bool buffered,
     bool* csum_error,
-    ceph::buffer::list& bl);
+    ceph::buffer::list& bl,
+    uint64_t readahead_offset = UINT64_MAX,  ///< regions past it are prefetch
+    bool cache_readahead = false);
+
+  uint64_t _readahead_window(
+    OnodeRef& o,
+    uint64_t offset,
+    size_t length,
+    uint32_t op_flags);
 
   int _do_read(
     Collection *c,
@@ -3393,6 +3579,11 @@ public:
     ceph::buffer::list *header,          ///< [out] omap header
     std::map<std::string, ceph::buffer::list> *out /// < [out] Key to value map
   );
+  /// kv iterator over the omap of o, served from the onode if it is inline
+  KeyValueDB::Iterator _get_omap_kv_iterator(
+    const OnodeRef& o,
+    KeyValueDB::IteratorOpts opts,
+    KeyValueDB::IteratorBounds bounds);
 
 
   /// Get omap header
@@ -3673,7 +3864,8 @@ private:
     uint64_t blob_xoffset,
     const ceph::buffer::list& bl,
     uint64_t logical_offset);
-  int _decompress(ceph::buffer::list& source, ceph::buffer::list* result);
+  int _decompress(ceph::buffer::list& source, ceph::buffer::list* result,
+                  uint64_t want_len = std::numeric_limits<uint64_t>::max());
 
 
   // --------------------------------------------------------
@@ -3891,6 +4083,10 @@ private:
 	       CollectionRef& c,
 	       OnodeRef& o);
   void _do_omap_clear(TransContext *txc, OnodeRef& o);
+  /// set omap flags on first omap write, inline if the layout allows it
+  void _init_omap(TransContext *txc, OnodeRef& o);
+  /// move inline omap to kv once it outgrows inline_omap_max_bytes
+  void _maybe_spill_inline_omap(TransContext *txc, OnodeRef& o);
   int _omap_clear(TransContext *txc,
 		  CollectionRef& c,
 		  OnodeRef& o);
@@ -4040,6 +4236,10 @@ public:
     mempool::bluestore_fsck::list<std::string>* expecting_shards,
     std::map<BlobRef, bluestore_blob_t::unused_t>* referenced,
     BlueStore::FSCK_ObjectCtx& ctx);
+  /// read the whole object content to verify checksums, returns error count
+  int64_t fsck_read_object_data(
+    CollectionRef& c,
+    OnodeRef& o);
 #ifdef CEPH_BLUESTORE_TOOL_RESTORE_ALLOCATION
   int  push_allocation_to_rocksdb();
   int  read_allocation_from_drive_for_bluestore_tool();
@@ -84,18 +84,28 @@ int64_t Btree2Allocator::allocate(
     max_alloc_size >= cap) {
     max_alloc_size = p2align(uint64_t(cap), (uint64_t)block_size);
   }
+  const size_t first = extents->size();
+  int64_t r;
   uint64_t cached_chunk_offs = 0;
   if (cache && cache->try_get(&cached_chunk_offs, want)) {
     num_free -= want;
     extents->emplace_back(cached_chunk_offs, want);
-    return want;
+    r = want;
+  } else {
+    std::lock_guard l(lock);
+    r = _allocate(want, unit, max_alloc_size, hint, extents);
   }
-  std::lock_guard l(lock);
-  return _allocate(want, unit, max_alloc_size, hint, extents);
+  if (is_tracing()) {
+    _trace_allocate(want, unit, max_alloc_size, hint, r, *extents, first);
+  }
+  return r;
 }
 
 void Btree2Allocator::release(const release_set_t& release_set)
 {
+  if (is_tracing()) {
+    _trace_release(release_set);
+  }
   if (!cache || release_set.num_intervals() >= pextent_array_size) {
     std::lock_guard l(lock);
     _release(release_set);
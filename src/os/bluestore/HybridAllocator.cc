@@ -47,6 +47,11 @@ int64_t HybridBtree2Allocator::allocate(
   uint64_t cached_chunk_offs = 0;
   if (try_get_from_cache(&cached_chunk_offs, want)) {
     extents->emplace_back(cached_chunk_offs, want);
+    // the regular path below is traced by HybridAllocatorBase
+    if (is_tracing()) {
+      _trace_allocate(want, unit, max_alloc_size, hint, want,
+		      *extents, extents->size() - 1);
+    }
     return want;
   }
   return HybridAllocatorBase<Btree2Allocator>::allocate(want,
@@ -58,6 +63,10 @@ void HybridBtree2Allocator::release(const release_set_t& release_set)
     HybridAllocatorBase<Btree2Allocator>::release(release_set);
     return;
   }
+  // the path above is traced by Btree2Allocator::release()
+  if (is_tracing()) {
+    _trace_release(release_set);
+  }
   PExtentArray to_release;
   size_t count = 0;
   auto p = release_set.begin();
@@ -35,35 +35,43 @@ int64_t HybridAllocatorBase<T>::allocate(
     max_alloc_size = p2align(uint64_t(cap), (uint64_t)T::get_block_size());
   }
 
-  std::lock_guard l(T::get_lock());
+  const size_t first = extents->size();
+  int64_t res;
+  {
+    std::lock_guard l(T::get_lock());
 
-  // try bitmap first to avoid unneeded contiguous extents split if
-  // desired amount is less than shortes range in AVL or Btree2
-  bool primary_first = !(bmap_alloc &&
-                         bmap_alloc->get_free() &&
-                         want < T::_lowest_size_available());
+    // try bitmap first to avoid unneeded contiguous extents split if
+    // desired amount is less than shortes range in AVL or Btree2
+    bool primary_first = !(bmap_alloc &&
+                           bmap_alloc->get_free() &&
+                           want < T::_lowest_size_available());
 
-  int64_t res = _allocate_or_rollback(primary_first,
-    want, unit, max_alloc_size, hint, extents);
-  ceph_assert(res >= 0);
-  if ((uint64_t)res < want) {
-    auto orig_size = extents->size();
-    int64_t res2 = 0;
-    // try alternate allocator
-    if (!primary_first) {
-      res2 = T::_allocate(want - res, unit, max_alloc_size, hint, extents);
-    } else if (bmap_alloc) {
-      res2 =
-        bmap_alloc->allocate(want - res, unit, max_alloc_size, hint, extents);
-    }
-    if (res2 >= 0) {
-      res += res2;
-    } else {
-      // allocator shouldn't return new extents on error
-      ceph_assert(orig_size == extents->size());
+    res = _allocate_or_rollback(primary_first,
+      want, unit, max_alloc_size, hint, extents);
+    ceph_assert(res >= 0);
+    if ((uint64_t)res < want) {
+      auto orig_size = extents->size();
+      int64_t res2 = 0;
+      // try alternate allocator
+      if (!primary_first) {
+        res2 = T::_allocate(want - res, unit, max_alloc_size, hint, extents);
+      } else if (bmap_alloc) {
+        res2 =
+          bmap_alloc->allocate(want - res, unit, max_alloc_size, hint, extents);
+      }
+      if (res2 >= 0) {
+        res += res2;
+      } else {
+        // allocator shouldn't return new extents on error
+        ceph_assert(orig_size == extents->size());
+      }
     }
   }
-  return res ? res : -ENOSPC;
+  res = res ? res : -ENOSPC;
+  if (T::is_tracing()) {
+    T::_trace_allocate(want, unit, max_alloc_size, hint, res, *extents, first);
+  }
+  return res;
 }
 
 template <typename T>
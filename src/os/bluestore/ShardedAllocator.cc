@@ -0,0 +1,241 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "ShardedAllocator.h"
+#include "HybridAllocator.h"
+
+#include "common/debug.h"
+
+#define dout_context cct
+#define dout_subsys ceph_subsys_bluestore
+#undef  dout_prefix
+#define dout_prefix *_dout << "ShardedHybridAllocator "
+
+ShardedHybridAllocator::ShardedHybridAllocator(
+  CephContext* _cct,
+  int64_t device_size,
+  int64_t _block_size,
+  uint64_t max_mem,
+  size_t _num_shards,
+  size_t _num_classes,
+  size_t _batch,
+  std::string_view name) :
+    Allocator(name, device_size, _block_size),
+    cct(_cct),
+    backend(new HybridAvlAllocator(cct, device_size, _block_size, max_mem,
+      name.empty() ? std::string() : std::string(name) + "_backend")),
+    shards(new Shard[std::max<size_t>(_num_shards, 1)]),
+    num_shards(std::max<size_t>(_num_shards, 1)),
+    num_classes(_num_classes),
+    batch(std::max<size_t>(_batch, 1))
+{
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards[i].classes.resize(num_classes);
+  }
+  ldout(cct, 10) << __func__ << " shards " << num_shards
+		 << " size classes " << num_classes
+		 << " batch " << batch << dendl;
+}
+
+ShardedHybridAllocator::~ShardedHybridAllocator()
+{
+}
+
+ShardedHybridAllocator::Shard& ShardedHybridAllocator::_get_shard()
+{
+  static std::atomic<size_t> next_thread = {0};
+  thread_local size_t thread_idx = next_thread++;
+  return shards[thread_idx % num_shards];
+}
+
+int ShardedHybridAllocator::_get_class(uint64_t offset, uint64_t length) const
+{
+  if (length == 0 ||
+      !p2aligned(offset, (uint64_t)block_size) ||
+      !p2aligned(length, (uint64_t)block_size)) {
+    return -1;
+  }
+  uint64_t cls = length / block_size - 1;
+  return cls < num_classes ? (int)cls : -1;
+}
+
+void ShardedHybridAllocator::_refill(Shard& s, size_t cls)
+{
+  ceph_assert(ceph_mutex_is_locked(s.lock));
+  uint64_t len = (cls + 1) * block_size;
+  PExtentVector extents;
+  int64_t r = backend->allocate(len * batch, block_size, len, 0, &extents);
+  if (r <= 0) {
+    return;
+  }
+  release_set_t leftovers;
+  auto& c = s.classes[cls];
+  for (auto& e : extents) {
+    // the backend may be fragmented and return shorter chunks
+    if (e.length == len) {
+      c.push_back(e.offset);
+      s.bytes += len;
+    } else {
+      leftovers.insert(e.offset, e.length);
+    }
+  }
+  if (!leftovers.empty()) {
+    backend->release(leftovers);
+  }
+  ldout(cct, 20) << __func__ << " class 0x" << std::hex << len << std::dec
+		 << " cached " << c.size() << dendl;
+}
+
+void ShardedHybridAllocator::_flush_caches()
+{
+  release_set_t to_release;
+  for (size_t i = 0; i < num_shards; ++i) {
+    auto& s = shards[i];
+    std::lock_guard l(s.lock);
+    for (size_t cls = 0; cls < num_classes; ++cls) {
+      for (auto o : s.classes[cls]) {
+	to_release.insert(o, (cls + 1) * block_size);
+      }
+      s.classes[cls].clear();
+    }
+    s.bytes = 0;
+  }
+  if (!to_release.empty()) {
+    backend->release(to_release);
+  }
+}
+
+int64_t ShardedHybridAllocator::allocate(
+  uint64_t want,
+  uint64_t unit,
+  uint64_t max_alloc_size,
+  int64_t  hint,
+  PExtentVector *extents)
+{
+  ldout(cct, 10) << __func__ << std::hex
+		 << " 0x" << want
+		 << "/" << unit
+		 << "," << max_alloc_size
+		 << "," << hint
+		 << std::dec << dendl;
+  const size_t first = extents->size();
+  int64_t r = 0;
+  int cls = _get_class(0, want);
+  if (cls >= 0 && unit == (uint64_t)block_size &&
+      (max_alloc_size == 0 || max_alloc_size >= want)) {
+    auto& s = _get_shard();
+    if (s.lock.try_lock()) {
+      auto& c = s.classes[cls];
+      if (c.empty()) {
+	_refill(s, cls);
+      }
+      if (!c.empty()) {
+	extents->emplace_back(c.back(), want);
+	c.pop_back();
+	s.bytes -= want;
+	r = want;
+      }
+      s.lock.unlock();
+    }
+  }
+  if (r == 0) {
+    r = backend->allocate(want, unit, max_alloc_size, hint, extents);
+    if (r == -ENOSPC) {
+      // space might be sitting in other shards' caches
+      _flush_caches();
+      r = backend->allocate(want, unit, max_alloc_size, hint, extents);
+    }
+  }
+  if (is_tracing()) {
+    _trace_allocate(want, unit, max_alloc_size, hint, r, *extents, first);
+  }
+  return r;
+}
+
+void ShardedHybridAllocator::release(const release_set_t& release_set)
+{
+  if (is_tracing()) {
+    _trace_release(release_set);
+  }
+  auto& s = _get_shard();
+  release_set_t to_release;
+  bool locked = s.lock.try_lock();
+  for (auto p = release_set.begin(); p != release_set.end(); ++p) {
+    int cls = locked ? _get_class(p.get_start(), p.get_len()) : -1;
+    if (cls >= 0 && s.classes[cls].size() < batch * 2) {
+      s.classes[cls].push_back(p.get_start());
+      s.bytes += p.get_len();
+    } else {
+      to_release.insert(p.get_start(), p.get_len());
+    }
+  }
+  if (locked) {
+    s.lock.unlock();
+  }
+  if (!to_release.empty()) {
+    backend->release(to_release);
+  }
+}
+
+uint64_t ShardedHybridAllocator::get_free()
+{
+  uint64_t cached = 0;
+  for (size_t i = 0; i < num_shards; ++i) {
+    cached += shards[i].bytes;
+  }
+  return backend->get_free() + cached;
+}
+
+double ShardedHybridAllocator::get_fragmentation()
+{
+  return backend->get_fragmentation();
+}
+
+void ShardedHybridAllocator::dump()
+{
+  backend->dump();
+  for (size_t i = 0; i < num_shards; ++i) {
+    auto& s = shards[i];
+    std::lock_guard l(s.lock);
+    for (size_t cls = 0; cls < num_classes; ++cls) {
+      if (!s.classes[cls].empty()) {
+	ldout(cct, 0) << __func__ << " shard " << i << " class 0x" << std::hex
+		      << (cls + 1) * block_size << std::dec
+		      << " cached " << s.classes[cls].size() << dendl;
+      }
+    }
+  }
+}
+
+void ShardedHybridAllocator::foreach(
+  std::function<void(uint64_t offset, uint64_t length)> notify)
+{
+  for (size_t i = 0; i < num_shards; ++i) {
+    auto& s = shards[i];
+    std::lock_guard l(s.lock);
+    for (size_t cls = 0; cls < num_classes; ++cls) {
+      for (auto o : s.classes[cls]) {
+	notify(o, (cls + 1) * block_size);
+      }
+    }
+  }
+  backend->foreach(notify);
+}
+
+void ShardedHybridAllocator::init_add_free(uint64_t offset, uint64_t length)
+{
+  backend->init_add_free(offset, length);
+}
+
+void ShardedHybridAllocator::init_rm_free(uint64_t offset, uint64_t length)
+{
+  // cached extents could overlap the range
+  _flush_caches();
+  backend->init_rm_free(offset, length);
+}
+
+void ShardedHybridAllocator::shutdown()
+{
+  _flush_caches();
+  backend->shutdown();
+}
@@ -0,0 +1,81 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Allocator.h"
+#include "common/ceph_mutex.h"
+
+/*
+ * Allocator which fronts a HybridAvlAllocator with per-shard caches of
+ * pre-carved free extents for the most common (small) request sizes:
+ * 1..N multiples of the block size. Threads are spread over the shards
+ * so a cache hit only takes an uncontended shard lock via try_lock() and
+ * never the backend's global lock. Empty size classes are refilled in
+ * batches from the backend, large or odd-shaped requests go to the
+ * backend directly.
+ */
+class ShardedHybridAllocator : public Allocator {
+  CephContext* cct;
+  std::unique_ptr<Allocator> backend;
+
+  struct alignas(64) Shard {
+    ceph::mutex lock =
+      ceph::make_mutex("ShardedHybridAllocator::Shard::lock");
+    /// cached offsets per size class, class i holds (i + 1) * block_size
+    std::vector<std::vector<uint64_t>> classes;
+    std::atomic<uint64_t> bytes = {0};
+  };
+  std::unique_ptr<Shard[]> shards;
+  const size_t num_shards;
+  const size_t num_classes;
+  const size_t batch;
+
+  Shard& _get_shard();
+  /// returns size class index for the request or -1 if it isn't cacheable
+  int _get_class(uint64_t offset, uint64_t length) const;
+  /// refills the class from the backend, shard lock must be held
+  void _refill(Shard& s, size_t cls);
+  /// moves all cached extents back to the backend
+  void _flush_caches();
+
+public:
+  ShardedHybridAllocator(CephContext* cct,
+			 int64_t device_size,
+			 int64_t block_size,
+			 uint64_t max_mem,
+			 size_t num_shards,
+			 size_t num_classes,
+			 size_t batch,
+			 std::string_view name);
+  ~ShardedHybridAllocator() override;
+
+  const char* get_type() const override
+  {
+    return "hybrid_sharded";
+  }
+
+  int64_t allocate(
+    uint64_t want,
+    uint64_t unit,
+    uint64_t max_alloc_size,
+    int64_t  hint,
+    PExtentVector *extents) override;
+  void release(const release_set_t& release_set) override;
+
+  uint64_t get_free() override;
+  double get_fragmentation() override;
+
+  void dump() override;
+  void foreach(
+    std::function<void(uint64_t offset, uint64_t length)> notify) override;
+
+  void init_add_free(uint64_t offset, uint64_t length) override;
+  void init_rm_free(uint64_t offset, uint64_t length) override;
+
+  void shutdown() override;
+};
@@ -178,6 +178,9 @@ int64_t StupidAllocator::allocate(
   uint64_t offset = 0;
   uint32_t length = 0;
   int res = 0;
+  const size_t first = extents->size();
+  const uint64_t orig_max_alloc_size = max_alloc_size;
+  const int64_t orig_hint = hint;
 
   if (max_alloc_size == 0) {
     max_alloc_size = want_size;
@@ -214,15 +217,20 @@ int64_t StupidAllocator::allocate(
     hint = offset + length;
   }
 
-  if (allocated_size == 0) {
-    return -ENOSPC;
+  int64_t r = allocated_size ? int64_t(allocated_size) : -ENOSPC;
+  if (is_tracing()) {
+    _trace_allocate(want_size, alloc_unit, orig_max_alloc_size, orig_hint, r,
+		    *extents, first);
   }
-  return allocated_size;
+  return r;
 }
 
 void StupidAllocator::release(
   const interval_set<uint64_t>& release_set)
 {
+  if (is_tracing()) {
+    _trace_release(release_set);
+  }
   std::lock_guard l(lock);
   for (interval_set<uint64_t>::const_iterator p = release_set.begin();
        p != release_set.end();
@@ -1415,6 +1415,10 @@ void bluestore_onode_t::dump(Formatter *f) const
   f->dump_unsigned("expected_object_size", expected_object_size);
   f->dump_unsigned("expected_write_size", expected_write_size);
   f->dump_unsigned("alloc_hint_flags", alloc_hint_flags);
+  if (has_inline_omap()) {
+    f->dump_unsigned("inline_omap_keys", inline_omap.size());
+    f->dump_unsigned("inline_omap_bytes", get_inline_omap_bytes());
+  }
 }
 
 void bluestore_onode_t::generate_test_instances(list<bluestore_onode_t*>& o)
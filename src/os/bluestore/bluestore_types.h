@@ -1086,11 +1086,17 @@ struct bluestore_onode_t {
 
   std::map<uint32_t, uint64_t> zone_offset_refs;  ///< (zone, offset) refs to this onode
 
+  // small omaps kept in the onode itself (FLAG_INLINE_OMAP), no kv keys;
+  // mempool to be assigned to buffer::ptr manually
+  std::map<mempool::bluestore_cache_meta::string, ceph::buffer::ptr> inline_omap;
+  ceph::buffer::ptr inline_omap_header;
+
   enum {
     FLAG_OMAP = 1,         ///< object may have omap data
     FLAG_PGMETA_OMAP = 2,  ///< omap data is in meta omap prefix
     FLAG_PERPOOL_OMAP = 4, ///< omap data is in per-pool prefix; per-pool keys
     FLAG_PERPG_OMAP = 8,   ///< omap data is in per-pg prefix; per-pg keys
+    FLAG_INLINE_OMAP = 16, ///< omap data is stored in the onode
   };
 
   std::string get_flags_string() const {
@@ -1107,6 +1113,9 @@ struct bluestore_onode_t {
     if (flags & FLAG_PERPG_OMAP) {
       s += "+per_pg_omap";
     }
+    if (flags & FLAG_INLINE_OMAP) {
+      s += "+inline_omap";
+    }
     return s;
   }
 
@@ -1144,6 +1153,17 @@ struct bluestore_onode_t {
   bool is_perpg_omap() const {
     return has_flag(FLAG_PERPG_OMAP);
   }
+  bool has_inline_omap() const {
+    return has_flag(FLAG_INLINE_OMAP);
+  }
+  /// bytes of keys, values and header held inline
+  uint64_t get_inline_omap_bytes() const {
+    uint64_t bytes = inline_omap_header.length();
+    for (auto& [k, v] : inline_omap) {
+      bytes += k.length() + v.length();
+    }
+    return bytes;
+  }
 
   void set_omap_flags(bool legacy) {
     set_flag(FLAG_OMAP | (legacy ? 0 : (FLAG_PERPOOL_OMAP | FLAG_PERPG_OMAP)));
@@ -1152,15 +1172,22 @@ struct bluestore_onode_t {
     set_flag(FLAG_OMAP | FLAG_PGMETA_OMAP);
   }
 
+  void clear_inline_omap() {
+    clear_flag(FLAG_INLINE_OMAP);
+    inline_omap.clear();
+    inline_omap_header = ceph::buffer::ptr();
+  }
+
   void clear_omap_flag() {
     clear_flag(FLAG_OMAP |
 	       FLAG_PGMETA_OMAP |
 	       FLAG_PERPOOL_OMAP |
 	       FLAG_PERPG_OMAP);
+    clear_inline_omap();
   }
 
   DENC(bluestore_onode_t, v, p) {
-    DENC_START(2, 1, p);
+    DENC_START(3, 1, p);
     denc_varint(v.nid, p);
     denc_varint(v.size, p);
     denc(v.attrs, p);
@@ -1172,6 +1199,10 @@ struct bluestore_onode_t {
     if (struct_v >= 2) {
       denc(v.zone_offset_refs, p);
     }
+    if (struct_v >= 3 && (v.flags & FLAG_INLINE_OMAP)) {
+      denc(v.inline_omap, p);
+      denc(v.inline_omap_header, p);
+    }
     DENC_FINISH(p);
   }
   void dump(ceph::Formatter *f) const;
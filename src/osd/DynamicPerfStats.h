@@ -4,6 +4,8 @@
 #ifndef DYNAMIC_PERF_STATS_H
 #define DYNAMIC_PERF_STATS_H
 
+#include <algorithm>
+
 #include "include/random.h"
 #include "messages/MOSDOp.h"
 #include "mgr/OSDPerfMetricTypes.h"
@@ -12,10 +14,11 @@
 
 class DynamicPerfStats {
 public:
-  DynamicPerfStats() {
+  DynamicPerfStats() : max_keys(get_max_keys()) {
   }
 
-  DynamicPerfStats(const std::list<OSDPerfMetricQuery> &queries) {
+  DynamicPerfStats(const std::list<OSDPerfMetricQuery> &queries)
+    : max_keys(get_max_keys()) {
     for (auto &query : queries) {
       data[query];
     }
@@ -38,6 +41,7 @@ public:
         ceph_assert(key_it.second.size() >= data[query][key].size());
         query.update_counters(update_counter_fnc, &data[query][key]);
       }
+      maybe_trim(&data[query]);
     }
   }
 
@@ -48,6 +52,7 @@ public:
       std::swap(new_data[query], data[query]);
     }
     std::swap(data, new_data);
+    max_keys = get_max_keys();
   }
 
   bool is_enabled() {
@@ -164,6 +169,7 @@ public:
       OSDPerfMetricKey key;
       if (query.get_key(get_subkey_fnc, &key)) {
         query.update_counters(update_counter_fnc, &it.second[key]);
+        maybe_trim(&it.second);
       }
     }
   }
@@ -245,6 +251,38 @@ public:
   }
 
 private:
+  static uint64_t get_max_keys() {
+    return g_conf().get_val<uint64_t>("osd_perf_metric_max_keys");
+  }
+
+  // Lossy counting: once a query tracks more than max_keys keys, keep
+  // only the heavier half by its first counter.  Keys that keep getting
+  // hits survive every trim, so top-N reports stay accurate for them
+  // while memory stays bounded regardless of key cardinality.
+  void maybe_trim(std::map<OSDPerfMetricKey, PerformanceCounters> *counters) {
+    if (max_keys == 0 || counters->size() <= max_keys) {
+      return;
+    }
+    typedef std::map<OSDPerfMetricKey, PerformanceCounters>::iterator
+        Iterator;
+    std::vector<Iterator> its;
+    its.reserve(counters->size());
+    for (auto it = counters->begin(); it != counters->end(); ++it) {
+      its.push_back(it);
+    }
+    auto weight = [](Iterator it) {
+      return it->second.empty() ? 0 : it->second[0].first;
+    };
+    size_t keep = std::max<size_t>(1, max_keys / 2);
+    std::nth_element(its.begin(), its.begin() + keep, its.end(),
+                     [&weight](Iterator a, Iterator b) {
+                       return weight(a) > weight(b);
+                     });
+    for (auto i = its.begin() + keep; i != its.end(); ++i) {
+      counters->erase(*i);
+    }
+  }
+
   static bool is_limited(const OSDPerfMetricLimits &limits,
                          size_t counters_size) {
     if (limits.empty()) {
@@ -262,6 +300,7 @@ private:
 
   std::map<OSDPerfMetricQuery,
            std::map<OSDPerfMetricKey, PerformanceCounters>> data;
+  uint64_t max_keys = 0;
 };
 
 #endif // DYNAMIC_PERF_STATS_H
@@ -1256,6 +1256,9 @@ void ECBackend::handle_sub_read_reply(
       pair<uint64_t, uint64_t> aligned =
 	sinfo.chunk_aligned_offset_len_to_chunk(
 	  make_pair(req_iter->offset, req_iter->size));
+      if (rop.to_read.find(i->first)->second.need.size() == 1) {
+	read_pipeline.get_sub_chunk_read(*req_iter, from.shard, &aligned);
+      }
       ceph_assert(aligned.first == j->first);
       riter->get<2>()[from] = std::move(j->second);
     }
@@ -23,6 +23,7 @@
 #include "messages/MOSDECSubOpRead.h"
 #include "messages/MOSDECSubOpReadReply.h"
 #include "ECMsgTypes.h"
+#include "osd_perf_counters.h"
 #include "PGLog.h"
 
 #include "osd_tracer.h"
@@ -301,9 +302,30 @@ int ECCommon::ReadPipeline::get_min_avail_to_read_shards(
   get_all_avail_shards(hoid, error_shards, have, shards, for_recovery);
 
   map<int, vector<pair<int, int>>> need;
-  int r = ec_impl->minimum_to_decode(want, have, &need);
-  if (r < 0)
-    return r;
+  int r;
+#ifndef WITH_SEASTAR
+  if (for_recovery && cct->_conf->osd_ec_recovery_cost_aware_reads &&
+      ec_impl->get_sub_chunk_count() == 1) {
+    // steer recovery reads away from slow peers
+    map<int, int> costs;
+    for (auto &&i : have) {
+      costs[i] = get_parent()->get_shard_read_cost(shards[shard_id_t(i)]);
+    }
+    set<int> minimum;
+    r = ec_impl->minimum_to_decode_with_cost(want, costs, &minimum);
+    if (r < 0)
+      return r;
+    for (auto &&i : minimum) {
+      need[i].push_back(make_pair(0, 1));
+    }
+    dout(20) << __func__ << " costs " << costs << " need " << minimum << dendl;
+  } else
+#endif
+  {
+    r = ec_impl->minimum_to_decode(want, have, &need);
+    if (r < 0)
+      return r;
+  }
 
   if (do_redundant_reads) {
       vector<pair<int, int>> subchunks_list;
@@ -455,6 +477,10 @@ void ECCommon::ReadPipeline::do_read_op(ReadOp &op)
     for (const auto& read : i->second.to_read) {
       auto p = make_pair(read.offset, read.size);
       pair<uint64_t, uint64_t> chunk_off_len = sinfo.chunk_aligned_offset_len_to_chunk(p);
+      if (i->second.need.size() == 1) {
+	get_sub_chunk_read(read, i->second.need.begin()->first.shard,
+			   &chunk_off_len);
+      }
       for (auto k = i->second.need.begin();
 	   k != i->second.need.end();
 	   ++k) {
@@ -508,6 +534,23 @@ void ECCommon::ReadPipeline::get_want_to_read_shards(
   }
 }
 
+bool ECCommon::ReadPipeline::get_sub_chunk_read(
+  const ec_align_t &read,
+  int shard,
+  pair<uint64_t, uint64_t> *shard_off_len) const
+{
+  unsigned int raw_shard;
+  pair<uint64_t, uint64_t> off_len;
+  if (ec_impl->get_sub_chunk_count() != 1 ||
+      !sinfo.offset_len_to_sub_chunk(make_pair(read.offset, read.size),
+				     &raw_shard, &off_len) ||
+      sinfo.get_shard(raw_shard) != shard) {
+    return false;
+  }
+  *shard_off_len = off_len;
+  return true;
+}
+
 struct ClientReadCompleter : ECCommon::ReadCompleter {
   ClientReadCompleter(ECCommon::ReadPipeline &read_pipeline,
                       ECCommon::ClientAsyncReadStatus *status)
@@ -542,6 +585,28 @@ struct ClientReadCompleter : ECCommon::ReadCompleter {
 	   ++j) {
 	to_decode[j->first.shard] = std::move(j->second);
       }
+      uint64_t shard_bytes = 0;
+      for (auto& [shard, chunk] : to_decode) {
+	shard_bytes += chunk.length();
+      }
+      if (shard_bytes > read.size) {
+	read_pipeline.get_parent()->get_logger()->inc(
+	  l_osd_ec_read_overread_bytes, shard_bytes - read.size);
+      }
+      pair<uint64_t, uint64_t> sub_chunk;
+      if (to_decode.size() == 1 &&
+	  read_pipeline.get_sub_chunk_read(read, to_decode.begin()->first,
+					   &sub_chunk)) {
+	// only the requested bytes were fetched, from the shard that
+	// holds them: nothing to decode or trim
+	auto& chunk = to_decode.begin()->second;
+	ceph_assert(read.size <= chunk.length());
+	bufferlist trimmed;
+	trimmed.substr_of(chunk, 0, read.size);
+	result.insert(read.offset, trimmed.length(), std::move(trimmed));
+	res.returned.pop_front();
+	continue;
+      }
       dout(20) << __func__ << " going to decode: "
                << " wanted_to_read=" << wanted_to_read
                << " to_decode=" << to_decode
@@ -751,6 +816,14 @@ bool ECCommon::RMWPipeline::try_state_to_reads()
 
   if (op->using_cache) {
     cache.open_write_pin(op->pin);
+    if (op->invalidates_cache()) {
+      // ops that follow until the pipeline drains bypass the cache
+      cache.invalidate_retained();
+    } else {
+      for (auto &&oid : op->plan.resets) {
+	cache.invalidate_retained(oid);
+      }
+    }
 
     extent_set empty;
     for (auto &&hpair: op->plan.will_write) {
@@ -1010,6 +1083,7 @@ bool ECCommon::RMWPipeline::try_finish_rmw()
   }
 
   if (op->using_cache) {
+    cache.set_retain_max_bytes(cct->_conf->osd_ec_extent_cache_size);
     cache.release_write_pin(op->pin);
   }
   tid_to_op_map.erase(op->tid);
@@ -1044,6 +1118,7 @@ void ECCommon::RMWPipeline::on_change()
   for (auto &&op: tid_to_op_map) {
     cache.release_write_pin(op.second->pin);
   }
+  cache.invalidate_retained();
   tid_to_op_map.clear();
 }
 
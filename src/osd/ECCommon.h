@@ -33,6 +33,7 @@ struct ECTransaction {
     bool invalidates_cache = false; // Yes, both are possible
     std::map<hobject_t,extent_set> to_read;
     std::map<hobject_t,extent_set> will_write; // superset of to_read
+    std::set<hobject_t> resets;
 
     std::map<hobject_t,ECUtil::HashInfoRef> hash_infos;
   };
@@ -138,6 +139,11 @@ struct ECListener {
 
   // XXX
 #ifndef WITH_SEASTAR
+  virtual PerfCounters *get_logger() = 0;
+
+  /// relative cost of reading from **shard**, 0 if unknown
+  virtual int get_shard_read_cost(pg_shard_t shard) = 0;
+
   virtual GenContext<ThreadPool::TPHandle&> *bless_unlocked_gencontext(
     GenContext<ThreadPool::TPHandle&> *c) = 0;
 
@@ -482,6 +488,13 @@ struct ECCommon {
 
     void get_want_to_read_shards(std::set<int> *want_to_read) const;
 
+    /// if `read` lies within one chunk and `shard` holds it, the bytes
+    /// to fetch from that shard alone instead of whole chunks to decode
+    bool get_sub_chunk_read(
+      const ec_align_t &read,
+      int shard,
+      std::pair<uint64_t, uint64_t> *shard_off_len) const;
+
     /// Returns to_read replicas sufficient to reconstruct want
     int get_min_avail_to_read_shards(
       const hobject_t &hoid,     ///< [in] object
@@ -26,6 +26,8 @@ namespace ECTransaction {
     bool invalidates_cache = false; // Yes, both are possible
     std::map<hobject_t,extent_set> to_read;
     std::map<hobject_t,extent_set> will_write; // superset of to_read
+    // deleted or truncated, so data outside will_write changes too
+    std::set<hobject_t> resets;
 
     std::map<hobject_t,ECUtil::HashInfoRef> hash_infos;
   };
@@ -51,6 +53,9 @@ namespace ECTransaction {
 			     << " to 0" << dendl;
 	  projected_size = 0;
 	}
+	if (op.deletes_first() || op.truncate) {
+	  plan.resets.insert(obj);
+	}
 
 	hobject_t source;
 	if (op.has_source(&source)) {
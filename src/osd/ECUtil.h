@@ -177,6 +177,25 @@ public:
     const auto last_chunk_idx = (chunk_size - 1 + off + len) / chunk_size;
     return {first_chunk_idx, last_chunk_idx};
   }
+  /// if [off, off+len) lies within a single data chunk, return the raw
+  /// shard holding it and the matching byte range on that shard
+  bool offset_len_to_sub_chunk(
+    std::pair<uint64_t, uint64_t> in,
+    unsigned int *raw_shard,
+    std::pair<uint64_t, uint64_t> *out) const {
+    if (in.second == 0) {
+      return false;
+    }
+    const auto chunk_idx = in.first / chunk_size;
+    if ((in.first + in.second - 1) / chunk_size != chunk_idx) {
+      return false;
+    }
+    *raw_shard = chunk_idx % k;
+    *out = std::make_pair(
+      logical_to_prev_chunk_offset(in.first) + in.first % chunk_size,
+      in.second);
+    return true;
+  }
   bool offset_length_is_same_stripe(
     uint64_t off, uint64_t len) const {
     if (len == 0) {
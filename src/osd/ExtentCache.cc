@@ -24,6 +24,7 @@ void ExtentCache::extent::_link_pin_state(pin_state &pin_state)
   ceph_assert(!parent_pin_state);
   parent_pin_state = &pin_state;
   pin_state.pin_list.push_back(*this);
+  pin_state.bytes += length;
 }
 
 void ExtentCache::extent::_unlink_pin_state()
@@ -32,6 +33,7 @@ void ExtentCache::extent::_unlink_pin_state()
   ceph_assert(parent_pin_state);
   auto liter = pin_state::list::s_iterator_to(*this);
   parent_pin_state->pin_list.erase(liter);
+  parent_pin_state->bytes -= length;
   parent_pin_state = nullptr;
 }
 
@@ -220,6 +222,41 @@ void ExtentCache::present_rmw_update(
   }
 }
 
+void ExtentCache::trim_retained(uint64_t max)
+{
+  while (retained.bytes > max) {
+    std::unique_ptr<extent> extent(&retained.pin_list.front());
+    auto &eset = *(extent->parent_extent_set);
+    extent->unlink();
+    remove_and_destroy_if_empty(eset);
+  }
+}
+
+void ExtentCache::invalidate_retained(const hobject_t &oid)
+{
+  auto *eset = get_if_exists(oid);
+  if (!eset) {
+    return;
+  }
+  eset->retain_min_tid = next_write_tid;
+  for (auto iter = eset->extent_set.begin();
+       iter != eset->extent_set.end(); ) {
+    extent *ext = &*iter;
+    ++iter;
+    if (ext->parent_pin_state == &retained) {
+      ext->unlink();
+      delete ext;
+    }
+  }
+  remove_and_destroy_if_empty(*eset);
+}
+
+void ExtentCache::invalidate_retained()
+{
+  retain_min_tid = next_write_tid;
+  trim_retained(0);
+}
+
 ostream &ExtentCache::print(ostream &out) const
 {
   out << "ExtentCache(" << std::endl;
@@ -92,6 +92,15 @@
    All of the above suggests that there are 3 things users can
    ask of the cache corresponding to the 3 Write pipelines
    states.
+
+   Optionally, up to a byte budget, extents holding data are kept
+   after the last write pin on them is released ("retained") so that
+   later rmw writes to the same stripes need not read them again.
+   Retained extents are owned by an internal pin in LRU order and are
+   treated like Write Pinned extents by reserve_extents_for_rmw.  The
+   user must drop them with invalidate_retained() whenever an object
+   changes outside of the rmw path (delete, truncate, clone, interval
+   change).
  */
 
 /// If someone wants these types, but not ExtentCache, move to another file
@@ -171,6 +180,8 @@ private:
 
   struct object_extent_set : boost::intrusive::set_base_hook<> {
     hobject_t oid;
+    /// pins older than this do not retain their extents
+    uint64_t retain_min_tid = 0;
     explicit object_extent_set(const hobject_t &oid) : oid(oid) {}
 
     using set_member_options = boost::intrusive::member_hook<
@@ -353,6 +364,7 @@ private:
     };
     pin_type_t pin_type = NONE;
     bool is_write() const { return pin_type == WRITE; }
+    uint64_t bytes = 0;   ///< total length of pin_list
 
     pin_state(const pin_state &other) = delete;
     pin_state &operator=(const pin_state &other) = delete;
@@ -380,18 +392,40 @@ private:
 
   void release_pin(pin_state &p) {
     for (auto iter = p.pin_list.begin(); iter != p.pin_list.end(); ) {
-      std::unique_ptr<extent> extent(&*iter); // we now own this
-      iter++; // unlink will invalidate
-      ceph_assert(extent->parent_extent_set);
-      auto &eset = *(extent->parent_extent_set);
+      extent *ext = &*iter;
+      iter++; // unlink/move will invalidate
+      ceph_assert(ext->parent_extent_set);
+      auto &eset = *(ext->parent_extent_set);
+      if (ext->bl && retain_max_bytes &&
+	  p.tid >= std::max(retain_min_tid, eset.retain_min_tid)) {
+	ext->move(retained);
+	continue;
+      }
+      std::unique_ptr<extent> extent(ext); // we now own this
       extent->unlink();
       remove_and_destroy_if_empty(eset);
     }
     p.tid = 0;
     p.pin_type = pin_state::NONE;
+    trim_retained();
+  }
+
+  /// extents kept after their last write pin released, oldest first
+  pin_state retained;
+  uint64_t retain_max_bytes = 0;
+  /// pins older than this do not retain their extents
+  uint64_t retain_min_tid = 0;
+
+  void trim_retained(uint64_t max);
+  void trim_retained() {
+    trim_retained(retain_max_bytes);
   }
 
 public:
+  ~ExtentCache() {
+    trim_retained(0);
+  }
+
   class write_pin : private pin_state {
     friend class ExtentCache;
   private:
@@ -481,6 +515,29 @@ public:
     release_pin(pin);
   }
 
+  /**
+   * Set the budget for retained extents, 0 to disable retention
+   */
+  void set_retain_max_bytes(uint64_t max) {
+    retain_max_bytes = max;
+    trim_retained();
+  }
+
+  uint64_t get_retained_bytes() const {
+    return retained.bytes;
+  }
+
+  /**
+   * Drop retained extents of oid, and make sure extents pinned by
+   * writes that are already open are not retained when released
+   */
+  void invalidate_retained(const hobject_t &oid);
+
+  /**
+   * Same as above for every object
+   */
+  void invalidate_retained();
+
   std::ostream &print(std::ostream &out) const;
 };
 
@@ -34,6 +34,10 @@
 #include <sys/mount.h>
 #endif
 
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
 #include "osd/PG.h"
 #include "osd/scrubber/scrub_machine.h"
 #include "osd/scrubber/pg_scrubber.h"
@@ -136,6 +140,7 @@
 
 #include "common/cmdparse.h"
 #include "include/str_list.h"
+#include "common/strtol.h"
 #include "include/util.h"
 
 #include "include/ceph_assert.h"
@@ -2420,6 +2425,9 @@ OSD::OSD(CephContext *cct_,
                                            cct->_conf->osd_op_history_duration);
   op_tracker.set_history_slow_op_size_and_threshold(cct->_conf->osd_op_history_slow_op_size,
                                                     cct->_conf->osd_op_history_slow_op_threshold);
+  op_tracker.set_timeline_stage_names(OpRequest::get_timeline_stage_names());
+  op_tracker.set_timeline(cct->_conf->osd_op_timeline_sample_interval,
+                          cct->_conf->osd_op_timeline_size);
   ObjectCleanRegions::set_max_num_intervals(cct->_conf->osd_object_clean_region_max_num_intervals);
 #ifdef WITH_BLKIN
   std::stringstream ss;
@@ -2585,6 +2593,10 @@ int OSD::set_numa_affinity()
       dout(1) << __func__ << " unable to determine numa node " << numa_node
 	      << " CPUs" << dendl;
       numa_node = -1;
+    } else if (!shard_cpus.empty()) {
+      // would undo the pinning of the op shard threads
+      dout(1) << __func__ << " op shards are pinned (osd_op_shard_cpus), "
+	      << "not setting numa affinity to node " << numa_node << dendl;
     } else {
       dout(1) << __func__ << " setting numa affinity to node " << numa_node
 	      << " cpus "
@@ -2601,6 +2613,7 @@ int OSD::set_numa_affinity()
   } else {
     dout(1) << __func__ << " not setting numa affinity" << dendl;
   }
+
   return 0;
 }
 
@@ -2857,6 +2870,8 @@ will start to track new ops received afterwards.";
 	goto out;
       }
     }
+  } else if (prefix == "dump_ops_timeline") {
+    op_tracker.dump_ops_timeline(f);
   } else if (prefix == "dump_op_pq_state") {
     f->open_object_section("pq");
     op_shardedwq.dump(f);
@@ -3757,6 +3772,11 @@ int OSD::init()
   journal_is_rotational = store->is_journal_rotational();
   dout(2) << "journal looks like " << (journal_is_rotational ? "hdd" : "ssd")
           << dendl;
+  {
+    set<string> devnames;
+    store->get_devices(&devnames);
+    service.get_scrub_services().set_scrub_devices(devnames);
+  }
 
   enable_disable_fuse(false);
 
@@ -4038,9 +4058,31 @@ int OSD::init()
     }
   }
 
+  // per shard pinning of the op threads, applied as they start
+  if (auto cpus = cct->_conf.get_val<std::string>("osd_op_shard_cpus");
+      !cpus.empty()) {
+    size_t cpu_set_size;
+    cpu_set_t cpu_set;
+    if (int err = parse_cpu_set_list(cpus.c_str(), &cpu_set_size, &cpu_set);
+	err < 0) {
+      derr << __func__ << " unable to parse osd_op_shard_cpus '" << cpus
+	   << "': " << cpp_strerror(err) << dendl;
+    } else {
+      for (auto cpu : cpu_set_to_set(cpu_set_size, &cpu_set)) {
+	shard_cpus.push_back(cpu);
+      }
+      dout(1) << __func__ << " pinning op shards to cpus "
+	      << cpu_set_to_str_list(cpu_set_size, &cpu_set) << dendl;
+    }
+  }
   osd_op_tp.start();
 
   // start the heartbeat
+  if (int cpu = cct->_conf.get_val<int64_t>("osd_heartbeat_thread_cpu");
+      cpu >= 0) {
+    dout(1) << __func__ << " pinning heartbeat thread to cpu " << cpu << dendl;
+    heartbeat_thread.set_affinity(cpu);
+  }
   heartbeat_thread.create("osd_srv_heartbt");
 
   // tick
@@ -4122,6 +4164,7 @@ int OSD::init()
   maybe_override_sleep_options_for_qos();
   maybe_override_options_for_qos();
   maybe_override_max_osd_capacity_for_qos();
+  maybe_calibrate_cost_curve_for_qos();
 
   return 0;
 
@@ -4178,6 +4221,10 @@ void OSD::final_init()
 				     asok_hook,
 				     "show slowest recent ops, sorted by duration");
   ceph_assert(r == 0);
+  r = admin_socket->register_command("dump_ops_timeline",
+				     asok_hook,
+				     "show per-stage latency of sampled recent ops");
+  ceph_assert(r == 0);
   r = admin_socket->register_command("dump_op_pq_state",
 				     asok_hook,
 				     "dump op queue state");
@@ -6174,6 +6221,19 @@ void OSD::handle_osd_ping(MOSDPing *m)
 
 void OSD::heartbeat_entry()
 {
+#ifdef __linux__
+  // per-thread on linux: PRIO_PROCESS with a tid only affects that thread
+  if (int nice = cct->_conf.get_val<int64_t>("osd_heartbeat_thread_nice");
+      nice != 0) {
+    if (setpriority(PRIO_PROCESS, ceph_gettid(), nice) < 0) {
+      int r = -errno;
+      derr << __func__ << " unable to set heartbeat thread nice to " << nice
+	   << ": " << cpp_strerror(r) << dendl;
+    } else {
+      dout(1) << __func__ << " heartbeat thread nice " << nice << dendl;
+    }
+  }
+#endif
   std::unique_lock l(heartbeat_lock);
   if (is_stopping())
     return;
@@ -7551,11 +7611,6 @@ bool OSD::heartbeat_dispatch(Message *m)
 bool OSD::ms_dispatch(Message *m)
 {
   dout(20) << "OSD::ms_dispatch: " << *m << dendl;
-  if (m->get_type() == MSG_OSD_MARK_ME_DOWN) {
-    service.got_stop_ack();
-    m->put();
-    return true;
-  }
 
   // lock!
 
@@ -7657,6 +7712,12 @@ void OSD::dispatch_session_waiting(const ceph::ref_t<Session>& session, OSDMapRe
 void OSD::ms_fast_dispatch(Message *m)
 {
   FUNCTRACE(cct);
+  if (m->get_type() == MSG_OSD_MARK_ME_DOWN) {
+    // the monitor's ack of our shutdown; prepare_to_stop() waits for it
+    service.got_stop_ack();
+    m->put();
+    return;
+  }
   if (service.is_stopping()) {
     m->put();
     return;
@@ -7734,7 +7795,8 @@ void OSD::ms_fast_dispatch(Message *m)
     enqueue_op(
       static_cast<MOSDFastDispatchOp*>(m)->get_spg(),
       std::move(op),
-      static_cast<MOSDFastDispatchOp*>(m)->get_map_epoch());
+      static_cast<MOSDFastDispatchOp*>(m)->get_map_epoch(),
+      true);
   } else {
     // legacy client, and this is an MOSDOp (the *only* fast dispatch
     // message that didn't have an explicit spg_t); we need to map
@@ -9839,7 +9901,8 @@ bool OSD::op_is_discardable(const MOSDOp *op)
   return false;
 }
 
-void OSD::enqueue_op(spg_t pg, OpRequestRef&& op, epoch_t epoch)
+void OSD::enqueue_op(spg_t pg, OpRequestRef&& op, epoch_t epoch,
+		     bool allow_inline)
 {
   const utime_t stamp = op->get_req()->get_recv_stamp();
   const utime_t latency = ceph_clock_now() - stamp;
@@ -9874,6 +9937,11 @@ void OSD::enqueue_op(spg_t pg, OpRequestRef&& op, epoch_t epoch)
       OpSchedulerItem(
         unique_ptr<OpSchedulerItem::OpQueueable>(new PGRecoveryMsg(pg, std::move(op))),
         cost, priority, stamp, owner, epoch));
+  } else if (allow_inline && cct->_conf->osd_op_inline_dispatch) {
+    op_shardedwq.enqueue_inline(
+      OpSchedulerItem(
+        unique_ptr<OpSchedulerItem::OpQueueable>(new PGOpItem(pg, std::move(op))),
+        cost, priority, stamp, owner, epoch));
   } else {
     op_shardedwq.queue(
       OpSchedulerItem(
@@ -10007,6 +10075,8 @@ std::vector<std::string> OSD::get_tracked_keys() const noexcept
     "osd_op_history_slow_op_size"s,
     "osd_op_history_slow_op_threshold"s,
     "osd_enable_op_tracker"s,
+    "osd_op_timeline_sample_interval"s,
+    "osd_op_timeline_size"s,
     "osd_map_cache_size"s,
     "osd_pg_epoch_max_lag_factor"s,
     "osd_pg_epoch_persisted_max_stale"s,
@@ -10114,6 +10184,11 @@ void OSD::handle_conf_change(const ConfigProxy& conf,
   if (changed.count("osd_enable_op_tracker")) {
       op_tracker.set_tracking(cct->_conf->osd_enable_op_tracker);
   }
+  if (changed.count("osd_op_timeline_sample_interval") ||
+      changed.count("osd_op_timeline_size")) {
+    op_tracker.set_timeline(cct->_conf->osd_op_timeline_sample_interval,
+                            cct->_conf->osd_op_timeline_size);
+  }
   if (changed.count("osd_map_cache_size")) {
     service.map_cache.set_size(cct->_conf->osd_map_cache_size);
     service.map_bl_cache.set_size(cct->_conf->osd_map_cache_size);
@@ -10298,6 +10373,68 @@ void OSD::maybe_override_max_osd_capacity_for_qos()
   }
 }
 
+void OSD::maybe_calibrate_cost_curve_for_qos()
+{
+  if ((op_queue_type_t::mClockScheduler != osd_op_queue_type()) ||
+      cct->_conf.get_val<bool>("osd_mclock_skip_benchmark") ||
+      !cct->_conf.get_val<bool>("osd_mclock_calibrate_cost_curve") ||
+      (store->get_type() == "memstore")) {
+    return;
+  }
+  if (!cct->_conf.get_val<std::string>("osd_mclock_cost_curve").empty() &&
+      !cct->_conf.get_val<bool>("osd_mclock_force_run_benchmark_on_init")) {
+    dout(1) << __func__ << " osd_mclock_cost_curve already set."
+            << " Skip calibration." << dendl;
+    return;
+  }
+
+  std::vector<std::string> sizes;
+  get_str_vec(
+    cct->_conf.get_val<std::string>("osd_mclock_calibration_block_sizes"),
+    ",", sizes);
+  // Same object set and write count per size as the iops benchmark in
+  // maybe_override_max_osd_capacity_for_qos(), within the osd bench limits
+  const int64_t osize = 4194304;
+  const int64_t onum = 100;
+  const int64_t ios = 3000;
+  const int64_t duration = cct->_conf->osd_bench_duration;
+  std::string curve;
+  for (auto &s : sizes) {
+    std::string err;
+    int64_t bsize = strict_iecstrtoll(s, &err);
+    if (!err.empty() || bsize <= 0 || bsize > osize) {
+      derr << __func__ << " invalid block size '" << s << "'" << dendl;
+      return;
+    }
+    int64_t count = std::min<int64_t>(bsize * ios,
+      bsize < (1 << 20) ?
+        bsize * duration * cct->_conf->osd_bench_small_size_max_iops :
+        cct->_conf->osd_bench_large_size_max_throughput * duration);
+    double elapsed = 0.0;
+    stringstream ss;
+    int ret = run_osd_bench_test(count, bsize, osize, onum, &elapsed, ss);
+    if (ret != 0) {
+      derr << __func__
+           << " osd bench err: " << ret
+           << " osd bench errstr: " << ss.str()
+           << dendl;
+      return;
+    }
+    double iops = count / elapsed / bsize;
+    dout(1) << __func__ << " bsize " << bsize
+            << std::fixed << std::setprecision(3)
+            << " iops " << iops
+            << " elapsed_sec " << elapsed << dendl;
+    if (!curve.empty()) {
+      curve += ",";
+    }
+    curve += std::to_string(bsize) + ":" + std::to_string(iops);
+  }
+  if (!curve.empty()) {
+    mon_cmd_set_config("osd_mclock_cost_curve", curve);
+  }
+}
+
 bool OSD::maybe_override_options_for_qos(const std::set<std::string> *changed)
 {
   // Override options only if the scheduler enabled is mclock and the
@@ -10755,6 +10892,7 @@ void OSDShard::consume_map(
 
     ++p;
   }
+  _update_pool_qos(new_osdmap);
   if (queued) {
     std::lock_guard l{sdata_wait_lock};
     if (queued == 1)
@@ -10764,6 +10902,46 @@ void OSDShard::consume_map(
   }
 }
 
+void OSDShard::_update_pool_qos(const OSDMapRef& osdmap)
+{
+  using ceph::osd::scheduler::OpScheduler;
+  std::map<int64_t, OpScheduler::pool_qos_t> qos;
+  for (auto& [pool_id, pool] : osdmap->get_pools()) {
+    int64_t res = 0, wgt = 0, lim = 0;
+    pool.opts.get(pool_opts_t::QOS_RESERVATION, &res);
+    pool.opts.get(pool_opts_t::QOS_WEIGHT, &wgt);
+    pool.opts.get(pool_opts_t::QOS_LIMIT, &lim);
+    if (res > 0 || wgt > 0 || lim > 0) {
+      qos[pool_id] = OpScheduler::pool_qos_t{
+	(double)res, (uint64_t)std::max<int64_t>(wgt, 1), (double)lim};
+    }
+  }
+  if (qos.empty() && !has_pool_qos) {
+    return;
+  }
+  has_pool_qos = !qos.empty();
+
+  // the pool's reservation and limit are cluster wide: this shard gets
+  // the fraction of the pool's pgs whose primary it holds
+  std::map<int64_t, unsigned> primaries;
+  for (auto& [pgid, slot] : pg_slots) {
+    if (slot->pg && qos.count(pgid.pool()) &&
+	osdmap->get_pg_acting_primary(pgid.pgid) == osd->get_nodeid()) {
+      ++primaries[pgid.pool()];
+    }
+  }
+  for (auto& [pool_id, q] : qos) {
+    double share = (double)primaries[pool_id] /
+      std::max(osdmap->get_pg_num(pool_id), 1);
+    q.reservation *= share;
+    q.limit *= share;
+    dout(20) << __func__ << " pool " << pool_id << " primaries "
+	     << primaries[pool_id] << " res " << q.reservation
+	     << " wgt " << q.weight << " lim " << q.limit << dendl;
+  }
+  scheduler->update_pool_qos(qos);
+}
+
 int OSDShard::_wake_pg_slot(
   spg_t pgid,
   OSDShardPGSlot *slot)
@@ -11024,6 +11202,13 @@ OSDShard::OSDShard(
     context_queue(sdata_wait_lock, sdata_cond)
 {
   dout(0) << "using op scheduler " << *scheduler << dendl;
+  inline_hb = cct->get_heartbeat_map()->add_worker(
+    shard_name + "::inline", pthread_self());
+}
+
+OSDShard::~OSDShard()
+{
+  cct->get_heartbeat_map()->remove_worker(inline_hb);
 }
 
 
@@ -11057,6 +11242,27 @@ void OSD::ShardedOpWQ::_add_slot_waiter(
 #undef dout_prefix
 #define dout_prefix *_dout << "osd." << osd->whoami << " op_wq(" << shard_index << ") "
 
+void OSD::ShardedOpWQ::_thread_start(uint32_t thread_index)
+{
+  uint32_t shard_index = thread_index % osd->num_shards;
+  const auto& cpus = osd->shard_cpus;
+  if (cpus.empty()) {
+    return;
+  }
+  int cpu = cpus[shard_index % cpus.size()];
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  int r = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (r != 0) {
+    derr << __func__ << " thread " << thread_index << " failed to pin to cpu "
+	 << cpu << ": " << cpp_strerror(r) << dendl;
+  } else {
+    dout(10) << __func__ << " thread " << thread_index << " on cpu " << cpu
+	     << dendl;
+  }
+}
+
 void OSD::ShardedOpWQ::_process(uint32_t thread_index, heartbeat_handle_d *hb)
 {
   uint32_t shard_index = thread_index % osd->num_shards;
@@ -11068,6 +11274,7 @@ void OSD::ShardedOpWQ::_process(uint32_t thread_index, heartbeat_handle_d *hb)
   // thread_index(thread_index < num_shards) of shard to do oncommit
   // callback.
   bool is_smallest_thread_index = thread_index < osd->num_shards;
+  const unsigned batch_max = osd->cct->_conf->osd_op_pg_batch_max;
 
   // peek at spg_t
   sdata->shard_lock.lock();
@@ -11191,6 +11398,14 @@ void OSD::ShardedOpWQ::_process(uint32_t thread_index, heartbeat_handle_d *hb)
  retry_pg:
   PGRef pg = slot->pg;
 
+  if (pg && slot->num_draining) {
+    // the thread holding the pg lock will run it after its current item
+    dout(20) << __func__ << " " << token << " left to batch" << dendl;
+    sdata->shard_lock.unlock();
+    handle_oncommits(oncommits);
+    return;
+  }
+
   // lock pg (if we have it)
   if (pg) {
     // note the requeue seq now...
@@ -11348,6 +11563,10 @@ void OSD::ShardedOpWQ::_process(uint32_t thread_index, heartbeat_handle_d *hb)
       return;
     }
   }
+  const bool batching = batch_max > 1;
+  if (batching) {
+    ++slot->num_draining;
+  }
   sdata->shard_lock.unlock();
 
   if (!new_children.empty()) {
@@ -11393,6 +11612,63 @@ void OSD::ShardedOpWQ::_process(uint32_t thread_index, heartbeat_handle_d *hb)
   }
 
   handle_oncommits(oncommits);
+  if (batching) {
+    _process_batch(sdata, token, pg, batch_max, tp_handle);
+  }
+}
+
+void OSD::ShardedOpWQ::_process_batch(
+  OSDShard *sdata,
+  spg_t token,
+  PGRef pg,
+  unsigned batch_max,
+  ThreadPool::TPHandle& tp_handle)
+{
+  // Run whatever other threads left in the slot while we held the pg
+  // lock.  Anything still queued when we stop is handed back to the
+  // scheduler so that no item is stranded without a thread behind it.
+  for (unsigned n = 1; ; ++n) {
+    pg->lock();
+    sdata->shard_lock.lock();
+    auto q = sdata->pg_slots.find(token);
+    if (q == sdata->pg_slots.end()) {
+      // raced with pg removal
+      dout(20) << __func__ << " slot " << token << " no longer there" << dendl;
+      sdata->shard_lock.unlock();
+      pg->unlock();
+      return;
+    }
+    OSDShardPGSlot *slot = q->second.get();
+    if (slot->to_process.empty() ||
+	slot->pg != pg ||
+	n >= batch_max ||
+	osd->is_stopping()) {
+      dout(20) << __func__ << " " << token << " ran " << n
+	       << " to_process " << slot->to_process << dendl;
+      if (!slot->to_process.empty()) {
+	sdata->_wake_pg_slot(token, slot);
+      }
+      --slot->num_draining;
+      sdata->shard_lock.unlock();
+      pg->unlock();
+      return;
+    }
+    auto qi = std::move(slot->to_process.front());
+    slot->to_process.pop_front();
+    dout(20) << __func__ << " " << qi << " pg " << pg << dendl;
+    if (qi.is_peering() &&
+	qi.get_map_epoch() > sdata->shard_osdmap->get_epoch()) {
+      _add_slot_waiter(token, slot, std::move(qi));
+      sdata->shard_lock.unlock();
+      pg->unlock();
+      continue;
+    }
+    sdata->shard_lock.unlock();
+
+    osd->logger->inc(l_osd_op_pg_batched);
+    tp_handle.reset_tp_timeout();
+    qi.run(osd, sdata, pg, tp_handle);
+  }
 }
 
 void OSD::ShardedOpWQ::_enqueue(OpSchedulerItem&& item) {
@@ -11426,6 +11702,84 @@ void OSD::ShardedOpWQ::_enqueue(OpSchedulerItem&& item) {
   }
 }
 
+void OSD::ShardedOpWQ::enqueue_inline(OpSchedulerItem&& item)
+{
+  if (unlikely(m_fast_shutdown) ) {
+    // stop enqueing when we are in the middle of a fast shutdown
+    return;
+  }
+
+  uint32_t shard_index =
+    item.get_ordering_token().hash_to_shard(osd->shards.size());
+
+  OSDShard* sdata = osd->shards[shard_index];
+  assert (NULL != sdata);
+
+  dout(20) << fmt::format("{} {}", __func__, item) << dendl;
+
+  const auto token = item.get_ordering_token();
+  sdata->shard_lock.lock();
+  bool empty = sdata->scheduler->empty();
+  sdata->scheduler->enqueue(std::move(item));
+
+  // Only an item the scheduler hands out right away for a pg that nobody
+  // else has work queued for may skip the worker threads; anything else
+  // (and anything ordered behind it) is left to _process.  One inline
+  // runner per shard keeps messenger threads from piling up on it.
+  PGRef pg;
+  if (empty && !sdata->inline_running && !osd->is_stopping()) {
+    auto p = sdata->pg_slots.find(token);
+    if (p != sdata->pg_slots.end()) {
+      OSDShardPGSlot *slot = p->second.get();
+      if (slot->pg &&
+	  slot->to_process.empty() &&
+	  slot->num_running == 0 &&
+	  slot->num_draining == 0 &&
+	  slot->waiting.empty() &&
+	  slot->waiting_peering.empty() &&
+	  slot->waiting_for_split.empty() &&
+	  slot->pg->try_lock()) {
+	pg = slot->pg;
+      }
+    }
+  }
+  if (pg) {
+    WorkItem work_item = sdata->scheduler->dequeue();
+    if (auto qi = std::get_if<OpSchedulerItem>(&work_item)) {
+      ceph_assert(qi->get_ordering_token() == token);
+      sdata->inline_running = true;
+      // so that a suicide timeout aborts this thread; published to the
+      // heartbeat checker by the timeout reset below
+      sdata->inline_hb->thread_id = pthread_self();
+      sdata->shard_lock.unlock();
+
+      ThreadPool::TPHandle tp_handle(osd->cct, sdata->inline_hb,
+				     timeout_interval.load(),
+				     suicide_interval.load());
+      tp_handle.reset_tp_timeout();
+      osd->logger->inc(l_osd_op_inline);
+      qi->run(osd, sdata, pg, tp_handle);  // unlocks pg
+      tp_handle.suspend_tp_timeout();
+
+      std::lock_guard l{sdata->shard_lock};
+      sdata->inline_running = false;
+      return;
+    }
+    // scheduled in the future, a worker will pick it up
+    pg->unlock();
+  }
+  sdata->shard_lock.unlock();
+
+  {
+    std::lock_guard l{sdata->sdata_wait_lock};
+    if (empty) {
+      sdata->sdata_cond.notify_all();
+    } else if (sdata->waiting_threads) {
+      sdata->sdata_cond.notify_one();
+    }
+  }
+}
+
 void OSD::ShardedOpWQ::_enqueue_front(OpSchedulerItem&& item)
 {
   if (unlikely(m_fast_shutdown) ) {
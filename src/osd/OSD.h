@@ -751,6 +751,15 @@ public:
     *pp = osd_stat.hb_pingtime;
     return;
   }
+  /// 1 minute average back network ping time to **osd** in usec, 0 if unknown
+  int get_hb_back_pingtime(int osd)
+  {
+    std::lock_guard l(stat_lock);
+    auto i = osd_stat.hb_pingtime.find(osd);
+    if (i == osd_stat.hb_pingtime.end())
+      return 0;
+    return i->second.back_pingtime[0];
+  }
 
   // -- OSD Full Status --
 private:
@@ -950,6 +959,7 @@ struct OSDShardPGSlot {
   PGRef pg;                      ///< pg reference
   std::deque<OpSchedulerItem> to_process; ///< order items for this slot
   int num_running = 0;          ///< _process threads doing pg lookup/lock
+  int num_draining = 0;         ///< _process threads running to_process in a batch
 
   std::deque<OpSchedulerItem> waiting;   ///< waiting for pg (or map + pg)
 
@@ -1017,9 +1027,16 @@ struct OSDShard {
 
   /// priority queue
   ceph::osd::scheduler::OpSchedulerRef scheduler;
+  /// scheduler was last given a non-empty per-pool QoS map
+  bool has_pool_qos = false;
 
   bool stop_waiting = false;
 
+  /// a messenger thread is running an op of this shard inline
+  bool inline_running = false;
+  /// points at whichever messenger thread is the inline runner
+  ceph::heartbeat_handle_d *inline_hb = nullptr;
+
   ContextQueue context_queue;
 
   void _attach_pg(OSDShardPGSlot *slot, PG *pg);
@@ -1039,6 +1056,9 @@ struct OSDShard {
 
   int _wake_pg_slot(spg_t pgid, OSDShardPGSlot *slot);
 
+  /// hand the scheduler this shard's share of each pool's QoS options
+  void _update_pool_qos(const OSDMapRef& osdmap);
+
   void identify_splits_and_merges(
     const OSDMapRef& as_of_osdmap,
     std::set<std::pair<spg_t,epoch_t>> *split_children,
@@ -1059,6 +1079,7 @@ struct OSDShard {
     OSD *osd,
     op_queue_type_t osd_op_queue,
     unsigned osd_op_queue_cut_off);
+  ~OSDShard();
 };
 
 class OSD : public Dispatcher,
@@ -1110,6 +1131,7 @@ protected:
   int numa_node = -1;
   size_t numa_cpu_set_size = 0;
   cpu_set_t numa_cpu_set;
+  std::vector<int> shard_cpus;  ///< cpu of each op shard's threads, if pinned
 
   bool store_is_rotational = true;
   bool journal_is_rotational = true;
@@ -1574,11 +1596,22 @@ protected:
     /// try to do some work
     void _process(uint32_t thread_index, ceph::heartbeat_handle_d *hb) override;
 
+    /// run items left in the pg slot by other threads (osd_op_pg_batch_max)
+    void _process_batch(OSDShard *sdata, spg_t token, PGRef pg,
+			unsigned batch_max, ThreadPool::TPHandle& tp_handle);
+
+    /// pin the thread to its shard's cpu (osd_op_shard_cpus)
+    void _thread_start(uint32_t thread_index) override;
+
     void stop_for_fast_shutdown();
 
     /// enqueue a new item
     void _enqueue(OpSchedulerItem&& item) override;
 
+    /// enqueue a client op and, if the shard scheduler hands it out right
+    /// away and its pg is idle, run it on the calling thread
+    void enqueue_inline(OpSchedulerItem&& item);
+
     /// requeue an old item (at the front of the line)
     void _enqueue_front(OpSchedulerItem&& item) override;
 
@@ -1641,7 +1674,9 @@ protected:
   } op_shardedwq;
 
 
-  void enqueue_op(spg_t pg, OpRequestRef&& op, epoch_t epoch);
+  /// allow_inline: the caller holds no locks (see osd_op_inline_dispatch)
+  void enqueue_op(spg_t pg, OpRequestRef&& op, epoch_t epoch,
+		  bool allow_inline = false);
   void dequeue_op(
     PGRef pg, OpRequestRef op,
     ThreadPool::TPHandle &handle);
@@ -1950,6 +1985,7 @@ private:
     case MSG_OSD_PG_RECOVERY_DELETE_REPLY:
     case MSG_OSD_PG_LEASE:
     case MSG_OSD_PG_LEASE_ACK:
+    case MSG_OSD_MARK_ME_DOWN:
       return true;
     default:
       return false;
@@ -2022,6 +2058,7 @@ private:
 
   int get_recovery_max_active();
   void maybe_override_max_osd_capacity_for_qos();
+  void maybe_calibrate_cost_curve_for_qos();
   void maybe_override_sleep_options_for_qos();
   bool maybe_override_options_for_qos(
     const std::set<std::string> *changed = nullptr);
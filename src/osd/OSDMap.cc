@@ -241,6 +241,38 @@ int OSDMap::Incremental::identify_osd(uuid_d u) const
   return -1;
 }
 
+bool OSDMap::Incremental::get_pg_local_changes(std::set<pg_t> *pgs) const
+{
+  if (fullmap.length() || crush.length() ||
+      new_max_osd >= 0 || new_flags >= 0 ||
+      !new_pools.empty() || !old_pools.empty() ||
+      !new_up_client.empty() || !new_state.empty() ||
+      !new_weight.empty() || !new_primary_affinity.empty() ||
+      new_require_osd_release != ceph_release_t{0xff} ||
+      change_stretch_mode) {
+    return false;
+  }
+  for (auto& i : new_pg_temp) {
+    pgs->insert(i.first);
+  }
+  for (auto& i : new_primary_temp) {
+    pgs->insert(i.first);
+  }
+  for (auto& i : new_pg_upmap) {
+    pgs->insert(i.first);
+  }
+  for (auto& i : new_pg_upmap_items) {
+    pgs->insert(i.first);
+  }
+  for (auto& i : new_pg_upmap_primary) {
+    pgs->insert(i.first);
+  }
+  pgs->insert(old_pg_upmap.begin(), old_pg_upmap.end());
+  pgs->insert(old_pg_upmap_items.begin(), old_pg_upmap_items.end());
+  pgs->insert(old_pg_upmap_primary.begin(), old_pg_upmap_primary.end());
+  return true;
+}
+
 int OSDMap::Incremental::propagate_base_properties_to_tiers(CephContext *cct,
 							    const OSDMap& osdmap)
 {
@@ -1769,7 +1801,7 @@ uint64_t OSDMap::get_features(int entity_type, uint64_t *pmask) const
     features |= CEPH_FEATUREMASK_CRUSH_MSR;
   mask |= CEPH_FEATURES_CRUSH;
 
-  if (!pg_upmap.empty() || !pg_upmap_items.empty())
+  if (!pg_upmap->empty() || !pg_upmap_items->empty())
     features |= CEPH_FEATUREMASK_OSDMAP_PG_UPMAP;
   mask |= CEPH_FEATUREMASK_OSDMAP_PG_UPMAP;
   if (!pg_upmap_primaries.empty())
@@ -1974,6 +2006,15 @@ void OSDMap::dedup(const OSDMap *o, OSDMap *n)
       n->primary_temp = o->primary_temp;
   }
 
+  // do the upmap tables match?  with the balancer active these are the
+  // largest per-map tables, so sharing them keeps cached maps small.
+  if (o->pg_upmap->size() == n->pg_upmap->size() &&
+      *o->pg_upmap == *n->pg_upmap)
+    n->pg_upmap = o->pg_upmap;
+  if (o->pg_upmap_items->size() == n->pg_upmap_items->size() &&
+      *o->pg_upmap_items == *n->pg_upmap_items)
+    n->pg_upmap_items = o->pg_upmap_items;
+
   // do uuids match?
   if (o->osd_uuid->size() == n->osd_uuid->size() &&
       *o->osd_uuid == *n->osd_uuid)
@@ -2069,10 +2110,10 @@ void OSDMap::clean_temps(CephContext *cct,
 
 void OSDMap::get_upmap_pgs(vector<pg_t> *upmap_pgs) const
 {
-  upmap_pgs->reserve(pg_upmap.size() + pg_upmap_items.size());
-  for (auto& p : pg_upmap)
+  upmap_pgs->reserve(pg_upmap->size() + pg_upmap_items->size());
+  for (auto& p : *pg_upmap)
     upmap_pgs->push_back(p.first);
-  for (auto& p : pg_upmap_items)
+  for (auto& p : *pg_upmap_items)
     upmap_pgs->push_back(p.first);
 }
 
@@ -2152,8 +2193,8 @@ bool OSDMap::check_pg_upmaps(
       continue;
     // okay, upmap is valid
     // continue to check if it is still necessary
-    auto i = pg_upmap.find(pg);
-    if (i != pg_upmap.end()) {
+    auto i = pg_upmap->find(pg);
+    if (i != pg_upmap->end()) {
       if (i->second == raw) {
         ldout(cct, 10) << __func__ << "removing redundant pg_upmap " << i->first << " "
                        << i->second << dendl;
@@ -2168,21 +2209,21 @@ bool OSDMap::check_pg_upmaps(
         continue;
       }
     }
-    auto j = pg_upmap_items.find(pg);
-    if (j != pg_upmap_items.end()) {
+    auto j = pg_upmap_items->find(pg);
+    if (j != pg_upmap_items->end()) {
       mempool::osdmap::vector<pair<int,int>> newmap;
       for (auto& p : j->second) {
 	auto osd_from = p.first;
 	auto osd_to = p.second;
         if (std::find(raw.begin(), raw.end(), osd_from) == raw.end()) {
           // cancel mapping if source osd does not exist anymore
-          ldout(cct, 20) << __func__ << " pg_upmap_items (source osd does not exist) " << pg_upmap_items << dendl;
+          ldout(cct, 20) << __func__ << " pg_upmap_items (source osd does not exist) " << *pg_upmap_items << dendl;
           continue;
         }
         if (osd_to != CRUSH_ITEM_NONE && osd_to < max_osd &&
             osd_to >= 0 && osd_weight[osd_to] == 0) {
           // cancel mapping if target osd is out
-          ldout(cct, 20) << __func__ << " pg_upmap_items (target osd is out) " << pg_upmap_items << dendl;
+          ldout(cct, 20) << __func__ << " pg_upmap_items (target osd is out) " << *pg_upmap_items << dendl;
           continue;
         }
         newmap.push_back(p);
@@ -2222,8 +2263,8 @@ void OSDMap::clean_pg_upmaps(
                      << dendl;
       pending_inc->new_pg_upmap.erase(i);
     }
-    auto j = pg_upmap.find(pg);
-    if (j != pg_upmap.end()) {
+    auto j = pg_upmap->find(pg);
+    if (j != pg_upmap->end()) {
       ldout(cct, 10) << __func__ << " cancel invalid pg_upmap entry "
                      << j->first << "->" << j->second
                      << dendl;
@@ -2237,8 +2278,8 @@ void OSDMap::clean_pg_upmaps(
                      << dendl;
       pending_inc->new_pg_upmap_items.erase(p);
     }
-    auto q = pg_upmap_items.find(pg);
-    if (q != pg_upmap_items.end()) {
+    auto q = pg_upmap_items->find(pg);
+    if (q != pg_upmap_items->end()) {
       ldout(cct, 10) << __func__ << " cancel invalid "
                      << "pg_upmap_items entry "
                      << q->first << "->" << q->second
@@ -2465,16 +2506,16 @@ int OSDMap::apply_incremental(const Incremental &inc)
   }
 
   for (auto& p : inc.new_pg_upmap) {
-    pg_upmap[p.first] = p.second;
+    (*pg_upmap)[p.first] = p.second;
   }
   for (auto& pg : inc.old_pg_upmap) {
-    pg_upmap.erase(pg);
+    pg_upmap->erase(pg);
   }
   for (auto& p : inc.new_pg_upmap_items) {
-    pg_upmap_items[p.first] = p.second;
+    (*pg_upmap_items)[p.first] = p.second;
   }
   for (auto& pg : inc.old_pg_upmap_items) {
-    pg_upmap_items.erase(pg);
+    pg_upmap_items->erase(pg);
   }
 
   for (auto& [pg, prim] : inc.new_pg_upmap_primary) {
@@ -2703,8 +2744,8 @@ int OSDMap::_pick_primary(const vector<int>& osds) const
 void OSDMap::_apply_upmap(const pg_pool_t& pi, pg_t raw_pg, vector<int> *raw) const
 {
   pg_t pg = pi.raw_pg_to_pg(raw_pg);
-  auto p = pg_upmap.find(pg);
-  if (p != pg_upmap.end()) {
+  auto p = pg_upmap->find(pg);
+  if (p != pg_upmap->end()) {
     // make sure targets aren't marked out
     for (auto osd : p->second) {
       if (osd != CRUSH_ITEM_NONE && osd < max_osd && osd >= 0 &&
@@ -2717,8 +2758,8 @@ void OSDMap::_apply_upmap(const pg_pool_t& pi, pg_t raw_pg, vector<int> *raw) co
     // continue to check and apply pg_upmap_items if any
   }
 
-  auto q = pg_upmap_items.find(pg);
-  if (q != pg_upmap_items.end()) {
+  auto q = pg_upmap_items->find(pg);
+  if (q != pg_upmap_items->end()) {
     // NOTE: this approach does not allow a bidirectional swap,
     // e.g., [[1,2],[2,1]] applied to [0,1,2] -> [0,2,1].
     for (auto& [osd_from, osd_to] : q->second) {
@@ -3266,11 +3307,11 @@ void OSDMap::encode(ceph::buffer::list& bl, uint64_t features) const
     encode(erasure_code_profiles, bl);
 
     if (v >= 4) {
-      encode(pg_upmap, bl);
-      encode(pg_upmap_items, bl);
+      encode(*pg_upmap, bl);
+      encode(*pg_upmap_items, bl);
     } else {
-      ceph_assert(pg_upmap.empty());
-      ceph_assert(pg_upmap_items.empty());
+      ceph_assert(pg_upmap->empty());
+      ceph_assert(pg_upmap_items->empty());
     }
     if (v >= 6) {
       encode(crush_version, bl);
@@ -3607,11 +3648,11 @@ void OSDMap::decode(ceph::buffer::list::const_iterator& bl)
     // version increased from 3 to 4 still in luminous, so same as above
     // applies.
     if (struct_v >= 4) {
-      decode(pg_upmap, bl);
-      decode(pg_upmap_items, bl);
+      decode(*pg_upmap, bl);
+      decode(*pg_upmap_items, bl);
     } else {
-      pg_upmap.clear();
-      pg_upmap_items.clear();
+      pg_upmap->clear();
+      pg_upmap_items->clear();
     }
     // again, version increased from 5 to 6 still in luminous, so above
     // applies.
@@ -3972,7 +4013,7 @@ void OSDMap::dump(Formatter *f, CephContext *cct) const
   f->close_section();
 
   f->open_array_section("pg_upmap");
-  for (auto& p : pg_upmap) {
+  for (auto& p : *pg_upmap) {
     f->open_object_section("mapping");
     f->dump_stream("pgid") << p.first;
     f->open_array_section("osds");
@@ -3985,7 +4026,7 @@ void OSDMap::dump(Formatter *f, CephContext *cct) const
   f->close_section();
 
   f->open_array_section("pg_upmap_items");
-  for (auto& [pgid, mappings] : pg_upmap_items) {
+  for (auto& [pgid, mappings] : *pg_upmap_items) {
     f->open_object_section("mapping");
     f->dump_stream("pgid") << pgid;
     f->open_array_section("mappings");
@@ -4304,10 +4345,10 @@ void OSDMap::print(CephContext *cct, ostream& out) const
   print_osds(out);
   out << std::endl;
 
-  for (auto& p : pg_upmap) {
+  for (auto& p : *pg_upmap) {
     out << "pg_upmap " << p.first << " " << p.second << "\n";
   }
-  for (auto& p : pg_upmap_items) {
+  for (auto& p : *pg_upmap_items) {
     out << "pg_upmap_items " << p.first << " " << p.second << "\n";
   }
 
@@ -5666,8 +5707,8 @@ int OSDMap::calc_pg_upmaps(
 
       // try upmap
       for (auto pg : pgs) {
-        auto temp_it = tmp_osd_map.pg_upmap.find(pg);
-        if (temp_it != tmp_osd_map.pg_upmap.end()) {
+        auto temp_it = tmp_osd_map.pg_upmap->find(pg);
+        if (temp_it != tmp_osd_map.pg_upmap->end()) {
           // leave pg_upmap alone
           // it must be specified by admin since balancer does not
           // support pg_upmap yet
@@ -5679,8 +5720,8 @@ int OSDMap::calc_pg_upmaps(
         auto pg_pool_size = tmp_osd_map.get_pg_pool_size(pg);
         mempool::osdmap::vector<pair<int32_t,int32_t>> new_upmap_items;
         set<int> existing;
-        auto it = tmp_osd_map.pg_upmap_items.find(pg);
-        if (it != tmp_osd_map.pg_upmap_items.end()) {
+        auto it = tmp_osd_map.pg_upmap_items->find(pg);
+        if (it != tmp_osd_map.pg_upmap_items->end()) {
 	  auto& um_items = it->second;
           if (um_items.size() >= (size_t)pg_pool_size) {
             ldout(cct, 10) << " " << pg << " already has full-size pg_upmap_items "
@@ -6055,8 +6096,8 @@ int OSDMap::pack_upmap_results(
   int num_changed = 0;
   for (auto& i : to_unmap) {
     ldout(cct, 10) << " unmap pg " << i << dendl;
-    ceph_assert(tmp_osd_map.pg_upmap_items.count(i));
-    tmp_osd_map.pg_upmap_items.erase(i);
+    ceph_assert(tmp_osd_map.pg_upmap_items->count(i));
+    tmp_osd_map.pg_upmap_items->erase(i);
     pending_inc->old_pg_upmap_items.insert(i);
     ++num_changed;
   }
@@ -6064,7 +6105,7 @@ int OSDMap::pack_upmap_results(
     ldout(cct, 10) << " upmap pg " << pg
                    << " new pg_upmap_items " << um_items
                    << dendl;
-    tmp_osd_map.pg_upmap_items[pg] = um_items;
+    (*tmp_osd_map.pg_upmap_items)[pg] = um_items;
     pending_inc->new_pg_upmap_items[pg] = um_items;
     ++num_changed;
   }
@@ -6113,8 +6154,8 @@ bool OSDMap::try_drop_remap_overfull(
   // if it found an item that can be dropped, false if not. 
   //
   for (auto pg : pgs) {
-    auto p = tmp_osd_map.pg_upmap_items.find(pg);
-    if (p == tmp_osd_map.pg_upmap_items.end())
+    auto p = tmp_osd_map.pg_upmap_items->find(pg);
+    if (p == tmp_osd_map.pg_upmap_items->end())
       continue;
     mempool::osdmap::vector<pair<int32_t,int32_t>> new_upmap_items;
     auto& pg_upmap_items = p->second;
@@ -6285,8 +6326,8 @@ OSDMap::candidates_t OSDMap::build_candidates(
   // build the candidates data structure
   //
   candidates_t candidates;
-  candidates.reserve(tmp_osd_map.pg_upmap_items.size());
-  for (auto& [pg, um_pair] : tmp_osd_map.pg_upmap_items) {
+  candidates.reserve(tmp_osd_map.pg_upmap_items->size());
+  for (auto& [pg, um_pair] : *tmp_osd_map.pg_upmap_items) {
     if (to_skip.count(pg))
       continue;
     if (!only_pools.empty() && !only_pools.count(pg.pool()))
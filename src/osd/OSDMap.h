@@ -442,6 +442,9 @@ public:
     int get_net_marked_out(const OSDMap *previous) const;
     int get_net_marked_down(const OSDMap *previous) const;
     int identify_osd(uuid_d u) const;
+    /// add the pgs whose mapping this incremental may change to *pgs;
+    /// false if it can change the mapping of any pg (e.g. crush, osd state)
+    bool get_pg_local_changes(std::set<pg_t> *pgs) const;
 
     void encode_client_old(ceph::buffer::list& bl) const;
     void encode_classic(ceph::buffer::list& bl, uint64_t features) const;
@@ -590,8 +593,8 @@ private:
   std::shared_ptr< mempool::osdmap::vector<__u32> > osd_primary_affinity; ///< 16.16 fixed point, 0x10000 = baseline
 
   // remap (post-CRUSH, pre-up)
-  mempool::osdmap::map<pg_t,mempool::osdmap::vector<int32_t>> pg_upmap; ///< remap pg
-  mempool::osdmap::map<pg_t,mempool::osdmap::vector<std::pair<int32_t,int32_t>>> pg_upmap_items; ///< remap osds in up set
+  std::shared_ptr< mempool::osdmap::map<pg_t,mempool::osdmap::vector<int32_t>> > pg_upmap; ///< remap pg
+  std::shared_ptr< mempool::osdmap::map<pg_t,mempool::osdmap::vector<std::pair<int32_t,int32_t>>> > pg_upmap_items; ///< remap osds in up set
   mempool::osdmap::map<pg_t, int32_t> pg_upmap_primaries; ///< remap primary of a pg
 
   mempool::osdmap::map<int64_t,pg_pool_t> pools;
@@ -684,6 +687,8 @@ private:
 	     osd_addrs(std::make_shared<addrs_s>()),
 	     pg_temp(std::make_shared<PGTempMap>()),
 	     primary_temp(std::make_shared<mempool::osdmap::map<pg_t,int32_t>>()),
+	     pg_upmap(std::make_shared<mempool::osdmap::map<pg_t,mempool::osdmap::vector<int32_t>>>()),
+	     pg_upmap_items(std::make_shared<mempool::osdmap::map<pg_t,mempool::osdmap::vector<std::pair<int32_t,int32_t>>>>()),
 	     osd_uuid(std::make_shared<mempool::osdmap::vector<uuid_d>>()),
 	     cluster_snapshot_epoch(0),
 	     new_blocklist_entries(false),
@@ -710,6 +715,13 @@ public:
     *this = o;
     primary_temp.reset(new mempool::osdmap::map<pg_t,int32_t>(*o.primary_temp));
     pg_temp.reset(new PGTempMap(*o.pg_temp));
+    pg_upmap.reset(
+      new mempool::osdmap::map<pg_t,mempool::osdmap::vector<int32_t>>(
+	*o.pg_upmap));
+    pg_upmap_items.reset(
+      new mempool::osdmap::map<pg_t,
+	mempool::osdmap::vector<std::pair<int32_t,int32_t>>>(
+	  *o.pg_upmap_items));
     osd_uuid.reset(new mempool::osdmap::vector<uuid_d>(*o.osd_uuid));
 
     if (o.osd_primary_affinity)
@@ -1721,8 +1733,8 @@ public:
   int get_osds_by_bucket_name(const std::string &name, std::set<int> *osds) const;
 
   bool have_pg_upmaps(pg_t pg) const {
-    return pg_upmap.count(pg) ||
-      pg_upmap_items.count(pg);
+    return pg_upmap->count(pg) ||
+      pg_upmap_items->count(pg);
   }
 
   bool check_full(const std::set<pg_shard_t> &missing_on) const {
@@ -280,7 +280,14 @@ private:
       : Job(osdmap), mapping(m) {
       mapping->_start(*osdmap);
     }
-    void process(const std::vector<pg_t>& pgs) override {}
+    void process(const std::vector<pg_t>& pgs) override {
+      for (auto& pg : pgs) {
+	auto p = mapping->pools.find(pg.pool());
+	if (p != mapping->pools.end() && pg.ps() < p->second.pg_num) {
+	  mapping->_update_range(*osdmap, pg.pool(), pg.ps(), pg.ps() + 1);
+	}
+      }
+    }
     void process(int64_t pool, unsigned ps_begin, unsigned ps_end) override {
       mapping->_update_range(*osdmap, pool, ps_begin, ps_end);
     }
@@ -342,6 +349,23 @@ public:
     return job;
   }
 
+  /// remap only the given pgs; the rest must already match the
+  /// map's previous epoch
+  std::unique_ptr<MappingJob> start_update(
+    const OSDMap& map,
+    ParallelPGMapper& mapper,
+    unsigned pgs_per_item,
+    const std::vector<pg_t>& pgs) {
+    std::unique_ptr<MappingJob> job(new MappingJob(&map, this));
+    if (pgs.empty()) {
+      job->finish = ceph_clock_now();
+      job->complete();
+    } else {
+      mapper.queue(job.get(), pgs_per_item, pgs);
+    }
+    return job;
+  }
+
   epoch_t get_epoch() const {
     return epoch;
   }
@@ -2,6 +2,7 @@
 
 #include "OpRequest.h"
 #include "common/Formatter.h"
+#include <bit>
 #include <iostream>
 #include <vector>
 #include "common/debug.h"
@@ -120,6 +121,7 @@ void OpRequest::mark_flag_point(uint8_t flag, const char *s) {
 #ifdef WITH_LTTNG
   uint8_t old_flags = hit_flag_points;
 #endif
+  mark_stage(std::countr_zero(flag));
   mark_event(s);
   last_event_detail = s;
   hit_flag_points |= flag;
@@ -133,6 +135,7 @@ void OpRequest::mark_flag_point_string(uint8_t flag, const string& s) {
 #ifdef WITH_LTTNG
   uint8_t old_flags = hit_flag_points;
 #endif
+  mark_stage(std::countr_zero(flag));
   mark_event(s);
   hit_flag_points |= flag;
   latest_flag_point = flag;
@@ -141,6 +144,12 @@ void OpRequest::mark_flag_point_string(uint8_t flag, const string& s) {
 	     flag, s.c_str(), old_flags, hit_flag_points);
 }
 
+std::vector<std::string> OpRequest::get_timeline_stage_names()
+{
+  return {"queued_for_pg", "reached_pg", "delayed", "started",
+	  "sub_op_sent", "commit_sent"};
+}
+
 bool OpRequest::filter_out(const set<string>& filters)
 {
   set<entity_addr_t> addrs;
@@ -94,6 +94,7 @@ public:
   epoch_t min_epoch = 0;      ///< min epoch needed to handle this msg
 
   bool hitset_inserted;
+  bool temperature_recorded = false; ///< counted in the PG's object_temperature
   jspan_ptr osd_parent_span;
 
   template<class T>
@@ -184,6 +185,9 @@ public:
 
   typedef boost::intrusive_ptr<OpRequest> Ref;
 
+  /// timeline stage names, indexed by flag point bit
+  static std::vector<std::string> get_timeline_stage_names();
+
 private:
   void mark_flag_point(uint8_t flag, const char *s);
   void mark_flag_point_string(uint8_t flag, const std::string& s);
@@ -222,6 +222,7 @@ public:
     uint64_t events, utime_t event_dur) override;
 
   void lock(bool no_lockdep = false) const;
+  bool try_lock() const;
   void unlock() const;
   bool is_locked() const;
 
@@ -873,20 +873,38 @@ void PGLog::_write_log_and_missing(
 		     << " write_from_dups=" << write_from_dups
 		     << " trimmed_dups.size()=" << trimmed_dups.size() << dendl;
   set<string> to_remove;
-  to_remove.swap(trimmed_dups);
-  for (auto& t : trimmed) {
-    string key = t.get_key_name();
-    if (log_keys_debug) {
-      auto it = log_keys_debug->find(key);
+  if (log_keys_debug) {
+    for (auto& t : trimmed) {
+      auto it = log_keys_debug->find(t.get_key_name());
       ceph_assert(it != log_keys_debug->end());
       log_keys_debug->erase(it);
     }
-    to_remove.emplace(std::move(key));
   }
-  trimmed.clear();
 
   if (touch_log)
     t.touch(coll, log_oid);
+
+  // Entries and dups are only ever trimmed off the tail, so each set covers
+  // a contiguous run of keys.  Drop a run with one range delete rather than
+  // a tombstone per key.
+  auto rm_trimmed = [&](const string& first, const string& last) {
+    string end = last;
+    end.push_back('\0');  // the smallest key after last
+    t.omap_rmkeyrange(coll, log_oid, first, end);
+  };
+  if (trimmed.size() > 1) {
+    rm_trimmed(trimmed.begin()->get_key_name(),
+	       trimmed.rbegin()->get_key_name());
+  } else if (!trimmed.empty()) {
+    to_remove.emplace(trimmed.begin()->get_key_name());
+  }
+  trimmed.clear();
+  if (trimmed_dups.size() > 1) {
+    rm_trimmed(*trimmed_dups.begin(), *trimmed_dups.rbegin());
+  } else {
+    to_remove.merge(trimmed_dups);
+  }
+  trimmed_dups.clear();
   if (dirty_to != eversion_t()) {
     t.omap_rmkeyrange(
       coll, log_oid,
@@ -14,11 +14,14 @@
 #ifndef PGTRANSACTION_H
 #define PGTRANSACTION_H
 
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 
 #include "common/hobject.h"
+#include "include/mempool.h"
 #ifndef WITH_SEASTAR
 #include "osd/osd_internal_types.h"
 #else
@@ -39,8 +42,14 @@
  *    transaction
  */
 class PGTransaction {
+  // The object maps below rarely hold more than a few entries.  Their
+  // nodes are carved out of this inline buffer and all released with the
+  // transaction; whatever does not fit is accounted to osd_pgtrans.
+  alignas(std::max_align_t) std::byte arena_buf[2048];
+  std::pmr::monotonic_buffer_resource arena{
+    arena_buf, sizeof(arena_buf), mempool::osd_pgtrans::memory_resource()};
 public:
-  std::map<hobject_t, ObjectContextRef> obc_map;
+  std::pmr::map<hobject_t, ObjectContextRef> obc_map{&arena};
 
   class ObjectOperation {
   public:
@@ -249,7 +258,7 @@ public:
 
     friend class PGTransaction;
   };
-  std::map<hobject_t, ObjectOperation> op_map;
+  std::pmr::map<hobject_t, ObjectOperation> op_map{&arena};
 private:
   ObjectOperation &get_object_op_for_modify(const hobject_t &hoid) {
     auto &op = op_map[hoid];
@@ -35,6 +35,13 @@ using std::vector;
 using ceph::Formatter;
 using ceph::make_message;
 
+static void record_state_latency(PerfCounters &perf, int idx, utime_t dur)
+{
+  perf.tinc(idx, dur);
+  perf.hinc(rs_state_latency_histogram, dur.to_nsec(),
+	    idx - rs_initial_latency);
+}
+
 BufferedRecoveryMessages::BufferedRecoveryMessages(PeeringCtx &ctx)
   // steal messages from ctx
   : message_map{std::move(ctx.message_map)}
@@ -4686,7 +4693,7 @@ void PeeringState::Initial::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_initial_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_initial_latency, dur);
 }
 
 /*------Started-------*/
@@ -4747,7 +4754,7 @@ void PeeringState::Started::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_started_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_started_latency, dur);
   ps->state_clear(PG_STATE_WAIT | PG_STATE_LAGGY);
 }
 
@@ -4843,7 +4850,7 @@ void PeeringState::Reset::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_reset_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_reset_latency, dur);
 }
 
 /*-------Start---------*/
@@ -4868,7 +4875,7 @@ void PeeringState::Start::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_start_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_start_latency, dur);
 }
 
 /*---------Primary--------*/
@@ -4965,7 +4972,7 @@ void PeeringState::Primary::exit()
   DECLARE_LOCALS;
   ps->want_acting.clear();
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_primary_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_primary_latency, dur);
   pl->clear_primary_state();
   ps->state_clear(PG_STATE_CREATING);
 }
@@ -5067,7 +5074,7 @@ void PeeringState::Peering::exit()
   pl->clear_probe_targets();
 
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_peering_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_peering_latency, dur);
 }
 
 
@@ -5191,7 +5198,7 @@ void PeeringState::Backfilling::exit()
   ps->state_clear(PG_STATE_BACKFILLING);
   ps->state_clear(PG_STATE_FORCED_BACKFILL | PG_STATE_FORCED_RECOVERY);
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_backfilling_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_backfilling_latency, dur);
 }
 
 /*--WaitRemoteBackfillReserved--*/
@@ -5244,7 +5251,7 @@ void PeeringState::WaitRemoteBackfillReserved::exit()
   DECLARE_LOCALS;
 
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_waitremotebackfillreserved_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_waitremotebackfillreserved_latency, dur);
 }
 
 void PeeringState::WaitRemoteBackfillReserved::retry()
@@ -5323,7 +5330,7 @@ void PeeringState::WaitLocalBackfillReserved::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_waitlocalbackfillreserved_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_waitlocalbackfillreserved_latency, dur);
 }
 
 /*----NotBackfilling------*/
@@ -5364,7 +5371,7 @@ void PeeringState::NotBackfilling::exit()
   DECLARE_LOCALS;
   ps->state_clear(PG_STATE_BACKFILL_UNFOUND);
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_notbackfilling_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_notbackfilling_latency, dur);
 }
 
 /*----NotRecovering------*/
@@ -5393,7 +5400,7 @@ void PeeringState::NotRecovering::exit()
   DECLARE_LOCALS;
   ps->state_clear(PG_STATE_RECOVERY_UNFOUND);
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_notrecovering_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_notrecovering_latency, dur);
 }
 
 /*---RepNotRecovering----*/
@@ -5418,7 +5425,7 @@ void PeeringState::RepNotRecovering::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_repnotrecovering_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_repnotrecovering_latency, dur);
 }
 
 /*---RepWaitRecoveryReserved--*/
@@ -5459,7 +5466,7 @@ void PeeringState::RepWaitRecoveryReserved::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_repwaitrecoveryreserved_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_repwaitrecoveryreserved_latency, dur);
 }
 
 /*-RepWaitBackfillReserved*/
@@ -5532,7 +5539,7 @@ void PeeringState::RepWaitBackfillReserved::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_repwaitbackfillreserved_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_repwaitbackfillreserved_latency, dur);
 }
 
 boost::statechart::result
@@ -5650,7 +5657,7 @@ void PeeringState::RepRecovering::exit()
 
   pl->cancel_remote_recovery_reservation();
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_reprecovering_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_reprecovering_latency, dur);
 }
 
 /*------Activating--------*/
@@ -5666,7 +5673,7 @@ void PeeringState::Activating::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_activating_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_activating_latency, dur);
 }
 
 PeeringState::WaitLocalRecoveryReserved::WaitLocalRecoveryReserved(my_context ctx)
@@ -5717,7 +5724,7 @@ void PeeringState::WaitLocalRecoveryReserved::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_waitlocalrecoveryreserved_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_waitlocalrecoveryreserved_latency, dur);
 }
 
 PeeringState::WaitRemoteRecoveryReserved::WaitRemoteRecoveryReserved(my_context ctx)
@@ -5757,7 +5764,7 @@ void PeeringState::WaitRemoteRecoveryReserved::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_waitremoterecoveryreserved_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_waitremoterecoveryreserved_latency, dur);
 }
 
 PeeringState::Recovering::Recovering(my_context ctx)
@@ -5871,7 +5878,7 @@ void PeeringState::Recovering::exit()
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
   ps->state_clear(PG_STATE_RECOVERING);
-  pl->get_peering_perf().tinc(rs_recovering_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_recovering_latency, dur);
 }
 
 PeeringState::Recovered::Recovered(my_context ctx)
@@ -5916,7 +5923,7 @@ void PeeringState::Recovered::exit()
   DECLARE_LOCALS;
 
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_recovered_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_recovered_latency, dur);
 }
 
 PeeringState::Clean::Clean(my_context ctx)
@@ -5945,7 +5952,7 @@ void PeeringState::Clean::exit()
   DECLARE_LOCALS;
   ps->state_clear(PG_STATE_CLEAN);
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_clean_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_clean_latency, dur);
 }
 
 template <typename T>
@@ -6426,7 +6433,7 @@ void PeeringState::Active::exit()
   ps->state_clear(PG_STATE_RECOVERY_WAIT);
   ps->state_clear(PG_STATE_RECOVERY_TOOFULL);
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_active_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_active_latency, dur);
   pl->on_active_exit();
 }
 
@@ -6582,7 +6589,7 @@ void PeeringState::ReplicaActive::exit()
 
   pl->cancel_remote_recovery_reservation();
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_replicaactive_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_replicaactive_latency, dur);
 
   ps->min_last_complete_ondisk = eversion_t();
 }
@@ -6693,7 +6700,7 @@ void PeeringState::Stray::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_stray_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_stray_latency, dur);
 }
 
 
@@ -6959,7 +6966,7 @@ void PeeringState::GetInfo::exit()
 
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_getinfo_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_getinfo_latency, dur);
   ps->blocked_by.clear();
 }
 
@@ -7100,7 +7107,7 @@ void PeeringState::GetLog::exit()
 
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_getlog_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_getlog_latency, dur);
   ps->blocked_by.clear();
 }
 
@@ -7168,7 +7175,7 @@ void PeeringState::WaitActingChange::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_waitactingchange_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_waitactingchange_latency, dur);
 }
 
 /*------Down--------*/
@@ -7196,7 +7203,7 @@ void PeeringState::Down::exit()
 
   ps->state_clear(PG_STATE_DOWN);
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_down_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_down_latency, dur);
 
   ps->blocked_by.clear();
 }
@@ -7310,7 +7317,7 @@ void PeeringState::Incomplete::exit()
 
   ps->state_clear(PG_STATE_INCOMPLETE);
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_incomplete_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_incomplete_latency, dur);
 
   ps->blocked_by.clear();
 }
@@ -7467,7 +7474,7 @@ void PeeringState::GetMissing::exit()
 
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_getmissing_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_getmissing_latency, dur);
   ps->blocked_by.clear();
 }
 
@@ -7519,7 +7526,7 @@ void PeeringState::WaitUpThru::exit()
   context< PeeringMachine >().log_exit(state_name, enter_time);
   DECLARE_LOCALS;
   utime_t dur = ceph_clock_now() - enter_time;
-  pl->get_peering_perf().tinc(rs_waitupthru_latency, dur);
+  record_state_latency(pl->get_peering_perf(), rs_waitupthru_latency, dur);
 }
 
 /*----PeeringState::PeeringMachine Methods-----*/
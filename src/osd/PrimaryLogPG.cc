@@ -2402,6 +2402,11 @@ void PrimaryLogPG::do_op(OpRequestRef& op)
     }
   }
 
+  if (object_temperature.enabled() && !op->temperature_recorded) {
+    object_temperature.insert(oid.get_hash());
+    op->temperature_recorded = true;
+  }
+
   if (agent_state) {
     if (agent_choose_mode(false, op))
       return;
@@ -3590,17 +3595,83 @@ ObjectContextRef PrimaryLogPG::get_prev_clone_obc(ObjectContextRef obc)
   return nullptr;
 }
 
+struct C_PutChunkRefs : public Context {
+  PrimaryLogPGRef pg;
+  hobject_t src;
+  hobject_t tgt;
+  uint32_t count;
+  ceph::real_time mtime;
+  C_PutChunkRefs(PrimaryLogPG *p, const hobject_t& src, const hobject_t& tgt,
+		 uint32_t count, ceph::real_time mtime)
+    : pg(p), src(src), tgt(tgt), count(count), mtime(mtime) {}
+  void finish(int r) override {
+    // -EOPNOTSUPP: the chunk's OSD does not know chunk_put_refs yet.
+    // -ENOLINK: the chunk holds fewer refs than count and the batched put
+    // dropped none of them.  Either way drop them one by one, so that
+    // whatever refs exist go away as they did before batching.
+    if (r != -EOPNOTSUPP && r != -ENOLINK) {
+      return;
+    }
+    std::scoped_lock locker{*pg};
+    pg->put_chunk_refs(src, tgt, count, mtime, false);
+  }
+};
+
+void PrimaryLogPG::put_chunk_refs(const hobject_t& src_soid,
+				  const hobject_t& tgt_soid,
+				  uint32_t count, ceph::real_time mtime,
+				  bool batch)
+{
+  unsigned flags = CEPH_OSD_FLAG_IGNORE_CACHE | CEPH_OSD_FLAG_IGNORE_OVERLAY |
+                   CEPH_OSD_FLAG_RWORDERED;
+  object_locator_t oloc(tgt_soid);
+  if (batch && count > 1) {
+    ObjectOperation obj_op;
+    bufferlist in;
+    cls_cas_chunk_put_ref_op call;
+    call.source = src_soid.get_head();
+    call.count = count;
+    ::encode(call, in);
+    obj_op.call("cas", "chunk_put_refs", in);
+    Context *c = new C_OnFinisher(
+      new C_PutChunkRefs(this, src_soid, tgt_soid, count, mtime),
+      osd->get_objecter_finisher(get_pg_shard()));
+    osd->objecter->mutate(tgt_soid.oid, oloc, obj_op, SnapContext(),
+			  mtime, flags, c);
+    return;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    ObjectOperation obj_op;
+    bufferlist in;
+    cls_cas_chunk_put_ref_op call;
+    call.source = src_soid.get_head();
+    ::encode(call, in);
+    obj_op.call("cas", "chunk_put_ref", in);
+    osd->objecter->mutate(tgt_soid.oid, oloc, obj_op, SnapContext(),
+			  mtime, flags, nullptr);
+  }
+}
+
 void PrimaryLogPG::dec_refcount(const hobject_t& soid, const object_ref_delta_t& refs)
 {
   for (auto p = refs.begin(); p != refs.end(); ++p) {
     int dec_ref_count = p->second;
     ceph_assert(dec_ref_count < 0);
-    while (dec_ref_count < 0) {
+    if (dec_ref_count == -1) {
       dout(10) << __func__ << ": decrement reference on offset oid: " << p->first << dendl;
-      refcount_manifest(soid, p->first, 
+      refcount_manifest(soid, p->first,
 			refcount_t::DECREMENT_REF, NULL, std::nullopt);
-      dec_ref_count++;
+      continue;
     }
+    // a chunk referenced several times (e.g. repeated content) loses all
+    // of them in one op rather than one round trip per reference
+    dout(10) << __func__ << ": decrement " << -dec_ref_count
+	     << " references on offset oid: " << p->first << dendl;
+    ObjectContextRef src_obc = get_object_context(soid, false, NULL);
+    ceph_assert(src_obc);
+    put_chunk_refs(soid, p->first, -dec_ref_count,
+		   ceph::real_clock::from_ceph_timespec(src_obc->obs.oi.mtime),
+		   true);
   }
 }
 
@@ -8911,12 +8982,14 @@ void PrimaryLogPG::do_osd_op_effects(OpContext *ctx, const ConnectionRef& conn)
 	p->notify_id,
 	ctx->obc->obs.oi.user_version,
 	osd));
+    // one clock read for the ping cutoff of every watcher
+    utime_t now = ceph_clock_now();
     for (map<pair<uint64_t, entity_name_t>, WatchRef>::iterator i =
 	   ctx->obc->watchers.begin();
 	 i != ctx->obc->watchers.end();
 	 ++i) {
       dout(10) << "starting notify on watch " << i->first << dendl;
-      i->second->start_notify(notif);
+      i->second->start_notify(notif, now);
     }
     notif->init();
   }
@@ -9137,7 +9210,11 @@ void PrimaryLogPG::finish_ctx(OpContext *ctx, int log_op_type, int result)
     dout(20) << __func__ << "  extra_reqids " << ctx->extra_reqids << " "
              << ctx->extra_reqid_return_codes << dendl;
     ctx->log.back().extra_reqids.swap(ctx->extra_reqids);
-    ctx->log.back().extra_reqid_return_codes.swap(ctx->extra_reqid_return_codes);
+    ctx->log.back().extra_reqid_return_codes.insert(
+      boost::container::ordered_unique_range,
+      ctx->extra_reqid_return_codes.begin(),
+      ctx->extra_reqid_return_codes.end());
+    ctx->extra_reqid_return_codes.clear();
   }
 
   // apply new object state.
@@ -13119,6 +13196,7 @@ void PrimaryLogPG::on_activate_complete()
 
   hit_set_setup();
   agent_setup();
+  object_temperature_setup();
 }
 
 void PrimaryLogPG::on_change(ObjectStore::Transaction &t)
@@ -13135,6 +13213,9 @@ void PrimaryLogPG::on_change(ObjectStore::Transaction &t)
     osd->clear_queued_recovery(this);
   }
 
+  // new interval; rebuilt on activation if we are (still) primary
+  object_temperature.init(0, 0, 0);
+
   // requeue everything in the reverse order they should be
   // reexamined.
   requeue_ops(waiting_for_peered);
@@ -14518,6 +14599,19 @@ void PrimaryLogPG::hit_set_clear()
   hit_set_start_stamp = utime_t();
 }
 
+void PrimaryLogPG::object_temperature_setup()
+{
+  auto width = cct->_conf.get_val<uint64_t>("osd_object_temperature_width");
+  if (!is_primary() || width == 0) {
+    object_temperature.init(0, 0, 0);
+    return;
+  }
+  object_temperature.init(
+    cct->_conf.get_val<uint64_t>("osd_object_temperature_depth"),
+    width,
+    cct->_conf.get_val<uint64_t>("osd_object_temperature_decay_ops"));
+}
+
 void PrimaryLogPG::hit_set_setup()
 {
   if (!is_active() ||
@@ -15843,6 +15937,7 @@ boost::statechart::result PrimaryLogPG::AwaitAsyncWork::react(const DoSnapWork&)
       [pg, object, &in_flight]() {
 	ceph_assert(in_flight.find(object) != in_flight.end());
 	in_flight.erase(object);
+	pg->osd->logger->inc(l_osd_snap_trim_objects);
 	if (in_flight.empty()) {
 	  if (pg->state_test(PG_STATE_SNAPTRIM_ERROR)) {
 	    pg->snap_trimmer_machine.process_event(Reset());
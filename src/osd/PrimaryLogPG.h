@@ -27,6 +27,7 @@
 #include "messages/MOSDOpReply.h"
 #include "common/admin_finisher.h"
 #include "common/Checksummer.h"
+#include "common/count_min_sketch.h"
 #include "common/intrusive_timer.h"
 #include "common/sharedptr_registry.hpp"
 #include "common/shared_cache.hpp"
@@ -481,6 +482,11 @@ public:
   void inc_osd_stat_repaired() override {
     osd->inc_osd_stat_repaired();
   }
+  int get_shard_read_cost(pg_shard_t shard) override {
+    if (shard == pg_whoami)
+      return 0;
+    return osd->get_hb_back_pingtime(shard.osd);
+  }
   bool pg_is_remote_backfilling() override {
     return is_remote_backfilling();
   }
@@ -996,6 +1002,9 @@ protected:
   // hot/cold tracking
   HitSetRef hit_set;        ///< currently accumulating HitSet
   utime_t hit_set_start_stamp;    ///< time the current HitSet started recording
+  /// decaying access frequency per object, independent of cache tiering
+  decaying_count_min_sketch object_temperature;
+  void object_temperature_setup();
 
 
   void hit_set_clear();     ///< discard any HitSet state
@@ -1007,6 +1016,12 @@ protected:
   void hit_set_in_memory_trim(uint32_t max_in_memory); ///< discard old in memory HitSets
   void hit_set_remove_all();
 
+ public:
+  /// approximate recent access count of @p oid on this primary
+  uint32_t get_object_temperature(const hobject_t& oid) const {
+    return object_temperature.estimate(oid.get_hash());
+  }
+ protected:
   hobject_t get_hit_set_current_object(utime_t stamp);
   hobject_t get_hit_set_archive_object(utime_t start,
 				       utime_t end,
@@ -1496,6 +1511,8 @@ protected:
   void cancel_manifest_ops(bool requeue, std::vector<ceph_tid_t> *tids);
   ceph_tid_t refcount_manifest(hobject_t src_soid, hobject_t tgt_soid, refcount_t type,
 			      Context *cb, std::optional<bufferlist> chunk);
+  void put_chunk_refs(const hobject_t& src_soid, const hobject_t& tgt_soid,
+		      uint32_t count, ceph::real_time mtime, bool batch);
   void dec_all_refcount_manifest(const object_info_t& oi, OpContext* ctx);
   void dec_refcount(const hobject_t& soid, const object_ref_delta_t& refs);
   void update_chunk_map_by_dirty(OpContext* ctx);
@@ -1520,6 +1537,7 @@ protected:
   friend struct RefCountCallback;
   friend struct C_SetDedupChunks;
   friend struct C_SetManifestRefCountDone;
+  friend struct C_PutChunkRefs;
   friend struct SetManifestFinisher;
 
 public:
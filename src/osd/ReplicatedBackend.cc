@@ -2072,7 +2072,8 @@ void ReplicatedBackend::send_pushes(int prio, map<pg_shard_t, vector<PushOp> > &
 		 << " to osd." << i->first << dendl;
 	cost += j->cost(cct);
 	pushes += 1;
-	msg->pushes.push_back(*j);
+	// the caller's pushes are done with; don't copy omap and attrs
+	msg->pushes.push_back(std::move(*j));
       }
       msg->set_cost(cost);
       get_parent()->send_message_osd_cluster(msg, con);
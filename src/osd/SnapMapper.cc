@@ -618,28 +618,42 @@ vector<hobject_t> SnapMapper::get_objects_by_prefixes(
 {
   vector<hobject_t> out;
 
+  // the key that ended the previous prefix, if it is the first key of the
+  // current one (prefixes are disjoint and iterated in key order)
+  std::optional<pair<string, ceph::buffer::list>> carried;
+
   /// maintain the prefix_itr between calls to avoid searching depleted prefixes
   for ( ; prefix_itr != prefixes.end(); prefix_itr++) {
     const string prefix(get_prefix(pool, snap) + *prefix_itr);
     string pos = prefix;
     while (out.size() < max) {
       pair<string, ceph::buffer::list> next;
-      // access RocksDB (an expensive operation!)
-      int r = backend.get_next(pos, &next);
-      dout(20) << *this << __func__ << " get_next(" << pos << ") returns " << r
-	       << " " << next.first << dendl;
-      if (r != 0) {
-	return out; // Done
+      if (carried) {
+	next = std::move(*carried);
+	carried.reset();
+      } else {
+	// access RocksDB (an expensive operation!)
+	int r = backend.get_next(pos, &next);
+	dout(20) << *this << __func__ << " get_next(" << pos << ") returns " << r
+		 << " " << next.first << dendl;
+	if (r != 0) {
+	  return out; // Done
+	}
       }
 
       ceph_assert(is_mapping(next.first));
 
       if (auto next_prefix = next.first.substr(0, prefix.size());
           next_prefix != prefix) {
-	// TBD: we access the DB twice for the first object of each iterator...
 	dout(20) << fmt::format("{}: breaking, prefix expected {} got {}",
 	                        __func__, prefix, next_prefix)
 	         << dendl;
+	// no need to look it up again if the next prefix starts with it
+	if (auto n = std::next(prefix_itr);
+	    n != prefixes.end() &&
+	    next.first.starts_with(get_prefix(pool, snap) + *n)) {
+	  carried = std::move(next);
+	}
 	break; // Done with this prefix
       }
 
@@ -157,7 +157,7 @@ void Notify::start_watcher(WatchRef watch)
 {
   std::lock_guard l(lock);
   dout(10) << "start_watcher" << dendl;
-  watchers.insert(watch);
+  watchers.insert(std::move(watch));
 }
 
 void Notify::complete_watcher(WatchRef watch, bufferlist& reply_bl)
@@ -166,8 +166,8 @@ void Notify::complete_watcher(WatchRef watch, bufferlist& reply_bl)
   dout(10) << "complete_watcher" << dendl;
   if (is_discarded())
     return;
-  ceph_assert(watchers.count(watch));
-  watchers.erase(watch);
+  [[maybe_unused]] auto erased = watchers.erase(watch);
+  ceph_assert(erased == 1);
   notify_replies.insert(make_pair(make_pair(watch->get_watcher_gid(),
 					    watch->get_cookie()),
 				  reply_bl));
@@ -180,8 +180,8 @@ void Notify::complete_watcher_remove(WatchRef watch)
   dout(10) << __func__ << dendl;
   if (is_discarded())
     return;
-  ceph_assert(watchers.count(watch));
-  watchers.erase(watch);
+  [[maybe_unused]] auto erased = watchers.erase(watch);
+  ceph_assert(erased == 1);
   maybe_complete_notify();
 }
 
@@ -463,12 +463,12 @@ void Watch::remove(bool send_disconnect)
   discard_state();
 }
 
-void Watch::start_notify(NotifyRef notif)
+void Watch::start_notify(NotifyRef notif, utime_t now)
 {
   ceph_assert(in_progress_notifies.find(notif->notify_id) ==
 	 in_progress_notifies.end());
   if (will_ping) {
-    utime_t cutoff = ceph_clock_now();
+    utime_t cutoff = now;
     cutoff.sec_ref() -= timeout;
     if (last_ping < cutoff) {
       dout(10) << __func__ << " " << notif->notify_id
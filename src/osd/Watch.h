@@ -245,7 +245,8 @@ public:
 
   /// Adds notif as in-progress notify
   void start_notify(
-    NotifyRef notif ///< [in] Reference to new in-progress notify
+    NotifyRef notif, ///< [in] Reference to new in-progress notify
+    utime_t now      ///< [in] current time, shared by all watchers notified
     );
 
   /// Removes timed out notify
@@ -132,6 +132,12 @@ PerfCounters *build_osd_logger(CephContext *cct) {
 
   osd_plb.add_time_avg(l_osd_op_before_dequeue_op_lat, "op_before_dequeue_op_lat",
     "Latency of IO before calling dequeue_op(already dequeued and get PG lock)"); // client io before dequeue_op latency
+  osd_plb.add_u64_counter(
+    l_osd_op_inline, "op_inline",
+    "Client operations run on the messenger thread without a queue hand-off");
+  osd_plb.add_u64_counter(
+    l_osd_op_pg_batched, "op_pg_batched",
+    "Queued items run back to back by the thread already holding the PG lock");
 
 
   osd_plb.add_u64_counter(
@@ -358,6 +364,25 @@ PerfCounters *build_osd_logger(CephContext *cct) {
   "Number of watches that timed out or were blocklisted",
   NULL, PerfCountersBuilder::PRIO_USEFUL);
 
+  osd_plb.add_u64_counter(
+    l_osd_snap_trim_objects, "snap_trim_objects",
+    "Clones trimmed by the snap trimmer",
+    NULL, PerfCountersBuilder::PRIO_USEFUL);
+
+  osd_plb.add_u64_counter(
+    l_osd_ec_read_overread_bytes, "ec_read_overread_bytes",
+    "Shard bytes fetched for EC client reads beyond the bytes requested",
+    NULL, PerfCountersBuilder::PRIO_USEFUL, unit_t(UNIT_BYTES));
+
+  // bumped by every op shard thread for every client op
+  osd_plb.mark_hot(l_osd_op);
+  osd_plb.mark_hot(l_osd_op_inb);
+  osd_plb.mark_hot(l_osd_op_outb);
+  osd_plb.mark_hot(l_osd_op_lat);
+  osd_plb.mark_hot(l_osd_op_process_lat);
+  osd_plb.mark_hot(l_osd_op_r);
+  osd_plb.mark_hot(l_osd_op_w);
+
   return osd_plb.create_perf_counters();
 }
 
@@ -397,6 +422,27 @@ PerfCounters *build_recoverystate_perf(CephContext *cct) {
   rs_perf.add_time_avg(rs_waitupthru_latency, "waitupthru_latency", "Waitupthru recovery state latency");
   rs_perf.add_time_avg(rs_notrecovering_latency, "notrecovering_latency", "Notrecovering recovery state latency");
 
+  // Time spent per state exit, one row per *_latency state above; the
+  // row index is the state's offset from rs_initial_latency
+  PerfHistogramCommon::axis_config_d rs_hist_x_axis_config{
+    "Latency (usec)",
+    PerfHistogramCommon::SCALE_LOG2, ///< Latency in logarithmic scale
+    0,                               ///< Start at 0
+    1000000,                         ///< Quantization unit is 1ms
+    24,                              ///< Enough to cover hours
+  };
+  PerfHistogramCommon::axis_config_d rs_hist_y_axis_config{
+    "Recovery state",
+    PerfHistogramCommon::SCALE_LINEAR,
+    0,                               ///< Start at 0
+    1,                               ///< One bucket per state
+    rs_notrecovering_latency - rs_initial_latency + 2,
+  };
+  rs_perf.add_u64_counter_histogram(
+    rs_state_latency_histogram, "state_latency_histogram",
+    rs_hist_x_axis_config, rs_hist_y_axis_config,
+    "Histogram of recovery state latency by state");
+
   return rs_perf.create_perf_counters();
 }
 
@@ -42,6 +42,8 @@ enum {
 
   l_osd_op_before_queue_op_lat,
   l_osd_op_before_dequeue_op_lat,
+  l_osd_op_inline,
+  l_osd_op_pg_batched,
 
   l_osd_replica_read,
   l_osd_replica_read_redirect_missing,
@@ -143,6 +145,10 @@ enum {
 
   l_osd_watch_timeouts,
 
+  l_osd_snap_trim_objects,
+
+  l_osd_ec_read_overread_bytes,
+
   l_osd_last,
 };
 
@@ -182,6 +188,7 @@ enum {
   rs_getmissing_latency,
   rs_waitupthru_latency,
   rs_notrecovering_latency,
+  rs_state_latency_histogram,
   rs_last,
 };
 
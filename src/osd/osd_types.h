@@ -1122,6 +1122,17 @@ public:
      * completion if there are no other in progress writes.
      */
     PCT_UPDATE_DELAY,
+    /**
+     * QOS_RESERVATION, QOS_WEIGHT, QOS_LIMIT
+     *
+     * mClock reservation and limit (IOPS) and weight shared by all client
+     * ops to the pool, across the whole cluster.  Each OSD enforces the
+     * fraction matching the pool's PGs it is primary for.  0 or unset
+     * leaves the pool's ops in the shared client class.
+     */
+    QOS_RESERVATION,
+    QOS_WEIGHT,
+    QOS_LIMIT,
   };
 
   enum type_t {
@@ -4395,16 +4406,17 @@ struct pg_log_entry_t {
   osd_reqid_t reqid;  // caller+tid to uniquely identify request
   mempool::osd_pglog::vector<std::pair<osd_reqid_t, version_t> > extra_reqids;
 
-  /// map extra_reqids by index to error return code (if any)
-  mempool::osd_pglog::map<uint32_t, int> extra_reqid_return_codes;
+  /// map extra_reqids by index to error return code (if any); almost
+  /// always empty, so kept flat to save per-entry footprint
+  mempool::osd_pglog::flat_map<uint32_t, int> extra_reqid_return_codes;
 
   eversion_t version, prior_version, reverting_to;
   version_t user_version; // the user version for this entry
   utime_t     mtime;  // this is the _user_ mtime, mind you
-  int32_t return_code; // only stored for ERRORs for dup detection
 
   std::vector<pg_log_op_return_item_t> op_returns;
 
+  int32_t return_code; // only stored for ERRORs for dup detection
   __s32      op;
   bool invalid_hash; // only when decoding sobject_t based entries
   bool invalid_pool; // only when decoding pool-less hobject based entries
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <map>
 #include <ostream>
 #include <variant>
 
@@ -65,6 +66,15 @@ public:
     return 0.0;
   }
 
+  // Per-pool client QoS, in IOPS, for the PGs served by this scheduler.
+  // Pools not in the map go back to sharing the client class.
+  struct pool_qos_t {
+    double reservation = 0;
+    uint64_t weight = 1;
+    double limit = 0;
+  };
+  virtual void update_pool_qos(const std::map<int64_t, pool_qos_t> &qos) {}
+
   // Destructor
   virtual ~OpScheduler() {};
 };
@@ -13,11 +13,14 @@
  */
 
 
+#include <algorithm>
 #include <memory>
 #include <functional>
 
 #include "osd/scheduler/mClockScheduler.h"
 #include "common/dout.h"
+#include "common/strtol.h"
+#include "include/str_list.h"
 
 namespace dmc = crimson::dmclock;
 using namespace std::placeholders;
@@ -248,6 +251,32 @@ const dmc::ClientInfo *mClockScheduler::ClientRegistry::get_info(
   }
 }
 
+void mClockScheduler::ClientRegistry::update_pool_qos(
+  const std::map<int64_t, pool_qos_t> &qos,
+  double cost_per_io)
+{
+  qos_pools.clear();
+  for (auto &[pool, q] : qos) {
+    qos_pools.insert(pool);
+    double res = q.reservation * cost_per_io;
+    double lim = q.limit * cost_per_io;
+    auto info = external_client_infos.try_emplace(
+      client_profile_id_t(0, pool + 1),
+      default_min, 1, default_max).first;
+    info->second.update(
+      res ? res : default_min,
+      q.weight ? q.weight : 1,
+      lim ? lim : default_max);
+  }
+}
+
+void mClockScheduler::update_pool_qos(
+  const std::map<int64_t, pool_qos_t> &qos)
+{
+  dout(10) << __func__ << " " << qos.size() << " pools" << dendl;
+  client_registry.update_pool_qos(qos, osd_bandwidth_cost_per_io);
+}
+
 void mClockScheduler::set_osd_capacity_params_from_config()
 {
   uint64_t osd_bandwidth_capacity;
@@ -275,6 +304,22 @@ void mClockScheduler::set_osd_capacity_params_from_config()
   osd_bandwidth_capacity_per_shard = static_cast<double>(osd_bandwidth_capacity)
     / static_cast<double>(num_shards);
 
+  cost_curve.clear();
+  auto curve = cct->_conf.get_val<std::string>("osd_mclock_cost_curve");
+  if (!curve.empty()) {
+    if (parse_cost_curve(curve, &cost_curve)) {
+      for (auto &[bsize, iops] : cost_curve) {
+        iops = static_cast<double>(osd_bandwidth_capacity) / iops;
+      }
+      dout(1) << __func__ << ": using osd_mclock_cost_curve with "
+              << cost_curve.size() << " points" << dendl;
+    } else {
+      derr << __func__ << ": ignoring invalid osd_mclock_cost_curve '"
+           << curve << "'" << dendl;
+      cost_curve.clear();
+    }
+  }
+
   dout(1) << __func__ << ": osd_bandwidth_cost_per_io: "
           << std::fixed << std::setprecision(2)
           << osd_bandwidth_cost_per_io << " bytes/io"
@@ -431,11 +476,62 @@ uint32_t mClockScheduler::calc_scaled_cost(int item_cost)
     std::max<int>(
       1, // ensure cost is non-zero and positive
       item_cost));
+  if (!cost_curve.empty()) {
+    double scaled;
+    auto next = std::lower_bound(
+      cost_curve.begin(), cost_curve.end(), cost,
+      [](const auto &point, uint64_t size) { return point.first < size; });
+    if (next == cost_curve.begin()) {
+      scaled = next->second;
+    } else if (next == cost_curve.end()) {
+      // past the last point ops are bandwidth bound
+      auto &last = cost_curve.back();
+      scaled = last.second * cost / last.first;
+    } else {
+      auto prev = std::prev(next);
+      scaled = prev->second + (next->second - prev->second) *
+        (cost - prev->first) / (next->first - prev->first);
+    }
+    return static_cast<uint32_t>(std::clamp<double>(
+      scaled, 1, std::numeric_limits<uint32_t>::max()));
+  }
   auto cost_per_io = static_cast<uint32_t>(osd_bandwidth_cost_per_io);
 
   return std::max<uint32_t>(cost, cost_per_io);
 }
 
+bool mClockScheduler::parse_cost_curve(
+  const std::string &s,
+  std::vector<std::pair<uint64_t, double>> *points)
+{
+  points->clear();
+  std::vector<std::string> entries;
+  get_str_vec(s, ",", entries);
+  for (auto &entry : entries) {
+    auto colon = entry.find(':');
+    if (colon == std::string::npos) {
+      return false;
+    }
+    std::string err;
+    auto bsize = strict_iecstrtoll(entry.substr(0, colon), &err);
+    if (!err.empty() || bsize == 0) {
+      return false;
+    }
+    auto iops = strict_strtod(entry.substr(colon + 1), &err);
+    if (!err.empty() || iops <= 0) {
+      return false;
+    }
+    points->emplace_back(bsize, iops);
+  }
+  std::sort(points->begin(), points->end());
+  for (size_t i = 1; i < points->size(); ++i) {
+    if ((*points)[i].first == (*points)[i - 1].first) {
+      return false;
+    }
+  }
+  return !points->empty();
+}
+
 void mClockScheduler::update_configuration()
 {
   // Apply configuration change. The expectation is that
@@ -607,6 +703,7 @@ std::vector<std::string> mClockScheduler::get_tracked_keys() const noexcept
     "osd_mclock_max_capacity_iops_ssd"s,
     "osd_mclock_max_sequential_bandwidth_hdd"s,
     "osd_mclock_max_sequential_bandwidth_ssd"s,
+    "osd_mclock_cost_curve"s,
     "osd_mclock_profile"s
   };
 }
@@ -622,7 +719,8 @@ void mClockScheduler::handle_conf_change(
       conf, osd_bandwidth_capacity_per_shard);
   }
   if (changed.count("osd_mclock_max_sequential_bandwidth_hdd") ||
-      changed.count("osd_mclock_max_sequential_bandwidth_ssd")) {
+      changed.count("osd_mclock_max_sequential_bandwidth_ssd") ||
+      changed.count("osd_mclock_cost_curve")) {
     set_osd_capacity_params_from_config();
     client_registry.update_from_config(
       conf, osd_bandwidth_capacity_per_shard);
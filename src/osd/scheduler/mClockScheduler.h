@@ -18,6 +18,7 @@
 #include <functional>
 #include <ostream>
 #include <map>
+#include <set>
 #include <vector>
 
 #include "boost/variant.hpp"
@@ -53,10 +54,11 @@ constexpr double default_max = std::numeric_limits<double>::is_iec559 ?
  * client_id - global id (client.####) for client QoS
  * profile_id - id generated by client's QoS profile
  *
- * Currently (Reef and below), both members are set to
- * 0 which ensures that all external clients share the
- * mClock profile allocated reservation and limit
- * bandwidth.
+ * By default both members are set to 0 which ensures that
+ * all external clients share the mClock profile allocated
+ * reservation and limit bandwidth.  Ops to a pool with
+ * a QoS pool option set use profile_id = pool + 1 instead
+ * (see ClientRegistry::get_client_profile).
  *
  * Note: Post Reef, both members will be set to non-zero
  * values when the distributed feature of the mClock
@@ -153,6 +155,17 @@ class mClockScheduler : public OpScheduler, md_config_obs_t {
    */
   double osd_bandwidth_capacity_per_shard;
 
+  /**
+   * cost_curve
+   *
+   * (block size, cost) points parsed from osd_mclock_cost_curve, sorted
+   * by block size.  The cost of a block size is the OSD bandwidth times
+   * the time the device takes for one op of that size, so the linear
+   * model is the special case of a single point at 4KiB.  Empty if the
+   * option is not set.
+   */
+  std::vector<std::pair<uint64_t, double>> cost_curve;
+
   class ClientRegistry {
     std::array<
       crimson::dmclock::ClientInfo,
@@ -168,6 +181,8 @@ class mClockScheduler : public OpScheduler, md_config_obs_t {
 	     crimson::dmclock::ClientInfo> external_client_infos;
     const crimson::dmclock::ClientInfo *get_external_client(
       const client_profile_id_t &client) const;
+    /// pools whose client ops are scheduled apart from the client class
+    std::set<int64_t> qos_pools;
   public:
     /**
      * update_from_config
@@ -181,6 +196,24 @@ class mClockScheduler : public OpScheduler, md_config_obs_t {
       double capacity_per_shard);
     const crimson::dmclock::ClientInfo *get_info(
       const scheduler_id_t &id) const;
+
+    /**
+     * update_pool_qos
+     *
+     * Sets the mclock parameters of every pool in **qos**, converting
+     * reservation and limit from IOPS to bytes/second.  Entries are
+     * never erased since the queue holds pointers to them; pools no
+     * longer in **qos** simply stop being looked up.
+     */
+    void update_pool_qos(
+      const std::map<int64_t, pool_qos_t> &qos,
+      double cost_per_io);
+    client_profile_id_t get_client_profile(int64_t pool) const {
+      if (qos_pools.count(pool)) {
+	return client_profile_id_t(0, pool + 1);
+      }
+      return client_profile_id_t();
+    }
   } client_registry;
 
   using mclock_queue_t = crimson::dmclock::PullPriorityQueue<
@@ -203,10 +236,15 @@ class mClockScheduler : public OpScheduler, md_config_obs_t {
   SubQueue high_priority;
   priority_t immediate_class_priority = std::numeric_limits<priority_t>::max();
 
-  static scheduler_id_t get_scheduler_id(const OpSchedulerItem &item) {
+  scheduler_id_t get_scheduler_id(const OpSchedulerItem &item) const {
+    auto class_id = item.get_scheduler_class();
+    if (class_id != op_scheduler_class::client) {
+      return scheduler_id_t{class_id, client_profile_id_t()};
+    }
     return scheduler_id_t{
-      item.get_scheduler_class(),
-      client_profile_id_t()
+      class_id,
+      client_registry.get_client_profile(
+	item.get_ordering_token().pgid.pool())
     };
   }
 
@@ -236,6 +274,11 @@ public:
   /// Calculate scaled cost per item
   uint32_t calc_scaled_cost(int cost);
 
+  /// Parse <block size>:<iops>[,...] into sorted points, false if invalid
+  static bool parse_cost_curve(
+    const std::string &s,
+    std::vector<std::pair<uint64_t, double>> *points);
+
   // Helper method to display mclock queues
   std::string display_queues() const;
 
@@ -276,6 +319,8 @@ public:
   double get_cost_per_io() const {
     return osd_bandwidth_cost_per_io;
   }
+
+  void update_pool_qos(const std::map<int64_t, pool_qos_t> &qos) final;
 private:
   // Enqueue the op to the high priority queue
   void enqueue_high(unsigned prio, OpSchedulerItem &&item, bool front = false);
@@ -3,6 +3,8 @@
 
 #include "./osd_scrub.h"
 
+#include <fstream>
+
 #include "osd/OSD.h"
 #include "osd/osd_perf_counters.h"
 #include "osdc/Objecter.h"
@@ -172,7 +174,8 @@ bool OsdScrub::is_sched_target_eligible(
   if (r.restricted_time && ScrubJob::observes_allowed_hours(e.urgency)) {
     return false;
   }
-  if (r.cpu_overloaded && ScrubJob::observes_load_limit(e.urgency)) {
+  if ((r.cpu_overloaded || r.device_busy) &&
+      ScrubJob::observes_load_limit(e.urgency)) {
     return false;
   }
   if (r.recovery_in_progress && ScrubJob::observes_recovery(e.urgency)) {
@@ -219,6 +222,8 @@ Scrub::OSDRestrictions OsdScrub::restrictions_on_scrubbing(
     env_conditions.restricted_time = !scrub_time_permit(scrub_clock_now);
     env_conditions.cpu_overloaded =
 	!m_load_tracker.scrub_load_below_threshold();
+    env_conditions.device_busy =
+	!m_load_tracker.device_util_below_threshold();
   }
 
   return env_conditions;
@@ -301,6 +306,8 @@ std::optional<double> OsdScrub::LoadTracker::update_load_average()
     n_samples = std::max(n_samples / hb_interval, 1L);
   }
 
+  update_device_util();
+
   double loadavg;
   if (getloadavg(&loadavg, 1) == 1) {
     daily_loadavg = (daily_loadavg * (n_samples - 1) + loadavg) / n_samples;
@@ -355,6 +362,75 @@ std::ostream& OsdScrub::LoadTracker::gen_prefix(
   return out << log_prefix << fn << ": ";
 }
 
+void OsdScrub::LoadTracker::set_devices(const std::set<std::string>& devs)
+{
+  std::lock_guard l{dev_lock};
+  io_ticks.clear();
+  for (const auto& d : devs) {
+    io_ticks[d] = 0;
+  }
+  last_sample = ceph::mono_clock::zero();
+  device_util = 0.0;
+}
+
+void OsdScrub::LoadTracker::update_device_util()
+{
+  std::lock_guard l{dev_lock};
+  if (io_ticks.empty()) {
+    return;
+  }
+  const auto now = ceph::mono_clock::now();
+  const double elapsed_ms =
+      std::chrono::duration<double, std::milli>(now - last_sample).count();
+  const bool first = (last_sample == ceph::mono_clock::zero());
+  double max_util = 0.0;
+  for (auto& [dev, ticks] : io_ticks) {
+    // the 10th field of the block device stat file is the number of
+    // milliseconds the device had I/O in flight
+    std::ifstream f("/sys/block/" + dev + "/stat");
+    uint64_t fields[10];
+    for (auto& v : fields) {
+      f >> v;
+    }
+    if (!f) {
+      continue;
+    }
+    uint64_t busy = fields[9];
+    if (!first && elapsed_ms > 0 && busy >= ticks) {
+      max_util = std::max(max_util, (busy - ticks) / elapsed_ms);
+    }
+    ticks = busy;
+  }
+  last_sample = now;
+  if (!first) {
+    device_util = std::min(max_util, 1.0);
+  }
+  dout(20) << fmt::format("device util {:.3f}", device_util) << dendl;
+}
+
+bool OsdScrub::LoadTracker::device_util_below_threshold() const
+{
+  const double threshold = conf.get_val<double>(
+      "osd_scrub_device_util_threshold");
+  if (threshold <= 0) {
+    return true;
+  }
+  std::lock_guard l{dev_lock};
+  if (device_util < threshold) {
+    return true;
+  }
+  dout(10) << fmt::format(
+		  "device util {:.3f} >= max {:.3f} = no", device_util,
+		  threshold)
+	   << dendl;
+  return false;
+}
+
+void OsdScrub::set_scrub_devices(const std::set<std::string>& devs)
+{
+  m_load_tracker.set_devices(devs);
+}
+
 std::optional<double> OsdScrub::update_load_average()
 {
   return m_load_tracker.update_load_average();
@@ -2,6 +2,9 @@
 // vim: ts=8 sw=2 smarttab
 
 #pragma once
+#include <map>
+#include <set>
+#include <string>
 #include <string_view>
 
 #include "osd/osd_types_fmt.h"
@@ -128,6 +131,12 @@ class OsdScrub {
    */
   std::optional<double> update_load_average();
 
+  /**
+   * the block devices (names under /sys/block) backing the object store,
+   * whose utilization is checked against osd_scrub_device_util_threshold
+   */
+  void set_scrub_devices(const std::set<std::string>& devs);
+
    // the scrub performance counters collections
    // ---------------------------------------------------------------
   PerfCounters* get_perf_counters(int pool_type, scrub_level_t level);
@@ -203,6 +212,18 @@ class OsdScrub {
     const std::string log_prefix;
     double daily_loadavg{0.0};
 
+    /// protects the device utilization data below: updated by the
+    /// heartbeat, read when scheduling scrubs
+    mutable ceph::mutex dev_lock =
+	ceph::make_mutex("OsdScrub::LoadTracker::dev_lock");
+    /// device name -> busy time (ms) at the last sample
+    std::map<std::string, uint64_t> io_ticks;
+    ceph::mono_time last_sample;
+    /// the highest fraction of the last sample interval any device was busy
+    double device_util{0.0};
+
+    void update_device_util();
+
    public:
     explicit LoadTracker(
 	CephContext* cct,
@@ -213,6 +234,10 @@ class OsdScrub {
 
     [[nodiscard]] bool scrub_load_below_threshold() const;
 
+    [[nodiscard]] bool device_util_below_threshold() const;
+
+    void set_devices(const std::set<std::string>& devs);
+
     std::ostream& gen_prefix(std::ostream& out, std::string_view fn) const;
   };
   LoadTracker m_load_tracker;
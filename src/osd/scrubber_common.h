@@ -95,6 +95,10 @@ struct OSDRestrictions {
   /// the CPU load is high. No regular scrubs are allowed.
   bool cpu_overloaded:1{false};
 
+  /// the OSD's devices are not idle (osd_scrub_device_util_threshold).
+  /// Handled as cpu_overloaded.
+  bool device_busy:1{false};
+
   /// outside of allowed scrubbing hours/days
   bool restricted_time:1{false};
 
@@ -193,10 +197,11 @@ struct formatter<Scrub::OSDRestrictions> {
   auto format(const Scrub::OSDRestrictions& conds, FormatContext& ctx) const
   {
     return fmt::format_to(
-	ctx.out(), "<{}.{}.{}.{}.{}.{}>",
+	ctx.out(), "<{}.{}.{}.{}.{}.{}.{}>",
 	conds.max_concurrency_reached ? "max-scrubs" : "",
 	conds.random_backoff_active ? "backoff" : "",
 	conds.cpu_overloaded ? "high-load" : "",
+	conds.device_busy ? "device-busy" : "",
 	conds.restricted_time ? "time-restrict" : "",
 	conds.recovery_in_progress ? "recovery" : "",
 	conds.allow_requested_repair_only ? "repair-only" : "");
@@ -1739,6 +1739,7 @@ int ObjectCacher::writex(OSDWrite *wr, ObjectSet *oset, Context *onfreespace,
   }
 
   list<Context*> wait_for_reads;
+  vector<Object*> written;
   for (vector<ObjectExtent>::iterator ex_it = wr->extents.begin();
        ex_it != wr->extents.end();
        ++ex_it) {
@@ -1804,6 +1805,21 @@ int ObjectCacher::writex(OSDWrite *wr, ObjectSet *oset, Context *onfreespace,
     bh->last_write = now;
 
     o->try_merge_bh(bh);
+    if (max_dirty_extent && (written.empty() || written.back() != o))
+      written.push_back(o);
+  }
+
+  // many small sequential writes merge into one dirty bh per object; once
+  // it is big enough, write it back now as one large write instead of
+  // leaving it to the flusher
+  for (auto o : written) {
+    for (auto& p : o->data) {
+      BufferHead *dbh = p.second;
+      if (dbh->is_dirty() && (uint64_t)dbh->length() >= max_dirty_extent) {
+	ldout(cct, 10) << "writex flushing large dirty " << *dbh << dendl;
+	bh_write(dbh, trace);
+      }
+    }
   }
 
   if (perfcounter) {
@@ -410,6 +410,7 @@ class ObjectCacher {
 
   uint64_t max_dirty, target_dirty, max_size, max_objects;
   ceph::timespan max_dirty_age;
+  uint64_t max_dirty_extent = 0;
   bool cfg_block_writes_upfront;
 
   ZTracer::Endpoint trace_endpoint;
@@ -683,6 +684,10 @@ public:
   void set_max_objects(int64_t v) {
     max_objects = v;
   }
+  // write back a dirty extent as soon as it grows to this size (0 = never)
+  void set_max_dirty_extent(uint64_t v) {
+    max_dirty_extent = v;
+  }
 
 
   // file functions
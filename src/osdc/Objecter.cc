@@ -185,6 +185,8 @@ enum {
   l_osdc_replica_read_bounced,
   l_osdc_replica_read_completed,
 
+  l_osdc_op_send_same_pg,
+
   l_osdc_last,
 };
 
@@ -245,9 +247,10 @@ void Objecter::handle_conf_change(const ConfigProxy& conf,
   auto read_policy = conf.get_val<std::string>("rados_replica_read_policy");
   if (read_policy == "localize") {
     extra_read_flags = CEPH_OSD_FLAG_LOCALIZE_READS;
-  } else if (read_policy == "balance") {
+  } else if (read_policy == "balance" || read_policy == "latency") {
     extra_read_flags = CEPH_OSD_FLAG_BALANCE_READS;
   }
+  balance_reads_by_latency = read_policy == "latency";
 }
 
 void Objecter::update_crush_location()
@@ -395,6 +398,9 @@ void Objecter::init()
     pcb.add_u64_counter(l_osdc_replica_read_completed, "replica_read_completed",
 			"Operations completed by replica");
 
+    pcb.add_u64_counter(l_osdc_op_send_same_pg, "op_send_same_pg",
+			"Operations sent right after another one to the same PG");
+
     logger = pcb.create_perf_counters();
     cct->get_perfcounters_collection()->add(logger);
   }
@@ -1178,6 +1184,31 @@ void Objecter::_scan_requests(
 
 void Objecter::handle_osd_map(MOSDMap *m)
 {
+  // Decode the maps we expect to use before taking rwlock exclusively.  A
+  // full map of a large cluster takes long enough to decode that every op
+  // submitter would stall behind it; only applying the maps needs the lock.
+  const epoch_t last_epoch = with_osdmap([](const OSDMap& o) {
+    return o.get_epoch();
+  });
+  map<epoch_t, OSDMap::Incremental> decoded_incs;
+  map<epoch_t, std::unique_ptr<OSDMap>> decoded_maps;
+  if (m->fsid == monc->get_fsid() && m->get_last() > last_epoch) {
+    for (auto& [e, bl] : m->incremental_maps) {
+      if (last_epoch && e > last_epoch) {
+	decoded_incs.try_emplace(e, bl);
+      }
+    }
+    for (auto& [e, bl] : m->maps) {
+      if (last_epoch ?
+	  (e > last_epoch && !m->incremental_maps.count(e)) :
+	  e == m->get_last()) {
+	auto o = std::make_unique<OSDMap>();
+	o->decode(bl);
+	decoded_maps.emplace(e, std::move(o));
+      }
+    }
+  }
+
   ceph::shunique_lock sul(rwlock, acquire_unique);
   if (!initialized)
     return;
@@ -1224,7 +1255,11 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	    m->incremental_maps.count(e)) {
 	  ldout(cct, 3) << "handle_osd_map decoding incremental epoch " << e
 			<< dendl;
-	  OSDMap::Incremental inc(m->incremental_maps[e]);
+	  auto i = decoded_incs.find(e);
+	  if (i == decoded_incs.end()) {
+	    i = decoded_incs.try_emplace(e, m->incremental_maps[e]).first;
+	  }
+	  const OSDMap::Incremental& inc = i->second;
 	  osdmap->apply_incremental(inc);
 
           emit_blocklist_events(inc);
@@ -1233,8 +1268,13 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	}
 	else if (m->maps.count(e)) {
 	  ldout(cct, 3) << "handle_osd_map decoding full epoch " << e << dendl;
-          auto new_osdmap = std::make_unique<OSDMap>();
-          new_osdmap->decode(m->maps[e]);
+          std::unique_ptr<OSDMap> new_osdmap;
+          if (auto d = decoded_maps.find(e); d != decoded_maps.end()) {
+            new_osdmap = std::move(d->second);
+          } else {
+            new_osdmap = std::make_unique<OSDMap>();
+            new_osdmap->decode(m->maps[e]);
+          }
 
           emit_blocklist_events(*osdmap, *new_osdmap);
           osdmap = std::move(new_osdmap);
@@ -1298,7 +1338,12 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	}
 	ldout(cct, 3) << "handle_osd_map decoding full epoch "
 		      << m->get_last() << dendl;
-	osdmap->decode(m->maps[m->get_last()]);
+	if (auto d = decoded_maps.find(m->get_last());
+	    d != decoded_maps.end()) {
+	  osdmap = std::move(d->second);
+	} else {
+	  osdmap->decode(m->maps[m->get_last()]);
+	}
         prune_pg_mapping(osdmap->get_pools());
 
 	_scan_requests(homeless_session, false, false, NULL,
@@ -2988,7 +3033,15 @@ int Objecter::_calc_target(op_target_t *t, Connection *con, bool any_change)
         !is_write && pi->is_replicated() && t->acting.size() > 1) {
       int osd;
       ceph_assert(is_read && t->acting[0] == acting_primary);
-      if (t->flags & CEPH_OSD_FLAG_BALANCE_READS) {
+      if ((t->flags & CEPH_OSD_FLAG_BALANCE_READS) &&
+	  balance_reads_by_latency) {
+	unsigned p = _choose_replica_by_latency(t->acting);
+	if (p)
+	  t->used_replica = true;
+	osd = t->acting[p];
+	ldout(cct, 10) << " chose fastest osd." << osd << " of " << t->acting
+		       << dendl;
+      } else if (t->flags & CEPH_OSD_FLAG_BALANCE_READS) {
 	int p = rand() % t->acting.size();
 	if (p)
 	  t->used_replica = true;
@@ -3043,6 +3096,34 @@ int Objecter::_map_session(op_target_t *target, OSDSession **s,
   return _get_session(target->osd, s, sul);
 }
 
+unsigned Objecter::_choose_replica_by_latency(const std::vector<int>& acting)
+{
+  // rwlock is locked
+
+  // power of two choices: compare two random replicas by the latency an
+  // op to them can expect, i.e. their read latency times the ops already
+  // queued on them.  OSDs with no session or no reads yet score 0 and so
+  // get tried.
+  auto score = [this, &acting](unsigned i) -> uint64_t {
+    auto p = osd_sessions.find(acting[i]);
+    if (p == osd_sessions.end()) {
+      return 0;
+    }
+    const OSDSession *s = p->second;
+    return s->read_lat_ewma_ns.load(std::memory_order_relaxed) *
+      (s->num_ops.load(std::memory_order_relaxed) + 1);
+  };
+  unsigned a = rand() % acting.size();
+  unsigned b = rand() % (acting.size() - 1);
+  if (b >= a) {
+    ++b;
+  }
+  auto sa = score(a), sb = score(b);
+  ldout(cct, 20) << __func__ << " osd." << acting[a] << " score " << sa
+		 << " vs osd." << acting[b] << " score " << sb << dendl;
+  return sb < sa ? b : a;
+}
+
 void Objecter::_session_op_assign(OSDSession *to, Op *op)
 {
   // to->lock is locked
@@ -3052,6 +3133,7 @@ void Objecter::_session_op_assign(OSDSession *to, Op *op)
   get_session(to);
   op->session = to;
   to->ops[op->tid] = op;
+  to->num_ops.store(to->ops.size(), std::memory_order_relaxed);
 
   if (to->is_homeless()) {
     num_homeless_ops++;
@@ -3070,6 +3152,7 @@ void Objecter::_session_op_remove(OSDSession *from, Op *op)
   }
 
   from->ops.erase(op->tid);
+  from->num_ops.store(from->ops.size(), std::memory_order_relaxed);
   put_session(from);
   op->session = NULL;
 
@@ -3340,6 +3423,13 @@ void Objecter::_send_op(Op *op)
 #endif
 
   op->incarnation = op->session->incarnation;
+  if (op->session->last_sent_pgid == op->target.actual_pgid) {
+    logger->inc(l_osdc_op_send_same_pg);
+  }
+  op->session->last_sent_pgid = op->target.actual_pgid;
+  if (balance_reads_by_latency) {
+    op->sent_stamp = ceph::mono_clock::now();
+  }
 
   if (op->trace.valid()) {
     m->trace.init("op msg", nullptr, &op->trace);
@@ -3504,6 +3594,14 @@ void Objecter::handle_osd_op_reply(MOSDOpReply *m)
       logger->inc(l_osdc_replica_read_bounced);
     } else {
       logger->inc(l_osdc_replica_read_completed);
+      if (op->sent_stamp != ceph::mono_time()) {
+	// s->lock serializes the updates
+	uint64_t lat = std::chrono::nanoseconds(
+	  ceph::mono_clock::now() - op->sent_stamp).count();
+	uint64_t avg = s->read_lat_ewma_ns.load(std::memory_order_relaxed);
+	s->read_lat_ewma_ns.store(avg ? avg - avg / 8 + lat / 8 : lat,
+				  std::memory_order_relaxed);
+      }
     }
   }
 
@@ -5125,6 +5223,10 @@ Objecter::Objecter(CephContext *cct,
   } else if (read_policy == "balance") {
     ldout(cct, 20) << __func__ << ": read policy: balance" << dendl;
     extra_read_flags = CEPH_OSD_FLAG_BALANCE_READS;
+  } else if (read_policy == "latency") {
+    ldout(cct, 20) << __func__ << ": read policy: latency" << dendl;
+    extra_read_flags = CEPH_OSD_FLAG_BALANCE_READS;
+    balance_reads_by_latency = true;
   }
 }
 
@@ -1724,6 +1724,8 @@ private:
   bool honor_pool_full = true;
 
   std::atomic<int> extra_read_flags{0};
+  /// pick balanced-read replicas by observed latency rather than at random
+  std::atomic<bool> balance_reads_by_latency{false};
 
   // If this is true, accumulate a set of blocklisted entities
   // to be drained by consume_blocklist_events.
@@ -2017,6 +2019,7 @@ public:
     epoch_t *reply_epoch = nullptr;
 
     ceph::coarse_mono_time stamp;
+    ceph::mono_time sent_stamp; ///< last send, for replica read latency
 
     epoch_t map_dne_bound = 0;
 
@@ -2476,6 +2479,10 @@ public:
 
     int incarnation;
     ConnectionRef con;
+    spg_t last_sent_pgid;  ///< pg of the last op sent on this session
+    // read by _calc_target() without the session lock
+    std::atomic<uint32_t> num_ops{0};
+    std::atomic<uint64_t> read_lat_ewma_ns{0};
     int num_locks;
     std::unique_ptr<std::mutex[]> completion_locks;
 
@@ -2561,6 +2568,7 @@ public:
     Op *op);
 
   bool target_should_be_paused(op_target_t *op);
+  unsigned _choose_replica_by_latency(const std::vector<int>& acting);
   int _calc_target(op_target_t *t, Connection *con,
 		   bool any_change = false);
   int _map_session(op_target_t *op, OSDSession **s,
@@ -8,6 +8,7 @@ import re
 import threading
 import time
 import enum
+import gzip
 from collections import namedtuple
 import tempfile
 
@@ -520,8 +521,12 @@ class MetricCollectionThread(threading.Thread):
                     )
                     sleep_time = 0
 
+                # compress once per collection rather than once per scrape
+                data_gz = gzip.compress(data.encode('utf-8'), compresslevel=6)
+
                 with self.mod.collect_lock:
                     self.mod.collect_cache = data
+                    self.mod.collect_cache_gz = data_gz
                     self.mod.collect_time = duration
 
                 self.event.wait(sleep_time)
@@ -611,6 +616,7 @@ class Module(MgrModule, OrchestratorClientMixin):
         self.cache = True
         self.stale_cache_strategy: str = self.STALE_CACHE_FAIL
         self.collect_cache: Optional[str] = None
+        self.collect_cache_gz: Optional[bytes] = None
         self.rbd_stats = {
             'pools': {},
             'pools_refresh_time': 0,
@@ -1838,14 +1844,14 @@ class Module(MgrModule, OrchestratorClientMixin):
 </html>'''
 
             @cherrypy.expose
-            def metrics(self) -> Optional[str]:
+            def metrics(self) -> Optional[Union[str, bytes]]:
                 # Lock the function execution
                 assert isinstance(_global_instance, Module)
                 with _global_instance.collect_lock:
                     return self._metrics(_global_instance)
 
             @staticmethod
-            def _metrics(instance: 'Module') -> Optional[str]:
+            def _metrics(instance: 'Module') -> Optional[Union[str, bytes]]:
                 if not self.cache:
                     self.log.debug('Cache disabled, collecting and returning without cache')
                     cherrypy.response.headers['Content-Type'] = 'text/plain'
@@ -1855,9 +1861,14 @@ class Module(MgrModule, OrchestratorClientMixin):
                 if not instance.collect_cache:
                     raise cherrypy.HTTPError(503, 'No cached data available yet')
 
-                def respond() -> Optional[str]:
+                def respond() -> Optional[Union[str, bytes]]:
                     assert isinstance(instance, Module)
                     cherrypy.response.headers['Content-Type'] = 'text/plain'
+                    accept = cherrypy.request.headers.get('Accept-Encoding', '')
+                    if instance.collect_cache_gz and 'gzip' in accept:
+                        cherrypy.response.headers['Content-Encoding'] = 'gzip'
+                        cherrypy.response.headers['Vary'] = 'Accept-Encoding'
+                        return instance.collect_cache_gz
                     return instance.collect_cache
 
                 if instance.collect_time < instance.scrape_interval:
@@ -9,6 +9,7 @@
 #include "rgw_auth_s3.h"
 #include "rgw_op.h"
 #include "rgw_crypt_sanitize.h"
+#include "rgw_perf_counters.h"
 #if defined(__linux__)
 #include <features.h>
 #endif
@@ -94,6 +95,14 @@ void D3nDataCache::init(CephContext *_cct) {
                               "' : " << e.what() << dendl;
   }
 
+  admission_misses = std::max<uint64_t>(
+    1, cct->_conf.get_val<uint64_t>("rgw_d3n_l1_admission_misses"));
+  // remember misses for about twice as many max-size chunks as fit in
+  // the cache
+  miss_history_max = std::max<uint64_t>(
+    1024, 2 * free_data_cache_size / std::max<uint64_t>(
+      1, cct->_conf->rgw_get_obj_max_req_size));
+
   auto conf_eviction_policy = cct->_conf.get_val<std::string>("rgw_d3n_l1_eviction_policy");
   ceph_assert(conf_eviction_policy == "lru" || conf_eviction_policy == "random");
   if (conf_eviction_policy == "lru")
@@ -192,6 +201,12 @@ void D3nDataCache::d3n_libaio_write_completion_cb(D3nCacheAioWriteRequest* c)
     lru_insert_head(chunk_info);
   }
 
+  if (perfcounter) {
+    perfcounter->inc(l_rgw_d3n_cache_fill);
+    perfcounter->tinc(l_rgw_d3n_cache_fill_lat,
+		      ceph::mono_clock::now() - c->start_time);
+  }
+
   delete c;
   c = nullptr;
 }
@@ -212,6 +227,7 @@ int D3nDataCache::d3n_libaio_create_write_request(bufferlist& bl, unsigned int l
   wr->cb->aio_sigevent.sigev_value.sival_ptr = (void*)(wr.get());
   wr->oid = oid;
   wr->priv_data = this;
+  wr->start_time = ceph::mono_clock::now();
 
   if ((r = ::aio_write(wr->cb)) != 0) {
     ldout(cct, 0) << "ERROR: D3nDataCache: " << __func__ << "() aio_write r=" << r << dendl;
@@ -243,6 +259,14 @@ void D3nDataCache::put(bufferlist& bl, unsigned int len, std::string& oid)
       ldout(cct, 10) << "D3nDataCache: NOTE: data put in cache already issued, no rewrite" << dendl;
       return;
     }
+    if (!admit(oid)) {
+      ldout(cct, 20) << "D3nDataCache: " << __func__ << "(): not admitting oid="
+		     << oid << " yet" << dendl;
+      if (perfcounter) {
+	perfcounter->inc(l_rgw_d3n_cache_admission_skip);
+      }
+      return;
+    }
     d3n_outstanding_write_list.insert(oid);
   }
   {
@@ -263,6 +287,7 @@ void D3nDataCache::put(bufferlist& bl, unsigned int len, std::string& oid)
     }
     if (sr == 0) {
       ldout(cct, 2) << "D3nDataCache: Warning: eviction was not able to free disk space, not writing to cache" << dendl;
+      const std::lock_guard l(d3n_cache_lock);
       d3n_outstanding_write_list.erase(oid);
       return;
     }
@@ -283,19 +308,52 @@ void D3nDataCache::put(bufferlist& bl, unsigned int len, std::string& oid)
   outstanding_write_size += len;
 }
 
+bool D3nDataCache::admit(const std::string& oid)
+{
+  if (admission_misses <= 1) {
+    return true;
+  }
+  auto [it, inserted] = d3n_miss_history.try_emplace(oid);
+  if (inserted) {
+    it->second = {0, d3n_miss_fifo.insert(d3n_miss_fifo.end(), oid)};
+    if (d3n_miss_fifo.size() > miss_history_max) {
+      d3n_miss_history.erase(d3n_miss_fifo.front());
+      d3n_miss_fifo.pop_front();
+    }
+  }
+  if (++it->second.first < admission_misses) {
+    return false;
+  }
+  d3n_miss_fifo.erase(it->second.second);
+  d3n_miss_history.erase(it);
+  return true;
+}
+
 bool D3nDataCache::get(const string& oid, const off_t len)
 {
-  const std::lock_guard l(d3n_cache_lock);
-  bool exist = false;
   string location = cache_location + url_encode(oid, true);
 
   lsubdout(g_ceph_context, rgw_datacache, 20) << "D3nDataCache: " << __func__ << "(): location=" << location << dendl;
-  std::unordered_map<string, D3nChunkDataInfo*>::iterator iter = d3n_cache_map.find(oid);
-  if (!(iter == d3n_cache_map.end())) {
-    // check inside cache whether file exists or not!!!! then make exist true;
+  {
+    const std::lock_guard l(d3n_cache_lock);
+    if (d3n_cache_map.find(oid) == d3n_cache_map.end()) {
+      if (perfcounter) {
+        perfcounter->inc(l_rgw_d3n_cache_miss);
+      }
+      return false;
+    }
+  }
+
+  // check inside cache whether file exists or not, without holding
+  // d3n_cache_lock across the syscall
+  struct stat st;
+  int r = stat(location.c_str(), &st);
+
+  const std::lock_guard l(d3n_cache_lock);
+  bool exist = false;
+  auto iter = d3n_cache_map.find(oid);
+  if (iter != d3n_cache_map.end()) { // may have been evicted meanwhile
     struct D3nChunkDataInfo* chdo = iter->second;
-    struct stat st;
-    int r = stat(location.c_str(), &st);
     if ( r != -1 && st.st_size == len) { // file exists and contains required data range length
       exist = true;
       /*LRU*/
@@ -304,13 +362,15 @@ bool D3nDataCache::get(const string& oid, const off_t len)
       lru_remove(chdo);
       lru_insert_head(chdo);
     } else {
-      d3n_cache_map.erase(oid);
+      d3n_cache_map.erase(iter);
       const std::lock_guard l(d3n_eviction_lock);
       lru_remove(chdo);
       delete chdo;
-      exist = false;
     }
   }
+  if (perfcounter) {
+    perfcounter->inc(exist ? l_rgw_d3n_cache_hit : l_rgw_d3n_cache_miss);
+  }
   return exist;
 }
 
@@ -8,8 +8,10 @@
 
 #include "rgw_common.h"
 
+#include <list>
 #include <unistd.h>
 #include <signal.h>
+#include "common/ceph_time.h"
 #include "include/Context.h"
 #include "include/lru.h"
 #include "rgw_d3n_cacherequest.h"
@@ -46,6 +48,7 @@ struct D3nCacheAioWriteRequest {
 	struct aiocb *cb = nullptr;
 	D3nDataCache *priv_data = nullptr;
 	CephContext *cct = nullptr;
+	ceph::mono_time start_time;
 
 	D3nCacheAioWriteRequest(CephContext *_cct) : cct(_cct) {}
 	int d3n_libaio_prepare_write_op(bufferlist& bl, unsigned int len, std::string oid, std::string cache_location);
@@ -82,8 +85,18 @@ private:
   struct D3nChunkDataInfo* head;
   struct D3nChunkDataInfo* tail;
 
+  // rgw_d3n_l1_admission_misses: recently missed chunks that haven't
+  // been admitted yet, with their miss counts, oldest first in
+  // d3n_miss_fifo; protected by d3n_cache_lock
+  uint32_t admission_misses = 1;
+  size_t miss_history_max = 0;
+  std::list<std::string> d3n_miss_fifo;
+  std::unordered_map<std::string,
+		     std::pair<uint32_t, std::list<std::string>::iterator>> d3n_miss_history;
+
 private:
   void add_io();
+  bool admit(const std::string& oid);
 
 public:
   D3nDataCache();
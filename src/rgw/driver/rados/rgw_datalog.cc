@@ -422,7 +422,8 @@ RGWDataChangesLog::RGWDataChangesLog(CephContext* cct)
   : cct(cct),
     num_shards(cct->_conf->rgw_data_log_num_shards),
     prefix(get_prefix()),
-    changes(cct->_conf->rgw_data_log_changes_size) {}
+    changes(cct->_conf->rgw_data_log_changes_size),
+    push_queues(num_shards) {}
 
 bs::error_code DataLogBackends::handle_init(entries_t e) noexcept {
   std::unique_lock l(m);
@@ -737,9 +738,7 @@ int RGWDataChangesLog::add_entry(const DoutPrefixProvider *dpp,
 
     ldpp_dout(dpp, 20) << "RGWDataChangesLog::add_entry() sending update with now=" << now << " cur_expiration=" << expiration << dendl;
 
-    auto be = bes->head();
-    // TODO: pass y once we fix the deadlock from https://tracker.ceph.com/issues/63373
-    ret = be->push(dpp, index, now, change.key, std::move(bl), null_yield);
+    ret = push_batched(dpp, index, now, change.key, std::move(bl));
 
     now = real_clock::now();
 
@@ -762,6 +761,43 @@ int RGWDataChangesLog::add_entry(const DoutPrefixProvider *dpp,
   return ret;
 }
 
+int RGWDataChangesLog::push_batched(const DoutPrefixProvider *dpp, int index,
+				    ceph::real_time now, const std::string& key,
+				    ceph::buffer::list&& bl)
+{
+  auto& q = push_queues[index];
+  std::unique_lock l(q.lock);
+  auto batch = q.next;
+  batch->items.emplace_back(now, key, std::move(bl));
+  q.cond.wait(l, [&] { return batch->done || !q.pushing; });
+  if (batch->done) {
+    return batch->ret;
+  }
+
+  // nothing in flight for this shard, push everything queued so far
+  q.pushing = true;
+  q.next = std::make_shared<PushBatch>();
+  l.unlock();
+
+  auto be = bes->head();
+  RGWDataChangesBE::entries entries;
+  for (auto& [t, k, b] : batch->items) {
+    be->prepare(t, k, std::move(b), entries);
+  }
+  ldpp_dout(dpp, 20) << "RGWDataChangesLog::push_batched() pushing "
+		     << batch->items.size() << " entries to shard "
+		     << index << dendl;
+  // TODO: pass y once we fix the deadlock from https://tracker.ceph.com/issues/63373
+  int ret = be->push(dpp, index, std::move(entries), null_yield);
+
+  l.lock();
+  batch->ret = ret;
+  batch->done = true;
+  q.pushing = false;
+  q.cond.notify_all();
+  return ret;
+}
+
 int DataLogBackends::list(const DoutPrefixProvider *dpp, int shard, int max_entries,
 			  std::vector<rgw_data_change_log_entry>& entries,
 			  std::string_view marker, std::string* out_marker,
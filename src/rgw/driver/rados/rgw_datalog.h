@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <variant>
 #include <vector>
 
@@ -269,6 +270,26 @@ class RGWDataChangesLog {
 
   bc::flat_set<BucketGen> cur_cycle;
 
+  // add_entry() pushes to the same datalog shard are group committed:
+  // entries queued while a push is in flight go out together in the
+  // next one, sent by whichever of their callers wakes first
+  struct PushBatch {
+    std::vector<std::tuple<ceph::real_time, std::string,
+			   ceph::buffer::list>> items;
+    bool done = false;
+    int ret = 0;
+  };
+  struct PushQueue {
+    ceph::mutex lock = ceph::make_mutex("RGWDataChangesLog::PushQueue");
+    ceph::condition_variable cond;
+    bool pushing = false;
+    std::shared_ptr<PushBatch> next = std::make_shared<PushBatch>();
+  };
+  std::vector<PushQueue> push_queues;
+  int push_batched(const DoutPrefixProvider *dpp, int index,
+		   ceph::real_time now, const std::string& key,
+		   ceph::buffer::list&& bl);
+
   ChangeStatusPtr _get_change(const rgw_bucket_shard& bs, uint64_t gen);
   void register_renew(const rgw_bucket_shard& bs,
 		      const rgw::bucket_log_layout_generation& gen);
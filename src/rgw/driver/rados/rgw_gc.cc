@@ -3,6 +3,8 @@
 
 #include "rgw_gc.h"
 
+#include <optional>
+
 #include "rgw_tools.h"
 #include "include/scope_guard.h"
 #include "include/rados/librados.hpp"
@@ -594,6 +596,12 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
   string marker;
   string next_marker;
   bool truncated = false;
+  /* in queue mode, the page after the one whose tail objects are being
+   * removed is listed while those removals are in flight */
+  std::optional<std::list<cls_rgw_gc_obj_info>> prefetched;
+  int prefetch_ret = 0;
+  bool prefetch_truncated = false;
+  string prefetch_next_marker;
   IoCtx *ctx = new IoCtx;
   do {
     int max = 100;
@@ -628,7 +636,15 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
     }
 
     if (transitioned_objects_cache[index]) {
-      ret = cls_rgw_gc_queue_list_entries(store->gc_pool_ctx, obj_names[index], marker, max, expired_only, entries, &truncated, next_marker);
+      if (prefetched) {
+        entries = std::move(*prefetched);
+        prefetched.reset();
+        ret = prefetch_ret;
+        truncated = prefetch_truncated;
+        next_marker = std::move(prefetch_next_marker);
+      } else {
+        ret = cls_rgw_gc_queue_list_entries(store->gc_pool_ctx, obj_names[index], marker, max, expired_only, entries, &truncated, next_marker);
+      }
       ldpp_dout(this, 20) <<
       "RGWGC::process cls_rgw_gc_queue_list_entries returned with return value:" << ret <<
       ", entries.size=" << entries.size() << ", truncated=" << truncated <<
@@ -711,6 +727,10 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
       } // else -- chains not empty
     } // entries loop
     if (transitioned_objects_cache[index] && entries.size() > 0) {
+      if (truncated) {
+        prefetched.emplace();
+        prefetch_ret = cls_rgw_gc_queue_list_entries(store->gc_pool_ctx, obj_names[index], marker, max, expired_only, *prefetched, &prefetch_truncated, prefetch_next_marker);
+      }
       ret = io_manager.drain_ios();
       if (ret < 0) {
         goto done;
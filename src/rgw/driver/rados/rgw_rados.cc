@@ -53,6 +53,7 @@
 #include "rgw_etag_verifier.h"
 #include "rgw_worker.h"
 #include "rgw_notify.h"
+#include "rgw_perf_counters.h"
 #include "rgw_http_errors.h"
 
 #undef fork // fails to compile RGWPeriod::fork() below
@@ -1857,6 +1858,10 @@ int RGWRados::Bucket::List::list_objects_ordered(
   // until we return at least one entry
   constexpr uint16_t SOFT_MAX_ATTEMPTS = 8;
 
+  // shards that have no entries after cur_marker; since the marker
+  // only moves forward, later attempts don't need to ask them again
+  std::set<int> exhausted_shards;
+
   rgw_obj_index_key prev_marker;
   for (uint16_t attempt = 1; /* empty */; ++attempt) {
     ldpp_dout(dpp, 20) << __func__ <<
@@ -1889,7 +1894,8 @@ int RGWRados::Bucket::List::list_objects_ordered(
 					   &cls_filtered,
 					   &cur_marker,
                                            y,
-					   params.force_check_filter);
+					   params.force_check_filter,
+					   &exhausted_shards);
     if (r < 0) {
       return r;
     }
@@ -3311,7 +3317,12 @@ int RGWRados::Object::Write::_do_write_meta(uint64_t size, uint64_t accounted_si
 
   if (!index_op->is_prepared()) {
     tracepoint(rgw_rados, prepare_enter, req_id.c_str());
+    auto prepare_start = ceph::mono_clock::now();
     r = index_op->prepare(rctx.dpp, CLS_RGW_OP_ADD, &state->write_tag, rctx.y, log_op);
+    if (perfcounter) {
+      perfcounter->tinc(l_rgw_index_prepare_lat,
+                        ceph::mono_clock::now() - prepare_start);
+    }
     tracepoint(rgw_rados, prepare_exit, req_id.c_str());
     if (r < 0)
       return r;
@@ -3320,7 +3331,11 @@ int RGWRados::Object::Write::_do_write_meta(uint64_t size, uint64_t accounted_si
   auto& ioctx = ref.ioctx;
 
   tracepoint(rgw_rados, operate_enter, req_id.c_str());
+  auto write_start = ceph::mono_clock::now();
   r = rgw_rados_operate(rctx.dpp, ref.ioctx, ref.obj.oid, &op, rctx.y, 0, &trace, &epoch);
+  if (perfcounter) {
+    perfcounter->tinc(l_rgw_head_write_lat, ceph::mono_clock::now() - write_start);
+  }
   tracepoint(rgw_rados, operate_exit, req_id.c_str());
   if (r < 0) { /* we can expect to get -ECANCELED if object was replaced under,
                 or -ENOENT if was removed, or -EEXIST if it did not exist
@@ -3449,6 +3464,12 @@ int RGWRados::Object::Write::write_meta(uint64_t size, uint64_t accounted_size,
   RGWRados::Bucket::UpdateIndex index_op(&bop, target->get_obj());
   index_op.set_zones_trace(meta.zones_trace);
   
+  // with assume_noent, a new object costs two synchronous round trips:
+  // the index prepare and an exclusive create of the head, which carries
+  // the first chunk of data; the index complete is sent asynchronously.
+  // the two can't share an op, as the head and the index shard are
+  // different objects, and the prepare has to land first so that a crash
+  // leaves a pending entry for check_disk_state() to reconcile
   bool assume_noent = (meta.if_match == NULL && meta.if_nomatch == NULL);
   int r;
   if (assume_noent) {
@@ -4285,7 +4306,11 @@ int RGWRados::fetch_remote_obj(RGWObjectCtx& dest_obj_ctx,
   ACLOwner owner;
   RGWAccessControlPolicy policy;
 
-  rgw::BlockingAioThrottle aio(cct->_conf->rgw_put_obj_min_window_size);
+  // the remote GET is streamed straight into the processor, so let the
+  // write window widen whenever rados writes are what keeps the stream
+  // waiting
+  rgw::BlockingAioThrottle aio(cct->_conf->rgw_put_obj_min_window_size,
+                               cct->_conf->rgw_put_obj_max_window_size);
   using namespace rgw::putobj;
   jspan_context no_trace{false, false};
   AtomicObjectProcessor processor(&aio, this, dest_bucket_info, nullptr,
@@ -7689,8 +7714,10 @@ int RGWRados::Object::Read::iterate(const DoutPrefixProvider *dpp, int64_t ofs,
   CephContext *cct = store->ctx();
   const uint64_t chunk_size = cct->_conf->rgw_get_obj_max_req_size;
   const uint64_t window_size = cct->_conf->rgw_get_obj_window_size;
+  const uint64_t max_window_size =
+    cct->_conf.get_val<Option::size_t>("rgw_get_obj_max_window_size");
 
-  auto aio = rgw::make_throttle(window_size, y);
+  auto aio = rgw::make_throttle(window_size, y, max_window_size);
   get_obj_data data(store, cb, &*aio, ofs, y);
 
   int r = store->iterate_obj(dpp, source->get_ctx(), source->get_bucket_info(), state.obj,
@@ -9662,6 +9689,24 @@ int RGWRados::bi_list(const DoutPrefixProvider *dpp,
   return bi_list(bs, obj_name_filter, marker, max, entries, is_truncated, reshardlog, y);
 }
 
+int RGWRados::bi_list_shards(const DoutPrefixProvider *dpp,
+			     const RGWBucketInfo& bucket_info,
+			     const string& marker, uint32_t max, bool reshardlog,
+			     map<int, rgw_cls_bi_list_ret>& results, optional_yield y)
+{
+  librados::IoCtx index_pool;
+  map<int, string> bucket_objs;
+
+  int r = svc.bi_rados->open_bucket_index(dpp, bucket_info, std::nullopt, bucket_info.layout.current_index, &index_pool, &bucket_objs, nullptr);
+  if (r < 0) {
+    return r;
+  }
+
+  maybe_warn_about_blocking(dpp); // TODO: use AioTrottle
+  return CLSRGWIssueBIList(index_pool, marker, max, reshardlog, bucket_objs,
+			   results, cct->_conf->rgw_bucket_index_max_aio)();
+}
+
 int RGWRados::bi_remove(const DoutPrefixProvider *dpp, BucketShard& bs)
 {
   auto& ref = bs.bucket_obj;
@@ -9904,7 +9949,8 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
 				      bool* cls_filtered,
 				      rgw_obj_index_key* last_entry,
                                       optional_yield y,
-				      RGWBucketListNameFilter force_check_filter)
+				      RGWBucketListNameFilter force_check_filter,
+				      std::set<int>* exhausted_shards)
 {
   const bool bitx = cct->_conf->rgw_bucket_index_transaction_instrumentation;
 
@@ -9942,14 +9988,31 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     return r;
   }
 
-  const uint32_t shard_count = shard_oids.size();
-  if (shard_count == 0) {
+  if (shard_oids.empty()) {
     ldpp_dout(dpp, 0) << "ERROR: " << __func__ <<
       ": the bucket index shard count appears to be 0, "
       "which is an illegal value" << dendl;
     return -ERR_INVALID_BUCKET_STATE;
   }
 
+  // shards that returned everything they had after an earlier marker
+  // in this listing have nothing after our (later) marker either, so
+  // don't send them another cls call; the remaining shards share the
+  // per-shard read calculation below
+  if (exhausted_shards && !exhausted_shards->empty()) {
+    for (int s : *exhausted_shards) {
+      shard_oids.erase(s);
+    }
+    if (shard_oids.empty()) {
+      ldpp_dout(dpp, 10) << __func__ <<
+	": all requested shards exhausted by earlier calls" << dendl;
+      *is_truncated = false;
+      return 0;
+    }
+  }
+
+  const uint32_t shard_count = shard_oids.size();
+
   uint32_t num_entries_per_shard;
   if (expansion_factor == 0) {
     num_entries_per_shard =
@@ -10037,18 +10100,30 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     }
   }; // ShardTracker
 
-  // add the next unique candidate, or return false if we reach the end
-  auto next_candidate = [] (CephContext *cct, ShardTracker& t,
-                            std::multimap<std::string, size_t>& candidates,
-                            size_t tracker_idx) {
-    if (!t.at_end()) {
-      candidates.emplace(t.entry_name(), tracker_idx);
+  // one tracker per shard requested (may not be all shards)
+  std::vector<ShardTracker> results_trackers;
+
+  // min-heap of the next candidate entry from each ShardTracker that
+  // still has entries, ordered by entry name and then by index into
+  // results_trackers so ties resolve deterministically; as we consume
+  // entries from shards, we replace them with the next entries in the
+  // shards until we run out
+  auto candidate_greater = [&results_trackers] (size_t a, size_t b) {
+    int c = results_trackers[a].entry_name().compare(
+      results_trackers[b].entry_name());
+    return c > 0 || (c == 0 && a > b);
+  };
+  std::vector<size_t> candidates;
+  candidates.reserve(shard_list_results.size());
+
+  // add the next candidate from the tracker, if it has one
+  auto next_candidate = [&] (size_t tracker_idx) {
+    if (!results_trackers[tracker_idx].at_end()) {
+      candidates.push_back(tracker_idx);
+      std::push_heap(candidates.begin(), candidates.end(), candidate_greater);
     }
-    return;
   };
 
-  // one tracker per shard requested (may not be all shards)
-  std::vector<ShardTracker> results_trackers;
   results_trackers.reserve(shard_list_results.size());
   for (auto& r : shard_list_results) {
     results_trackers.emplace_back(r.first, r.second, shard_oids[r.first]);
@@ -10062,21 +10137,15 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     *cls_filtered = *cls_filtered && r.second.cls_filtered;
   }
 
-  // create a map to track the next candidate entry from ShardTracker
-  // (key=candidate, value=index into results_trackers); as we consume
-  // entries from shards, we replace them with the next entries in the
-  // shards until we run out
-  std::multimap<std::string, size_t> candidates;
-  size_t tracker_idx = 0;
+  // it's important that the values in the heap refer to the index into
+  // the results_trackers vector, which may not be the same as the
+  // shard number (i.e., when not all shards are requested)
+  for (size_t tracker_idx = 0; tracker_idx < results_trackers.size();
+       ++tracker_idx) {
+    next_candidate(tracker_idx);
+  }
   std::vector<size_t> vidx;
   vidx.reserve(shard_list_results.size());
-  for (auto& t : results_trackers) {
-    // it's important that the values in the map refer to the index
-    // into the results_trackers vector, which may not be the same
-    // as the shard number (i.e., when not all shards are requested)
-    next_candidate(cct, t, candidates, tracker_idx);
-    ++tracker_idx;
-  }
 
   rgw_bucket_dir_entry*
     last_entry_visited = nullptr; // to set last_entry (marker)
@@ -10084,11 +10153,10 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
   uint32_t count = 0;
   while (count < num_entries && !candidates.empty()) {
     r = 0;
-    // select the next entry in lexical order (first key in map);
-    // again tracker_idx is not necessarily shard number, but is index
-    // into results_trackers vector
-    tracker_idx = candidates.begin()->second;
-    auto& tracker = results_trackers.at(tracker_idx);
+    // select the next entry in lexical order (top of the heap); again
+    // the value is not necessarily shard number, but is index into
+    // results_trackers vector
+    auto& tracker = results_trackers.at(candidates.front());
 
     const std::string& name = tracker.entry_name();
     rgw_bucket_dir_entry& dirent = tracker.dir_entry();
@@ -10144,18 +10212,21 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
       last_entry_visited = &tracker.dir_entry();
     }
 
-    // refresh the candidates map
+    // refresh the candidates heap; pop every tracker positioned at
+    // this name before advancing any of them, since advancing
+    // invalidates the name
     vidx.clear();
     bool need_to_stop = false;
-    auto range = candidates.equal_range(name);
-    for (auto i = range.first; i != range.second; ++i) {
-      vidx.push_back(i->second);
-    } 
-    candidates.erase(range.first, range.second);
+    while (!candidates.empty() &&
+	   results_trackers[candidates.front()].entry_name() == name) {
+      std::pop_heap(candidates.begin(), candidates.end(), candidate_greater);
+      vidx.push_back(candidates.back());
+      candidates.pop_back();
+    }
     for (auto idx : vidx) {
       auto& tracker_match = results_trackers.at(idx);
       tracker_match.advance();
-      next_candidate(cct, tracker_match, candidates, idx);
+      next_candidate(idx);
       if (tracker_match.at_end() && tracker_match.is_truncated()) {
         need_to_stop = true;
         break;
@@ -10193,12 +10264,14 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
   } // updates loop
 
   // determine truncation by checking if all the returned entries are
-  // consumed or not
+  // consumed or not; remember the shards that have been fully consumed
+  // so the caller's next call can leave them out
   *is_truncated = false;
   for (const auto& t : results_trackers) {
     if (!t.at_end() || t.is_truncated()) {
       *is_truncated = true;
-      break;
+    } else if (exhausted_shards) {
+      exhausted_shards->insert(t.shard_idx);
     }
   }
 
@@ -1518,7 +1518,8 @@ public:
 			      bool* cls_filtered,
 			      rgw_obj_index_key *last_entry,
                               optional_yield y,
-			      RGWBucketListNameFilter force_check_filter = {});
+			      RGWBucketListNameFilter force_check_filter = {},
+			      std::set<int>* exhausted_shards = nullptr);
   int cls_bucket_list_unordered(const DoutPrefixProvider *dpp,
                                 RGWBucketInfo& bucket_info,
                                 const rgw::bucket_index_layout_generation& idx_layout,
@@ -1559,6 +1560,12 @@ public:
               bool *is_truncated, bool reshardlog, optional_yield y);
   int bi_list(const DoutPrefixProvider *dpp, rgw_bucket& bucket, const std::string& obj_name, const std::string& marker, uint32_t max,
               std::list<rgw_cls_bi_entry> *entries, bool *is_truncated, bool reshardlog, optional_yield y);
+  // list the first max entries after marker from every shard of the
+  // current index concurrently; results are keyed by shard id
+  int bi_list_shards(const DoutPrefixProvider *dpp,
+                     const RGWBucketInfo& bucket_info,
+                     const std::string& marker, uint32_t max, bool reshardlog,
+                     std::map<int, rgw_cls_bi_list_ret>& results, optional_yield y);
   int bi_remove(const DoutPrefixProvider *dpp, BucketShard& bs);
 
   int trim_reshard_log_entries(const DoutPrefixProvider *dpp, RGWBucketInfo& bucket_info, optional_yield y);
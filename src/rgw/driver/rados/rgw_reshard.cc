@@ -1121,6 +1121,20 @@ int RGWBucketReshard::reshard_process(const rgw::bucket_index_layout_generation&
     (*out) << stage;
   }
 
+  // writes are blocked while the log is processed, so rather than
+  // waiting on each source shard's first page in turn, fetch them all
+  // concurrently; most shards' logs fit in one page or are empty
+  std::map<int, rgw_cls_bi_list_ret> first_pages;
+  if (process_log) {
+    int ret = store->getRados()->bi_list_shards(dpp, bucket_info, "",
+                                                max_op_entries, process_log,
+                                                first_pages, y);
+    if (ret < 0) {
+      derr << "ERROR: bi_list_shards(): " << cpp_strerror(-ret) << dendl;
+      return ret;
+    }
+  }
+
   const uint32_t num_source_shards = rgw::num_shards(current.layout.normal);
   string marker;
   for (uint32_t i = 0; i < num_source_shards; ++i) {
@@ -1130,9 +1144,16 @@ int RGWBucketReshard::reshard_process(const rgw::bucket_index_layout_generation&
     while (is_truncated) {
       entries.clear();
 
-      int ret = store->getRados()->bi_list(dpp, bucket_info, i, null_object_filter,
-                                           marker, max_op_entries, &entries,
-                                           &is_truncated, process_log, y);
+      int ret = 0;
+      if (auto page = first_pages.find(i); page != first_pages.end()) {
+        entries.swap(page->second.entries);
+        is_truncated = page->second.is_truncated;
+        first_pages.erase(page);
+      } else {
+        ret = store->getRados()->bi_list(dpp, bucket_info, i, null_object_filter,
+                                         marker, max_op_entries, &entries,
+                                         &is_truncated, process_log, y);
+      }
       if (ret == -ENOENT) {
         ldpp_dout(dpp, 1) << "WARNING: " << __func__ << " failed to find shard "
             << i << ", skipping" << dendl;
@@ -48,6 +48,7 @@ AioResultList BlockingAioThrottle::get(rgw_raw_obj obj,
       waiter = Wait::Available;
       cond.wait(lock, [this] { return is_available(); });
       waiter = Wait::None;
+      grow_window(p->cost);
     }
 
     // register the pending write and attach a completion
@@ -141,6 +142,7 @@ AioResultList YieldingAioThrottle::get(rgw_raw_obj obj,
       boost::system::error_code ec;
       waiter = Wait::Available;
       async_wait(yield[ec]);
+      grow_window(p->cost);
     }
 
     // register the pending write and initiate the operation
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include "common/ceph_mutex.h"
 #include "common/async/completion.h"
@@ -25,7 +26,9 @@ namespace rgw {
 
 class Throttle {
  protected:
-  const uint64_t window;
+  uint64_t window;
+  // the window widens up to max_window, see grow_window()
+  const uint64_t max_window;
   uint64_t pending_size = 0;
 
   AioResultList pending;
@@ -40,8 +43,16 @@ class Throttle {
 
   bool waiter_ready() const;
 
+  // called after get() had to wait for the window: the caller sat idle
+  // until a completion freed up space, so allow one more op of this size
+  // in flight next time
+  void grow_window(uint64_t cost) {
+    window = std::min(max_window, window + cost);
+  }
+
  public:
-  Throttle(uint64_t window) : window(window) {}
+  Throttle(uint64_t window, uint64_t max_window = 0)
+    : window(window), max_window(std::max(window, max_window)) {}
 
   virtual ~Throttle() {
     // must drain before destructing
@@ -61,7 +72,8 @@ class BlockingAioThrottle final : public Aio, private Throttle {
     uint64_t cost = 0;
   };
  public:
-  BlockingAioThrottle(uint64_t window) : Throttle(window) {}
+  BlockingAioThrottle(uint64_t window, uint64_t max_window = 0)
+    : Throttle(window, max_window) {}
 
   virtual ~BlockingAioThrottle() override {};
 
@@ -93,8 +105,9 @@ class YieldingAioThrottle final : public Aio, private Throttle {
   struct Pending : AioResultEntry { uint64_t cost = 0; };
 
  public:
-  YieldingAioThrottle(uint64_t window, boost::asio::yield_context yield)
-    : Throttle(window), yield(yield)
+  YieldingAioThrottle(uint64_t window, boost::asio::yield_context yield,
+                      uint64_t max_window = 0)
+    : Throttle(window, max_window), yield(yield)
   {}
 
   virtual ~YieldingAioThrottle() override {};
@@ -111,15 +124,18 @@ class YieldingAioThrottle final : public Aio, private Throttle {
   AioResultList drain() override final;
 };
 
-// return a smart pointer to Aio
-inline auto make_throttle(uint64_t window_size, optional_yield y)
+// return a smart pointer to Aio. if max_window_size is larger than
+// window_size, the window grows toward it whenever a get() has to wait
+inline auto make_throttle(uint64_t window_size, optional_yield y,
+                          uint64_t max_window_size = 0)
 {
   std::unique_ptr<Aio> aio;
   if (y) {
     aio = std::make_unique<YieldingAioThrottle>(window_size,
-                                                y.get_yield_context());
+                                                y.get_yield_context(),
+                                                max_window_size);
   } else {
-    aio = std::make_unique<BlockingAioThrottle>(window_size);
+    aio = std::make_unique<BlockingAioThrottle>(window_size, max_window_size);
   }
   return aio;
 }
@@ -480,6 +480,7 @@ class AsioFrontend {
     boost::asio::cancellation_signal signal;
     bool use_ssl = false;
     bool use_nodelay = false;
+    bool use_reuseport = false;
 
     explicit Listener(boost::asio::io_context& context)
       : acceptor(context), socket(context) {}
@@ -696,7 +697,36 @@ int AsioFrontend::init()
       l.use_nodelay = (nodelay->second == "1");
     }
   }
-  
+
+  // listen on several SO_REUSEPORT sockets per endpoint, each with its
+  // own accept loop, so the kernel spreads new connections over them
+  // instead of funneling every accept through one coroutine
+  if (auto i = config.find("so_reuseport"); i != config.end()) {
+#ifdef SO_REUSEPORT
+    auto n = ceph::parse<uint32_t>(i->second);
+    if (!n || *n == 0) {
+      lderr(ctx()) << "WARNING: invalid value for so_reuseport: "
+          << i->second << ", ignoring" << dendl;
+    } else if (*n > 1) {
+      const auto count = listeners.size();
+      auto l = listeners.begin();
+      for (size_t j = 0; j < count; ++j, ++l) {
+        l->use_reuseport = true;
+        for (uint32_t k = 1; k < *n; ++k) {
+          auto& dup = listeners.emplace_back(context);
+          dup.endpoint = l->endpoint;
+          dup.use_ssl = l->use_ssl;
+          dup.use_nodelay = l->use_nodelay;
+          dup.use_reuseport = true;
+        }
+      }
+    }
+#else
+    lderr(ctx()) << "WARNING: so_reuseport is not supported on this platform"
+        << dendl;
+#endif
+  }
+
 
   bool socket_bound = false;
   // start listeners
@@ -723,6 +753,18 @@ int AsioFrontend::init()
     }
 
     l.acceptor.set_option(tcp::acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+    if (l.use_reuseport) {
+      using reuse_port = boost::asio::detail::socket_option::boolean<
+        SOL_SOCKET, SO_REUSEPORT>;
+      l.acceptor.set_option(reuse_port(true), ec);
+      if (ec) {
+        lderr(ctx()) << "failed to set SO_REUSEPORT socket option: "
+            << ec.message() << dendl;
+        return -ec.value();
+      }
+    }
+#endif
     l.acceptor.bind(l.endpoint, ec);
     if (ec) {
       lderr(ctx()) << "failed to bind address " << l.endpoint
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "common/armor.h"
+#include "common/lru_map.h"
 #include "common/utf8.h"
 #include "common/split.h"
 #include "include/timegm.h"
@@ -957,6 +958,25 @@ get_v4_signing_key(CephContext* const cct,
                    const std::string_view& secret_access_key,
                    const DoutPrefixProvider *dpp)
 {
+  // the key depends only on the secret and the credential scope, which
+  // changes once a day per region and service; cache it rather than
+  // running four HMACs per request
+  static const uint64_t cache_size =
+    cct->_conf.get_val<uint64_t>("rgw_s3_v4_signing_key_cache_size");
+  static lru_map<std::string, sha256_digest_t> cache(cache_size);
+  std::string cache_key;
+  if (cache_size > 0) {
+    cache_key.reserve(secret_access_key.size() + 1 + credential_scope.size());
+    cache_key.append(secret_access_key);
+    cache_key.push_back('\0');
+    cache_key.append(credential_scope);
+    sha256_digest_t signing_key;
+    if (cache.find(cache_key, signing_key)) {
+      ldpp_dout(dpp, 10) << "signing_k = " << signing_key << " (cached)" << dendl;
+      return signing_key;
+    }
+  }
+
   std::string_view date, region, service;
   std::tie(date, region, service) = parse_cred_scope(credential_scope);
 
@@ -974,6 +994,10 @@ get_v4_signing_key(CephContext* const cct,
   ldpp_dout(dpp, 10) << "service_k = " << service_k << dendl;
   ldpp_dout(dpp, 10) << "signing_k = " << signing_key << dendl;
 
+  if (cache_size > 0) {
+    auto k = signing_key;
+    cache.add(cache_key, k);
+  }
   return signing_key;
 }
 
@@ -4,6 +4,7 @@
 #include "rgw_cache.h"
 #include "rgw_perf_counters.h"
 
+#include <algorithm>
 #include <errno.h>
 
 #define dout_subsys ceph_subsys_rgw
@@ -12,14 +13,14 @@ using namespace std;
 
 int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cache_entry_info *cache_info)
 {
-
-  std::shared_lock rl{lock};
-  std::unique_lock wl{lock, std::defer_lock}; // may be promoted to write lock
+  Shard& shard = get_shard(name);
+  std::shared_lock rl{shard.lock};
+  std::unique_lock wl{shard.lock, std::defer_lock}; // may be promoted to write lock
   if (!enabled) {
     return -ENOENT;
   }
-  auto iter = cache_map.find(name);
-  if (iter == cache_map.end()) {
+  auto iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end()) {
     ldpp_dout(dpp, 10) << "cache get: name=" << name << " : miss" << dendl;
     if (perfcounter) {
       perfcounter->inc(l_rgw_cache_miss);
@@ -33,12 +34,12 @@ int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCa
     rl.unlock();
     wl.lock(); // write lock for expiration
     // check that wasn't already removed by other thread
-    iter = cache_map.find(name);
-    if (iter != cache_map.end()) {
+    iter = shard.cache_map.find(name);
+    if (iter != shard.cache_map.end()) {
       for (auto &kv : iter->second.chained_entries)
         kv.first->invalidate(kv.second);
-      remove_lru(name, iter->second.lru_iter);
-      cache_map.erase(iter);
+      remove_lru(shard, iter->second.lru_iter);
+      shard.cache_map.erase(iter);
     }
     if (perfcounter) {
       perfcounter->inc(l_rgw_cache_miss);
@@ -48,24 +49,10 @@ int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCa
 
   ObjectCacheEntry *entry = &iter->second;
 
-  if (lru_counter - entry->lru_promotion_ts > lru_window) {
-    ldpp_dout(dpp, 20) << "cache get: touching lru, lru_counter=" << lru_counter
-                   << " promotion_ts=" << entry->lru_promotion_ts << dendl;
-    rl.unlock();
-    wl.lock(); // write lock for touch_lru()
-    /* need to redo this because entry might have dropped off the cache */
-    iter = cache_map.find(name);
-    if (iter == cache_map.end()) {
-      ldpp_dout(dpp, 10) << "lost race! cache get: name=" << name << " : miss" << dendl;
-      if(perfcounter) perfcounter->inc(l_rgw_cache_miss);
-      return -ENOENT;
-    }
-
-    entry = &iter->second;
-    /* check again, we might have lost a race here */
-    if (lru_counter - entry->lru_promotion_ts > lru_window) {
-      touch_lru(dpp, name, *entry, iter->second.lru_iter);
-    }
+  // no lru reordering on a hit; the eviction sweep in touch_lru() looks
+  // at this bit instead
+  if (!entry->referenced.load(std::memory_order_relaxed)) {
+    entry->referenced.store(true, std::memory_order_relaxed);
   }
 
   ObjectCacheInfo& src = iter->second.info;
@@ -99,7 +86,21 @@ bool ObjectCache::chain_cache_entry(const DoutPrefixProvider *dpp,
                                     std::initializer_list<rgw_cache_entry_info*> cache_info_entries,
 				    RGWChainedCache::Entry *chained_entry)
 {
-  std::unique_lock l{lock};
+  // lock every shard involved, in shard order, so that none of the
+  // entries can be invalidated while we attach to them
+  std::vector<size_t> shard_idx;
+  shard_idx.reserve(cache_info_entries.size());
+  for (auto cache_info : cache_info_entries) {
+    shard_idx.push_back(&get_shard(cache_info->cache_locator) - shards.data());
+  }
+  std::sort(shard_idx.begin(), shard_idx.end());
+  shard_idx.erase(std::unique(shard_idx.begin(), shard_idx.end()),
+		  shard_idx.end());
+  std::vector<std::unique_lock<ceph::shared_mutex>> locks;
+  locks.reserve(shard_idx.size());
+  for (auto i : shard_idx) {
+    locks.emplace_back(shards[i].lock);
+  }
 
   if (!enabled) {
     return false;
@@ -111,6 +112,7 @@ bool ObjectCache::chain_cache_entry(const DoutPrefixProvider *dpp,
   for (auto cache_info : cache_info_entries) {
     ldpp_dout(dpp, 10) << "chain_cache_entry: cache_locator="
 		   << cache_info->cache_locator << dendl;
+    auto& cache_map = get_shard(cache_info->cache_locator).cache_map;
     auto iter = cache_map.find(cache_info->cache_locator);
     if (iter == cache_map.end()) {
       ldpp_dout(dpp, 20) << "chain_cache_entry: couldn't find cache locator" << dendl;
@@ -141,7 +143,8 @@ bool ObjectCache::chain_cache_entry(const DoutPrefixProvider *dpp,
 
 void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectCacheInfo& info, rgw_cache_entry_info *cache_info)
 {
-  std::unique_lock l{lock};
+  Shard& shard = get_shard(name);
+  std::unique_lock l{shard.lock};
 
   if (!enabled) {
     return;
@@ -150,11 +153,11 @@ void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectC
   ldpp_dout(dpp, 10) << "cache put: name=" << name << " info.flags=0x"
                  << std::hex << info.flags << std::dec << dendl;
 
-  auto [iter, inserted] = cache_map.emplace(name, ObjectCacheEntry{});
+  auto [iter, inserted] = shard.cache_map.try_emplace(name);
   ObjectCacheEntry& entry = iter->second;
   entry.info.time_added = ceph::coarse_mono_clock::now();
   if (inserted) {
-    entry.lru_iter = lru.end();
+    entry.lru_iter = shard.lru.end();
   }
   ObjectCacheInfo& target = entry.info;
 
@@ -163,7 +166,7 @@ void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectC
   entry.chained_entries.clear();
   entry.gen++;
 
-  touch_lru(dpp, name, entry, entry.lru_iter);
+  touch_lru(dpp, shard, name, entry);
 
   target.status = info.status;
 
@@ -218,14 +221,15 @@ void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectC
 // negative lookup. It must only invalidate.
 bool ObjectCache::invalidate_remove(const DoutPrefixProvider *dpp, const string& name)
 {
-  std::unique_lock l{lock};
+  Shard& shard = get_shard(name);
+  std::unique_lock l{shard.lock};
 
   if (!enabled) {
     return false;
   }
 
-  auto iter = cache_map.find(name);
-  if (iter == cache_map.end())
+  auto iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end())
     return false;
 
   ldpp_dout(dpp, 10) << "removing " << name << " from cache" << dendl;
@@ -235,16 +239,20 @@ bool ObjectCache::invalidate_remove(const DoutPrefixProvider *dpp, const string&
     kv.first->invalidate(kv.second);
   }
 
-  remove_lru(name, iter->second.lru_iter);
-  cache_map.erase(iter);
+  remove_lru(shard, iter->second.lru_iter);
+  shard.cache_map.erase(iter);
   return true;
 }
 
-void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, const string& name, ObjectCacheEntry& entry,
-			    std::list<string>::iterator& lru_iter)
+void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, Shard& shard,
+			    const string& name, ObjectCacheEntry& entry)
 {
-  while (lru_size > (size_t)cct->_conf->rgw_cache_lru_size) {
-    auto iter = lru.begin();
+  // CLOCK: the front of the list is the hand; entries hit since it last
+  // passed them get another trip around instead of being evicted
+  const size_t max_size = std::max<size_t>(
+    1, cct->_conf->rgw_cache_lru_size / shards.size());
+  while (shard.lru_size > max_size) {
+    auto iter = shard.lru.begin();
     if ((*iter).compare(name) == 0) {
       /*
        * if the entry we're touching happens to be at the lru end, don't remove it,
@@ -252,43 +260,42 @@ void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, const string& name, O
        */
       break;
     }
-    auto map_iter = cache_map.find(*iter);
+    auto map_iter = shard.cache_map.find(*iter);
+    if (map_iter != shard.cache_map.end() &&
+	map_iter->second.referenced.exchange(false, std::memory_order_relaxed)) {
+      shard.lru.splice(shard.lru.end(), shard.lru, iter);
+      continue;
+    }
     ldout(cct, 10) << "removing entry: name=" << *iter << " from cache LRU" << dendl;
-    if (map_iter != cache_map.end()) {
+    if (map_iter != shard.cache_map.end()) {
       ObjectCacheEntry& entry = map_iter->second;
       invalidate_lru(entry);
-      cache_map.erase(map_iter);
+      shard.cache_map.erase(map_iter);
     }
-    lru.pop_front();
-    lru_size--;
+    shard.lru.pop_front();
+    shard.lru_size--;
   }
 
-  if (lru_iter == lru.end()) {
-    lru.push_back(name);
-    lru_size++;
-    lru_iter--;
+  if (entry.lru_iter == shard.lru.end()) {
+    shard.lru.push_back(name);
+    shard.lru_size++;
+    entry.lru_iter--;
     ldpp_dout(dpp, 10) << "adding " << name << " to cache LRU end" << dendl;
   } else {
-    ldpp_dout(dpp, 10) << "moving " << name << " to cache LRU end" << dendl;
-    lru.erase(lru_iter);
-    lru.push_back(name);
-    lru_iter = lru.end();
-    --lru_iter;
+    ldpp_dout(dpp, 10) << "referencing " << name << " in cache LRU" << dendl;
+    entry.referenced.store(true, std::memory_order_relaxed);
   }
-
-  lru_counter++;
-  entry.lru_promotion_ts = lru_counter;
 }
 
-void ObjectCache::remove_lru(const string& name,
+void ObjectCache::remove_lru(Shard& shard,
 			     std::list<string>::iterator& lru_iter)
 {
-  if (lru_iter == lru.end())
+  if (lru_iter == shard.lru.end())
     return;
 
-  lru.erase(lru_iter);
-  lru_size--;
-  lru_iter = lru.end();
+  shard.lru.erase(lru_iter);
+  shard.lru_size--;
+  lru_iter = shard.lru.end();
 }
 
 void ObjectCache::invalidate_lru(ObjectCacheEntry& entry)
@@ -300,9 +307,19 @@ void ObjectCache::invalidate_lru(ObjectCacheEntry& entry)
   }
 }
 
+std::vector<std::unique_lock<ceph::shared_mutex>> ObjectCache::lock_all()
+{
+  std::vector<std::unique_lock<ceph::shared_mutex>> locks;
+  locks.reserve(shards.size());
+  for (auto& shard : shards) {
+    locks.emplace_back(shard.lock);
+  }
+  return locks;
+}
+
 void ObjectCache::set_enabled(bool status)
 {
-  std::unique_lock l{lock};
+  auto l = lock_all();
 
   enabled = status;
 
@@ -313,19 +330,18 @@ void ObjectCache::set_enabled(bool status)
 
 void ObjectCache::invalidate_all()
 {
-  std::unique_lock l{lock};
+  auto l = lock_all();
 
   do_invalidate_all();
 }
 
 void ObjectCache::do_invalidate_all()
 {
-  cache_map.clear();
-  lru.clear();
-
-  lru_size = 0;
-  lru_counter = 0;
-  lru_window = 0;
+  for (auto& shard : shards) {
+    shard.cache_map.clear();
+    shard.lru.clear();
+    shard.lru_size = 0;
+  }
 
   for (auto& cache : chained_cache) {
     cache->invalidate_all();
@@ -333,12 +349,12 @@ void ObjectCache::do_invalidate_all()
 }
 
 void ObjectCache::chain_cache(RGWChainedCache *cache) {
-  std::unique_lock l{lock};
+  auto l = lock_all();
   chained_cache.push_back(cache);
 }
 
 void ObjectCache::unchain_cache(RGWChainedCache *cache) {
-  std::unique_lock l{lock};
+  auto l = lock_all();
 
   auto iter = chained_cache.begin();
   for (; iter != chained_cache.end(); ++iter) {
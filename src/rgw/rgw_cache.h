@@ -3,10 +3,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <shared_mutex> // for std::shared_lock
 #include <string>
 #include <map>
 #include <unordered_map>
+#include <vector>
 #include "include/types.h"
 #include "include/utime.h"
 #include "include/ceph_assert.h"
@@ -152,20 +154,25 @@ public:
 struct ObjectCacheEntry {
   ObjectCacheInfo info;
   std::list<std::string>::iterator lru_iter;
-  uint64_t lru_promotion_ts;
+  // set by hits under the shared lock; an entry found referenced when
+  // the eviction sweep reaches it gets moved to the back instead
+  std::atomic<bool> referenced;
   uint64_t gen;
   std::vector<std::pair<RGWChainedCache *, std::string> > chained_entries;
 
-  ObjectCacheEntry() : lru_promotion_ts(0), gen(0) {}
+  ObjectCacheEntry() : referenced(false), gen(0) {}
 };
 
 class ObjectCache {
-  std::unordered_map<std::string, ObjectCacheEntry> cache_map;
-  std::list<std::string> lru;
-  unsigned long lru_size;
-  unsigned long lru_counter;
-  unsigned long lru_window;
-  ceph::shared_mutex lock = ceph::make_shared_mutex("ObjectCache");
+  // entries are spread over shards by name hash, each with its own lock
+  // and CLOCK list, so that hits on different names don't contend
+  struct Shard {
+    std::unordered_map<std::string, ObjectCacheEntry> cache_map;
+    std::list<std::string> lru;
+    unsigned long lru_size = 0;
+    ceph::shared_mutex lock = ceph::make_shared_mutex("ObjectCache::Shard");
+  };
+  std::vector<Shard> shards;
   CephContext *cct;
 
   std::vector<RGWChainedCache *> chained_cache;
@@ -173,15 +180,20 @@ class ObjectCache {
   bool enabled;
   ceph::timespan expiry;
 
-  void touch_lru(const DoutPrefixProvider *dpp, const std::string& name, ObjectCacheEntry& entry,
-		 std::list<std::string>::iterator& lru_iter);
-  void remove_lru(const std::string& name, std::list<std::string>::iterator& lru_iter);
+  Shard& get_shard(const std::string& name) {
+    return shards[std::hash<std::string>{}(name) % shards.size()];
+  }
+  std::vector<std::unique_lock<ceph::shared_mutex>> lock_all();
+
+  void touch_lru(const DoutPrefixProvider *dpp, Shard& shard,
+		 const std::string& name, ObjectCacheEntry& entry);
+  void remove_lru(Shard& shard, std::list<std::string>::iterator& lru_iter);
   void invalidate_lru(ObjectCacheEntry& entry);
 
   void do_invalidate_all();
 
 public:
-  ObjectCache() : lru_size(0), lru_counter(0), lru_window(0), cct(NULL), enabled(false) { }
+  ObjectCache() : shards(1), cct(NULL), enabled(false) { }
   ~ObjectCache();
   int get(const DoutPrefixProvider *dpp, const std::string& name, ObjectCacheInfo& bl, uint32_t mask, rgw_cache_entry_info *cache_info);
   std::optional<ObjectCacheInfo> get(const DoutPrefixProvider *dpp, const std::string& name) {
@@ -192,10 +204,13 @@ public:
 
   template<typename F>
   void for_each(const F& f) {
-    std::shared_lock l{lock};
-    if (enabled) {
+    for (auto& shard : shards) {
+      std::shared_lock l{shard.lock};
+      if (!enabled) {
+        return;
+      }
       auto now  = ceph::coarse_mono_clock::now();
-      for (const auto& [name, entry] : cache_map) {
+      for (const auto& [name, entry] : shard.cache_map) {
         if (expiry.count() && (now - entry.info.time_added) < expiry) {
           f(name, entry);
         }
@@ -205,9 +220,11 @@ public:
 
   void put(const DoutPrefixProvider *dpp, const std::string& name, ObjectCacheInfo& bl, rgw_cache_entry_info *cache_info);
   bool invalidate_remove(const DoutPrefixProvider *dpp, const std::string& name);
+  // called once at startup, before the cache is shared between threads
   void set_ctx(CephContext *_cct) {
     cct = _cct;
-    lru_window = cct->_conf->rgw_cache_lru_size / 2;
+    shards = std::vector<Shard>(std::max<uint64_t>(
+	1, cct->_conf.get_val<uint64_t>("rgw_cache_shards")));
     expiry = std::chrono::seconds(cct->_conf.get_val<uint64_t>(
 						"rgw_cache_expiry_interval"));
   }
@@ -10,6 +10,7 @@
 #include "json_spirit/json_spirit.h"
 #include "common/ceph_json.h"
 #include "common/Formatter.h"
+#include "common/lru_map.h"
 #include "common/versioned_variant.h"
 
 #include "rgw_op.h"
@@ -3237,7 +3238,25 @@ get_iam_policy_from_attr(CephContext* cct,
                          const std::string& tenant)
 {
   if (auto i = attrs.find(RGW_ATTR_IAM_POLICY); i != attrs.end()) {
-    return Policy(cct, &tenant, i->second.to_str(), false);
+    // the same bucket policy is re-read by every request to the bucket;
+    // keep the parsed form, keyed by tenant and policy text, so only
+    // changed policies get parsed again
+    static const uint64_t cache_size =
+      cct->_conf.get_val<uint64_t>("rgw_iam_policy_cache_size");
+    if (cache_size == 0) {
+      return Policy(cct, &tenant, i->second.to_str(), false);
+    }
+    static lru_map<std::string, std::shared_ptr<const Policy>> cache(cache_size);
+    std::string key = tenant;
+    key.push_back('\0');
+    key.append(i->second.c_str(), i->second.length());
+    std::shared_ptr<const Policy> p;
+    if (!cache.find(key, p)) {
+      // a parse failure throws and isn't cached
+      p = std::make_shared<const Policy>(cct, &tenant, i->second.to_str(), false);
+      cache.add(key, p);
+    }
+    return *p;
   } else {
     return boost::none;
   }
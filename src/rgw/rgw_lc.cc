@@ -21,6 +21,7 @@
 #include "common/split.h"
 #include <common/errno.h>
 #include "include/random.h"
+#include "common/Thread.h"
 #include "cls/lock/cls_lock_client.h"
 #include "rgw_perf_counters.h"
 #include "rgw_common.h"
@@ -372,6 +373,12 @@ public:
     list_params.prefix = prefix;
   }
 
+  // list only this bucket index shard; all versions of an object are
+  // on the same shard, so noncurrent accounting still holds
+  void set_shard(int shard_id) {
+    list_params.shard_id = shard_id;
+  }
+
   int init(const DoutPrefixProvider *dpp) {
     return fetch(dpp);
   }
@@ -841,7 +848,7 @@ class RGWLC::WorkPool
 {
   using TVector = ceph::containers::tiny_vector<WorkQ, 3>;
   TVector wqs;
-  uint64_t ix;
+  std::atomic<uint64_t> ix;
 
 public:
   WorkPool(RGWLC::LCWorker* wk, uint16_t n_threads, uint32_t qmax)
@@ -865,9 +872,9 @@ public:
     }
   }
 
+  // may be called from several shard listers at once
   void enqueue(WorkItem item) {
-    const auto tix = ix;
-    ix = (ix+1) % wqs.size();
+    const auto tix = ix++ % wqs.size();
     (wqs[tix]).enqueue(std::move(item));
   }
 
@@ -1830,39 +1837,90 @@ int RGWLC::bucket_lc_process(string& shard_id, LCWorker* worker,
       pre_marker = next_marker;
     }
 
-    LCObjsLister ol(driver, bucket.get());
-    ol.set_prefix(prefix_iter->first);
-
     if (! zone_check(op, zone)) {
       ldpp_dout(this, 7) << "LC rule not executable in " << zone->get_tier_type()
 			 << " zone, skipping" << dendl;
       continue;
     }
 
-    ret = ol.init(this);
-    if (ret < 0) {
-      if (ret == (-ENOENT))
-        return 0;
-      ldpp_dout(this, 0) << "ERROR: driver->list_objects():" << dendl;
-      return ret;
-    }
+    /* returns 1 if the interval budget expired, -ENOENT if there is
+     * nothing to list.  work items copy the LCOpRule, whose env refers
+     * to the lister, but only update() (called here) reads from it */
+    auto list_and_enqueue = [&](LCObjsLister& ol) -> int {
+      int r = ol.init(this);
+      if (r < 0) {
+	if (r != -ENOENT) {
+	  ldpp_dout(this, 0) << "ERROR: driver->list_objects():" << dendl;
+	}
+	return r;
+      }
 
-    op_env oenv(op, driver, worker, bucket.get(), ol);
-    LCOpRule orule(oenv);
-    orule.build(); // why can't ctor do it?
-    rgw_bucket_dir_entry* o{nullptr};
-    for (auto offset = 0; ol.get_obj(this, &o /* , fetch_barrier */); ++offset, ol.next()) {
-      orule.update();
-      std::tuple<LCOpRule, rgw_bucket_dir_entry> t1 = {orule, *o};
-      worker->workpool->enqueue(WorkItem{t1});
-      if ((offset % 100) == 0) {
-	if (worker_should_stop(stop_at, once)) {
-	  ldpp_dout(this, 5) << __func__ << " interval budget EXPIRED worker="
-			     << worker->ix << " bucket=" << bucket_name
-			     << dendl;
-	  return 0;
+      op_env oenv(op, driver, worker, bucket.get(), ol);
+      LCOpRule orule(oenv);
+      orule.build(); // why can't ctor do it?
+      rgw_bucket_dir_entry* o{nullptr};
+      for (auto offset = 0; ol.get_obj(this, &o /* , fetch_barrier */); ++offset, ol.next()) {
+	orule.update();
+	std::tuple<LCOpRule, rgw_bucket_dir_entry> t1 = {orule, *o};
+	worker->workpool->enqueue(WorkItem{t1});
+	if ((offset % 100) == 0) {
+	  if (worker_should_stop(stop_at, once)) {
+	    ldpp_dout(this, 5) << __func__ << " interval budget EXPIRED worker="
+			       << worker->ix << " bucket=" << bucket_name
+			       << dendl;
+	    return 1;
+	  }
 	}
       }
+      return 0;
+    };
+
+    const auto& index = bucket->get_info().layout.current_index.layout;
+    const uint32_t num_shards =
+      index.type == rgw::BucketIndexType::Normal ? index.normal.num_shards : 0;
+    const uint32_t n_listers = std::min<uint32_t>(
+      num_shards, std::max<int64_t>(
+	1, cct->_conf.get_val<int64_t>("rgw_lc_max_list_workers")));
+    if (n_listers > 1) {
+      /* a huge bucket would otherwise be listed by this one thread,
+       * however many workpool threads are waiting on it; let each
+       * lister claim the next unlisted index shard */
+      std::atomic<uint32_t> next_shard{0};
+      std::atomic<bool> stop{false};
+      std::atomic<int> list_ret{0};
+      std::vector<std::thread> listers;
+      for (uint32_t i = 0; i < n_listers; ++i) {
+	listers.push_back(make_named_thread("lc_list", [&] {
+	  uint32_t shard;
+	  while (!stop && (shard = next_shard++) < num_shards) {
+	    LCObjsLister ol(driver, bucket.get());
+	    ol.set_prefix(prefix_iter->first);
+	    ol.set_shard(shard);
+	    int r = list_and_enqueue(ol);
+	    if (r == 1) {
+	      stop = true;
+	    } else if (r < 0 && r != -ENOENT) {
+	      list_ret = r;
+	      stop = true;
+	    }
+	  }
+	}));
+      }
+      for (auto& t : listers) {
+	t.join();
+      }
+      if (stop) {
+	return list_ret;
+      }
+    } else {
+      LCObjsLister ol(driver, bucket.get());
+      ol.set_prefix(prefix_iter->first);
+      ret = list_and_enqueue(ol);
+      if (ret == 1 || ret == -ENOENT) {
+	return 0;
+      } else if (ret < 0) {
+	return ret;
+      }
     }
     worker->workpool->drain();
   }
@@ -821,7 +821,7 @@ int execute(
     }
 
     // execute the lua script
-    if (luaL_dostring(L, script.c_str()) != LUA_OK) {
+    if (dostring(L, script, s->cct->_conf->rgw_lua_bytecode_cache_size) != LUA_OK) {
       const std::string err(lua_tostring(L, -1));
       ldpp_dout(s, 1) << "Lua ERROR: " << err << dendl;
       rc = -1;
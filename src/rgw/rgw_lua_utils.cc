@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <list>
 #include <string>
 #include <lua.hpp>
 #include "common/ceph_context.h"
@@ -114,6 +116,42 @@ void* allocator(void* ud, void* ptr, std::size_t osize, std::size_t nsize) {
   return realloc(ptr, nsize);
 }
 
+static int bytecode_writer(lua_State* L, const void* p, size_t sz, void* ud) {
+  static_cast<std::string*>(ud)->append(static_cast<const char*>(p), sz);
+  return 0;
+}
+
+int dostring(lua_State* L, const std::string& script, std::size_t cache_size) {
+  // script text -> bytecode, most recently used first
+  thread_local std::list<std::pair<std::string, std::string>> bytecode_cache;
+
+  auto it = std::find_if(bytecode_cache.begin(), bytecode_cache.end(),
+      [&script](const auto& entry) { return entry.first == script; });
+  int rc;
+  if (it != bytecode_cache.end()) {
+    bytecode_cache.splice(bytecode_cache.begin(), bytecode_cache, it);
+    const auto& bytecode = it->second;
+    rc = luaL_loadbufferx(L, bytecode.data(), bytecode.size(),
+                          script.c_str(), "b");
+  } else {
+    rc = luaL_loadstring(L, script.c_str());
+    if (rc == LUA_OK && cache_size > 0) {
+      std::string bytecode;
+      // keep debug info so errors still carry line numbers
+      if (lua_dump(L, bytecode_writer, &bytecode, 0) == 0) {
+        bytecode_cache.emplace_front(script, std::move(bytecode));
+      }
+    }
+  }
+  while (bytecode_cache.size() > cache_size) {
+    bytecode_cache.pop_back();
+  }
+  if (rc != LUA_OK) {
+    return rc;
+  }
+  return lua_pcall(L, 0, LUA_MULTRET, 0);
+}
+
 // create new lua state together with its memory counter
 lua_State* newstate(int max_memory) {
   std::size_t* remaining_memory = nullptr;
@@ -84,7 +84,10 @@ class lua_state_guard {
   lua_State* get() { return state; }
 };
 
-int dostring(lua_State* L, const char* str);
+// load and run a script like luaL_dostring()
+// the compiled bytecode of the last "cache_size" scripts run on this thread
+// is kept, so that running the same script again skips the parser
+int dostring(lua_State* L, const std::string& script, std::size_t cache_size);
 
 // keys for the lua registry
 static constexpr const char* max_runtime_key = "runtimeguard_max_runtime";
@@ -11,6 +11,9 @@
 #include <string_view>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/asio/execution/context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/query.hpp>
 #include <boost/optional.hpp>
 #include <boost/utility/in_place_factory.hpp>
 #include <fmt/format.h>
@@ -18,6 +21,7 @@
 #include "include/scope_guard.h"
 #include "common/Clock.h"
 #include "common/armor.h"
+#include "common/async/completion.h"
 #include "common/async/spawn_throttle.h"
 #include "common/errno.h"
 #include "common/mime.h"
@@ -4229,6 +4233,80 @@ int RGWPutObj::get_lua_filter(std::unique_ptr<rgw::sal::DataProcessor>* filter,
   return 0;
 }
 
+namespace {
+
+/* Hashes PUT body chunks on another thread of the request's io_context,
+ * so the MD5 of one chunk overlaps with the filter chain and RADOS write
+ * of that chunk and with receiving the next one. Only one update is in
+ * flight at a time, so the chunks are hashed in order. Must be used from
+ * the request coroutine. */
+class OffloadedMD5 {
+  using Completion = ceph::async::Completion<void(boost::system::error_code)>;
+
+  MD5& hash;
+  boost::asio::yield_context yield;
+  boost::asio::io_context::executor_type worker;
+
+  ceph::mutex mutex = ceph::make_mutex("OffloadedMD5");
+  bool busy = false;
+  std::unique_ptr<Completion> completion;
+
+ public:
+  OffloadedMD5(MD5& hash, boost::asio::yield_context yield)
+    : hash(hash), yield(yield),
+      // request coroutines run on a strand of the frontend's io_context
+      worker(static_cast<boost::asio::io_context&>(
+          boost::asio::query(yield.get_executor(),
+                             boost::asio::execution::context)).get_executor())
+  {}
+
+  ~OffloadedMD5() {
+    wait();
+  }
+
+  void update(bufferlist bl) {
+    wait();
+    {
+      std::lock_guard l{mutex};
+      busy = true;
+    }
+    boost::asio::post(worker, [this, bl = std::move(bl)] {
+      for (const auto& ptr : bl.buffers()) {
+        hash.Update(reinterpret_cast<const unsigned char*>(ptr.c_str()),
+                    ptr.length());
+      }
+      std::unique_ptr<Completion> c;
+      {
+        std::lock_guard l{mutex};
+        busy = false;
+        c = std::move(completion);
+      }
+      // don't touch this past here: the coroutine may already be done
+      if (c) {
+        ceph::async::post(std::move(c), boost::system::error_code{});
+      }
+    });
+  }
+
+  // suspend until the update in flight, if any, has finished
+  void wait() {
+    std::unique_lock l{mutex};
+    if (!busy) {
+      return;
+    }
+    using Signature = void(boost::system::error_code);
+    boost::system::error_code ec;
+    boost::asio::async_initiate<boost::asio::yield_context, Signature>(
+        [this, &l] (auto handler) {
+          completion = Completion::create(yield.get_executor(),
+                                          std::move(handler));
+          l.unlock();
+        }, yield[ec]);
+  }
+};
+
+} // anonymous namespace
+
 void RGWPutObj::execute(optional_yield y)
 {
   char supplied_md5_bin[CEPH_CRYPTO_MD5_DIGESTSIZE + 1];
@@ -4491,6 +4569,12 @@ void RGWPutObj::execute(optional_yield y)
       filter = &*cksum_filter;
     }
   } /* !append */
+  // destroyed (and so drained) before hash
+  std::optional<OffloadedMD5> offloaded_md5;
+  if (need_calc_md5 && y) {
+    offloaded_md5.emplace(hash, y.get_yield_context());
+  }
+
   tracepoint(rgw_op, before_data_transfer, s->req_id.c_str());
   do {
     bufferlist data;
@@ -4515,7 +4599,10 @@ void RGWPutObj::execute(optional_yield y)
       break;
     }
 
-    if (need_calc_md5) {
+    if (offloaded_md5) {
+      // the filters only read the chunk's buffers, so share them
+      offloaded_md5->update(data);
+    } else if (need_calc_md5) {
       hash.Update((const unsigned char *)data.c_str(), data.length());
     }
 
@@ -4529,6 +4616,9 @@ void RGWPutObj::execute(optional_yield y)
     ofs += len;
   } while (len > 0);
   tracepoint(rgw_op, after_data_transfer, s->req_id.c_str(), ofs);
+  if (offloaded_md5) {
+    offloaded_md5->wait();
+  }
 
   // flush any data in filters
   op_ret = filter->process({}, ofs);
@@ -7395,9 +7485,10 @@ void RGWDeleteMultiObj::handle_individual_object(const rgw_obj_key& o, optional_
                           rgw::notify::ObjectRemovedDelete;
   std::unique_ptr<rgw::sal::Notification> res
           = driver->get_notification(obj.get(), s->src_object.get(), s, event_type, y);
-  op_ret = res->publish_reserve(dpp);
-  if (op_ret < 0) {
-    send_partial_response(o, false, "", op_ret);
+  // deletes run concurrently, so keep each one's result out of op_ret
+  int ret = res->publish_reserve(dpp);
+  if (ret < 0) {
+    send_partial_response(o, false, "", ret);
     return;
   }
 
@@ -7410,26 +7501,26 @@ void RGWDeleteMultiObj::handle_individual_object(const rgw_obj_key& o, optional_
   del_op->params.bucket_owner = s->bucket_owner.id;
   del_op->params.marker_version_id = version_id;
 
-  op_ret = del_op->delete_obj(dpp, y, rgw::sal::FLAG_LOG_OP);
-  if (op_ret == -ENOENT) {
-    op_ret = 0;
+  ret = del_op->delete_obj(dpp, y, rgw::sal::FLAG_LOG_OP);
+  if (ret == -ENOENT) {
+    ret = 0;
   }
       
-  if (auto ret = rgw::bucketlogging::log_record(driver, rgw::bucketlogging::LoggingType::Any, obj.get(), s, canonical_name(), etag, obj_size, this, y, true, false); ret < 0) {
+  if (auto log_ret = rgw::bucketlogging::log_record(driver, rgw::bucketlogging::LoggingType::Any, obj.get(), s, canonical_name(), etag, obj_size, this, y, true, false); log_ret < 0) {
     // don't reply with an error in case of failed delete logging
-    ldpp_dout(this, 5) << "WARNING: multi DELETE operation ignores bucket logging failure: " << ret << dendl;
+    ldpp_dout(this, 5) << "WARNING: multi DELETE operation ignores bucket logging failure: " << log_ret << dendl;
   }
 
-  if (op_ret == 0) {
+  if (ret == 0) {
     // send request to notification manager
-    int ret = res->publish_commit(dpp, obj_size, ceph::real_clock::now(), etag, version_id);
-    if (ret < 0) {
-      ldpp_dout(dpp, 1) << "ERROR: publishing notification failed, with error: " << ret << dendl;
-      // too late to rollback operation, hence op_ret is not set here
+    int notify_ret = res->publish_commit(dpp, obj_size, ceph::real_clock::now(), etag, version_id);
+    if (notify_ret < 0) {
+      ldpp_dout(dpp, 1) << "ERROR: publishing notification failed, with error: " << notify_ret << dendl;
+      // too late to rollback operation, hence ret is not set here
     }
   }
   
-  send_partial_response(o, del_op->result.delete_marker, del_op->result.version_id, op_ret);
+  send_partial_response(o, del_op->result.delete_marker, del_op->result.version_id, ret);
 }
 
 void RGWDeleteMultiObj::execute(optional_yield y)
@@ -7501,12 +7592,16 @@ void RGWDeleteMultiObj::execute(optional_yield y)
   const uint32_t max_aio = std::max<uint32_t>(1, s->cct->_conf->rgw_multi_obj_del_max_aio);
   auto group = ceph::async::spawn_throttle{y, max_aio};
 
+  // send the partial responses in batches rather than one write per key
+  constexpr int flush_threshold = 4096;
   for (const auto& key : multi_delete->objects) {
     group.spawn([this, &key] (boost::asio::yield_context yield) {
                   handle_individual_object(key, yield);
                 });
 
-    rgw_flush_formatter(s, s->formatter);
+    if (s->formatter->get_len() >= flush_threshold) {
+      rgw_flush_formatter(s, s->formatter);
+    }
   }
   group.wait();
 
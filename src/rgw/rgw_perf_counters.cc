@@ -24,9 +24,24 @@ void add_rgw_frontend_counters(PerfCountersBuilder *pcb) {
   pcb->add_u64(l_rgw_qlen, "qlen", "Queue length");
   pcb->add_u64(l_rgw_qactive, "qactive", "Active requests queue");
 
+  pcb->add_time_avg(l_rgw_auth_lat, "auth_lat", "Request authentication latency");
+  pcb->add_time_avg(l_rgw_init_lat, "init_lat", "Request bucket/object info and ACL load latency");
+  pcb->add_time_avg(l_rgw_perm_lat, "perm_lat", "Request permission (ACL and policy) check latency");
+  pcb->add_time_avg(l_rgw_exec_lat, "exec_lat", "Request execute latency");
+  pcb->add_time_avg(l_rgw_complete_lat, "complete_lat", "Request response completion latency");
+  pcb->add_time_avg(l_rgw_index_prepare_lat, "index_prepare_lat", "Bucket index prepare latency of object writes");
+  pcb->add_time_avg(l_rgw_head_write_lat, "head_write_lat", "Head object write latency of object writes");
+
   pcb->add_u64_counter(l_rgw_cache_hit, "cache_hit", "Cache hits");
   pcb->add_u64_counter(l_rgw_cache_miss, "cache_miss", "Cache miss");
 
+  pcb->add_u64_counter(l_rgw_d3n_cache_hit, "d3n_cache_hit", "D3N data cache hits");
+  pcb->add_u64_counter(l_rgw_d3n_cache_miss, "d3n_cache_miss", "D3N data cache misses");
+  pcb->add_u64_counter(l_rgw_d3n_cache_fill, "d3n_cache_fill", "D3N data cache chunks written");
+  pcb->add_time_avg(l_rgw_d3n_cache_fill_lat, "d3n_cache_fill_lat", "D3N data cache chunk write latency");
+  pcb->add_u64_counter(l_rgw_d3n_cache_admission_skip, "d3n_cache_admission_skip",
+		       "D3N data cache misses not written to the cache under rgw_d3n_l1_admission_misses");
+
   pcb->add_u64_counter(l_rgw_keystone_token_cache_hit, "keystone_token_cache_hit", "Keystone token cache hits");
   pcb->add_u64_counter(l_rgw_keystone_token_cache_miss, "keystone_token_cache_miss", "Keystone token cache miss");
 
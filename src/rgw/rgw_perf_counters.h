@@ -20,9 +20,23 @@ enum {
   l_rgw_qlen,
   l_rgw_qactive,
 
+  l_rgw_auth_lat,
+  l_rgw_init_lat,
+  l_rgw_perm_lat,
+  l_rgw_exec_lat,
+  l_rgw_complete_lat,
+  l_rgw_index_prepare_lat,
+  l_rgw_head_write_lat,
+
   l_rgw_cache_hit,
   l_rgw_cache_miss,
 
+  l_rgw_d3n_cache_hit,
+  l_rgw_d3n_cache_miss,
+  l_rgw_d3n_cache_fill,
+  l_rgw_d3n_cache_fill_lat,
+  l_rgw_d3n_cache_admission_skip,
+
   l_rgw_keystone_token_cache_hit,
   l_rgw_keystone_token_cache_miss,
 
@@ -6,6 +6,7 @@
 #include "common/WorkQueue.h"
 #include "include/scope_guard.h"
 
+#include <optional>
 #include <utility>
 #include "rgw_auth_registry.h"
 #include "rgw_dmclock_scheduler.h"
@@ -163,6 +164,19 @@ bool rate_limit(rgw::sal::Driver* driver, req_state* s) {
   return (limit_user || limit_bucket);
 }
 
+namespace {
+// records the time spent in one stage of request processing
+class StageTimer {
+  const int idx;
+  const ceph::mono_time start = ceph::mono_clock::now();
+public:
+  explicit StageTimer(int idx) : idx(idx) {}
+  ~StageTimer() {
+    perfcounter->tinc(idx, ceph::mono_clock::now() - start);
+  }
+};
+} // anonymous namespace
+
 int rgw_process_authenticated(RGWHandler_REST * const handler,
                               RGWOp *& op,
                               RGWRequest * const req,
@@ -171,6 +185,7 @@ int rgw_process_authenticated(RGWHandler_REST * const handler,
                               rgw::sal::Driver* driver,
                               const bool skip_retarget)
 {
+  std::optional<StageTimer> init_timer{std::in_place, l_rgw_init_lat};
   ldpp_dout(op, 2) << "init permissions" << dendl;
   int ret = handler->init_permissions(op, y);
   if (ret < 0) {
@@ -204,6 +219,7 @@ int rgw_process_authenticated(RGWHandler_REST * const handler,
   if (ret < 0) {
     return ret;
   }
+  init_timer.reset();
 
   ldpp_dout(op, 2) << "verifying op mask" << dendl;
   ret = op->verify_op_mask();
@@ -221,6 +237,7 @@ int rgw_process_authenticated(RGWHandler_REST * const handler,
 
   ldpp_dout(op, 2) << "verifying op permissions" << dendl;
   {
+    StageTimer timer{l_rgw_perm_lat};
     auto span = tracing::rgw::tracer.add_span("verify_permission", s->trace);
     std::swap(span, s->trace);
     ret = op->verify_permission(y);
@@ -251,6 +268,7 @@ int rgw_process_authenticated(RGWHandler_REST * const handler,
   }
   ldpp_dout(op, 2) << "executing" << dendl;
   {
+    StageTimer timer{l_rgw_exec_lat};
     auto span = tracing::rgw::tracer.add_span("execute", s->trace);
     std::swap(span, s->trace);
     op->execute(y);
@@ -258,7 +276,10 @@ int rgw_process_authenticated(RGWHandler_REST * const handler,
   }
 
   ldpp_dout(op, 2) << "completing" << dendl;
-  op->complete();
+  {
+    StageTimer timer{l_rgw_complete_lat};
+    op->complete();
+  }
 
   return 0;
 }
@@ -356,7 +377,10 @@ int process_request(const RGWProcessEnv& penv,
 
   try {
     ldpp_dout(op, 2) << "verifying requester" << dendl;
-    ret = op->verify_requester(*penv.auth_registry, yield);
+    {
+      StageTimer timer{l_rgw_auth_lat};
+      ret = op->verify_requester(*penv.auth_registry, yield);
+    }
     if (ret < 0) {
       dout(10) << "failed to authorize request" << dendl;
       abort_early(s, op, ret, handler, yield);
@@ -83,8 +83,10 @@ public:
     async_refcount->put_wait(); /* wait for all pending async requests to complete */
   }
 
+  /// if quota is given, expired stats may still be returned while an async
+  /// refresh is in flight, see rgw_quota_soft_check_ratio
   int get_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y,
-                const DoutPrefixProvider* dpp);
+                const DoutPrefixProvider* dpp, const RGWQuotaInfo* quota = nullptr);
   void adjust_stats(const rgw_owner& owner, rgw_bucket& bucket, int objs_delta, uint64_t added_bytes, uint64_t removed_bytes);
 
   void set_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs, const RGWStorageStats& stats);
@@ -141,8 +143,26 @@ void RGWQuotaCache<T>::set_stats(const rgw_owner& owner, const rgw_bucket& bucke
   map_add(owner, bucket, qs);
 }
 
+// true if stats are far enough below the quota that a stale copy can
+// decide the check
+static bool below_soft_limit(const RGWQuotaInfo& quota,
+                             const RGWStorageStats& stats, double ratio)
+{
+  if (quota.max_objects >= 0 &&
+      stats.num_objects > quota.max_objects * ratio) {
+    return false;
+  }
+  if (quota.max_size >= 0) {
+    const uint64_t used = quota.check_on_raw ? stats.size : stats.size_rounded;
+    if (used > quota.max_size * ratio) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template<class T>
-int RGWQuotaCache<T>::get_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y, const DoutPrefixProvider* dpp) {
+int RGWQuotaCache<T>::get_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y, const DoutPrefixProvider* dpp, const RGWQuotaInfo* quota) {
   RGWQuotaCacheStats qs;
   utime_t now = ceph_clock_now();
   if (map_find(owner, bucket, qs)) {
@@ -159,6 +179,22 @@ int RGWQuotaCache<T>::get_stats(const rgw_owner& owner, const rgw_bucket& bucket
       stats = qs.stats;
       return 0;
     }
+
+    /* past expiration, the above has started an async refresh (unless one
+     * is in flight already); rather than block on a synchronous fetch, keep
+     * using the cached stats for up to another ttl as long as they are well
+     * below the quota */
+    const double soft_ratio =
+      driver->ctx()->_conf.get_val<double>("rgw_quota_soft_check_ratio");
+    utime_t stale_limit = qs.expiration;
+    stale_limit += driver->ctx()->_conf->rgw_bucket_quota_ttl;
+    if (quota && soft_ratio > 0 && now < stale_limit &&
+        below_soft_limit(*quota, qs.stats, soft_ratio)) {
+      ldpp_dout(dpp, 20) << "using expired quota stats for bucket=" << bucket
+                         << " while they are refreshed" << dendl;
+      stats = qs.stats;
+      return 0;
+    }
   }
 
   int ret = fetch_stats_from_storage(owner, bucket, stats, y, dpp);
@@ -951,7 +987,8 @@ public:
     const DoutPrefix dp(driver->ctx(), dout_subsys, "rgw quota handler: ");
     if (quota.bucket_quota.enabled) {
       RGWStorageStats bucket_stats;
-      int ret = bucket_stats_cache.get_stats(owner, bucket, bucket_stats, y, &dp);
+      int ret = bucket_stats_cache.get_stats(owner, bucket, bucket_stats, y, &dp,
+                                             &quota.bucket_quota);
       if (ret < 0) {
         return ret;
       }
@@ -963,7 +1000,8 @@ public:
 
     if (quota.user_quota.enabled) {
       RGWStorageStats owner_stats;
-      int ret = owner_stats_cache.get_stats(owner, bucket, owner_stats, y, &dp);
+      int ret = owner_stats_cache.get_stats(owner, bucket, owner_stats, y, &dp,
+                                            &quota.user_quota);
       if (ret < 0) {
         return ret;
       }
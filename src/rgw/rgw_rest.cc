@@ -808,6 +808,26 @@ int dump_body(req_state* const s, /* const */ ceph::buffer::list& bl)
   return dump_body(s, bl.c_str(), bl.length());
 }
 
+/* Send bl[ofs, ofs + len) one segment at a time. Unlike bl.c_str(), this
+ * doesn't flatten (copy) a bufferlist made of several segments, as the
+ * object data handed to GET is. */
+int dump_body(req_state* const s, const ceph::buffer::list& bl,
+              const size_t ofs, const size_t len)
+{
+  size_t sent = 0;
+  auto p = bl.begin(ofs);
+  while (sent < len && !p.end()) {
+    const char* buf;
+    const size_t n = p.get_ptr_and_advance(len - sent, &buf);
+    const int r = dump_body(s, buf, n);
+    if (r < 0) {
+      return r;
+    }
+    sent += n;
+  }
+  return sent;
+}
+
 int dump_body(req_state* const s, const std::string& str)
 {
   return dump_body(s, str.c_str(), str.length());
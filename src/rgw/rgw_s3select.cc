@@ -703,14 +703,30 @@ int RGWSelectObj_ObjStore_S3::range_request(int64_t ofs, int64_t len, void* buff
 {
   //purpose: implementation for arrow::ReadAt, this may take several async calls.
   //send_response_date(call_back) accumulate buffer, upon completion control is back to ReadAt.
-  range_req_str = "bytes=" + std::to_string(ofs) + "-" + std::to_string(ofs+len-1);
+  if (buff && ofs >= m_requested_buffer_ofs &&
+      ofs + len <= m_requested_buffer_ofs + static_cast<int64_t>(requested_buffer.size())) {
+    //the parquet-reader issues many small reads (footer, page headers, narrow column chunks),
+    //serve them from the last range fetched rather than another RGWGetObj::execute() each
+    ldout(s->cct, 10) << "S3select: range-request served from read-ahead buffer, offset :" << ofs << " length :" << len << dendl;
+    memcpy(buff, requested_buffer.data() + (ofs - m_requested_buffer_ofs), len);
+    return len;
+  }
+  int64_t fetch_len = len;
+  if (buff) {
+    const int64_t readahead = s->cct->_conf->rgw_parquet_readahead_size;
+    const int64_t remaining = static_cast<int64_t>(get_obj_size()) - ofs;
+    fetch_len = std::max(len, std::min(readahead, remaining));
+  }
+  range_req_str = "bytes=" + std::to_string(ofs) + "-" + std::to_string(ofs+fetch_len-1);
   range_str = range_req_str.c_str();
   range_parsed = false;
   RGWGetObj::parse_range();
   requested_buffer.clear();
-  m_request_range = len;
-  m_aws_response_handler.update_processed_size(len);
-  ldout(s->cct, 10) << "S3select: calling execute(async):" << " request-offset :" << ofs << " request-length :" << len << " buffer size : " << requested_buffer.size() << dendl;
+  requested_buffer.reserve(buff ? fetch_len : 0);
+  m_requested_buffer_ofs = ofs;
+  m_request_range = fetch_len;
+  m_aws_response_handler.update_processed_size(fetch_len);
+  ldout(s->cct, 10) << "S3select: calling execute(async):" << " request-offset :" << ofs << " request-length :" << fetch_len << " buffer size : " << requested_buffer.size() << dendl;
   RGWGetObj::execute(y);
   if (buff) {
     memcpy(buff, requested_buffer.data(), len);
@@ -808,8 +824,9 @@ int RGWSelectObj_ObjStore_S3::parquet_processing(bufferlist& bl, off_t ofs, off_
       }
       append_in_callback += it.length();
       ldout(s->cct, 10) << "S3select: part " << part_no++ << " it.length() = " << it.length() << dendl;
-      requested_buffer.append(&(it)[0]+ofs, len);
     }
+    //ofs/len are relative to the whole bufferlist, not to each of its buffers
+    bl.begin(ofs).copy(len, requested_buffer);
     ldout(s->cct, 10) << "S3select:append_in_callback = " << append_in_callback << dendl;
     if (requested_buffer.size() < m_request_range) {
       ldout(s->cct, 10) << "S3select: need another round buffe-size: " << requested_buffer.size() << " request range length:" << m_request_range << dendl;
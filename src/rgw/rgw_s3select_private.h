@@ -228,6 +228,8 @@ private:
   //a request for range may satisfy by several calls to send_response_date;
   size_t m_request_range;
   std::string requested_buffer;
+  //object offset of requested_buffer, kept to serve later reads within it
+  int64_t m_requested_buffer_ofs = 0;
   std::string range_req_str;
   std::function<int(std::string&)> fp_result_header_format;
   std::function<int(std::string&)> fp_s3select_result_format;
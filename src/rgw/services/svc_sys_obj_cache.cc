@@ -2,6 +2,7 @@
 // vim: ts=8 sw=2 smarttab ft=cpp
 
 #include "common/admin_socket.h"
+#include "common/Thread.h"
 
 #include "svc_sys_obj_cache.h"
 #include "svc_zone.h"
@@ -55,15 +56,79 @@ int RGWSI_SysObj_Cache::do_start(optional_yield y, const DoutPrefixProvider *dpp
 
   notify_svc->register_watch_cb(cb.get());
 
+  auto interval = cct->_conf.get_val<std::chrono::milliseconds>(
+    "rgw_cache_notify_coalesce_interval");
+  if (interval.count() > 0) {
+    notify_thread = make_named_thread("rgw_cache_notify",
+				      &RGWSI_SysObj_Cache::notify_run, this,
+				      interval);
+  }
+
   return 0;
 }
 
 void RGWSI_SysObj_Cache::shutdown()
 {
+  if (notify_thread.joinable()) {
+    {
+      std::lock_guard l{pending_lock};
+      pending_stop = true;
+    }
+    pending_cond.notify_all();
+    notify_thread.join();
+  }
   asocket.shutdown();
   RGWSI_SysObj_Core::shutdown();
 }
 
+void RGWSI_SysObj_Cache::notify_run(std::chrono::milliseconds interval) noexcept
+{
+  const DoutPrefix dp(cct, dout_subsys, "rgw cache notify: ");
+  std::unique_lock l{pending_lock};
+  while (!pending_stop) {
+    pending_cond.wait_for(l, interval);
+    l.unlock();
+    flush_pending_updates(&dp);
+    l.lock();
+  }
+  l.unlock();
+  flush_pending_updates(&dp);
+}
+
+void RGWSI_SysObj_Cache::flush_pending_updates(const DoutPrefixProvider *dpp)
+{
+  size_t count;
+  {
+    std::lock_guard l{pending_lock};
+    count = pending_updates.size();
+  }
+  // only what was queued when we started; later updates wait for the
+  // next interval so they can still be coalesced
+  for (; count > 0; --count) {
+    std::lock_guard f{flush_lock};
+    std::string name;
+    RGWCacheNotifyInfo info;
+    info.op = UPDATE_OBJ;
+    {
+      std::lock_guard l{pending_lock};
+      auto i = pending_updates.begin();
+      if (i == pending_updates.end()) {
+	break;
+      }
+      name = i->first;
+      info.obj_info = std::move(i->second.info);
+      info.obj = std::move(i->second.obj);
+      pending_updates.erase(i);
+    }
+    // this thread only runs the notifies, so blocking is fine here
+    int r = notify_svc->distribute(dpp, name, info, null_yield);
+    if (r < 0) {
+      ldpp_dout(dpp, 0) << "ERROR: failed to distribute cache for "
+			<< info.obj << dendl;
+    }
+  }
+}
+
 static string normal_name(rgw_pool& pool, const std::string& oid) {
   std::string buf;
   buf.reserve(pool.name.size() + pool.ns.size() + oid.size() + 2);
@@ -455,6 +520,23 @@ int RGWSI_SysObj_Cache::distribute_cache(const DoutPrefixProvider *dpp,
                                          ObjectCacheInfo& obj_info, int op,
                                          optional_yield y)
 {
+  if (notify_thread.joinable()) {
+    if (op == UPDATE_OBJ) {
+      // peers pick up the content at the next flush; until then they
+      // keep serving what they have, as they would within
+      // rgw_cache_expiry_interval after a missed notify
+      std::lock_guard l{pending_lock};
+      pending_updates.insert_or_assign(normal_name,
+				       PendingUpdate{obj, obj_info});
+      return 0;
+    }
+    // an invalidation supersedes any update still waiting to be sent,
+    // and waits out one that is being sent
+    std::lock_guard f{flush_lock};
+    std::lock_guard l{pending_lock};
+    pending_updates.erase(normal_name);
+  }
+
   RGWCacheNotifyInfo info;
   info.op = op;
   info.obj_info = obj_info;
@@ -9,7 +9,9 @@
 
 #include "svc_sys_obj_core.h"
 
+#include <map>
 #include <shared_mutex> // for std::shared_lock
+#include <thread>
 
 class RGWSI_Notify;
 
@@ -27,6 +29,24 @@ class RGWSI_SysObj_Cache : public RGWSI_SysObj_Core
 
   std::shared_ptr<RGWSI_SysObj_Cache_CB> cb;
 
+  // with rgw_cache_notify_coalesce_interval set, UPDATE_OBJ notifies are
+  // held here and sent by notify_thread once per interval, one per name
+  // with its latest content
+  struct PendingUpdate {
+    rgw_raw_obj obj;
+    ObjectCacheInfo info;
+  };
+  ceph::mutex pending_lock = ceph::make_mutex("RGWSI_SysObj_Cache::pending_lock");
+  // held while a queued update is sent, so an invalidation can't be
+  // overtaken by an older update of the same name
+  ceph::mutex flush_lock = ceph::make_mutex("RGWSI_SysObj_Cache::flush_lock");
+  ceph::condition_variable pending_cond;
+  std::map<std::string, PendingUpdate> pending_updates;
+  bool pending_stop = false;
+  std::thread notify_thread;
+  void notify_run(std::chrono::milliseconds interval) noexcept;
+  void flush_pending_updates(const DoutPrefixProvider *dpp);
+
   void normalize_pool_and_obj(const rgw_pool& src_pool, const std::string& src_obj, rgw_pool& dst_pool, std::string& dst_obj);
 protected:
   void init(librados::Rados* rados_,
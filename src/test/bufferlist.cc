@@ -24,6 +24,8 @@
 #include <sys/uio.h>
 
 #include <iostream> // for std::cout
+#include <thread>
+#include <vector>
 
 #include "include/buffer.h"
 #include "include/buffer_raw.h"
@@ -2951,6 +2953,36 @@ TEST(BufferList, TestDirectAppend) {
   ASSERT_EQ(memcmp(bl.c_str(), correct, curpos), 0);
 }
 
+TEST(BufferList, PtrNodeReuse) {
+  // a freed node is handed out again by the next allocation on the thread
+  const void* first;
+  {
+    bufferlist bl;
+    bl.append("a", 1);
+    first = &bl.front();
+  }
+  {
+    bufferlist bl;
+    bl.append("b", 1);
+    EXPECT_EQ(first, &bl.front());
+  }
+  // nodes may be freed, and cached, on a thread other than the one that
+  // allocated them, including on threads that then exit with nodes cached
+  std::vector<bufferlist> lists(1000);
+  for (auto& bl : lists) {
+    bl.append("x", 1);
+    bl.append(buffer::create(8));
+  }
+  std::thread t([&lists] {
+    lists.clear();
+    bufferlist bl;
+    bl.append("y", 1);
+    EXPECT_EQ(1u, bl.length());
+  });
+  t.join();
+  EXPECT_TRUE(lists.empty());
+}
+
 TEST(BufferList, TestCopyAll) {
   const static size_t BIG_SZ = 10737414;
   std::shared_ptr <unsigned char> big(
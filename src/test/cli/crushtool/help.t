@@ -95,6 +95,8 @@
         [--min-rep n] [--max-rep n] [--num-rep n]
         [--pool-id n]      specifies pool id
         [--batches b]      split the CRUSH mapping into b > 1 rounds
+        [--threads n]      compute mappings with n threads (only when no
+                           per-mapping output is requested)
         [--weight|-w devno weight]
                            where weight is 0 to 1.0
         [--simulate]       simulate placements using a random
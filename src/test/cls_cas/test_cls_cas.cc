@@ -125,6 +125,53 @@ TEST_F(cls_cas, get_put)
   ASSERT_EQ(-ENOENT, ioctx.read(oid, t, 0, 0));
 }
 
+TEST_F(cls_cas, put_refs)
+{
+  bufferlist bl;
+  bl.append("my data");
+  string oid = "mychunk";
+  hobject_t ref1, ref2;
+  ref1.oid.name = "foo1";
+  ref2.oid.name = "foo2";
+  bufferlist t;
+
+  // ref1 x3, ref2 x1
+  for (int i = 0; i < 3; ++i) {
+    auto op = new_op();
+    cls_cas_chunk_create_or_get_ref(*op, ref1, bl);
+    ASSERT_EQ(0, ioctx.operate(oid, op));
+  }
+  {
+    auto op = new_op();
+    cls_cas_chunk_get_ref(*op, ref2);
+    ASSERT_EQ(0, ioctx.operate(oid, op));
+  }
+
+  // more than ref1 holds: nothing is dropped
+  {
+    auto op = new_op();
+    cls_cas_chunk_put_refs(*op, ref1, 4);
+    ASSERT_EQ(-ENOLINK, ioctx.operate(oid, op));
+  }
+  {
+    auto op = new_op();
+    cls_cas_chunk_put_refs(*op, ref1, 3);
+    ASSERT_EQ(0, ioctx.operate(oid, op));
+  }
+  ASSERT_EQ(bl.length(), ioctx.read(oid, t, 0, 0));
+  {
+    auto op = new_op();
+    cls_cas_chunk_put_ref(*op, ref1);
+    ASSERT_EQ(-ENOLINK, ioctx.operate(oid, op));
+  }
+  {
+    auto op = new_op();
+    cls_cas_chunk_put_refs(*op, ref2, 1);
+    ASSERT_EQ(0, ioctx.operate(oid, op));
+  }
+  ASSERT_EQ(-ENOENT, ioctx.read(oid, t, 0, 0));
+}
+
 TEST_F(cls_cas, wrong_put)
 {
   bufferlist bl;
@@ -28,6 +28,7 @@
 #include <mutex>
 #include <random>
 #include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "common/Thread.h"
@@ -140,6 +141,48 @@ TEST_F(ThrottleTest, get) {
 
 }
 
+TEST_F(ThrottleTest, contended) {
+  // gets and puts mostly take the lock-free path here; check that they
+  // never let more than max through and that nobody is left waiting
+  const int64_t throttle_max = 8;
+  const int nthreads = 32;
+  const int ops = 20000;
+  Throttle throttle(g_ceph_context, "throttle", throttle_max);
+  std::atomic<int64_t> in_flight = {0};
+  std::atomic<int64_t> peak = {0};
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nthreads; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < ops; ++j) {
+	int64_t c = 1 + (i + j) % 3;
+	if (j % 4 == 0) {
+	  if (!throttle.get_or_fail(c)) {
+	    continue;
+	  }
+	} else {
+	  throttle.get(c);
+	}
+	int64_t now = in_flight += c;
+	int64_t p = peak;
+	while (now > p && !peak.compare_exchange_weak(p, now));
+	in_flight -= c;
+	throttle.put(c);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  cout << nthreads << " threads: "
+       << nthreads * ops / elapsed.count() << " get/put pairs per second"
+       << std::endl;
+  ASSERT_LE(peak, throttle_max);
+  ASSERT_EQ(throttle.get_current(), 0);
+}
+
 TEST_F(ThrottleTest, get_or_fail) {
   {
     Throttle throttle(g_ceph_context, "throttle");
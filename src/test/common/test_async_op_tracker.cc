@@ -0,0 +1,112 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/AsyncOpTracker.h"
+#include "include/Context.h"
+
+TEST(AsyncOpTracker, wait_without_ops)
+{
+  AsyncOpTracker tracker;
+  ASSERT_TRUE(tracker.empty());
+
+  bool finished = false;
+  tracker.wait_for_ops(new LambdaContext([&finished](int) {
+    finished = true;
+  }));
+  ASSERT_TRUE(finished);
+}
+
+TEST(AsyncOpTracker, wait_for_pending_ops)
+{
+  AsyncOpTracker tracker;
+  tracker.start_op();
+  tracker.start_op();
+  ASSERT_FALSE(tracker.empty());
+
+  bool finished = false;
+  tracker.wait_for_ops(new LambdaContext([&finished](int) {
+    finished = true;
+  }));
+  ASSERT_FALSE(finished);
+
+  tracker.finish_op();
+  ASSERT_FALSE(finished);
+  tracker.finish_op();
+  ASSERT_TRUE(finished);
+  ASSERT_TRUE(tracker.empty());
+}
+
+TEST(AsyncOpTracker, concurrent_ops)
+{
+  AsyncOpTracker tracker;
+  // keep one op outstanding so the waiter can only fire once the
+  // workers are done
+  tracker.start_op();
+
+  std::atomic<int> finished = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&tracker] {
+      for (int j = 0; j < 100000; ++j) {
+	tracker.start_op();
+	tracker.finish_op();
+      }
+    });
+  }
+  tracker.wait_for_ops(new LambdaContext([&finished](int) {
+    ++finished;
+  }));
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(0, finished);
+
+  tracker.finish_op();
+  ASSERT_EQ(1, finished);
+  ASSERT_TRUE(tracker.empty());
+}
+
+TEST(AsyncOpTracker, destroy_from_waiter)
+{
+  // the waiter frees the tracker; finish_op() racing with it must not
+  // touch the tracker once the last op is gone
+  for (int i = 0; i < 1000; ++i) {
+    auto tracker = new AsyncOpTracker();
+    tracker->start_op();
+    std::atomic<bool> go = false;
+    std::thread t([tracker, &go] {
+      while (!go) {}
+      tracker->finish_op();
+    });
+    std::atomic<bool> finished = false;
+    go = true;
+    tracker->wait_for_ops(new LambdaContext([tracker, &finished](int) {
+      delete tracker;
+      finished = true;
+    }));
+    t.join();
+    ASSERT_TRUE(finished);
+  }
+}
+
+TEST(AsyncOpTracker, destroy_after_empty)
+{
+  for (int i = 0; i < 1000; ++i) {
+    auto tracker = new AsyncOpTracker();
+    tracker->start_op();
+    std::atomic<bool> go = false;
+    std::thread t([tracker, &go] {
+      while (!go) {}
+      tracker->finish_op();
+    });
+    go = true;
+    while (!tracker->empty()) {}
+    delete tracker;
+    t.join();
+  }
+}
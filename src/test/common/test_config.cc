@@ -263,6 +263,15 @@ TEST(md_config_t, set_val)
   }
 }
 
+TEST(md_config_t, get_val_key_whitespace)
+{
+  ConfigProxy conf{false};
+  auto expected = Option::size_t{256 << 20};
+  EXPECT_EQ(0, conf.set_val("mgr_osd_bytes", "256M", nullptr));
+  EXPECT_EQ(expected, conf.get_val<Option::size_t>("mgr_osd_bytes"));
+  EXPECT_EQ(expected, conf.get_val<Option::size_t>(" mgr_osd_bytes\t"));
+}
+
 TEST(Option, validation)
 {
   Option opt_int("foo", Option::TYPE_INT, Option::LEVEL_BASIC);
@@ -0,0 +1,57 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <gtest/gtest.h>
+
+#include "common/count_min_sketch.h"
+
+TEST(CountMinSketch, Disabled) {
+  decaying_count_min_sketch s;
+  ASSERT_FALSE(s.enabled());
+  s.insert(1);
+  ASSERT_EQ(0u, s.estimate(1));
+  ASSERT_EQ(0u, s.get_memory_usage());
+}
+
+TEST(CountMinSketch, NeverUndercounts) {
+  decaying_count_min_sketch s(4, 1024, 0);
+  for (uint32_t k = 0; k < 4096; ++k) {
+    for (uint32_t i = 0; i < k % 7; ++i) {
+      s.insert(k);
+    }
+  }
+  for (uint32_t k = 0; k < 4096; ++k) {
+    ASSERT_GE(s.estimate(k), k % 7);
+  }
+}
+
+TEST(CountMinSketch, HotKeysStandOut) {
+  // keys sharing their low bits, as objects in one PG do
+  decaying_count_min_sketch s(4, 4096, 0);
+  for (uint32_t k = 0; k < 10000; ++k) {
+    s.insert(k << 8 | 0x2a);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    s.insert(0xdead002a);
+  }
+  ASSERT_GE(s.estimate(0xdead002a), 1000u);
+  unsigned cold_over = 0;
+  for (uint32_t k = 0; k < 10000; ++k) {
+    if (s.estimate(k << 8 | 0x2a) > 10) {
+      ++cold_over;
+    }
+  }
+  ASSERT_LT(cold_over, 100u);
+}
+
+TEST(CountMinSketch, Decay) {
+  decaying_count_min_sketch s(2, 64, 100);
+  for (int i = 0; i < 99; ++i) {
+    s.insert(7);
+  }
+  ASSERT_EQ(99u, s.estimate(7));
+  s.insert(7);
+  ASSERT_EQ(50u, s.estimate(7));
+  s.clear();
+  ASSERT_EQ(0u, s.estimate(7));
+}
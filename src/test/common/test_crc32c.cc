@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <string.h>
+#include <vector>
 
 #include "include/types.h"
 #include "include/crc32c.h"
@@ -165,6 +166,47 @@ static uint32_t crc_check_table[] = {
 0xf8eafea1, 0xfe36fdae, 0xb4b546f1, 0x2e27ce89, 0xc1fde8a0, 0x99f2f157, 0xfde687a1, 0x40a75f50,
 0x6c653330, 0xf3e38821, 0xf4663e43, 0x2f7e801e, 0xfca360af, 0x53cd3c59, 0xd20da292, 0x812a0241 };
 
+TEST(Crc32c, Multi) {
+  const unsigned max_count = 11;
+  const unsigned max_chunk = 4100;
+  std::vector<unsigned char> data(max_count * max_chunk);
+  for (auto& c : data)
+    c = rand();
+  uint32_t out[max_count];
+  for (unsigned chunk_len : {1u, 7u, 8u, 61u, 512u, 4093u, 4096u}) {
+    for (unsigned count = 0; count <= max_count; count++) {
+      uint32_t crc = rand();
+      ceph_crc32c_multi(crc, data.data(), chunk_len, count, out);
+      for (unsigned i = 0; i < count; i++) {
+	ASSERT_EQ(ceph_crc32c(crc, data.data() + i * chunk_len, chunk_len), out[i])
+	  << "chunk_len " << chunk_len << " count " << count << " chunk " << i;
+      }
+    }
+  }
+}
+
+TEST(Crc32c, multi_performance) {
+  const size_t len = 256 * 1024 * 1024;
+  std::vector<unsigned char> data(len);
+  for (size_t i = 0; i < len; i++)
+    data[i] = i & 0xff;
+  for (unsigned chunk_len : {512u, 4096u, 65536u}) {
+    unsigned count = len / chunk_len;
+    std::vector<uint32_t> a(count), b(count);
+    utime_t start = ceph_clock_now();
+    for (unsigned i = 0; i < count; i++)
+      a[i] = ceph_crc32c(-1, data.data() + (size_t)i * chunk_len, chunk_len);
+    utime_t mid = ceph_clock_now();
+    ceph_crc32c_multi(-1, data.data(), chunk_len, count, b.data());
+    utime_t end = ceph_clock_now();
+    std::cout << "chunk " << chunk_len
+	      << " per-chunk loop = " << (double)len / (1024*1024) / (double)(mid - start)
+	      << " MB/sec, multi = " << (double)len / (1024*1024) / (double)(end - mid)
+	      << " MB/sec" << std::endl;
+    ASSERT_EQ(a, b);
+  }
+}
+
 TEST(Crc32c, Range) {
   int len = sizeof(crc_check_table) / sizeof(crc_check_table[0]);
   unsigned char *b = (unsigned char *)malloc(len);
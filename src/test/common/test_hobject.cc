@@ -17,6 +17,28 @@ TEST(HObject, cmp)
   ASSERT_EQ(-1, cmp(d, e));
 }
 
+TEST(HObject, eq_matches_cmp)
+{
+  std::vector<hobject_t> objs = {
+    hobject_t{},
+    hobject_t{hobject_t::get_max()},
+    hobject_t{object_t{"fooc"}, "food", CEPH_NOSNAP, 42, 0, "nspace"},
+    hobject_t{object_t{"food"}, "",     CEPH_NOSNAP, 42, 0, "nspace"},
+    hobject_t{object_t{"food"}, "",     1,           42, 0, "nspace"},
+    hobject_t{object_t{"food"}, "",     CEPH_NOSNAP, 43, 0, "nspace"},
+    hobject_t{object_t{"food"}, "",     CEPH_NOSNAP, 42, 1, "nspace"},
+    hobject_t{object_t{"food"}, "",     CEPH_NOSNAP, 42, 0, "other"},
+    hobject_t{object_t{"food"}, "key",  CEPH_NOSNAP, 42, 0, "nspace"},
+  };
+  for (const auto& l : objs) {
+    for (const auto& r : objs) {
+      EXPECT_EQ(cmp(l, r) == 0, l == r) << l << " vs " << r;
+      EXPECT_EQ((l <=> r) == 0, l == r) << l << " vs " << r;
+    }
+    EXPECT_EQ(l, hobject_t{l});
+  }
+}
+
 // ---- test methods that 'stringify' the object while escaping special characters ----
 
 
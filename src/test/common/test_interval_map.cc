@@ -18,6 +18,7 @@
 #include <boost/mpl/apply.hpp>
 #include "include/buffer.h"
 #include "common/interval_map.h"
+#include "include/btree_map.h"
 
 using namespace std;
 
@@ -27,10 +28,13 @@ public:
   using TestType = T;
 };
 
-template <typename _key>
+template <typename _key,
+	  template<typename, typename, typename ...> class _C = std::map>
 struct bufferlist_test_type {
   using key = _key;
   using value = bufferlist;
+  template <typename K, typename V, typename S>
+  using map_type = interval_map<K, V, S, _C>;
 
   struct make_splitter {
     template <typename merge_t>
@@ -70,7 +74,9 @@ struct bufferlist_test_type {
   };
 };
 
-using IntervalMapTypes = ::testing::Types< bufferlist_test_type<uint64_t> >;
+using IntervalMapTypes = ::testing::Types<
+  bufferlist_test_type<uint64_t>,
+  bufferlist_test_type<uint64_t, btree::btree_map> >;
 
 TYPED_TEST_SUITE(IntervalMapTest, IntervalMapTypes);
 
@@ -81,7 +87,8 @@ TYPED_TEST_SUITE(IntervalMapTest, IntervalMapTypes);
   using splitter = typename boost::mpl::apply<                   \
     typename TT::make_splitter,                                  \
     _can_merge>;                                                 \
-  using imap = interval_map<key, val, splitter>; (void)imap();	 \
+  using imap = typename TT::template map_type<key, val, splitter>; \
+  (void)imap();							 \
   typename TT::generate_random gen;                              \
   val v(gen(5));	                                         \
   splitter split; (void)split.split(0, 0, v);
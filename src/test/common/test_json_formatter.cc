@@ -126,3 +126,17 @@ TEST(formatter, dump_large_item) {
   EXPECT_TRUE(parser.parse(bl.c_str(), bl.length()));
   EXPECT_EQ(parser.find_obj("Location")->get_data(), full_url);
 }
+
+TEST(formatter, dump_ints_and_escapes) {
+  JSONFormatter formatter;
+  formatter.open_object_section("obj");
+  formatter.dump_unsigned("u", std::numeric_limits<uint64_t>::max());
+  formatter.dump_int("s", std::numeric_limits<int64_t>::min());
+  formatter.dump_string("str", "a\"b\\c\td\ne\x01");
+  formatter.close_section();
+  std::stringstream ss;
+  formatter.flush(ss);
+  EXPECT_EQ(ss.str(),
+	    "{\"u\":18446744073709551615,\"s\":-9223372036854775808,"
+	    "\"str\":\"a\\\"b\\\\c\\td\\ne\\u0001\"}");
+}
@@ -355,6 +355,31 @@ TEST_F(SharedLRU_all, clear_all) {
   ASSERT_FALSE(cache.empty());
 }
 
+TEST_F(SharedLRU_all, lookup_lru) {
+  const size_t SIZE = 2;
+  SharedLRUTest cache;
+  cache.set_size(SIZE);
+  cache.add(0, new int(0));
+  cache.add(1, new int(1));
+  // hits served from the lru still refresh its order
+  ASSERT_EQ(0, *cache.lookup(0));
+  cache.add(2, new int(2));
+  ASSERT_TRUE(cache.lookup(0).get());
+  ASSERT_FALSE(cache.lookup(1));
+  ASSERT_EQ(0, *cache.lookup_or_create(0));
+  cache.add(3, new int(3));
+  ASSERT_TRUE(cache.lookup(0).get());
+  ASSERT_FALSE(cache.lookup(2));
+
+  // a purged key is not found through the lru
+  std::shared_ptr<int> ptr = cache.lookup(0);
+  cache.purge(0);
+  ASSERT_FALSE(cache.lookup(0));
+  std::shared_ptr<int> ptr2 = cache.lookup_or_create(0);
+  ASSERT_NE(ptr, ptr2);
+  ASSERT_EQ(ptr2, cache.lookup(0));
+}
+
 TEST(SharedCache_all, add) {
   SharedLRU<int, int> cache;
   unsigned int key = 1;
@@ -0,0 +1,137 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "common/Formatter.h"
+#include "common/TrackedOp.h"
+#include "global/global_context.h"
+#include "json_spirit/json_spirit.h"
+
+namespace {
+
+TrackedOpTimeline make_timeline(uint32_t queued, uint32_t started,
+				uint32_t done)
+{
+  TrackedOpTimeline t;
+  t.stage_us[0] = queued;
+  t.stage_us[1] = started;
+  t.done_us = done;
+  return t;
+}
+
+json_spirit::mObject dump(OpTracker& tracker)
+{
+  JSONFormatter f;
+  tracker.dump_ops_timeline(&f);
+  std::ostringstream ss;
+  f.flush(ss);
+  json_spirit::mValue v;
+  EXPECT_TRUE(json_spirit::read(ss.str(), v));
+  return v.get_obj();
+}
+
+void expect_stage(json_spirit::mValue& v, const std::string& name,
+		  uint64_t count, uint64_t p50, uint64_t p90, uint64_t p99,
+		  uint64_t max)
+{
+  auto& o = v.get_obj();
+  EXPECT_EQ(name, o["stage"].get_str());
+  EXPECT_EQ(count, o["count"].get_uint64());
+  EXPECT_EQ(p50, o["p50_us"].get_uint64());
+  EXPECT_EQ(p90, o["p90_us"].get_uint64());
+  EXPECT_EQ(p99, o["p99_us"].get_uint64());
+  EXPECT_EQ(max, o["max_us"].get_uint64());
+}
+
+} // anonymous namespace
+
+TEST(OpTracker, should_sample_timeline)
+{
+  OpTracker tracker(g_ceph_context, false, 1);
+
+  unsigned sampled = 0;
+  for (int i = 0; i < 8; ++i) {
+    sampled += tracker.should_sample_timeline();
+  }
+  ASSERT_EQ(0u, sampled);
+
+  tracker.set_timeline(4, 16);
+  for (int i = 0; i < 8; ++i) {
+    sampled += tracker.should_sample_timeline();
+  }
+  ASSERT_EQ(2u, sampled);
+
+  // each thread keeps its own count
+  unsigned other_sampled = 0;
+  std::thread t([&] {
+    for (int i = 0; i < 8; ++i) {
+      other_sampled += tracker.should_sample_timeline();
+    }
+  });
+  t.join();
+  ASSERT_EQ(2u, other_sampled);
+
+  // a zero sized ring disables sampling
+  tracker.set_timeline(4, 0);
+  sampled = 0;
+  for (int i = 0; i < 8; ++i) {
+    sampled += tracker.should_sample_timeline();
+  }
+  ASSERT_EQ(0u, sampled);
+}
+
+TEST(OpTracker, dump_ops_timeline_empty)
+{
+  OpTracker tracker(g_ceph_context, false, 1);
+  tracker.set_timeline(10, 4);
+
+  auto o = dump(tracker);
+  ASSERT_EQ(10u, o["sample_interval"].get_uint64());
+  ASSERT_EQ(0u, o["num_samples"].get_uint64());
+  ASSERT_TRUE(o["stages"].get_array().empty());
+}
+
+TEST(OpTracker, dump_ops_timeline)
+{
+  OpTracker tracker(g_ceph_context, false, 1);
+  tracker.set_timeline(1, 4);
+  tracker.set_timeline_stage_names({"queued", "started"});
+
+  // pushed out of the ring by the four below
+  tracker.record_timeline(make_timeline(1000000, 2000000, 3000000));
+  for (uint32_t i = 1; i <= 4; ++i) {
+    tracker.record_timeline(make_timeline(10 * i, 10 * i + 100,
+					  11 * i + 100));
+  }
+
+  auto o = dump(tracker);
+  ASSERT_EQ(1u, o["sample_interval"].get_uint64());
+  ASSERT_EQ(4u, o["num_samples"].get_uint64());
+  auto& stages = o["stages"].get_array();
+  // stages no sample reached are left out
+  ASSERT_EQ(4u, stages.size());
+  expect_stage(stages[0], "queued", 4, 20, 30, 30, 40);
+  expect_stage(stages[1], "started", 4, 100, 100, 100, 100);
+  expect_stage(stages[2], "done", 4, 2, 3, 3, 4);
+  expect_stage(stages[3], "total", 4, 122, 133, 133, 144);
+}
+
+TEST(OpTracker, dump_ops_timeline_resize)
+{
+  OpTracker tracker(g_ceph_context, false, 1);
+  tracker.set_timeline(1, 4);
+  tracker.record_timeline(make_timeline(10, 20, 30));
+  ASSERT_EQ(1u, dump(tracker)["num_samples"].get_uint64());
+
+  // changing the ring size drops what was sampled so far
+  tracker.set_timeline(1, 8);
+  ASSERT_EQ(0u, dump(tracker)["num_samples"].get_uint64());
+
+  // changing only the interval keeps it
+  tracker.record_timeline(make_timeline(10, 20, 30));
+  tracker.set_timeline(2, 8);
+  ASSERT_EQ(1u, dump(tracker)["num_samples"].get_uint64());
+}
@@ -143,6 +143,35 @@ TEST_P(CompressorTest, big_round_trip_randomish)
        << " with " << GetParam() << std::endl;
 }
 
+TEST_P(CompressorTest, decompress_prefix)
+{
+  unsigned len = 1048576;
+  bufferlist orig;
+  const char *alphabet = "abcdefghijklmnopqrstuvwxyz";
+  bufferptr bp(len);
+  char *p = bp.c_str();
+  for (unsigned i=0; i<len; ++i) {
+    p[i] = alphabet[rand() % 10];
+  }
+  orig.append(bp);
+  bufferlist compressed;
+  std::optional<int32_t> compressor_message;
+  int r = compressor->compress(orig, compressed, compressor_message);
+  ASSERT_EQ(0, r);
+  for (size_t want : {size_t(1), size_t(4096), size_t(len / 3), size_t(len)}) {
+    bufferlist decompressed;
+    auto i = compressed.cbegin();
+    r = compressor->decompress_prefix(i, compressed.length(), want,
+                                      decompressed, compressor_message);
+    ASSERT_EQ(0, r);
+    ASSERT_GE(decompressed.length(), want);
+    ASSERT_LE(decompressed.length(), orig.length());
+    bufferlist expected;
+    expected.substr_of(orig, 0, decompressed.length());
+    ASSERT_TRUE(decompressed.contents_equal(expected));
+  }
+}
+
 #if 0
 TEST_P(CompressorTest, big_round_trip_file)
 {
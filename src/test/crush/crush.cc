@@ -1555,3 +1555,20 @@ TEST_F(CRUSHTest, msr_multi_root) {
     }
   }
 }
+
+TEST(CRUSHHash, hash32_3_multi) {
+  std::vector<__s32> ids;
+  for (int i = -40; i < 60; ++i) {
+    ids.push_back(i * 7919);
+  }
+  std::vector<__u32> out(ids.size());
+  for (__u32 x : {0u, 1u, 12345u, 0xffffffffu}) {
+    for (__u32 r : {0u, 3u}) {
+      crush_hash32_3_multi(CRUSH_HASH_RJENKINS1, x, ids.data(), r,
+			   out.data(), ids.size());
+      for (unsigned i = 0; i < ids.size(); ++i) {
+	ASSERT_EQ(crush_hash32_3(CRUSH_HASH_RJENKINS1, x, ids[i], r), out[i]);
+      }
+    }
+  }
+}
@@ -158,6 +158,33 @@ TEST(ErasureCodeTest, encode_misaligned_non_contiguous)
   }
 }
 
+TEST(ErasureCodeTest, minimum_to_decode_with_cost)
+{
+  ErasureCodeTest erasure_code(2, 2, 8);
+  set<int> want_to_read = { 0 };
+  set<int> minimum;
+  // chunk 0 is missing, 2 is the most expensive to get
+  map<int, int> available = { {1, 1}, {2, 9}, {3, 1} };
+  EXPECT_EQ(0, erasure_code.minimum_to_decode_with_cost(want_to_read,
+							 available,
+							 &minimum));
+  EXPECT_EQ(set<int>({1, 3}), minimum);
+
+  // same cost everywhere: lowest chunk indexes first
+  minimum.clear();
+  available = { {1, 0}, {2, 0}, {3, 0} };
+  EXPECT_EQ(0, erasure_code.minimum_to_decode_with_cost(want_to_read,
+							 available,
+							 &minimum));
+  EXPECT_EQ(set<int>({1, 2}), minimum);
+
+  minimum.clear();
+  available = { {3, 0} };
+  EXPECT_EQ(-EIO, erasure_code.minimum_to_decode_with_cost(want_to_read,
+							    available,
+							    &minimum));
+}
+
 /*
  * Local Variables:
  * compile-command: "cd ../.. ;
@@ -0,0 +1,116 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph distributed storage system
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ */
+
+// SUMMARY: encode_delta/apply_delta against a full re-encode, for every
+// plugin and technique that supports parity-delta updates
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include "acconfig.h"
+#include "erasure-code/ErasureCodePlugin.h"
+#include "global/global_context.h"
+#include "common/config_proxy.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+struct DeltaParam {
+  const char *plugin;
+  const char *technique;
+};
+
+static const DeltaParam delta_params[] = {
+  { "jerasure", "reed_sol_van" },
+  { "jerasure", "reed_sol_r6_op" },
+#ifdef WITH_EC_ISA_PLUGIN
+  { "isa", "reed_sol_van" },
+  { "isa", "cauchy" },
+#endif
+};
+
+class ErasureCodeDeltaTest : public ::testing::TestWithParam<DeltaParam> {
+};
+
+TEST_P(ErasureCodeDeltaTest, apply_delta)
+{
+  ErasureCodePluginRegistry &instance = ErasureCodePluginRegistry::instance();
+  ErasureCodeProfile profile;
+  profile["technique"] = GetParam().technique;
+  profile["k"] = "4";
+  profile["m"] = "2";
+  ErasureCodeInterfaceRef erasure_code;
+  ASSERT_EQ(0, instance.factory(GetParam().plugin,
+				g_conf().get_val<std::string>("erasure_code_dir"),
+				profile,
+				&erasure_code, &cerr));
+  ASSERT_TRUE(erasure_code.get());
+  unsigned k = erasure_code->get_data_chunk_count();
+  unsigned n = erasure_code->get_chunk_count();
+
+  unsigned object_size = k * erasure_code->get_chunk_size(k * 4096);
+  bufferlist before;
+  for (unsigned i = 0; i < object_size; i++)
+    before.append((char)(i * 7));
+  set<int> want_to_encode;
+  for (unsigned i = 0; i < n; i++)
+    want_to_encode.insert(i);
+  map<int,bufferlist> encoded;
+  EXPECT_EQ(0, erasure_code->encode(want_to_encode, before, &encoded));
+
+  // overwrite a range in the middle of the second data chunk
+  unsigned chunk_size = encoded[0].length();
+  unsigned off = chunk_size / 4, len = chunk_size / 2;
+  string change(len, 'Z');
+  bufferlist after;
+  after.substr_of(before, 0, chunk_size + off);
+  after.append(change);
+  bufferlist tail;
+  tail.substr_of(before, chunk_size + off + len,
+		 object_size - chunk_size - off - len);
+  after.append(tail);
+  map<int,bufferlist> reencoded;
+  EXPECT_EQ(0, erasure_code->encode(want_to_encode, after, &reencoded));
+
+  bufferlist old_data, new_data;
+  old_data.substr_of(encoded[1], off, len);
+  new_data.append(change);
+  map<int,bufferlist> in;
+  erasure_code->encode_delta(old_data, new_data, &in[1]);
+  map<int,bufferlist> parity;
+  for (unsigned i = k; i < n; i++) {
+    parity[i].substr_of(encoded[i], off, len);
+    parity[i].rebuild();
+  }
+  EXPECT_EQ(0, erasure_code->apply_delta(in, &parity));
+  for (unsigned i = k; i < n; i++) {
+    bufferlist expected;
+    expected.substr_of(reencoded[i], off, len);
+    EXPECT_TRUE(expected.contents_equal(parity[i]));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Plugins, ErasureCodeDeltaTest,
+			 ::testing::ValuesIn(delta_params),
+			 [](const ::testing::TestParamInfo<DeltaParam>& info) {
+			   return string(info.param.plugin) + "_" +
+			     info.param.technique;
+			 });
+
+/*
+ * Local Variables:
+ * compile-command: "cd ../.. ; make -j4 &&
+ *   make unittest_erasure_code_delta &&
+ *   valgrind --tool=memcheck ./unittest_erasure_code_delta \
+ *      --gtest_filter=*.* --log-to-stderr=true --debug-osd=20"
+ * End:
+ */
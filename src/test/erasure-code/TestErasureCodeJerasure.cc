@@ -305,6 +305,56 @@ TEST(ErasureCodeTest, encode)
   }
 }
 
+TEST(ErasureCodeTest, apply_delta_unsupported)
+{
+  ErasureCodeJerasureCauchyGood jerasure;
+  ErasureCodeProfile profile;
+  profile["k"] = "2";
+  profile["m"] = "2";
+  jerasure.init(profile, &cerr);
+
+  map<int,bufferlist> in, out;
+  in[0].append(string(64, 'X'));
+  out[2].append(string(64, 'X'));
+  out[3].append(string(64, 'X'));
+  EXPECT_EQ(-EOPNOTSUPP, jerasure.apply_delta(in, &out));
+}
+
+TEST(ErasureCodeTest, encode_stripes)
+{
+  ErasureCodeJerasureCauchyGood jerasure;
+  ErasureCodeProfile profile;
+  profile["k"] = "2";
+  profile["m"] = "2";
+  profile["packetsize"] = "8";
+  jerasure.init(profile, &cerr);
+
+  unsigned stripe_width = jerasure.get_alignment() * 2;
+  unsigned stripes = 5;
+  bufferlist in;
+  for (unsigned i = 0; i < stripe_width * stripes; i++)
+    in.append((char)(i * 13 + i / 7));
+  set<int> want_to_encode = { 0, 1, 2, 3 };
+  map<int,bufferlist> batched;
+  EXPECT_EQ(0, jerasure.encode_stripes(want_to_encode, in, stripe_width,
+				       &batched));
+  EXPECT_EQ(4u, batched.size());
+
+  map<int,bufferlist> expected;
+  for (unsigned s = 0; s < stripes; s++) {
+    bufferlist stripe;
+    stripe.substr_of(in, s * stripe_width, stripe_width);
+    map<int,bufferlist> encoded;
+    EXPECT_EQ(0, jerasure.encode(want_to_encode, stripe, &encoded));
+    for (auto &c : encoded)
+      expected[c.first].claim_append(c.second);
+  }
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(stripe_width / 2 * stripes, batched[i].length());
+    EXPECT_TRUE(expected[i].contents_equal(batched[i]));
+  }
+}
+
 TEST(ErasureCodeTest, create_rule)
 {
   std::unique_ptr<CrushWrapper> c = std::make_unique<CrushWrapper>();
@@ -31,6 +31,9 @@
 #include "common/config.h"
 #include "common/Clock.h"
 #include "include/utime.h"
+#include "arch/probe.h"
+#include "arch/intel.h"
+#include "arch/arm.h"
 #include "erasure-code/ErasureCodePlugin.h"
 #include "erasure-code/ErasureCode.h"
 #include "ceph_erasure_code_benchmark.h"
@@ -71,6 +74,10 @@ int ErasureCodeBench::setup(int argc, char** argv) {
      " the first chunk, then the second etc.)")
     ("parameter,P", po::value<vector<string> >(),
      "add a parameter to the erasure code profile")
+    ("compare,C", po::value<string>(),
+     "comma separated list of plugins to run the workload with, using the "
+     "same profile, and print one line per plugin along with the SIMD "
+     "features of this CPU")
     ;
 
   po::variables_map vm;
@@ -121,6 +128,9 @@ int ErasureCodeBench::setup(int argc, char** argv) {
   in_size = vm["size"].as<int>();
   max_iterations = vm["iterations"].as<int>();
   plugin = vm["plugin"].as<string>();
+  if (vm.count("compare")) {
+    boost::split(compare, vm["compare"].as<string>(), boost::is_any_of(","));
+  }
   workload = vm["workload"].as<string>();
   erasures = vm["erasures"].as<int>();
   if (vm.count("erasures-generation") > 0 &&
@@ -156,20 +166,82 @@ int ErasureCodeBench::run() {
   ErasureCodePluginRegistry &instance = ErasureCodePluginRegistry::instance();
   instance.disable_dlclose = true;
 
+  if (!compare.empty())
+    return run_compare();
+
+  utime_t duration;
+  int code;
   if (workload == "encode")
-    return encode();
+    code = encode(plugin, profile, &duration);
   else
-    return decode();
+    code = decode(plugin, profile, &duration);
+  if (code)
+    return code;
+  cout << duration << "\t" << (max_iterations * (in_size / 1024)) << endl;
+  return 0;
+}
+
+static string simd_features()
+{
+  ceph_arch_probe();
+  string features;
+#if defined(__i386__) || defined(__x86_64__)
+  if (ceph_arch_intel_sse2)
+    features += " sse2";
+  if (ceph_arch_intel_sse3)
+    features += " sse3";
+  if (ceph_arch_intel_ssse3)
+    features += " ssse3";
+  if (ceph_arch_intel_sse41)
+    features += " sse4.1";
+  if (ceph_arch_intel_sse42)
+    features += " sse4.2";
+  if (ceph_arch_intel_pclmul)
+    features += " pclmul";
+#elif defined(__arm__) || defined(__aarch64__)
+  if (ceph_arch_neon)
+    features += " neon";
+  if (ceph_arch_aarch64_pmull)
+    features += " pmull";
+#endif
+  return features.empty() ? " none" : features;
+}
+
+int ErasureCodeBench::run_compare()
+{
+  cout << "# simd:" << simd_features() << endl;
+  cout << "# workload " << workload << " k=" << k << " m=" << m
+       << " size " << in_size << " iterations " << max_iterations << endl;
+  cout << "# plugin\tseconds\tKB\tMB/s" << endl;
+  uint64_t kb = (uint64_t)max_iterations * (in_size / 1024);
+  for (auto &name : compare) {
+    utime_t duration;
+    int code;
+    if (workload == "encode")
+      code = encode(name, profile, &duration);
+    else
+      code = decode(name, profile, &duration);
+    if (code) {
+      cout << name << "\terror " << code << endl;
+      continue;
+    }
+    double secs = (double)duration;
+    cout << name << "\t" << duration << "\t" << kb << "\t"
+	 << (secs > 0 ? kb / 1024.0 / secs : 0) << endl;
+  }
+  return 0;
 }
 
-int ErasureCodeBench::encode()
+int ErasureCodeBench::encode(const string &plugin_name,
+			     ErasureCodeProfile p,
+			     utime_t *duration)
 {
   ErasureCodePluginRegistry &instance = ErasureCodePluginRegistry::instance();
   ErasureCodeInterfaceRef erasure_code;
   stringstream messages;
-  int code = instance.factory(plugin,
+  int code = instance.factory(plugin_name,
 			      g_conf().get_val<std::string>("erasure_code_dir"),
-			      profile, &erasure_code, &messages);
+			      p, &erasure_code, &messages);
   if (code) {
     cerr << messages.str() << endl;
     return code;
@@ -189,8 +261,7 @@ int ErasureCodeBench::encode()
     if (code)
       return code;
   }
-  utime_t end_time = ceph_clock_now();
-  cout << (end_time - begin_time) << "\t" << (max_iterations * (in_size / 1024)) << endl;
+  *duration = ceph_clock_now() - begin_time;
   return 0;
 }
 
@@ -257,14 +328,16 @@ int ErasureCodeBench::decode_erasures(const map<int,bufferlist> &all_chunks,
   return 0;
 }
 
-int ErasureCodeBench::decode()
+int ErasureCodeBench::decode(const string &plugin_name,
+			     ErasureCodeProfile p,
+			     utime_t *duration)
 {
   ErasureCodePluginRegistry &instance = ErasureCodePluginRegistry::instance();
   ErasureCodeInterfaceRef erasure_code;
   stringstream messages;
-  int code = instance.factory(plugin,
+  int code = instance.factory(plugin_name,
 			      g_conf().get_val<std::string>("erasure_code_dir"),
-			      profile, &erasure_code, &messages);
+			      p, &erasure_code, &messages);
   if (code) {
     cerr << messages.str() << endl;
     return code;
@@ -320,8 +393,7 @@ int ErasureCodeBench::decode()
 	return code;
     }
   }
-  utime_t end_time = ceph_clock_now();
-  cout << (end_time - begin_time) << "\t" << (max_iterations * (in_size / 1024)) << endl;
+  *duration = ceph_clock_now() - begin_time;
   return 0;
 }
 
@@ -27,6 +27,7 @@
 #include "include/buffer.h"
 
 #include "common/ceph_context.h"
+#include "include/utime.h"
 
 #include "erasure-code/ErasureCodeInterface.h"
 
@@ -38,6 +39,7 @@ class ErasureCodeBench {
   int m;
 
   std::string plugin;
+  std::vector<std::string> compare;
 
   bool exhaustive_erasures;
   std::vector<int> erased;
@@ -55,8 +57,13 @@ public:
 		      unsigned i,
 		      unsigned want_erasures,
 		      ErasureCodeInterfaceRef erasure_code);
-  int decode();
-  int encode();
+  int decode(const std::string &plugin_name,
+	     ceph::ErasureCodeProfile p,
+	     utime_t *duration);
+  int encode(const std::string &plugin_name,
+	     ceph::ErasureCodeProfile p,
+	     utime_t *duration);
+  int run_compare();
 };
 
 #endif
@@ -233,3 +233,28 @@ TEST_F(TestSimplePolicy, test_evict_list_10) {
     m_promoted_lru.erase(m_promoted_lru.begin());
   }
 }
+
+TEST_F(TestSimplePolicy, test_admission_window) {
+  SimplePolicy policy(g_ceph_context, m_cache_size, 128, 0.9, 2);
+
+  // first miss is only remembered
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("reused_file"));
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.get_status("reused_file"));
+  ASSERT_EQ(0, policy.get_promoting_entry_num());
+
+  // reused within the window: promote
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.lookup_object("reused_file"));
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.get_status("reused_file"));
+  ASSERT_EQ(1, policy.get_promoting_entry_num());
+
+  // a scan pushes "scan_file_0" out of the window before it is reused
+  for (int i = 0; i < 3; ++i) {
+    auto file_name = "scan_file_" + std::to_string(i);
+    ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object(file_name));
+  }
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("scan_file_0"));
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.get_status("scan_file_0"));
+  ASSERT_EQ(1, policy.get_promoting_entry_num());
+
+  policy.update_status("reused_file", OBJ_CACHE_NONE);
+}
@@ -65,6 +65,53 @@ struct TestMockCacheSSDWriteLog : public TestMockFixture {
   typedef librbd::cache::ImageWriteback<librbd::MockImageCtx> MockImageWriteback;
   typedef librbd::plugin::Api<librbd::MockImageCtx> MockApi;
 
+  // records the extents of every write sent to the image and optionally
+  // holds back the first one until release() is called
+  struct RecordingImageWriteback : public MockImageWriteback {
+    using MockImageWriteback::MockImageWriteback;
+
+    ceph::mutex lock = ceph::make_mutex("RecordingImageWriteback::lock");
+    ceph::condition_variable cond;
+    std::vector<Extents> writes;
+    bool hold_first = false;
+    std::function<void()> held_write;
+
+    void aio_write(Extents &&image_extents, ceph::bufferlist&& bl,
+                   int fadvise_flags, Context *on_finish) override {
+      {
+        std::lock_guard locker{lock};
+        writes.push_back(image_extents);
+        if (hold_first && writes.size() == 1) {
+          held_write = [this, image_extents=std::move(image_extents),
+                        bl=std::move(bl), fadvise_flags, on_finish]() mutable {
+            MockImageWriteback::aio_write(std::move(image_extents),
+                                          std::move(bl), fadvise_flags,
+                                          on_finish);
+          };
+          cond.notify_all();
+          return;
+        }
+      }
+      MockImageWriteback::aio_write(std::move(image_extents), std::move(bl),
+                                    fadvise_flags, on_finish);
+    }
+
+    void release() {
+      std::function<void()> write;
+      {
+        std::unique_lock locker{lock};
+        cond.wait(locker, [this] { return bool(held_write); });
+        std::swap(write, held_write);
+      }
+      write();
+    }
+
+    std::vector<Extents> get_writes() {
+      std::lock_guard locker{lock};
+      return writes;
+    }
+  };
+
   MockImageCacheStateSSD *get_cache_state(
       MockImageCtx& mock_image_ctx, MockApi& mock_api) {
     MockImageCacheStateSSD *ssd_state = new MockImageCacheStateSSD(
@@ -629,6 +676,82 @@ TEST_F(TestMockCacheSSDWriteLog, flush) {
   ASSERT_EQ(0, finish_ctx3.wait());
 }
 
+TEST_F(TestMockCacheSSDWriteLog, flush_contiguous_writes) {
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  MockImageCtx mock_image_ctx(*ictx);
+  RecordingImageWriteback mock_image_writeback(mock_image_ctx);
+  mock_image_writeback.hold_first = true;
+  MockApi mock_api;
+  MockSSDWriteLog ssd(
+      mock_image_ctx, get_cache_state(mock_image_ctx, mock_api),
+      mock_image_writeback, mock_api);
+
+  expect_op_work_queue(mock_image_ctx);
+  expect_metadata_set(mock_image_ctx);
+
+  MockContextSSD finish_ctx1;
+  expect_context_complete(finish_ctx1, 0);
+  ssd.init(&finish_ctx1);
+  ASSERT_EQ(0, finish_ctx1.wait());
+
+  // the writeback of this unrelated write is held in flight, which keeps
+  // the entries of the next sync point dirty until they have all been
+  // written to the cache
+  MockContextSSD finish_ctx2;
+  expect_context_complete(finish_ctx2, 0);
+  Extents image_extents2{{1 << 20, 4096}};
+  bufferlist bl2;
+  bl2.append(std::string(4096, '0'));
+  ssd.write(std::move(image_extents2), std::move(bl2), 0, &finish_ctx2);
+  ASSERT_EQ(0, finish_ctx2.wait());
+
+  MockContextSSD finish_ctx_sync;
+  expect_context_complete(finish_ctx_sync, 0);
+  ssd.flush(io::FLUSH_SOURCE_USER, &finish_ctx_sync);
+  ASSERT_EQ(0, finish_ctx_sync.wait());
+
+  // adjacent writes in the same sync point are written back as one request
+  for (uint64_t off = 0; off < 4 * 4096; off += 4096) {
+    MockContextSSD finish_ctx;
+    expect_context_complete(finish_ctx, 0);
+    Extents image_extents{{off, 4096}};
+    bufferlist bl;
+    bl.append(std::string(4096, '1' + off / 4096));
+    int fadvise_flags = 0;
+    ssd.write(std::move(image_extents), std::move(bl), fadvise_flags,
+              &finish_ctx);
+    ASSERT_EQ(0, finish_ctx.wait());
+  }
+  mock_image_writeback.release();
+
+  MockContextSSD finish_ctx_flush;
+  expect_context_complete(finish_ctx_flush, 0);
+  ssd.flush(&finish_ctx_flush);
+  ASSERT_EQ(0, finish_ctx_flush.wait());
+
+  auto writes = mock_image_writeback.get_writes();
+  ASSERT_EQ(2u, writes.size());
+  ASSERT_EQ(Extents({{1 << 20, 4096}}), writes[0]);
+  ASSERT_EQ(Extents({{0, 4 * 4096}}), writes[1]);
+
+  MockContextSSD finish_ctx_read;
+  expect_context_complete(finish_ctx_read, 0);
+  Extents image_extents{{4096, 8192}};
+  bufferlist read_bl;
+  ssd.read(std::move(image_extents), &read_bl, 0, &finish_ctx_read);
+  ASSERT_EQ(0, finish_ctx_read.wait());
+  ASSERT_EQ(std::string(4096, '2') + std::string(4096, '3'),
+            read_bl.to_str());
+
+  MockContextSSD finish_ctx3;
+  expect_context_complete(finish_ctx3, 0);
+  ssd.shut_down(&finish_ctx3);
+
+  ASSERT_EQ(0, finish_ctx3.wait());
+}
+
 TEST_F(TestMockCacheSSDWriteLog, flush_source_shutdown) {
   librbd::ImageCtx *ictx;
   ASSERT_EQ(0, open_image(m_image_name, &ictx));
@@ -0,0 +1,123 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+/*
+ * Measure msgr2 secure mode frame encryption and decryption. The same
+ * amount of data is pushed through the AES-GCM handlers once as a single
+ * buffer and once split into buffers of each given fragment size, the way
+ * an encoded message with many small fields arrives at the tx handler.
+ */
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "auth/Auth.h"
+#include "common/ceph_argparse.h"
+#include "common/Clock.h"
+#include "global/global_context.h"
+#include "global/global_init.h"
+#include "include/str_list.h"
+#include "msg/async/crypto_onwire.h"
+
+using namespace std;
+using namespace ceph::crypto::onwire;
+
+static void usage(const char *name)
+{
+  cout << name << " [options]\n"
+       << "  --size N          bytes per frame (default 4194304)\n"
+       << "  --fragments L     comma separated buffer sizes the frame is\n"
+       << "                    built from (default 65536,4096,512,64)\n"
+       << "  --frames N        frames per run (default 256)\n"
+       << std::endl;
+}
+
+static void run(CephContext *cct, unsigned size, unsigned fragment,
+		unsigned frames)
+{
+  AuthConnectionMeta meta;
+  meta.con_mode = CEPH_CON_MODE_SECURE;
+  meta.connection_secret.resize(meta.get_connection_secret_length());
+  for (auto& c : meta.connection_secret) {
+    c = rand();
+  }
+  // the receiver sees the nonces crossed
+  auto sender = rxtx_t::create_handler_pair(cct, meta, true, false);
+  auto receiver = rxtx_t::create_handler_pair(cct, meta, true, true);
+
+  ceph::bufferlist plain;
+  for (unsigned off = 0; off < size; off += fragment) {
+    unsigned len = std::min(fragment, size - off);
+    ceph::bufferptr p(len);
+    memset(p.c_str(), off & 0xff, len);
+    plain.append(std::move(p));
+  }
+
+  utime_t tx_time, rx_time;
+  for (unsigned i = 0; i < frames; ++i) {
+    utime_t start = ceph_clock_now();
+    sender.tx->reset_tx_handler({size});
+    sender.tx->authenticated_encrypt_update(plain);
+    auto cipher = sender.tx->authenticated_encrypt_final();
+    utime_t mid = ceph_clock_now();
+    receiver.rx->reset_rx_handler();
+    receiver.rx->authenticated_decrypt_update_final(cipher);
+    rx_time += ceph_clock_now() - mid;
+    tx_time += mid - start;
+  }
+  double mb = (double)size * frames / (1024 * 1024);
+  cout << "fragment " << fragment
+       << " buffers " << plain.get_num_buffers()
+       << " encrypt MB/s " << mb / (double)tx_time
+       << " decrypt MB/s " << mb / (double)rx_time
+       << std::endl;
+}
+
+int main(int argc, const char **argv)
+{
+  auto args = argv_to_vec(argc, argv);
+  if (ceph_argparse_need_usage(args)) {
+    usage(argv[0]);
+    return EXIT_SUCCESS;
+  }
+  auto cct = global_init(nullptr, args, CEPH_ENTITY_TYPE_CLIENT,
+			 CODE_ENVIRONMENT_UTILITY,
+			 CINIT_FLAG_NO_DEFAULT_CONFIG_FILE);
+  common_init_finish(g_ceph_context);
+
+  unsigned size = 4 << 20, frames = 256;
+  std::string fragments = "65536,4096,512,64";
+  std::string val;
+  for (auto i = args.begin(); i != args.end();) {
+    if (ceph_argparse_witharg(args, i, &val, "--size", (char*)nullptr)) {
+      size = atoi(val.c_str());
+    } else if (ceph_argparse_witharg(args, i, &val, "--fragments",
+				     (char*)nullptr)) {
+      fragments = val;
+    } else if (ceph_argparse_witharg(args, i, &val, "--frames",
+				     (char*)nullptr)) {
+      frames = atoi(val.c_str());
+    } else {
+      cerr << "unknown option " << *i << std::endl;
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (size == 0 || frames == 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  run(g_ceph_context, size, size, frames);
+  std::vector<std::string> fragment_list;
+  get_str_vec(fragments, ",", fragment_list);
+  for (const auto& f : fragment_list) {
+    unsigned fragment = atoi(f.c_str());
+    if (fragment > 0 && fragment < size) {
+      run(g_ceph_context, size, fragment, frames);
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -205,10 +205,12 @@ protected:
       comp_meta.con_mode = Compressor::COMP_FORCE;
       comp_meta.con_method = Compressor::COMP_ALG_SNAPPY;
       m_tx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
-        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD
+        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD,
+        /*required_ratio=*/1.0, /*backoff_max=*/0
       );
       m_rx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
-        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD
+        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD,
+        /*required_ratio=*/1.0, /*backoff_max=*/0
       );
     }
   }
@@ -468,6 +470,44 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::ValuesIn(round_trip_perf_instances),
         ::testing::ValuesIn(modes)));
 
+TEST(CompressionOnwireTest, Backoff) {
+  auto compressor = Compressor::create(g_ceph_context,
+                                       Compressor::COMP_ALG_SNAPPY);
+  ASSERT_TRUE(compressor);
+  ceph::compression::onwire::TxHandler tx(
+    g_ceph_context, compressor, Compressor::COMP_FORCE, 0, 0.875, 4);
+
+  bufferlist random;
+  random.append(buffer::create(64 << 10));
+  for (unsigned i = 0; i < random.length(); i++) {
+    random.c_str()[i] = rand();
+  }
+  bufferlist zeros;
+  zeros.append_zero(64 << 10);
+
+  auto try_frame = [&tx](const bufferlist& bl) {
+    tx.reset_handler(1, bl.length());
+    auto out = tx.compress(bl);
+    return out && tx.done();
+  };
+
+  // every incompressible frame doubles the frames skipped after it
+  for (unsigned skipped : {1, 2, 4, 4}) {
+    ASSERT_TRUE(tx.should_compress());
+    ASSERT_FALSE(try_frame(random));
+    for (unsigned i = 0; i < skipped; i++) {
+      ASSERT_FALSE(tx.should_compress());
+    }
+  }
+  // compressible data is picked up again at the next probe
+  ASSERT_TRUE(tx.should_compress());
+  ASSERT_TRUE(try_frame(zeros));
+  ASSERT_TRUE(tx.should_compress());
+  ASSERT_FALSE(try_frame(random));
+  ASSERT_FALSE(tx.should_compress());
+  ASSERT_TRUE(tx.should_compress());
+}
+
 }  // namespace ceph::msgr::v2
 
 int main(int argc, char* argv[]) {
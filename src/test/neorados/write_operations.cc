@@ -15,6 +15,7 @@
 #include <memory>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <boost/asio/use_awaitable.hpp>
 
@@ -191,3 +192,33 @@ CORO_TEST_F(NeoRadosWriteOps, CmpExt, NeoRadosTest) {
   }
   co_return;
 }
+
+CORO_TEST_F(NeoRadosWriteOps, ExecuteMany, NeoRadosTest) {
+  static constexpr std::size_t count = 32;
+  std::vector<std::pair<neorados::Object, WriteOp>> writes;
+  for (std::size_t i = 0; i < count; ++i) {
+    writes.emplace_back(fmt::format("many_{}", i), WriteOp{}
+			.write_full(to_buffer_list(fmt::format("{}", i))));
+  }
+  auto results = co_await rados().execute_many(pool(), std::move(writes), 4,
+					       boost::asio::use_awaitable);
+  EXPECT_EQ(count, results.size());
+  for (const auto& ec : results) {
+    EXPECT_FALSE(ec);
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto bl = co_await read(fmt::format("many_{}", i));
+    EXPECT_EQ(fmt::format("{}", i), bl.to_str());
+  }
+
+  // one failing op doesn't stop the rest, and is reported in its slot
+  writes.clear();
+  writes.emplace_back("many_0", WriteOp{}.create(true));
+  writes.emplace_back("many_new", WriteOp{}.create(true));
+  co_await expect_error_code(
+    rados().execute_many(pool(), std::move(writes), 4,
+			 boost::asio::use_awaitable),
+    sys::errc::file_exists);
+  co_await execute("many_new", WriteOp{}.assert_exists());
+  co_return;
+}
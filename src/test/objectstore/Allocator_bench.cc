@@ -851,4 +851,5 @@ TEST_P(AllocTest, mempoolAccounting)
 INSTANTIATE_TEST_SUITE_P(
   Allocator,
   AllocTest,
-  ::testing::Values("stupid", "bitmap", "avl", "hybrid", "btree", "hybrid_btree2"));
+  ::testing::Values("stupid", "bitmap", "avl", "hybrid", "btree", "hybrid_btree2",
+                    "hybrid_sharded"));
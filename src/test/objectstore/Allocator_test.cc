@@ -14,6 +14,7 @@
 #include "include/stringify.h"
 #include "include/Context.h"
 #include "os/bluestore/Allocator.h"
+#include "os/bluestore/AllocatorTrace.h"
 
 using namespace std;
 
@@ -670,7 +671,61 @@ TEST_P(AllocTest, test_init_rm_free_unbound)
   }
 }
 
+TEST_P(AllocTest, test_alloc_trace)
+{
+  int64_t block_size = 0x1000;
+  int64_t capacity = block_size * 1024;
+  init_alloc(capacity, block_size);
+  alloc->init_add_free(0, capacity);
+
+  string path = "alloc_trace." + stringify(getpid());
+  std::ostringstream ss;
+  ASSERT_EQ(0, alloc->start_trace(path, ss));
+  ASSERT_EQ(-EBUSY, alloc->start_trace(path, ss));
+
+  PExtentVector extents;
+  EXPECT_EQ(block_size * 4,
+	    alloc->allocate(block_size * 4, block_size, 0, &extents));
+  alloc->release(extents);
+  alloc->stop_trace();
+  // not recorded
+  extents.clear();
+  EXPECT_EQ(block_size,
+	    alloc->allocate(block_size, block_size, 0, &extents));
+
+  AllocatorTrace::Reader reader;
+  AllocatorTrace::header_t header;
+  ASSERT_EQ(0, reader.open(path, &header, ss));
+  EXPECT_EQ((uint64_t)capacity, header.capacity);
+  EXPECT_EQ((uint64_t)block_size, header.block_size);
+  EXPECT_EQ(string(alloc->get_type()), header.alloc_type);
+
+  AllocatorTrace::entry_t e;
+  uint64_t free = 0;
+  ASSERT_TRUE(reader.next(&e));
+  while (e.op == AllocatorTrace::OP_FREE) {
+    free += e.extents[0].second;
+    ASSERT_TRUE(reader.next(&e));
+  }
+  EXPECT_EQ((uint64_t)capacity, free);
+
+  ASSERT_EQ(AllocatorTrace::OP_ALLOCATE, e.op);
+  EXPECT_EQ((uint64_t)block_size * 4, e.want);
+  EXPECT_EQ(block_size * 4, e.result);
+  uint64_t allocated = 0;
+  for (auto& x : e.extents) {
+    allocated += x.second;
+  }
+  EXPECT_EQ((uint64_t)block_size * 4, allocated);
+
+  ASSERT_TRUE(reader.next(&e));
+  ASSERT_EQ(AllocatorTrace::OP_RELEASE, e.op);
+  ASSERT_FALSE(reader.next(&e));
+  ::unlink(path.c_str());
+}
+
 INSTANTIATE_TEST_SUITE_P(
   Allocator,
   AllocTest,
-  ::testing::Values("stupid", "bitmap", "avl", "hybrid", "btree", "hybrid_btree2"));
+  ::testing::Values("stupid", "bitmap", "avl", "hybrid", "btree", "hybrid_btree2",
+                    "hybrid_sharded"));
@@ -15,7 +15,9 @@
 #include "common/admin_socket.h"
 #include "include/denc.h"
 #include "global/global_init.h"
+#include "include/str_list.h"
 #include "os/bluestore/Allocator.h"
+#include "os/bluestore/AllocatorTrace.h"
 
 using namespace std;
 
@@ -30,6 +32,9 @@ void usage(const string &name) {
           "export_binary <out_file>|"
           "free_histogram [<alloc_unit>] [<num_buckets>]"
        << std::endl;
+  cerr << "       " << name << " <allocator_trace> "
+       << "replay_trace [<alloc_type>[,<alloc_type>...]] [<sample_every_ops>]"
+       << std::endl;
 }
 
 void usage_replay_alloc(const string &name) {
@@ -534,6 +539,197 @@ int check_duplicates(char* fname)
   return r >= 0 ? errors != 0 : r;
 }
 
+/*
+ * Replays a trace recorded via
+ * "ceph daemon <osd> bluestore allocator trace start <name> <path>"
+ * against the given allocator implementation.
+ * Extents returned by the replayed allocator differ from the recorded ones,
+ * so recorded offsets are translated to replayed ones when released.
+ * Ranges not allocated within the trace were in use when it started
+ * and are released as is.
+ */
+int replay_trace(const char* fname,
+                 const string& alloc_type,
+                 uint64_t sample_every)
+{
+  AllocatorTrace::Reader reader;
+  AllocatorTrace::header_t header;
+  std::ostringstream ss;
+  int r = reader.open(fname, &header, ss);
+  if (r < 0) {
+    std::cerr << "error: " << ss.str() << std::endl;
+    return r;
+  }
+  size_t mem0 = mempool::bluestore_alloc::allocated_bytes();
+  unique_ptr<Allocator> alloc(
+    Allocator::create(g_ceph_context, alloc_type,
+                      header.capacity, header.block_size,
+                      "replay_" + alloc_type));
+  if (!alloc) {
+    return -EINVAL;
+  }
+
+  // recorded offset -> (length, replayed offset),
+  // replayed offset is UINT64_MAX when the replay failed to allocate
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> xlat;
+  auto map_extents = [&](
+    const std::vector<std::pair<uint64_t, uint64_t>>& orig,
+    const PExtentVector& repl) {
+    auto ri = repl.begin();
+    uint64_t rpos = 0;
+    for (auto [o, l] : orig) {
+      while (l > 0) {
+        if (ri == repl.end()) {
+          xlat[o] = std::make_pair(l, std::numeric_limits<uint64_t>::max());
+          break;
+        }
+        uint64_t n = std::min<uint64_t>(l, ri->length - rpos);
+        xlat[o] = std::make_pair(n, ri->offset + rpos);
+        o += n;
+        l -= n;
+        rpos += n;
+        if (rpos == ri->length) {
+          ++ri;
+          rpos = 0;
+        }
+      }
+    }
+  };
+  auto translate = [&](uint64_t offset, uint64_t length,
+                       release_set_t* to_release) {
+    uint64_t end = offset + length;
+    while (offset < end) {
+      auto it = xlat.upper_bound(offset);
+      if (it != xlat.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second.first > offset) {
+          it = prev;
+        }
+      }
+      if (it == xlat.end() || it->first > offset) {
+        // in use before the trace started
+        uint64_t n = (it == xlat.end()) ? end - offset :
+          std::min(end, it->first) - offset;
+        to_release->union_insert(offset, n);
+        offset += n;
+        continue;
+      }
+      auto [seg_off, seg] = *it;
+      auto [seg_len, seg_repl] = seg;
+      xlat.erase(it);
+      uint64_t head = offset - seg_off;
+      uint64_t n = std::min(end, seg_off + seg_len) - offset;
+      bool mapped = seg_repl != std::numeric_limits<uint64_t>::max();
+      if (head) {
+        xlat[seg_off] = std::make_pair(head, seg_repl);
+      }
+      if (head + n < seg_len) {
+        xlat[offset + n] = std::make_pair(seg_len - head - n,
+          mapped ? seg_repl + head + n : seg_repl);
+      }
+      if (mapped) {
+        to_release->union_insert(seg_repl + head, n);
+      }
+      offset += n;
+    }
+  };
+
+  std::vector<uint64_t> alloc_lat, release_lat;
+  uint64_t failed = 0;
+  uint64_t ops = 0;
+  size_t mem_peak = 0;
+  ceph::timespan busy = ceph::timespan::zero();
+  AllocatorTrace::entry_t e;
+  while (reader.next(&e)) {
+    switch (e.op) {
+    case AllocatorTrace::OP_FREE:
+      alloc->init_add_free(e.extents[0].first, e.extents[0].second);
+      continue;
+    case AllocatorTrace::OP_ALLOCATE:
+      {
+        PExtentVector extents;
+        auto t0 = ceph::mono_clock::now();
+        int64_t res = alloc->allocate(e.want, e.unit, e.max_alloc_size,
+                                      e.hint, &extents);
+        auto dur = ceph::mono_clock::now() - t0;
+        busy += dur;
+        alloc_lat.push_back(std::chrono::nanoseconds(dur).count());
+        if (e.result < 0) {
+          // recorded call failed, don't let its extents leak
+          if (res > 0) {
+            alloc->release(extents);
+          }
+        } else {
+          if (res < e.result) {
+            ++failed;
+          }
+          map_extents(e.extents, extents);
+        }
+      }
+      break;
+    case AllocatorTrace::OP_RELEASE:
+      {
+        release_set_t to_release;
+        for (auto [o, l] : e.extents) {
+          translate(o, l, &to_release);
+        }
+        auto t0 = ceph::mono_clock::now();
+        alloc->release(to_release);
+        auto dur = ceph::mono_clock::now() - t0;
+        busy += dur;
+        release_lat.push_back(std::chrono::nanoseconds(dur).count());
+      }
+      break;
+    }
+    ++ops;
+    if (sample_every && (ops % sample_every) == 0) {
+      size_t mem = mempool::bluestore_alloc::allocated_bytes() - mem0;
+      mem_peak = std::max(mem_peak, mem);
+      std::cout << alloc_type << " ops " << ops
+                << " fragmentation_score " << alloc->get_fragmentation_score()
+                << " free 0x" << std::hex << alloc->get_free() << std::dec
+                << " mem " << mem
+                << std::endl;
+    }
+  }
+  size_t mem = mempool::bluestore_alloc::allocated_bytes() - mem0;
+  mem_peak = std::max(mem_peak, mem);
+
+  auto pct = [](std::vector<uint64_t>& v, double p) -> uint64_t {
+    if (v.empty()) {
+      return 0;
+    }
+    size_t i = std::min(v.size() - 1, size_t(v.size() * p));
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+  };
+  double secs = std::chrono::duration<double>(busy).count();
+  std::cout << "alloc_type: " << alloc_type
+            << " (recorded with " << header.alloc_type << ")"
+            << std::endl
+            << "  ops: " << ops
+            << " failed allocations: " << failed
+            << " throughput (ops/s): " << (secs > 0 ? ops / secs : 0)
+            << std::endl
+            << "  allocate latency (ns) p50/p99/p999: "
+            << pct(alloc_lat, 0.5) << "/"
+            << pct(alloc_lat, 0.99) << "/"
+            << pct(alloc_lat, 0.999)
+            << std::endl
+            << "  release latency (ns) p50/p99/p999: "
+            << pct(release_lat, 0.5) << "/"
+            << pct(release_lat, 0.99) << "/"
+            << pct(release_lat, 0.999)
+            << std::endl
+            << "  memory (bytes) final/peak: " << mem << "/" << mem_peak
+            << std::endl
+            << "  fragmentation score: " << alloc->get_fragmentation_score()
+            << " free: 0x" << std::hex << alloc->get_free() << std::dec
+            << std::endl;
+  alloc->shutdown();
+  return 0;
+}
+
 int main(int argc, char **argv)
 {
   auto args = argv_to_vec(argc, argv);
@@ -796,5 +992,24 @@ int main(int argc, char **argv)
     return export_as_binary(argv[1], argv[3]);
   } else if (strcmp(argv[2], "duplicates") == 0) {
     return check_duplicates(argv[1]);
+  } else if (strcmp(argv[2], "replay_trace") == 0) {
+    std::list<string> types = {
+      "stupid", "bitmap", "avl", "btree", "hybrid", "hybrid_btree2",
+      "hybrid_sharded" };
+    if (argc >= 4) {
+      types.clear();
+      get_str_list(argv[3], ",", types);
+    }
+    uint64_t sample_every = 0;
+    if (argc >= 5) {
+      sample_every = strtoul(argv[4], nullptr, 10);
+    }
+    for (auto& t : types) {
+      int r = replay_trace(argv[1], t, sample_every);
+      if (r < 0) {
+        return -1;
+      }
+    }
+    return 0;
   }
 }
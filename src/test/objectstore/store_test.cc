@@ -1685,6 +1685,123 @@ TEST_P(StoreTestSpecificAUSize, ReproBug41901Test) {
   }
 }
 
+TEST_P(StoreTest, BluestoreWriteCoalescing) {
+  if (string(GetParam()) != "bluestore")
+    return;
+
+  SetVal(g_conf(), "bluestore_write_coalesce_max_bytes", "65536");
+  g_conf().apply_changes(nullptr);
+
+  int r;
+  coll_t cid;
+  ghobject_t hoid(hobject_t(sobject_t("Object 1", CEPH_NOSNAP)));
+  const PerfCounters* logger = store->get_perf_counters();
+  auto ch = store->create_new_collection(cid);
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  uint64_t ops0 = logger->get(l_bluestore_write_coalesced_ops);
+  uint64_t bytes0 = logger->get(l_bluestore_write_coalesced_bytes);
+  std::string expected(0x4000, '\0');
+  {
+    ObjectStore::Transaction t;
+    auto write = [&](uint64_t off, uint64_t len, char c) {
+      bufferlist bl;
+      bl.append(std::string(len, c));
+      t.write(cid, hoid, off, len, bl);
+      expected.replace(off, len, len, c);
+    };
+    write(0x0, 0x1000, 'a');
+    write(0x1000, 0x1000, 'b');  // adjacent, merged
+    write(0x800, 0x1000, 'c');   // overlapping, merged
+    write(0x3000, 0x1000, 'd');  // gap, starts a new write
+    write(0x2000, 0x1000, 'e');  // adjacent on the left, merged
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  ASSERT_EQ(logger->get(l_bluestore_write_coalesced_ops) - ops0, 3u);
+  ASSERT_EQ(logger->get(l_bluestore_write_coalesced_bytes) - bytes0, 0x3000u);
+  {
+    bufferlist bl;
+    r = store->read(ch, hoid, 0, 0x4000, bl);
+    ASSERT_EQ(r, 0x4000);
+    ASSERT_EQ(expected, bl.to_str());
+  }
+  {
+    ObjectStore::Transaction t;
+    t.remove(cid, hoid);
+    t.remove_collection(cid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
+
+TEST_P(StoreTestSpecificAUSize, SequentialReadahead) {
+  if(string(GetParam()) != "bluestore")
+    return;
+
+  SetVal(g_conf(), "bluestore_readahead_max_bytes", "262144");
+  SetVal(g_conf(), "bluestore_readahead_trigger_reads", "2");
+  g_conf().apply_changes(nullptr);
+  StartDeferred(4096);
+
+  int r;
+  coll_t cid;
+  ghobject_t hoid(hobject_t(sobject_t("Object 1", CEPH_NOSNAP)));
+  const PerfCounters* logger = store->get_perf_counters();
+  auto ch = store->create_new_collection(cid);
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  const unsigned obj_size = 1 << 20;
+  const unsigned chunk = 65536;
+  bufferlist orig;
+  {
+    for (unsigned i = 0; i < obj_size / 4096; ++i) {
+      orig.append(string(4096, 'a' + (i % 26)));
+    }
+    ObjectStore::Transaction t;
+    t.write(cid, hoid, 0, orig.length(), orig,
+            CEPH_OSD_OP_FLAG_FADVISE_DONTNEED);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  auto ra0 = logger->get(l_bluestore_readahead_bytes);
+  auto hit0 = logger->get(l_bluestore_readahead_hit_bytes);
+  for (unsigned off = 0; off < obj_size; off += chunk) {
+    bufferlist bl, expected;
+    r = store->read(ch, hoid, off, chunk, bl);
+    ASSERT_EQ(r, (int)chunk);
+    expected.substr_of(orig, off, chunk);
+    ASSERT_TRUE(bl_eq(expected, bl));
+  }
+  ASSERT_GT(logger->get(l_bluestore_readahead_bytes), ra0);
+  ASSERT_GT(logger->get(l_bluestore_readahead_hit_bytes), hit0);
+
+  // a random read breaks the stream and must not trigger readahead
+  ra0 = logger->get(l_bluestore_readahead_bytes);
+  {
+    bufferlist bl, expected;
+    r = store->read(ch, hoid, 4096, 4096, bl);
+    ASSERT_EQ(r, 4096);
+    expected.substr_of(orig, 4096, 4096);
+    ASSERT_TRUE(bl_eq(expected, bl));
+  }
+  ASSERT_EQ(logger->get(l_bluestore_readahead_bytes), ra0);
+  {
+    ObjectStore::Transaction t;
+    t.remove(cid, hoid);
+    t.remove_collection(cid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
 
 TEST_P(StoreTestSpecificAUSize, BluestoreStatFSTest) {
   if(string(GetParam()) != "bluestore")
@@ -3799,6 +3916,92 @@ TEST_P(StoreTest, OmapCloneTest) {
   }
 }
 
+TEST_P(StoreTest, BluestoreInlineOmap) {
+  if (string(GetParam()) != "bluestore")
+    return;
+
+  SetVal(g_conf(), "bluestore_inline_omap_max_bytes", "256");
+  g_conf().apply_changes(nullptr);
+
+  int r;
+  coll_t cid;
+  ghobject_t hoid(hobject_t(sobject_t("Object 1", CEPH_NOSNAP),
+			    "key", 123, -1, ""));
+  ghobject_t hoid2(hobject_t(sobject_t("Object 2", CEPH_NOSNAP),
+			     "key", 123, -1, ""));
+  const PerfCounters* logger = store->get_perf_counters();
+  auto ch = store->create_new_collection(cid);
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  uint64_t inline0 = logger->get(l_bluestore_omap_inline_count);
+  uint64_t spill0 = logger->get(l_bluestore_omap_inline_spill_count);
+  map<string,bufferlist> km;
+  km["a"].append("1");
+  km["b"].append("22");
+  km["c"].append("333");
+  bufferlist header;
+  header.append("header");
+  {
+    ObjectStore::Transaction t;
+    t.touch(cid, hoid);
+    t.omap_setkeys(cid, hoid, km);
+    t.omap_setheader(cid, hoid, header);
+    t.omap_rmkey(cid, hoid, "b");
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  km.erase("b");
+  ASSERT_EQ(logger->get(l_bluestore_omap_inline_count) - inline0, 1u);
+  auto check = [&](const ghobject_t& oid) {
+    map<string,bufferlist> got;
+    bufferlist h;
+    ASSERT_EQ(store->omap_get(ch, oid, &h, &got), 0);
+    ASSERT_TRUE(bl_eq(header, h));
+    ASSERT_EQ(km.size(), got.size());
+    for (auto& [k, v] : km) {
+      ASSERT_TRUE(bl_eq(v, got[k]));
+    }
+    set<string> keys;
+    ASSERT_EQ(store->omap_check_keys(ch, oid, set<string>{"a", "b", "c"},
+				     &keys), 0);
+    ASSERT_EQ(set<string>({"a", "c"}), keys);
+    auto it = store->get_omap_iterator(ch, oid);
+    it->lower_bound("b");
+    ASSERT_TRUE(it->valid());
+    ASSERT_EQ("c", it->key());
+  };
+  check(hoid);
+  {
+    ObjectStore::Transaction t;
+    t.clone(cid, hoid, hoid2);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  check(hoid2);
+  // growing past the limit moves the omap to kv
+  km["big"].append(std::string(512, 'x'));
+  {
+    ObjectStore::Transaction t;
+    t.omap_setkeys(cid, hoid, km);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  ASSERT_EQ(logger->get(l_bluestore_omap_inline_spill_count) - spill0, 1u);
+  check(hoid);
+  {
+    ObjectStore::Transaction t;
+    t.remove(cid, hoid);
+    t.remove(cid, hoid2);
+    t.remove_collection(cid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
+
 TEST_P(StoreTest, SimpleCloneRangeTest) {
   int r;
   coll_t cid;
@@ -5650,6 +5853,45 @@ INSTANTIATE_TEST_SUITE_P(
   }))
 );
 
+class SyntheticMatrixKVSubmitShards: public MatrixTest {};
+TEST_P(SyntheticMatrixKVSubmitShards, Test)
+{
+  SyntheticTest();
+};
+
+INSTANTIATE_TEST_SUITE_P(
+  BlueStore,
+  SyntheticMatrixKVSubmitShards,
+  ::testing::ValuesIn(MatrixTest::Expand({
+    { "bluestore_min_alloc_size", "4096" },
+    { "max_write", "65536" },
+    { "max_size", "1048576" },
+    { "alignment", "512" },
+    { "bluestore_prefer_deferred_size", "32768", "0" },
+    { "bluestore_sync_submit_transaction", "true", "false" },
+    { "bluestore_kv_sync_queue_shards", "1", "5" }
+  }))
+);
+
+class SyntheticMatrixFsckDeepReadThreads: public MatrixTest {};
+TEST_P(SyntheticMatrixFsckDeepReadThreads, Test)
+{
+  SyntheticTest();
+};
+
+INSTANTIATE_TEST_SUITE_P(
+  BlueStore,
+  SyntheticMatrixFsckDeepReadThreads,
+  ::testing::ValuesIn(MatrixTest::Expand({
+    { "bluestore_min_alloc_size", "4096" },
+    { "max_write", "65536" },
+    { "max_size", "1048576" },
+    { "alignment", "512" },
+    { "bluestore_csum_type", "crc32c" },
+    { "bluestore_fsck_deep_read_threads", "1", "4" }
+  }))
+);
+
 TEST_P(StoreTest, AttrSynthetic) {
   MixedGenerator gen(447);
   gen_type rng(TEST_RANDOM_SEED);
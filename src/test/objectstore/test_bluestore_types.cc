@@ -2473,6 +2473,67 @@ INSTANTIATE_TEST_SUITE_P(
 );
 
 
+TEST(ExtentMap, unload_shards)
+{
+  BlueStore store(g_ceph_context, "", 4096);
+  BlueStore::OnodeCacheShard *oc =
+      BlueStore::OnodeCacheShard::create(g_ceph_context, "lru", NULL);
+  BlueStore::BufferCacheShard *bc =
+      BlueStore::BufferCacheShard::create(&store, "lru", NULL);
+
+  auto coll = ceph::make_ref<BlueStore::Collection>(&store, oc, bc, coll_t());
+  BlueStore::OnodeRef onode(
+      new BlueStore::Onode(coll.get(), ghobject_t(), ""));
+  BlueStore::ExtentMap &em = onode->extent_map;
+
+  onode->onode.extent_map_shards.resize(2);
+  onode->onode.extent_map_shards[0].offset = 0;
+  onode->onode.extent_map_shards[1].offset = 0x10000;
+  em.init_shards(true, false);
+
+  for (uint32_t offs : {0x0, 0x10000}) {
+    BlueStore::BlobRef b = coll->new_blob();
+    auto &_b = b->dirty_blob();
+    PExtentVector pextents;
+    pextents.emplace_back(0x100000 + offs, 0x2000);
+    _b.allocated(0, 0x2000, pextents);
+    auto *ext = new BlueStore::Extent(offs, 0, 0x2000, b);
+    em.extent_map.insert(*ext);
+    b->get_ref(coll.get(), 0, 0x2000);
+    _b.mark_used(0, 0x2000);
+  }
+
+  // dirty shards stay decoded
+  em.shards[1].dirty = true;
+  ASSERT_EQ(1u, em.unload_shards());
+  ASSERT_FALSE(em.shards[0].loaded);
+  ASSERT_TRUE(em.shards[1].loaded);
+  ASSERT_NE(0u, em.shards[0].cold_bl.length());
+  ASSERT_EQ(em.extent_map.end(), em.seek_lextent(0));
+
+  em.shards[1].dirty = false;
+  ASSERT_EQ(1u, em.unload_shards());
+  ASSERT_TRUE(em.extent_map.empty());
+
+  // cold shards are decoded without touching the kv store
+  em.fault_range(nullptr, 0x10000, 0x1000);
+  ASSERT_FALSE(em.shards[0].loaded);
+  ASSERT_TRUE(em.shards[1].loaded);
+  ASSERT_EQ(0u, em.shards[1].cold_bl.length());
+  auto p = em.seek_lextent(0x10000);
+  ASSERT_NE(em.extent_map.end(), p);
+  ASSERT_EQ(0x10000u, p->logical_offset);
+  ASSERT_EQ(0x2000u, p->length);
+  ASSERT_EQ(0x2000u, p->blob->get_referenced_bytes());
+  ASSERT_EQ(0x110000u, p->blob->get_blob().get_extents()[0].offset);
+
+  em.fault_range(nullptr, 0, 0x1000);
+  ASSERT_TRUE(em.shards[0].loaded);
+  p = em.seek_lextent(0);
+  ASSERT_NE(em.extent_map.end(), p);
+  ASSERT_EQ(0x100000u, p->blob->get_blob().get_extents()[0].offset);
+}
+
 TEST(ExtentMap, dup_extent_map)
 {
   BlueStore store(g_ceph_context, "", 4096);
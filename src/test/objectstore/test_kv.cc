@@ -503,6 +503,123 @@ TEST_P(KVTest, RocksDBShardingIteratorTest) {
   fini();
 }
 
+TEST_P(KVTest, RocksDBIteratorNextBatch) {
+  if(string(GetParam()) != "rocksdb")
+    return;
+
+  std::string cfs("A(4) B");
+  ASSERT_EQ(0, db->init(g_conf()->bluestore_rocksdb_options));
+  ASSERT_EQ(0, db->create_and_open(cout, cfs));
+  {
+    KeyValueDB::Transaction t = db->get_transaction();
+    for (int v = 100; v <= 999; v++) {
+      std::string str = to_string(v);
+      bufferlist val;
+      val.append(std::string(v % 7, 'x') + str);
+      t->set("A", str, val);
+      t->set("B", str, val);
+      t->set("C", str, val);
+    }
+    ASSERT_EQ(0, db->submit_transaction_sync(t));
+  }
+  for (auto prefix : {"A", "B", "C"}) {
+    KeyValueDB::Iterator it =
+      db->get_iterator(prefix, KeyValueDB::ITERATOR_PREFETCH);
+    it->seek_to_first();
+    int pos = 100;
+    KeyValueDB::KVBatch batch;
+    std::vector<bufferptr> kept;
+    while (it->valid()) {
+      // small arenas force a short batch once they are full
+      ASSERT_EQ(0, it->next_batch(50, 128, &batch));
+      ASSERT_FALSE(batch.empty());
+      ASSERT_LE(batch.size(), 50u);
+      for (auto& [k, v] : batch.entries) {
+	std::string str = to_string(pos);
+	ASSERT_EQ(str, std::string(k.c_str(), k.length()));
+	ASSERT_EQ(std::string(pos % 7, 'x') + str,
+		  std::string(v.c_str(), v.length()));
+	// entries share the batch arena
+	ASSERT_EQ(batch.entries.front().first.raw_c_str(), k.raw_c_str());
+	kept.push_back(v);
+	++pos;
+      }
+    }
+    ASSERT_EQ(1000, pos);
+    // values outlive later batches
+    pos = 100;
+    for (auto& v : kept) {
+      ASSERT_EQ(std::string(pos % 7, 'x') + to_string(pos),
+		std::string(v.c_str(), v.length()));
+      ++pos;
+    }
+  }
+  {
+    // an entry bigger than the arena still comes back, alone
+    KeyValueDB::Transaction t = db->get_transaction();
+    bufferlist val;
+    val.append(std::string(4096, 'y'));
+    t->set("B", "big", val);
+    ASSERT_EQ(0, db->submit_transaction_sync(t));
+    KeyValueDB::Iterator it = db->get_iterator("B");
+    it->lower_bound("big");
+    KeyValueDB::KVBatch batch;
+    ASSERT_EQ(0, it->next_batch(10, 128, &batch));
+    ASSERT_EQ(1u, batch.size());
+    ASSERT_EQ(4096u, batch.entries[0].second.length());
+    ASSERT_FALSE(it->valid());
+  }
+  fini();
+}
+
+TEST_P(KVTest, RocksDBPrefixStats) {
+  if(string(GetParam()) != "rocksdb")
+    return;
+
+  g_ceph_context->_conf.set_val("rocksdb_perf_prefix_sample", "1");
+  std::string cfs("A(2)");
+  ASSERT_EQ(0, db->init(g_conf()->bluestore_rocksdb_options));
+  ASSERT_EQ(0, db->create_and_open(cout, cfs));
+  {
+    KeyValueDB::Transaction t = db->get_transaction();
+    bufferlist val;
+    val.append(std::string(100, 'v'));
+    t->set("A", "key1", val);
+    t->set("B", "key1", val);
+    t->set("B", "key2", val);
+    ASSERT_EQ(0, db->submit_transaction_sync(t));
+  }
+  {
+    bufferlist bl;
+    ASSERT_EQ(0, db->get("B", "key1", &bl));
+    KeyValueDB::Iterator it = db->get_iterator("A");
+    for (it->seek_to_first(); it->valid(); it->next()) ;
+  }
+  auto read = [](const std::string& path, bool avg) {
+    uint64_t v = 0;
+    g_ceph_context->get_perfcounters_collection()->with_counters(
+      [&](const PerfCountersCollectionImpl::CounterMap& m) {
+	auto p = m.find(path);
+	if (p != m.end()) {
+	  v = avg ? p->second.data->avgcount.load() : p->second.data->u64.load();
+	}
+      });
+    return v;
+  };
+  EXPECT_EQ(1u, read("rocksdb-prefix-A.submit_latency", true));
+  EXPECT_EQ(1u, read("rocksdb-prefix-B.submit_latency", true));
+  EXPECT_LT(read("rocksdb-prefix-A.submit_bytes", false),
+	    read("rocksdb-prefix-B.submit_bytes", false));
+  EXPECT_EQ(1u, read("rocksdb-prefix-B.get_latency", true));
+  EXPECT_EQ(100u, read("rocksdb-prefix-B.get_bytes", false));
+  EXPECT_EQ(1u, read("rocksdb-prefix-A.iterate_latency", true));
+  EXPECT_EQ(1u, read("rocksdb-prefix-A.iterate_keys", false));
+  fini();
+  // closing the store drops the loggers
+  EXPECT_EQ(0u, read("rocksdb-prefix-A.submit_latency", true));
+  g_ceph_context->_conf.set_val("rocksdb_perf_prefix_sample", "0");
+}
+
 TEST_P(KVTest, RocksDBCFMerge) {
   if(string(GetParam()) != "rocksdb")
     return;
@@ -1284,6 +1401,57 @@ TEST_F(RocksDBResharding, change_reshard) {
   }
 }
 
+TEST_F(RocksDBResharding, online) {
+  ASSERT_EQ(0, db->create_and_open(cout, "C(3) Evade(2)"));
+  generate_data();
+  data_to_db();
+  check_db();
+  ASSERT_NE(db->reshard_online("C(3) D(2) Evade(2)", cout), 0);
+  ASSERT_EQ(db->reshard_online("C(5) Evade(3,0-8)", cout), 0);
+  // keys are readable and writable while they move
+  check_db();
+  clear_db();
+  generate_data();
+  data_to_db();
+  while (db->is_online_resharding()) {
+    usleep(1000);
+  }
+  check_db();
+  db->close();
+  ASSERT_EQ(db->open(cout), 0);
+  std::string sharding;
+  ASSERT_TRUE(db->get_sharding(sharding));
+  ASSERT_EQ(sharding, "C(5) Evade(3,0-8)");
+  check_db();
+  db->close();
+}
+
+TEST_F(RocksDBResharding, online_resume) {
+  ASSERT_EQ(0, db->create_and_open(cout, "C(3) Evade(2)"));
+  generate_data();
+  data_to_db();
+  // slow enough to be interrupted after the first batch
+  g_ceph_context->_conf.set_val("rocksdb_online_reshard_bytes_per_sec", "1");
+  ASSERT_EQ(db->reshard_online("C(1) Evade(4)", cout), 0);
+  check_db();
+  db->close();
+  ASSERT_NE(db->reshard("Evade(4)"), 0);
+  g_ceph_context->_conf.set_val("rocksdb_online_reshard_bytes_per_sec", "0");
+  ASSERT_EQ(db->open(cout), 0);
+  check_db();
+  while (db->is_online_resharding()) {
+    usleep(1000);
+  }
+  check_db();
+  db->close();
+  ASSERT_EQ(db->open(cout), 0);
+  std::string sharding;
+  ASSERT_TRUE(db->get_sharding(sharding));
+  ASSERT_EQ(sharding, "C(1) Evade(4)");
+  check_db();
+  db->close();
+}
+
 
 INSTANTIATE_TEST_SUITE_P(
   KeyValueDB,
@@ -15,6 +15,7 @@
 #include "common/debug.h"
 #include "common/strtol.h"
 #include "common/ceph_argparse.h"
+#include "include/str_list.h"
 
 #define dout_context g_ceph_context
 #define dout_subsys ceph_subsys_filestore
@@ -33,7 +34,14 @@ static void usage()
       "	 --threads\n"
       "	       number of threads to carry out this workload\n"
       "	 --multi-object\n"
-    "	       have each thread write to a separate object\n" << std::endl;
+      "	       have each thread write to a separate object\n"
+      "	 --multi-collection\n"
+      "	       have each thread write to a separate collection\n"
+      "	 --sync-writes\n"
+      "	       wait for each write to commit before issuing the next\n"
+      "	 --kv-sync-lanes <n>[,<n>...]\n"
+      "	       repeat the workload for each bluestore_kv_sync_lanes value\n"
+    << std::endl;
   generic_server_usage();
 }
 
@@ -77,10 +85,14 @@ struct Config {
   int repeats;
   int threads;
   bool multi_object;
+  bool multi_collection;
+  bool sync_writes;
+  std::vector<std::string> kv_sync_lanes;
   Config()
     : size(1048576), block_size(4096),
       repeats(1), threads(1),
-      multi_object(false) {}
+      multi_object(false), multi_collection(false),
+      sync_writes(false) {}
 };
 
 class C_NotifyCond : public Context {
@@ -132,6 +144,20 @@ void osbench_worker(ObjectStore *os, const Config &cfg,
       if (offset > cfg.size)
         offset -= cfg.size;
       len -= count;
+
+      if (cfg.sync_writes) {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool done = false;
+        tls.back().register_on_commit(new C_NotifyCond(&mutex, &cond, &done));
+        os->queue_transactions(ch, tls);
+        tls.clear();
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&done](){ return done; });
+      }
+    }
+    if (tls.empty()) {
+      continue;
     }
 
     // set up the finisher
@@ -148,6 +174,37 @@ void osbench_worker(ObjectStore *os, const Config &cfg,
   }
 }
 
+/// run all workers once and return the observed iops
+size_t run_workload(ObjectStore *os, const Config &cfg,
+                    const std::vector<coll_t> &cids,
+                    const std::vector<ghobject_t> &oids)
+{
+  std::vector<std::thread> workers;
+  workers.reserve(cfg.threads);
+
+  using namespace std::chrono;
+  auto t1 = high_resolution_clock::now();
+  for (int i = 0; i < cfg.threads; i++) {
+    const auto &cid = cids[i % cids.size()];
+    const auto &oid = oids[i % oids.size()];
+    workers.emplace_back(osbench_worker, os, std::ref(cfg),
+                         cid, oid, i * cfg.size / cfg.threads);
+  }
+  for (auto &worker : workers)
+    worker.join();
+  auto t2 = high_resolution_clock::now();
+  workers.clear();
+
+  auto duration = duration_cast<microseconds>(t2 - t1);
+  byte_units total = cfg.size * cfg.repeats * cfg.threads;
+  byte_units rate = (1000000LL * total) / duration.count();
+  size_t iops = (1000000LL * total / cfg.block_size) / duration.count();
+  dout(0) << "Wrote " << total << " in "
+      << duration.count() << "us, at a rate of " << rate << "/s and "
+      << iops << " iops" << dendl;
+  return iops;
+}
+
 int main(int argc, const char *argv[])
 {
   // command-line arguments
@@ -191,6 +248,12 @@ int main(int argc, const char *argv[])
       cfg.threads = atoi(val.c_str());
     } else if (ceph_argparse_flag(args, i, "--multi-object", (char*)nullptr)) {
       cfg.multi_object = true;
+    } else if (ceph_argparse_flag(args, i, "--multi-collection", (char*)nullptr)) {
+      cfg.multi_collection = true;
+    } else if (ceph_argparse_flag(args, i, "--sync-writes", (char*)nullptr)) {
+      cfg.sync_writes = true;
+    } else if (ceph_argparse_witharg(args, i, &val, "--kv-sync-lanes", (char*)nullptr)) {
+      cfg.kv_sync_lanes = get_str_vec(val, ",");
     } else {
       derr << "Error: can't understand argument: " << *i << "\n" << dendl;
       exit(1);
@@ -262,68 +325,66 @@ int main(int argc, const char *argv[])
 
   dout(10) << "created objectstore " << os.get() << dendl;
 
-  // create a collection
-  spg_t pg;
-  const coll_t cid(pg);
-  ObjectStore::CollectionHandle ch = os->create_new_collection(cid);
-  {
+  // create the collections and objects
+  std::vector<coll_t> cids;
+  std::vector<ghobject_t> oids;
+  int ncolls = cfg.multi_collection ? cfg.threads : 1;
+  int nobjs = (cfg.multi_object || cfg.multi_collection) ? cfg.threads : 1;
+  for (int i = 0; i < ncolls; i++) {
+    const coll_t cid(spg_t(pg_t(i, 0)));
+    cids.push_back(cid);
+    ObjectStore::CollectionHandle ch = os->create_new_collection(cid);
     ObjectStore::Transaction t;
     t.create_collection(cid, 0);
     os->queue_transaction(ch, std::move(t));
   }
-
-  // create the objects
-  std::vector<ghobject_t> oids;
-  if (cfg.multi_object) {
-    oids.reserve(cfg.threads);
-    for (int i = 0; i < cfg.threads; i++) {
-      std::stringstream oss;
+  for (int i = 0; i < nobjs; i++) {
+    std::stringstream oss;
+    if (nobjs > 1) {
       oss << "osbench-thread-" << i;
-      oids.emplace_back(hobject_t(sobject_t(oss.str(), CEPH_NOSNAP)));
-
-      ObjectStore::Transaction t;
-      t.touch(cid, oids[i]);
-      int r = os->queue_transaction(ch, std::move(t));
-      ceph_assert(r == 0);
+    } else {
+      oss << "osbench";
     }
-  } else {
-    oids.emplace_back(hobject_t(sobject_t("osbench", CEPH_NOSNAP)));
+    oids.emplace_back(hobject_t(sobject_t(oss.str(), CEPH_NOSNAP)));
 
+    const coll_t& cid = cids[i % ncolls];
+    ObjectStore::CollectionHandle ch = os->open_collection(cid);
     ObjectStore::Transaction t;
-    t.touch(cid, oids.back());
+    t.touch(cid, oids[i]);
     int r = os->queue_transaction(ch, std::move(t));
     ceph_assert(r == 0);
   }
 
-  // run the worker threads
-  std::vector<std::thread> workers;
-  workers.reserve(cfg.threads);
-
-  using namespace std::chrono;
-  auto t1 = high_resolution_clock::now();
-  for (int i = 0; i < cfg.threads; i++) {
-    const auto &oid = cfg.multi_object ? oids[i] : oids[0];
-    workers.emplace_back(osbench_worker, os.get(), std::ref(cfg),
-                         cid, oid, i * cfg.size / cfg.threads);
+  if (cfg.kv_sync_lanes.empty()) {
+    run_workload(os.get(), cfg, cids, oids);
+  } else {
+    // remount with each lane count so the workload sees a fresh kv sync setup
+    std::vector<std::pair<std::string, size_t>> results;
+    for (auto& lanes : cfg.kv_sync_lanes) {
+      os->umount();
+      g_conf().set_val_or_die("bluestore_kv_sync_lanes", lanes);
+      g_conf().apply_changes(nullptr);
+      if (os->mount() < 0) {
+        derr << "mount failed" << dendl;
+        return 1;
+      }
+      dout(0) << "bluestore_kv_sync_lanes " << lanes << dendl;
+      results.emplace_back(lanes, run_workload(os.get(), cfg, cids, oids));
+    }
+    std::cout << "kv_sync_lanes\tiops" << std::endl;
+    for (auto& [lanes, iops] : results) {
+      std::cout << lanes << "\t" << iops << std::endl;
+    }
   }
-  for (auto &worker : workers)
-    worker.join();
-  auto t2 = high_resolution_clock::now();
-  workers.clear();
-
-  auto duration = duration_cast<microseconds>(t2 - t1);
-  byte_units total = cfg.size * cfg.repeats * cfg.threads;
-  byte_units rate = (1000000LL * total) / duration.count();
-  size_t iops = (1000000LL * total / cfg.block_size) / duration.count();
-  dout(0) << "Wrote " << total << " in "
-      << duration.count() << "us, at a rate of " << rate << "/s and "
-      << iops << " iops" << dendl;
 
   // remove the objects
-  ObjectStore::Transaction t;
-  for (const auto &oid : oids)
-    t.remove(cid, oid);
-  os->queue_transaction(ch, std::move(t));
+  for (int i = 0; i < nobjs; i++) {
+    const coll_t& cid = cids[i % ncolls];
+    ObjectStore::CollectionHandle ch = os->open_collection(cid);
+    ObjectStore::Transaction t;
+    t.remove(cid, oids[i]);
+    os->queue_transaction(ch, std::move(t));
+  }
 
   os->umount();
   return 0;
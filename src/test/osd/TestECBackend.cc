@@ -164,6 +164,38 @@ TEST(ECUtil, offset_length_is_same_stripe)
 }
 
 
+TEST(ECUtil, offset_len_to_sub_chunk)
+{
+  const uint64_t swidth = 4096;
+  const uint64_t schunk = 1024;
+  const unsigned int k = 4;
+  const unsigned int m = 2;
+
+  ECUtil::stripe_info_t s(k, m, swidth);
+  unsigned int raw_shard;
+  std::pair<uint64_t, uint64_t> off_len;
+
+  // nothing to read
+  ASSERT_FALSE(s.offset_len_to_sub_chunk(
+    std::make_pair(0, 0), &raw_shard, &off_len));
+
+  // 100 bytes in the middle of the second chunk of the second stripe
+  ASSERT_TRUE(s.offset_len_to_sub_chunk(
+    std::make_pair(swidth + schunk + 10, 100), &raw_shard, &off_len));
+  ASSERT_EQ(1u, raw_shard);
+  ASSERT_EQ(std::make_pair(schunk + 10, (uint64_t)100), off_len);
+
+  // a whole chunk
+  ASSERT_TRUE(s.offset_len_to_sub_chunk(
+    std::make_pair(3 * schunk, schunk), &raw_shard, &off_len));
+  ASSERT_EQ(3u, raw_shard);
+  ASSERT_EQ(std::make_pair((uint64_t)0, schunk), off_len);
+
+  // crossing a chunk boundary
+  ASSERT_FALSE(s.offset_len_to_sub_chunk(
+    std::make_pair(schunk - 1, 2), &raw_shard, &off_len));
+}
+
 TEST(ECCommon, get_min_want_to_read_shards)
 {
   const uint64_t swidth = 4096;
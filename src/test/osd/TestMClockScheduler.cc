@@ -7,6 +7,7 @@
 #include "global/global_context.h"
 #include "global/global_init.h"
 #include "common/common_init.h"
+#include "common/Formatter.h"
 
 #include "osd/scheduler/mClockScheduler.h"
 #include "osd/scheduler/OpSchedulerItem.h"
@@ -58,8 +59,9 @@ public:
   struct MockDmclockItem : public PGOpQueueable {
     op_scheduler_class scheduler_class;
 
-    MockDmclockItem(op_scheduler_class _scheduler_class) :
-      PGOpQueueable(spg_t()),
+    MockDmclockItem(op_scheduler_class _scheduler_class,
+		    spg_t pgid = spg_t()) :
+      PGOpQueueable(pgid),
       scheduler_class(_scheduler_class) {}
 
     MockDmclockItem()
@@ -220,6 +222,65 @@ TEST_F(mClockSchedulerTest, TestHighPriorityQueueEnqueueDequeue) {
   ASSERT_TRUE(q.empty());
 }
 
+TEST_F(mClockSchedulerTest, TestPoolQoS) {
+  auto client_count = [this] {
+    JSONFormatter f;
+    q.dump(f);
+    std::ostringstream out;
+    f.flush(out);
+    return out.str();
+  };
+  spg_t pg1(pg_t(0, 1)), pg2(pg_t(0, 2));
+
+  q.enqueue(create_item(100, client1, op_scheduler_class::client, pg1));
+  q.enqueue(create_item(101, client1, op_scheduler_class::client, pg2));
+  // without pool QoS both pools share the client class
+  ASSERT_NE(std::string::npos, client_count().find("\"client_count\":1"));
+  get_item(q.dequeue());
+  get_item(q.dequeue());
+  ASSERT_TRUE(q.empty());
+
+  std::map<int64_t, mClockScheduler::pool_qos_t> qos;
+  qos[1] = {100, 1, 0};
+  q.update_pool_qos(qos);
+  q.enqueue(create_item(102, client1, op_scheduler_class::client, pg1));
+  q.enqueue(create_item(103, client1, op_scheduler_class::client, pg2));
+  ASSERT_NE(std::string::npos, client_count().find("\"client_count\":2"));
+  get_item(q.dequeue());
+  get_item(q.dequeue());
+  ASSERT_TRUE(q.empty());
+}
+
+TEST_F(mClockSchedulerTest, TestCostCurve) {
+  std::vector<std::pair<uint64_t, double>> points;
+  ASSERT_FALSE(mClockScheduler::parse_cost_curve("", &points));
+  ASSERT_FALSE(mClockScheduler::parse_cost_curve("4096", &points));
+  ASSERT_FALSE(mClockScheduler::parse_cost_curve("4096:0", &points));
+  ASSERT_FALSE(mClockScheduler::parse_cost_curve("4K:10,4096:20", &points));
+  ASSERT_TRUE(mClockScheduler::parse_cost_curve("64K:500,4K:1000", &points));
+  ASSERT_EQ(2u, points.size());
+  ASSERT_EQ(4096u, points[0].first);
+  ASSERT_EQ(65536u, points[1].first);
+
+  auto bw = g_ceph_context->_conf.get_val<Option::size_t>(
+    "osd_mclock_max_sequential_bandwidth_ssd");
+  g_ceph_context->_conf.set_val_or_die("osd_mclock_cost_curve",
+				       "4096:1000,65536:500");
+  q.handle_conf_change(g_ceph_context->_conf, {"osd_mclock_cost_curve"});
+  // below the first point: cost of the first point
+  ASSERT_EQ((uint32_t)(bw / 1000), q.calc_scaled_cost(512));
+  ASSERT_EQ((uint32_t)(bw / 1000), q.calc_scaled_cost(4096));
+  // half way between the points
+  ASSERT_EQ((uint32_t)((bw / 1000 + bw / 500) / 2),
+	    q.calc_scaled_cost((4096 + 65536) / 2));
+  // past the last point cost grows with the size
+  ASSERT_EQ((uint32_t)(bw / 500 * 2), q.calc_scaled_cost(131072));
+
+  g_ceph_context->_conf.set_val_or_die("osd_mclock_cost_curve", "");
+  q.handle_conf_change(g_ceph_context->_conf, {"osd_mclock_cost_curve"});
+  ASSERT_EQ((uint32_t)q.get_cost_per_io(), q.calc_scaled_cost(512));
+}
+
 TEST_F(mClockSchedulerTest, TestAllQueuesEnqueueDequeue) {
   ASSERT_TRUE(q.empty());
 
@@ -844,6 +844,88 @@ TEST_F(OSDMapTest, parse_osd_id_list) {
   ASSERT_EQ(-EINVAL, osdmap.parse_osd_id_list({"-12"}, &out, &cout));
 }
 
+TEST_F(OSDMapTest, DedupUpmaps) {
+  set_up_map();
+  pg_t pgid(0, my_rep_pool);
+  {
+    OSDMap::Incremental inc(osdmap.get_epoch() + 1);
+    inc.new_pg_upmap[pgid] = mempool::osdmap::vector<int32_t>{0, 1, 2};
+    inc.new_pg_upmap_items[pgid] =
+      mempool::osdmap::vector<pair<int32_t,int32_t>>{{0, 3}};
+    osdmap.apply_incremental(inc);
+  }
+  auto nextmap = std::make_shared<OSDMap>();
+  nextmap->deepish_copy_from(osdmap);
+  {
+    OSDMap::Incremental inc(osdmap.get_epoch() + 1);
+    nextmap->apply_incremental(inc);
+  }
+  size_t before = mempool::osdmap::allocated_items();
+  OSDMap::dedup(&osdmap, nextmap.get());
+  ASSERT_LT(mempool::osdmap::allocated_items(), before);
+  ASSERT_TRUE(nextmap->have_pg_upmaps(pgid));
+
+  // a later map dropping the upmaps must not touch the shared tables
+  OSDMap lastmap;
+  lastmap.deepish_copy_from(*nextmap);
+  {
+    OSDMap::Incremental inc(nextmap->get_epoch() + 1);
+    inc.old_pg_upmap.insert(pgid);
+    inc.old_pg_upmap_items.insert(pgid);
+    lastmap.apply_incremental(inc);
+  }
+  ASSERT_FALSE(lastmap.have_pg_upmaps(pgid));
+  ASSERT_TRUE(nextmap->have_pg_upmaps(pgid));
+  ASSERT_TRUE(osdmap.have_pg_upmaps(pgid));
+}
+
+TEST_F(OSDMapTest, IncrementalMappingUpdate) {
+  set_up_map();
+  ThreadPool tp(g_ceph_context, "mapping_tp", "mapping_tp", 4);
+  ParallelPGMapper mapper(g_ceph_context, &tp);
+  tp.start();
+  mapping.start_update(osdmap, mapper, 64)->wait();
+
+  pg_t pgid(0, my_rep_pool);
+  vector<int> up;
+  int up_primary;
+  osdmap.pg_to_raw_up(pgid, &up, &up_primary);
+  ASSERT_EQ(3u, up.size());
+  int other = -1;
+  for (int i = 0; i < get_num_osds() && other < 0; ++i) {
+    if (std::find(up.begin(), up.end(), i) == up.end()) {
+      other = i;
+    }
+  }
+  OSDMap::Incremental inc(osdmap.get_epoch() + 1);
+  inc.new_pg_upmap_items[pgid] =
+    mempool::osdmap::vector<pair<int32_t,int32_t>>{{up[0], other}};
+  std::set<pg_t> pgs;
+  ASSERT_TRUE(inc.get_pg_local_changes(&pgs));
+  ASSERT_EQ(std::set<pg_t>{pgid}, pgs);
+  osdmap.apply_incremental(inc);
+
+  mapping.start_update(osdmap, mapper, 64,
+		       vector<pg_t>(pgs.begin(), pgs.end()))->wait();
+  ASSERT_EQ(osdmap.get_epoch(), mapping.get_epoch());
+  for (unsigned ps = 0; ps < osdmap.get_pg_pool(my_rep_pool)->get_pg_num();
+       ++ps) {
+    pg_t pg(ps, my_rep_pool);
+    vector<int> up1, acting1, up2, acting2;
+    int up_primary1, acting_primary1, up_primary2, acting_primary2;
+    osdmap.pg_to_up_acting_osds(pg, &up1, &up_primary1,
+				&acting1, &acting_primary1);
+    mapping.get(pg, &up2, &up_primary2, &acting2, &acting_primary2);
+    ASSERT_EQ(up1, up2);
+    ASSERT_EQ(acting1, acting2);
+  }
+  tp.stop();
+
+  OSDMap::Incremental crush_inc(osdmap.get_epoch() + 1);
+  osdmap.crush->encode(crush_inc.crush, CEPH_FEATURES_SUPPORTED_DEFAULT);
+  ASSERT_FALSE(crush_inc.get_pg_local_changes(&pgs));
+}
+
 TEST_F(OSDMapTest, CleanPGUpmaps) {
   set_up_map();
 
@@ -2514,6 +2514,26 @@ TEST_F(PGLogMergeDupsTest, OtherEmpty) {
   check_index();
 }
 
+TEST_F(PGLogMergeDupsTest, TrimmedDupsRemovedOnDisk) {
+  log.tail = eversion_t(14, 5);
+
+  add_dups(example_dups_1());
+  index();
+  test_disk_roundtrip();
+
+  // drop the oldest dups as IndexedLog::trim would; they are written out
+  // as a single range removal and must not come back on read
+  for (int i = 0; i < 3; ++i) {
+    trimmed_dups.insert(log.dups.front().get_key_name());
+    log.dups.pop_front();
+  }
+  index();
+  test_disk_roundtrip();
+
+  EXPECT_EQ(2u, log.dups.size());
+  check_order();
+}
+
 TEST_F(PGLogMergeDupsTest, AmEmpty) {
   log.tail = eversion_t(14, 5);
   index();
@@ -0,0 +1,153 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+/*
+ * Exercise OpScheduler::enqueue/dequeue the way the OSD op queue does:
+ * every shard has its own scheduler behind a mutex and several threads
+ * per shard take turns queueing and dequeueing ops.
+ */
+
+#include <iostream>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "common/ceph_argparse.h"
+#include "common/ceph_mutex.h"
+#include "common/Clock.h"
+#include "global/global_context.h"
+#include "global/global_init.h"
+
+#include "osd/scheduler/OpScheduler.h"
+#include "osd/scheduler/OpSchedulerItem.h"
+
+using namespace std;
+using namespace ceph::osd::scheduler;
+
+struct BenchItem : public PGOpQueueable {
+  op_scheduler_class scheduler_class;
+
+  BenchItem(spg_t pgid, op_scheduler_class c)
+    : PGOpQueueable(pgid), scheduler_class(c) {}
+
+  ostream &print(ostream &rhs) const final { return rhs; }
+  std::string print() const final { return std::string(); }
+  std::optional<OpRequestRef> maybe_get_op() const final {
+    return std::nullopt;
+  }
+  op_scheduler_class get_scheduler_class() const final {
+    return scheduler_class;
+  }
+  void run(OSD *osd, OSDShard *sdata, PGRef& pg,
+	   ThreadPool::TPHandle &handle) final {}
+};
+
+struct Shard {
+  ceph::mutex lock = ceph::make_mutex("bench_op_scheduler::Shard");
+  OpSchedulerRef scheduler;
+};
+
+static void usage(const char *name)
+{
+  cout << name << " [options]\n"
+       << "  --type wpq|mclock_scheduler   scheduler to exercise (default wpq)\n"
+       << "  --shards N                    number of shards (default 8)\n"
+       << "  --threads-per-shard N         threads per shard (default 2)\n"
+       << "  --ops N                       ops per thread (default 1000000)\n"
+       << std::endl;
+}
+
+int main(int argc, const char **argv)
+{
+  auto args = argv_to_vec(argc, argv);
+  if (ceph_argparse_need_usage(args)) {
+    usage(argv[0]);
+    return EXIT_SUCCESS;
+  }
+  auto cct = global_init(nullptr, args, CEPH_ENTITY_TYPE_OSD,
+			 CODE_ENVIRONMENT_UTILITY,
+			 CINIT_FLAG_NO_DEFAULT_CONFIG_FILE);
+  common_init_finish(g_ceph_context);
+
+  std::string type = "wpq";
+  int shards = 8, threads_per_shard = 2, ops = 1000000;
+  std::string val;
+  for (auto i = args.begin(); i != args.end();) {
+    if (ceph_argparse_witharg(args, i, &val, "--type", (char*)nullptr)) {
+      type = val;
+    } else if (ceph_argparse_witharg(args, i, &val, "--shards",
+				     (char*)nullptr)) {
+      shards = atoi(val.c_str());
+    } else if (ceph_argparse_witharg(args, i, &val, "--threads-per-shard",
+				     (char*)nullptr)) {
+      threads_per_shard = atoi(val.c_str());
+    } else if (ceph_argparse_witharg(args, i, &val, "--ops",
+				     (char*)nullptr)) {
+      ops = atoi(val.c_str());
+    } else {
+      cerr << "unknown option " << *i << std::endl;
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  auto queue_type = get_op_queue_type_by_name(type);
+  if (!queue_type || shards <= 0 || threads_per_shard <= 0 || ops <= 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Shard> shard_list(shards);
+  for (int i = 0; i < shards; ++i) {
+    shard_list[i].scheduler = make_scheduler(
+      g_ceph_context, 0, shards, i, false, "bluestore", *queue_type,
+      g_conf().get_val<std::string>("osd_op_queue_cut_off") == "low" ?
+      CEPH_MSG_PRIO_LOW : CEPH_MSG_PRIO_HIGH, nullptr);
+  }
+
+  auto worker = [&](int shard, int thread) {
+    Shard &s = shard_list[shard];
+    int queued = 0;
+    for (int i = 0; i < ops; ++i) {
+      spg_t pgid(pg_t(i % 64, 1 + thread));
+      auto c = (i % 4 == 0) ? op_scheduler_class::background_best_effort :
+	op_scheduler_class::client;
+      std::lock_guard l{s.lock};
+      s.scheduler->enqueue(OpSchedulerItem(
+	std::make_unique<BenchItem>(pgid, c),
+	4096, c == op_scheduler_class::client ? 63 : 10,
+	utime_t(), thread, 1));
+      ++queued;
+      // keep a few ops queued, as a loaded shard would
+      if (queued > 8 && !s.scheduler->empty()) {
+	auto item = s.scheduler->dequeue();
+	if (std::holds_alternative<OpSchedulerItem>(item)) {
+	  --queued;
+	}
+      }
+    }
+    std::lock_guard l{s.lock};
+    while (!s.scheduler->empty()) {
+      s.scheduler->dequeue();
+    }
+  };
+
+  utime_t start = ceph_clock_now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < shards; ++i) {
+    for (int j = 0; j < threads_per_shard; ++j) {
+      threads.emplace_back(worker, i, j);
+    }
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  double elapsed = (double)(ceph_clock_now() - start);
+  uint64_t total = (uint64_t)ops * shards * threads_per_shard;
+  cout << type << " shards " << shards
+       << " threads_per_shard " << threads_per_shard
+       << " ops " << total
+       << " elapsed " << elapsed
+       << " ops/sec " << (elapsed > 0 ? total / elapsed : 0)
+       << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -581,6 +581,12 @@ int ceph::io_sequence::tester::TestObject::get_num_io() {
   return exerciser_model->get_num_io();
 }
 
+const std::map<ceph::io_exerciser::OpType,
+               ceph::io_exerciser::Model::LatencyStats>&
+ceph::io_sequence::tester::TestObject::get_latency_stats() {
+  return exerciser_model->get_latency_stats();
+}
+
 ceph::io_sequence::tester::TestRunner::TestRunner(po::variables_map& vm,
                                                   librados::Rados& rados)
     : rados(rados),
@@ -941,12 +947,25 @@ bool ceph::io_sequence::tester::TestRunner::run_automated_test() {
   }
 
   int total_io = 0;
+  std::map<ceph::io_exerciser::OpType, ceph::io_exerciser::Model::LatencyStats>
+      latency_stats;
   for (auto obj = test_objects.begin(); obj != test_objects.end(); ++obj) {
     std::shared_ptr<ceph::io_sequence::tester::TestObject> to = *obj;
     total_io += to->get_num_io();
+    for (auto& [type, stats] : to->get_latency_stats()) {
+      latency_stats[type].merge(stats);
+    }
     ceph_assert(to->finished());
   }
   dout(0) << "Total number of IOs = " << total_io << dendl;
+  for (auto& [type, stats] : latency_stats) {
+    using ms = std::chrono::duration<double, std::milli>;
+    dout(0) << fmt::format("{}: {} IOs, avg latency {:.3f}ms, max {:.3f}ms",
+                           type, stats.count,
+                           ms(stats.total).count() / stats.count,
+                           ms(stats.max).count())
+            << dendl;
+  }
 
   return true;
 }
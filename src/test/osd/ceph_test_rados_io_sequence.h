@@ -250,6 +250,9 @@ class TestObject {
              std::optional<int> seqseed, bool testRecovery);
 
   int get_num_io();
+  const std::map<ceph::io_exerciser::OpType,
+                 ceph::io_exerciser::Model::LatencyStats>&
+  get_latency_stats();
   bool readyForIo();
   bool next();
   bool finished();
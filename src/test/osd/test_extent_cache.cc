@@ -280,3 +280,48 @@ TEST(extentcache, write_write_overlap2)
 
   c.release_write_pin(pin3);
 }
+
+TEST(extentcache, retain_after_release)
+{
+  hobject_t oid;
+
+  ExtentCache c;
+  c.set_retain_max_bytes(16);
+
+  // write 1 reads and writes 0~8
+  ExtentCache::write_pin pin;
+  c.open_write_pin(pin);
+  auto to_write = iset_from_vector({{0, 8}});
+  ASSERT_EQ(to_write, c.reserve_extents_for_rmw(oid, pin, to_write, to_write));
+  c.present_rmw_update(oid, pin, imap_from_iset(to_write));
+  c.release_write_pin(pin);
+  ASSERT_EQ(8u, c.get_retained_bytes());
+
+  // write 2 finds 0~8 cached and only reads 8~4
+  ExtentCache::write_pin pin2;
+  c.open_write_pin(pin2);
+  auto to_write2 = iset_from_vector({{4, 8}});
+  ASSERT_EQ(iset_from_vector({{8, 4}}),
+	    c.reserve_extents_for_rmw(oid, pin2, to_write2, to_write2));
+  auto got = c.get_remaining_extents_for_rmw(
+    oid, pin2, iset_from_vector({{4, 4}}));
+  ASSERT_EQ(got.ext_count(), 1u);
+  c.present_rmw_update(oid, pin2, imap_from_iset(to_write2));
+  c.release_write_pin(pin2);
+  ASSERT_EQ(12u, c.get_retained_bytes());
+
+  // the budget is enforced, oldest first
+  c.set_retain_max_bytes(8);
+  ASSERT_LE(c.get_retained_bytes(), 8u);
+
+  // invalidation drops retained extents and those of open pins
+  ExtentCache::write_pin pin3;
+  c.open_write_pin(pin3);
+  auto to_write3 = iset_from_vector({{32, 4}});
+  c.reserve_extents_for_rmw(oid, pin3, to_write3, extent_set());
+  c.present_rmw_update(oid, pin3, imap_from_iset(to_write3));
+  c.invalidate_retained(oid);
+  ASSERT_EQ(0u, c.get_retained_bytes());
+  c.release_write_pin(pin3);
+  ASSERT_EQ(0u, c.get_retained_bytes());
+}
@@ -352,6 +352,79 @@ int correctness_test(uint64_t delay_ns)
   return EXIT_FAILURE;
 }
 
+int dirty_extent_test(uint64_t delay_ns)
+{
+  std::cerr << "starting dirty extent test" << std::endl;
+  ceph::mutex lock = ceph::make_mutex("object_cacher_stress::object_cacher");
+  MemWriteback writeback(g_ceph_context, &lock, delay_ns);
+
+  const uint64_t extent = 1<<16;
+  const uint64_t write_len = 1<<12;
+  ObjectCacher obc(g_ceph_context, "test", writeback, lock, NULL, NULL,
+		   1<<22, // max cache size, 4MB
+		   1, // max objects, just one
+		   1<<21, // max dirty, 2MB
+		   1<<20, // target dirty, 1MB
+		   3600, // max dirty age, never reached here
+		   true);
+  obc.set_max_dirty_extent(extent);
+  obc.start();
+
+  SnapContext snapc;
+  ceph_tid_t journal_tid = 0;
+  std::string oid("dirty_extent_test_obj");
+  ObjectCacher::ObjectSet object_set(NULL, 0, 0);
+  ceph::bufferlist bl;
+  bl.append_zero(write_len);
+
+  // sequential appends merge into one dirty bh; it must stay dirty until
+  // it reaches max_dirty_extent and then be written back from writex()
+  std::map<uint64_t, C_SaferCond> finishers;
+  for (uint64_t off = 0; off < extent; off += write_len) {
+    ObjectCacher::OSDWrite *wr = obc.prepare_write(snapc, bl,
+						   ceph::real_clock::zero(), 0,
+						   ++journal_tid);
+    ObjectExtent oe(oid, 0, off, write_len, 0);
+    oe.oloc.pool = 0;
+    oe.buffer_extents.push_back(make_pair(0, write_len));
+    wr->extents.push_back(oe);
+    lock.lock();
+    obc.writex(wr, &object_set, &finishers[off]);
+    loff_t dirty = obc.get_stat_dirty();
+    lock.unlock();
+    uint64_t expected = off + write_len < extent ? off + write_len : 0;
+    if ((uint64_t)dirty != expected) {
+      std::cout << "after writing " << off << "~" << write_len
+		<< " dirty is " << dirty << ", expected " << expected
+		<< std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  for (auto& [off, f] : finishers) {
+    f.wait();
+  }
+
+  lock.lock();
+  C_SaferCond flushcond;
+  bool done = obc.flush_all(&flushcond);
+  if (!done) {
+    lock.unlock();
+    flushcond.wait();
+    lock.lock();
+  }
+  bool unclean = obc.release_set(&object_set);
+  lock.unlock();
+  obc.stop();
+  if (unclean) {
+    std::cout << "unclean buffers left over!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Testing ObjectCacher dirty extent writeback complete"
+	    << std::endl;
+  return EXIT_SUCCESS;
+}
+
 int main(int argc, const char **argv)
 {
   auto args = argv_to_vec(argc, argv);
@@ -368,6 +441,7 @@ int main(int argc, const char **argv)
   int seed = time(0) % 100000;
   bool stress = false;
   bool correctness = false;
+  bool dirty_extent = false;
   std::ostringstream err;
   std::vector<const char*>::iterator i;
   for (i = args.begin(); i != args.end();) {
@@ -410,6 +484,8 @@ int main(int argc, const char **argv)
       stress = true;
     } else if (ceph_argparse_flag(args, i, "--correctness-test", NULL)) {
       correctness = true;
+    } else if (ceph_argparse_flag(args, i, "--dirty-extent-test", NULL)) {
+      dirty_extent = true;
     } else {
       cerr << "unknown option " << *i << std::endl;
       return EXIT_FAILURE;
@@ -423,4 +499,7 @@ int main(int argc, const char **argv)
   if (correctness) {
     return correctness_test(delay_ns);
   }
+  if (dirty_extent) {
+    return dirty_extent_test(delay_ns);
+  }
 }
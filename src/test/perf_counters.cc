@@ -21,6 +21,7 @@
 #include "common/admin_socket_client.h"
 #include "common/ceph_context.h"
 #include "common/config.h"
+#include "common/Cycles.h"
 #include "common/errno.h"
 #include "common/safe_io.h"
 
@@ -44,6 +45,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <thread>
+#include <vector>
 
 #include "common/common_init.h"
 
@@ -260,6 +262,53 @@ TEST(PerfCounters, read_avg) {
   t1.join();
 }
 
+TEST(PerfCounters, HotCounters) {
+  PerfCountersBuilder bld(g_ceph_context, "test_perfcounter_hot",
+	  TEST_PERFCOUNTERS1_ELEMENT_FIRST, TEST_PERFCOUNTERS1_ELEMENT_LAST);
+  bld.add_u64_counter(TEST_PERFCOUNTERS1_ELEMENT_1, "element1");
+  bld.add_u64(TEST_PERFCOUNTERS1_ELEMENT_2, "element2");
+  bld.add_time_avg(TEST_PERFCOUNTERS1_ELEMENT_3, "element3");
+  bld.mark_hot(TEST_PERFCOUNTERS1_ELEMENT_1);
+  bld.mark_hot(TEST_PERFCOUNTERS1_ELEMENT_3);
+  std::unique_ptr<PerfCounters> pc{bld.create_perf_counters()};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 20; ++i) {
+    threads.emplace_back([&pc] {
+      for (int j = 0; j < 1000; ++j) {
+	pc->inc(TEST_PERFCOUNTERS1_ELEMENT_1);
+	pc->tinc(TEST_PERFCOUNTERS1_ELEMENT_3, utime_t(0, 1000));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(20000u, pc->get(TEST_PERFCOUNTERS1_ELEMENT_1));
+  auto a = pc->get_tavg_ns(TEST_PERFCOUNTERS1_ELEMENT_3);
+  ASSERT_EQ(20000u, a.first);
+  ASSERT_EQ(20000000u, a.second);
+
+  pc->dec(TEST_PERFCOUNTERS1_ELEMENT_1, 5);
+  ASSERT_EQ(19995u, pc->get(TEST_PERFCOUNTERS1_ELEMENT_1));
+  pc->set(TEST_PERFCOUNTERS1_ELEMENT_1, 7);
+  ASSERT_EQ(7u, pc->get(TEST_PERFCOUNTERS1_ELEMENT_1));
+
+  pc->reset();
+  a = pc->get_tavg_ns(TEST_PERFCOUNTERS1_ELEMENT_3);
+  ASSERT_EQ(0u, a.first);
+  ASSERT_EQ(0u, a.second);
+
+  Cycles::init();
+  if (Cycles::per_second() != 0) {
+    pc->tinc_cycles(TEST_PERFCOUNTERS1_ELEMENT_3,
+		    Cycles::from_nanoseconds(5000000));
+    a = pc->get_tavg_ns(TEST_PERFCOUNTERS1_ELEMENT_3);
+    ASSERT_EQ(1u, a.first);
+    ASSERT_NEAR(5000000.0, (double)a.second, 1000.0);
+  }
+}
+
 static PerfCounters* setup_test_perfcounter4(std::string name, CephContext *cct)
 {
   PerfCountersBuilder bld(cct, name,
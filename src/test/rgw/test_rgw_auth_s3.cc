@@ -0,0 +1,87 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <memory>
+#include <string>
+
+#include <boost/intrusive_ptr.hpp>
+
+#include <gtest/gtest.h>
+
+#include "common/ceph_context.h"
+#include "common/dout.h"
+#include "rgw_auth_s3.h"
+
+using rgw::auth::s3::get_v4_signature;
+
+namespace {
+
+// the worked example from the AWS SigV4 documentation
+const std::string secret = "wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY";
+const std::string scope = "20150830/us-east-1/iam/aws4_request";
+const std::string canonreq_hash =
+  "f536975d06c0309214f805bb90ccff089219ecd68b2577efef23edd43b7e1a59";
+const std::string signature =
+  "5d672d79c15b13162d9279b0855cfba6789a8edb4c82c400e06b5924a6f2b5d7";
+
+std::string string_to_sign(const std::string& date,
+			   const std::string& credential_scope)
+{
+  return "AWS4-HMAC-SHA256\n" + date + "T123600Z\n" + credential_scope +
+    "\n" + canonreq_hash;
+}
+
+} // anonymous namespace
+
+class SigningKeyCacheTest : public ::testing::Test {
+protected:
+  boost::intrusive_ptr<CephContext> cct;
+  std::unique_ptr<NoDoutPrefix> dpp;
+public:
+  SigningKeyCacheTest() {
+    cct.reset(new CephContext(CEPH_ENTITY_TYPE_CLIENT), false);
+    dpp = std::make_unique<NoDoutPrefix>(cct.get(), ceph_subsys_rgw);
+  }
+
+  std::string sign(const std::string& secret_key,
+		   const std::string& credential_scope,
+		   const std::string& sts) {
+    return get_v4_signature(credential_scope, cct.get(), secret_key, sts,
+			    dpp.get());
+  }
+};
+
+TEST_F(SigningKeyCacheTest, Hit) {
+  const auto sts = string_to_sign("20150830", scope);
+  // the first call derives and caches the signing key, the others use it
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(signature, sign(secret, scope, sts));
+  }
+  // a cached key still signs a different string to sign
+  EXPECT_NE(signature, sign(secret, scope, sts + "0"));
+}
+
+TEST_F(SigningKeyCacheTest, SecretChange) {
+  const auto sts = string_to_sign("20150830", scope);
+  EXPECT_EQ(signature, sign(secret, scope, sts));
+  // a rotated secret key for the same scope doesn't find the old key
+  EXPECT_EQ("927d35fba76edee43b5271357fa17f75e6d81ab7395aeeca53895b91785e72f5",
+	    sign("AKIDEXAMPLESECRETKEYROTATEDEXAMPLEKEY", scope, sts));
+  EXPECT_EQ(signature, sign(secret, scope, sts));
+}
+
+TEST_F(SigningKeyCacheTest, ScopeChange) {
+  EXPECT_EQ(signature, sign(secret, scope, string_to_sign("20150830", scope)));
+  // the next day's scope derives a new key
+  const std::string next_scope = "20150831/us-east-1/iam/aws4_request";
+  EXPECT_EQ("e098623b8e47fb062d1f1c8202f6e5ca17d0c2cd772f2053086cc17a04ed0a4f",
+	    sign(secret, next_scope, string_to_sign("20150831", next_scope)));
+}
+
+TEST_F(SigningKeyCacheTest, KeyBoundary) {
+  // moving characters between the secret and the scope must not map
+  // both onto the same cache entry
+  const auto sts = string_to_sign("20150830", scope);
+  EXPECT_EQ(signature, sign(secret, scope, sts));
+  EXPECT_NE(signature, sign(secret + "2", scope.substr(1), sts));
+}
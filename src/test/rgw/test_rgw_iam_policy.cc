@@ -276,6 +276,65 @@ TEST_F(PolicyTest, Eval1) {
 
 }
 
+TEST_F(PolicyTest, AttrCacheHit) {
+  std::map<std::string, bufferlist> attrs;
+  attrs[RGW_ATTR_IAM_POLICY].append(example1);
+
+  // the first call parses and caches the policy, the others copy it
+  for (int i = 0; i < 3; ++i) {
+    auto p = get_iam_policy_from_attr(cct.get(), attrs, arbitrary_tenant);
+    ASSERT_TRUE(p);
+    EXPECT_EQ(p->text, example1);
+    ASSERT_EQ(p->statements.size(), 1U);
+    EXPECT_EQ(p->statements[0].resource.begin()->account, arbitrary_tenant);
+
+    Environment e;
+    ARN arn(Partition::aws, Service::s3, "", arbitrary_tenant,
+	    "example_bucket");
+    EXPECT_EQ(p->eval(e, none, s3ListBucket, arn), Effect::Allow);
+    EXPECT_EQ(p->eval(e, none, s3PutBucketAcl, arn), Effect::Pass);
+  }
+
+  attrs.erase(RGW_ATTR_IAM_POLICY);
+  EXPECT_FALSE(get_iam_policy_from_attr(cct.get(), attrs, arbitrary_tenant));
+}
+
+TEST_F(PolicyTest, AttrCacheInvalidate) {
+  std::map<std::string, bufferlist> attrs;
+  attrs[RGW_ATTR_IAM_POLICY].append(example1);
+  auto p = get_iam_policy_from_attr(cct.get(), attrs, arbitrary_tenant);
+  ASSERT_TRUE(p);
+  EXPECT_EQ(p->text, example1);
+
+  // a policy replaced by PutBucketPolicy is parsed again
+  attrs[RGW_ATTR_IAM_POLICY].clear();
+  attrs[RGW_ATTR_IAM_POLICY].append(example2);
+  p = get_iam_policy_from_attr(cct.get(), attrs, arbitrary_tenant);
+  ASSERT_TRUE(p);
+  EXPECT_EQ(p->text, example2);
+  EXPECT_EQ(p->statements.size(), 1U);
+  EXPECT_EQ(p->id, string("S3-Account-Permissions"));
+
+  // the same text under another tenant resolves its ARNs to that tenant
+  const string other_tenant = "other_tenant";
+  attrs[RGW_ATTR_IAM_POLICY].clear();
+  attrs[RGW_ATTR_IAM_POLICY].append(example1);
+  p = get_iam_policy_from_attr(cct.get(), attrs, other_tenant);
+  ASSERT_TRUE(p);
+  EXPECT_EQ(p->statements[0].resource.begin()->account, other_tenant);
+  p = get_iam_policy_from_attr(cct.get(), attrs, arbitrary_tenant);
+  ASSERT_TRUE(p);
+  EXPECT_EQ(p->statements[0].resource.begin()->account, arbitrary_tenant);
+
+  // a policy that fails to parse isn't cached
+  attrs[RGW_ATTR_IAM_POLICY].clear();
+  attrs[RGW_ATTR_IAM_POLICY].append("{ \"Version\": ");
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THROW(get_iam_policy_from_attr(cct.get(), attrs, arbitrary_tenant),
+		 rgw::IAM::PolicyParseException);
+  }
+}
+
 TEST_F(PolicyTest, Parse2) {
   boost::optional<Policy> p;
 
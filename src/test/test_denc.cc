@@ -25,6 +25,7 @@
 #include "gtest/gtest.h"
 
 #include "include/denc.h"
+#include "include/object.h"
 
 #include <boost/container/flat_map.hpp>
 #include <boost/container/flat_set.hpp>
@@ -275,6 +276,46 @@ TEST(denc, vector)
   }
 }
 
+TEST(denc, vector_memcpy)
+{
+  static_assert(_denc::is_memcpy_encodable<uint32_t>);
+  static_assert(_denc::is_memcpy_encodable<snapid_t>);
+  static_assert(!_denc::is_memcpy_encodable<bool>);
+  static_assert(!_denc::is_memcpy_encodable<std::string>);
+
+  // the memcpy path for vectors must produce the same bytes as the
+  // per-element path std::list takes
+  std::vector<uint32_t> v(100);
+  std::iota(v.begin(), v.end(), 0xfffff000);
+  std::list<uint32_t> l(v.begin(), v.end());
+  {
+    bufferlist vbl, lbl;
+    encode(v, vbl);
+    encode(l, lbl);
+    ASSERT_EQ(lbl, vbl);
+  }
+  test_denc(v);
+  test_denc(std::vector<snapid_t>{1, 2, 0xffffffffffffull});
+  test_denc(std::vector<int64_t>{});
+  test_denc(boost::container::small_vector<int16_t, 4>{-1, 0, 1, 2, 3, 4});
+
+  // a count beyond the end of the data is caught before anything is
+  // allocated
+  bufferlist bl;
+  encode((uint32_t)0x7fffffff, bl);
+  encode((uint32_t)1, bl);
+  std::vector<uint64_t> out;
+  {
+    auto p = bl.cbegin();
+    ASSERT_THROW(decode(out, p), ceph::buffer::end_of_buffer);
+  }
+  {
+    bl.rebuild();
+    auto p = bl.front().cbegin();
+    ASSERT_THROW(denc(out, p), ceph::buffer::end_of_buffer);
+  }
+}
+
 template<typename T>
 using default_list = std::list<T>;
 
@@ -15,6 +15,7 @@
 
 #include <errno.h>
 
+#include <chrono>
 #include <filesystem>
 #include <iomanip>
 
@@ -61,6 +62,7 @@ void usage(ostream &out)
   out << "  count_tests         print number of generated test objects (to stdout)\n";
   out << "  select_test <n>     select generated test object as in-memory object\n";
   out << "  is_deterministic    exit w/ success if type encodes deterministically\n";
+  out << "  bench <n>           time <n> encodes and decodes of the in-memory object\n";
 }
 
 vector<DencoderPlugin> load_plugins()
@@ -265,6 +267,43 @@ int main(int argc, const char **argv)
       }
       int n = atoi(*i);
       err = den->select_generated(n);
+    } else if (*i == string("bench")) {
+      if (!den) {
+	cerr << "must first select type with 'type <name>'" << std::endl;
+	return 1;
+      }
+      ++i;
+      if (i == args.end()) {
+	cerr << "expecting iteration count" << std::endl;
+	return 1;
+      }
+      const int n = atoi(*i);
+      if (n <= 0) {
+	cerr << "iteration count must be positive" << std::endl;
+	return 1;
+      }
+      using clock = std::chrono::steady_clock;
+      bufferlist bl;
+      den->encode(bl, features | CEPH_FEATURE_RESERVED);
+      auto start = clock::now();
+      for (int k = 0; k < n; ++k) {
+	bufferlist out;
+	den->encode(out, features | CEPH_FEATURE_RESERVED);
+      }
+      const std::chrono::duration<double> enc = clock::now() - start;
+      start = clock::now();
+      for (int k = 0; k < n && err.empty(); ++k) {
+	err = den->decode(bl, 0);
+      }
+      const std::chrono::duration<double> dec = clock::now() - start;
+      if (err.empty()) {
+	const double mb = (double)bl.length() * n / (1024 * 1024);
+	cout << "size " << bl.length() << " bytes\n"
+	     << "encode " << enc.count() * 1e9 / n << " ns/op "
+	     << mb / enc.count() << " MiB/s\n"
+	     << "decode " << dec.count() * 1e9 / n << " ns/op "
+	     << mb / dec.count() << " MiB/s" << std::endl;
+      }
     } else if (*i == string("is_deterministic")) {
       if (!den) {
 	cerr << "must first select type with 'type <name>'" << std::endl;
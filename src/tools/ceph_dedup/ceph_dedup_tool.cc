@@ -15,6 +15,8 @@
 #include "common.h"
 #include "log/Log.h"
 
+#include <unordered_map>
+
 #include <boost/optional.hpp>
 
 struct EstimateResult {
@@ -25,7 +27,7 @@ struct EstimateResult {
   ceph::mutex lock = ceph::make_mutex("EstimateResult::lock");
 
   // < key, <count, chunk_size> >
-  map< string, pair <uint64_t, uint64_t> > chunk_statistics;
+  std::unordered_map< string, pair <uint64_t, uint64_t> > chunk_statistics;
   uint64_t total_bytes = 0;
   std::atomic<uint64_t> total_objects = {0};
 
@@ -33,34 +35,33 @@ struct EstimateResult {
     : cdc(CDC::create(alg, chunk_size)),
       chunk_size(1ull << chunk_size) {}
 
-  void add_chunk(bufferlist& chunk, const std::string& fp_algo) {
-    string fp;
+  static string fingerprint(const bufferlist& chunk, const std::string& fp_algo) {
     if (fp_algo == "sha1") {
-      sha1_digest_t sha1_val = crypto::digest<crypto::SHA1>(chunk);
-      fp = sha1_val.to_str();
+      return crypto::digest<crypto::SHA1>(chunk).to_str();
     } else if (fp_algo == "sha256") {
-      sha256_digest_t sha256_val = crypto::digest<crypto::SHA256>(chunk);
-      fp = sha256_val.to_str();
+      return crypto::digest<crypto::SHA256>(chunk).to_str();
     } else if (fp_algo == "sha512") {
-      sha512_digest_t sha512_val = crypto::digest<crypto::SHA512>(chunk);
-      fp = sha512_val.to_str();
-    } else {
-      ceph_assert(0 == "no support fingerperint algorithm");
+      return crypto::digest<crypto::SHA512>(chunk).to_str();
     }
+    ceph_abort_msg("no support fingerperint algorithm");
+  }
 
+  // < fingerprint, chunk_size > of every chunk of one object; hashing is
+  // done by the caller so the lock is only held for the table updates
+  void add_chunks(const vector<pair<string, uint64_t>>& fps) {
     std::lock_guard l(lock);
-    auto p = chunk_statistics.find(fp);
-    if (p != chunk_statistics.end()) {
-      p->second.first++;
-      if (p->second.second != chunk.length()) {
-	cerr << "warning: hash collision on " << fp
-	     << ": was " << p->second.second
-	     << " now " << chunk.length() << std::endl;
+    for (auto& [fp, len] : fps) {
+      auto [p, inserted] = chunk_statistics.try_emplace(fp, 1, len);
+      if (!inserted) {
+	p->second.first++;
+	if (p->second.second != len) {
+	  cerr << "warning: hash collision on " << fp
+	       << ": was " << p->second.second
+	       << " now " << len << std::endl;
+	}
       }
-    } else {
-      chunk_statistics[fp] = make_pair(1, chunk.length());
+      total_bytes += len;
     }
-    total_bytes += chunk.length();
   }
 
   void dump(Formatter *f) const {
@@ -112,10 +113,12 @@ po::options_description make_usage() {
      ": perform a chunk dedup---deduplicate only a chunk, which is a part of object.")
     ("op object-dedup --pool <POOL> --object <OID> --chunk-pool <POOL> --fingerprint-algorithm <FP> --dedup-cdc-chunk-size <CHUNK_SIZE> [--snap]",
      ": perform a object dedup---deduplicate the entire object, not a chunk. Related snapshots are also deduplicated if --snap is given")
+    ("op chunk-bench --input-file <FILE> --chunk-size <CHUNK_SIZE> --chunk-algorithm <ALGO> --fingerprint-algorithm <FP_ALGO>",
+     ": measure chunking and fingerprinting throughput on a local file, without a cluster")
     ;
   po::options_description op_desc("Opational arguments");
   op_desc.add_options()
-    ("op", po::value<std::string>(), ": estimate|chunk-scrub|chunk-get-ref|chunk-put-ref|chunk-repair|dump-chunk-refs|chunk-dedup|object-dedup")
+    ("op", po::value<std::string>(), ": estimate|chunk-scrub|chunk-get-ref|chunk-put-ref|chunk-repair|dump-chunk-refs|chunk-dedup|object-dedup|chunk-bench")
     ("target-ref", po::value<std::string>(), ": set target object")
     ("target-ref-pool-id", po::value<uint64_t>(), ": set target pool id")
     ("object", po::value<std::string>(), ": set object name")
@@ -128,6 +131,7 @@ po::options_description make_usage() {
     ("max-seconds", po::value<int>(), ": set max runtime")
     ("max-read-size", po::value<int>(), ": set max read size")
     ("pool", po::value<std::string>(), ": set pool name")
+    ("input-file", po::value<std::string>(), ": set local input file")
     ("min-chunk-size", po::value<int>(), ": min chunk size (byte)")
     ("max-chunk-size", po::value<int>(), ": max chunk size (byte)")
     ("source-off", po::value<uint64_t>(), ": set source offset")
@@ -369,14 +373,17 @@ void EstimateDedupRatio::estimate_dedup_ratio()
       for (auto& i : dedup_estimates) {
 	vector<pair<uint64_t, uint64_t>> chunks;
 	i.second.cdc->calc_chunks(bl, &chunks);
+	vector<pair<string, uint64_t>> fps;
+	fps.reserve(chunks.size());
 	for (auto& p : chunks) {
 	  bufferlist chunk;
 	  chunk.substr_of(bl, p.first, p.second);
-	  i.second.add_chunk(chunk, fp_algo);
+	  fps.emplace_back(EstimateResult::fingerprint(chunk, fp_algo), p.second);
 	  if (debug) {
 	    cout << " " << oid <<  " " << p.first << "~" << p.second << std::endl;
 	  }
 	}
+	i.second.add_chunks(fps);
 	++i.second.total_objects;
       }
     }
@@ -520,6 +527,63 @@ void ChunkScrub::print_status(Formatter *f, ostream &out)
   }
 }
 
+int bench_chunking(const po::variables_map &opts)
+{
+  string chunk_algo = get_opts_chunk_algo(opts);
+  string fp_algo = get_opts_fp_algo(opts);
+  uint64_t chunk_size = 8192;
+  if (opts.count("chunk-size")) {
+    chunk_size = opts["chunk-size"].as<int>();
+  }
+  if (!opts.count("input-file")) {
+    cerr << "must specify input-file" << std::endl;
+    return -EINVAL;
+  }
+  string fn = opts["input-file"].as<string>();
+  bufferlist bl;
+  string err;
+  int r = bl.read_file(fn.c_str(), &err);
+  if (r < 0) {
+    cerr << "error reading " << fn << ": " << err << std::endl;
+    return r;
+  }
+
+  EstimateResult result(chunk_algo, cbits(chunk_size) - 1);
+  utime_t start = ceph_clock_now();
+  vector<pair<uint64_t, uint64_t>> chunks;
+  result.cdc->calc_chunks(bl, &chunks);
+  utime_t chunked = ceph_clock_now();
+  vector<pair<string, uint64_t>> fps;
+  fps.reserve(chunks.size());
+  for (auto& p : chunks) {
+    bufferlist chunk;
+    chunk.substr_of(bl, p.first, p.second);
+    fps.emplace_back(EstimateResult::fingerprint(chunk, fp_algo), p.second);
+  }
+  utime_t hashed = ceph_clock_now();
+  result.add_chunks(fps);
+  ++result.total_objects;
+
+  double mb = (double)bl.length() / (1 << 20);
+  double chunk_sec = chunked - start;
+  double fp_sec = hashed - chunked;
+  auto f = Formatter::create("json-pretty");
+  f->open_object_section("results");
+  f->dump_string("chunk_algo", chunk_algo);
+  f->dump_string("fingerprint_algo", fp_algo);
+  f->dump_unsigned("bytes", bl.length());
+  f->dump_unsigned("chunks", chunks.size());
+  f->dump_float("chunk_seconds", chunk_sec);
+  f->dump_float("chunk_mb_per_sec", chunk_sec > 0 ? mb / chunk_sec : 0);
+  f->dump_float("fingerprint_seconds", fp_sec);
+  f->dump_float("fingerprint_mb_per_sec", fp_sec > 0 ? mb / fp_sec : 0);
+  f->dump_object("chunker", result);
+  f->close_section();
+  f->flush(cout);
+  delete f;
+  return 0;
+}
+
 int estimate_dedup_ratio(const po::variables_map &opts)
 {
   Rados rados;
@@ -1118,6 +1182,8 @@ int main(int argc, const char **argv)
   int ret = 0;
   if (op_name == "estimate") {
     ret = estimate_dedup_ratio(opts);
+  } else if (op_name == "chunk-bench") {
+    ret = bench_chunking(opts);
   } else if (op_name == "chunk-scrub" ||
 	     op_name == "chunk-get-ref" ||
 	     op_name == "chunk-put-ref" ||
@@ -1666,14 +1666,35 @@ int ObjectStoreTool::get_object(ObjectStore *store,
     }
   }
   if (!dry_run) {
-    wait_until_done(t, [&] {
-      store->queue_transaction(ch, std::move(*t));
-      ch->flush();
-    });
+    queue_import_transaction(store, ch, std::move(*t));
   }
   return 0;
 }
 
+void ObjectStoreTool::queue_import_transaction(
+  ObjectStore *store,
+  ObjectStore::CollectionHandle& ch,
+  ObjectStore::Transaction&& t)
+{
+  {
+    std::unique_lock l{inflight_lock};
+    inflight_cond.wait(l, [this] { return inflight < max_inflight; });
+    ++inflight;
+  }
+  t.register_on_complete(make_lambda_context([this](int) {
+    std::lock_guard l{inflight_lock};
+    --inflight;
+    inflight_cond.notify_all();
+  }));
+  store->queue_transaction(ch, std::move(t));
+}
+
+void ObjectStoreTool::wait_for_import_transactions()
+{
+  std::unique_lock l{inflight_lock};
+  inflight_cond.wait(l, [this] { return inflight == 0; });
+}
+
 int dump_pg_metadata(Formatter *formatter, bufferlist &bl, metadata_section &ms)
 {
   auto ebliter = bl.cbegin();
@@ -2163,6 +2184,7 @@ int ObjectStoreTool::do_import(ObjectStore *store, OSDSuperblock& sb,
       return -EFAULT;
     }
   }
+  wait_for_import_transactions();
 
   if (!found_metadata) {
     cerr << "Missing metadata section" << std::endl;
@@ -15,10 +15,26 @@
 #ifndef CEPH_OBJECTSTORE_TOOL_H_
 #define CEPH_OBJECTSTORE_TOOL_H_
 
+#include <condition_variable>
+#include <mutex>
+
 #include "RadosDump.h"
+#include "os/ObjectStore.h"
 
 class ObjectStoreTool : public RadosDump
 {
+    // import queues each object's transaction without waiting for it to
+    // commit, up to max_inflight at a time
+    std::mutex inflight_lock;
+    std::condition_variable inflight_cond;
+    unsigned inflight = 0;
+    static constexpr unsigned max_inflight = 64;
+
+    void queue_import_transaction(ObjectStore *store,
+				  ObjectStore::CollectionHandle& ch,
+				  ObjectStore::Transaction&& t);
+    void wait_for_import_transactions();
+
   public:
     ObjectStoreTool(int file_fd, bool dry_run)
       : RadosDump(file_fd, dry_run)
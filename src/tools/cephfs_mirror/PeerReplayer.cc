@@ -753,6 +753,133 @@ close_local_fd:
   return r == 0 ? 0 : r;
 }
 
+#define DELTA_BLOCK_SIZE (4 * 1024 * 1024) // compare granularity for delta copy
+int PeerReplayer::copy_delta_to_remote(const std::string &dir_root, const std::string &epath,
+                                       const struct ceph_statx &stx, const FHandles &fh,
+                                       bool *done) {
+  *done = false;
+  auto min_size = g_ceph_context->_conf.get_val<Option::size_t>(
+    "cephfs_mirror_delta_copy_min_size");
+  if (min_size == 0 || stx.stx_size < min_size || fh.p_mnt != m_local_mount) {
+    return 0;
+  }
+
+  // the remote file can only be patched in place if it still is what
+  // the previous snapshot had: same size and, since attributes are
+  // synced after data, the same mtime (an interrupted copy leaves a
+  // truncated or freshly modified remote file).
+  struct ceph_statx pstx;
+  int r = ceph_statxat(m_local_mount, fh.p_fd, epath.c_str(), &pstx,
+                       CEPH_STATX_MODE | CEPH_STATX_SIZE | CEPH_STATX_MTIME,
+                       AT_STATX_DONT_SYNC | AT_SYMLINK_NOFOLLOW);
+  if (r < 0 || !S_ISREG(pstx.stx_mode)) {
+    return 0;
+  }
+  struct ceph_statx rstx;
+  r = ceph_statxat(m_remote_mount, fh.r_fd_dir_root, epath.c_str(), &rstx,
+                   CEPH_STATX_MODE | CEPH_STATX_SIZE | CEPH_STATX_MTIME,
+                   AT_STATX_DONT_SYNC | AT_SYMLINK_NOFOLLOW);
+  if (r < 0 || !S_ISREG(rstx.stx_mode) || rstx.stx_size != pstx.stx_size ||
+      rstx.stx_mtime != pstx.stx_mtime) {
+    dout(20) << ": remote file path=" << epath << " does not match previous snapshot"
+             << dendl;
+    return 0;
+  }
+
+  int l_fd = ceph_openat(m_local_mount, fh.c_fd, epath.c_str(), O_RDONLY | O_NOFOLLOW, 0);
+  if (l_fd < 0) {
+    derr << ": failed to open local file path=" << epath << ": "
+         << cpp_strerror(l_fd) << dendl;
+    return l_fd;
+  }
+  int p_fd = ceph_openat(m_local_mount, fh.p_fd, epath.c_str(), O_RDONLY | O_NOFOLLOW, 0);
+  if (p_fd < 0) {
+    ceph_close(m_local_mount, l_fd);
+    return 0;
+  }
+  int r_fd = ceph_openat(m_remote_mount, fh.r_fd_dir_root, epath.c_str(),
+                         O_WRONLY | O_NOFOLLOW, 0);
+  if (r_fd < 0) {
+    derr << ": failed to open remote file path=" << epath << ": "
+         << cpp_strerror(r_fd) << dendl;
+    ceph_close(m_local_mount, p_fd);
+    ceph_close(m_local_mount, l_fd);
+    return r_fd;
+  }
+
+  std::vector<char> cbuf(DELTA_BLOCK_SIZE);
+  std::vector<char> pbuf(DELTA_BLOCK_SIZE);
+  uint64_t written = 0;
+  int64_t off = 0;
+  while (true) {
+    if (should_backoff(dir_root, &r)) {
+      dout(0) << ": backing off r=" << r << dendl;
+      break;
+    }
+
+    r = ceph_read(m_local_mount, l_fd, cbuf.data(), DELTA_BLOCK_SIZE, off);
+    if (r < 0) {
+      derr << ": failed to read local file path=" << epath << ": "
+           << cpp_strerror(r) << dendl;
+      break;
+    }
+    if (r == 0) {
+      break;
+    }
+    int clen = r;
+
+    int plen = 0;
+    if ((uint64_t)off < pstx.stx_size) {
+      r = ceph_read(m_local_mount, p_fd, pbuf.data(), DELTA_BLOCK_SIZE, off);
+      if (r < 0) {
+        derr << ": failed to read previous snapshot of path=" << epath << ": "
+             << cpp_strerror(r) << dendl;
+        break;
+      }
+      plen = r;
+    }
+
+    if (clen != plen || memcmp(cbuf.data(), pbuf.data(), clen) != 0) {
+      r = ceph_write(m_remote_mount, r_fd, cbuf.data(), clen, off);
+      if (r < 0) {
+        derr << ": failed to write remote file path=" << epath << ": "
+             << cpp_strerror(r) << dendl;
+        break;
+      }
+      written += clen;
+    }
+    off += clen;
+    r = 0;
+  }
+
+  if (r == 0 && stx.stx_size < pstx.stx_size) {
+    r = ceph_ftruncate(m_remote_mount, r_fd, stx.stx_size);
+    if (r < 0) {
+      derr << ": failed to truncate remote file path=" << epath << ": "
+           << cpp_strerror(r) << dendl;
+    }
+  }
+  if (r == 0) {
+    r = ceph_fsync(m_remote_mount, r_fd, 0);
+    if (r < 0) {
+      derr << ": failed to sync data for file path=" << epath << ": "
+           << cpp_strerror(r) << dendl;
+    }
+  }
+
+  ceph_close(m_remote_mount, r_fd);
+  ceph_close(m_local_mount, p_fd);
+  ceph_close(m_local_mount, l_fd);
+  if (r < 0) {
+    return r;
+  }
+
+  dout(10) << ": delta copied path=" << epath << ", wrote " << written << " of "
+           << stx.stx_size << " bytes" << dendl;
+  *done = true;
+  return 0;
+}
+
 int PeerReplayer::remote_file_op(const std::string &dir_root, const std::string &epath,
                                  const struct ceph_statx &stx, const FHandles &fh,
                                  bool need_data_sync, bool need_attr_sync) {
@@ -762,7 +889,11 @@ int PeerReplayer::remote_file_op(const std::string &dir_root, const std::string
   int r;
   if (need_data_sync) {
     if (S_ISREG(stx.stx_mode)) {
-      r = copy_to_remote(dir_root, epath, stx, fh);
+      bool done;
+      r = copy_delta_to_remote(dir_root, epath, stx, fh, &done);
+      if (r == 0 && !done) {
+        r = copy_to_remote(dir_root, epath, stx, fh);
+      }
       if (r < 0) {
         derr << ": failed to copy path=" << epath << ": " << cpp_strerror(r) << dendl;
         return r;
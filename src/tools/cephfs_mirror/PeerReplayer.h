@@ -324,6 +324,8 @@ private:
                      const FHandles &fh, bool need_data_sync, bool need_attr_sync);
   int copy_to_remote(const std::string &dir_root, const std::string &epath, const struct ceph_statx &stx,
                      const FHandles &fh);
+  int copy_delta_to_remote(const std::string &dir_root, const std::string &epath,
+                           const struct ceph_statx &stx, const FHandles &fh, bool *done);
   int sync_perms(const std::string& path);
 };
 
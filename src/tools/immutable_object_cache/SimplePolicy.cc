@@ -16,13 +16,15 @@ namespace ceph {
 namespace immutable_obj_cache {
 
 SimplePolicy::SimplePolicy(CephContext *cct, uint64_t cache_size,
-                           uint64_t max_inflight, double watermark)
+                           uint64_t max_inflight, double watermark,
+                           uint64_t admission_window)
   : cct(cct), m_watermark(watermark), m_max_inflight_ops(max_inflight),
-    m_max_cache_size(cache_size) {
+    m_max_cache_size(cache_size), m_admission_window(admission_window) {
 
   ldout(cct, 20) << "max cache size= " << m_max_cache_size
                  << " ,watermark= " << m_watermark
-                 << " ,max inflight ops= " << m_max_inflight_ops << dendl;
+                 << " ,max inflight ops= " << m_max_inflight_ops
+                 << " ,admission window= " << m_admission_window << dendl;
 
   m_cache_size = 0;
 
@@ -50,6 +52,11 @@ cache_status_t SimplePolicy::alloc_entry(std::string file_name) {
 
   if ((m_cache_size < m_max_cache_size) &&
       (inflight_ops < m_max_inflight_ops)) {
+    if (!admit_entry(file_name)) {
+      ldout(cct, 20) << "not reused recently, skip promotion: "
+                     << file_name << dendl;
+      return OBJ_CACHE_SKIP;
+    }
     Entry* entry = new Entry();
     ceph_assert(entry != nullptr);
     m_cache_map[file_name] = entry;
@@ -62,6 +69,28 @@ cache_status_t SimplePolicy::alloc_entry(std::string file_name) {
   return OBJ_CACHE_SKIP;
 }
 
+bool SimplePolicy::admit_entry(const std::string& file_name) {
+  ceph_assert(ceph_mutex_is_wlocked(m_cache_map_lock));
+  if (m_admission_window == 0) {
+    return true;
+  }
+
+  auto ghost_it = m_ghost_map.find(file_name);
+  if (ghost_it != m_ghost_map.end()) {
+    m_ghost_lru.erase(ghost_it->second);
+    m_ghost_map.erase(ghost_it);
+    return true;
+  }
+
+  m_ghost_lru.push_front(file_name);
+  m_ghost_map[file_name] = m_ghost_lru.begin();
+  if (m_ghost_lru.size() > m_admission_window) {
+    m_ghost_map.erase(m_ghost_lru.back());
+    m_ghost_lru.pop_back();
+  }
+  return false;
+}
+
 cache_status_t SimplePolicy::lookup_object(std::string file_name) {
   ldout(cct, 20) << "lookup: " << file_name << dendl;
 
@@ -9,6 +9,7 @@
 #include "include/lru.h"
 #include "Policy.h"
 
+#include <list>
 #include <unordered_map>
 #include <string>
 
@@ -18,7 +19,7 @@ namespace immutable_obj_cache {
 class SimplePolicy : public Policy {
  public:
   SimplePolicy(CephContext *cct, uint64_t block_num, uint64_t max_inflight,
-               double watermark);
+               double watermark, uint64_t admission_window = 0);
   ~SimplePolicy();
 
   cache_status_t lookup_object(std::string file_name);
@@ -39,6 +40,7 @@ class SimplePolicy : public Policy {
 
  private:
   cache_status_t alloc_entry(std::string file_name);
+  bool admit_entry(const std::string& file_name);
 
   class Entry : public LRUObject {
    public:
@@ -61,6 +63,14 @@ class SimplePolicy : public Policy {
   std::atomic<uint64_t> m_cache_size;
 
   LRU m_promoted_lru;
+
+  // objects missed recently but not promoted yet, most recent first. An
+  // object is promoted only if it is looked up again while still in here,
+  // i.e. within m_admission_window other misses, so one-pass scans don't
+  // push reused objects out of the cache. Protected by m_cache_map_lock.
+  uint64_t m_admission_window;
+  std::list<std::string> m_ghost_lru;
+  std::unordered_map<std::string, std::list<std::string>::iterator> m_ghost_map;
 };
 
 }  // namespace immutable_obj_cache
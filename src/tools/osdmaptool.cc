@@ -25,6 +25,8 @@
 #include "mon/health_check.h"
 #include <time.h>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "global/global_init.h"
 #include "osd/OSDMap.h"
@@ -780,7 +782,32 @@ skip_upmap:
       
       cout << "pool " << p->first
 	   << " pg_num " << p->second.get_pg_num() << std::endl;
-      for (unsigned i = 0; i < p->second.get_pg_num(); ++i) {
+      // map the pgs in parallel; the tallies below still run in pg order
+      const unsigned pg_count = p->second.get_pg_num();
+      vector<pair<vector<int>, int>> mapped;
+      if (pg_count && !test_random && !test_map_pgs_dump_all) {
+	mapped.resize(pg_count);
+	const unsigned chunk = 1024;
+	std::atomic<unsigned> next{0};
+	vector<std::thread> threads;
+	unsigned nthreads = std::clamp(std::thread::hardware_concurrency(),
+				       1u, (pg_count + chunk - 1) / chunk);
+	for (unsigned t = 0; t < nthreads; ++t) {
+	  threads.emplace_back([&] {
+	    for (unsigned b = next.fetch_add(chunk); b < pg_count;
+		 b = next.fetch_add(chunk)) {
+	      for (unsigned i = b; i < std::min(b + chunk, pg_count); ++i) {
+		osdmap.pg_to_acting_osds(pg_t(i, p->first),
+					 &mapped[i].first, &mapped[i].second);
+	      }
+	    }
+	  });
+	}
+	for (auto& t : threads) {
+	  t.join();
+	}
+      }
+      for (unsigned i = 0; i < pg_count; ++i) {
 	pg_t pgid = pg_t(i, p->first);
 
 	vector<int> osds, raw, up, acting;
@@ -798,7 +825,8 @@ skip_upmap:
 	  osds = acting;
 	  primary = acting_primary;
         } else {
-	  osdmap.pg_to_acting_osds(pgid, &osds, &primary);
+	  osds = std::move(mapped[i].first);
+	  primary = mapped[i].second;
 	}
 	size[osds.size()]++;
 	if ((unsigned)max_size < osds.size())
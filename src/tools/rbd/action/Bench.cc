@@ -494,6 +494,7 @@ void get_arguments_for_bench(po::options_description *positional,
 
   options->add_options()
     ("io-type", po::value<IOType>()->required(), "IO type (read, write, or readwrite(rw))");
+  at::add_encryption_options(options);
 }
 
 int bench_execute(const po::variables_map &vm, io_type_t bench_io_type) {
@@ -574,6 +575,12 @@ int bench_execute(const po::variables_map &vm, io_type_t bench_io_type) {
     }
   }
 
+  utils::EncryptionOptions encryption_options;
+  r = utils::get_encryption_options(vm, &encryption_options);
+  if (r < 0) {
+    return r;
+  }
+
   librados::Rados rados;
   librados::IoCtx io_ctx;
   librbd::Image image;
@@ -583,6 +590,16 @@ int bench_execute(const po::variables_map &vm, io_type_t bench_io_type) {
     return r;
   }
 
+  if (!encryption_options.specs.empty()) {
+    r = image.encryption_load2(encryption_options.specs.data(),
+                               encryption_options.specs.size());
+    if (r < 0) {
+      std::cerr << "rbd: encryption load failed: " << cpp_strerror(r)
+                << std::endl;
+      return r;
+    }
+  }
+
   init_async_signal_handler();
   register_async_signal_handler(SIGHUP, sighup_handler);
   register_async_signal_handler_oneshot(SIGINT, handle_signal);
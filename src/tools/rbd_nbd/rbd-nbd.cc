@@ -100,6 +100,7 @@ struct Config {
   int max_part = 255;
   int io_timeout = -1;
   int reattach_timeout = 30;
+  int num_connections = 1;
 
   bool exclusive = false;
   bool notrim = false;
@@ -156,6 +157,8 @@ static void usage()
             << "  --encryption-passphrase-file  Path of file containing passphrase for unlocking image encryption\n"
             << "  --exclusive                   Forbid writes by other clients\n"
             << "  --notrim                      Turn off trim/discard\n"
+            << "  --num-connections <count>     Number of nbd sockets (queues) to\n"
+            << "                                use, netlink only (default: 1)\n"
             << "  --io-timeout <sec>            Set nbd IO timeout\n"
             << "  --max_part <limit>            Override for module param max_part\n"
             << "  --nbds_max <limit>            Override for module param nbds_max\n"
@@ -182,10 +185,17 @@ static void usage()
 
 static int nbd = -1;
 static int nbd_index = -1;
+// shared by all of the servers of a multi-connection mapping: nobody reads
+// it, so once notified it wakes every reader
+static int terminate_event_fd = -1;
 static EventSocket terminate_event_sock;
 
 #define RBD_NBD_BLKSIZE 512UL
 
+#ifndef NBD_FLAG_CAN_MULTI_CONN
+#define NBD_FLAG_CAN_MULTI_CONN (1 << 8)
+#endif
+
 #define HELP_INFO 1
 #define VERSION_INFO 2
 
@@ -237,7 +247,6 @@ public:
   }
 
 private:
-  int terminate_event_fd = -1;
   ceph::mutex disconnect_lock =
     ceph::make_mutex("NBDServer::DisconnectLocker");
   ceph::condition_variable disconnect_cond;
@@ -461,6 +470,9 @@ error:
       }
     }
 signal:
+    // stop the other connections of the mapping too
+    terminate_event_sock.notify();
+
     std::lock_guard l{lock};
     terminated = true;
     cond.notify_all();
@@ -613,11 +625,7 @@ public:
 
       started = true;
 
-      terminate_event_fd = eventfd(0, EFD_NONBLOCK);
-      ceph_assert(terminate_event_fd > 0);
-      int r = terminate_event_sock.init(terminate_event_fd,
-                                        EVENT_SOCKET_TYPE_EVENTFD);
-      ceph_assert(r >= 0);
+      ceph_assert(terminate_event_sock.is_valid());
 
       reader_thread.create("rbd_reader");
       writer_thread.create("rbd_writer");
@@ -673,7 +681,6 @@ public:
 
       assert_clean();
 
-      close(terminate_event_fd);
       started = false;
     }
   }
@@ -1399,8 +1406,9 @@ static int netlink_connect_cb(struct nl_msg *msg, void *arg)
   return NL_OK;
 }
 
-static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id, int fd,
-                           uint64_t size, uint64_t flags, bool reconnect)
+static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id,
+                           const std::vector<int>& fds, uint64_t size,
+                           uint64_t flags, bool reconnect)
 {
   struct nlattr *sock_attr;
   struct nlattr *sock_opt;
@@ -1455,14 +1463,16 @@ static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id, int fd,
     goto free_msg;
   }
 
-  sock_opt = nla_nest_start(msg, NBD_SOCK_ITEM);
-  if (!sock_opt) {
-    cerr << "rbd-nbd: Could not init sock in netlink message." << std::endl;
-    goto free_msg;
-  }
+  for (auto fd : fds) {
+    sock_opt = nla_nest_start(msg, NBD_SOCK_ITEM);
+    if (!sock_opt) {
+      cerr << "rbd-nbd: Could not init sock in netlink message." << std::endl;
+      goto free_msg;
+    }
 
-  NLA_PUT_U32(msg, NBD_SOCK_FD, fd);
-  nla_nest_end(msg, sock_opt);
+    NLA_PUT_U32(msg, NBD_SOCK_FD, fd);
+    nla_nest_end(msg, sock_opt);
+  }
   nla_nest_end(msg, sock_attr);
 
   ret = nl_send_sync(sock, msg);
@@ -1481,8 +1491,8 @@ free_msg:
   return -EIO;
 }
 
-static int try_netlink_setup(Config *cfg, int fd, uint64_t size, uint64_t flags,
-                             bool reconnect)
+static int try_netlink_setup(Config *cfg, const std::vector<int>& fds,
+                             uint64_t size, uint64_t flags, bool reconnect)
 {
   struct nl_sock *sock;
   int nl_id, ret;
@@ -1496,7 +1506,7 @@ static int try_netlink_setup(Config *cfg, int fd, uint64_t size, uint64_t flags,
 
   dout(10) << "netlink interface supported." << dendl;
 
-  ret = netlink_connect(cfg, sock, nl_id, fd, size, flags, reconnect);
+  ret = netlink_connect(cfg, sock, nl_id, fds, size, flags, reconnect);
   netlink_cleanup(sock);
 
   if (ret != 0)
@@ -1552,19 +1562,25 @@ static void handle_signal(int signum)
   terminate_event_sock.notify();
 }
 
-static NBDServer *start_server(int fd, librbd::Image& image, Config *cfg)
+static void start_servers(const std::vector<int>& fds, librbd::Image& image,
+                          Config *cfg, std::vector<NBDServer*> *servers)
 {
-  NBDServer *server;
+  terminate_event_fd = eventfd(0, EFD_NONBLOCK);
+  ceph_assert(terminate_event_fd > 0);
+  int r = terminate_event_sock.init(terminate_event_fd,
+                                    EVENT_SOCKET_TYPE_EVENTFD);
+  ceph_assert(r >= 0);
 
-  server = new NBDServer(fd, image, cfg);
-  server->start();
+  for (auto fd : fds) {
+    auto server = new NBDServer(fd, image, cfg);
+    server->start();
+    servers->push_back(server);
+  }
 
   init_async_signal_handler();
   register_async_signal_handler(SIGHUP, sighup_handler);
   register_async_signal_handler_oneshot(SIGINT, handle_signal);
   register_async_signal_handler_oneshot(SIGTERM, handle_signal);
-
-  return server;
 }
 
 static void run_server(Preforker& forker, NBDServer *server, bool netlink_used)
@@ -1682,12 +1698,15 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   unsigned long blksize = RBD_NBD_BLKSIZE;
   bool use_netlink = true;
 
-  int fd[2];
+  // one socketpair per connection: the kernel gets the first end of each,
+  // a server the second
+  std::vector<int> nbd_fds;
+  std::vector<int> server_fds;
 
   librbd::image_info_t info;
 
   Preforker forker;
-  NBDServer *server;
+  std::vector<NBDServer*> servers;
 
   auto args = argv_to_vec(argc, argv);
   if (args.empty()) {
@@ -1723,9 +1742,14 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   common_init_finish(g_ceph_context);
   global_init_chdir(g_ceph_context);
 
-  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd) == -1) {
-    r = -errno;
-    goto close_ret;
+  for (int i = 0; i < cfg->num_connections; i++) {
+    int fd[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd) == -1) {
+      r = -errno;
+      goto close_fd;
+    }
+    nbd_fds.push_back(fd[0]);
+    server_fds.push_back(fd[1]);
   }
 
   r = rados.init_with_context(g_ceph_context);
@@ -1841,6 +1865,11 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
     flags |= NBD_FLAG_READ_ONLY;
     read_only = 1;
   }
+  if (cfg->num_connections > 1) {
+    // all the connections share one image handle, so a flush on any of
+    // them covers writes completed on the others
+    flags |= NBD_FLAG_CAN_MULTI_CONN;
+  }
 
   if (info.size > ULONG_MAX) {
     r = -EFBIG;
@@ -1855,7 +1884,7 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   if (r < 0)
     goto close_fd;
 
-  server = start_server(fd[1], image, cfg);
+  start_servers(server_fds, image, cfg, &servers);
 
   // generate when the cookie is not supplied at CLI
   if (!reconnect && cfg->cookie.empty()) {
@@ -1863,7 +1892,7 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
     uuid_gen.generate_random();
     cfg->cookie = uuid_gen.to_string();
   }
-  r = try_netlink_setup(cfg, fd[0], size, flags, reconnect);
+  r = try_netlink_setup(cfg, nbd_fds, size, flags, reconnect);
   if (r < 0) {
     goto free_server;
   } else if (r == 1) {
@@ -1871,7 +1900,13 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   }
 
   if (!use_netlink) {
-    r = try_ioctl_setup(cfg, fd[0], size, blksize, flags);
+    if (cfg->num_connections > 1) {
+      cerr << "rbd-nbd: --num-connections requires the netlink interface"
+           << std::endl;
+      r = -EOPNOTSUPP;
+      goto free_server;
+    }
+    r = try_ioctl_setup(cfg, nbd_fds[0], size, blksize, flags);
     if (r < 0)
       goto free_server;
   }
@@ -1887,6 +1922,8 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   }
 
   {
+    // quiesce is only supported with a single connection
+    NBDServer *server = servers[0];
     NBDQuiesceWatchCtx quiesce_watch_ctx(server);
     if (cfg->quiesce) {
       r = image.quiesce_watch(&quiesce_watch_ctx,
@@ -1938,11 +1975,19 @@ close_nbd:
   }
   close(nbd);
 free_server:
-  delete server;
+  for (auto server : servers) {
+    delete server;
+  }
+  if (terminate_event_fd >= 0) {
+    close(terminate_event_fd);
+  }
 close_fd:
-  close(fd[0]);
-  close(fd[1]);
-close_ret:
+  for (auto fd : nbd_fds) {
+    close(fd);
+  }
+  for (auto fd : server_fds) {
+    close(fd);
+  }
   image.close();
   io_ctx.close();
   rados.shutdown();
@@ -2195,6 +2240,16 @@ static int parse_args(vector<const char*>& args, std::ostream *err_msg,
       cfg->exclusive = true;
     } else if (ceph_argparse_flag(args, i, "--notrim", (char *)NULL)) {
       cfg->notrim = true;
+    } else if (ceph_argparse_witharg(args, i, &cfg->num_connections, err,
+                                     "--num-connections", (char *)NULL)) {
+      if (!err.str().empty()) {
+        *err_msg << "rbd-nbd: " << err.str();
+        return -EINVAL;
+      }
+      if (cfg->num_connections < 1) {
+        *err_msg << "rbd-nbd: Invalid argument for num-connections!";
+        return -EINVAL;
+      }
     } else if (ceph_argparse_witharg(args, i, &cfg->io_timeout, err,
                                      "--timeout", (char *)NULL)) {
       if (!err.str().empty()) {
@@ -2254,6 +2309,11 @@ static int parse_args(vector<const char*>& args, std::ostream *err_msg,
                                    RBD_ENCRYPTION_FORMAT_LUKS);
   }
 
+  if (cfg->quiesce && cfg->num_connections > 1) {
+    *err_msg << "rbd-nbd: --quiesce is not supported with --num-connections";
+    return -EINVAL;
+  }
+
   if (cfg->encryption_formats.size() != cfg->encryption_passphrase_files.size()) {
     *err_msg << "rbd-nbd: Encryption formats count does not match "
              << "passphrase files count";